@@ -259,6 +259,8 @@ print_bearer_info (MMBearer *bearer)
         gchar *total_duration = NULL;
         gchar *total_bytes_rx = NULL;
         gchar *total_bytes_tx = NULL;
+        gchar *rate_rx = NULL;
+        gchar *rate_tx = NULL;
 
         if (stats) {
             guint64 val;
@@ -287,6 +289,12 @@ print_bearer_info (MMBearer *bearer)
             val = mm_bearer_stats_get_total_tx_bytes (stats);
             if (val)
                 total_bytes_tx = g_strdup_printf ("%" G_GUINT64_FORMAT, val);
+            val = mm_bearer_stats_get_rx_rate (stats);
+            if (val)
+                rate_rx = g_strdup_printf ("%" G_GUINT64_FORMAT, val);
+            val = mm_bearer_stats_get_tx_rate (stats);
+            if (val)
+                rate_tx = g_strdup_printf ("%" G_GUINT64_FORMAT, val);
         }
 
         mmcli_output_string_take (MMC_F_BEARER_STATS_DURATION,        duration);
@@ -297,6 +305,8 @@ print_bearer_info (MMBearer *bearer)
         mmcli_output_string_take (MMC_F_BEARER_STATS_TOTAL_DURATION,  total_duration);
         mmcli_output_string_take (MMC_F_BEARER_STATS_TOTAL_BYTES_RX,  total_bytes_rx);
         mmcli_output_string_take (MMC_F_BEARER_STATS_TOTAL_BYTES_TX,  total_bytes_tx);
+        mmcli_output_string_take (MMC_F_BEARER_STATS_RATE_RX,         rate_rx);
+        mmcli_output_string_take (MMC_F_BEARER_STATS_RATE_TX,         rate_tx);
     }
 
     mmcli_output_dump ();
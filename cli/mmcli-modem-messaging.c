@@ -51,6 +51,7 @@ static gboolean list_flag;
 static gchar *create_str;
 static gchar *create_with_data_str;
 static gchar *delete_str;
+static gchar **send_batch_strv;
 
 static GOptionEntry entries[] = {
     { "messaging-status", 0, 0, G_OPTION_ARG_NONE, &status_flag,
@@ -73,6 +74,10 @@ static GOptionEntry entries[] = {
       "Delete a SMS from a given modem",
       "[PATH|INDEX]"
     },
+    { "messaging-send-batch", 0, 0, G_OPTION_ARG_STRING_ARRAY, &send_batch_strv,
+      "Send SMS messages right away, without creating them in the modem; give once per message",
+      "[\"key=value,...\"]"
+    },
     { NULL }
 };
 
@@ -103,7 +108,8 @@ mmcli_modem_messaging_options_enabled (void)
     n_actions = (status_flag +
                  list_flag +
                  !!create_str +
-                 !!delete_str);
+                 !!delete_str +
+                 !!send_batch_strv);
 
     if (n_actions > 1) {
         g_printerr ("error: too many Messaging actions requested\n");
@@ -321,6 +327,58 @@ delete_ready (MMModemMessaging *modem,
     mmcli_async_operation_done ();
 }
 
+static GList *
+build_sms_properties_list_from_input (gchar **properties_strv)
+{
+    GList *list = NULL;
+    guint  i;
+
+    for (i = 0; properties_strv[i]; i++)
+        list = g_list_append (list, build_sms_properties_from_input (properties_strv[i], NULL));
+    return list;
+}
+
+static void
+send_batch_process_reply (GList        *result,
+                          const GError *error)
+{
+    GList *l;
+    guint  i;
+
+    if (error) {
+        g_printerr ("error: couldn't send SMS batch: '%s'\n",
+                    error->message);
+        exit (EXIT_FAILURE);
+    }
+
+    for (l = result, i = 0; l; l = g_list_next (l), i++) {
+        MMModemMessagingBatchResult *batch_result;
+
+        batch_result = (MMModemMessagingBatchResult *)l->data;
+        if (mm_modem_messaging_batch_result_get_sent (batch_result))
+            g_print ("[%u] successfully sent SMS (message reference %u)\n",
+                     i, mm_modem_messaging_batch_result_get_message_reference (batch_result));
+        else
+            g_print ("[%u] couldn't send SMS: '%s'\n",
+                     i, mm_modem_messaging_batch_result_get_error_message (batch_result));
+    }
+    g_list_free_full (result, (GDestroyNotify) mm_modem_messaging_batch_result_free);
+}
+
+static void
+send_batch_ready (MMModemMessaging *modem,
+                  GAsyncResult     *result,
+                  gpointer          nothing)
+{
+    GList *operation_result;
+    GError *error = NULL;
+
+    operation_result = mm_modem_messaging_send_batch_finish (modem, result, &error);
+    send_batch_process_reply (operation_result, error);
+
+    mmcli_async_operation_done ();
+}
+
 static void
 get_sms_to_delete_ready (GDBusConnection *connection,
                          GAsyncResult *res)
@@ -398,6 +456,21 @@ get_modem_ready (GObject      *source,
         return;
     }
 
+    /* Request to send a batch of SMS? */
+    if (send_batch_strv) {
+        GList *properties;
+
+        properties = build_sms_properties_list_from_input (send_batch_strv);
+        g_debug ("Asynchronously sending SMS batch...");
+        mm_modem_messaging_send_batch (ctx->modem_messaging,
+                                       properties,
+                                       ctx->cancellable,
+                                       (GAsyncReadyCallback)send_batch_ready,
+                                       NULL);
+        g_list_free_full (properties, g_object_unref);
+        return;
+    }
+
     g_warn_if_reached ();
 }
 
@@ -500,5 +573,22 @@ mmcli_modem_messaging_run_synchronous (GDBusConnection *connection)
         return;
     }
 
+    /* Request to send a batch of SMS? */
+    if (send_batch_strv) {
+        GList *properties;
+        GList *result;
+
+        properties = build_sms_properties_list_from_input (send_batch_strv);
+        g_debug ("Synchronously sending SMS batch...");
+        result = mm_modem_messaging_send_batch_sync (ctx->modem_messaging,
+                                                     properties,
+                                                     NULL,
+                                                     &error);
+        g_list_free_full (properties, g_object_unref);
+
+        send_batch_process_reply (result, error);
+        return;
+    }
+
     g_warn_if_reached ();
 }
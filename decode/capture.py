@@ -0,0 +1,147 @@
+#!/usr/bin/python
+# -*- Mode: python; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details:
+#
+# Dumps the port captures written by ModemManager (Modem.SetPortCapture())
+#
+# Usage: capture.py [--port=NAME] [--hex] <capture.pcapng>
+#
+
+import struct
+import sys
+import time
+
+BLOCK_SHB = 0x0A0D0D0A
+BLOCK_IDB = 0x00000001
+BLOCK_EPB = 0x00000006
+
+OPTION_IF_NAME = 2
+OPTION_EPB_FLAGS = 2
+
+DIRECTION_IN = 1
+DIRECTION_OUT = 2
+
+class Interface:
+    def __init__(self, name):
+        self.name = name
+
+class Packet:
+    def __init__(self, interface, timestamp, direction, data):
+        self.interface = interface
+        self.timestamp = timestamp
+        self.direction = direction
+        self.data = bytearray(data)
+
+    def is_text(self):
+        for b in self.data:
+            if (b < 0x20 and b not in (0x0d, 0x0a)) or b > 0x7e:
+                return False
+        return True
+
+    def show(self, hexdump):
+        if self.direction == DIRECTION_OUT:
+            arrow = "-->"
+        elif self.direction == DIRECTION_IN:
+            arrow = "<--"
+        else:
+            arrow = "???"
+
+        ts = time.strftime("%Y-%m-%d %H:%M:%S", time.localtime(self.timestamp // 1000000))
+        prefix = "[%s.%06d] (%s) %s" % (ts, self.timestamp % 1000000, self.interface.name, arrow)
+
+        if not hexdump and self.is_text():
+            text = ""
+            for b in self.data:
+                if b == 0x0d:
+                    text += "<CR>"
+                elif b == 0x0a:
+                    text += "<LF>"
+                else:
+                    text += chr(b)
+            print("%s '%s'" % (prefix, text))
+            return
+
+        print("%s %d bytes" % (prefix, len(self.data)))
+        for i in range(0, len(self.data), 16):
+            chunk = self.data[i:i + 16]
+            line = " ".join(["%02x" % b for b in chunk])
+            ascii = "".join([chr(b) if 0x20 <= b <= 0x7e else "." for b in chunk])
+            print("    %04x  %-47s  %s" % (i, line, ascii))
+
+def parse_options(data, endian):
+    options = {}
+    offset = 0
+    while offset + 4 <= len(data):
+        (code, length) = struct.unpack(endian + "HH", data[offset:offset + 4])
+        if code == 0:
+            break
+        options[code] = data[offset + 4:offset + 4 + length]
+        offset += 4 + ((length + 3) & ~3)
+    return options
+
+def parse(path):
+    f = open(path, 'rb')
+    contents = f.read()
+    f.close()
+
+    interfaces = []
+    packets = []
+    endian = "<"
+    offset = 0
+    while offset + 12 <= len(contents):
+        (btype,) = struct.unpack(endian + "I", contents[offset:offset + 4])
+        if btype == BLOCK_SHB:
+            # Byte order of the section given by its magic
+            (magic,) = struct.unpack("<I", contents[offset + 8:offset + 12])
+            endian = "<" if magic == 0x1A2B3C4D else ">"
+            interfaces = []
+        (total,) = struct.unpack(endian + "I", contents[offset + 4:offset + 8])
+        if total < 12 or offset + total > len(contents):
+            sys.stderr.write("Truncated block at offset %d\n" % offset)
+            break
+        body = contents[offset + 8:offset + total - 4]
+
+        if btype == BLOCK_IDB:
+            options = parse_options(body[8:], endian)
+            name = options.get(OPTION_IF_NAME, b"port%d" % len(interfaces))
+            interfaces.append(Interface(name.decode("utf-8", "replace")))
+        elif btype == BLOCK_EPB:
+            (iface, ts_high, ts_low, captured, original) = struct.unpack(endian + "IIIII", body[:20])
+            data = body[20:20 + captured]
+            options = parse_options(body[20 + ((captured + 3) & ~3):], endian)
+            direction = 0
+            if OPTION_EPB_FLAGS in options:
+                (flags,) = struct.unpack(endian + "I", options[OPTION_EPB_FLAGS])
+                direction = flags & 0x3
+            packets.append(Packet(interfaces[iface], (ts_high << 32) | ts_low, direction, data))
+
+        offset += total
+    return packets
+
+if __name__ == "__main__":
+    port = None
+    hexdump = False
+    i = 1
+    while i < len(sys.argv) and sys.argv[i].startswith("--"):
+        if sys.argv[i].startswith("--port="):
+            port = sys.argv[i][len("--port="):]
+        elif sys.argv[i] == "--hex":
+            hexdump = True
+        i = i + 1
+
+    if i >= len(sys.argv):
+        sys.stderr.write("Usage: %s [--port=NAME] [--hex] <capture.pcapng>\n" % sys.argv[0])
+        sys.exit(1)
+
+    for p in parse(sys.argv[i]):
+        if port is None or p.interface.name == port:
+            p.show(hexdump)
@@ -39,6 +39,7 @@
 # include <mm-call.h>
 # include <mm-bearer.h>
 # include <mm-modem.h>
+# include <mm-modem-snapshot.h>
 # include <mm-modem-3gpp.h>
 # include <mm-modem-3gpp-ussd.h>
 # include <mm-modem-cdma.h>
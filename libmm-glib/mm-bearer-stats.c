@@ -41,6 +41,8 @@ G_DEFINE_TYPE (MMBearerStats, mm_bearer_stats, G_TYPE_OBJECT)
 #define PROPERTY_TOTAL_DURATION  "total-duration"
 #define PROPERTY_TOTAL_RX_BYTES  "total-rx-bytes"
 #define PROPERTY_TOTAL_TX_BYTES  "total-tx-bytes"
+#define PROPERTY_RX_RATE         "rx-rate"
+#define PROPERTY_TX_RATE         "tx-rate"
 
 struct _MMBearerStatsPrivate {
     guint   duration;
@@ -51,6 +53,8 @@ struct _MMBearerStatsPrivate {
     guint   total_duration;
     guint64 total_rx_bytes;
     guint64 total_tx_bytes;
+    guint64 rx_rate;
+    guint64 tx_rate;
 };
 
 /*****************************************************************************/
@@ -313,6 +317,72 @@ mm_bearer_stats_set_total_tx_bytes (MMBearerStats *self,
 
 /*****************************************************************************/
 
+/**
+ * mm_bearer_stats_get_rx_rate:
+ * @self: a #MMBearerStats.
+ *
+ * Gets the average number of bytes received per second in the ongoing
+ * connection, measured between the last two statistics updates.
+ *
+ * Returns: a #guint64.
+ *
+ * Since: 1.16
+ */
+guint64
+mm_bearer_stats_get_rx_rate (MMBearerStats *self)
+{
+    g_return_val_if_fail (MM_IS_BEARER_STATS (self), 0);
+
+    return self->priv->rx_rate;
+}
+
+/**
+ * mm_bearer_stats_set_rx_rate: (skip)
+ */
+void
+mm_bearer_stats_set_rx_rate (MMBearerStats *self,
+                             guint64        rx_rate)
+{
+    g_return_if_fail (MM_IS_BEARER_STATS (self));
+
+    self->priv->rx_rate = rx_rate;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_bearer_stats_get_tx_rate:
+ * @self: a #MMBearerStats.
+ *
+ * Gets the average number of bytes transmitted per second in the ongoing
+ * connection, measured between the last two statistics updates.
+ *
+ * Returns: a #guint64.
+ *
+ * Since: 1.16
+ */
+guint64
+mm_bearer_stats_get_tx_rate (MMBearerStats *self)
+{
+    g_return_val_if_fail (MM_IS_BEARER_STATS (self), 0);
+
+    return self->priv->tx_rate;
+}
+
+/**
+ * mm_bearer_stats_set_tx_rate: (skip)
+ */
+void
+mm_bearer_stats_set_tx_rate (MMBearerStats *self,
+                             guint64        tx_rate)
+{
+    g_return_if_fail (MM_IS_BEARER_STATS (self));
+
+    self->priv->tx_rate = tx_rate;
+}
+
+/*****************************************************************************/
+
 /**
  * mm_bearer_stats_get_dictionary: (skip)
  */
@@ -358,6 +428,14 @@ mm_bearer_stats_get_dictionary (MMBearerStats *self)
                             "{sv}",
                             PROPERTY_TOTAL_TX_BYTES,
                             g_variant_new_uint64 (self->priv->total_tx_bytes));
+    g_variant_builder_add  (&builder,
+                            "{sv}",
+                            PROPERTY_RX_RATE,
+                            g_variant_new_uint64 (self->priv->rx_rate));
+    g_variant_builder_add  (&builder,
+                            "{sv}",
+                            PROPERTY_TX_RATE,
+                            g_variant_new_uint64 (self->priv->tx_rate));
     return g_variant_builder_end (&builder);
 }
 
@@ -423,6 +501,14 @@ mm_bearer_stats_new_from_dictionary (GVariant *dictionary,
             mm_bearer_stats_set_total_tx_bytes (
                 self,
                 g_variant_get_uint64 (value));
+        } else if (g_str_equal (key, PROPERTY_RX_RATE)) {
+            mm_bearer_stats_set_rx_rate (
+                self,
+                g_variant_get_uint64 (value));
+        } else if (g_str_equal (key, PROPERTY_TX_RATE)) {
+            mm_bearer_stats_set_tx_rate (
+                self,
+                g_variant_get_uint64 (value));
         }
 
         g_free (key);
@@ -242,6 +242,54 @@ mm_bearer_get_bearer_type (MMBearer *self)
 
 /*****************************************************************************/
 
+/**
+ * mm_bearer_get_connection_timings:
+ * @self: A #MMBearer.
+ * @timings: (out) (array length=n_timings): Return location for the array of
+ *  #MMBearerConnectionTiming values. The returned array should be freed with
+ *  mm_bearer_connection_timing_array_free() when no longer needed.
+ * @n_timings: (out): Return location for the number of values in @timings.
+ *
+ * Gets the steps of the last connection attempt, in the order in which they
+ * finished. The last step is always either <literal>"connected"</literal> or
+ * <literal>"failed"</literal>.
+ *
+ * Returns: %TRUE if @timings and @n_timings are set, %FALSE if there hasn't
+ * been any connection attempt yet.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_bearer_get_connection_timings (MMBearer                  *self,
+                                  MMBearerConnectionTiming **timings,
+                                  guint                     *n_timings)
+{
+    GVariant     *variant;
+    GVariantIter  iter;
+    const gchar  *step;
+    guint32       elapsed;
+    guint         i = 0;
+
+    g_return_val_if_fail (MM_IS_BEARER (self), FALSE);
+    g_return_val_if_fail (timings != NULL, FALSE);
+    g_return_val_if_fail (n_timings != NULL, FALSE);
+
+    variant = mm_gdbus_bearer_get_connection_timings (MM_GDBUS_BEARER (self));
+    if (!variant || !g_variant_n_children (variant))
+        return FALSE;
+
+    *n_timings = g_variant_iter_init (&iter, variant);
+    *timings = g_new0 (MMBearerConnectionTiming, *n_timings);
+    while (g_variant_iter_loop (&iter, "(&su)", &step, &elapsed)) {
+        (*timings)[i].step = g_strdup (step);
+        (*timings)[i].elapsed = elapsed;
+        i++;
+    }
+    return TRUE;
+}
+
+/*****************************************************************************/
+
 static void
 ipv4_config_updated (MMBearer *self,
                      GParamSpec *pspec)
@@ -34,6 +34,7 @@
 #include "mm-bearer-properties.h"
 #include "mm-bearer-ip-config.h"
 #include "mm-bearer-stats.h"
+#include "mm-helper-types.h"
 
 G_BEGIN_DECLS
 
@@ -116,6 +117,10 @@ MMBearerIpConfig   *mm_bearer_peek_ipv6_config (MMBearer *self);
 MMBearerStats      *mm_bearer_get_stats        (MMBearer *self);
 MMBearerStats      *mm_bearer_peek_stats       (MMBearer *self);
 
+gboolean            mm_bearer_get_connection_timings (MMBearer                  *self,
+                                                      MMBearerConnectionTiming **timings,
+                                                      guint                     *n_timings);
+
 G_END_DECLS
 
 #endif /* _MM_BEARER_H_ */
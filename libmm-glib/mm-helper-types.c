@@ -41,3 +41,45 @@ mm_modem_port_info_array_free (MMModemPortInfo *array,
         g_free (array[i].name);
     g_free (array);
 }
+
+/**
+ * mm_bearer_connection_timing_array_free:
+ * @array: an array of #MMBearerConnectionTiming values.
+ * @array_size: length of @array.
+ *
+ * Frees an array of #MMBearerConnectionTiming values.
+ *
+ * Since: 1.16
+ */
+void
+mm_bearer_connection_timing_array_free (MMBearerConnectionTiming *array,
+                                        guint array_size)
+{
+    guint i;
+
+    for (i = 0; i < array_size; i++)
+        g_free (array[i].step);
+    g_free (array);
+}
+
+/**
+ * mm_modem_connection_timing_histogram_array_free:
+ * @array: an array of #MMModemConnectionTimingHistogram values.
+ * @array_size: length of @array.
+ *
+ * Frees an array of #MMModemConnectionTimingHistogram values.
+ *
+ * Since: 1.16
+ */
+void
+mm_modem_connection_timing_histogram_array_free (MMModemConnectionTimingHistogram *array,
+                                                 guint array_size)
+{
+    guint i;
+
+    for (i = 0; i < array_size; i++) {
+        g_free (array[i].step);
+        g_free (array[i].buckets);
+    }
+    g_free (array);
+}
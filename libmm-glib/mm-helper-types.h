@@ -64,6 +64,46 @@ struct _MMModemPortInfo {
 void mm_modem_port_info_array_free (MMModemPortInfo *array,
                                     guint array_size);
 
+/**
+ * MMBearerConnectionTiming:
+ * @step: Name of the connection step.
+ * @elapsed: Milliseconds elapsed since the connection attempt was started
+ *  when the step finished.
+ *
+ * Time at which a given step of a connection attempt finished.
+ *
+ * Since: 1.16
+ */
+typedef struct _MMBearerConnectionTiming MMBearerConnectionTiming;
+struct _MMBearerConnectionTiming {
+    gchar *step;
+    guint elapsed;
+};
+
+void mm_bearer_connection_timing_array_free (MMBearerConnectionTiming *array,
+                                             guint array_size);
+
+/**
+ * MMModemConnectionTimingHistogram:
+ * @step: Name of the connection step, or <literal>"total"</literal>.
+ * @buckets: Counters of steps lasting up to 100, 250, 500, 1000, 2500, 5000,
+ *  10000, 30000 milliseconds, and longer.
+ * @n_buckets: Number of values in @buckets.
+ *
+ * Aggregated durations of a given connection step.
+ *
+ * Since: 1.16
+ */
+typedef struct _MMModemConnectionTimingHistogram MMModemConnectionTimingHistogram;
+struct _MMModemConnectionTimingHistogram {
+    gchar *step;
+    guint *buckets;
+    guint n_buckets;
+};
+
+void mm_modem_connection_timing_histogram_array_free (MMModemConnectionTimingHistogram *array,
+                                                      guint array_size);
+
 /**
  * MMOmaPendingNetworkInitiatedSession:
  * @session_type: A #MMOmaSessionType.
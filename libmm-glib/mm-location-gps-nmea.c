@@ -14,10 +14,7 @@
  */
 
 #include <string.h>
-#include <ctype.h>
-#include <stdlib.h>
 
-#include "mm-common-helpers.h"
 #include "mm-errors-types.h"
 #include "mm-location-gps-nmea.h"
 
@@ -36,86 +33,251 @@
 
 G_DEFINE_TYPE (MMLocationGpsNmea, mm_location_gps_nmea, G_TYPE_OBJECT)
 
+/* Longest sequence of GSV or GSA sentences stored for a single talker */
+#define MAX_SEQUENCE_PARTS 9
+
+/* Sentences with a well-known address get their slot without any string
+ * comparison */
+static const gchar *known_talkers[] = { "GP", "GL", "GA", "GB", "GN", "GQ", "BD" };
+static const gchar *known_types[]   = { "GGA", "RMC", "GSA", "GSV", "VTG", "GLL", "GNS", "ZDA", "GST" };
+#define N_KNOWN_TALKERS G_N_ELEMENTS (known_talkers)
+#define N_KNOWN_TYPES   G_N_ELEMENTS (known_types)
+
+typedef enum {
+    SEQUENCE_NONE,
+    /* Sentences carry their total count and index: '$xxGSV,<total>,<index>,...' */
+    SEQUENCE_INDEXED,
+    /* Consecutive sentences of the same type are one sequence (e.g. one GSA
+     * per constellation on each fix) */
+    SEQUENCE_CONSECUTIVE,
+} SequenceType;
+
+/* All sentences with the same address (e.g. '$GPGSV'). Part strings are
+ * reused for every new sentence, only growing when needed. */
+typedef struct {
+    gchar        *address;
+    SequenceType  sequence;
+    GString      *parts[MAX_SEQUENCE_PARTS];
+    guint         n_parts;
+    /* Parts joined with '\r\n', built on demand */
+    GString      *built;
+    gboolean      built_valid;
+} Slot;
+
 struct _MMLocationGpsNmeaPrivate {
-    GHashTable *traces;
-    GRegex *sequence_regex;
+    /* Slots in the order their addresses were first seen */
+    GPtrArray *slots;
+    Slot      *known[N_KNOWN_TALKERS][N_KNOWN_TYPES];
+    /* Slot of the last sentence added */
+    Slot      *last;
 };
 
 /*****************************************************************************/
 
-static gboolean
-check_append_or_replace (MMLocationGpsNmea *self,
-                         const gchar *trace)
+static void
+slot_free (Slot *slot)
+{
+    guint i;
+
+    for (i = 0; i < MAX_SEQUENCE_PARTS; i++) {
+        if (slot->parts[i])
+            g_string_free (slot->parts[i], TRUE);
+    }
+    if (slot->built)
+        g_string_free (slot->built, TRUE);
+    g_free (slot->address);
+    g_slice_free (Slot, slot);
+}
+
+/* Traces given by the user may already end with '\r\n' */
+static void
+append_trace (GString     *built,
+              const gchar *trace,
+              gssize       len)
+{
+    if (built->len && !g_str_has_suffix (built->str, "\r\n"))
+        g_string_append (built, "\r\n");
+    g_string_append_len (built, trace, len);
+}
+
+static const gchar *
+slot_get_string (Slot *slot)
+{
+    guint i;
+
+    if (!slot->n_parts)
+        return NULL;
+    if (slot->n_parts == 1)
+        return slot->parts[0]->str;
+
+    if (!slot->built_valid) {
+        if (!slot->built)
+            slot->built = g_string_sized_new (slot->n_parts * 80);
+        g_string_truncate (slot->built, 0);
+        for (i = 0; i < slot->n_parts; i++) {
+            /* Missing parts of an indexed sequence */
+            if (!slot->parts[i]->len)
+                continue;
+            append_trace (slot->built, slot->parts[i]->str, slot->parts[i]->len);
+        }
+        slot->built_valid = TRUE;
+    }
+    return slot->built->str;
+}
+
+static gint
+find_known (const gchar  *address,
+            gsize         address_len,
+            const gchar **known,
+            guint         n_known,
+            gsize         offset,
+            gsize         len)
+{
+    guint i;
+
+    if (address_len < offset + len)
+        return -1;
+    for (i = 0; i < n_known; i++) {
+        if (memcmp (address + offset, known[i], len) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/* @address includes the leading '$', and is not NUL-terminated */
+static Slot *
+lookup_slot (MMLocationGpsNmea *self,
+             const gchar       *address,
+             gsize              address_len,
+             gboolean           create)
+{
+    Slot  **known = NULL;
+    Slot   *slot;
+    gint    talker = -1;
+    gint    type = -1;
+    guint   i;
+
+    /* '$' + 2 chars talker + 3 chars type */
+    if (address_len == 6) {
+        talker = find_known (address, address_len, known_talkers, N_KNOWN_TALKERS, 1, 2);
+        if (talker >= 0)
+            type = find_known (address, address_len, known_types, N_KNOWN_TYPES, 3, 3);
+    }
+
+    if (talker >= 0 && type >= 0) {
+        known = &self->priv->known[talker][type];
+        if (*known)
+            return *known;
+    } else {
+        for (i = 0; i < self->priv->slots->len; i++) {
+            slot = g_ptr_array_index (self->priv->slots, i);
+            if (strncmp (slot->address, address, address_len) == 0 && !slot->address[address_len])
+                return slot;
+        }
+    }
+
+    if (!create)
+        return NULL;
+
+    slot = g_slice_new0 (Slot);
+    slot->address = g_strndup (address, address_len);
+    if (address_len == 6 && memcmp (address + 3, "GSV", 3) == 0)
+        slot->sequence = SEQUENCE_INDEXED;
+    else if (address_len == 6 && memcmp (address + 3, "GSA", 3) == 0)
+        slot->sequence = SEQUENCE_CONSECUTIVE;
+    else
+        slot->sequence = SEQUENCE_NONE;
+    g_ptr_array_add (self->priv->slots, slot);
+    if (known)
+        *known = slot;
+    return slot;
+}
+
+/* Index (1-based) of the sentence within its sequence, 0 if unknown */
+static guint
+get_sequence_index (const gchar *trace)
 {
-    /* By default, replace */
-    gboolean append_or_replace = FALSE;
-    GMatchInfo *match_info = NULL;
-
-    if (G_UNLIKELY (!self->priv->sequence_regex))
-        self->priv->sequence_regex = g_regex_new ("\\$GPGSV,(\\d),(\\d).*",
-                                                  G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                                                  0,
-                                                  NULL);
-
-    if (g_regex_match (self->priv->sequence_regex, trace, 0, &match_info)) {
-        guint index;
-
-        /* If we don't have the first element of a sequence, append */
-        if (mm_get_uint_from_match_info (match_info, 2, &index) && index != 1)
-            append_or_replace = TRUE;
+    const gchar *p;
+    guint        index = 0;
+
+    /* Skip address and total count fields */
+    p = strchr (trace, ',');
+    if (!p)
+        return 0;
+    p = strchr (p + 1, ',');
+    if (!p)
+        return 0;
+
+    for (p++; g_ascii_isdigit (*p); p++) {
+        index = index * 10 + (*p - '0');
+        if (index > MAX_SEQUENCE_PARTS)
+            return 0;
     }
-    g_match_info_free (match_info);
+    return (*p == ',' || *p == '*' || *p == '\0') ? index : 0;
+}
 
-    return append_or_replace;
+static void
+slot_set_part (Slot        *slot,
+               guint        part,
+               const gchar *trace,
+               gsize        len)
+{
+    if (!slot->parts[part])
+        slot->parts[part] = g_string_sized_new (len + 1);
+    g_string_truncate (slot->parts[part], 0);
+    g_string_append_len (slot->parts[part], trace, len);
 }
 
 static gboolean
-location_gps_nmea_take_trace (MMLocationGpsNmea *self,
-                              gchar *trace)
+location_gps_nmea_add_trace_len (MMLocationGpsNmea *self,
+                                 const gchar       *trace,
+                                 gsize              len)
 {
-    gchar *i;
-    gchar *trace_type;
+    const gchar *comma;
+    Slot        *slot;
+    guint        part = 0;
+    guint        i;
 
-    i = strchr (trace, ',');
-    if (!i || i == trace) {
-        g_free (trace);
+    comma = memchr (trace, ',', len);
+    if (!comma || comma == trace)
         return FALSE;
-    }
 
-    trace_type = g_malloc (i - trace + 1);
-    memcpy (trace_type, trace, i - trace);
-    trace_type[i - trace] = '\0';
+    slot = lookup_slot (self, trace, comma - trace, TRUE);
 
     /* Some traces are part of a SEQUENCE; so we need to decide whether we
-     * completely replace the previous trace, or we append the new one to
-     * the already existing list */
-    if (check_append_or_replace (self, trace)) {
-        /* Append */
-        const gchar *previous;
-
-        previous = g_hash_table_lookup (self->priv->traces, trace_type);
-        if (previous) {
-            gchar *sequence;
-
-            /* Skip the trace if we already have it there */
-            if (strstr (previous, trace)) {
-                g_free (trace_type);
-                g_free (trace);
-                return TRUE;
-            }
-
-            sequence = g_strdup_printf ("%s%s%s",
-                                        previous,
-                                        g_str_has_suffix (previous, "\r\n") ? "" : "\r\n",
-                                        trace);
-            g_free (trace);
-            trace = sequence;
+     * completely replace the previous trace, or we store the new one along
+     * with the previous ones */
+    switch (slot->sequence) {
+    case SEQUENCE_INDEXED:
+        part = get_sequence_index (trace);
+        if (part <= 1)
+            part = 0;
+        else
+            part--;
+        break;
+    case SEQUENCE_CONSECUTIVE:
+        if (self->priv->last == slot && slot->n_parts < MAX_SEQUENCE_PARTS)
+            part = slot->n_parts;
+        break;
+    case SEQUENCE_NONE:
+    default:
+        break;
+    }
+
+    if (part == 0) {
+        /* New sequence, previous parts are dropped */
+        slot->n_parts = 1;
+    } else {
+        /* Parts skipped (e.g. missed sentences) are left empty */
+        for (i = slot->n_parts; i < part; i++) {
+            slot_set_part (slot, i, "", 0);
         }
+        slot->n_parts = MAX (slot->n_parts, part + 1);
     }
 
-    g_hash_table_replace (self->priv->traces,
-                          trace_type,
-                          trace);
+    slot_set_part (slot, part, trace, len);
+    slot->built_valid = FALSE;
+    self->priv->last = slot;
     return TRUE;
 }
 
@@ -126,7 +288,7 @@ gboolean
 mm_location_gps_nmea_add_trace (MMLocationGpsNmea *self,
                                 const gchar *trace)
 {
-    return location_gps_nmea_take_trace (self, g_strdup (trace));
+    return location_gps_nmea_add_trace_len (self, trace, strlen (trace));
 }
 
 /*****************************************************************************/
@@ -147,21 +309,14 @@ const gchar *
 mm_location_gps_nmea_get_trace (MMLocationGpsNmea *self,
                                 const gchar *trace_type)
 {
-    return (const gchar *)g_hash_table_lookup (self->priv->traces, trace_type);
+    Slot *slot;
+
+    slot = lookup_slot (self, trace_type, strlen (trace_type), FALSE);
+    return slot ? slot_get_string (slot) : NULL;
 }
 
 /*****************************************************************************/
 
-static void
-build_all_foreach (const gchar  *trace_type,
-                   const gchar  *trace,
-                   GPtrArray   **built)
-{
-    if (*built == NULL)
-        *built = g_ptr_array_new ();
-    g_ptr_array_add (*built, g_strdup (trace));
-}
-
 /**
  * mm_location_gps_nmea_get_traces:
  * @self: a #MMLocationGpsNmea.
@@ -175,10 +330,18 @@ gchar **
 mm_location_gps_nmea_get_traces (MMLocationGpsNmea *self)
 {
     GPtrArray *built = NULL;
+    guint      i;
+
+    for (i = 0; i < self->priv->slots->len; i++) {
+        const gchar *trace;
 
-    g_hash_table_foreach (self->priv->traces,
-                          (GHFunc)build_all_foreach,
-                          &built);
+        trace = slot_get_string (g_ptr_array_index (self->priv->slots, i));
+        if (!trace)
+            continue;
+        if (!built)
+            built = g_ptr_array_new ();
+        g_ptr_array_add (built, g_strdup (trace));
+    }
     if (!built)
         return NULL;
 
@@ -188,19 +351,26 @@ mm_location_gps_nmea_get_traces (MMLocationGpsNmea *self)
 
 /*****************************************************************************/
 
-#ifndef MM_DISABLE_DEPRECATED
-
-static void
-build_full_foreach (const gchar *trace_type,
-                    const gchar *trace,
-                    GString **built)
+static gchar *
+build_full (MMLocationGpsNmea *self)
 {
-    if ((*built)->len == 0 || g_str_has_suffix ((*built)->str, "\r\n"))
-        g_string_append (*built, trace);
-    else
-        g_string_append_printf (*built, "\r\n%s", trace);
+    GString *built;
+    guint    i;
+
+    built = g_string_new ("");
+    for (i = 0; i < self->priv->slots->len; i++) {
+        const gchar *trace;
+
+        trace = slot_get_string (g_ptr_array_index (self->priv->slots, i));
+        if (!trace)
+            continue;
+        append_trace (built, trace, -1);
+    }
+    return g_string_free (built, FALSE);
 }
 
+#ifndef MM_DISABLE_DEPRECATED
+
 /**
  * mm_location_gps_nmea_build_full:
  * @self: a #MMLocationGpsNmea.
@@ -218,13 +388,7 @@ build_full_foreach (const gchar *trace_type,
 gchar *
 mm_location_gps_nmea_build_full (MMLocationGpsNmea *self)
 {
-    GString *built;
-
-    built = g_string_new ("");
-    g_hash_table_foreach (self->priv->traces,
-                          (GHFunc)build_full_foreach,
-                          &built);
-    return g_string_free (built, FALSE);
+    return build_full (self);
 }
 
 #endif
@@ -237,14 +401,9 @@ mm_location_gps_nmea_build_full (MMLocationGpsNmea *self)
 GVariant *
 mm_location_gps_nmea_get_string_variant (MMLocationGpsNmea *self)
 {
-    g_autofree gchar *built = NULL;
-    g_auto (GStrv)    traces = NULL;
-
     g_return_val_if_fail (MM_IS_LOCATION_GPS_NMEA (self), NULL);
 
-    traces = mm_location_gps_nmea_get_traces (self);
-    built = g_strjoinv ("\r\n", traces);
-    return g_variant_ref_sink (g_variant_new_string (built));
+    return g_variant_ref_sink (g_variant_new_take_string (build_full (self)));
 }
 
 /*****************************************************************************/
@@ -257,8 +416,7 @@ mm_location_gps_nmea_new_from_string_variant (GVariant *string,
                                               GError **error)
 {
     MMLocationGpsNmea *self = NULL;
-    gchar **split;
-    guint i;
+    const gchar       *str;
 
     if (!g_variant_is_of_type (string, G_VARIANT_TYPE_STRING)) {
         g_set_error (error,
@@ -269,26 +427,21 @@ mm_location_gps_nmea_new_from_string_variant (GVariant *string,
         return NULL;
     }
 
-    split = g_strsplit (g_variant_get_string (string, NULL), "\r\n", -1);
-    if (!split) {
-        g_set_error (error,
-                     MM_CORE_ERROR,
-                     MM_CORE_ERROR_INVALID_ARGS,
-                     "Invalid GPS NMEA location string: '%s'",
-                     g_variant_get_string (string, NULL));
-        return NULL;
-    }
+    str = g_variant_get_string (string, NULL);
 
     /* Create new location object */
     self = mm_location_gps_nmea_new ();
 
-    for (i = 0; split[i]; i++) {
-        location_gps_nmea_take_trace (self, split[i]);
-    }
+    /* Traces are added straight from the '\r\n'-separated string */
+    while (*str) {
+        const gchar *end;
 
-    /* Note that the strings in the array of strings were already taken
-     * or freed */
-    g_free (split);
+        end = strstr (str, "\r\n");
+        if (!end)
+            end = str + strlen (str);
+        location_gps_nmea_add_trace_len (self, str, end - str);
+        str = *end ? end + 2 : end;
+    }
 
     return self;
 }
@@ -312,10 +465,7 @@ mm_location_gps_nmea_init (MMLocationGpsNmea *self)
                                               MM_TYPE_LOCATION_GPS_NMEA,
                                               MMLocationGpsNmeaPrivate);
 
-    self->priv->traces = g_hash_table_new_full (g_str_hash,
-                                                g_str_equal,
-                                                g_free,
-                                                g_free);
+    self->priv->slots = g_ptr_array_new_with_free_func ((GDestroyNotify) slot_free);
 }
 
 static void
@@ -323,9 +473,7 @@ finalize (GObject *object)
 {
     MMLocationGpsNmea *self = MM_LOCATION_GPS_NMEA (object);
 
-    g_hash_table_destroy (self->priv->traces);
-    if (self->priv->sequence_regex)
-        g_regex_unref (self->priv->sequence_regex);
+    g_ptr_array_unref (self->priv->slots);
 
     G_OBJECT_CLASS (mm_location_gps_nmea_parent_class)->finalize (object);
 }
@@ -49,6 +49,7 @@ struct _MMLocationGpsRawPrivate {
     gdouble  latitude;
     gdouble  longitude;
     gdouble  altitude;
+    guint    fix_quality;
 };
 
 /*****************************************************************************/
@@ -135,6 +136,17 @@ mm_location_gps_raw_get_altitude (MMLocationGpsRaw *self)
     return self->priv->altitude;
 }
 
+/**
+ * mm_location_gps_raw_get_fix_quality: (skip)
+ */
+guint
+mm_location_gps_raw_get_fix_quality (MMLocationGpsRaw *self)
+{
+    g_return_val_if_fail (MM_IS_LOCATION_GPS_RAW (self), 0);
+
+    return self->priv->fix_quality;
+}
+
 /*****************************************************************************/
 
 static gboolean
@@ -256,6 +268,10 @@ mm_location_gps_raw_add_trace (MMLocationGpsRaw *self,
             g_free (str);
         }
 
+        /* Fix quality */
+        self->priv->fix_quality = 0;
+        mm_get_uint_from_match_info (match_info, 6, &self->priv->fix_quality);
+
         /* Altitude */
         self->priv->altitude = MM_LOCATION_ALTITUDE_UNKNOWN;
         mm_get_double_from_match_info (match_info, 9, &self->priv->altitude);
@@ -79,6 +79,9 @@ gboolean mm_location_gps_raw_add_trace (MMLocationGpsRaw *self,
 
 GVariant *mm_location_gps_raw_get_dictionary (MMLocationGpsRaw *self);
 
+/* GGA quality indicator of the last fix, 0 if invalid */
+guint mm_location_gps_raw_get_fix_quality (MMLocationGpsRaw *self);
+
 #endif
 
 G_END_DECLS
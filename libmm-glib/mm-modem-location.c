@@ -565,6 +565,196 @@ mm_modem_location_set_gps_refresh_rate_sync (MMModemLocation *self,
 
 /*****************************************************************************/
 
+/**
+ * mm_modem_location_subscribe_finish:
+ * @self: A #MMModemLocation.
+ * @res: The #GAsyncResult obtained from the #GAsyncReadyCallback passed to
+ *  mm_modem_location_subscribe().
+ * @error: Return location for error or %NULL.
+ *
+ * Finishes an operation started with mm_modem_location_subscribe().
+ *
+ * Returns: %TRUE if the subscription was successful, %FALSE if @error is set.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_location_subscribe_finish (MMModemLocation *self,
+                                    GAsyncResult *res,
+                                    GError **error)
+{
+    g_return_val_if_fail (MM_IS_MODEM_LOCATION (self), FALSE);
+
+    return mm_gdbus_modem_location_call_subscribe_finish (MM_GDBUS_MODEM_LOCATION (self), res, error);
+}
+
+/**
+ * mm_modem_location_subscribe:
+ * @self: A #MMModemLocation.
+ * @sources: Bitmask of #MMModemLocationSource values to get updates for.
+ * @interval: Minimum time between two updates, in milliseconds.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @callback: A #GAsyncReadyCallback to call when the request is satisfied or %NULL.
+ * @user_data: User data to pass to @callback.
+ *
+ * Asynchronously subscribes to the updates of the given location sources,
+ * which are then sent to this client only, in the
+ * #MmGdbusModemLocation::updated signal.
+ *
+ * Only %MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI and
+ * %MM_MODEM_LOCATION_SOURCE_GPS_RAW are allowed in @sources. An @interval
+ * below 1000ms is raised to 1000ms.
+ *
+ * When the operation is finished, @callback will be invoked in the
+ * <link linkend="g-main-context-push-thread-default">thread-default main loop</link>
+ * of the thread you are calling this method from. You can then call
+ * mm_modem_location_subscribe_finish() to get the result of the operation.
+ *
+ * See mm_modem_location_subscribe_sync() for the synchronous, blocking version
+ * of this method.
+ *
+ * Since: 1.16
+ */
+void
+mm_modem_location_subscribe (MMModemLocation *self,
+                             MMModemLocationSource sources,
+                             guint interval,
+                             GCancellable *cancellable,
+                             GAsyncReadyCallback callback,
+                             gpointer user_data)
+{
+    g_return_if_fail (MM_IS_MODEM_LOCATION (self));
+
+    mm_gdbus_modem_location_call_subscribe (MM_GDBUS_MODEM_LOCATION (self),
+                                            sources,
+                                            interval,
+                                            cancellable,
+                                            callback,
+                                            user_data);
+}
+
+/**
+ * mm_modem_location_subscribe_sync:
+ * @self: A #MMModemLocation.
+ * @sources: Bitmask of #MMModemLocationSource values to get updates for.
+ * @interval: Minimum time between two updates, in milliseconds.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @error: Return location for error or %NULL.
+ *
+ * Synchronously subscribes to the updates of the given location sources.
+ *
+ * The calling thread is blocked until a reply is received. See
+ * mm_modem_location_subscribe() for the asynchronous version of this method.
+ *
+ * Returns: %TRUE if the subscription was successful, %FALSE if @error is set.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_location_subscribe_sync (MMModemLocation *self,
+                                  MMModemLocationSource sources,
+                                  guint interval,
+                                  GCancellable *cancellable,
+                                  GError **error)
+{
+    g_return_val_if_fail (MM_IS_MODEM_LOCATION (self), FALSE);
+
+    return mm_gdbus_modem_location_call_subscribe_sync (MM_GDBUS_MODEM_LOCATION (self),
+                                                        sources,
+                                                        interval,
+                                                        cancellable,
+                                                        error);
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_location_unsubscribe_finish:
+ * @self: A #MMModemLocation.
+ * @res: The #GAsyncResult obtained from the #GAsyncReadyCallback passed to
+ *  mm_modem_location_unsubscribe().
+ * @error: Return location for error or %NULL.
+ *
+ * Finishes an operation started with mm_modem_location_unsubscribe().
+ *
+ * Returns: %TRUE if the subscription was dropped, %FALSE if @error is set.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_location_unsubscribe_finish (MMModemLocation *self,
+                                      GAsyncResult *res,
+                                      GError **error)
+{
+    g_return_val_if_fail (MM_IS_MODEM_LOCATION (self), FALSE);
+
+    return mm_gdbus_modem_location_call_unsubscribe_finish (MM_GDBUS_MODEM_LOCATION (self), res, error);
+}
+
+/**
+ * mm_modem_location_unsubscribe:
+ * @self: A #MMModemLocation.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @callback: A #GAsyncReadyCallback to call when the request is satisfied or %NULL.
+ * @user_data: User data to pass to @callback.
+ *
+ * Asynchronously drops the subscription created with
+ * mm_modem_location_subscribe().
+ *
+ * When the operation is finished, @callback will be invoked in the
+ * <link linkend="g-main-context-push-thread-default">thread-default main loop</link>
+ * of the thread you are calling this method from. You can then call
+ * mm_modem_location_unsubscribe_finish() to get the result of the operation.
+ *
+ * See mm_modem_location_unsubscribe_sync() for the synchronous, blocking
+ * version of this method.
+ *
+ * Since: 1.16
+ */
+void
+mm_modem_location_unsubscribe (MMModemLocation *self,
+                               GCancellable *cancellable,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data)
+{
+    g_return_if_fail (MM_IS_MODEM_LOCATION (self));
+
+    mm_gdbus_modem_location_call_unsubscribe (MM_GDBUS_MODEM_LOCATION (self),
+                                              cancellable,
+                                              callback,
+                                              user_data);
+}
+
+/**
+ * mm_modem_location_unsubscribe_sync:
+ * @self: A #MMModemLocation.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @error: Return location for error or %NULL.
+ *
+ * Synchronously drops the subscription created with
+ * mm_modem_location_subscribe().
+ *
+ * The calling thread is blocked until a reply is received. See
+ * mm_modem_location_unsubscribe() for the asynchronous version of this method.
+ *
+ * Returns: %TRUE if the subscription was dropped, %FALSE if @error is set.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_location_unsubscribe_sync (MMModemLocation *self,
+                                    GCancellable *cancellable,
+                                    GError **error)
+{
+    g_return_val_if_fail (MM_IS_MODEM_LOCATION (self), FALSE);
+
+    return mm_gdbus_modem_location_call_unsubscribe_sync (MM_GDBUS_MODEM_LOCATION (self),
+                                                          cancellable,
+                                                          error);
+}
+
+/*****************************************************************************/
+
 static gboolean
 build_locations (GVariant *dictionary,
                  MMLocation3gpp **location_3gpp,
@@ -143,6 +143,32 @@ gboolean mm_modem_location_set_gps_refresh_rate_sync   (MMModemLocation *self,
                                                         GCancellable *cancellable,
                                                         GError **error);
 
+void     mm_modem_location_subscribe          (MMModemLocation *self,
+                                               MMModemLocationSource sources,
+                                               guint interval,
+                                               GCancellable *cancellable,
+                                               GAsyncReadyCallback callback,
+                                               gpointer user_data);
+gboolean mm_modem_location_subscribe_finish   (MMModemLocation *self,
+                                               GAsyncResult *res,
+                                               GError **error);
+gboolean mm_modem_location_subscribe_sync     (MMModemLocation *self,
+                                               MMModemLocationSource sources,
+                                               guint interval,
+                                               GCancellable *cancellable,
+                                               GError **error);
+
+void     mm_modem_location_unsubscribe        (MMModemLocation *self,
+                                               GCancellable *cancellable,
+                                               GAsyncReadyCallback callback,
+                                               gpointer user_data);
+gboolean mm_modem_location_unsubscribe_finish (MMModemLocation *self,
+                                               GAsyncResult *res,
+                                               GError **error);
+gboolean mm_modem_location_unsubscribe_sync   (MMModemLocation *self,
+                                               GCancellable *cancellable,
+                                               GError **error);
+
 void            mm_modem_location_get_3gpp        (MMModemLocation *self,
                                                    GCancellable *cancellable,
                                                    GAsyncReadyCallback callback,
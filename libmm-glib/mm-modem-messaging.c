@@ -213,6 +213,62 @@ mm_modem_messaging_peek_supported_storages (MMModemMessaging *self,
 
 /*****************************************************************************/
 
+/**
+ * mm_modem_messaging_get_multipart_stats:
+ * @self: A #MMModem.
+ * @n_in_flight: (out) (allow-none): Return location for the number of
+ *  incomplete multipart messages being reassembled, or %NULL.
+ * @n_pending_parts: (out) (allow-none): Return location for the number of
+ *  parts received for the incomplete messages, or %NULL.
+ * @n_expired: (out) (allow-none): Return location for the number of
+ *  incomplete messages whose remaining parts didn't arrive in time, or %NULL.
+ * @n_evicted: (out) (allow-none): Return location for the number of
+ *  incomplete messages removed to make room for newer ones, or %NULL.
+ *
+ * Gets the statistics of the reassembly of multipart messages received from
+ * the network.
+ *
+ * Returns: %TRUE if the statistics are available, %FALSE otherwise.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_messaging_get_multipart_stats (MMModemMessaging *self,
+                                        guint            *n_in_flight,
+                                        guint            *n_pending_parts,
+                                        guint            *n_expired,
+                                        guint            *n_evicted)
+{
+    GVariant *dictionary;
+    guint     in_flight = 0;
+    guint     pending_parts = 0;
+    guint     expired = 0;
+    guint     evicted = 0;
+
+    g_return_val_if_fail (MM_IS_MODEM_MESSAGING (self), FALSE);
+
+    dictionary = mm_gdbus_modem_messaging_get_multipart_stats (MM_GDBUS_MODEM_MESSAGING (self));
+    if (!dictionary)
+        return FALSE;
+
+    g_variant_lookup (dictionary, "in-flight",     "u", &in_flight);
+    g_variant_lookup (dictionary, "pending-parts", "u", &pending_parts);
+    g_variant_lookup (dictionary, "expired",       "u", &expired);
+    g_variant_lookup (dictionary, "evicted",       "u", &evicted);
+
+    if (n_in_flight)
+        *n_in_flight = in_flight;
+    if (n_pending_parts)
+        *n_pending_parts = pending_parts;
+    if (n_expired)
+        *n_expired = expired;
+    if (n_evicted)
+        *n_evicted = evicted;
+    return TRUE;
+}
+
+/*****************************************************************************/
+
 /**
  * mm_modem_messaging_get_default_storage:
  * @self: A #MMModem.
@@ -723,6 +779,271 @@ mm_modem_messaging_delete_sync (MMModemMessaging *self,
 
 /*****************************************************************************/
 
+struct _MMModemMessagingBatchResult {
+    gboolean sent;
+    guint message_reference;
+    gchar *error_message;
+};
+
+/**
+ * mm_modem_messaging_batch_result_free:
+ * @result: A #MMModemMessagingBatchResult.
+ *
+ * Frees a #MMModemMessagingBatchResult.
+ *
+ * Since: 1.16
+ */
+void
+mm_modem_messaging_batch_result_free (MMModemMessagingBatchResult *result)
+{
+    if (!result)
+        return;
+
+    g_free (result->error_message);
+    g_slice_free (MMModemMessagingBatchResult, result);
+}
+
+static MMModemMessagingBatchResult *
+modem_messaging_batch_result_copy (MMModemMessagingBatchResult *result)
+{
+    MMModemMessagingBatchResult *result_copy;
+
+    result_copy = g_slice_new0 (MMModemMessagingBatchResult);
+    result_copy->sent              = result->sent;
+    result_copy->message_reference = result->message_reference;
+    result_copy->error_message     = g_strdup (result->error_message);
+
+    return result_copy;
+}
+
+G_DEFINE_BOXED_TYPE (MMModemMessagingBatchResult, mm_modem_messaging_batch_result, (GBoxedCopyFunc)modem_messaging_batch_result_copy, (GBoxedFreeFunc)mm_modem_messaging_batch_result_free)
+
+/**
+ * mm_modem_messaging_batch_result_get_sent:
+ * @result: A #MMModemMessagingBatchResult.
+ *
+ * Checks whether the message was sent.
+ *
+ * Returns: %TRUE if the message was sent, %FALSE otherwise.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_messaging_batch_result_get_sent (const MMModemMessagingBatchResult *result)
+{
+    g_return_val_if_fail (result != NULL, FALSE);
+
+    return result->sent;
+}
+
+/**
+ * mm_modem_messaging_batch_result_get_message_reference:
+ * @result: A #MMModemMessagingBatchResult.
+ *
+ * Gets the message reference given by the network to the last part of the
+ * message.
+ *
+ * Returns: The message reference, or 0 if the message wasn't sent.
+ *
+ * Since: 1.16
+ */
+guint
+mm_modem_messaging_batch_result_get_message_reference (const MMModemMessagingBatchResult *result)
+{
+    g_return_val_if_fail (result != NULL, 0);
+
+    return result->message_reference;
+}
+
+/**
+ * mm_modem_messaging_batch_result_get_error_message:
+ * @result: A #MMModemMessagingBatchResult.
+ *
+ * Gets the description of the error found when sending the message.
+ *
+ * Returns: (transfer none): The error description, or %NULL if the message
+ * was sent.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_messaging_batch_result_get_error_message (const MMModemMessagingBatchResult *result)
+{
+    g_return_val_if_fail (result != NULL, NULL);
+
+    return result->error_message;
+}
+
+/*****************************************************************************/
+
+static GVariant *
+build_batch_messages (GList *properties)
+{
+    GVariantBuilder builder;
+    GList *l;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+    for (l = properties; l; l = g_list_next (l)) {
+        GVariant *dictionary;
+
+        dictionary = mm_sms_properties_get_dictionary (MM_SMS_PROPERTIES (l->data));
+        g_variant_builder_add_value (&builder, dictionary);
+        g_variant_unref (dictionary);
+    }
+    return g_variant_builder_end (&builder);
+}
+
+static GList *
+create_batch_results_list (GVariant *variant)
+{
+    GList *list = NULL;
+    GVariantIter iter;
+    gboolean sent;
+    guint message_reference;
+    const gchar *error_message;
+
+    /* Input is a(bus) */
+    g_variant_iter_init (&iter, variant);
+    while (g_variant_iter_next (&iter, "(bu&s)", &sent, &message_reference, &error_message)) {
+        MMModemMessagingBatchResult *result;
+
+        result = g_slice_new0 (MMModemMessagingBatchResult);
+        result->sent = sent;
+        result->message_reference = message_reference;
+        if (!sent)
+            result->error_message = g_strdup (error_message);
+        list = g_list_prepend (list, result);
+    }
+
+    /* Results are given in the same order as the messages */
+    return g_list_reverse (list);
+}
+
+/**
+ * mm_modem_messaging_send_batch_finish:
+ * @self: A #MMModemMessaging.
+ * @res: The #GAsyncResult obtained from the #GAsyncReadyCallback passed to
+ *  mm_modem_messaging_send_batch().
+ * @error: Return location for error or %NULL.
+ *
+ * Finishes an operation started with mm_modem_messaging_send_batch().
+ *
+ * Returns: (transfer full) (element-type ModemManager.ModemMessagingBatchResult):
+ * a list of #MMModemMessagingBatchResult structs, one per message and in the
+ * same order, or #NULL if @error is set. The returned value should be freed
+ * with g_list_free_full() using mm_modem_messaging_batch_result_free() as
+ * #GDestroyNotify function.
+ *
+ * Since: 1.16
+ */
+GList *
+mm_modem_messaging_send_batch_finish (MMModemMessaging *self,
+                                      GAsyncResult *res,
+                                      GError **error)
+{
+    GVariant *results = NULL;
+    GList *list;
+
+    g_return_val_if_fail (MM_IS_MODEM_MESSAGING (self), NULL);
+
+    if (!mm_gdbus_modem_messaging_call_send_batch_finish (MM_GDBUS_MODEM_MESSAGING (self), &results, res, error))
+        return NULL;
+
+    list = create_batch_results_list (results);
+    g_variant_unref (results);
+    return list;
+}
+
+/**
+ * mm_modem_messaging_send_batch:
+ * @self: A #MMModemMessaging.
+ * @properties: (element-type ModemManager.SmsProperties): A list of
+ *  #MMSmsProperties objects, one per message to send.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @callback: A #GAsyncReadyCallback to call when the request is satisfied or
+ *  %NULL.
+ * @user_data: User data to pass to @callback.
+ *
+ * Asynchronously sends a set of messages, without creating #MMSms objects
+ * for them.
+ *
+ * A failure sending one of the messages doesn't stop the remaining ones
+ * from being sent; the result of each message is reported separately. Lists
+ * of more than 64 messages are rejected with %MM_CORE_ERROR_TOO_MANY.
+ *
+ * When the operation is finished, @callback will be invoked in the
+ * <link linkend="g-main-context-push-thread-default">thread-default main loop</link>
+ * of the thread you are calling this method from. You can then call
+ * mm_modem_messaging_send_batch_finish() to get the result of the operation.
+ *
+ * See mm_modem_messaging_send_batch_sync() for the synchronous, blocking
+ * version of this method.
+ *
+ * Since: 1.16
+ */
+void
+mm_modem_messaging_send_batch (MMModemMessaging *self,
+                               GList *properties,
+                               GCancellable *cancellable,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data)
+{
+    g_return_if_fail (MM_IS_MODEM_MESSAGING (self));
+
+    mm_gdbus_modem_messaging_call_send_batch (MM_GDBUS_MODEM_MESSAGING (self),
+                                              build_batch_messages (properties),
+                                              cancellable,
+                                              callback,
+                                              user_data);
+}
+
+/**
+ * mm_modem_messaging_send_batch_sync:
+ * @self: A #MMModemMessaging.
+ * @properties: (element-type ModemManager.SmsProperties): A list of
+ *  #MMSmsProperties objects, one per message to send.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @error: Return location for error or %NULL.
+ *
+ * Synchronously sends a set of messages, without creating #MMSms objects
+ * for them.
+ *
+ * The calling thread is blocked until a reply is received. See
+ * mm_modem_messaging_send_batch() for the asynchronous version of this method.
+ *
+ * Returns: (transfer full) (element-type ModemManager.ModemMessagingBatchResult):
+ * a list of #MMModemMessagingBatchResult structs, one per message and in the
+ * same order, or #NULL if @error is set. The returned value should be freed
+ * with g_list_free_full() using mm_modem_messaging_batch_result_free() as
+ * #GDestroyNotify function.
+ *
+ * Since: 1.16
+ */
+GList *
+mm_modem_messaging_send_batch_sync (MMModemMessaging *self,
+                                    GList *properties,
+                                    GCancellable *cancellable,
+                                    GError **error)
+{
+    GVariant *results = NULL;
+    GList *list;
+
+    g_return_val_if_fail (MM_IS_MODEM_MESSAGING (self), NULL);
+
+    if (!mm_gdbus_modem_messaging_call_send_batch_sync (MM_GDBUS_MODEM_MESSAGING (self),
+                                                        build_batch_messages (properties),
+                                                        &results,
+                                                        cancellable,
+                                                        error))
+        return NULL;
+
+    list = create_batch_results_list (results);
+    g_variant_unref (results);
+    return list;
+}
+
+/*****************************************************************************/
+
 static void
 mm_modem_messaging_init (MMModemMessaging *self)
 {
@@ -79,6 +79,12 @@ gboolean     mm_modem_messaging_peek_supported_storages (MMModemMessaging *self,
 
 MMSmsStorage mm_modem_messaging_get_default_storage    (MMModemMessaging *self);
 
+gboolean     mm_modem_messaging_get_multipart_stats    (MMModemMessaging *self,
+                                                        guint *n_in_flight,
+                                                        guint *n_pending_parts,
+                                                        guint *n_expired,
+                                                        guint *n_evicted);
+
 void   mm_modem_messaging_create        (MMModemMessaging *self,
                                          MMSmsProperties *properties,
                                          GCancellable *cancellable,
@@ -116,6 +122,36 @@ gboolean mm_modem_messaging_delete_sync   (MMModemMessaging *self,
                                            GCancellable *cancellable,
                                            GError **error);
 
+/**
+ * MMModemMessagingBatchResult:
+ *
+ * The #MMModemMessagingBatchResult structure contains private data and should
+ * only be accessed using the provided API.
+ */
+typedef struct _MMModemMessagingBatchResult MMModemMessagingBatchResult;
+
+#define MM_TYPE_MODEM_MESSAGING_BATCH_RESULT (mm_modem_messaging_batch_result_get_type ())
+GType mm_modem_messaging_batch_result_get_type (void);
+
+gboolean     mm_modem_messaging_batch_result_get_sent              (const MMModemMessagingBatchResult *result);
+guint        mm_modem_messaging_batch_result_get_message_reference (const MMModemMessagingBatchResult *result);
+const gchar *mm_modem_messaging_batch_result_get_error_message     (const MMModemMessagingBatchResult *result);
+void         mm_modem_messaging_batch_result_free                  (MMModemMessagingBatchResult *result);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMModemMessagingBatchResult, mm_modem_messaging_batch_result_free)
+
+void   mm_modem_messaging_send_batch        (MMModemMessaging *self,
+                                             GList *properties,
+                                             GCancellable *cancellable,
+                                             GAsyncReadyCallback callback,
+                                             gpointer user_data);
+GList *mm_modem_messaging_send_batch_finish (MMModemMessaging *self,
+                                             GAsyncResult *res,
+                                             GError **error);
+GList *mm_modem_messaging_send_batch_sync   (MMModemMessaging *self,
+                                             GList *properties,
+                                             GCancellable *cancellable,
+                                             GError **error);
+
 G_END_DECLS
 
 #endif /* _MM_MODEM_MESSAGING_H_ */
@@ -0,0 +1,989 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * libmm -- Access modem status & information from glib applications
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ */
+
+#include "mm-helpers.h"
+#include "mm-modem-snapshot.h"
+
+/**
+ * SECTION: mm-modem-snapshot
+ * @title: MMModemSnapshot
+ * @short_description: Helper object holding all the Modem interface properties.
+ *
+ * The #MMModemSnapshot is an immutable object holding the values of all the
+ * properties of the Modem interface at a given time.
+ *
+ * This object is retrieved from the #MMModem object with
+ * mm_modem_get_snapshot(). As long as none of the properties change, the same
+ * #MMModemSnapshot is given to every caller, so clients reading the whole
+ * modem state periodically don't need to decode the properties again each
+ * time. Unlike the values returned by the #MMModem getters, the ones returned
+ * by a #MMModemSnapshot are valid for as long as the object is alive, in any
+ * thread.
+ */
+
+G_DEFINE_TYPE (MMModemSnapshot, mm_modem_snapshot, G_TYPE_OBJECT)
+
+struct _MMModemSnapshotPrivate {
+    gchar *path;
+    gchar *sim_path;
+    GArray *supported_capabilities;
+    MMModemCapability current_capabilities;
+    guint max_bearers;
+    guint max_active_bearers;
+    gchar **bearer_paths;
+    gchar *manufacturer;
+    gchar *model;
+    gchar *revision;
+    gchar *carrier_configuration;
+    gchar *carrier_configuration_revision;
+    gchar *hardware_revision;
+    gchar *device_identifier;
+    gchar *device;
+    gchar **drivers;
+    gchar *plugin;
+    gchar *primary_port;
+    GArray *ports;
+    gchar *equipment_identifier;
+    gchar **own_numbers;
+    MMModemLock unlock_required;
+    MMUnlockRetries *unlock_retries;
+    MMModemState state;
+    MMModemStateFailedReason state_failed_reason;
+    MMModemPowerState power_state;
+    MMModemAccessTechnology access_technologies;
+    guint signal_quality;
+    gboolean signal_quality_recent;
+    GArray *supported_modes;
+    gboolean current_modes_set;
+    MMModemMode current_modes_allowed;
+    MMModemMode current_modes_preferred;
+    GArray *supported_bands;
+    GArray *current_bands;
+    MMBearerIpFamily supported_ip_families;
+};
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_get_path:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the DBus path of the #MMObject the snapshot was taken from.
+ *
+ * Returns: (transfer none): The DBus path of the #MMObject object. Do not free
+ * the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_path (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->path;
+}
+
+/**
+ * mm_modem_snapshot_get_sim_path:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the DBus path of the #MMSim handled in this #MMModem.
+ *
+ * Returns: (transfer none): The DBus path of the #MMSim, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_sim_path (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->sim_path;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_peek_supported_capabilities:
+ * @self: A #MMModemSnapshot.
+ * @capabilities: (out) (array length=n_capabilities): Return location for the
+ *  array of #MMModemCapability values. Do not free the returned array, it is
+ *  owned by @self.
+ * @n_capabilities: (out): Return location for the number of values in
+ *  @capabilities.
+ *
+ * Gets the list of combinations of generic families of access technologies
+ * supported by the #MMModem.
+ *
+ * Returns: %TRUE if @capabilities and @n_capabilities are set, %FALSE
+ * otherwise.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_snapshot_peek_supported_capabilities (MMModemSnapshot *self,
+                                               const MMModemCapability **capabilities,
+                                               guint *n_capabilities)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), FALSE);
+    g_return_val_if_fail (capabilities != NULL, FALSE);
+    g_return_val_if_fail (n_capabilities != NULL, FALSE);
+
+    if (!self->priv->supported_capabilities)
+        return FALSE;
+
+    *n_capabilities = self->priv->supported_capabilities->len;
+    *capabilities = (MMModemCapability *)self->priv->supported_capabilities->data;
+    return TRUE;
+}
+
+/**
+ * mm_modem_snapshot_get_current_capabilities:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the list of generic families of access technologies supported by the
+ * #MMModem without a firmware reload or reinitialization.
+ *
+ * Returns: A bitmask of #MMModemCapability flags.
+ *
+ * Since: 1.16
+ */
+MMModemCapability
+mm_modem_snapshot_get_current_capabilities (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_CAPABILITY_NONE);
+
+    return self->priv->current_capabilities;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_get_max_bearers:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the maximum number of defined packet data bearers the #MMModem
+ * supports.
+ *
+ * Returns: the maximum number of defined packet data bearers.
+ *
+ * Since: 1.16
+ */
+guint
+mm_modem_snapshot_get_max_bearers (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), 0);
+
+    return self->priv->max_bearers;
+}
+
+/**
+ * mm_modem_snapshot_get_max_active_bearers:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the maximum number of active packet data bearers the #MMModem
+ * supports.
+ *
+ * Returns: the maximum number of active packet data bearers.
+ *
+ * Since: 1.16
+ */
+guint
+mm_modem_snapshot_get_max_active_bearers (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), 0);
+
+    return self->priv->max_active_bearers;
+}
+
+/**
+ * mm_modem_snapshot_get_bearer_paths:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the DBus paths of the #MMBearer<!-- -->s handled in the #MMModem.
+ *
+ * Returns: (transfer none): The DBus paths of the bearers, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar * const *
+mm_modem_snapshot_get_bearer_paths (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return (const gchar * const *)self->priv->bearer_paths;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_get_manufacturer:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the equipment manufacturer, as reported by the #MMModem.
+ *
+ * Returns: (transfer none): The equipment manufacturer, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_manufacturer (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->manufacturer;
+}
+
+/**
+ * mm_modem_snapshot_get_model:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the equipment model, as reported by the #MMModem.
+ *
+ * Returns: (transfer none): The equipment model, or %NULL if none available.
+ * Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_model (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->model;
+}
+
+/**
+ * mm_modem_snapshot_get_revision:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the equipment revision, as reported by the #MMModem.
+ *
+ * Returns: (transfer none): The equipment revision, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_revision (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->revision;
+}
+
+/**
+ * mm_modem_snapshot_get_carrier_configuration:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the carrier-specific configuration (MCFG) in use, as reported by the
+ * #MMModem.
+ *
+ * Returns: (transfer none): The carrier configuration, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_carrier_configuration (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->carrier_configuration;
+}
+
+/**
+ * mm_modem_snapshot_get_carrier_configuration_revision:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the carrier-specific configuration revision in use, as reported by the
+ * #MMModem.
+ *
+ * Returns: (transfer none): The carrier configuration revision, or %NULL if
+ * none available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_carrier_configuration_revision (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->carrier_configuration_revision;
+}
+
+/**
+ * mm_modem_snapshot_get_hardware_revision:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the equipment hardware revision, as reported by the #MMModem.
+ *
+ * Returns: (transfer none): The equipment hardware revision, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_hardware_revision (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->hardware_revision;
+}
+
+/**
+ * mm_modem_snapshot_get_device_identifier:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets a best-effort device identifier based on various device information
+ * like model name, firmware revision, USB/PCI/PCMCIA IDs, and other properties.
+ *
+ * Returns: (transfer none): The device identifier, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_device_identifier (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->device_identifier;
+}
+
+/**
+ * mm_modem_snapshot_get_device:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the physical modem device reference (ie, USB, PCI, PCMCIA device),
+ * which may be dependent upon the operating system.
+ *
+ * Returns: (transfer none): The device, or %NULL if none available. Do not
+ * free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_device (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->device;
+}
+
+/**
+ * mm_modem_snapshot_get_drivers:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the Operating System device drivers handling communication with the
+ * modem hardware.
+ *
+ * Returns: (transfer none): The drivers, or %NULL if none available. Do not
+ * free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar * const *
+mm_modem_snapshot_get_drivers (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return (const gchar * const *)self->priv->drivers;
+}
+
+/**
+ * mm_modem_snapshot_get_plugin:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the name of the plugin handling the #MMModem.
+ *
+ * Returns: (transfer none): The name of the plugin, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_plugin (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->plugin;
+}
+
+/**
+ * mm_modem_snapshot_get_primary_port:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the name of the primary port controlling the #MMModem.
+ *
+ * Returns: (transfer none): The name of the primary port, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_primary_port (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->primary_port;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_peek_ports:
+ * @self: A #MMModemSnapshot.
+ * @ports: (out) (array length=n_ports) (transfer none): Return location for the
+ *  array of #MMModemPortInfo values. Do not free the returned value, it is
+ *  owned by @self.
+ * @n_ports: (out): Return location for the number of values in @ports.
+ *
+ * Gets the list of ports in the #MMModem.
+ *
+ * Returns: %TRUE if @ports and @n_ports are set, %FALSE otherwise.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_snapshot_peek_ports (MMModemSnapshot *self,
+                              const MMModemPortInfo **ports,
+                              guint *n_ports)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), FALSE);
+    g_return_val_if_fail (ports != NULL, FALSE);
+    g_return_val_if_fail (n_ports != NULL, FALSE);
+
+    if (!self->priv->ports)
+        return FALSE;
+
+    *n_ports = self->priv->ports->len;
+    *ports = (MMModemPortInfo *)self->priv->ports->data;
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_get_equipment_identifier:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the identity of the #MMModem.
+ *
+ * This will be the IMEI number for GSM devices and the hex-format ESN/MEID
+ * for CDMA devices.
+ *
+ * Returns: (transfer none): The equipment identifier, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar *
+mm_modem_snapshot_get_equipment_identifier (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->equipment_identifier;
+}
+
+/**
+ * mm_modem_snapshot_get_own_numbers:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the list of numbers (e.g. MSISDN in 3GPP) being currently handled by
+ * the #MMModem.
+ *
+ * Returns: (transfer none): The list of own numbers or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+const gchar * const *
+mm_modem_snapshot_get_own_numbers (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return (const gchar * const *)self->priv->own_numbers;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_get_unlock_required:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets current lock state of the #MMModem.
+ *
+ * Returns: A #MMModemLock value, specifying the current lock state.
+ *
+ * Since: 1.16
+ */
+MMModemLock
+mm_modem_snapshot_get_unlock_required (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_LOCK_UNKNOWN);
+
+    return self->priv->unlock_required;
+}
+
+/**
+ * mm_modem_snapshot_peek_unlock_retries:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets a #MMUnlockRetries object, which provides, for each
+ * <link linkend="MMModemLock">MMModemLock</link> handled by the modem, the
+ * number of PIN tries remaining before the code becomes blocked (requiring a
+ * PUK) or permanently blocked.
+ *
+ * Returns: (transfer none): A #MMUnlockRetries, or %NULL if unknown. Do not
+ * free the returned value, it belongs to @self.
+ *
+ * Since: 1.16
+ */
+MMUnlockRetries *
+mm_modem_snapshot_peek_unlock_retries (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->unlock_retries;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_get_state:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the overall state of the #MMModem.
+ *
+ * Returns: A #MMModemState value.
+ *
+ * Since: 1.16
+ */
+MMModemState
+mm_modem_snapshot_get_state (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_STATE_UNKNOWN);
+
+    return self->priv->state;
+}
+
+/**
+ * mm_modem_snapshot_get_state_failed_reason:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the reason specifying why the modem is in #MM_MODEM_STATE_FAILED state.
+ *
+ * Returns: A #MMModemStateFailedReason value.
+ *
+ * Since: 1.16
+ */
+MMModemStateFailedReason
+mm_modem_snapshot_get_state_failed_reason (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_STATE_FAILED_REASON_UNKNOWN);
+
+    return self->priv->state_failed_reason;
+}
+
+/**
+ * mm_modem_snapshot_get_power_state:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the power state of the #MMModem.
+ *
+ * Returns: A #MMModemPowerState value.
+ *
+ * Since: 1.16
+ */
+MMModemPowerState
+mm_modem_snapshot_get_power_state (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_POWER_STATE_UNKNOWN);
+
+    return self->priv->power_state;
+}
+
+/**
+ * mm_modem_snapshot_get_access_technologies:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the current network access technology used by the #MMModem to
+ * communicate with the network.
+ *
+ * Returns: A ##MMModemAccessTechnology value.
+ *
+ * Since: 1.16
+ */
+MMModemAccessTechnology
+mm_modem_snapshot_get_access_technologies (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN);
+
+    return self->priv->access_technologies;
+}
+
+/**
+ * mm_modem_snapshot_get_signal_quality:
+ * @self: A #MMModemSnapshot.
+ * @recent: (out) (allow-none): Return location for the flag specifying if the
+ *  signal quality value was recent or not.
+ *
+ * Gets the signal quality value in percent (0 - 100) of the dominant access
+ * technology the #MMModem is using to communicate with the network.
+ *
+ * Returns: The signal quality.
+ *
+ * Since: 1.16
+ */
+guint
+mm_modem_snapshot_get_signal_quality (MMModemSnapshot *self,
+                                      gboolean *recent)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), 0);
+
+    if (recent)
+        *recent = self->priv->signal_quality_recent;
+    return self->priv->signal_quality;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_peek_supported_modes:
+ * @self: A #MMModemSnapshot.
+ * @modes: (out) (array length=n_modes): Return location for the array of
+ *  #MMModemModeCombination structs. Do not free the returned array, it is owned
+ *  by @self.
+ * @n_modes: (out): Return location for the number of values in @modes.
+ *
+ * Gets the list of supported mode combinations.
+ *
+ * Returns: %TRUE if @modes and @n_modes are set, %FALSE otherwise.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_snapshot_peek_supported_modes (MMModemSnapshot *self,
+                                        const MMModemModeCombination **modes,
+                                        guint *n_modes)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), FALSE);
+    g_return_val_if_fail (modes != NULL, FALSE);
+    g_return_val_if_fail (n_modes != NULL, FALSE);
+
+    if (!self->priv->supported_modes)
+        return FALSE;
+
+    *n_modes = self->priv->supported_modes->len;
+    *modes = (MMModemModeCombination *)self->priv->supported_modes->data;
+    return TRUE;
+}
+
+/**
+ * mm_modem_snapshot_get_current_modes:
+ * @self: A #MMModemSnapshot.
+ * @allowed: (out): Return location for a bitmask of #MMModemMode values.
+ * @preferred: (out): Return location for a #MMModemMode value.
+ *
+ * Gets the list of modes specifying the access technologies (eg 2G/3G/4G)
+ * the #MMModem is currently allowed to use when connecting to a network, as
+ * well as the preferred one, if any.
+ *
+ * Returns: %TRUE if @allowed and @preferred are set, %FALSE otherwise.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_snapshot_get_current_modes (MMModemSnapshot *self,
+                                     MMModemMode *allowed,
+                                     MMModemMode *preferred)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), FALSE);
+    g_return_val_if_fail (allowed != NULL, FALSE);
+    g_return_val_if_fail (preferred != NULL, FALSE);
+
+    if (!self->priv->current_modes_set)
+        return FALSE;
+
+    *allowed = self->priv->current_modes_allowed;
+    *preferred = self->priv->current_modes_preferred;
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_peek_supported_bands:
+ * @self: A #MMModemSnapshot.
+ * @bands: (out) (array length=n_bands): Return location for the array of
+ *  #MMModemBand values. Do not free the returned array, it is owned by @self.
+ * @n_bands: (out): Return location for the number of values in @bands.
+ *
+ * Gets the list of radio frequency and technology bands supported by the
+ * #MMModem.
+ *
+ * Returns: %TRUE if @bands and @n_bands are set, %FALSE otherwise.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_snapshot_peek_supported_bands (MMModemSnapshot *self,
+                                        const MMModemBand **bands,
+                                        guint *n_bands)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), FALSE);
+    g_return_val_if_fail (bands != NULL, FALSE);
+    g_return_val_if_fail (n_bands != NULL, FALSE);
+
+    if (!self->priv->supported_bands)
+        return FALSE;
+
+    *n_bands = self->priv->supported_bands->len;
+    *bands = (MMModemBand *)self->priv->supported_bands->data;
+    return TRUE;
+}
+
+/**
+ * mm_modem_snapshot_peek_current_bands:
+ * @self: A #MMModemSnapshot.
+ * @bands: (out) (array length=n_bands): Return location for the array of
+ *  #MMModemBand values. Do not free the returned array, it is owned by @self.
+ * @n_bands: (out): Return location for the number of values in @bands.
+ *
+ * Gets the list of radio frequency and technology bands the #MMModem is
+ * currently using when connecting to a network.
+ *
+ * Returns: %TRUE if @bands and @n_bands are set, %FALSE otherwise.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_snapshot_peek_current_bands (MMModemSnapshot *self,
+                                      const MMModemBand **bands,
+                                      guint *n_bands)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), FALSE);
+    g_return_val_if_fail (bands != NULL, FALSE);
+    g_return_val_if_fail (n_bands != NULL, FALSE);
+
+    if (!self->priv->current_bands)
+        return FALSE;
+
+    *n_bands = self->priv->current_bands->len;
+    *bands = (MMModemBand *)self->priv->current_bands->data;
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_get_supported_ip_families:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the list of supported IP families.
+ *
+ * Returns: A bitmask of #MMBearerIpFamily values.
+ *
+ * Since: 1.16
+ */
+MMBearerIpFamily
+mm_modem_snapshot_get_supported_ip_families (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_BEARER_IP_FAMILY_NONE);
+
+    return self->priv->supported_ip_families;
+}
+
+/*****************************************************************************/
+
+static gchar *
+non_empty_string (gchar *str)
+{
+    if (str && !str[0]) {
+        g_free (str);
+        return NULL;
+    }
+    return str;
+}
+
+static gchar **
+non_empty_strv (gchar **strv)
+{
+    if (strv && !strv[0]) {
+        g_strfreev (strv);
+        return NULL;
+    }
+    return strv;
+}
+
+static GArray *
+array_ref (GArray *array)
+{
+    return (array ? g_array_ref (array) : NULL);
+}
+
+/**
+ * mm_modem_snapshot_new: (skip)
+ */
+MMModemSnapshot *
+mm_modem_snapshot_new (const gchar *path,
+                       MmGdbusModem *modem,
+                       GArray *supported_capabilities,
+                       GArray *ports,
+                       MMUnlockRetries *unlock_retries,
+                       GArray *supported_modes,
+                       GArray *supported_bands,
+                       GArray *current_bands)
+{
+    MMModemSnapshot *self;
+    GVariant *variant;
+
+    self = g_object_new (MM_TYPE_MODEM_SNAPSHOT, NULL);
+
+    self->priv->path = g_strdup (path);
+    self->priv->sim_path = non_empty_string (mm_gdbus_modem_dup_sim (modem));
+    self->priv->supported_capabilities = array_ref (supported_capabilities);
+    self->priv->current_capabilities = mm_gdbus_modem_get_current_capabilities (modem);
+    self->priv->max_bearers = mm_gdbus_modem_get_max_bearers (modem);
+    self->priv->max_active_bearers = mm_gdbus_modem_get_max_active_bearers (modem);
+    self->priv->bearer_paths = mm_gdbus_modem_dup_bearers (modem);
+    self->priv->manufacturer = non_empty_string (mm_gdbus_modem_dup_manufacturer (modem));
+    self->priv->model = non_empty_string (mm_gdbus_modem_dup_model (modem));
+    self->priv->revision = non_empty_string (mm_gdbus_modem_dup_revision (modem));
+    self->priv->carrier_configuration = non_empty_string (mm_gdbus_modem_dup_carrier_configuration (modem));
+    self->priv->carrier_configuration_revision = non_empty_string (mm_gdbus_modem_dup_carrier_configuration_revision (modem));
+    self->priv->hardware_revision = non_empty_string (mm_gdbus_modem_dup_hardware_revision (modem));
+    self->priv->device_identifier = non_empty_string (mm_gdbus_modem_dup_device_identifier (modem));
+    self->priv->device = non_empty_string (mm_gdbus_modem_dup_device (modem));
+    self->priv->drivers = mm_gdbus_modem_dup_drivers (modem);
+    self->priv->plugin = non_empty_string (mm_gdbus_modem_dup_plugin (modem));
+    self->priv->primary_port = non_empty_string (mm_gdbus_modem_dup_primary_port (modem));
+    self->priv->ports = array_ref (ports);
+    self->priv->equipment_identifier = non_empty_string (mm_gdbus_modem_dup_equipment_identifier (modem));
+    self->priv->own_numbers = non_empty_strv (mm_gdbus_modem_dup_own_numbers (modem));
+    self->priv->unlock_required = (MMModemLock) mm_gdbus_modem_get_unlock_required (modem);
+    /* MMUnlockRetries can be modified by whoever holds a reference, e.g. the
+     * callers of mm_modem_get_unlock_retries(), so the snapshot has its own */
+    if (unlock_retries) {
+        variant = mm_unlock_retries_get_dictionary (unlock_retries);
+        self->priv->unlock_retries = mm_unlock_retries_new_from_dictionary (variant);
+        g_variant_unref (variant);
+    }
+    self->priv->state = (MMModemState) mm_gdbus_modem_get_state (modem);
+    self->priv->state_failed_reason = (MMModemStateFailedReason) mm_gdbus_modem_get_state_failed_reason (modem);
+    self->priv->power_state = (MMModemPowerState) mm_gdbus_modem_get_power_state (modem);
+    self->priv->access_technologies = (MMModemAccessTechnology) mm_gdbus_modem_get_access_technologies (modem);
+    self->priv->supported_modes = array_ref (supported_modes);
+    self->priv->supported_bands = array_ref (supported_bands);
+    self->priv->current_bands = array_ref (current_bands);
+    self->priv->supported_ip_families = (MMBearerIpFamily) mm_gdbus_modem_get_supported_ip_families (modem);
+
+    variant = mm_gdbus_modem_dup_signal_quality (modem);
+    if (variant) {
+        g_variant_get (variant,
+                       "(ub)",
+                       &self->priv->signal_quality,
+                       &self->priv->signal_quality_recent);
+        g_variant_unref (variant);
+    }
+
+    variant = mm_gdbus_modem_dup_current_modes (modem);
+    if (variant) {
+        g_variant_get (variant,
+                       "(uu)",
+                       &self->priv->current_modes_allowed,
+                       &self->priv->current_modes_preferred);
+        self->priv->current_modes_set = TRUE;
+        g_variant_unref (variant);
+    }
+
+    return self;
+}
+
+/*****************************************************************************/
+
+static void
+mm_modem_snapshot_init (MMModemSnapshot *self)
+{
+    self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
+                                              MM_TYPE_MODEM_SNAPSHOT,
+                                              MMModemSnapshotPrivate);
+}
+
+static void
+finalize (GObject *object)
+{
+    MMModemSnapshot *self = MM_MODEM_SNAPSHOT (object);
+
+    g_free (self->priv->path);
+    g_free (self->priv->sim_path);
+    g_strfreev (self->priv->bearer_paths);
+    g_free (self->priv->manufacturer);
+    g_free (self->priv->model);
+    g_free (self->priv->revision);
+    g_free (self->priv->carrier_configuration);
+    g_free (self->priv->carrier_configuration_revision);
+    g_free (self->priv->hardware_revision);
+    g_free (self->priv->device_identifier);
+    g_free (self->priv->device);
+    g_strfreev (self->priv->drivers);
+    g_free (self->priv->plugin);
+    g_free (self->priv->primary_port);
+    g_free (self->priv->equipment_identifier);
+    g_strfreev (self->priv->own_numbers);
+
+    if (self->priv->supported_capabilities)
+        g_array_unref (self->priv->supported_capabilities);
+    if (self->priv->ports)
+        g_array_unref (self->priv->ports);
+    if (self->priv->supported_modes)
+        g_array_unref (self->priv->supported_modes);
+    if (self->priv->supported_bands)
+        g_array_unref (self->priv->supported_bands);
+    if (self->priv->current_bands)
+        g_array_unref (self->priv->current_bands);
+
+    G_OBJECT_CLASS (mm_modem_snapshot_parent_class)->finalize (object);
+}
+
+static void
+dispose (GObject *object)
+{
+    MMModemSnapshot *self = MM_MODEM_SNAPSHOT (object);
+
+    g_clear_object (&self->priv->unlock_retries);
+
+    G_OBJECT_CLASS (mm_modem_snapshot_parent_class)->dispose (object);
+}
+
+static void
+mm_modem_snapshot_class_init (MMModemSnapshotClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    g_type_class_add_private (object_class, sizeof (MMModemSnapshotPrivate));
+
+    object_class->dispose = dispose;
+    object_class->finalize = finalize;
+}
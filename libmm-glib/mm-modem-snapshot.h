@@ -0,0 +1,148 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * libmm -- Access modem status & information from glib applications
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _MM_MODEM_SNAPSHOT_H_
+#define _MM_MODEM_SNAPSHOT_H_
+
+#if !defined (__LIBMM_GLIB_H_INSIDE__) && !defined (LIBMM_GLIB_COMPILATION)
+#error "Only <libmm-glib.h> can be included directly."
+#endif
+
+#include <ModemManager.h>
+#include <glib-object.h>
+
+#include "mm-gdbus-modem.h"
+#include "mm-unlock-retries.h"
+#include "mm-helper-types.h"
+
+G_BEGIN_DECLS
+
+#define MM_TYPE_MODEM_SNAPSHOT            (mm_modem_snapshot_get_type ())
+#define MM_MODEM_SNAPSHOT(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_MODEM_SNAPSHOT, MMModemSnapshot))
+#define MM_MODEM_SNAPSHOT_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),  MM_TYPE_MODEM_SNAPSHOT, MMModemSnapshotClass))
+#define MM_IS_MODEM_SNAPSHOT(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_MODEM_SNAPSHOT))
+#define MM_IS_MODEM_SNAPSHOT_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  MM_TYPE_MODEM_SNAPSHOT))
+#define MM_MODEM_SNAPSHOT_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  MM_TYPE_MODEM_SNAPSHOT, MMModemSnapshotClass))
+
+typedef struct _MMModemSnapshot MMModemSnapshot;
+typedef struct _MMModemSnapshotClass MMModemSnapshotClass;
+typedef struct _MMModemSnapshotPrivate MMModemSnapshotPrivate;
+
+/**
+ * MMModemSnapshot:
+ *
+ * The #MMModemSnapshot structure contains private data and should only be
+ * accessed using the provided API.
+ */
+struct _MMModemSnapshot {
+    /*< private >*/
+    GObject parent;
+    MMModemSnapshotPrivate *priv;
+};
+
+struct _MMModemSnapshotClass {
+    /*< private >*/
+    GObjectClass parent;
+};
+
+GType mm_modem_snapshot_get_type (void);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMModemSnapshot, g_object_unref)
+
+const gchar         *mm_modem_snapshot_get_path                 (MMModemSnapshot *self);
+const gchar         *mm_modem_snapshot_get_sim_path             (MMModemSnapshot *self);
+
+gboolean             mm_modem_snapshot_peek_supported_capabilities (MMModemSnapshot *self,
+                                                                    const MMModemCapability **capabilities,
+                                                                    guint *n_capabilities);
+MMModemCapability    mm_modem_snapshot_get_current_capabilities (MMModemSnapshot *self);
+
+guint                mm_modem_snapshot_get_max_bearers          (MMModemSnapshot *self);
+guint                mm_modem_snapshot_get_max_active_bearers   (MMModemSnapshot *self);
+const gchar * const *mm_modem_snapshot_get_bearer_paths         (MMModemSnapshot *self);
+
+const gchar         *mm_modem_snapshot_get_manufacturer         (MMModemSnapshot *self);
+const gchar         *mm_modem_snapshot_get_model                (MMModemSnapshot *self);
+const gchar         *mm_modem_snapshot_get_revision             (MMModemSnapshot *self);
+const gchar         *mm_modem_snapshot_get_carrier_configuration          (MMModemSnapshot *self);
+const gchar         *mm_modem_snapshot_get_carrier_configuration_revision (MMModemSnapshot *self);
+const gchar         *mm_modem_snapshot_get_hardware_revision    (MMModemSnapshot *self);
+const gchar         *mm_modem_snapshot_get_device_identifier    (MMModemSnapshot *self);
+const gchar         *mm_modem_snapshot_get_device               (MMModemSnapshot *self);
+const gchar * const *mm_modem_snapshot_get_drivers              (MMModemSnapshot *self);
+const gchar         *mm_modem_snapshot_get_plugin               (MMModemSnapshot *self);
+const gchar         *mm_modem_snapshot_get_primary_port         (MMModemSnapshot *self);
+
+gboolean             mm_modem_snapshot_peek_ports               (MMModemSnapshot *self,
+                                                                 const MMModemPortInfo **ports,
+                                                                 guint *n_ports);
+
+const gchar         *mm_modem_snapshot_get_equipment_identifier (MMModemSnapshot *self);
+const gchar * const *mm_modem_snapshot_get_own_numbers          (MMModemSnapshot *self);
+
+MMModemLock          mm_modem_snapshot_get_unlock_required      (MMModemSnapshot *self);
+MMUnlockRetries     *mm_modem_snapshot_peek_unlock_retries      (MMModemSnapshot *self);
+
+MMModemState             mm_modem_snapshot_get_state               (MMModemSnapshot *self);
+MMModemStateFailedReason mm_modem_snapshot_get_state_failed_reason (MMModemSnapshot *self);
+MMModemPowerState        mm_modem_snapshot_get_power_state         (MMModemSnapshot *self);
+MMModemAccessTechnology  mm_modem_snapshot_get_access_technologies (MMModemSnapshot *self);
+
+guint                mm_modem_snapshot_get_signal_quality       (MMModemSnapshot *self,
+                                                                 gboolean *recent);
+
+gboolean             mm_modem_snapshot_peek_supported_modes     (MMModemSnapshot *self,
+                                                                 const MMModemModeCombination **modes,
+                                                                 guint *n_modes);
+gboolean             mm_modem_snapshot_get_current_modes        (MMModemSnapshot *self,
+                                                                 MMModemMode *allowed,
+                                                                 MMModemMode *preferred);
+
+gboolean             mm_modem_snapshot_peek_supported_bands     (MMModemSnapshot *self,
+                                                                 const MMModemBand **bands,
+                                                                 guint *n_bands);
+gboolean             mm_modem_snapshot_peek_current_bands       (MMModemSnapshot *self,
+                                                                 const MMModemBand **bands,
+                                                                 guint *n_bands);
+
+MMBearerIpFamily     mm_modem_snapshot_get_supported_ip_families (MMModemSnapshot *self);
+
+/*****************************************************************************/
+/* ModemManager/libmm-glib/mmcli specific methods */
+
+#if defined (_LIBMM_INSIDE_MM) ||    \
+    defined (_LIBMM_INSIDE_MMCLI) || \
+    defined (LIBMM_GLIB_COMPILATION)
+
+/* The arrays are already decoded values which are shared, not copied, so
+ * they must not be modified afterwards. The unlock retries are copied. */
+MMModemSnapshot *mm_modem_snapshot_new (const gchar *path,
+                                        MmGdbusModem *modem,
+                                        GArray *supported_capabilities,
+                                        GArray *ports,
+                                        MMUnlockRetries *unlock_retries,
+                                        GArray *supported_modes,
+                                        GArray *supported_bands,
+                                        GArray *current_bands);
+
+#endif
+
+G_END_DECLS
+
+#endif /* _MM_MODEM_SNAPSHOT_H_ */
@@ -43,38 +43,187 @@
 
 G_DEFINE_TYPE (MMModem, mm_modem, MM_GDBUS_TYPE_MODEM_PROXY)
 
+/* Properties needing a conversion from their DBus value, decoded on first use
+ * and dropped whenever the property changes */
+typedef enum {
+    CACHED_SUPPORTED_CAPABILITIES = 1 << 0,
+    CACHED_PORTS                  = 1 << 1,
+    CACHED_UNLOCK_RETRIES         = 1 << 2,
+    CACHED_SUPPORTED_MODES        = 1 << 3,
+    CACHED_SUPPORTED_BANDS        = 1 << 4,
+    CACHED_CURRENT_BANDS          = 1 << 5,
+    CACHED_ALL                    = (1 << 6) - 1,
+} CachedProperty;
+
+static const struct {
+    const gchar *name;
+    CachedProperty property;
+} cached_properties[] = {
+    { "SupportedCapabilities", CACHED_SUPPORTED_CAPABILITIES },
+    { "Ports",                 CACHED_PORTS                  },
+    { "UnlockRetries",         CACHED_UNLOCK_RETRIES         },
+    { "SupportedModes",        CACHED_SUPPORTED_MODES        },
+    { "SupportedBands",        CACHED_SUPPORTED_BANDS        },
+    { "CurrentBands",          CACHED_CURRENT_BANDS          },
+};
+
 struct _MMModemPrivate {
-    /* Ports */
-    GMutex ports_mutex;
-    guint ports_id;
-    GArray *ports;
+    /* Protects the decoded values and the snapshot, as the getters
+     * may be used from any thread */
+    GMutex cache_mutex;
 
-    /* UnlockRetries */
-    GMutex unlock_retries_mutex;
-    guint unlock_retries_id;
+    /* Mask of CachedProperty values already decoded */
+    guint cached;
+    GArray *supported_capabilities;
+    GArray *ports;
     MMUnlockRetries *unlock_retries;
-
-    /* Supported Modes */
-    GMutex supported_modes_mutex;
-    guint supported_modes_id;
     GArray *supported_modes;
-
-    /* Supported Capabilities */
-    GMutex supported_capabilities_mutex;
-    guint supported_capabilities_id;
-    GArray *supported_capabilities;
-
-    /* Supported Bands */
-    GMutex supported_bands_mutex;
-    guint supported_bands_id;
     GArray *supported_bands;
-
-    /* Current Bands */
-    GMutex current_bands_mutex;
-    guint current_bands_id;
     GArray *current_bands;
+
+    /* Built on request, kept until any property changes */
+    MMModemSnapshot *snapshot;
 };
 
+/*****************************************************************************/
+/* Decoded properties cache */
+
+static void
+cache_ensure_unlocked (MMModem *self,
+                       guint properties)
+{
+    MmGdbusModem *modem = MM_GDBUS_MODEM (self);
+    GVariant *variant;
+
+    properties &= ~self->priv->cached;
+    if (!properties)
+        return;
+
+    if (properties & CACHED_SUPPORTED_CAPABILITIES) {
+        variant = mm_gdbus_modem_dup_supported_capabilities (modem);
+        if (variant) {
+            self->priv->supported_capabilities = mm_common_capability_combinations_variant_to_garray (variant);
+            g_variant_unref (variant);
+        }
+    }
+
+    if (properties & CACHED_PORTS) {
+        variant = mm_gdbus_modem_dup_ports (modem);
+        if (variant) {
+            self->priv->ports = mm_common_ports_variant_to_garray (variant);
+            g_variant_unref (variant);
+        }
+    }
+
+    if (properties & CACHED_UNLOCK_RETRIES) {
+        variant = mm_gdbus_modem_dup_unlock_retries (modem);
+        if (variant) {
+            self->priv->unlock_retries = mm_unlock_retries_new_from_dictionary (variant);
+            g_variant_unref (variant);
+        }
+    }
+
+    if (properties & CACHED_SUPPORTED_MODES) {
+        variant = mm_gdbus_modem_dup_supported_modes (modem);
+        if (variant) {
+            self->priv->supported_modes = mm_common_mode_combinations_variant_to_garray (variant);
+            g_variant_unref (variant);
+        }
+    }
+
+    if (properties & CACHED_SUPPORTED_BANDS) {
+        variant = mm_gdbus_modem_dup_supported_bands (modem);
+        if (variant) {
+            self->priv->supported_bands = mm_common_bands_variant_to_garray (variant);
+            g_variant_unref (variant);
+        }
+    }
+
+    if (properties & CACHED_CURRENT_BANDS) {
+        variant = mm_gdbus_modem_dup_current_bands (modem);
+        if (variant) {
+            self->priv->current_bands = mm_common_bands_variant_to_garray (variant);
+            g_variant_unref (variant);
+        }
+    }
+
+    self->priv->cached |= properties;
+}
+
+static void
+clear_array (GArray **array)
+{
+    if (*array) {
+        g_array_unref (*array);
+        *array = NULL;
+    }
+}
+
+static void
+cache_clear_unlocked (MMModem *self,
+                      guint properties)
+{
+    if (properties & CACHED_SUPPORTED_CAPABILITIES)
+        clear_array (&self->priv->supported_capabilities);
+    if (properties & CACHED_PORTS)
+        clear_array (&self->priv->ports);
+    if (properties & CACHED_UNLOCK_RETRIES)
+        g_clear_object (&self->priv->unlock_retries);
+    if (properties & CACHED_SUPPORTED_MODES)
+        clear_array (&self->priv->supported_modes);
+    if (properties & CACHED_SUPPORTED_BANDS)
+        clear_array (&self->priv->supported_bands);
+    if (properties & CACHED_CURRENT_BANDS)
+        clear_array (&self->priv->current_bands);
+
+    self->priv->cached &= ~properties;
+}
+
+static guint
+cached_property_from_name (const gchar *name)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (cached_properties); i++) {
+        if (g_str_equal (cached_properties[i].name, name))
+            return cached_properties[i].property;
+    }
+    return 0;
+}
+
+static void
+g_properties_changed (GDBusProxy *proxy,
+                      GVariant *changed_properties,
+                      const gchar *const *invalidated_properties)
+{
+    MMModem *self = MM_MODEM (proxy);
+    GVariantIter iter;
+    const gchar *name;
+    guint changed = 0;
+    guint i;
+
+    /* All the properties changed in the same signal are handled at once, the
+     * values are only decoded again when requested */
+    g_variant_iter_init (&iter, changed_properties);
+    while (g_variant_iter_next (&iter, "{&sv}", &name, NULL))
+        changed |= cached_property_from_name (name);
+    for (i = 0; invalidated_properties && invalidated_properties[i]; i++)
+        changed |= cached_property_from_name (invalidated_properties[i]);
+
+    g_mutex_lock (&self->priv->cache_mutex);
+    {
+        cache_clear_unlocked (self, changed);
+        g_clear_object (&self->priv->snapshot);
+    }
+    g_mutex_unlock (&self->priv->cache_mutex);
+
+    /* Chain up, so that the property notifications are emitted once the
+     * cache is already up to date */
+    G_DBUS_PROXY_CLASS (mm_modem_parent_class)->g_properties_changed (proxy,
+                                                                      changed_properties,
+                                                                      invalidated_properties);
+}
+
 /*****************************************************************************/
 
 /**
@@ -172,25 +321,6 @@ mm_modem_dup_sim_path (MMModem *self)
 
 /*****************************************************************************/
 
-static void
-supported_capabilities_updated (MMModem *self,
-                                GParamSpec *pspec)
-{
-    g_mutex_lock (&self->priv->supported_capabilities_mutex);
-    {
-        GVariant *dictionary;
-
-        if (self->priv->supported_capabilities)
-            g_array_unref (self->priv->supported_capabilities);
-
-        dictionary = mm_gdbus_modem_get_supported_capabilities (MM_GDBUS_MODEM (self));
-        self->priv->supported_capabilities = (dictionary ?
-                                              mm_common_capability_combinations_variant_to_garray (dictionary) :
-                                              NULL);
-    }
-    g_mutex_unlock (&self->priv->supported_capabilities_mutex);
-}
-
 static gboolean
 ensure_internal_supported_capabilities (MMModem *self,
                                         MMModemCapability **dup_capabilities,
@@ -198,26 +328,9 @@ ensure_internal_supported_capabilities (MMModem *self,
 {
     gboolean ret;
 
-    g_mutex_lock (&self->priv->supported_capabilities_mutex);
+    g_mutex_lock (&self->priv->cache_mutex);
     {
-        /* If this is the first time ever asking for the array, setup the
-         * update listener and the initial array, if any. */
-        if (!self->priv->supported_capabilities_id) {
-            GVariant *dictionary;
-
-            dictionary = mm_gdbus_modem_dup_supported_capabilities (MM_GDBUS_MODEM (self));
-            if (dictionary) {
-                self->priv->supported_capabilities = mm_common_capability_combinations_variant_to_garray (dictionary);
-                g_variant_unref (dictionary);
-            }
-
-            /* No need to clear this signal connection when freeing self */
-            self->priv->supported_capabilities_id =
-                g_signal_connect (self,
-                                  "notify::supported-capabilities",
-                                  G_CALLBACK (supported_capabilities_updated),
-                                  NULL);
-        }
+        cache_ensure_unlocked (self, CACHED_SUPPORTED_CAPABILITIES);
 
         if (!self->priv->supported_capabilities)
             ret = FALSE;
@@ -234,7 +347,7 @@ ensure_internal_supported_capabilities (MMModem *self,
             }
         }
     }
-    g_mutex_unlock (&self->priv->supported_capabilities_mutex);
+    g_mutex_unlock (&self->priv->cache_mutex);
 
     return ret;
 }
@@ -952,25 +1065,6 @@ mm_modem_dup_primary_port (MMModem *self)
 
 /*****************************************************************************/
 
-static void
-ports_updated (MMModem *self,
-               GParamSpec *pspec)
-{
-    g_mutex_lock (&self->priv->ports_mutex);
-    {
-        GVariant *dictionary;
-
-        if (self->priv->ports)
-            g_array_unref (self->priv->ports);
-
-        dictionary = mm_gdbus_modem_get_ports (MM_GDBUS_MODEM (self));
-        self->priv->ports = (dictionary ?
-                             mm_common_ports_variant_to_garray (dictionary) :
-                             NULL);
-    }
-    g_mutex_unlock (&self->priv->ports_mutex);
-}
-
 static gboolean
 ensure_internal_ports (MMModem *self,
                        MMModemPortInfo **dup_ports,
@@ -979,26 +1073,9 @@ ensure_internal_ports (MMModem *self,
     gboolean ret;
     guint i;
 
-    g_mutex_lock (&self->priv->ports_mutex);
+    g_mutex_lock (&self->priv->cache_mutex);
     {
-        /* If this is the first time ever asking for the array, setup the
-         * update listener and the initial array, if any. */
-        if (!self->priv->ports_id) {
-            GVariant *dictionary;
-
-            dictionary = mm_gdbus_modem_dup_ports (MM_GDBUS_MODEM (self));
-            if (dictionary) {
-                self->priv->ports = mm_common_ports_variant_to_garray (dictionary);
-                g_variant_unref (dictionary);
-            }
-
-            /* No need to clear this signal connection when freeing self */
-            self->priv->ports_id =
-                g_signal_connect (self,
-                                  "notify::ports",
-                                  G_CALLBACK (ports_updated),
-                                  NULL);
-        }
+        cache_ensure_unlocked (self, CACHED_PORTS);
 
         if (!self->priv->ports)
             ret = FALSE;
@@ -1023,7 +1100,7 @@ ensure_internal_ports (MMModem *self,
             }
         }
     }
-    g_mutex_unlock (&self->priv->ports_mutex);
+    g_mutex_unlock (&self->priv->cache_mutex);
 
     return ret;
 }
@@ -1087,6 +1164,61 @@ mm_modem_get_ports (MMModem *self,
 
 /*****************************************************************************/
 
+/**
+ * mm_modem_get_connection_timing_histograms:
+ * @self: A #MMModem.
+ * @histograms: (out) (array length=n_histograms): Return location for the
+ *  array of #MMModemConnectionTimingHistogram values. The returned array
+ *  should be freed with mm_modem_connection_timing_histogram_array_free()
+ *  when no longer needed.
+ * @n_histograms: (out): Return location for the number of values in
+ *  @histograms.
+ *
+ * Gets the aggregated durations of the steps of all the connection attempts
+ * made on the bearers of the modem, plus a <literal>"total"</literal> entry
+ * for the whole connection attempts.
+ *
+ * Returns: %TRUE if @histograms and @n_histograms are set, %FALSE if no
+ * connection attempt has finished yet.
+ *
+ * Since: 1.16
+ */
+gboolean
+mm_modem_get_connection_timing_histograms (MMModem                           *self,
+                                           MMModemConnectionTimingHistogram **histograms,
+                                           guint                             *n_histograms)
+{
+    GVariant     *variant;
+    GVariant     *buckets;
+    GVariantIter  iter;
+    const gchar  *step;
+    guint         i = 0;
+
+    g_return_val_if_fail (MM_IS_MODEM (self), FALSE);
+    g_return_val_if_fail (histograms != NULL, FALSE);
+    g_return_val_if_fail (n_histograms != NULL, FALSE);
+
+    variant = mm_gdbus_modem_get_connection_timing_histograms (MM_GDBUS_MODEM (self));
+    if (!variant || !g_variant_n_children (variant))
+        return FALSE;
+
+    *n_histograms = g_variant_iter_init (&iter, variant);
+    *histograms = g_new0 (MMModemConnectionTimingHistogram, *n_histograms);
+    while (g_variant_iter_loop (&iter, "{&s@au}", &step, &buckets)) {
+        const guint32 *values;
+        gsize          n_values;
+
+        values = g_variant_get_fixed_array (buckets, &n_values, sizeof (guint32));
+        (*histograms)[i].step = g_strdup (step);
+        (*histograms)[i].buckets = g_memdup (values, n_values * sizeof (guint32));
+        (*histograms)[i].n_buckets = n_values;
+        i++;
+    }
+    return TRUE;
+}
+
+/*****************************************************************************/
+
 /**
  * mm_modem_get_equipment_identifier:
  * @self: A #MMModem.
@@ -1216,53 +1348,18 @@ mm_modem_get_unlock_required (MMModem *self)
 
 /*****************************************************************************/
 
-static void
-unlock_retries_updated (MMModem *self,
-                        GParamSpec *pspec)
-{
-    g_mutex_lock (&self->priv->unlock_retries_mutex);
-    {
-        GVariant *dictionary;
-
-        g_clear_object (&self->priv->unlock_retries);
-
-        /* TODO: update existing object instead of re-creating? */
-        dictionary = mm_gdbus_modem_get_unlock_retries (MM_GDBUS_MODEM (self));
-        if (dictionary)
-            self->priv->unlock_retries = mm_unlock_retries_new_from_dictionary (dictionary);
-    }
-    g_mutex_unlock (&self->priv->unlock_retries_mutex);
-}
-
 static void
 ensure_internal_unlock_retries (MMModem *self,
                                 MMUnlockRetries **dup)
 {
-    g_mutex_lock (&self->priv->unlock_retries_mutex);
+    g_mutex_lock (&self->priv->cache_mutex);
     {
-        /* If this is the first time ever asking for the object, setup the
-         * update listener and the initial object, if any. */
-        if (!self->priv->unlock_retries_id) {
-            GVariant *dictionary;
-
-            dictionary = mm_gdbus_modem_dup_unlock_retries (MM_GDBUS_MODEM (self));
-            if (dictionary) {
-                self->priv->unlock_retries = mm_unlock_retries_new_from_dictionary (dictionary);
-                g_variant_unref (dictionary);
-            }
-
-            /* No need to clear this signal connection when freeing self */
-            self->priv->unlock_retries_id =
-                g_signal_connect (self,
-                                  "notify::unlock-retries",
-                                  G_CALLBACK (unlock_retries_updated),
-                                  NULL);
-        }
+        cache_ensure_unlocked (self, CACHED_UNLOCK_RETRIES);
 
         if (dup && self->priv->unlock_retries)
             *dup = g_object_ref (self->priv->unlock_retries);
     }
-    g_mutex_unlock (&self->priv->unlock_retries_mutex);
+    g_mutex_unlock (&self->priv->cache_mutex);
 }
 
 /**
@@ -1446,25 +1543,6 @@ mm_modem_get_signal_quality (MMModem *self,
 
 /*****************************************************************************/
 
-static void
-supported_modes_updated (MMModem *self,
-                         GParamSpec *pspec)
-{
-    g_mutex_lock (&self->priv->supported_modes_mutex);
-    {
-        GVariant *dictionary;
-
-        if (self->priv->supported_modes)
-            g_array_unref (self->priv->supported_modes);
-
-        dictionary = mm_gdbus_modem_get_supported_modes (MM_GDBUS_MODEM (self));
-        self->priv->supported_modes = (dictionary ?
-                                       mm_common_mode_combinations_variant_to_garray (dictionary) :
-                                       NULL);
-    }
-    g_mutex_unlock (&self->priv->supported_modes_mutex);
-}
-
 static gboolean
 ensure_internal_supported_modes (MMModem *self,
                                  MMModemModeCombination **dup_modes,
@@ -1472,26 +1550,9 @@ ensure_internal_supported_modes (MMModem *self,
 {
     gboolean ret;
 
-    g_mutex_lock (&self->priv->supported_modes_mutex);
+    g_mutex_lock (&self->priv->cache_mutex);
     {
-        /* If this is the first time ever asking for the array, setup the
-         * update listener and the initial array, if any. */
-        if (!self->priv->supported_modes_id) {
-            GVariant *dictionary;
-
-            dictionary = mm_gdbus_modem_dup_supported_modes (MM_GDBUS_MODEM (self));
-            if (dictionary) {
-                self->priv->supported_modes = mm_common_mode_combinations_variant_to_garray (dictionary);
-                g_variant_unref (dictionary);
-            }
-
-            /* No need to clear this signal connection when freeing self */
-            self->priv->supported_modes_id =
-                g_signal_connect (self,
-                                  "notify::supported-modes",
-                                  G_CALLBACK (supported_modes_updated),
-                                  NULL);
-        }
+        cache_ensure_unlocked (self, CACHED_SUPPORTED_MODES);
 
         if (!self->priv->supported_modes)
             ret = FALSE;
@@ -1508,7 +1569,7 @@ ensure_internal_supported_modes (MMModem *self,
             }
         }
     }
-    g_mutex_unlock (&self->priv->supported_modes_mutex);
+    g_mutex_unlock (&self->priv->cache_mutex);
 
     return ret;
 }
@@ -1612,25 +1673,6 @@ mm_modem_get_current_modes (MMModem *self,
 
 /*****************************************************************************/
 
-static void
-supported_bands_updated (MMModem *self,
-                         GParamSpec *pspec)
-{
-    g_mutex_lock (&self->priv->supported_bands_mutex);
-    {
-        GVariant *dictionary;
-
-        if (self->priv->supported_bands)
-            g_array_unref (self->priv->supported_bands);
-
-        dictionary = mm_gdbus_modem_get_supported_bands (MM_GDBUS_MODEM (self));
-        self->priv->supported_bands = (dictionary ?
-                                       mm_common_bands_variant_to_garray (dictionary) :
-                                       NULL);
-    }
-    g_mutex_unlock (&self->priv->supported_bands_mutex);
-}
-
 static gboolean
 ensure_internal_supported_bands (MMModem *self,
                                  MMModemBand **dup_bands,
@@ -1638,26 +1680,9 @@ ensure_internal_supported_bands (MMModem *self,
 {
     gboolean ret;
 
-    g_mutex_lock (&self->priv->supported_bands_mutex);
+    g_mutex_lock (&self->priv->cache_mutex);
     {
-        /* If this is the first time ever asking for the array, setup the
-         * update listener and the initial array, if any. */
-        if (!self->priv->supported_bands_id) {
-            GVariant *dictionary;
-
-            dictionary = mm_gdbus_modem_dup_supported_bands (MM_GDBUS_MODEM (self));
-            if (dictionary) {
-                self->priv->supported_bands = mm_common_bands_variant_to_garray (dictionary);
-                g_variant_unref (dictionary);
-            }
-
-            /* No need to clear this signal connection when freeing self */
-            self->priv->supported_bands_id =
-                g_signal_connect (self,
-                                  "notify::supported-bands",
-                                  G_CALLBACK (supported_bands_updated),
-                                  NULL);
-        }
+        cache_ensure_unlocked (self, CACHED_SUPPORTED_BANDS);
 
         if (!self->priv->supported_bands)
             ret = FALSE;
@@ -1674,7 +1699,7 @@ ensure_internal_supported_bands (MMModem *self,
             }
         }
     }
-    g_mutex_unlock (&self->priv->supported_bands_mutex);
+    g_mutex_unlock (&self->priv->cache_mutex);
 
     return ret;
 }
@@ -1743,25 +1768,6 @@ mm_modem_peek_supported_bands (MMModem *self,
 
 /*****************************************************************************/
 
-static void
-current_bands_updated (MMModem *self,
-                       GParamSpec *pspec)
-{
-    g_mutex_lock (&self->priv->current_bands_mutex);
-    {
-        GVariant *dictionary;
-
-        if (self->priv->current_bands)
-            g_array_unref (self->priv->current_bands);
-
-        dictionary = mm_gdbus_modem_get_current_bands (MM_GDBUS_MODEM (self));
-        self->priv->current_bands = (dictionary ?
-                                     mm_common_bands_variant_to_garray (dictionary) :
-                                     NULL);
-    }
-    g_mutex_unlock (&self->priv->current_bands_mutex);
-}
-
 static gboolean
 ensure_internal_current_bands (MMModem *self,
                                MMModemBand **dup_bands,
@@ -1769,26 +1775,9 @@ ensure_internal_current_bands (MMModem *self,
 {
     gboolean ret;
 
-    g_mutex_lock (&self->priv->current_bands_mutex);
+    g_mutex_lock (&self->priv->cache_mutex);
     {
-        /* If this is the first time ever asking for the array, setup the
-         * update listener and the initial array, if any. */
-        if (!self->priv->current_bands_id) {
-            GVariant *dictionary;
-
-            dictionary = mm_gdbus_modem_dup_current_bands (MM_GDBUS_MODEM (self));
-            if (dictionary) {
-                self->priv->current_bands = mm_common_bands_variant_to_garray (dictionary);
-                g_variant_unref (dictionary);
-            }
-
-            /* No need to clear this signal connection when freeing self */
-            self->priv->current_bands_id =
-                g_signal_connect (self,
-                                  "notify::current-bands",
-                                  G_CALLBACK (current_bands_updated),
-                                  NULL);
-        }
+        cache_ensure_unlocked (self, CACHED_CURRENT_BANDS);
 
         if (!self->priv->current_bands)
             ret = FALSE;
@@ -1805,7 +1794,7 @@ ensure_internal_current_bands (MMModem *self,
             }
         }
     }
-    g_mutex_unlock (&self->priv->current_bands_mutex);
+    g_mutex_unlock (&self->priv->cache_mutex);
 
     return ret;
 }
@@ -1894,6 +1883,56 @@ mm_modem_get_supported_ip_families (MMModem *self)
 
 /*****************************************************************************/
 
+/**
+ * mm_modem_get_snapshot:
+ * @self: A #MMModem.
+ *
+ * Gets a #MMModemSnapshot object, which holds the values of all the properties
+ * of @self at the time of the call.
+ *
+ * The same #MMModemSnapshot is returned until any of the properties changes,
+ * so calling this method periodically is cheap when the modem state doesn't
+ * change. This method is thread-safe.
+ *
+ * <warning>The values reported by the returned object are not updated when the
+ * values in the interface change. Instead, the client is expected to call
+ * mm_modem_get_snapshot() again to get a new #MMModemSnapshot with the new
+ * values.</warning>
+ *
+ * Returns: (transfer full): A #MMModemSnapshot that must be freed with
+ * g_object_unref().
+ *
+ * Since: 1.16
+ */
+MMModemSnapshot *
+mm_modem_get_snapshot (MMModem *self)
+{
+    MMModemSnapshot *snapshot;
+
+    g_return_val_if_fail (MM_IS_MODEM (self), NULL);
+
+    g_mutex_lock (&self->priv->cache_mutex);
+    {
+        if (!self->priv->snapshot) {
+            cache_ensure_unlocked (self, CACHED_ALL);
+            self->priv->snapshot = mm_modem_snapshot_new (g_dbus_proxy_get_object_path (G_DBUS_PROXY (self)),
+                                                          MM_GDBUS_MODEM (self),
+                                                          self->priv->supported_capabilities,
+                                                          self->priv->ports,
+                                                          self->priv->unlock_retries,
+                                                          self->priv->supported_modes,
+                                                          self->priv->supported_bands,
+                                                          self->priv->current_bands);
+        }
+        snapshot = g_object_ref (self->priv->snapshot);
+    }
+    g_mutex_unlock (&self->priv->cache_mutex);
+
+    return snapshot;
+}
+
+/*****************************************************************************/
+
 /**
  * mm_modem_enable_finish:
  * @self: A #MMModem.
@@ -3390,12 +3429,7 @@ mm_modem_init (MMModem *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
                                               MM_TYPE_MODEM,
                                               MMModemPrivate);
-    g_mutex_init (&self->priv->unlock_retries_mutex);
-    g_mutex_init (&self->priv->supported_modes_mutex);
-    g_mutex_init (&self->priv->supported_capabilities_mutex);
-    g_mutex_init (&self->priv->supported_bands_mutex);
-    g_mutex_init (&self->priv->current_bands_mutex);
-    g_mutex_init (&self->priv->ports_mutex);
+    g_mutex_init (&self->priv->cache_mutex);
 }
 
 static void
@@ -3403,23 +3437,7 @@ finalize (GObject *object)
 {
     MMModem *self = MM_MODEM (object);
 
-    g_mutex_clear (&self->priv->unlock_retries_mutex);
-    g_mutex_clear (&self->priv->supported_modes_mutex);
-    g_mutex_clear (&self->priv->supported_capabilities_mutex);
-    g_mutex_clear (&self->priv->supported_bands_mutex);
-    g_mutex_clear (&self->priv->current_bands_mutex);
-    g_mutex_clear (&self->priv->ports_mutex);
-
-    if (self->priv->supported_modes)
-        g_array_unref (self->priv->supported_modes);
-    if (self->priv->supported_capabilities)
-        g_array_unref (self->priv->supported_capabilities);
-    if (self->priv->supported_bands)
-        g_array_unref (self->priv->supported_bands);
-    if (self->priv->current_bands)
-        g_array_unref (self->priv->current_bands);
-    if (self->priv->ports)
-       g_array_unref (self->priv->ports);
+    g_mutex_clear (&self->priv->cache_mutex);
 
     G_OBJECT_CLASS (mm_modem_parent_class)->finalize (object);
 }
@@ -3429,7 +3447,8 @@ dispose (GObject *object)
 {
     MMModem *self = MM_MODEM (object);
 
-    g_clear_object (&self->priv->unlock_retries);
+    cache_clear_unlocked (self, CACHED_ALL);
+    g_clear_object (&self->priv->snapshot);
 
     G_OBJECT_CLASS (mm_modem_parent_class)->dispose (object);
 }
@@ -3438,10 +3457,12 @@ static void
 mm_modem_class_init (MMModemClass *modem_class)
 {
     GObjectClass *object_class = G_OBJECT_CLASS (modem_class);
+    GDBusProxyClass *proxy_class = G_DBUS_PROXY_CLASS (modem_class);
 
     g_type_class_add_private (object_class, sizeof (MMModemPrivate));
 
     /* Virtual methods */
     object_class->dispose = dispose;
     object_class->finalize = finalize;
+    proxy_class->g_properties_changed = g_properties_changed;
 }
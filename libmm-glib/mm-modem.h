@@ -32,6 +32,7 @@
 
 #include "mm-gdbus-modem.h"
 #include "mm-unlock-retries.h"
+#include "mm-modem-snapshot.h"
 #include "mm-sim.h"
 #include "mm-bearer.h"
 #include "mm-helper-types.h"
@@ -130,6 +131,10 @@ gboolean           mm_modem_get_ports                (MMModem *self,
                                                       MMModemPortInfo **ports,
                                                       guint *n_ports);
 
+gboolean           mm_modem_get_connection_timing_histograms (MMModem                           *self,
+                                                              MMModemConnectionTimingHistogram **histograms,
+                                                              guint                             *n_histograms);
+
 const gchar       *mm_modem_get_equipment_identifier (MMModem *self);
 gchar             *mm_modem_dup_equipment_identifier (MMModem *self);
 
@@ -179,6 +184,8 @@ gboolean           mm_modem_get_current_bands        (MMModem *self,
 
 MMBearerIpFamily   mm_modem_get_supported_ip_families (MMModem *self);
 
+MMModemSnapshot   *mm_modem_get_snapshot             (MMModem *self);
+
 void     mm_modem_enable        (MMModem *self,
                                  GCancellable *cancellable,
                                  GAsyncReadyCallback callback,
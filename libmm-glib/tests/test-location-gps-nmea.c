@@ -0,0 +1,140 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <libmm-glib.h>
+#include <string.h>
+
+#define GPGGA   "$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76"
+#define GPGSV_1 "$GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30*70"
+#define GPGSV_2 "$GPGSV,3,2,11,02,39,223,19,13,28,070,17,26,23,252,,04,14,186,14*79"
+#define GPGSV_3 "$GPGSV,3,3,11,29,09,301,24,16,09,020,,36,,,*76"
+#define GLGSV_1 "$GLGSV,2,1,06,65,64,037,41,66,53,269,43,88,39,200,33,81,27,076,*6C"
+#define GLGSV_2 "$GLGSV,2,2,06,72,17,320,39,87,09,109,*6A"
+#define GNGSA_1 "$GNGSA,A,3,10,07,05,08,02,13,,,,,,,1.72,1.03,1.38*1C"
+#define GNGSA_2 "$GNGSA,A,3,65,66,88,,,,,,,,,,1.72,1.03,1.38*1F"
+
+/*****************************************************************************/
+
+static void
+test_sequences (void)
+{
+    MMLocationGpsNmea *nmea;
+
+    nmea = mm_location_gps_nmea_new ();
+
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GPGGA));
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GPGSV_1));
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GPGSV_2));
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GLGSV_1));
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GPGSV_3));
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GLGSV_2));
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GNGSA_1));
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GNGSA_2));
+    g_assert (!mm_location_gps_nmea_add_trace (nmea, "garbage"));
+
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GPGGA"), ==, GPGGA);
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GPGSV"), ==,
+                     GPGSV_1 "\r\n" GPGSV_2 "\r\n" GPGSV_3);
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GLGSV"), ==,
+                     GLGSV_1 "\r\n" GLGSV_2);
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GNGSA"), ==,
+                     GNGSA_1 "\r\n" GNGSA_2);
+    g_assert (!mm_location_gps_nmea_get_trace (nmea, "$GPRMC"));
+
+    /* Repeated sentences replace the stored ones */
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GPGSV_2));
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GPGSV"), ==,
+                     GPGSV_1 "\r\n" GPGSV_2 "\r\n" GPGSV_3);
+
+    /* A new sequence starts with the first sentence, or with a non
+     * consecutive GSA */
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GPGSV_1));
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GPGSV"), ==, GPGSV_1);
+    g_assert (mm_location_gps_nmea_add_trace (nmea, GNGSA_2));
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GNGSA"), ==, GNGSA_2);
+
+    g_object_unref (nmea);
+}
+
+static void
+test_string_variant (void)
+{
+    MMLocationGpsNmea *nmea;
+    MMLocationGpsNmea *copy;
+    GVariant          *variant;
+    GError            *error = NULL;
+    gchar            **traces;
+
+    nmea = mm_location_gps_nmea_new ();
+    mm_location_gps_nmea_add_trace (nmea, GPGGA);
+    mm_location_gps_nmea_add_trace (nmea, GPGSV_1);
+    mm_location_gps_nmea_add_trace (nmea, GPGSV_2);
+    mm_location_gps_nmea_add_trace (nmea, "$PQXFI,092750.0,5321.6802,N,00630.3372,W,61.7,1.7,1.5,0.1*5B");
+
+    /* Traces are kept in the order they were first seen */
+    variant = mm_location_gps_nmea_get_string_variant (nmea);
+    g_assert_cmpstr (g_variant_get_string (variant, NULL), ==,
+                     GPGGA "\r\n" GPGSV_1 "\r\n" GPGSV_2 "\r\n"
+                     "$PQXFI,092750.0,5321.6802,N,00630.3372,W,61.7,1.7,1.5,0.1*5B");
+
+    copy = mm_location_gps_nmea_new_from_string_variant (variant, &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (copy, "$GPGSV"), ==, GPGSV_1 "\r\n" GPGSV_2);
+    g_assert (mm_location_gps_nmea_get_trace (copy, "$PQXFI"));
+
+    traces = mm_location_gps_nmea_get_traces (copy);
+    g_assert_cmpuint (g_strv_length (traces), ==, 3);
+    g_strfreev (traces);
+
+    g_variant_unref (variant);
+    g_object_unref (copy);
+    g_object_unref (nmea);
+}
+
+static void
+test_crlf_terminated (void)
+{
+    MMLocationGpsNmea *nmea;
+    GVariant          *variant;
+
+    /* Traces given with their trailing CR-LF must not end up separated by
+     * two of them */
+    nmea = mm_location_gps_nmea_new ();
+    mm_location_gps_nmea_add_trace (nmea, GPGGA "\r\n");
+    mm_location_gps_nmea_add_trace (nmea, GPGSV_1 "\r\n");
+    mm_location_gps_nmea_add_trace (nmea, GPGSV_2 "\r\n");
+
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GPGSV"), ==,
+                     GPGSV_1 "\r\n" GPGSV_2 "\r\n");
+
+    variant = mm_location_gps_nmea_get_string_variant (nmea);
+    g_assert_cmpstr (g_variant_get_string (variant, NULL), ==,
+                     GPGGA "\r\n" GPGSV_1 "\r\n" GPGSV_2 "\r\n");
+
+    g_variant_unref (variant);
+    g_object_unref (nmea);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/location-gps-nmea/sequences",       test_sequences);
+    g_test_add_func ("/MM/location-gps-nmea/string-variant",  test_string_variant);
+    g_test_add_func ("/MM/location-gps-nmea/crlf-terminated", test_crlf_terminated);
+
+    return g_test_run ();
+}
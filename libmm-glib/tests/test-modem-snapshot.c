@@ -0,0 +1,217 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <libmm-glib.h>
+#include <string.h>
+
+/*****************************************************************************/
+
+/* A proxy which is never connected; property values are set in its cache
+ * and PropertiesChanged is fed by emitting g-properties-changed */
+static MMModem *
+modem_new (void)
+{
+    return g_object_new (MM_TYPE_MODEM,
+                         "g-object-path",    MM_DBUS_MODEM_PREFIX "/0",
+                         "g-interface-name", MM_DBUS_INTERFACE_MODEM,
+                         "g-flags",          (G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES |
+                                              G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS |
+                                              G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START),
+                         NULL);
+}
+
+/* Takes ownership of a floating @value, NULL invalidates the property */
+static void
+modem_set_property (MMModem     *modem,
+                    const gchar *name,
+                    GVariant    *value,
+                    gboolean     notify)
+{
+    GVariantBuilder  builder;
+    const gchar     *invalidated[] = { name, NULL };
+    const gchar     *none[] = { NULL };
+
+    if (value)
+        g_variant_ref_sink (value);
+    g_dbus_proxy_set_cached_property (G_DBUS_PROXY (modem), name, value);
+
+    if (notify) {
+        GVariant *changed;
+
+        g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+        if (value)
+            g_variant_builder_add (&builder, "{sv}", name, value);
+        changed = g_variant_ref_sink (g_variant_builder_end (&builder));
+        g_signal_emit_by_name (modem,
+                               "g-properties-changed",
+                               changed,
+                               value ? none : invalidated);
+        g_variant_unref (changed);
+    }
+
+    if (value)
+        g_variant_unref (value);
+}
+
+static GVariant *
+build_ports (const gchar *first_port,
+             ...)
+{
+    GVariantBuilder  builder;
+    const gchar     *port;
+    va_list          args;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(su)"));
+    va_start (args, first_port);
+    for (port = first_port; port; port = va_arg (args, const gchar *))
+        g_variant_builder_add (&builder, "(su)", port, MM_MODEM_PORT_TYPE_AT);
+    va_end (args);
+    return g_variant_builder_end (&builder);
+}
+
+static GVariant *
+build_unlock_retries (guint sim_pin)
+{
+    GVariantBuilder builder;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{uu}"));
+    g_variant_builder_add (&builder, "{uu}", MM_MODEM_LOCK_SIM_PIN, sim_pin);
+    return g_variant_builder_end (&builder);
+}
+
+static void
+check_ports (MMModemSnapshot *snapshot,
+             const gchar     *first_port,
+             const gchar     *second_port)
+{
+    const MMModemPortInfo *ports = NULL;
+    guint                  n_ports = 0;
+
+    g_assert (mm_modem_snapshot_peek_ports (snapshot, &ports, &n_ports));
+    g_assert_cmpuint (n_ports, ==, second_port ? 2 : 1);
+    g_assert_cmpstr (ports[0].name, ==, first_port);
+    if (second_port)
+        g_assert_cmpstr (ports[1].name, ==, second_port);
+}
+
+/*****************************************************************************/
+
+static void
+test_properties_changed (void)
+{
+    MMModem               *modem;
+    MMModemSnapshot       *first;
+    MMModemSnapshot       *snapshot;
+    MMModemSnapshot       *previous;
+    const MMModemPortInfo *ports = NULL;
+    const MMModemPortInfo *previous_ports = NULL;
+    guint                  n_ports = 0;
+
+    modem = modem_new ();
+    modem_set_property (modem, "Manufacturer", g_variant_new_string ("Acme"), FALSE);
+    modem_set_property (modem, "Ports", build_ports ("ttyUSB0", NULL), FALSE);
+
+    /* Same snapshot while nothing changes */
+    first = mm_modem_get_snapshot (modem);
+    snapshot = mm_modem_get_snapshot (modem);
+    g_assert (snapshot == first);
+    g_object_unref (snapshot);
+    g_assert_cmpstr (mm_modem_snapshot_get_manufacturer (first), ==, "Acme");
+    check_ports (first, "ttyUSB0", NULL);
+
+    /* Values not announced in PropertiesChanged are not seen */
+    modem_set_property (modem, "Ports", build_ports ("ttyUSB1", NULL), FALSE);
+    snapshot = mm_modem_get_snapshot (modem);
+    g_assert (snapshot == first);
+    g_object_unref (snapshot);
+
+    /* Any change drops the snapshot, but only the changed arrays are decoded
+     * again: the stale ports are still the cached ones */
+    modem_set_property (modem, "Manufacturer", g_variant_new_string ("Other"), TRUE);
+    snapshot = mm_modem_get_snapshot (modem);
+    g_assert (snapshot != first);
+    g_assert_cmpstr (mm_modem_snapshot_get_manufacturer (snapshot), ==, "Other");
+    g_assert (mm_modem_snapshot_peek_ports (first, &previous_ports, &n_ports));
+    g_assert (mm_modem_snapshot_peek_ports (snapshot, &ports, &n_ports));
+    g_assert (ports == previous_ports);
+    check_ports (snapshot, "ttyUSB0", NULL);
+
+    /* Changed array decoded again */
+    previous = snapshot;
+    modem_set_property (modem, "Ports", build_ports ("ttyUSB1", "ttyUSB2", NULL), TRUE);
+    snapshot = mm_modem_get_snapshot (modem);
+    g_assert (snapshot != previous);
+    g_assert (mm_modem_snapshot_peek_ports (snapshot, &ports, &n_ports));
+    g_assert (ports != previous_ports);
+    check_ports (snapshot, "ttyUSB1", "ttyUSB2");
+    g_object_unref (previous);
+
+    /* Invalidated array dropped */
+    previous = snapshot;
+    modem_set_property (modem, "Ports", NULL, TRUE);
+    snapshot = mm_modem_get_snapshot (modem);
+    g_assert (snapshot != previous);
+    g_assert (!mm_modem_snapshot_peek_ports (snapshot, &ports, &n_ports));
+    g_object_unref (previous);
+    g_object_unref (snapshot);
+
+    /* Older snapshots are not affected */
+    g_assert_cmpstr (mm_modem_snapshot_get_manufacturer (first), ==, "Acme");
+    check_ports (first, "ttyUSB0", NULL);
+
+    g_object_unref (first);
+    g_object_unref (modem);
+}
+
+static void
+test_unlock_retries (void)
+{
+    MMModem         *modem;
+    MMModemSnapshot *snapshot;
+    MMUnlockRetries *unlock_retries;
+
+    modem = modem_new ();
+    modem_set_property (modem, "UnlockRetries", build_unlock_retries (3), FALSE);
+
+    snapshot = mm_modem_get_snapshot (modem);
+    unlock_retries = mm_modem_get_unlock_retries (modem);
+    g_assert (unlock_retries);
+    g_assert (mm_modem_snapshot_peek_unlock_retries (snapshot) != unlock_retries);
+    g_assert (mm_unlock_retries_cmp (mm_modem_snapshot_peek_unlock_retries (snapshot), unlock_retries));
+
+    /* Callers of mm_modem_get_unlock_retries() may modify the object */
+    mm_unlock_retries_set (unlock_retries, MM_MODEM_LOCK_SIM_PIN, 0);
+    g_assert_cmpuint (mm_unlock_retries_get (mm_modem_snapshot_peek_unlock_retries (snapshot), MM_MODEM_LOCK_SIM_PIN), ==, 3);
+    g_object_unref (unlock_retries);
+    g_object_unref (snapshot);
+
+    modem_set_property (modem, "UnlockRetries", build_unlock_retries (2), TRUE);
+    snapshot = mm_modem_get_snapshot (modem);
+    g_assert_cmpuint (mm_unlock_retries_get (mm_modem_snapshot_peek_unlock_retries (snapshot), MM_MODEM_LOCK_SIM_PIN), ==, 2);
+    g_object_unref (snapshot);
+
+    g_object_unref (modem);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/modem-snapshot/properties-changed", test_properties_changed);
+    g_test_add_func ("/MM/modem-snapshot/unlock-retries",     test_unlock_retries);
+
+    return g_test_run ();
+}
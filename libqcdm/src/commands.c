@@ -312,6 +312,14 @@ qcdm_cmd_version_info_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const version_info_keys[QCDM_CMD_VERSION_INFO_N_FIELDS] = {
+    [QCDM_CMD_VERSION_INFO_FIELD_COMP_DATE] = QCDM_CMD_VERSION_INFO_ITEM_COMP_DATE,
+    [QCDM_CMD_VERSION_INFO_FIELD_COMP_TIME] = QCDM_CMD_VERSION_INFO_ITEM_COMP_TIME,
+    [QCDM_CMD_VERSION_INFO_FIELD_RELEASE_DATE] = QCDM_CMD_VERSION_INFO_ITEM_RELEASE_DATE,
+    [QCDM_CMD_VERSION_INFO_FIELD_RELEASE_TIME] = QCDM_CMD_VERSION_INFO_ITEM_RELEASE_TIME,
+    [QCDM_CMD_VERSION_INFO_FIELD_MODEL] = QCDM_CMD_VERSION_INFO_ITEM_MODEL,
+};
+
 QcdmResult *
 qcdm_cmd_version_info_result (const char *buf, size_t len, int *out_error)
 {
@@ -324,32 +332,32 @@ qcdm_cmd_version_info_result (const char *buf, size_t len, int *out_error)
     if (!check_command (buf, len, DIAG_CMD_VERSION_INFO, sizeof (DMCmdVersionInfoRsp), out_error))
         return NULL;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (version_info_keys, QCDM_CMD_VERSION_INFO_N_FIELDS, 5 * sizeof (tmp));
 
     memset (tmp, 0, sizeof (tmp));
     qcdm_assert (sizeof (rsp->comp_date) <= sizeof (tmp));
     memcpy (tmp, rsp->comp_date, sizeof (rsp->comp_date));
-    qcdm_result_add_string (result, QCDM_CMD_VERSION_INFO_ITEM_COMP_DATE, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_VERSION_INFO_FIELD_COMP_DATE, tmp);
 
     memset (tmp, 0, sizeof (tmp));
     qcdm_assert (sizeof (rsp->comp_time) <= sizeof (tmp));
     memcpy (tmp, rsp->comp_time, sizeof (rsp->comp_time));
-    qcdm_result_add_string (result, QCDM_CMD_VERSION_INFO_ITEM_COMP_TIME, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_VERSION_INFO_FIELD_COMP_TIME, tmp);
 
     memset (tmp, 0, sizeof (tmp));
     qcdm_assert (sizeof (rsp->rel_date) <= sizeof (tmp));
     memcpy (tmp, rsp->rel_date, sizeof (rsp->rel_date));
-    qcdm_result_add_string (result, QCDM_CMD_VERSION_INFO_ITEM_RELEASE_DATE, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_VERSION_INFO_FIELD_RELEASE_DATE, tmp);
 
     memset (tmp, 0, sizeof (tmp));
     qcdm_assert (sizeof (rsp->rel_time) <= sizeof (tmp));
     memcpy (tmp, rsp->rel_time, sizeof (rsp->rel_time));
-    qcdm_result_add_string (result, QCDM_CMD_VERSION_INFO_ITEM_RELEASE_TIME, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_VERSION_INFO_FIELD_RELEASE_TIME, tmp);
 
     memset (tmp, 0, sizeof (tmp));
     qcdm_assert (sizeof (rsp->model) <= sizeof (tmp));
     memcpy (tmp, rsp->model, sizeof (rsp->model));
-    qcdm_result_add_string (result, QCDM_CMD_VERSION_INFO_ITEM_MODEL, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_VERSION_INFO_FIELD_MODEL, tmp);
 
     return result;
 }
@@ -371,6 +379,10 @@ qcdm_cmd_esn_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const esn_keys[QCDM_CMD_ESN_N_FIELDS] = {
+    [QCDM_CMD_ESN_FIELD_ESN] = QCDM_CMD_ESN_ITEM_ESN,
+};
+
 QcdmResult *
 qcdm_cmd_esn_result (const char *buf, size_t len, int *out_error)
 {
@@ -394,8 +406,8 @@ qcdm_cmd_esn_result (const char *buf, size_t len, int *out_error)
 
     tmp = bin2hexstr (&swapped[0], sizeof (swapped));
     if (tmp != NULL) {
-        result = qcdm_result_new ();
-        qcdm_result_add_string (result, QCDM_CMD_ESN_ITEM_ESN, tmp);
+        result = qcdm_result_new_with_fields (esn_keys, QCDM_CMD_ESN_N_FIELDS, 2 * sizeof (swapped) + 1);
+        qcdm_result_set_string (result, QCDM_CMD_ESN_FIELD_ESN, tmp);
         free (tmp);
     }
 
@@ -448,6 +460,18 @@ qcdm_cmd_cdma_status_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const cdma_status_keys[QCDM_CMD_CDMA_STATUS_N_FIELDS] = {
+    [QCDM_CMD_CDMA_STATUS_FIELD_ESN] = QCDM_CMD_CDMA_STATUS_ITEM_ESN,
+    [QCDM_CMD_CDMA_STATUS_FIELD_RF_MODE] = QCDM_CMD_CDMA_STATUS_ITEM_RF_MODE,
+    [QCDM_CMD_CDMA_STATUS_FIELD_RX_STATE] = QCDM_CMD_CDMA_STATUS_ITEM_RX_STATE,
+    [QCDM_CMD_CDMA_STATUS_FIELD_ENTRY_REASON] = QCDM_CMD_CDMA_STATUS_ITEM_ENTRY_REASON,
+    [QCDM_CMD_CDMA_STATUS_FIELD_CURRENT_CHANNEL] = QCDM_CMD_CDMA_STATUS_ITEM_CURRENT_CHANNEL,
+    [QCDM_CMD_CDMA_STATUS_FIELD_CODE_CHANNEL] = QCDM_CMD_CDMA_STATUS_ITEM_CODE_CHANNEL,
+    [QCDM_CMD_CDMA_STATUS_FIELD_PILOT_BASE] = QCDM_CMD_CDMA_STATUS_ITEM_PILOT_BASE,
+    [QCDM_CMD_CDMA_STATUS_FIELD_SID] = QCDM_CMD_CDMA_STATUS_ITEM_SID,
+    [QCDM_CMD_CDMA_STATUS_FIELD_NID] = QCDM_CMD_CDMA_STATUS_ITEM_NID,
+};
+
 QcdmResult *
 qcdm_cmd_cdma_status_result (const char *buf, size_t len, int *out_error)
 {
@@ -462,7 +486,7 @@ qcdm_cmd_cdma_status_result (const char *buf, size_t len, int *out_error)
     if (!check_command (buf, len, DIAG_CMD_STATUS, sizeof (DMCmdStatusRsp), out_error))
         return NULL;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (cdma_status_keys, QCDM_CMD_CDMA_STATUS_N_FIELDS, 2 * sizeof (swapped) + 1);
 
     /* Convert the ESN from binary to a hex string; it's LE so we have to
      * swap it to get the correct ordering.
@@ -473,31 +497,31 @@ qcdm_cmd_cdma_status_result (const char *buf, size_t len, int *out_error)
     swapped[3] = rsp->esn[0];
 
     tmp = bin2hexstr (&swapped[0], sizeof (swapped));
-    qcdm_result_add_string (result, QCDM_CMD_CDMA_STATUS_ITEM_ESN, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_CDMA_STATUS_FIELD_ESN, tmp);
     free (tmp);
 
     tmp_num = (uint32_t) le16toh (rsp->rf_mode);
-    qcdm_result_add_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_RF_MODE, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CDMA_STATUS_FIELD_RF_MODE, tmp_num);
 
     tmp_num = (uint32_t) le16toh (rsp->cdma_rx_state);
-    qcdm_result_add_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_RX_STATE, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CDMA_STATUS_FIELD_RX_STATE, tmp_num);
 
     tmp_num = (uint32_t) le16toh (rsp->entry_reason);
-    qcdm_result_add_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_ENTRY_REASON, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CDMA_STATUS_FIELD_ENTRY_REASON, tmp_num);
 
     tmp_num = (uint32_t) le16toh (rsp->curr_chan);
-    qcdm_result_add_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_CURRENT_CHANNEL, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CDMA_STATUS_FIELD_CURRENT_CHANNEL, tmp_num);
 
-    qcdm_result_add_u8 (result, QCDM_CMD_CDMA_STATUS_ITEM_CODE_CHANNEL, rsp->cdma_code_chan);
+    qcdm_result_set_u8 (result, QCDM_CMD_CDMA_STATUS_FIELD_CODE_CHANNEL, rsp->cdma_code_chan);
 
     tmp_num = (uint32_t) le16toh (rsp->pilot_base);
-    qcdm_result_add_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_PILOT_BASE, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CDMA_STATUS_FIELD_PILOT_BASE, tmp_num);
 
     tmp_num = (uint32_t) le16toh (rsp->sid);
-    qcdm_result_add_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_SID, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CDMA_STATUS_FIELD_SID, tmp_num);
 
     tmp_num = (uint32_t) le16toh (rsp->nid);
-    qcdm_result_add_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_NID, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CDMA_STATUS_FIELD_NID, tmp_num);
 
     return result;
 }
@@ -519,6 +543,12 @@ qcdm_cmd_sw_version_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const sw_version_keys[QCDM_CMD_SW_VERSION_N_FIELDS] = {
+    [QCDM_CMD_SW_VERSION_FIELD_VERSION] = QCDM_CMD_SW_VERSION_ITEM_VERSION,
+    [QCDM_CMD_SW_VERSION_FIELD_COMP_DATE] = QCDM_CMD_SW_VERSION_ITEM_COMP_DATE,
+    [QCDM_CMD_SW_VERSION_FIELD_COMP_TIME] = QCDM_CMD_SW_VERSION_ITEM_COMP_TIME,
+};
+
 QcdmResult *
 qcdm_cmd_sw_version_result (const char *buf, size_t len, int *out_error)
 {
@@ -531,22 +561,22 @@ qcdm_cmd_sw_version_result (const char *buf, size_t len, int *out_error)
     if (!check_command (buf, len, DIAG_CMD_SW_VERSION, sizeof (*rsp), out_error))
         return NULL;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (sw_version_keys, QCDM_CMD_SW_VERSION_N_FIELDS, 3 * sizeof (tmp));
 
     memset (tmp, 0, sizeof (tmp));
     qcdm_assert (sizeof (rsp->version) <= sizeof (tmp));
     memcpy (tmp, rsp->version, sizeof (rsp->version));
-    qcdm_result_add_string (result, QCDM_CMD_SW_VERSION_ITEM_VERSION, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_SW_VERSION_FIELD_VERSION, tmp);
 
     memset (tmp, 0, sizeof (tmp));
     qcdm_assert (sizeof (rsp->comp_date) <= sizeof (tmp));
     memcpy (tmp, rsp->comp_date, sizeof (rsp->comp_date));
-    qcdm_result_add_string (result, QCDM_CMD_SW_VERSION_ITEM_COMP_DATE, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_SW_VERSION_FIELD_COMP_DATE, tmp);
 
     memset (tmp, 0, sizeof (tmp));
     qcdm_assert (sizeof (rsp->comp_time) <= sizeof (tmp));
     memcpy (tmp, rsp->comp_time, sizeof (rsp->comp_time));
-    qcdm_result_add_string (result, QCDM_CMD_SW_VERSION_ITEM_COMP_TIME, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_SW_VERSION_FIELD_COMP_TIME, tmp);
 
     return result;
 }
@@ -586,6 +616,16 @@ digit_fixup (uint8_t d)
     return 0;
 }
 
+static const char *const status_snapshot_keys[QCDM_CMD_STATUS_SNAPSHOT_N_FIELDS] = {
+    [QCDM_CMD_STATUS_SNAPSHOT_FIELD_ESN] = QCDM_CMD_STATUS_SNAPSHOT_ITEM_ESN,
+    [QCDM_CMD_STATUS_SNAPSHOT_FIELD_HOME_MCC] = QCDM_CMD_STATUS_SNAPSHOT_ITEM_HOME_MCC,
+    [QCDM_CMD_STATUS_SNAPSHOT_FIELD_BAND_CLASS] = QCDM_CMD_STATUS_SNAPSHOT_ITEM_BAND_CLASS,
+    [QCDM_CMD_STATUS_SNAPSHOT_FIELD_BASE_STATION_PREV] = QCDM_CMD_STATUS_SNAPSHOT_ITEM_BASE_STATION_PREV,
+    [QCDM_CMD_STATUS_SNAPSHOT_FIELD_MOBILE_PREV] = QCDM_CMD_STATUS_SNAPSHOT_ITEM_MOBILE_PREV,
+    [QCDM_CMD_STATUS_SNAPSHOT_FIELD_PREV_IN_USE] = QCDM_CMD_STATUS_SNAPSHOT_ITEM_PREV_IN_USE,
+    [QCDM_CMD_STATUS_SNAPSHOT_FIELD_STATE] = QCDM_CMD_STATUS_SNAPSHOT_ITEM_STATE,
+};
+
 QcdmResult *
 qcdm_cmd_status_snapshot_result (const char *buf, size_t len, int *out_error)
 {
@@ -601,7 +641,7 @@ qcdm_cmd_status_snapshot_result (const char *buf, size_t len, int *out_error)
     if (!check_command (buf, len, DIAG_CMD_STATUS_SNAPSHOT, sizeof (*rsp), out_error))
         return NULL;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (status_snapshot_keys, QCDM_CMD_STATUS_SNAPSHOT_N_FIELDS, 2 * sizeof (swapped) + 1);
 
     /* Convert the ESN from binary to a hex string; it's LE so we have to
      * swap it to get the correct ordering.
@@ -612,7 +652,7 @@ qcdm_cmd_status_snapshot_result (const char *buf, size_t len, int *out_error)
     swapped[3] = rsp->esn[0];
 
     tmp = bin2hexstr (&swapped[0], sizeof (swapped));
-    qcdm_result_add_string (result, QCDM_CMD_STATUS_SNAPSHOT_ITEM_ESN, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_STATUS_SNAPSHOT_FIELD_ESN, tmp);
     free (tmp);
 
     /* Cheap binary -> decimal conversion */
@@ -622,13 +662,13 @@ qcdm_cmd_status_snapshot_result (const char *buf, size_t len, int *out_error)
     tmcc[0] = (hmcc - (tmcc[2] * 100) - (tmcc[1] * 10));
 
     mcc = (100 * digit_fixup (tmcc[2])) + (10 * digit_fixup (tmcc[1])) + digit_fixup (tmcc[0]);
-    qcdm_result_add_u32 (result, QCDM_CMD_STATUS_SNAPSHOT_ITEM_HOME_MCC, mcc);
+    qcdm_result_set_u32 (result, QCDM_CMD_STATUS_SNAPSHOT_FIELD_HOME_MCC, mcc);
 
-    qcdm_result_add_u8 (result, QCDM_CMD_STATUS_SNAPSHOT_ITEM_BAND_CLASS, cdma_band_class_to_qcdm (rsp->band_class));
-    qcdm_result_add_u8 (result, QCDM_CMD_STATUS_SNAPSHOT_ITEM_BASE_STATION_PREV, cdma_prev_to_qcdm (rsp->prev));
-    qcdm_result_add_u8 (result, QCDM_CMD_STATUS_SNAPSHOT_ITEM_MOBILE_PREV, cdma_prev_to_qcdm (rsp->mob_prev));
-    qcdm_result_add_u8 (result, QCDM_CMD_STATUS_SNAPSHOT_ITEM_PREV_IN_USE, cdma_prev_to_qcdm (rsp->prev_in_use));
-    qcdm_result_add_u8 (result, QCDM_CMD_STATUS_SNAPSHOT_ITEM_STATE, snapshot_state_to_qcdm (rsp->state & 0xF));
+    qcdm_result_set_u8 (result, QCDM_CMD_STATUS_SNAPSHOT_FIELD_BAND_CLASS, cdma_band_class_to_qcdm (rsp->band_class));
+    qcdm_result_set_u8 (result, QCDM_CMD_STATUS_SNAPSHOT_FIELD_BASE_STATION_PREV, cdma_prev_to_qcdm (rsp->prev));
+    qcdm_result_set_u8 (result, QCDM_CMD_STATUS_SNAPSHOT_FIELD_MOBILE_PREV, cdma_prev_to_qcdm (rsp->mob_prev));
+    qcdm_result_set_u8 (result, QCDM_CMD_STATUS_SNAPSHOT_FIELD_PREV_IN_USE, cdma_prev_to_qcdm (rsp->prev_in_use));
+    qcdm_result_set_u8 (result, QCDM_CMD_STATUS_SNAPSHOT_FIELD_STATE, snapshot_state_to_qcdm (rsp->state & 0xF));
 
     return result;
 }
@@ -654,16 +694,29 @@ qcdm_cmd_pilot_sets_new (char *buf, size_t len)
 #define PILOT_SETS_CMD_CANDIDATE_SET "candidate-set"
 #define PILOT_SETS_CMD_NEIGHBOR_SET  "neighbor-set"
 
-static const char *
-set_num_to_str (uint32_t num)
+enum {
+    PILOT_SETS_CMD_FIELD_ACTIVE_SET = 0,
+    PILOT_SETS_CMD_FIELD_CANDIDATE_SET,
+    PILOT_SETS_CMD_FIELD_NEIGHBOR_SET,
+    PILOT_SETS_CMD_N_FIELDS
+};
+
+static const char *const pilot_sets_keys[PILOT_SETS_CMD_N_FIELDS] = {
+    [PILOT_SETS_CMD_FIELD_ACTIVE_SET]    = PILOT_SETS_CMD_ACTIVE_SET,
+    [PILOT_SETS_CMD_FIELD_CANDIDATE_SET] = PILOT_SETS_CMD_CANDIDATE_SET,
+    [PILOT_SETS_CMD_FIELD_NEIGHBOR_SET]  = PILOT_SETS_CMD_NEIGHBOR_SET,
+};
+
+static int
+set_num_to_field (uint32_t num)
 {
     if (num == QCDM_CMD_PILOT_SETS_TYPE_ACTIVE)
-        return PILOT_SETS_CMD_ACTIVE_SET;
+        return PILOT_SETS_CMD_FIELD_ACTIVE_SET;
     if (num == QCDM_CMD_PILOT_SETS_TYPE_CANDIDATE)
-        return PILOT_SETS_CMD_CANDIDATE_SET;
+        return PILOT_SETS_CMD_FIELD_CANDIDATE_SET;
     if (num == QCDM_CMD_PILOT_SETS_TYPE_NEIGHBOR)
-        return PILOT_SETS_CMD_NEIGHBOR_SET;
-    return NULL;
+        return PILOT_SETS_CMD_FIELD_NEIGHBOR_SET;
+    return -1;
 }
 
 QcdmResult *
@@ -678,28 +731,28 @@ qcdm_cmd_pilot_sets_result (const char *buf, size_t len, int *out_error)
     if (!check_command (buf, len, DIAG_CMD_PILOT_SETS, sizeof (DMCmdPilotSetsRsp), out_error))
         return NULL;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (pilot_sets_keys, PILOT_SETS_CMD_N_FIELDS, len);
 
     sets_len = rsp->active_count * sizeof (DMCmdPilotSetsSet);
     if (sets_len > 0) {
-        qcdm_result_add_u8_array (result,
-                                  PILOT_SETS_CMD_ACTIVE_SET,
+        qcdm_result_set_u8_array (result,
+                                  PILOT_SETS_CMD_FIELD_ACTIVE_SET,
                                   (const uint8_t *) &rsp->sets[0],
                                   sets_len);
     }
 
     sets_len = rsp->candidate_count * sizeof (DMCmdPilotSetsSet);
     if (sets_len > 0) {
-        qcdm_result_add_u8_array (result,
-                                  PILOT_SETS_CMD_CANDIDATE_SET,
+        qcdm_result_set_u8_array (result,
+                                  PILOT_SETS_CMD_FIELD_CANDIDATE_SET,
                                   (const uint8_t *) &rsp->sets[rsp->active_count],
                                   sets_len);
     }
 
     sets_len = rsp->neighbor_count * sizeof (DMCmdPilotSetsSet);
     if (sets_len > 0) {
-        qcdm_result_add_u8_array (result,
-                                  PILOT_SETS_CMD_NEIGHBOR_SET,
+        qcdm_result_set_u8_array (result,
+                                  PILOT_SETS_CMD_FIELD_NEIGHBOR_SET,
                                   (const uint8_t *) &rsp->sets[rsp->active_count + rsp->candidate_count],
                                   sets_len);
     }
@@ -712,16 +765,16 @@ qcdm_cmd_pilot_sets_result_get_num (QcdmResult *result,
                                     uint32_t set_type,
                                     uint32_t *out_num)
 {
-    const char *set_name;
+    int field;
     const uint8_t *array = NULL;
     size_t array_len = 0;
 
     qcdm_return_val_if_fail (result != NULL, FALSE);
 
-    set_name = set_num_to_str (set_type);
-    qcdm_return_val_if_fail (set_name != NULL, FALSE);
+    field = set_num_to_field (set_type);
+    qcdm_return_val_if_fail (field >= 0, FALSE);
 
-    if (qcdm_result_get_u8_array (result, set_name, &array, &array_len))
+    if (qcdm_result_get_field_u8_array (result, field, &array, &array_len))
         return FALSE;
 
     *out_num = array_len / sizeof (DMCmdPilotSetsSet);
@@ -736,17 +789,17 @@ qcdm_cmd_pilot_sets_result_get_pilot (QcdmResult *result,
                                       uint32_t *out_ecio,
                                       float *out_db)
 {
-    const char *set_name;
+    int field;
     DMCmdPilotSetsSet *set;
     const uint8_t *array = NULL;
     size_t array_len = 0;
 
     qcdm_return_val_if_fail (result != NULL, FALSE);
 
-    set_name = set_num_to_str (set_type);
-    qcdm_return_val_if_fail (set_name != NULL, FALSE);
+    field = set_num_to_field (set_type);
+    qcdm_return_val_if_fail (field >= 0, FALSE);
 
-    if (qcdm_result_get_u8_array (result, set_name, &array, &array_len))
+    if (qcdm_result_get_field_u8_array (result, field, &array, &array_len))
         return FALSE;
 
     qcdm_return_val_if_fail (num < array_len / sizeof (DMCmdPilotSetsSet), FALSE);
@@ -781,6 +834,11 @@ qcdm_cmd_nv_get_mdn_new (char *buf, size_t len, uint8_t profile)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const nv_get_mdn_keys[QCDM_CMD_NV_GET_MDN_N_FIELDS] = {
+    [QCDM_CMD_NV_GET_MDN_FIELD_PROFILE] = QCDM_CMD_NV_GET_MDN_ITEM_PROFILE,
+    [QCDM_CMD_NV_GET_MDN_FIELD_MDN] = QCDM_CMD_NV_GET_MDN_ITEM_MDN,
+};
+
 QcdmResult *
 qcdm_cmd_nv_get_mdn_result (const char *buf, size_t len, int *out_error)
 {
@@ -799,14 +857,14 @@ qcdm_cmd_nv_get_mdn_result (const char *buf, size_t len, int *out_error)
 
     mdn = (DMNVItemMdn *) &rsp->data[0];
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (nv_get_mdn_keys, QCDM_CMD_NV_GET_MDN_N_FIELDS, sizeof (tmp));
 
-    qcdm_result_add_u8 (result, QCDM_CMD_NV_GET_MDN_ITEM_PROFILE, mdn->profile);
+    qcdm_result_set_u8 (result, QCDM_CMD_NV_GET_MDN_FIELD_PROFILE, mdn->profile);
 
     memset (tmp, 0, sizeof (tmp));
     qcdm_assert (sizeof (mdn->mdn) <= sizeof (tmp));
     memcpy (tmp, mdn->mdn, sizeof (mdn->mdn));
-    qcdm_result_add_string (result, QCDM_CMD_NV_GET_MDN_ITEM_MDN, tmp);
+    qcdm_result_set_string (result, QCDM_CMD_NV_GET_MDN_FIELD_MDN, tmp);
 
     return result;
 }
@@ -843,6 +901,11 @@ qcdm_cmd_nv_get_roam_pref_new (char *buf, size_t len, uint8_t profile)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const nv_get_roam_pref_keys[QCDM_CMD_NV_GET_ROAM_PREF_N_FIELDS] = {
+    [QCDM_CMD_NV_GET_ROAM_PREF_FIELD_PROFILE] = QCDM_CMD_NV_GET_ROAM_PREF_ITEM_PROFILE,
+    [QCDM_CMD_NV_GET_ROAM_PREF_FIELD_ROAM_PREF] = QCDM_CMD_NV_GET_ROAM_PREF_ITEM_ROAM_PREF,
+};
+
 QcdmResult *
 qcdm_cmd_nv_get_roam_pref_result (const char *buf, size_t len, int *out_error)
 {
@@ -865,9 +928,9 @@ qcdm_cmd_nv_get_roam_pref_result (const char *buf, size_t len, int *out_error)
         return NULL;
     }
 
-    result = qcdm_result_new ();
-    qcdm_result_add_u8 (result, QCDM_CMD_NV_GET_ROAM_PREF_ITEM_PROFILE, roam->profile);
-    qcdm_result_add_u8 (result, QCDM_CMD_NV_GET_ROAM_PREF_ITEM_ROAM_PREF, roam->roam_pref);
+    result = qcdm_result_new_with_fields (nv_get_roam_pref_keys, QCDM_CMD_NV_GET_ROAM_PREF_N_FIELDS, 0);
+    qcdm_result_set_u8 (result, QCDM_CMD_NV_GET_ROAM_PREF_FIELD_PROFILE, roam->profile);
+    qcdm_result_set_u8 (result, QCDM_CMD_NV_GET_ROAM_PREF_FIELD_ROAM_PREF, roam->roam_pref);
 
     return result;
 }
@@ -937,6 +1000,11 @@ qcdm_cmd_nv_get_mode_pref_new (char *buf, size_t len, uint8_t profile)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const nv_get_mode_pref_keys[QCDM_CMD_NV_GET_MODE_PREF_N_FIELDS] = {
+    [QCDM_CMD_NV_GET_MODE_PREF_FIELD_PROFILE] = QCDM_CMD_NV_GET_MODE_PREF_ITEM_PROFILE,
+    [QCDM_CMD_NV_GET_MODE_PREF_FIELD_MODE_PREF] = QCDM_CMD_NV_GET_MODE_PREF_ITEM_MODE_PREF,
+};
+
 QcdmResult *
 qcdm_cmd_nv_get_mode_pref_result (const char *buf, size_t len, int *out_error)
 {
@@ -954,9 +1022,9 @@ qcdm_cmd_nv_get_mode_pref_result (const char *buf, size_t len, int *out_error)
 
     mode = (DMNVItemModePref *) &rsp->data[0];
 
-    result = qcdm_result_new ();
-    qcdm_result_add_u8 (result, QCDM_CMD_NV_GET_MODE_PREF_ITEM_PROFILE, mode->profile);
-    qcdm_result_add_u8 (result, QCDM_CMD_NV_GET_MODE_PREF_ITEM_MODE_PREF, mode->mode_pref);
+    result = qcdm_result_new_with_fields (nv_get_mode_pref_keys, QCDM_CMD_NV_GET_MODE_PREF_N_FIELDS, 0);
+    qcdm_result_set_u8 (result, QCDM_CMD_NV_GET_MODE_PREF_FIELD_PROFILE, mode->profile);
+    qcdm_result_set_u8 (result, QCDM_CMD_NV_GET_MODE_PREF_FIELD_MODE_PREF, mode->mode_pref);
 
     return result;
 }
@@ -1017,6 +1085,10 @@ qcdm_cmd_nv_get_hybrid_pref_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const nv_get_hybrid_pref_keys[QCDM_CMD_NV_GET_HYBRID_PREF_N_FIELDS] = {
+    [QCDM_CMD_NV_GET_HYBRID_PREF_FIELD_HYBRID_PREF] = QCDM_CMD_NV_GET_HYBRID_PREF_ITEM_HYBRID_PREF,
+};
+
 QcdmResult *
 qcdm_cmd_nv_get_hybrid_pref_result (const char *buf, size_t len, int *out_error)
 {
@@ -1037,8 +1109,8 @@ qcdm_cmd_nv_get_hybrid_pref_result (const char *buf, size_t len, int *out_error)
     if (hybrid->hybrid_pref > 1)
         qcdm_warn (0, "Unknown hybrid preference 0x%X", hybrid->hybrid_pref);
 
-    result = qcdm_result_new ();
-    qcdm_result_add_u8 (result, QCDM_CMD_NV_GET_HYBRID_PREF_ITEM_HYBRID_PREF, hybrid->hybrid_pref);
+    result = qcdm_result_new_with_fields (nv_get_hybrid_pref_keys, QCDM_CMD_NV_GET_HYBRID_PREF_N_FIELDS, 0);
+    qcdm_result_set_u8 (result, QCDM_CMD_NV_GET_HYBRID_PREF_FIELD_HYBRID_PREF, hybrid->hybrid_pref);
 
     return result;
 }
@@ -1105,6 +1177,10 @@ qcdm_cmd_nv_get_ipv6_enabled_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const nv_get_ipv6_enabled_keys[QCDM_CMD_NV_GET_IPV6_ENABLED_N_FIELDS] = {
+    [QCDM_CMD_NV_GET_IPV6_ENABLED_FIELD_ENABLED] = QCDM_CMD_NV_GET_IPV6_ENABLED_ITEM_ENABLED,
+};
+
 QcdmResult *
 qcdm_cmd_nv_get_ipv6_enabled_result (const char *buf, size_t len, int *out_error)
 {
@@ -1125,8 +1201,8 @@ qcdm_cmd_nv_get_ipv6_enabled_result (const char *buf, size_t len, int *out_error
     if (ipv6->enabled > 1)
         qcdm_warn (0, "Unknown ipv6 preference 0x%X", ipv6->enabled);
 
-    result = qcdm_result_new ();
-    qcdm_result_add_u8 (result, QCDM_CMD_NV_GET_IPV6_ENABLED_ITEM_ENABLED, ipv6->enabled);
+    result = qcdm_result_new_with_fields (nv_get_ipv6_enabled_keys, QCDM_CMD_NV_GET_IPV6_ENABLED_N_FIELDS, 0);
+    qcdm_result_set_u8 (result, QCDM_CMD_NV_GET_IPV6_ENABLED_FIELD_ENABLED, ipv6->enabled);
 
     return result;
 }
@@ -1203,6 +1279,10 @@ qcdm_cmd_nv_get_hdr_rev_pref_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const nv_get_hdr_rev_pref_keys[QCDM_CMD_NV_GET_HDR_REV_PREF_N_FIELDS] = {
+    [QCDM_CMD_NV_GET_HDR_REV_PREF_FIELD_REV_PREF] = QCDM_CMD_NV_GET_HDR_REV_PREF_ITEM_REV_PREF,
+};
+
 QcdmResult *
 qcdm_cmd_nv_get_hdr_rev_pref_result (const char *buf, size_t len, int *out_error)
 {
@@ -1225,8 +1305,8 @@ qcdm_cmd_nv_get_hdr_rev_pref_result (const char *buf, size_t len, int *out_error
         return NULL;
     }
 
-    result = qcdm_result_new ();
-    qcdm_result_add_u8 (result, QCDM_CMD_NV_GET_HDR_REV_PREF_ITEM_REV_PREF, rev->rev_pref);
+    result = qcdm_result_new_with_fields (nv_get_hdr_rev_pref_keys, QCDM_CMD_NV_GET_HDR_REV_PREF_N_FIELDS, 0);
+    qcdm_result_set_u8 (result, QCDM_CMD_NV_GET_HDR_REV_PREF_FIELD_REV_PREF, rev->rev_pref);
 
     return result;
 }
@@ -1291,6 +1371,19 @@ qcdm_cmd_cm_subsys_state_info_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const cm_subsys_state_info_keys[QCDM_CMD_CM_SUBSYS_STATE_INFO_N_FIELDS] = {
+    [QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_CALL_STATE] = QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_CALL_STATE,
+    [QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_OPERATING_MODE] = QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_OPERATING_MODE,
+    [QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_SYSTEM_MODE] = QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_SYSTEM_MODE,
+    [QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_MODE_PREF] = QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_MODE_PREF,
+    [QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_BAND_PREF] = QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_BAND_PREF,
+    [QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_ROAM_PREF] = QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_ROAM_PREF,
+    [QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_SERVICE_DOMAIN_PREF] = QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_SERVICE_DOMAIN_PREF,
+    [QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_ACQ_ORDER_PREF] = QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_ACQ_ORDER_PREF,
+    [QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_HYBRID_PREF] = QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_HYBRID_PREF,
+    [QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_NETWORK_SELECTION_PREF] = QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_NETWORK_SELECTION_PREF,
+};
+
 QcdmResult *
 qcdm_cmd_cm_subsys_state_info_result (const char *buf, size_t len, int *out_error)
 {
@@ -1310,36 +1403,36 @@ qcdm_cmd_cm_subsys_state_info_result (const char *buf, size_t len, int *out_erro
         return NULL;
     }
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (cm_subsys_state_info_keys, QCDM_CMD_CM_SUBSYS_STATE_INFO_N_FIELDS, 0);
 
     tmp_num = (uint32_t) le32toh (rsp->call_state);
-    qcdm_result_add_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_CALL_STATE, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_CALL_STATE, tmp_num);
 
     tmp_num = (uint32_t) le32toh (rsp->oper_mode);
-    qcdm_result_add_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_OPERATING_MODE, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_OPERATING_MODE, tmp_num);
 
     tmp_num = (uint32_t) le32toh (rsp->system_mode);
-    qcdm_result_add_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_SYSTEM_MODE, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_SYSTEM_MODE, tmp_num);
 
     tmp_num = (uint32_t) le32toh (rsp->mode_pref);
-    qcdm_result_add_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_MODE_PREF, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_MODE_PREF, tmp_num);
 
     tmp_num = (uint32_t) le32toh (rsp->band_pref);
-    qcdm_result_add_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_BAND_PREF, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_BAND_PREF, tmp_num);
 
-    qcdm_result_add_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_ROAM_PREF, roam_pref);
+    qcdm_result_set_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_ROAM_PREF, roam_pref);
 
     tmp_num = (uint32_t) le32toh (rsp->srv_domain_pref);
-    qcdm_result_add_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_SERVICE_DOMAIN_PREF, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_SERVICE_DOMAIN_PREF, tmp_num);
 
     tmp_num = (uint32_t) le32toh (rsp->acq_order_pref);
-    qcdm_result_add_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_ACQ_ORDER_PREF, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_ACQ_ORDER_PREF, tmp_num);
 
     tmp_num = (uint32_t) le32toh (rsp->hybrid_pref);
-    qcdm_result_add_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_HYBRID_PREF, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_HYBRID_PREF, tmp_num);
 
     tmp_num = (uint32_t) le32toh (rsp->network_sel_mode_pref);
-    qcdm_result_add_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_NETWORK_SELECTION_PREF, tmp_num);
+    qcdm_result_set_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_NETWORK_SELECTION_PREF, tmp_num);
 
     return result;
 }
@@ -1363,6 +1456,18 @@ qcdm_cmd_hdr_subsys_state_info_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const hdr_subsys_state_info_keys[QCDM_CMD_HDR_SUBSYS_STATE_INFO_N_FIELDS] = {
+    [QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_AT_STATE] = QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_AT_STATE,
+    [QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_SESSION_STATE] = QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_SESSION_STATE,
+    [QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_ALMP_STATE] = QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_ALMP_STATE,
+    [QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_INIT_STATE] = QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_INIT_STATE,
+    [QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_IDLE_STATE] = QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_IDLE_STATE,
+    [QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_CONNECTED_STATE] = QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_CONNECTED_STATE,
+    [QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_ROUTE_UPDATE_STATE] = QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_ROUTE_UPDATE_STATE,
+    [QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_OVERHEAD_MSG_STATE] = QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_OVERHEAD_MSG_STATE,
+    [QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_HDR_HYBRID_MODE] = QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_HDR_HYBRID_MODE,
+};
+
 QcdmResult *
 qcdm_cmd_hdr_subsys_state_info_result (const char *buf, size_t len, int *out_error)
 {
@@ -1374,17 +1479,17 @@ qcdm_cmd_hdr_subsys_state_info_result (const char *buf, size_t len, int *out_err
     if (!check_command (buf, len, DIAG_CMD_SUBSYS, sizeof (DMCmdSubsysHDRStateInfoRsp), out_error))
         return NULL;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (hdr_subsys_state_info_keys, QCDM_CMD_HDR_SUBSYS_STATE_INFO_N_FIELDS, 0);
 
-    qcdm_result_add_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_AT_STATE, rsp->at_state);
-    qcdm_result_add_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_SESSION_STATE, rsp->session_state);
-    qcdm_result_add_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_ALMP_STATE, rsp->almp_state);
-    qcdm_result_add_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_INIT_STATE, rsp->init_state);
-    qcdm_result_add_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_IDLE_STATE, rsp->idle_state);
-    qcdm_result_add_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_CONNECTED_STATE, rsp->connected_state);
-    qcdm_result_add_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_ROUTE_UPDATE_STATE, rsp->route_update_state);
-    qcdm_result_add_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_OVERHEAD_MSG_STATE, rsp->overhead_msg_state);
-    qcdm_result_add_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_HDR_HYBRID_MODE, rsp->hdr_hybrid_mode);
+    qcdm_result_set_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_AT_STATE, rsp->at_state);
+    qcdm_result_set_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_SESSION_STATE, rsp->session_state);
+    qcdm_result_set_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_ALMP_STATE, rsp->almp_state);
+    qcdm_result_set_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_INIT_STATE, rsp->init_state);
+    qcdm_result_set_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_IDLE_STATE, rsp->idle_state);
+    qcdm_result_set_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_CONNECTED_STATE, rsp->connected_state);
+    qcdm_result_set_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_ROUTE_UPDATE_STATE, rsp->route_update_state);
+    qcdm_result_set_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_OVERHEAD_MSG_STATE, rsp->overhead_msg_state);
+    qcdm_result_set_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_HDR_HYBRID_MODE, rsp->hdr_hybrid_mode);
 
     return result;
 }
@@ -1429,6 +1534,10 @@ qcdm_cmd_ext_logmask_new (char *buf,
     return dm_encapsulate_buffer (cmdbuf, total, sizeof (cmdbuf), buf, len);
 }
 
+static const char *const ext_logmask_keys[QCDM_CMD_EXT_LOGMASK_N_FIELDS] = {
+    [QCDM_CMD_EXT_LOGMASK_FIELD_MAX_ITEMS] = QCDM_CMD_EXT_LOGMASK_ITEM_MAX_ITEMS,
+};
+
 QcdmResult *
 qcdm_cmd_ext_logmask_result (const char *buf, size_t len, int *out_error)
 {
@@ -1471,10 +1580,10 @@ qcdm_cmd_ext_logmask_result (const char *buf, size_t len, int *out_error)
     if (!check_command (buf, len, DIAG_CMD_EXT_LOGMASK, minlen, out_error))
         return NULL;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (ext_logmask_keys, QCDM_CMD_EXT_LOGMASK_N_FIELDS, 0);
 
     if (minlen != 4)
-        qcdm_result_add_u32 (result, QCDM_CMD_EXT_LOGMASK_ITEM_MAX_ITEMS, maxlog);
+        qcdm_result_set_u32 (result, QCDM_CMD_EXT_LOGMASK_FIELD_MAX_ITEMS, maxlog);
 
     return result;
 }
@@ -1534,6 +1643,10 @@ qcdm_cmd_zte_subsys_status_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const zte_subsys_status_keys[QCDM_CMD_ZTE_SUBSYS_STATUS_N_FIELDS] = {
+    [QCDM_CMD_ZTE_SUBSYS_STATUS_FIELD_SIGNAL_INDICATOR] = QCDM_CMD_ZTE_SUBSYS_STATUS_ITEM_SIGNAL_INDICATOR,
+};
+
 QcdmResult *
 qcdm_cmd_zte_subsys_status_result (const char *buf, size_t len, int *out_error)
 {
@@ -1545,9 +1658,9 @@ qcdm_cmd_zte_subsys_status_result (const char *buf, size_t len, int *out_error)
     if (!check_command (buf, len, DIAG_CMD_SUBSYS, sizeof (DMCmdSubsysZteStatusRsp), out_error))
         return NULL;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (zte_subsys_status_keys, QCDM_CMD_ZTE_SUBSYS_STATUS_N_FIELDS, 0);
 
-    qcdm_result_add_u8 (result, QCDM_CMD_ZTE_SUBSYS_STATUS_ITEM_SIGNAL_INDICATOR, rsp->signal_ind);
+    qcdm_result_set_u8 (result, QCDM_CMD_ZTE_SUBSYS_STATUS_FIELD_SIGNAL_INDICATOR, rsp->signal_ind);
 
     return result;
 }
@@ -1590,6 +1703,14 @@ qcdm_cmd_nw_subsys_modem_snapshot_cdma_new (char *buf,
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const nw_subsys_modem_snapshot_cdma_keys[QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_N_FIELDS] = {
+    [QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_RSSI] = QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_RSSI,
+    [QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_PREV] = QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_PREV,
+    [QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_BAND_CLASS] = QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_BAND_CLASS,
+    [QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_ERI] = QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_ERI,
+    [QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_HDR_REV] = QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_HDR_REV,
+};
+
 QcdmResult *
 qcdm_cmd_nw_subsys_modem_snapshot_cdma_result (const char *buf, size_t len, int *out_error)
 {
@@ -1606,18 +1727,18 @@ qcdm_cmd_nw_subsys_modem_snapshot_cdma_result (const char *buf, size_t len, int
 
     /* FIXME: check response_code when we know what it means */
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (nw_subsys_modem_snapshot_cdma_keys, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_N_FIELDS, 0);
 
     num = le32toh (cdma->rssi);
-    qcdm_result_add_u32 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_RSSI, num);
+    qcdm_result_set_u32 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_RSSI, num);
 
     num8 = cdma_prev_to_qcdm (cdma->prev);
-    qcdm_result_add_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_PREV, num8);
+    qcdm_result_set_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_PREV, num8);
 
     num8 = cdma_band_class_to_qcdm (cdma->band_class);
-    qcdm_result_add_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_BAND_CLASS, num8);
+    qcdm_result_set_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_BAND_CLASS, num8);
 
-    qcdm_result_add_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_ERI, cdma->eri);
+    qcdm_result_set_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_ERI, cdma->eri);
 
     num8 = QCDM_HDR_REV_UNKNOWN;
     switch (cdma->hdr_rev) {
@@ -1630,7 +1751,7 @@ qcdm_cmd_nw_subsys_modem_snapshot_cdma_result (const char *buf, size_t len, int
     default:
         break;
     }
-    qcdm_result_add_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_HDR_REV, num8);
+    qcdm_result_set_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_HDR_REV, num8);
 
     return result;
 }
@@ -1671,6 +1792,16 @@ qcdm_cmd_nw_subsys_eri_new (char *buf,
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const nw_subsys_eri_keys[QCDM_CMD_NW_SUBSYS_ERI_N_FIELDS] = {
+    [QCDM_CMD_NW_SUBSYS_ERI_FIELD_ROAM] = QCDM_CMD_NW_SUBSYS_ERI_ITEM_ROAM,
+    [QCDM_CMD_NW_SUBSYS_ERI_FIELD_INDICATOR_ID] = QCDM_CMD_NW_SUBSYS_ERI_ITEM_INDICATOR_ID,
+    [QCDM_CMD_NW_SUBSYS_ERI_FIELD_ICON_ID] = QCDM_CMD_NW_SUBSYS_ERI_ITEM_ICON_ID,
+    [QCDM_CMD_NW_SUBSYS_ERI_FIELD_ICON_MODE] = QCDM_CMD_NW_SUBSYS_ERI_ITEM_ICON_MODE,
+    [QCDM_CMD_NW_SUBSYS_ERI_FIELD_CALL_PROMPT_ID] = QCDM_CMD_NW_SUBSYS_ERI_ITEM_CALL_PROMPT_ID,
+    [QCDM_CMD_NW_SUBSYS_ERI_FIELD_ALERT_ID] = QCDM_CMD_NW_SUBSYS_ERI_ITEM_ALERT_ID,
+    [QCDM_CMD_NW_SUBSYS_ERI_FIELD_TEXT] = QCDM_CMD_NW_SUBSYS_ERI_ITEM_TEXT,
+};
+
 QcdmResult *
 qcdm_cmd_nw_subsys_eri_result (const char *buf, size_t len, int *out_error)
 {
@@ -1685,21 +1816,21 @@ qcdm_cmd_nw_subsys_eri_result (const char *buf, size_t len, int *out_error)
 
     /* FIXME: check 'status' when we know what it means */
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (nw_subsys_eri_keys, QCDM_CMD_NW_SUBSYS_ERI_N_FIELDS, sizeof (str));
 
-    qcdm_result_add_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_ITEM_ROAM, rsp->roam);
-    qcdm_result_add_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_ITEM_INDICATOR_ID, rsp->indicator_id);
-    qcdm_result_add_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_ITEM_ICON_ID, rsp->icon_id);
-    qcdm_result_add_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_ITEM_ICON_MODE, rsp->icon_mode);
-    qcdm_result_add_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_ITEM_CALL_PROMPT_ID, rsp->call_prompt_id);
-    qcdm_result_add_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_ITEM_ALERT_ID, rsp->alert_id);
+    qcdm_result_set_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_FIELD_ROAM, rsp->roam);
+    qcdm_result_set_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_FIELD_INDICATOR_ID, rsp->indicator_id);
+    qcdm_result_set_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_FIELD_ICON_ID, rsp->icon_id);
+    qcdm_result_set_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_FIELD_ICON_MODE, rsp->icon_mode);
+    qcdm_result_set_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_FIELD_CALL_PROMPT_ID, rsp->call_prompt_id);
+    qcdm_result_set_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_FIELD_ALERT_ID, rsp->alert_id);
 
     qcdm_warn_if_fail (rsp->text_len < sizeof (str));
     if (rsp->text_len < sizeof (str)) {
         qcdm_assert (sizeof (str) > sizeof (rsp->text));
         memcpy (str, rsp->text, sizeof (rsp->text));
         str[rsp->text_len] = '\0';
-        qcdm_result_add_string (result, QCDM_CMD_NW_SUBSYS_ERI_ITEM_TEXT, str);
+        qcdm_result_set_string (result, QCDM_CMD_NW_SUBSYS_ERI_FIELD_TEXT, str);
     }
 
     return result;
@@ -1834,6 +1965,12 @@ check_log_config_respose (const char *buf, size_t len, uint32_t op)
 
 #define LOG_CODE_SET(mask, code)  (mask[code / 8] & (1 << (code % 8)))
 
+static const char *const log_config_mask_keys[QCDM_CMD_LOG_CONFIG_MASK_N_FIELDS] = {
+    [QCDM_CMD_LOG_CONFIG_MASK_FIELD_EQUIP_ID] = QCDM_CMD_LOG_CONFIG_MASK_ITEM_EQUIP_ID,
+    [QCDM_CMD_LOG_CONFIG_MASK_FIELD_NUM_ITEMS] = QCDM_CMD_LOG_CONFIG_MASK_ITEM_NUM_ITEMS,
+    [QCDM_CMD_LOG_CONFIG_MASK_FIELD_ITEMS] = QCDM_CMD_LOG_CONFIG_MASK_ITEM_ITEMS,
+};
+
 static QcdmResult *
 log_config_get_set_result (const char *buf, size_t len, uint32_t op, int *out_error)
 {
@@ -1841,7 +1978,9 @@ log_config_get_set_result (const char *buf, size_t len, uint32_t op, int *out_er
     DMCmdLogConfigRsp *rsp = (DMCmdLogConfigRsp *) buf;
     int err;
     uint32_t num_items;
+    uint32_t num_result_items = 0;
     uint32_t equipid;
+    uint32_t i;
 
     qcdm_return_val_if_fail (buf != NULL, NULL);
 
@@ -1852,35 +1991,35 @@ log_config_get_set_result (const char *buf, size_t len, uint32_t op, int *out_er
         return NULL;
     }
 
-    result = qcdm_result_new ();
-
     equipid = le32toh (rsp->equipid);
-    qcdm_result_add_u32 (result, QCDM_CMD_LOG_CONFIG_MASK_ITEM_EQUIP_ID, equipid);
-
     num_items = le32toh (rsp->u.get_set_items.num_items);
-    qcdm_result_add_u32 (result, QCDM_CMD_LOG_CONFIG_MASK_ITEM_NUM_ITEMS, num_items);
 
-    if (num_items > 0) {
-        uint32_t i, num_result_items = 0, count = 0;
+    /* First pass to find out how many are actually enabled */
+    for (i = 0; i < num_items; i++) {
+        /* Check if the bit corresponding to this log item is set */
+        if (LOG_CODE_SET (rsp->u.get_set_items.mask, i))
+            num_result_items++;
+    }
+
+    result = qcdm_result_new_with_fields (log_config_mask_keys,
+                                          QCDM_CMD_LOG_CONFIG_MASK_N_FIELDS,
+                                          sizeof (uint16_t) * num_result_items);
+
+    qcdm_result_set_u32 (result, QCDM_CMD_LOG_CONFIG_MASK_FIELD_EQUIP_ID, equipid);
+    qcdm_result_set_u32 (result, QCDM_CMD_LOG_CONFIG_MASK_FIELD_NUM_ITEMS, num_items);
+
+    if (num_result_items > 0) {
+        uint32_t count = 0;
         uint16_t *items;
 
-        /* First pass to find out how many are actually enabled */
+        items = malloc (sizeof (*items) * num_result_items);
         for (i = 0; i < num_items; i++) {
-            /* Check if the bit corresponding to this log item is set */
             if (LOG_CODE_SET (rsp->u.get_set_items.mask, i))
-                num_result_items++;
+                items[count++] = (equipid << 12) | (i & 0x0FFF);
         }
 
-        if (num_result_items) {
-            items = malloc (sizeof (*items) * num_result_items);
-            for (i = 0; i < num_items; i++) {
-                if (LOG_CODE_SET (rsp->u.get_set_items.mask, i))
-                    items[count++] = (equipid << 12) | (i & 0x0FFF);
-            }
-
-            qcdm_result_add_u16_array (result, QCDM_CMD_LOG_CONFIG_MASK_ITEM_ITEMS, items, count);
-            free (items);
-        }
+        qcdm_result_set_u16_array (result, QCDM_CMD_LOG_CONFIG_MASK_FIELD_ITEMS, items, count);
+        free (items);
     }
 
     return result;
@@ -1922,14 +2061,14 @@ qcmd_cmd_log_config_mask_result_code_set (QcdmResult *result,
 
     qcdm_return_val_if_fail (result != NULL, FALSE);
 
-    if (qcdm_result_get_u32 (result, QCDM_CMD_LOG_CONFIG_MASK_ITEM_EQUIP_ID, &tmp) != 0)
+    if (qcdm_result_get_field_u32 (result, QCDM_CMD_LOG_CONFIG_MASK_FIELD_EQUIP_ID, &tmp) != 0)
         return FALSE;
     qcdm_return_val_if_fail (equipid != tmp, FALSE);
 
-    if (qcdm_result_get_u16_array (result,
-                                   QCDM_CMD_LOG_CONFIG_MASK_ITEM_ITEMS,
-                                   &items,
-                                   &len)) {
+    if (qcdm_result_get_field_u16_array (result,
+                                         QCDM_CMD_LOG_CONFIG_MASK_FIELD_ITEMS,
+                                         &items,
+                                         &len)) {
         for (i = 0; i < len; i++) {
             if ((items[i] & 0x0FFF) == (log_code & 0x0FFF))
                 return TRUE;
@@ -1992,6 +2131,12 @@ qcdm_cmd_wcdma_subsys_state_info_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const wcdma_subsys_state_info_keys[QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_N_FIELDS] = {
+    [QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_FIELD_IMEI] = QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_ITEM_IMEI,
+    [QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_FIELD_IMSI] = QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_ITEM_IMSI,
+    [QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_FIELD_L1_STATE] = QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_ITEM_L1_STATE,
+};
+
 QcdmResult *
 qcdm_cmd_wcdma_subsys_state_info_result (const char *buf, size_t len, int *out_error)
 {
@@ -2004,17 +2149,17 @@ qcdm_cmd_wcdma_subsys_state_info_result (const char *buf, size_t len, int *out_e
     if (!check_command (buf, len, DIAG_CMD_SUBSYS, sizeof (DMCmdSubsysWcdmaStateInfoRsp), out_error))
         return NULL;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (wcdma_subsys_state_info_keys, QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_N_FIELDS, 2 * sizeof (imxi));
 
-    qcdm_result_add_u8 (result, QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_ITEM_L1_STATE, rsp->l1_state);
+    qcdm_result_set_u8 (result, QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_FIELD_L1_STATE, rsp->l1_state);
 
     memset (imxi, 0, sizeof (imxi));
     if (imxi_bcd_to_string (rsp->imei, rsp->imei_len, imxi, sizeof (imxi)))
-        qcdm_result_add_string (result, QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_ITEM_IMEI, imxi);
+        qcdm_result_set_string (result, QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_FIELD_IMEI, imxi);
 
     memset (imxi, 0, sizeof (imxi));
     if (imxi_bcd_to_string (rsp->imsi, rsp->imsi_len, imxi, sizeof (imxi)))
-        qcdm_result_add_string (result, QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_ITEM_IMSI, imxi);
+        qcdm_result_set_string (result, QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_FIELD_IMSI, imxi);
 
     return result;
 }
@@ -2038,6 +2183,18 @@ qcdm_cmd_gsm_subsys_state_info_new (char *buf, size_t len)
     return dm_encapsulate_buffer (cmdbuf, sizeof (*cmd), sizeof (cmdbuf), buf, len);
 }
 
+static const char *const gsm_subsys_state_info_keys[QCDM_CMD_GSM_SUBSYS_STATE_INFO_N_FIELDS] = {
+    [QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_IMEI] = QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_IMEI,
+    [QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_IMSI] = QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_IMSI,
+    [QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_LAI_MCC] = QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_LAI_MCC,
+    [QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_LAI_MNC] = QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_LAI_MNC,
+    [QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_LAI_LAC] = QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_LAI_LAC,
+    [QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CELLID] = QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CELLID,
+    [QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_CALL_STATE] = QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CM_CALL_STATE,
+    [QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_OP_MODE] = QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CM_OP_MODE,
+    [QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_SYS_MODE] = QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CM_SYS_MODE,
+};
+
 QcdmResult *
 qcdm_cmd_gsm_subsys_state_info_result (const char *buf, size_t len, int *out_error)
 {
@@ -2052,19 +2209,19 @@ qcdm_cmd_gsm_subsys_state_info_result (const char *buf, size_t len, int *out_err
     if (!check_command (buf, len, DIAG_CMD_SUBSYS, sizeof (DMCmdSubsysGsmStateInfoRsp), out_error))
         return NULL;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (gsm_subsys_state_info_keys, QCDM_CMD_GSM_SUBSYS_STATE_INFO_N_FIELDS, 2 * sizeof (imxi));
 
     memset (imxi, 0, sizeof (imxi));
     if (imxi_bcd_to_string (rsp->imei, rsp->imei_len, imxi, sizeof (imxi)))
-        qcdm_result_add_string (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_IMEI, imxi);
+        qcdm_result_set_string (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_IMEI, imxi);
 
     memset (imxi, 0, sizeof (imxi));
     if (imxi_bcd_to_string (rsp->imsi, rsp->imsi_len, imxi, sizeof (imxi)))
-        qcdm_result_add_string (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_IMSI, imxi);
+        qcdm_result_set_string (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_IMSI, imxi);
 
-    qcdm_result_add_u8 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CM_CALL_STATE, rsp->cm_call_state);
-    qcdm_result_add_u8 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CM_OP_MODE, rsp->cm_opmode);
-    qcdm_result_add_u8 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CM_SYS_MODE, rsp->cm_sysmode);
+    qcdm_result_set_u8 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_CALL_STATE, rsp->cm_call_state);
+    qcdm_result_set_u8 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_OP_MODE, rsp->cm_opmode);
+    qcdm_result_set_u8 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_SYS_MODE, rsp->cm_sysmode);
 
     /* MCC/MNC, LAC, and CI don't seem to be valid when the modem is not in GSM mode */
     if (   rsp->cm_sysmode == QCDM_CMD_CM_SUBSYS_STATE_INFO_SYSTEM_MODE_GSM
@@ -2073,19 +2230,19 @@ qcdm_cmd_gsm_subsys_state_info_result (const char *buf, size_t len, int *out_err
         mcc = (rsp->lai[0] & 0xF) * 100;
         mcc += ((rsp->lai[0] >> 4) & 0xF) * 10;
         mcc += rsp->lai[1] & 0xF;
-        qcdm_result_add_u32 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_LAI_MCC, mcc);
+        qcdm_result_set_u32 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_LAI_MCC, mcc);
 
         mnc = (rsp->lai[2] & 0XF) * 100;
         mnc += ((rsp->lai[2] >> 4) & 0xF) * 10;
         mnc3 = (rsp->lai[1] >> 4) & 0xF;
         if (mnc3 != 0xF)
             mnc += mnc3;
-        qcdm_result_add_u32 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_LAI_MNC, mnc);
+        qcdm_result_set_u32 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_LAI_MNC, mnc);
 
-        qcdm_result_add_u32 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_LAI_LAC,
+        qcdm_result_set_u32 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_LAI_LAC,
                              rsp->lai[4] << 8 | rsp->lai[3]);
 
-        qcdm_result_add_u32 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CELLID, le16toh (rsp->cellid));
+        qcdm_result_set_u32 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CELLID, le16toh (rsp->cellid));
     }
 
     return result;
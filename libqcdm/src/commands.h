@@ -87,6 +87,16 @@ enum {
 #define QCDM_CMD_VERSION_INFO_ITEM_RELEASE_TIME "release-time"
 #define QCDM_CMD_VERSION_INFO_ITEM_MODEL "model"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_VERSION_INFO_FIELD_COMP_DATE = 0,
+    QCDM_CMD_VERSION_INFO_FIELD_COMP_TIME,
+    QCDM_CMD_VERSION_INFO_FIELD_RELEASE_DATE,
+    QCDM_CMD_VERSION_INFO_FIELD_RELEASE_TIME,
+    QCDM_CMD_VERSION_INFO_FIELD_MODEL,
+    QCDM_CMD_VERSION_INFO_N_FIELDS
+};
+
 size_t      qcdm_cmd_version_info_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_version_info_result (const char *buf,
@@ -97,6 +107,12 @@ QcdmResult *qcdm_cmd_version_info_result (const char *buf,
 
 #define QCDM_CMD_ESN_ITEM_ESN "esn"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_ESN_FIELD_ESN = 0,
+    QCDM_CMD_ESN_N_FIELDS
+};
+
 size_t      qcdm_cmd_esn_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_esn_result (const char *buf,
@@ -148,6 +164,20 @@ enum {
 #define QCDM_CMD_CDMA_STATUS_ITEM_SID             "sid"
 #define QCDM_CMD_CDMA_STATUS_ITEM_NID             "nid"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_CDMA_STATUS_FIELD_ESN = 0,
+    QCDM_CMD_CDMA_STATUS_FIELD_RF_MODE,
+    QCDM_CMD_CDMA_STATUS_FIELD_RX_STATE,
+    QCDM_CMD_CDMA_STATUS_FIELD_ENTRY_REASON,
+    QCDM_CMD_CDMA_STATUS_FIELD_CURRENT_CHANNEL,
+    QCDM_CMD_CDMA_STATUS_FIELD_CODE_CHANNEL,
+    QCDM_CMD_CDMA_STATUS_FIELD_PILOT_BASE,
+    QCDM_CMD_CDMA_STATUS_FIELD_SID,
+    QCDM_CMD_CDMA_STATUS_FIELD_NID,
+    QCDM_CMD_CDMA_STATUS_N_FIELDS
+};
+
 size_t      qcdm_cmd_cdma_status_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_cdma_status_result (const char *buf,
@@ -164,6 +194,14 @@ QcdmResult *qcdm_cmd_cdma_status_result (const char *buf,
 #define QCDM_CMD_SW_VERSION_ITEM_COMP_DATE "comp-date"
 #define QCDM_CMD_SW_VERSION_ITEM_COMP_TIME "comp-time"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_SW_VERSION_FIELD_VERSION = 0,
+    QCDM_CMD_SW_VERSION_FIELD_COMP_DATE,
+    QCDM_CMD_SW_VERSION_FIELD_COMP_TIME,
+    QCDM_CMD_SW_VERSION_N_FIELDS
+};
+
 size_t      qcdm_cmd_sw_version_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_sw_version_result (const char *buf,
@@ -214,6 +252,18 @@ enum {
 /* The protocol revision currently in-use.  One of QCDM_STATUS_SNAPSHOT_STATE_* */
 #define QCDM_CMD_STATUS_SNAPSHOT_ITEM_STATE              "state"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_STATUS_SNAPSHOT_FIELD_ESN = 0,
+    QCDM_CMD_STATUS_SNAPSHOT_FIELD_HOME_MCC,
+    QCDM_CMD_STATUS_SNAPSHOT_FIELD_BAND_CLASS,
+    QCDM_CMD_STATUS_SNAPSHOT_FIELD_BASE_STATION_PREV,
+    QCDM_CMD_STATUS_SNAPSHOT_FIELD_MOBILE_PREV,
+    QCDM_CMD_STATUS_SNAPSHOT_FIELD_PREV_IN_USE,
+    QCDM_CMD_STATUS_SNAPSHOT_FIELD_STATE,
+    QCDM_CMD_STATUS_SNAPSHOT_N_FIELDS
+};
+
 size_t      qcdm_cmd_status_snapshot_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_status_snapshot_result (const char *buf,
@@ -251,6 +301,13 @@ qcdmbool    qcdm_cmd_pilot_sets_result_get_pilot (QcdmResult *result,
 #define QCDM_CMD_NV_GET_MDN_ITEM_PROFILE "profile"
 #define QCDM_CMD_NV_GET_MDN_ITEM_MDN "mdn"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_NV_GET_MDN_FIELD_PROFILE = 0,
+    QCDM_CMD_NV_GET_MDN_FIELD_MDN,
+    QCDM_CMD_NV_GET_MDN_N_FIELDS
+};
+
 size_t      qcdm_cmd_nv_get_mdn_new    (char *buf, size_t len, uint8_t profile);
 
 QcdmResult *qcdm_cmd_nv_get_mdn_result (const char *buf,
@@ -269,6 +326,13 @@ enum {
 #define QCDM_CMD_NV_GET_ROAM_PREF_ITEM_PROFILE   "profile"
 #define QCDM_CMD_NV_GET_ROAM_PREF_ITEM_ROAM_PREF "roam-pref"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_NV_GET_ROAM_PREF_FIELD_PROFILE = 0,
+    QCDM_CMD_NV_GET_ROAM_PREF_FIELD_ROAM_PREF,
+    QCDM_CMD_NV_GET_ROAM_PREF_N_FIELDS
+};
+
 size_t      qcdm_cmd_nv_get_roam_pref_new    (char *buf,
                                               size_t len,
                                               uint8_t profile);
@@ -309,6 +373,13 @@ enum {
 #define QCDM_CMD_NV_GET_MODE_PREF_ITEM_PROFILE   "profile"
 #define QCDM_CMD_NV_GET_MODE_PREF_ITEM_MODE_PREF "mode-pref"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_NV_GET_MODE_PREF_FIELD_PROFILE = 0,
+    QCDM_CMD_NV_GET_MODE_PREF_FIELD_MODE_PREF,
+    QCDM_CMD_NV_GET_MODE_PREF_N_FIELDS
+};
+
 size_t      qcdm_cmd_nv_get_mode_pref_new    (char *buf,
                                               size_t len,
                                               uint8_t profile);
@@ -335,6 +406,12 @@ enum {
 
 #define QCDM_CMD_NV_GET_HYBRID_PREF_ITEM_HYBRID_PREF "hybrid-pref"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_NV_GET_HYBRID_PREF_FIELD_HYBRID_PREF = 0,
+    QCDM_CMD_NV_GET_HYBRID_PREF_N_FIELDS
+};
+
 size_t      qcdm_cmd_nv_get_hybrid_pref_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_nv_get_hybrid_pref_result (const char *buf,
@@ -358,6 +435,12 @@ enum {
 
 #define QCDM_CMD_NV_GET_IPV6_ENABLED_ITEM_ENABLED "ipv6-enabled"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_NV_GET_IPV6_ENABLED_FIELD_ENABLED = 0,
+    QCDM_CMD_NV_GET_IPV6_ENABLED_N_FIELDS
+};
+
 size_t      qcdm_cmd_nv_get_ipv6_enabled_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_nv_get_ipv6_enabled_result (const char *buf,
@@ -383,6 +466,12 @@ enum {
 
 #define QCDM_CMD_NV_GET_HDR_REV_PREF_ITEM_REV_PREF "rev-pref"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_NV_GET_HDR_REV_PREF_FIELD_REV_PREF = 0,
+    QCDM_CMD_NV_GET_HDR_REV_PREF_N_FIELDS
+};
+
 size_t      qcdm_cmd_nv_get_hdr_rev_pref_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_nv_get_hdr_rev_pref_result (const char *buf,
@@ -472,6 +561,21 @@ enum {
 #define QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_HYBRID_PREF            "hybrid-pref"
 #define QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_NETWORK_SELECTION_PREF "network-selection-pref"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_CALL_STATE = 0,
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_OPERATING_MODE,
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_SYSTEM_MODE,
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_MODE_PREF,
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_BAND_PREF,
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_ROAM_PREF,
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_SERVICE_DOMAIN_PREF,
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_ACQ_ORDER_PREF,
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_HYBRID_PREF,
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_NETWORK_SELECTION_PREF,
+    QCDM_CMD_CM_SUBSYS_STATE_INFO_N_FIELDS
+};
+
 size_t      qcdm_cmd_cm_subsys_state_info_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_cm_subsys_state_info_result (const char *buf,
@@ -555,6 +659,20 @@ enum {
 #define QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_OVERHEAD_MSG_STATE "overhead-msg-state"
 #define QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_HDR_HYBRID_MODE    "hdr-hybrid-mode"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_AT_STATE = 0,
+    QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_SESSION_STATE,
+    QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_ALMP_STATE,
+    QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_INIT_STATE,
+    QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_IDLE_STATE,
+    QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_CONNECTED_STATE,
+    QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_ROUTE_UPDATE_STATE,
+    QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_OVERHEAD_MSG_STATE,
+    QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_HDR_HYBRID_MODE,
+    QCDM_CMD_HDR_SUBSYS_STATE_INFO_N_FIELDS
+};
+
 size_t      qcdm_cmd_hdr_subsys_state_info_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_hdr_subsys_state_info_result (const char *buf,
@@ -566,6 +684,12 @@ QcdmResult *qcdm_cmd_hdr_subsys_state_info_result (const char *buf,
 /* Max # of log items this device supports */
 #define QCDM_CMD_EXT_LOGMASK_ITEM_MAX_ITEMS   "max-items"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_EXT_LOGMASK_FIELD_MAX_ITEMS = 0,
+    QCDM_CMD_EXT_LOGMASK_N_FIELDS
+};
+
 size_t      qcdm_cmd_ext_logmask_new    (char *buf,
                                          size_t len,
                                          uint32_t items[], /* terminated by 0 */
@@ -606,6 +730,14 @@ size_t qcdm_cmd_log_config_set_mask_new (char *buf,
 
 #define QCDM_CMD_LOG_CONFIG_MASK_ITEM_ITEMS     "items"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_LOG_CONFIG_MASK_FIELD_EQUIP_ID = 0,
+    QCDM_CMD_LOG_CONFIG_MASK_FIELD_NUM_ITEMS,
+    QCDM_CMD_LOG_CONFIG_MASK_FIELD_ITEMS,
+    QCDM_CMD_LOG_CONFIG_MASK_N_FIELDS
+};
+
 QcdmResult *qcdm_cmd_log_config_get_mask_result (const char *buf,
                                                  size_t len,
                                                  int *out_error);
@@ -622,6 +754,12 @@ qcdmbool    qcmd_cmd_log_config_mask_result_code_set (QcdmResult *result,
 
 #define QCDM_CMD_ZTE_SUBSYS_STATUS_ITEM_SIGNAL_INDICATOR    "signal-indicator"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_ZTE_SUBSYS_STATUS_FIELD_SIGNAL_INDICATOR = 0,
+    QCDM_CMD_ZTE_SUBSYS_STATUS_N_FIELDS
+};
+
 size_t      qcdm_cmd_zte_subsys_status_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_zte_subsys_status_result (const char *buf,
@@ -643,6 +781,16 @@ QcdmResult *qcdm_cmd_zte_subsys_status_result (const char *buf,
 /* One of QCDM_HDR_REV_* */
 #define QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_HDR_REV    "hdr-rev"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_RSSI = 0,
+    QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_PREV,
+    QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_BAND_CLASS,
+    QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_ERI,
+    QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_HDR_REV,
+    QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_N_FIELDS
+};
+
 enum {
     QCDM_NW_CHIPSET_UNKNOWN = 0,
     QCDM_NW_CHIPSET_6500 = 1,
@@ -675,6 +823,18 @@ QcdmResult *qcdm_cmd_nw_subsys_modem_snapshot_cdma_result (const char *buf,
 
 #define QCDM_CMD_NW_SUBSYS_ERI_ITEM_TEXT           "text"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_NW_SUBSYS_ERI_FIELD_ROAM = 0,
+    QCDM_CMD_NW_SUBSYS_ERI_FIELD_INDICATOR_ID,
+    QCDM_CMD_NW_SUBSYS_ERI_FIELD_ICON_ID,
+    QCDM_CMD_NW_SUBSYS_ERI_FIELD_ICON_MODE,
+    QCDM_CMD_NW_SUBSYS_ERI_FIELD_CALL_PROMPT_ID,
+    QCDM_CMD_NW_SUBSYS_ERI_FIELD_ALERT_ID,
+    QCDM_CMD_NW_SUBSYS_ERI_FIELD_TEXT,
+    QCDM_CMD_NW_SUBSYS_ERI_N_FIELDS
+};
+
 size_t      qcdm_cmd_nw_subsys_eri_new    (char *buf,
                                            size_t len,
                                            uint8_t chipset);
@@ -711,6 +871,14 @@ enum {
 /* One of QCDM_WCDMA_L1_STATE_* */
 #define QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_ITEM_L1_STATE "l1-state"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_FIELD_IMEI = 0,
+    QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_FIELD_IMSI,
+    QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_FIELD_L1_STATE,
+    QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_N_FIELDS
+};
+
 size_t      qcdm_cmd_wcdma_subsys_state_info_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_wcdma_subsys_state_info_result (const char *buf,
@@ -740,6 +908,20 @@ QcdmResult *qcdm_cmd_wcdma_subsys_state_info_result (const char *buf,
 /* One of QCDM_CMD_CM_SUBSYS_STATE_INFO_SYSTEM_MODE_* */
 #define QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CM_SYS_MODE    "cm-sys-mode"
 
+/* Fields of the result, for the qcdm_result_get_field_*() getters */
+enum {
+    QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_IMEI = 0,
+    QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_IMSI,
+    QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_LAI_MCC,
+    QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_LAI_MNC,
+    QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_LAI_LAC,
+    QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CELLID,
+    QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_CALL_STATE,
+    QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_OP_MODE,
+    QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_SYS_MODE,
+    QCDM_CMD_GSM_SUBSYS_STATE_INFO_N_FIELDS
+};
+
 size_t      qcdm_cmd_gsm_subsys_state_info_new    (char *buf, size_t len);
 
 QcdmResult *qcdm_cmd_gsm_subsys_state_info_result (const char *buf,
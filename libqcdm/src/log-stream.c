@@ -0,0 +1,284 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <endian.h>
+
+#include "log-stream.h"
+#include "errors.h"
+#include "dm-commands.h"
+
+#define N_EQUIP_IDS 16
+#define N_ITEMS     4096
+
+typedef struct {
+    QcdmLogItemFunc func;
+    void *user_data;
+} Handler;
+
+struct QcdmLogStream {
+    /* Handlers indexed by equipment ID and item, each equipment ID table
+     * allocated when its first handler is set */
+    Handler *handlers[N_EQUIP_IDS];
+
+    /* Decapsulated packet being dispatched */
+    char *packet;
+    /* Incomplete frame kept between feeds; both buffers sized for a
+     * maximum length packet with every byte escaped */
+    char *pending;
+    size_t buf_size;
+    size_t pending_len;
+    /* Skipping the rest of a frame which didn't fit in 'pending' */
+    qcdmbool discarding;
+
+    QcdmLogStreamStats stats;
+};
+
+/**********************************************************************/
+
+QcdmLogStream *
+qcdm_log_stream_new (size_t max_packet_len)
+{
+    QcdmLogStream *stream;
+
+    qcdm_return_val_if_fail (max_packet_len > 0, NULL);
+
+    stream = calloc (1, sizeof (QcdmLogStream));
+    if (!stream)
+        return NULL;
+
+    /* Packet and CRC, all escaped, and the trailing control char */
+    stream->buf_size = (max_packet_len + 2) * 2 + 1;
+    stream->packet = malloc (stream->buf_size);
+    stream->pending = malloc (stream->buf_size);
+    if (!stream->packet || !stream->pending) {
+        qcdm_log_stream_free (stream);
+        return NULL;
+    }
+    return stream;
+}
+
+void
+qcdm_log_stream_free (QcdmLogStream *stream)
+{
+    unsigned int i;
+
+    qcdm_return_if_fail (stream != NULL);
+
+    for (i = 0; i < N_EQUIP_IDS; i++)
+        free (stream->handlers[i]);
+    free (stream->packet);
+    free (stream->pending);
+    free (stream);
+}
+
+/**********************************************************************/
+
+int
+qcdm_log_stream_set_handler (QcdmLogStream *stream,
+                             uint16_t log_code,
+                             QcdmLogItemFunc func,
+                             void *user_data)
+{
+    Handler **table;
+    Handler *handler;
+
+    qcdm_return_val_if_fail (stream != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (log_code > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
+
+    table = &stream->handlers[QCDM_LOG_CODE_EQUIP_ID (log_code)];
+    if (*table == NULL) {
+        if (func == NULL)
+            return 0;
+        *table = calloc (N_ITEMS, sizeof (Handler));
+        if (*table == NULL)
+            return -QCDM_ERROR_INVALID_ARGUMENTS;
+    }
+
+    handler = &(*table)[QCDM_LOG_CODE_ITEM (log_code)];
+    handler->func = func;
+    handler->user_data = func ? user_data : NULL;
+    return 0;
+}
+
+size_t
+qcdm_log_stream_get_codes (QcdmLogStream *stream,
+                           uint8_t equip_id,
+                           uint16_t *codes,
+                           size_t max_codes)
+{
+    const Handler *table;
+    size_t n = 0;
+    unsigned int i;
+
+    qcdm_return_val_if_fail (stream != NULL, 0);
+    qcdm_return_val_if_fail (equip_id < N_EQUIP_IDS, 0);
+    qcdm_return_val_if_fail (codes != NULL, 0);
+    qcdm_return_val_if_fail (max_codes > 0, 0);
+
+    table = stream->handlers[equip_id];
+    for (i = 0; table && i < N_ITEMS && n + 1 < max_codes; i++) {
+        if (table[i].func)
+            codes[n++] = (equip_id << 12) | i;
+    }
+    codes[n] = 0;
+    return n;
+}
+
+/**********************************************************************/
+
+qcdmbool
+qcdm_log_stream_dispatch (QcdmLogStream *stream,
+                          const char *packet,
+                          size_t len)
+{
+    const DMCmdLog *log_cmd = (const DMCmdLog *) packet;
+    const Handler *table;
+    uint16_t log_code;
+
+    qcdm_return_val_if_fail (stream != NULL, FALSE);
+    qcdm_return_val_if_fail (packet != NULL, FALSE);
+
+    stream->stats.n_frames++;
+
+    if (len == 0 || (uint8_t) packet[0] != DIAG_CMD_LOG) {
+        stream->stats.n_other++;
+        return FALSE;
+    }
+
+    if (len < sizeof (DMCmdLog)) {
+        stream->stats.n_invalid++;
+        return TRUE;
+    }
+
+    log_code = le16toh (log_cmd->log_code);
+    table = stream->handlers[QCDM_LOG_CODE_EQUIP_ID (log_code)];
+    if (!table || !table[QCDM_LOG_CODE_ITEM (log_code)].func) {
+        stream->stats.n_unhandled++;
+        return TRUE;
+    }
+
+    stream->stats.n_items++;
+    table[QCDM_LOG_CODE_ITEM (log_code)].func (log_code,
+                                               packet,
+                                               len,
+                                               table[QCDM_LOG_CODE_ITEM (log_code)].user_data);
+    return TRUE;
+}
+
+static void
+frame_cb (const char *packet, size_t len, void *user_data)
+{
+    qcdm_log_stream_dispatch ((QcdmLogStream *) user_data, packet, len);
+}
+
+/* Returns the amount of data used, up to the last control char */
+static size_t
+decapsulate (QcdmLogStream *stream, const char *buf, size_t len)
+{
+    size_t n_invalid = 0;
+    size_t used;
+
+    used = dm_decapsulate_frames (buf, len,
+                                  stream->packet, stream->buf_size,
+                                  frame_cb, stream,
+                                  &n_invalid);
+    stream->stats.n_invalid += n_invalid;
+    return used;
+}
+
+/* Returns FALSE if the data doesn't fit, in which case both the data and
+ * whatever was pending are dropped */
+static qcdmbool
+append_pending (QcdmLogStream *stream, const char *buf, size_t len)
+{
+    if (stream->pending_len + len > stream->buf_size) {
+        stream->stats.n_dropped_bytes += stream->pending_len + len;
+        stream->pending_len = 0;
+        return FALSE;
+    }
+
+    memcpy (stream->pending + stream->pending_len, buf, len);
+    stream->pending_len += len;
+    return TRUE;
+}
+
+void
+qcdm_log_stream_feed (QcdmLogStream *stream,
+                      const char *buf,
+                      size_t len)
+{
+    const char *control;
+    size_t used;
+
+    qcdm_return_if_fail (stream != NULL);
+    qcdm_return_if_fail (buf != NULL || len == 0);
+
+    /* Rest of a frame already known not to fit */
+    if (stream->discarding) {
+        control = memchr (buf, DIAG_CONTROL_CHAR, len);
+        used = control ? (size_t) (control + 1 - buf) : len;
+        stream->stats.n_dropped_bytes += used;
+        if (!control)
+            return;
+        stream->discarding = FALSE;
+        buf += used;
+        len -= used;
+    }
+
+    /* Complete the pending frame, if any */
+    if (stream->pending_len > 0) {
+        control = memchr (buf, DIAG_CONTROL_CHAR, len);
+        if (!control) {
+            if (!append_pending (stream, buf, len))
+                stream->discarding = TRUE;
+            return;
+        }
+
+        used = control + 1 - buf;
+        if (append_pending (stream, buf, used)) {
+            decapsulate (stream, stream->pending, stream->pending_len);
+            stream->pending_len = 0;
+        }
+        buf += used;
+        len -= used;
+    }
+
+    /* Complete frames are dispatched straight from the input */
+    used = decapsulate (stream, buf, len);
+    if (used < len && !append_pending (stream, buf + used, len - used))
+        stream->discarding = TRUE;
+}
+
+void
+qcdm_log_stream_flush (QcdmLogStream *stream)
+{
+    qcdm_return_if_fail (stream != NULL);
+
+    stream->stats.n_dropped_bytes += stream->pending_len;
+    stream->pending_len = 0;
+    stream->discarding = FALSE;
+}
+
+void
+qcdm_log_stream_get_stats (QcdmLogStream *stream,
+                           QcdmLogStreamStats *out_stats)
+{
+    qcdm_return_if_fail (stream != NULL);
+    qcdm_return_if_fail (out_stats != NULL);
+
+    *out_stats = stream->stats;
+}
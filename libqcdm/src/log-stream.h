@@ -0,0 +1,98 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBQCDM_LOG_STREAM_H
+#define LIBQCDM_LOG_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "utils.h"
+
+/* Log codes are made of a 4-bit equipment ID and a 12-bit item ID */
+#define QCDM_LOG_CODE_EQUIP_ID(code) (((code) >> 12) & 0x0F)
+#define QCDM_LOG_CODE_ITEM(code)     ((code) & 0x0FFF)
+
+/* Largest DIAG packet handled, before escaping */
+#define QCDM_LOG_STREAM_DEFAULT_MAX_PACKET_LEN 2048
+
+typedef struct QcdmLogStream QcdmLogStream;
+
+/* Called with the whole DIAG log packet (i.e. DIAG_CMD_LOG header included,
+ * CRC removed), which is only valid during the call.
+ */
+typedef void (*QcdmLogItemFunc) (uint16_t log_code,
+                                 const char *packet,
+                                 size_t len,
+                                 void *user_data);
+
+typedef struct {
+    /* Valid frames found */
+    size_t n_frames;
+    /* Log items given to a handler */
+    size_t n_items;
+    /* Log items without a handler */
+    size_t n_unhandled;
+    /* Valid frames which aren't log items, e.g. command responses */
+    size_t n_other;
+    /* Frames failing to unescape or the CRC check, or too short */
+    size_t n_invalid;
+    /* Bytes discarded because an incomplete frame didn't fit in the buffer */
+    size_t n_dropped_bytes;
+} QcdmLogStreamStats;
+
+/* 'max_packet_len' bounds both the packets given to handlers and the
+ * incomplete data kept between qcdm_log_stream_feed() calls.
+ */
+QcdmLogStream *qcdm_log_stream_new  (size_t max_packet_len);
+
+void           qcdm_log_stream_free (QcdmLogStream *stream);
+
+/* Replaces any existing handler of 'log_code'; a NULL 'func' removes it */
+int      qcdm_log_stream_set_handler (QcdmLogStream *stream,
+                                      uint16_t log_code,
+                                      QcdmLogItemFunc func,
+                                      void *user_data);
+
+/* Fills 'codes' with the log codes of the given equipment ID having a
+ * handler, in ascending order and followed by a 0 terminator, as expected
+ * by qcdm_cmd_log_config_set_mask_new(). Returns the number of codes.
+ */
+size_t   qcdm_log_stream_get_codes   (QcdmLogStream *stream,
+                                      uint8_t equip_id,
+                                      uint16_t *codes,
+                                      size_t max_codes);
+
+/* Dispatches an already decapsulated packet. Returns TRUE if it was a log
+ * item, whether handled or not.
+ */
+qcdmbool qcdm_log_stream_dispatch    (QcdmLogStream *stream,
+                                      const char *packet,
+                                      size_t len);
+
+/* Frames raw data read from the port, dispatching every complete packet.
+ * Incomplete data is kept until the next call.
+ */
+void     qcdm_log_stream_feed        (QcdmLogStream *stream,
+                                      const char *buf,
+                                      size_t len);
+
+/* Discards any incomplete data kept */
+void     qcdm_log_stream_flush       (QcdmLogStream *stream);
+
+void     qcdm_log_stream_get_stats   (QcdmLogStream *stream,
+                                      QcdmLogStreamStats *out_stats);
+
+#endif  /* LIBQCDM_LOG_STREAM_H */
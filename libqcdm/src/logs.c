@@ -70,16 +70,29 @@ check_log_item (const char *buf, size_t len, uint16_t log_code, size_t min_len,
 #define PILOT_SETS_LOG_CANDIDATE_SET "candidate-set"
 #define PILOT_SETS_LOG_REMAINING_SET  "remaining-set"
 
-static const char *
-set_num_to_str (uint32_t num)
+enum {
+    PILOT_SETS_LOG_FIELD_ACTIVE_SET = 0,
+    PILOT_SETS_LOG_FIELD_CANDIDATE_SET,
+    PILOT_SETS_LOG_FIELD_REMAINING_SET,
+    PILOT_SETS_LOG_N_FIELDS
+};
+
+static const char *const pilot_sets_keys[PILOT_SETS_LOG_N_FIELDS] = {
+    [PILOT_SETS_LOG_FIELD_ACTIVE_SET]    = PILOT_SETS_LOG_ACTIVE_SET,
+    [PILOT_SETS_LOG_FIELD_CANDIDATE_SET] = PILOT_SETS_LOG_CANDIDATE_SET,
+    [PILOT_SETS_LOG_FIELD_REMAINING_SET] = PILOT_SETS_LOG_REMAINING_SET,
+};
+
+static int
+set_num_to_field (uint32_t num)
 {
     if (num == QCDM_LOG_ITEM_EVDO_PILOT_SETS_V2_TYPE_ACTIVE)
-        return PILOT_SETS_LOG_ACTIVE_SET;
+        return PILOT_SETS_LOG_FIELD_ACTIVE_SET;
     if (num == QCDM_LOG_ITEM_EVDO_PILOT_SETS_V2_TYPE_CANDIDATE)
-        return PILOT_SETS_LOG_CANDIDATE_SET;
+        return PILOT_SETS_LOG_FIELD_CANDIDATE_SET;
     if (num == QCDM_LOG_ITEM_EVDO_PILOT_SETS_V2_TYPE_REMAINING)
-        return PILOT_SETS_LOG_REMAINING_SET;
-    return NULL;
+        return PILOT_SETS_LOG_FIELD_REMAINING_SET;
+    return -1;
 }
 
 QcdmResult *
@@ -97,28 +110,28 @@ qcdm_log_item_evdo_pilot_sets_v2_new (const char *buf, size_t len, int *out_erro
 
     pilot_sets = (DMLogItemEvdoPilotSetsV2 *) log_cmd->data;
 
-    result = qcdm_result_new ();
+    result = qcdm_result_new_with_fields (pilot_sets_keys, PILOT_SETS_LOG_N_FIELDS, len);
 
     sets_len = pilot_sets->active_count * sizeof (DMLogItemEvdoPilotSetsV2Pilot);
     if (sets_len > 0) {
-        qcdm_result_add_u8_array (result,
-                                  PILOT_SETS_LOG_ACTIVE_SET,
+        qcdm_result_set_u8_array (result,
+                                  PILOT_SETS_LOG_FIELD_ACTIVE_SET,
                                   (const uint8_t *) &pilot_sets->sets[0],
                                   sets_len);
     }
 
     sets_len = pilot_sets->candidate_count * sizeof (DMLogItemEvdoPilotSetsV2Pilot);
     if (sets_len > 0) {
-        qcdm_result_add_u8_array (result,
-                                  PILOT_SETS_LOG_CANDIDATE_SET,
+        qcdm_result_set_u8_array (result,
+                                  PILOT_SETS_LOG_FIELD_CANDIDATE_SET,
                                   (const uint8_t *) &pilot_sets->sets[pilot_sets->active_count],
                                   sets_len);
     }
 
     sets_len = pilot_sets->remaining_count * sizeof (DMLogItemEvdoPilotSetsV2Pilot);
     if (sets_len > 0) {
-        qcdm_result_add_u8_array (result,
-                                  PILOT_SETS_LOG_REMAINING_SET,
+        qcdm_result_set_u8_array (result,
+                                  PILOT_SETS_LOG_FIELD_REMAINING_SET,
                                   (const uint8_t *) &pilot_sets->sets[pilot_sets->active_count + pilot_sets->candidate_count],
                                   sets_len);
     }
@@ -132,16 +145,16 @@ qcdm_log_item_evdo_pilot_sets_v2_get_num (QcdmResult *result,
                                           uint32_t set_type,
                                           uint32_t *out_num)
 {
-    const char *set_name;
+    int field;
     const uint8_t *array = NULL;
     size_t array_len = 0;
 
     qcdm_return_val_if_fail (result != NULL, FALSE);
 
-    set_name = set_num_to_str (set_type);
-    qcdm_return_val_if_fail (set_name != NULL, FALSE);
+    field = set_num_to_field (set_type);
+    qcdm_return_val_if_fail (field >= 0, FALSE);
 
-    if (qcdm_result_get_u8_array (result, set_name, &array, &array_len))
+    if (qcdm_result_get_field_u8_array (result, field, &array, &array_len))
         return FALSE;
 
     *out_num = array_len / sizeof (DMLogItemEvdoPilotSetsV2Pilot);
@@ -158,17 +171,17 @@ qcdm_log_item_evdo_pilot_sets_v2_get_pilot (QcdmResult *result,
                                             uint32_t *out_pilot_energy,
                                             int32_t *out_rssi_dbm)
 {
-    const char *set_name;
+    int field;
     DMLogItemEvdoPilotSetsV2Pilot *pilot;
     const uint8_t *array = NULL;
     size_t array_len = 0;
 
     qcdm_return_val_if_fail (result != NULL, FALSE);
 
-    set_name = set_num_to_str (set_type);
-    qcdm_return_val_if_fail (set_name != NULL, FALSE);
+    field = set_num_to_field (set_type);
+    qcdm_return_val_if_fail (field >= 0, FALSE);
 
-    if (qcdm_result_get_u8_array (result, set_name, &array, &array_len))
+    if (qcdm_result_get_field_u8_array (result, field, &array, &array_len))
         return FALSE;
 
     qcdm_return_val_if_fail (num < array_len / sizeof (DMLogItemEvdoPilotSetsV2Pilot), FALSE);
@@ -22,6 +22,43 @@
 
 QcdmResult *qcdm_result_new (void);
 
+/* 'keys' must have 'n_fields' static strings, used by the string-keyed
+ * getters. 'data_size' bytes are reserved in the same allocation for the
+ * strings and arrays of the result; anything not fitting goes to the heap.
+ */
+QcdmResult *qcdm_result_new_with_fields (const char *const *keys,
+                                         size_t n_fields,
+                                         size_t data_size);
+
+void qcdm_result_set_string    (QcdmResult *result,
+                                unsigned int field,
+                                const char *str);
+
+void qcdm_result_set_u8        (QcdmResult *result,
+                                unsigned int field,
+                                uint8_t num);
+
+void qcdm_result_set_u32       (QcdmResult *result,
+                                unsigned int field,
+                                uint32_t num);
+
+void qcdm_result_set_u8_array  (QcdmResult *result,
+                                unsigned int field,
+                                const uint8_t *array,
+                                size_t array_len);
+
+void qcdm_result_set_u16_array (QcdmResult *result,
+                                unsigned int field,
+                                const uint16_t *array,
+                                size_t array_len);
+
+int qcdm_result_get_field_u8_array (QcdmResult *result,
+                                    unsigned int field,
+                                    const uint8_t **out_val,
+                                    size_t *out_len);
+
+/* Keys given to the qcdm_result_add_*() methods must be static strings */
+
 void qcdm_result_add_string (QcdmResult *result,
                              const char *key,
                              const char *str);
@@ -36,8 +36,11 @@ typedef enum {
 } ValType;
 
 struct Val {
-    char *key;
+    /* Static string, not owned */
+    const char *key;
     uint8_t type;
+    /* Whether the string or array didn't fit in the inline data */
+    uint8_t heap;
     union {
         char *s;
         uint8_t u8;
@@ -46,223 +49,433 @@ struct Val {
         uint16_t *u16_array;
     } u;
     uint32_t array_len;
-    Val *next;
 };
 
 static void
-val_free (Val *v)
-{
-    if (v->type == VAL_TYPE_STRING) {
-        free (v->u.s);
-    } else if (v->type == VAL_TYPE_U8_ARRAY) {
-        free (v->u.u8_array);
-    } else if (v->type == VAL_TYPE_U16_ARRAY) {
-        free (v->u.u16_array);
+val_clear (Val *v)
+{
+    if (v->heap) {
+        if (v->type == VAL_TYPE_STRING)
+            free (v->u.s);
+        else if (v->type == VAL_TYPE_U8_ARRAY)
+            free (v->u.u8_array);
+        else if (v->type == VAL_TYPE_U16_ARRAY)
+            free (v->u.u16_array);
+    }
+    v->type = VAL_TYPE_NONE;
+    v->heap = 0;
+    v->array_len = 0;
+    memset (&v->u, 0, sizeof (v->u));
+}
+
+/*********************************************************/
+
+/* Fields and inline data of results created with qcdm_result_new() */
+#define DEFAULT_N_FIELDS  8
+#define DEFAULT_DATA_SIZE 64
+
+#define DATA_ALIGN(n) (((n) + 7) & ~((size_t) 7))
+
+/* Fields are identified by their index, and the strings and arrays they
+ * hold are stored right after them, all in a single allocation.
+ */
+struct QcdmResult {
+    uint32_t refcount;
+    uint32_t n_fields;
+    uint8_t *data;
+    size_t data_size;
+    size_t data_used;
+    Val fields[];
+};
+
+QcdmResult *
+qcdm_result_new_with_fields (const char *const *keys,
+                             size_t n_fields,
+                             size_t data_size)
+{
+    QcdmResult *r;
+    size_t fields_size;
+    size_t i;
+
+    fields_size = DATA_ALIGN (sizeof (QcdmResult) + n_fields * sizeof (Val));
+    r = calloc (fields_size + data_size, 1);
+    if (r == NULL)
+        return NULL;
+
+    r->refcount = 1;
+    r->n_fields = n_fields;
+    r->data = (uint8_t *) r + fields_size;
+    r->data_size = data_size;
+    if (keys) {
+        for (i = 0; i < n_fields; i++)
+            r->fields[i].key = keys[i];
     }
-    free (v->key);
-    memset (v, 0, sizeof (*v));
-    free (v);
+    return r;
 }
 
+QcdmResult *
+qcdm_result_new (void)
+{
+    return qcdm_result_new_with_fields (NULL, DEFAULT_N_FIELDS, DEFAULT_DATA_SIZE);
+}
+
+QcdmResult *
+qcdm_result_ref (QcdmResult *r)
+{
+    qcdm_return_val_if_fail (r != NULL, NULL);
+    qcdm_return_val_if_fail (r->refcount > 0, NULL);
+
+    r->refcount++;
+    return r;
+}
+
+static void
+qcdm_result_free (QcdmResult *r)
+{
+    uint32_t i;
+
+    for (i = 0; i < r->n_fields; i++)
+        val_clear (&r->fields[i]);
+    memset (r, 0, sizeof (*r));
+    free (r);
+}
+
+void
+qcdm_result_unref (QcdmResult *r)
+{
+    qcdm_return_if_fail (r != NULL);
+    qcdm_return_if_fail (r->refcount > 0);
+
+    r->refcount--;
+    if (r->refcount == 0)
+        qcdm_result_free (r);
+}
+
+/*********************************************************/
+
+/* Returns the field cleared, ready to be set */
 static Val *
-val_new_string (const char *key, const char *value)
+field_for_set (QcdmResult *r, unsigned int field)
 {
-    Val *v;
+    qcdm_return_val_if_fail (r != NULL, NULL);
+    qcdm_return_val_if_fail (r->refcount > 0, NULL);
+    qcdm_return_val_if_fail (field < r->n_fields, NULL);
 
-    qcdm_return_val_if_fail (key != NULL, NULL);
-    qcdm_return_val_if_fail (key[0] != '\0', NULL);
-    qcdm_return_val_if_fail (value != NULL, NULL);
+    val_clear (&r->fields[field]);
+    return &r->fields[field];
+}
 
-    v = calloc (sizeof (Val), 1);
-    if (v == NULL)
-        return NULL;
+/* Storage for strings and arrays, inline if there's space left */
+static void *
+field_data_new (QcdmResult *r, Val *v, size_t size)
+{
+    size_t offset;
 
-    v->key = strdup (key);
-    v->type = VAL_TYPE_STRING;
-    v->u.s = strdup (value);
-    return v;
+    offset = DATA_ALIGN (r->data_used);
+    if (offset + size <= r->data_size) {
+        r->data_used = offset + size;
+        return r->data + offset;
+    }
+
+    v->heap = 1;
+    return malloc (size);
 }
 
 static Val *
-val_new_u8 (const char *key, uint8_t u)
+find_field (QcdmResult *r, unsigned int field, ValType expected_type)
 {
     Val *v;
 
-    qcdm_return_val_if_fail (key != NULL, NULL);
-    qcdm_return_val_if_fail (key[0] != '\0', NULL);
+    if (field >= r->n_fields)
+        return NULL;
 
-    v = calloc (sizeof (Val), 1);
-    if (v == NULL)
+    v = &r->fields[field];
+    if (v->type == VAL_TYPE_NONE)
         return NULL;
 
-    v->key = strdup (key);
-    v->type = VAL_TYPE_U8;
-    v->u.u8 = u;
+    qcdm_return_val_if_fail (v->type == expected_type, NULL);
     return v;
 }
 
-static Val *
-val_new_u8_array (const char *key, const uint8_t *array, size_t array_len)
+/* Returns the index of the field with the given key, or -1 if not found */
+static int
+find_key (QcdmResult *r, const char *key)
 {
-    Val *v;
+    uint32_t i;
+
+    for (i = 0; i < r->n_fields; i++) {
+        if (r->fields[i].key == NULL)
+            break;
+        /* Keys usually come from the same string literal */
+        if (r->fields[i].key == key || strcmp (r->fields[i].key, key) == 0)
+            return i;
+    }
+    return -1;
+}
 
-    qcdm_return_val_if_fail (key != NULL, NULL);
-    qcdm_return_val_if_fail (key[0] != '\0', NULL);
-    qcdm_return_val_if_fail (array != NULL, NULL);
-    qcdm_return_val_if_fail (array_len > 0, NULL);
+/* String-keyed results get a new field for each new key */
+static int
+find_or_add_key (QcdmResult *r, const char *key)
+{
+    int field;
+    uint32_t i;
 
-    v = calloc (sizeof (Val), 1);
-    if (v == NULL)
-        return NULL;
+    qcdm_return_val_if_fail (r != NULL, -1);
+    qcdm_return_val_if_fail (key != NULL, -1);
+    qcdm_return_val_if_fail (key[0] != '\0', -1);
 
-    v->key = strdup (key);
-    v->type = VAL_TYPE_U8_ARRAY;
-    v->u.u8_array = malloc (array_len);
-    if (v->u.u8_array == NULL) {
-        val_free (v);
-        return NULL;
+    field = find_key (r, key);
+    if (field >= 0)
+        return field;
+
+    for (i = 0; i < r->n_fields; i++) {
+        if (r->fields[i].key == NULL) {
+            r->fields[i].key = key;
+            return i;
+        }
     }
-    memcpy (v->u.u8_array, array, array_len);
-    v->array_len = array_len;
 
-    return v;
+    qcdm_warn (0, "no space left in result for key '%s'", key);
+    return -1;
 }
 
 static Val *
-val_new_u32 (const char *key, uint32_t u)
+find_val (QcdmResult *r, const char *key, ValType expected_type)
+{
+    int field;
+
+    field = find_key (r, key);
+    if (field < 0)
+        return NULL;
+    return find_field (r, field, expected_type);
+}
+
+/*********************************************************/
+
+void
+qcdm_result_set_string (QcdmResult *r,
+                        unsigned int field,
+                        const char *str)
 {
     Val *v;
+    size_t len;
 
-    qcdm_return_val_if_fail (key != NULL, NULL);
-    qcdm_return_val_if_fail (key[0] != '\0', NULL);
+    qcdm_return_if_fail (str != NULL);
 
-    v = calloc (sizeof (Val), 1);
-    if (v == NULL)
-        return NULL;
+    v = field_for_set (r, field);
+    qcdm_return_if_fail (v != NULL);
+
+    len = strlen (str) + 1;
+    v->u.s = field_data_new (r, v, len);
+    qcdm_return_if_fail (v->u.s != NULL);
+    memcpy (v->u.s, str, len);
+    v->type = VAL_TYPE_STRING;
+}
+
+void
+qcdm_result_set_u8 (QcdmResult *r,
+                    unsigned int field,
+                    uint8_t num)
+{
+    Val *v;
+
+    v = field_for_set (r, field);
+    qcdm_return_if_fail (v != NULL);
+
+    v->u.u8 = num;
+    v->type = VAL_TYPE_U8;
+}
+
+void
+qcdm_result_set_u32 (QcdmResult *r,
+                     unsigned int field,
+                     uint32_t num)
+{
+    Val *v;
+
+    v = field_for_set (r, field);
+    qcdm_return_if_fail (v != NULL);
 
-    v->key = strdup (key);
+    v->u.u32 = num;
     v->type = VAL_TYPE_U32;
-    v->u.u32 = u;
-    return v;
 }
 
-static Val *
-val_new_u16_array (const char *key, const uint16_t *array, size_t array_len)
+void
+qcdm_result_set_u8_array (QcdmResult *r,
+                          unsigned int field,
+                          const uint8_t *array,
+                          size_t array_len)
+{
+    Val *v;
+
+    qcdm_return_if_fail (array != NULL);
+    qcdm_return_if_fail (array_len > 0);
+
+    v = field_for_set (r, field);
+    qcdm_return_if_fail (v != NULL);
+
+    v->u.u8_array = field_data_new (r, v, array_len);
+    qcdm_return_if_fail (v->u.u8_array != NULL);
+    memcpy (v->u.u8_array, array, array_len);
+    v->array_len = array_len;
+    v->type = VAL_TYPE_U8_ARRAY;
+}
+
+void
+qcdm_result_set_u16_array (QcdmResult *r,
+                           unsigned int field,
+                           const uint16_t *array,
+                           size_t array_len)
 {
     Val *v;
     size_t sz;
 
-    qcdm_return_val_if_fail (key != NULL, NULL);
-    qcdm_return_val_if_fail (key[0] != '\0', NULL);
-    qcdm_return_val_if_fail (array != NULL, NULL);
-    qcdm_return_val_if_fail (array_len > 0, NULL);
+    qcdm_return_if_fail (array != NULL);
+    qcdm_return_if_fail (array_len > 0);
 
-    v = calloc (sizeof (Val), 1);
-    if (v == NULL)
-        return NULL;
+    v = field_for_set (r, field);
+    qcdm_return_if_fail (v != NULL);
 
-    v->key = strdup (key);
-    v->type = VAL_TYPE_U16_ARRAY;
     sz = sizeof (uint16_t) * array_len;
-    v->u.u16_array = malloc (sz);
-    if (v->u.u16_array == NULL) {
-        val_free (v);
-        return NULL;
-    }
+    v->u.u16_array = field_data_new (r, v, sz);
+    qcdm_return_if_fail (v->u.u16_array != NULL);
     memcpy (v->u.u16_array, array, sz);
     v->array_len = array_len;
-
-    return v;
+    v->type = VAL_TYPE_U16_ARRAY;
 }
 
 /*********************************************************/
 
-struct QcdmResult {
-    uint32_t refcount;
-    Val *first;
-};
+static int
+get_string (Val *v, const char **out_val)
+{
+    if (v == NULL)
+        return -QCDM_ERROR_VALUE_NOT_FOUND;
 
-QcdmResult *
-qcdm_result_new (void)
+    *out_val = v->u.s;
+    return 0;
+}
+
+int
+qcdm_result_get_field_string (QcdmResult *r,
+                              unsigned int field,
+                              const char **out_val)
 {
-    QcdmResult *r;
+    qcdm_return_val_if_fail (r != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (r->refcount > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (out_val != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (*out_val == NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
 
-    r = calloc (sizeof (QcdmResult), 1);
-    if (r)
-        r->refcount = 1;
-    return r;
+    return get_string (find_field (r, field, VAL_TYPE_STRING), out_val);
 }
 
-QcdmResult *
-qcdm_result_ref (QcdmResult *r)
+static int
+get_u8 (Val *v, uint8_t *out_val)
 {
-    qcdm_return_val_if_fail (r != NULL, NULL);
-    qcdm_return_val_if_fail (r->refcount > 0, NULL);
+    if (v == NULL)
+        return -QCDM_ERROR_VALUE_NOT_FOUND;
 
-    r->refcount++;
-    return r;
+    *out_val = v->u.u8;
+    return 0;
 }
 
-static void
-qcdm_result_free (QcdmResult *r)
+int
+qcdm_result_get_field_u8 (QcdmResult *r,
+                          unsigned int field,
+                          uint8_t *out_val)
 {
-    Val *v, *n;
+    qcdm_return_val_if_fail (r != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (r->refcount > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (out_val != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
 
-    v = r->first;
-    while (v) {
-        n = v->next;
-        val_free (v);
-        v = n;
-    }
-    memset (r, 0, sizeof (*r));
-    free (r);
+    return get_u8 (find_field (r, field, VAL_TYPE_U8), out_val);
 }
 
-void
-qcdm_result_unref (QcdmResult *r)
+static int
+get_u32 (Val *v, uint32_t *out_val)
 {
-    qcdm_return_if_fail (r != NULL);
-    qcdm_return_if_fail (r->refcount > 0);
+    if (v == NULL)
+        return -QCDM_ERROR_VALUE_NOT_FOUND;
 
-    r->refcount--;
-    if (r->refcount == 0)
-        qcdm_result_free (r);
+    *out_val = v->u.u32;
+    return 0;
 }
 
-static Val *
-find_val (QcdmResult *r, const char *key, ValType expected_type)
+int
+qcdm_result_get_field_u32 (QcdmResult *r,
+                           unsigned int field,
+                           uint32_t *out_val)
 {
-    Val *v, *n;
+    qcdm_return_val_if_fail (r != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (r->refcount > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (out_val != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
 
-    v = r->first;
-    while (v) {
-        n = v->next;
-        if (strcmp (v->key, key) == 0) {
-            /* Check type */
-            qcdm_return_val_if_fail (v->type == expected_type, NULL);
-            return v;
-        }
-        v = n;
-    }
-    return NULL;
+    return get_u32 (find_field (r, field, VAL_TYPE_U32), out_val);
+}
+
+static int
+get_u8_array (Val *v, const uint8_t **out_val, size_t *out_len)
+{
+    if (v == NULL)
+        return -QCDM_ERROR_VALUE_NOT_FOUND;
+
+    *out_val = v->u.u8_array;
+    *out_len = v->array_len;
+    return 0;
+}
+
+int
+qcdm_result_get_field_u8_array (QcdmResult *r,
+                                unsigned int field,
+                                const uint8_t **out_val,
+                                size_t *out_len)
+{
+    qcdm_return_val_if_fail (r != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (r->refcount > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (out_val != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (out_len != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+
+    return get_u8_array (find_field (r, field, VAL_TYPE_U8_ARRAY), out_val, out_len);
+}
+
+static int
+get_u16_array (Val *v, const uint16_t **out_val, size_t *out_len)
+{
+    if (v == NULL)
+        return -QCDM_ERROR_VALUE_NOT_FOUND;
+
+    *out_val = v->u.u16_array;
+    *out_len = v->array_len;
+    return 0;
 }
 
+int
+qcdm_result_get_field_u16_array (QcdmResult *r,
+                                 unsigned int field,
+                                 const uint16_t **out_val,
+                                 size_t *out_len)
+{
+    qcdm_return_val_if_fail (r != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (r->refcount > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (out_val != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+    qcdm_return_val_if_fail (out_len != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
+
+    return get_u16_array (find_field (r, field, VAL_TYPE_U16_ARRAY), out_val, out_len);
+}
+
+/*********************************************************/
+/* String-keyed API */
+
 void
 qcdm_result_add_string (QcdmResult *r,
                        const char *key,
                        const char *str)
 {
-    Val *v;
+    int field;
 
-    qcdm_return_if_fail (r != NULL);
-    qcdm_return_if_fail (r->refcount > 0);
-    qcdm_return_if_fail (key != NULL);
-    qcdm_return_if_fail (str != NULL);
-
-    v = val_new_string (key, str);
-    qcdm_return_if_fail (v != NULL);
-    v->next = r->first;
-    r->first = v;
+    field = find_or_add_key (r, key);
+    qcdm_return_if_fail (field >= 0);
+    qcdm_result_set_string (r, field, str);
 }
 
 int
@@ -270,20 +483,13 @@ qcdm_result_get_string (QcdmResult *r,
                        const char *key,
                        const char **out_val)
 {
-    Val *v;
-
     qcdm_return_val_if_fail (r != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (r->refcount > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (key != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (out_val != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (*out_val == NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
 
-    v = find_val (r, key, VAL_TYPE_STRING);
-    if (v == NULL)
-        return -QCDM_ERROR_VALUE_NOT_FOUND;
-
-    *out_val = v->u.s;
-    return 0;
+    return get_string (find_val (r, key, VAL_TYPE_STRING), out_val);
 }
 
 void
@@ -291,16 +497,11 @@ qcdm_result_add_u8 (QcdmResult *r,
                    const char *key,
                    uint8_t num)
 {
-    Val *v;
+    int field;
 
-    qcdm_return_if_fail (r != NULL);
-    qcdm_return_if_fail (r->refcount > 0);
-    qcdm_return_if_fail (key != NULL);
-
-    v = val_new_u8 (key, num);
-    qcdm_return_if_fail (v != NULL);
-    v->next = r->first;
-    r->first = v;
+    field = find_or_add_key (r, key);
+    qcdm_return_if_fail (field >= 0);
+    qcdm_result_set_u8 (r, field, num);
 }
 
 int
@@ -308,19 +509,12 @@ qcdm_result_get_u8  (QcdmResult *r,
                     const char *key,
                     uint8_t *out_val)
 {
-    Val *v;
-
     qcdm_return_val_if_fail (r != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (r->refcount > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (key != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (out_val != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
 
-    v = find_val (r, key, VAL_TYPE_U8);
-    if (v == NULL)
-        return -QCDM_ERROR_VALUE_NOT_FOUND;
-
-    *out_val = v->u.u8;
-    return 0;
+    return get_u8 (find_val (r, key, VAL_TYPE_U8), out_val);
 }
 
 void
@@ -329,17 +523,11 @@ qcdm_result_add_u8_array (QcdmResult *r,
                           const uint8_t *array,
                           size_t array_len)
 {
-    Val *v;
-
-    qcdm_return_if_fail (r != NULL);
-    qcdm_return_if_fail (r->refcount > 0);
-    qcdm_return_if_fail (key != NULL);
-    qcdm_return_if_fail (array != NULL);
+    int field;
 
-    v = val_new_u8_array (key, array, array_len);
-    qcdm_return_if_fail (v != NULL);
-    v->next = r->first;
-    r->first = v;
+    field = find_or_add_key (r, key);
+    qcdm_return_if_fail (field >= 0);
+    qcdm_result_set_u8_array (r, field, array, array_len);
 }
 
 int
@@ -348,21 +536,13 @@ qcdm_result_get_u8_array (QcdmResult *r,
                           const uint8_t **out_val,
                           size_t *out_len)
 {
-    Val *v;
-
     qcdm_return_val_if_fail (r != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (r->refcount > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (key != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (out_val != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (out_len != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
 
-    v = find_val (r, key, VAL_TYPE_U8_ARRAY);
-    if (v == NULL)
-        return -QCDM_ERROR_VALUE_NOT_FOUND;
-
-    *out_val = v->u.u8_array;
-    *out_len = v->array_len;
-    return 0;
+    return get_u8_array (find_val (r, key, VAL_TYPE_U8_ARRAY), out_val, out_len);
 }
 
 void
@@ -370,16 +550,11 @@ qcdm_result_add_u32 (QcdmResult *r,
                     const char *key,
                     uint32_t num)
 {
-    Val *v;
+    int field;
 
-    qcdm_return_if_fail (r != NULL);
-    qcdm_return_if_fail (r->refcount > 0);
-    qcdm_return_if_fail (key != NULL);
-
-    v = val_new_u32 (key, num);
-    qcdm_return_if_fail (v != NULL);
-    v->next = r->first;
-    r->first = v;
+    field = find_or_add_key (r, key);
+    qcdm_return_if_fail (field >= 0);
+    qcdm_result_set_u32 (r, field, num);
 }
 
 int
@@ -387,19 +562,12 @@ qcdm_result_get_u32 (QcdmResult *r,
                     const char *key,
                     uint32_t *out_val)
 {
-    Val *v;
-
     qcdm_return_val_if_fail (r != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (r->refcount > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (key != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (out_val != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
 
-    v = find_val (r, key, VAL_TYPE_U32);
-    if (v == NULL)
-        return -QCDM_ERROR_VALUE_NOT_FOUND;
-
-    *out_val = v->u.u32;
-    return 0;
+    return get_u32 (find_val (r, key, VAL_TYPE_U32), out_val);
 }
 
 void
@@ -408,17 +576,11 @@ qcdm_result_add_u16_array (QcdmResult *r,
                            const uint16_t *array,
                            size_t array_len)
 {
-    Val *v;
-
-    qcdm_return_if_fail (r != NULL);
-    qcdm_return_if_fail (r->refcount > 0);
-    qcdm_return_if_fail (key != NULL);
-    qcdm_return_if_fail (array != NULL);
+    int field;
 
-    v = val_new_u16_array (key, array, array_len);
-    qcdm_return_if_fail (v != NULL);
-    v->next = r->first;
-    r->first = v;
+    field = find_or_add_key (r, key);
+    qcdm_return_if_fail (field >= 0);
+    qcdm_result_set_u16_array (r, field, array, array_len);
 }
 
 int
@@ -427,19 +589,11 @@ qcdm_result_get_u16_array (QcdmResult *r,
                            const uint16_t **out_val,
                            size_t *out_len)
 {
-    Val *v;
-
     qcdm_return_val_if_fail (r != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (r->refcount > 0, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (key != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (out_val != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
     qcdm_return_val_if_fail (out_len != NULL, -QCDM_ERROR_INVALID_ARGUMENTS);
 
-    v = find_val (r, key, VAL_TYPE_U16_ARRAY);
-    if (v == NULL)
-        return -QCDM_ERROR_VALUE_NOT_FOUND;
-
-    *out_val = v->u.u16_array;
-    *out_len = v->array_len;
-    return 0;
+    return get_u16_array (find_val (r, key, VAL_TYPE_U16_ARRAY), out_val, out_len);
 }
@@ -39,6 +39,27 @@ int qcdm_result_get_u16_array  (QcdmResult *result,
                                 const uint16_t **out_val,
                                 size_t *out_len);
 
+/* Typed access to results whose fields are known in advance, identified by
+ * the QCDM_CMD_<command>_FIELD_* values of the command that created them.
+ * Field IDs from a different command give unrelated or no values.
+ */
+int qcdm_result_get_field_string (QcdmResult *r,
+                                  unsigned int field,
+                                  const char **out_val);
+
+int qcdm_result_get_field_u8     (QcdmResult *r,
+                                  unsigned int field,
+                                  uint8_t *out_val);
+
+int qcdm_result_get_field_u32    (QcdmResult *r,
+                                  unsigned int field,
+                                  uint32_t *out_val);
+
+int qcdm_result_get_field_u16_array (QcdmResult *r,
+                                     unsigned int field,
+                                     const uint16_t **out_val,
+                                     size_t *out_len);
+
 QcdmResult *qcdm_result_ref    (QcdmResult *r);
 
 void       qcdm_result_unref   (QcdmResult *r);
@@ -59,4 +59,16 @@ qcdmbool dm_decapsulate_buffer (const char *inbuf,
                                 size_t *out_used,
                                 qcdmbool *out_need_more);
 
+typedef void (*DmFrameFunc) (const char *packet,
+                             size_t len,
+                             void *user_data);
+
+size_t dm_decapsulate_frames (const char *inbuf,
+                              size_t inbuf_len,
+                              char *outbuf,
+                              size_t outbuf_len,
+                              DmFrameFunc frame_func,
+                              void *user_data,
+                              size_t *out_n_invalid);
+
 #endif  /* LIBQCDM_UTILS_H */
@@ -0,0 +1,283 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#include "test-qcdm-log-stream.h"
+#include "log-stream.h"
+#include "log-items.h"
+#include "logs.h"
+#include "utils.h"
+
+/* EVDO pilot sets (v2) log item, with one pilot in each set; the timestamp
+ * and the candidate pilot need escaping once framed.
+ */
+static const char pilot_sets_packet[] = {
+    0x10, 0x00, 0x35, 0x00, 0x35, 0x00, 0x8b, 0x10, 0x7e, 0x7d, 0x2a, 0xd3,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x07, 0x4b, 0x00, 0x00, 0x01, 0x07,
+    0x01, 0x0a, 0x00, 0xc8, 0x00, 0x90, 0x01, 0x05, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x7e, 0x00, 0x7d, 0x00, 0x4b, 0x00, 0x00, 0x00, 0x00, 0x01, 0x36,
+    0x01, 0x32, 0x00, 0x4b, 0x00, 0x00, 0x01, 0x00, 0x00
+};
+
+/* WCDMA cell ID log item, header only */
+static const char cell_id_packet[] = {
+    0x10, 0x00, 0x0c, 0x00, 0x0c, 0x00, 0x27, 0x41, 0x00, 0x00, 0x10, 0x20,
+    0x00, 0x00, 0x00, 0x00
+};
+
+/* Not a log item */
+static const char status_packet[] = {
+    0x0c, 0x00, 0x00, 0x00
+};
+
+typedef struct {
+    guint n_pilot_sets;
+    guint n_cell_id;
+} HandlerContext;
+
+static void
+append_frame (GByteArray *stream, const char *packet, gsize len)
+{
+    char inbuf[128];
+    char frame[(sizeof (inbuf) + 2) * 2 + 1];
+    gsize frame_len;
+
+    g_assert_cmpuint (len + 2, <=, sizeof (inbuf));
+    memcpy (inbuf, packet, len);
+    frame_len = dm_encapsulate_buffer (inbuf, len, sizeof (inbuf), frame, sizeof (frame));
+    g_assert_cmpuint (frame_len, >, 0);
+    g_byte_array_append (stream, (const guint8 *) frame, frame_len);
+}
+
+static void
+feed_chunked (QcdmLogStream *stream, GByteArray *data, GRand *rand, guint max_chunk)
+{
+    guint offset = 0;
+
+    while (offset < data->len) {
+        guint chunk;
+
+        chunk = g_rand_int_range (rand, 1, max_chunk + 1);
+        chunk = MIN (chunk, data->len - offset);
+        qcdm_log_stream_feed (stream, (const char *) data->data + offset, chunk);
+        offset += chunk;
+    }
+}
+
+static void
+check_pilot (QcdmResult *result,
+             guint32 set_type,
+             guint32 expected_pn,
+             guint32 expected_energy,
+             gint32 expected_rssi)
+{
+    uint32_t num = 0;
+    uint32_t pn = 0;
+    uint32_t energy = 0;
+    int32_t rssi = 0;
+
+    g_assert (qcdm_log_item_evdo_pilot_sets_v2_get_num (result, set_type, &num));
+    g_assert_cmpuint (num, ==, 1);
+    g_assert (qcdm_log_item_evdo_pilot_sets_v2_get_pilot (result, set_type, 0, &pn, &energy, &rssi));
+    g_assert_cmpuint (pn, ==, expected_pn);
+    g_assert_cmpuint (energy, ==, expected_energy);
+    g_assert_cmpint (rssi, ==, expected_rssi);
+}
+
+static void
+pilot_sets_cb (uint16_t log_code, const char *packet, size_t len, void *user_data)
+{
+    HandlerContext *ctx = user_data;
+    QcdmResult *result;
+    int err = 0;
+
+    g_assert_cmphex (log_code, ==, DM_LOG_ITEM_EVDO_PILOT_SETS_V2);
+    g_assert_cmpuint (len, ==, sizeof (pilot_sets_packet));
+    g_assert (memcmp (packet, pilot_sets_packet, len) == 0);
+
+    result = qcdm_log_item_evdo_pilot_sets_v2_new (packet, len, &err);
+    g_assert (result);
+    check_pilot (result, QCDM_LOG_ITEM_EVDO_PILOT_SETS_V2_TYPE_ACTIVE, 200, 400, -85);
+    check_pilot (result, QCDM_LOG_ITEM_EVDO_PILOT_SETS_V2_TYPE_CANDIDATE, 126, 125, -104);
+    check_pilot (result, QCDM_LOG_ITEM_EVDO_PILOT_SETS_V2_TYPE_REMAINING, 310, 50, -110);
+    qcdm_result_unref (result);
+
+    ctx->n_pilot_sets++;
+}
+
+static void
+cell_id_cb (uint16_t log_code, const char *packet, size_t len, void *user_data)
+{
+    HandlerContext *ctx = user_data;
+
+    g_assert_cmphex (log_code, ==, DM_LOG_ITEM_WCDMA_CELL_ID);
+    g_assert_cmpuint (len, ==, sizeof (cell_id_packet));
+    ctx->n_cell_id++;
+}
+
+void
+test_log_stream_pilot_sets (void *f, void *data)
+{
+    QcdmLogStream *stream;
+    QcdmLogStreamStats stats;
+    HandlerContext ctx = { 0, 0 };
+    GByteArray *bytes;
+    GRand *rand;
+    char unhandled_packet[sizeof (pilot_sets_packet)];
+    guint i;
+    guint seed;
+
+    /* Same item, but with a code nobody handles */
+    memcpy (unhandled_packet, pilot_sets_packet, sizeof (unhandled_packet));
+    unhandled_packet[6] = 0x05;
+    unhandled_packet[7] = 0x41;
+
+    bytes = g_byte_array_new ();
+    for (i = 0; i < 5; i++) {
+        append_frame (bytes, pilot_sets_packet, sizeof (pilot_sets_packet));
+        append_frame (bytes, status_packet, sizeof (status_packet));
+        append_frame (bytes, unhandled_packet, sizeof (unhandled_packet));
+    }
+
+    /* Whatever the way the data is split across reads */
+    for (seed = 0; seed < 20; seed++) {
+        memset (&ctx, 0, sizeof (ctx));
+        stream = qcdm_log_stream_new (QCDM_LOG_STREAM_DEFAULT_MAX_PACKET_LEN);
+        g_assert (stream);
+        g_assert_cmpint (qcdm_log_stream_set_handler (stream, DM_LOG_ITEM_EVDO_PILOT_SETS_V2, pilot_sets_cb, &ctx), ==, 0);
+
+        rand = g_rand_new_with_seed (seed);
+        feed_chunked (stream, bytes, rand, seed < 10 ? 8 : 128);
+        g_rand_free (rand);
+
+        g_assert_cmpuint (ctx.n_pilot_sets, ==, 5);
+        qcdm_log_stream_get_stats (stream, &stats);
+        g_assert_cmpuint (stats.n_frames, ==, 15);
+        g_assert_cmpuint (stats.n_items, ==, 5);
+        g_assert_cmpuint (stats.n_unhandled, ==, 5);
+        g_assert_cmpuint (stats.n_other, ==, 5);
+        g_assert_cmpuint (stats.n_invalid, ==, 0);
+        g_assert_cmpuint (stats.n_dropped_bytes, ==, 0);
+
+        qcdm_log_stream_free (stream);
+    }
+
+    g_byte_array_unref (bytes);
+}
+
+void
+test_log_stream_invalid (void *f, void *data)
+{
+    QcdmLogStream *stream;
+    QcdmLogStreamStats stats;
+    HandlerContext ctx = { 0, 0 };
+    GByteArray *bytes;
+    GRand *rand;
+    guint frame_len;
+
+    /* Corrupt and truncated packets */
+    stream = qcdm_log_stream_new (QCDM_LOG_STREAM_DEFAULT_MAX_PACKET_LEN);
+    qcdm_log_stream_set_handler (stream, DM_LOG_ITEM_EVDO_PILOT_SETS_V2, pilot_sets_cb, &ctx);
+    qcdm_log_stream_set_handler (stream, DM_LOG_ITEM_WCDMA_CELL_ID, cell_id_cb, &ctx);
+
+    bytes = g_byte_array_new ();
+    append_frame (bytes, pilot_sets_packet, sizeof (pilot_sets_packet));
+    bytes->data[2] ^= 0x01;
+    append_frame (bytes, cell_id_packet, 8);
+    append_frame (bytes, cell_id_packet, sizeof (cell_id_packet));
+    qcdm_log_stream_feed (stream, (const char *) bytes->data, bytes->len);
+
+    g_assert_cmpuint (ctx.n_pilot_sets, ==, 0);
+    g_assert_cmpuint (ctx.n_cell_id, ==, 1);
+    qcdm_log_stream_get_stats (stream, &stats);
+    g_assert_cmpuint (stats.n_items, ==, 1);
+    g_assert_cmpuint (stats.n_invalid, ==, 2);
+    qcdm_log_stream_free (stream);
+    g_byte_array_unref (bytes);
+
+    /* Packets longer than the maximum */
+    memset (&ctx, 0, sizeof (ctx));
+    stream = qcdm_log_stream_new (sizeof (cell_id_packet));
+    qcdm_log_stream_set_handler (stream, DM_LOG_ITEM_EVDO_PILOT_SETS_V2, pilot_sets_cb, &ctx);
+    qcdm_log_stream_set_handler (stream, DM_LOG_ITEM_WCDMA_CELL_ID, cell_id_cb, &ctx);
+
+    bytes = g_byte_array_new ();
+    append_frame (bytes, pilot_sets_packet, sizeof (pilot_sets_packet));
+    frame_len = bytes->len;
+    append_frame (bytes, cell_id_packet, sizeof (cell_id_packet));
+
+    /* All at once, the frame is found but can't be unescaped */
+    qcdm_log_stream_feed (stream, (const char *) bytes->data, bytes->len);
+    qcdm_log_stream_get_stats (stream, &stats);
+    g_assert_cmpuint (stats.n_invalid, ==, 1);
+    g_assert_cmpuint (stats.n_dropped_bytes, ==, 0);
+    g_assert_cmpuint (ctx.n_cell_id, ==, 1);
+
+    /* In small reads, the incomplete frame doesn't fit and is dropped
+     * without losing the next one */
+    rand = g_rand_new_with_seed (1);
+    feed_chunked (stream, bytes, rand, 10);
+    g_rand_free (rand);
+    qcdm_log_stream_get_stats (stream, &stats);
+    g_assert_cmpuint (stats.n_invalid, ==, 1);
+    g_assert_cmpuint (stats.n_dropped_bytes, ==, frame_len);
+    g_assert_cmpuint (ctx.n_cell_id, ==, 2);
+    g_assert_cmpuint (ctx.n_pilot_sets, ==, 0);
+
+    /* Flushing drops whatever is pending */
+    qcdm_log_stream_feed (stream, (const char *) bytes->data, 5);
+    qcdm_log_stream_flush (stream);
+    qcdm_log_stream_get_stats (stream, &stats);
+    g_assert_cmpuint (stats.n_dropped_bytes, ==, frame_len + 5);
+
+    qcdm_log_stream_free (stream);
+    g_byte_array_unref (bytes);
+}
+
+void
+test_log_stream_codes (void *f, void *data)
+{
+    QcdmLogStream *stream;
+    HandlerContext ctx = { 0, 0 };
+    uint16_t codes[8];
+
+    stream = qcdm_log_stream_new (QCDM_LOG_STREAM_DEFAULT_MAX_PACKET_LEN);
+    qcdm_log_stream_set_handler (stream, DM_LOG_ITEM_EVDO_PILOT_SETS_V2, pilot_sets_cb, &ctx);
+    qcdm_log_stream_set_handler (stream, DM_LOG_ITEM_CDMA_REVERSE_POWER_CONTROL, pilot_sets_cb, &ctx);
+    qcdm_log_stream_set_handler (stream, DM_LOG_ITEM_WCDMA_CELL_ID, cell_id_cb, &ctx);
+
+    g_assert_cmpuint (qcdm_log_stream_get_codes (stream, 0x01, codes, G_N_ELEMENTS (codes)), ==, 2);
+    g_assert_cmphex (codes[0], ==, DM_LOG_ITEM_CDMA_REVERSE_POWER_CONTROL);
+    g_assert_cmphex (codes[1], ==, DM_LOG_ITEM_EVDO_PILOT_SETS_V2);
+    g_assert_cmphex (codes[2], ==, 0);
+
+    g_assert_cmpuint (qcdm_log_stream_get_codes (stream, 0x04, codes, G_N_ELEMENTS (codes)), ==, 1);
+    g_assert_cmphex (codes[0], ==, DM_LOG_ITEM_WCDMA_CELL_ID);
+
+    g_assert_cmpuint (qcdm_log_stream_get_codes (stream, 0x07, codes, G_N_ELEMENTS (codes)), ==, 0);
+    g_assert_cmphex (codes[0], ==, 0);
+
+    /* Always room for the terminator */
+    g_assert_cmpuint (qcdm_log_stream_get_codes (stream, 0x01, codes, 2), ==, 1);
+    g_assert_cmphex (codes[1], ==, 0);
+
+    qcdm_log_stream_set_handler (stream, DM_LOG_ITEM_CDMA_REVERSE_POWER_CONTROL, NULL, NULL);
+    g_assert_cmpuint (qcdm_log_stream_get_codes (stream, 0x01, codes, G_N_ELEMENTS (codes)), ==, 1);
+    g_assert_cmphex (codes[0], ==, DM_LOG_ITEM_EVDO_PILOT_SETS_V2);
+
+    qcdm_log_stream_free (stream);
+}
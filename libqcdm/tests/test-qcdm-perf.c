@@ -0,0 +1,244 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#include "utils.h"
+
+/*
+ * Framing throughput. Run with '-m perf' to get meaningful numbers; in the
+ * default (quick) mode the buffers are only processed a few times, just to
+ * make sure the results are consistent.
+ */
+
+#define QUICK_ROUNDS 10
+#define PERF_ROUNDS  5000
+
+/* Similar in size to the DIAG log items streamed by devices */
+#define PACKET_LEN   200
+#define N_PACKETS    256
+
+static guint
+n_rounds (void)
+{
+    return g_test_perf () ? PERF_ROUNDS : QUICK_ROUNDS;
+}
+
+static void
+report_rate (const gchar *what,
+             gsize        n_bytes,
+             gdouble      elapsed)
+{
+    gdouble rate;
+
+    rate = elapsed > 0.0 ? n_bytes / elapsed / (1024.0 * 1024.0) : 0.0;
+    g_test_maximized_result (rate, "%s: %.1f MiB/s", what, rate);
+    if (g_test_verbose ())
+        g_print ("%s: %" G_GSIZE_FORMAT " bytes in %.3f s: %.1f MiB/s\n", what, n_bytes, elapsed, rate);
+}
+
+/* Random packet contents, with about 1% of bytes needing escaping */
+static void
+fill_packet (GRand *rand,
+             char  *packet,
+             gsize  len)
+{
+    gsize i;
+
+    for (i = 0; i < len; i++) {
+        if (g_rand_int_range (rand, 0, 100) == 0)
+            packet[i] = g_rand_boolean (rand) ? DIAG_CONTROL_CHAR : 0x7D;
+        else
+            packet[i] = (char) g_rand_int_range (rand, 0, 256);
+    }
+}
+
+static GByteArray *
+build_stream (void)
+{
+    GByteArray *stream;
+    GRand *rand;
+    guint i;
+
+    rand = g_rand_new_with_seed (1234);
+    stream = g_byte_array_new ();
+    for (i = 0; i < N_PACKETS; i++) {
+        char packet[PACKET_LEN + 2];
+        char frame[(PACKET_LEN + 2) * 2 + 1];
+        gsize frame_len;
+
+        fill_packet (rand, packet, PACKET_LEN);
+        frame_len = dm_encapsulate_buffer (packet, PACKET_LEN, sizeof (packet), frame, sizeof (frame));
+        g_assert_cmpuint (frame_len, >, 0);
+        g_byte_array_append (stream, (const guint8 *) frame, frame_len);
+    }
+    g_rand_free (rand);
+    return stream;
+}
+
+/*****************************************************************************/
+
+static void
+test_perf_crc16 (void)
+{
+    char buffer[PACKET_LEN * N_PACKETS];
+    GRand *rand;
+    guint rounds;
+    guint r;
+    guint16 crc = 0;
+
+    rand = g_rand_new_with_seed (1234);
+    fill_packet (rand, buffer, sizeof (buffer));
+    g_rand_free (rand);
+
+    rounds = n_rounds ();
+    g_test_timer_start ();
+    for (r = 0; r < rounds; r++) {
+        if (r == 0)
+            crc = dm_crc16 (buffer, sizeof (buffer));
+        else
+            g_assert_cmphex (dm_crc16 (buffer, sizeof (buffer)), ==, crc);
+    }
+    report_rate ("crc16", (gsize) rounds * sizeof (buffer), g_test_timer_elapsed ());
+}
+
+static void
+test_perf_escape (void)
+{
+    char buffer[PACKET_LEN * N_PACKETS];
+    char *escaped;
+    char *unescaped;
+    GRand *rand;
+    guint rounds;
+    guint r;
+    gsize escaped_len = 0;
+    gsize unescaped_len = 0;
+
+    rand = g_rand_new_with_seed (1234);
+    fill_packet (rand, buffer, sizeof (buffer));
+    g_rand_free (rand);
+
+    escaped = g_malloc (sizeof (buffer) * 2 + 1);
+    unescaped = g_malloc (sizeof (buffer) * 2 + 1);
+
+    rounds = n_rounds ();
+    g_test_timer_start ();
+    for (r = 0; r < rounds; r++)
+        escaped_len = dm_escape (buffer, sizeof (buffer), escaped, sizeof (buffer) * 2 + 1);
+    report_rate ("escape", (gsize) rounds * sizeof (buffer), g_test_timer_elapsed ());
+    g_assert_cmpuint (escaped_len, >, sizeof (buffer));
+
+    g_test_timer_start ();
+    for (r = 0; r < rounds; r++) {
+        qcdmbool escaping = FALSE;
+
+        unescaped_len = dm_unescape (escaped, escaped_len, unescaped, sizeof (buffer) * 2 + 1, &escaping);
+    }
+    report_rate ("unescape", (gsize) rounds * escaped_len, g_test_timer_elapsed ());
+    g_assert_cmpuint (unescaped_len, ==, sizeof (buffer));
+    g_assert (memcmp (buffer, unescaped, sizeof (buffer)) == 0);
+
+    g_free (escaped);
+    g_free (unescaped);
+}
+
+static void
+count_frame (const char *packet,
+             size_t      len,
+             void       *user_data)
+{
+    g_assert_cmpuint (len, ==, PACKET_LEN);
+    (*(guint *) user_data)++;
+}
+
+static void
+test_perf_decapsulate_buffer (void)
+{
+    GByteArray *stream;
+    char packet[(PACKET_LEN + 2) * 2];
+    guint rounds;
+    guint r;
+
+    stream = build_stream ();
+
+    /* One packet at a time, as done when replying to commands */
+    rounds = n_rounds ();
+    g_test_timer_start ();
+    for (r = 0; r < rounds; r++) {
+        gsize offset = 0;
+        guint n = 0;
+
+        while (offset < stream->len) {
+            gsize decap_len = 0;
+            gsize used = 0;
+            qcdmbool more = FALSE;
+
+            g_assert (dm_decapsulate_buffer ((const char *) stream->data + offset, stream->len - offset,
+                                             packet, sizeof (packet),
+                                             &decap_len, &used, &more));
+            g_assert (!more);
+            offset += used;
+            n++;
+        }
+        g_assert_cmpuint (n, ==, N_PACKETS);
+    }
+    report_rate ("decapsulate-buffer", (gsize) rounds * stream->len, g_test_timer_elapsed ());
+
+    g_byte_array_unref (stream);
+}
+
+static void
+test_perf_decapsulate_frames (void)
+{
+    GByteArray *stream;
+    char packet[(PACKET_LEN + 2) * 2];
+    guint rounds;
+    guint r;
+
+    stream = build_stream ();
+
+    rounds = n_rounds ();
+    g_test_timer_start ();
+    for (r = 0; r < rounds; r++) {
+        gsize used;
+        gsize n_invalid = 0;
+        guint n = 0;
+
+        used = dm_decapsulate_frames ((const char *) stream->data, stream->len,
+                                      packet, sizeof (packet),
+                                      count_frame, &n, &n_invalid);
+        g_assert_cmpuint (used, ==, stream->len);
+        g_assert_cmpuint (n, ==, N_PACKETS);
+        g_assert_cmpuint (n_invalid, ==, 0);
+    }
+    report_rate ("decapsulate-frames", (gsize) rounds * stream->len, g_test_timer_elapsed ());
+
+    g_byte_array_unref (stream);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/QCDM/perf/crc16",              test_perf_crc16);
+    g_test_add_func ("/QCDM/perf/escape",             test_perf_escape);
+    g_test_add_func ("/QCDM/perf/decapsulate-buffer", test_perf_decapsulate_buffer);
+    g_test_add_func ("/QCDM/perf/decapsulate-frames", test_perf_decapsulate_frames);
+
+    return g_test_run ();
+}
@@ -21,6 +21,7 @@
 #include "test-qcdm-result.h"
 #include "result.h"
 #include "result-private.h"
+#include "errors.h"
 
 #define TEST_TAG "test"
 
@@ -90,3 +91,95 @@ test_result_uint8_array (void *f, void *data)
 
     qcdm_result_unref (result);
 }
+
+enum {
+    TEST_FIELD_STRING = 0,
+    TEST_FIELD_U8,
+    TEST_FIELD_U16_ARRAY,
+    TEST_N_FIELDS
+};
+
+static const char *const test_keys[TEST_N_FIELDS] = {
+    [TEST_FIELD_STRING]    = "string",
+    [TEST_FIELD_U8]        = "u8",
+    [TEST_FIELD_U16_ARRAY] = "u16-array",
+};
+
+void
+test_result_fields (void *f, void *data)
+{
+    uint16_t array[] = { 0x1001, 0x1002, 0xFFFF };
+    const uint16_t *tmp_array = NULL;
+    size_t tmp_len = 0;
+    const char *str = NULL;
+    guint8 num = 0;
+    guint32 num32 = 0;
+    QcdmResult *result;
+
+    result = qcdm_result_new_with_fields (test_keys, TEST_N_FIELDS, 32);
+
+    /* Unset fields are not found */
+    g_assert_cmpint (qcdm_result_get_field_u8 (result, TEST_FIELD_U8, &num), ==, -QCDM_ERROR_VALUE_NOT_FOUND);
+
+    qcdm_result_set_string (result, TEST_FIELD_STRING, "foo");
+    qcdm_result_set_u8 (result, TEST_FIELD_U8, 0x1E);
+    qcdm_result_set_u16_array (result, TEST_FIELD_U16_ARRAY, array, G_N_ELEMENTS (array));
+
+    g_assert_cmpint (qcdm_result_get_field_string (result, TEST_FIELD_STRING, &str), ==, 0);
+    g_assert_cmpstr (str, ==, "foo");
+    g_assert_cmpint (qcdm_result_get_field_u8 (result, TEST_FIELD_U8, &num), ==, 0);
+    g_assert_cmpint (num, ==, 0x1E);
+    g_assert_cmpint (qcdm_result_get_field_u16_array (result, TEST_FIELD_U16_ARRAY, &tmp_array, &tmp_len), ==, 0);
+    g_assert_cmpint (tmp_len, ==, G_N_ELEMENTS (array));
+    g_assert_cmpint (memcmp (tmp_array, array, sizeof (array)), ==, 0);
+
+    /* Out of range */
+    g_assert_cmpint (qcdm_result_get_field_u32 (result, TEST_N_FIELDS, &num32), ==, -QCDM_ERROR_VALUE_NOT_FOUND);
+
+    /* Same values through the string keys */
+    str = NULL;
+    g_assert_cmpint (qcdm_result_get_string (result, "string", &str), ==, 0);
+    g_assert_cmpstr (str, ==, "foo");
+    num = 0;
+    g_assert_cmpint (qcdm_result_get_u8 (result, "u8", &num), ==, 0);
+    g_assert_cmpint (num, ==, 0x1E);
+    g_assert_cmpint (qcdm_result_get_u8 (result, "unknown", &num), ==, -QCDM_ERROR_VALUE_NOT_FOUND);
+
+    /* Setting again replaces the value */
+    qcdm_result_set_string (result, TEST_FIELD_STRING, "barbaz");
+    str = NULL;
+    g_assert_cmpint (qcdm_result_get_field_string (result, TEST_FIELD_STRING, &str), ==, 0);
+    g_assert_cmpstr (str, ==, "barbaz");
+
+    qcdm_result_unref (result);
+}
+
+void
+test_result_fields_overflow (void *f, void *data)
+{
+    const char *long_str = "a string longer than the data reserved for the result";
+    const char *str = NULL;
+    QcdmResult *result;
+    guint i;
+
+    /* Values not fitting in the reserved data are still stored */
+    result = qcdm_result_new_with_fields (test_keys, TEST_N_FIELDS, 8);
+    for (i = 0; i < 3; i++) {
+        qcdm_result_set_string (result, TEST_FIELD_STRING, i % 2 ? "short" : long_str);
+        str = NULL;
+        g_assert_cmpint (qcdm_result_get_field_string (result, TEST_FIELD_STRING, &str), ==, 0);
+        g_assert_cmpstr (str, ==, i % 2 ? "short" : long_str);
+    }
+    qcdm_result_unref (result);
+
+    /* Same for results without fields known in advance */
+    result = qcdm_result_new ();
+    for (i = 0; i < TEST_N_FIELDS; i++)
+        qcdm_result_add_string (result, test_keys[i], long_str);
+    for (i = 0; i < TEST_N_FIELDS; i++) {
+        str = NULL;
+        g_assert_cmpint (qcdm_result_get_string (result, test_keys[i], &str), ==, 0);
+        g_assert_cmpstr (str, ==, long_str);
+    }
+    qcdm_result_unref (result);
+}
@@ -104,3 +104,57 @@ test_utils_decapsulate_sierra_cns (void *f, void *data)
     g_assert (success == FALSE);
 }
 
+
+typedef struct {
+    guint n_frames;
+    gsize last_len;
+} FramesContext;
+
+static void
+frame_cb (const char *packet, size_t len, void *user_data)
+{
+    FramesContext *ctx = user_data;
+
+    ctx->n_frames++;
+    ctx->last_len = len;
+}
+
+void
+test_utils_decapsulate_frames (void *f, void *data)
+{
+    GByteArray *stream;
+    FramesContext ctx = { 0, 0 };
+    char outbuf[512];
+    gsize used;
+    gsize n_invalid = 0;
+    guint i;
+
+    /* Valid frames, with an empty one, a corrupt one and a partial one at the end */
+    stream = g_byte_array_new ();
+    for (i = 0; i < 3; i++)
+        g_byte_array_append (stream, (const guint8 *) decap_inbuf, sizeof (decap_inbuf));
+    g_byte_array_append (stream, (const guint8 *) "\x7e", 1);
+    g_byte_array_append (stream, (const guint8 *) cns_inbuf, sizeof (cns_inbuf));
+    g_byte_array_append (stream, (const guint8 *) encap_outbuf, sizeof (encap_outbuf));
+    g_byte_array_append (stream, (const guint8 *) decap_inbuf, 10);
+
+    used = dm_decapsulate_frames ((const char *) stream->data, stream->len,
+                                  outbuf, sizeof (outbuf),
+                                  frame_cb, &ctx, &n_invalid);
+    g_assert_cmpuint (used, ==, stream->len - 10);
+    g_assert_cmpuint (ctx.n_frames, ==, 4);
+    g_assert_cmpuint (ctx.last_len, ==, 4);
+    g_assert_cmpuint (n_invalid, ==, 1);
+    g_assert (memcmp (outbuf, "\x4b\x05\x08\x00", 4) == 0);
+
+    /* Frames not fitting in the output buffer are invalid */
+    ctx.n_frames = 0;
+    used = dm_decapsulate_frames (decap_inbuf, sizeof (decap_inbuf),
+                                  outbuf, 100,
+                                  frame_cb, &ctx, &n_invalid);
+    g_assert_cmpuint (used, ==, sizeof (decap_inbuf));
+    g_assert_cmpuint (ctx.n_frames, ==, 0);
+    g_assert_cmpuint (n_invalid, ==, 1);
+
+    g_byte_array_unref (stream);
+}
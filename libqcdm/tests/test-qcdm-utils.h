@@ -24,5 +24,7 @@ void test_utils_encapsulate_buffer (void *f, void *data);
 
 void test_utils_decapsulate_sierra_cns (void *f, void *data);
 
+void test_utils_decapsulate_frames (void *f, void *data);
+
 #endif  /* TEST_QCDM_UTILS_H */
 
@@ -22,6 +22,7 @@
 #include "test-qcdm-escaping.h"
 #include "test-qcdm-com.h"
 #include "test-qcdm-result.h"
+#include "test-qcdm-log-stream.h"
 #include "test-qcdm-utils.h"
 
 typedef struct {
@@ -86,10 +87,16 @@ int main (int argc, char **argv)
     g_test_suite_add (suite, TESTCASE (test_utils_decapsulate_buffer, NULL));
     g_test_suite_add (suite, TESTCASE (test_utils_encapsulate_buffer, NULL));
     g_test_suite_add (suite, TESTCASE (test_utils_decapsulate_sierra_cns, NULL));
+    g_test_suite_add (suite, TESTCASE (test_utils_decapsulate_frames, NULL));
     g_test_suite_add (suite, TESTCASE (test_result_string, NULL));
     g_test_suite_add (suite, TESTCASE (test_result_uint32, NULL));
     g_test_suite_add (suite, TESTCASE (test_result_uint8, NULL));
     g_test_suite_add (suite, TESTCASE (test_result_uint8_array, NULL));
+    g_test_suite_add (suite, TESTCASE (test_result_fields, NULL));
+    g_test_suite_add (suite, TESTCASE (test_result_fields_overflow, NULL));
+    g_test_suite_add (suite, TESTCASE (test_log_stream_pilot_sets, NULL));
+    g_test_suite_add (suite, TESTCASE (test_log_stream_invalid, NULL));
+    g_test_suite_add (suite, TESTCASE (test_log_stream_codes, NULL));
 
     /* Live tests */
     if (port) {
@@ -83,6 +83,8 @@ connect_3gpp_connect_ready (MMBaseModem *modem,
 
     ctx = g_task_get_task_data (task);
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (g_task_get_source_object (task)), "dial");
+
     config = mm_bearer_ip_config_new ();
 
     mm_bearer_ip_config_set_method (config, MM_BEARER_IP_METHOD_DHCP);
@@ -116,6 +118,8 @@ connect_3gpp_apnsettings_ready (MMBaseModem *modem,
 
     ctx = g_task_get_task_data (task);
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (g_task_get_source_object (task)), "apn-settings");
+
     mm_base_modem_at_command_full (ctx->modem,
                                    ctx->primary,
                                    "%DPDNACT=1",
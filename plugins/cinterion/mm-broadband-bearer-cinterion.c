@@ -425,6 +425,7 @@ dial_3gpp_context_step (GTask *task)
     case DIAL_3GPP_CONTEXT_STEP_START_SWWAN: {
         gchar *command;
 
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "auth");
         mm_obj_dbg (self, "dial step %u/%u: starting SWWAN interface %u connection...",
                     ctx->step, DIAL_3GPP_CONTEXT_STEP_LAST, usb_interface_configs[ctx->usb_interface_config_index].swwan_index);
         command = g_strdup_printf ("^SWWAN=1,%u,%u",
@@ -444,6 +445,7 @@ dial_3gpp_context_step (GTask *task)
     }
 
     case DIAL_3GPP_CONTEXT_STEP_VALIDATE_CONNECTION:
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "swwan");
         mm_obj_dbg (self, "dial step %u/%u: checking SWWAN interface %u status...",
                     ctx->step, DIAL_3GPP_CONTEXT_STEP_LAST, usb_interface_configs[ctx->usb_interface_config_index].swwan_index);
         load_connection_status_by_cid (ctx->self,
@@ -436,6 +436,8 @@ connect_3gpp_context_step (GTask *task)
         }
 
         /* Check if connected */
+        if (!ctx->check_count)
+            mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "ndisdup");
         ctx->check_count++;
         mm_base_modem_at_command_full (ctx->modem,
                                        ctx->primary,
@@ -449,6 +451,7 @@ connect_3gpp_context_step (GTask *task)
         return;
 
     case CONNECT_3GPP_CONTEXT_STEP_IP_CONFIG:
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "connection-check");
         mm_base_modem_at_command_full (ctx->modem,
                                        ctx->primary,
                                        "^DHCP?",
@@ -461,6 +464,8 @@ connect_3gpp_context_step (GTask *task)
         return;
 
     case CONNECT_3GPP_CONTEXT_STEP_LAST:
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "ip-config");
+
         /* Clear context */
         self->priv->connect_pending = NULL;
 
@@ -620,6 +620,10 @@ activate_ready (MMBaseModem            *modem,
     /* Track again */
     self->priv->connect_pending = task;
 
+    /* Activation requested, the remaining time until the unsolicited
+     * message is received is reported in the "dial" step */
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "activation");
+
     /* We will now setup a timeout and keep the context in the bearer's private.
      * Reports of modem being connected will arrive via unsolicited messages.
      * This timeout should be long enough. Actually... ideally should never get
@@ -685,6 +689,8 @@ authenticate_ready (MMBaseModem  *modem,
         return;
     }
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "auth");
+
     /* The unsolicited response to %IPDPACT may come before the OK does.
      * We will keep the connection context in the bearer private data so
      * that it is accessible from the unsolicited message handler. Note
@@ -791,6 +797,7 @@ deactivate_ready (MMBaseModem  *modem,
      */
     mm_base_modem_at_command_full_finish (modem, res, NULL);
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (g_task_get_source_object (task)), "deactivate");
     authenticate (task);
 }
 
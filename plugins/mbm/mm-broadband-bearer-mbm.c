@@ -287,6 +287,8 @@ activate_ready (MMBaseModem          *modem,
 
     ctx = g_task_get_task_data (task);
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "activation");
+
     /* No unsolicited E2NAP status yet; wait for it and periodically poll
      * to handle very old F3507g/MD300 firmware that may not send E2NAP. */
     self->priv->connect_pending = task;
@@ -307,6 +309,8 @@ activate (GTask *task)
     self = g_task_get_source_object (task);
     ctx  = g_task_get_task_data     (task);
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "auth");
+
     /* The unsolicited response to ENAP may come before the OK does.
      * We will keep the connection context in the bearer private data so
      * that it is accessible from the unsolicited message handler. */
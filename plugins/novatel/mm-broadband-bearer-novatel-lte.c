@@ -206,6 +206,7 @@ connect_3gpp_qmistatus_ready (MMBaseModem *modem,
         MMBearerIpConfig *config;
 
         mm_obj_dbg (self, "connected");
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "connection-check");
         config = mm_bearer_ip_config_new ();
         mm_bearer_ip_config_set_method (config, MM_BEARER_IP_METHOD_DHCP);
         g_task_return_pointer (
@@ -278,6 +279,8 @@ connect_3gpp_qmiconnect_ready (MMBaseModem *modem,
         return;
     }
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (g_task_get_source_object (task)), "dial");
+
     /*
      * The connection takes a bit of time to set up, but there's no
      * asynchronous notification from the modem when this has
@@ -430,7 +430,7 @@ nw_snapshot_old_ready (MMPortSerialQcdm *port,
     }
 
     /* Success */
-    qcdm_result_get_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_HDR_REV, &hdr_revision);
+    qcdm_result_get_field_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_HDR_REV, &hdr_revision);
     qcdm_result_unref (result);
 
     g_task_return_int (task, (gint) hdr_revision);
@@ -464,7 +464,7 @@ nw_snapshot_new_ready (MMPortSerialQcdm *port,
     g_byte_array_unref (response);
     if (result) {
         /* Success */
-        qcdm_result_get_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_ITEM_HDR_REV, &hdr_revision);
+        qcdm_result_get_field_u8 (result, QCDM_CMD_NW_SUBSYS_MODEM_SNAPSHOT_CDMA_FIELD_HDR_REV, &hdr_revision);
         qcdm_result_unref (result);
 
         g_task_return_int (task, (gint) hdr_revision);
@@ -1203,9 +1203,9 @@ parse_modem_eri (DetailedRegistrationStateContext *ctx, QcdmResult *result)
     MMModemCdmaRegistrationState new_state;
     guint8 indicator_id = 0, icon_id = 0, icon_mode = 0;
 
-    qcdm_result_get_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_ITEM_INDICATOR_ID, &indicator_id);
-    qcdm_result_get_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_ITEM_ICON_ID, &icon_id);
-    qcdm_result_get_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_ITEM_ICON_MODE, &icon_mode);
+    qcdm_result_get_field_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_FIELD_INDICATOR_ID, &indicator_id);
+    qcdm_result_get_field_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_FIELD_ICON_ID, &icon_id);
+    qcdm_result_get_field_u8 (result, QCDM_CMD_NW_SUBSYS_ERI_FIELD_ICON_MODE, &icon_mode);
 
     /* We use the "Icon ID" (also called the "Icon Index") because if it is 1,
      * the device is never roaming.  Any operator-defined IDs (greater than 2)
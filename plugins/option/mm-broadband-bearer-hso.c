@@ -405,6 +405,7 @@ activate_ready (MMBaseModem          *modem,
 
     /* Track the task again */
     self->priv->connect_pending = task;
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "activation");
 
     /* We will now setup a timeout and keep the context in the bearer's private.
      * Reports of modem being connected will arrive via unsolicited messages.
@@ -455,6 +456,7 @@ authenticate_ready (MMBaseModem  *modem,
 
     /* Store which auth command worked, for next attempts */
     self->priv->auth_idx = ctx->auth_idx;
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "auth");
 
     /* The unsolicited response to AT_OWANCALL may come before the OK does.
      * We will keep the connection context in the bearer private data so
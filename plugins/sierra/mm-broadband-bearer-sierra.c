@@ -316,6 +316,7 @@ dial_3gpp_context_step (GTask *task)
         return;
 
     case DIAL_3GPP_STEP_AUTHENTICATE:
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "ps-attach");
         if (!MM_IS_PORT_SERIAL_AT (ctx->data)) {
             gchar *command;
             const gchar *user;
@@ -398,6 +399,7 @@ dial_3gpp_context_step (GTask *task)
         /* fall through */
 
     case DIAL_3GPP_STEP_CONNECT:
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "auth");
         /* We need a net or AT data port */
         ctx->data = mm_base_modem_get_best_data_port (ctx->modem, MM_PORT_TYPE_NET);
         if (ctx->data) {
@@ -432,6 +432,8 @@ test_cedata (GTask *task)
     self = g_task_get_source_object (task);
     ctx  = g_task_get_task_data (task);
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "auth");
+
     /* We don't need to test for +UCEDATA if we're not using CDC-ECM or if we
        have tested before. Instead, we jump right to the activation. */
     if (self->priv->profile != MM_UBLOX_USB_PROFILE_ECM || self->priv->cedata != FEATURE_SUPPORT_UNKNOWN) {
@@ -63,11 +63,13 @@ hup_cb (gpointer user_data)
     mm_info ("Reloading log file...");
     mm_log_shutdown ();
     if (!mm_log_setup (mm_context_get_log_level (),
-       mm_context_get_log_file (),
-       mm_context_get_log_timestamps (),
-       mm_context_get_log_relative_timestamps (),
-       mm_context_get_debug (),
-       &err)) {
+                       mm_context_get_log_file (),
+                       mm_context_get_log_journal (),
+                       mm_context_get_log_timestamps (),
+                       mm_context_get_log_relative_timestamps (),
+                       &err) ||
+        (mm_context_get_log_async () &&
+         !mm_log_setup_async (mm_context_get_log_async_drop (), &err))) {
             g_warning ("Failed to set up logging: %s", err->message);
             g_error_free (err);
     }
@@ -185,7 +187,9 @@ main (int argc, char *argv[])
                        mm_context_get_log_journal (),
                        mm_context_get_log_timestamps (),
                        mm_context_get_log_relative_timestamps (),
-                       &error)) {
+                       &error) ||
+        (mm_context_get_log_async () &&
+         !mm_log_setup_async (mm_context_get_log_async_drop (), &error))) {
         g_warning ("failed to set up logging: %s", error->message);
         g_error_free (error);
         exit (1);
@@ -38,6 +38,9 @@
 #include "mm-log-object.h"
 #include "mm-modem-helpers.h"
 #include "mm-bearer-stats.h"
+#include "mm-netdev-stats.h"
+#include "mm-link-monitor.h"
+#include "mm-connection-timings.h"
 
 /* We require up to 20s to get a proper IP when using PPP */
 #define BEARER_IP_TIMEOUT_DEFAULT 20
@@ -46,9 +49,11 @@
 
 #define BEARER_STATS_UPDATE_TIMEOUT 30
 
-/* Initial connectivity check after 30s, then each 5s */
+/* Initial connectivity check after 30s, then each 5s; or each 5 minutes if
+ * the implementation gets notified about disconnections */
 #define BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT 30
 #define BEARER_CONNECTION_MONITOR_TIMEOUT          5
+#define BEARER_CONNECTION_MONITOR_EVENTS_TIMEOUT 300
 
 static void log_object_iface_init (MMLogObjectInterface *iface);
 
@@ -100,10 +105,20 @@ struct _MMBaseBearerPrivate {
     /* handler id for the disconnect + cancel connect request */
     gulong disconnect_signal_handler;
 
+    /* Scheduler running the connection monitoring and stats jobs */
+    MMPollScheduler *poll_scheduler;
+
     /* Connection status monitoring */
     guint connection_monitor_id;
+    /* Interval of the periodic checks, 0 until the initial one is done */
+    guint connection_monitor_timeout;
     /* Flag to specify whether connection monitoring is supported or not */
     gboolean load_connection_status_unsupported;
+    /* Whether disconnections are notified by the device for the ongoing
+     * connection (indications, URCs...) */
+    gboolean connection_events_available;
+    /* Link monitor watch of the data interface */
+    guint link_monitor_id;
 
     /*-- 3GPP specific --*/
     guint deferred_3gpp_unregistration_id;
@@ -128,6 +143,17 @@ struct _MMBaseBearerPrivate {
     GTimer *duration_timer;
     /* Flag to specify whether reloading stats is supported or not */
     gboolean reload_stats_unsupported;
+    /* Monotonic time of the last rx/tx bytes update, to compute rates */
+    gint64 stats_timestamp;
+    /* Kernel interface counters watch, and last raw counter values */
+    guint netdev_stats_id;
+    gchar *netdev_ifname;
+    gboolean netdev_stats_used;
+    guint64 netdev_rx_bytes;
+    guint64 netdev_tx_bytes;
+
+    /* Step timings of the ongoing connection attempt */
+    MMConnectionTimings *connection_timings;
 };
 
 /*****************************************************************************/
@@ -155,13 +181,27 @@ mm_base_bearer_export (MMBaseBearer *self)
 
 /*****************************************************************************/
 
+static MMPollScheduler *
+peek_poll_scheduler (MMBaseBearer *self)
+{
+    if (!self->priv->poll_scheduler)
+        self->priv->poll_scheduler = g_object_ref (mm_base_modem_peek_poll_scheduler (self->priv->modem));
+    return self->priv->poll_scheduler;
+}
+
 static void
 connection_monitor_stop (MMBaseBearer *self)
 {
     if (self->priv->connection_monitor_id) {
-        g_source_remove (self->priv->connection_monitor_id);
+        mm_poll_scheduler_remove (self->priv->poll_scheduler, self->priv->connection_monitor_id);
         self->priv->connection_monitor_id = 0;
     }
+    self->priv->connection_monitor_timeout = 0;
+
+    if (self->priv->link_monitor_id) {
+        mm_link_monitor_unwatch (mm_link_monitor_get (), self->priv->link_monitor_id);
+        self->priv->link_monitor_id = 0;
+    }
 }
 
 static void
@@ -207,6 +247,20 @@ connection_monitor_cb (MMBaseBearer *self)
     return G_SOURCE_CONTINUE;
 }
 
+static void
+connection_monitor_schedule_periodic (MMBaseBearer *self)
+{
+    self->priv->connection_monitor_timeout = (self->priv->connection_events_available ?
+                                              BEARER_CONNECTION_MONITOR_EVENTS_TIMEOUT :
+                                              BEARER_CONNECTION_MONITOR_TIMEOUT);
+    self->priv->connection_monitor_id = mm_poll_scheduler_add (peek_poll_scheduler (self),
+                                                               "connection-monitor",
+                                                               self->priv->connection_monitor_timeout,
+                                                               MM_POLL_JOB_FLAG_NONE,
+                                                               (GSourceFunc) connection_monitor_cb,
+                                                               self);
+}
+
 static gboolean
 initial_connection_monitor_cb (MMBaseBearer *self)
 {
@@ -216,18 +270,34 @@ initial_connection_monitor_cb (MMBaseBearer *self)
             (GAsyncReadyCallback)load_connection_status_ready,
             NULL);
 
-    /* Add new monitor timeout at a higher rate */
-    self->priv->connection_monitor_id = g_timeout_add_seconds (BEARER_CONNECTION_MONITOR_TIMEOUT,
-                                                               (GSourceFunc) connection_monitor_cb,
-                                                               self);
+    /* Add new monitor timeout at a higher rate, unless monitoring was
+     * stopped right away */
+    if (self->priv->connection_monitor_id)
+        connection_monitor_schedule_periodic (self);
 
     /* Remove the initial connection monitor timeout as we added a new one */
     return G_SOURCE_REMOVE;
 }
 
+static void
+link_changed_cb (const gchar  *ifname,
+                 gboolean      link_up,
+                 MMBaseBearer *self)
+{
+    /* Not all drivers report carrier changes, and a link going down doesn't
+     * always mean the connection is gone, so just check right away */
+    if (link_up || self->priv->status != MM_BEARER_STATUS_CONNECTED)
+        return;
+
+    mm_obj_dbg (self, "data interface %s link is down: checking connection status", ifname);
+    connection_monitor_cb (self);
+}
+
 static void
 connection_monitor_start (MMBaseBearer *self)
 {
+    const gchar *ifname;
+
     /* If not implemented, don't schedule anything */
     if (!MM_BASE_BEARER_GET_CLASS (self)->load_connection_status ||
         !MM_BASE_BEARER_GET_CLASS (self)->load_connection_status_finish)
@@ -238,9 +308,38 @@ connection_monitor_start (MMBaseBearer *self)
 
     /* Schedule initial check */
     g_assert (!self->priv->connection_monitor_id);
-    self->priv->connection_monitor_id = g_timeout_add_seconds (BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT,
+    self->priv->connection_monitor_id = mm_poll_scheduler_add (peek_poll_scheduler (self),
+                                                               "connection-monitor",
+                                                               BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT,
+                                                               MM_POLL_JOB_FLAG_NONE,
                                                                (GSourceFunc) initial_connection_monitor_cb,
                                                                self);
+
+    /* Check as soon as the data interface link goes down */
+    g_assert (!self->priv->link_monitor_id);
+    ifname = mm_gdbus_bearer_get_interface (MM_GDBUS_BEARER (self));
+    if (ifname)
+        self->priv->link_monitor_id = mm_link_monitor_watch (mm_link_monitor_get (),
+                                                             ifname,
+                                                             (MMLinkMonitorFunc) link_changed_cb,
+                                                             self);
+}
+
+void
+mm_base_bearer_set_connection_events_available (MMBaseBearer *self,
+                                                gboolean      available)
+{
+    if (self->priv->connection_events_available == available)
+        return;
+
+    mm_obj_dbg (self, "disconnections %s notified by the device", available ? "are" : "are no longer");
+    self->priv->connection_events_available = available;
+
+    /* Reschedule the periodic checks, if already running */
+    if (self->priv->connection_monitor_id && self->priv->connection_monitor_timeout) {
+        mm_poll_scheduler_remove (self->priv->poll_scheduler, self->priv->connection_monitor_id);
+        connection_monitor_schedule_periodic (self);
+    }
 }
 
 /*****************************************************************************/
@@ -259,9 +358,22 @@ bearer_reset_ongoing_interface_stats (MMBaseBearer *self)
     mm_bearer_stats_set_duration (self->priv->stats, 0);
     mm_bearer_stats_set_tx_bytes (self->priv->stats, 0);
     mm_bearer_stats_set_rx_bytes (self->priv->stats, 0);
+    mm_bearer_stats_set_rx_rate (self->priv->stats, 0);
+    mm_bearer_stats_set_tx_rate (self->priv->stats, 0);
+    self->priv->stats_timestamp = 0;
     bearer_update_interface_stats (self);
 }
 
+static guint64
+bearer_compute_rate (guint64 previous,
+                     guint64 current,
+                     gint64  elapsed_usec)
+{
+    if (current <= previous)
+        return 0;
+    return (guint64) (((gdouble) (current - previous) * G_USEC_PER_SEC) / elapsed_usec);
+}
+
 static void
 bearer_set_ongoing_interface_stats (MMBaseBearer *self,
                                     guint         duration,
@@ -285,6 +397,31 @@ bearer_set_ongoing_interface_stats (MMBaseBearer *self,
         }
     }
 
+    /* Rates are averaged since the previous byte counters update */
+    if (rx_bytes || tx_bytes) {
+        gint64 now;
+
+        now = g_get_monotonic_time ();
+        if (self->priv->stats_timestamp && now > self->priv->stats_timestamp) {
+            guint64 rx_rate;
+            guint64 tx_rate;
+
+            rx_rate = bearer_compute_rate (mm_bearer_stats_get_rx_bytes (self->priv->stats),
+                                           rx_bytes,
+                                           now - self->priv->stats_timestamp);
+            tx_rate = bearer_compute_rate (mm_bearer_stats_get_tx_bytes (self->priv->stats),
+                                           tx_bytes,
+                                           now - self->priv->stats_timestamp);
+            if (rx_rate != mm_bearer_stats_get_rx_rate (self->priv->stats) ||
+                tx_rate != mm_bearer_stats_get_tx_rate (self->priv->stats)) {
+                mm_bearer_stats_set_rx_rate (self->priv->stats, rx_rate);
+                mm_bearer_stats_set_tx_rate (self->priv->stats, tx_rate);
+                n_updates++;
+            }
+        }
+        self->priv->stats_timestamp = now;
+    }
+
     if (rx_bytes) {
         gint64 delta_rx_bytes;
 
@@ -313,9 +450,55 @@ bearer_set_ongoing_interface_stats (MMBaseBearer *self,
         bearer_update_interface_stats (self);
 }
 
+static void
+netdev_stats_cb (const gchar  *ifname,
+                 guint64       rx_bytes,
+                 guint64       tx_bytes,
+                 MMBaseBearer *self)
+{
+    guint64 ongoing_rx_bytes;
+    guint64 ongoing_tx_bytes;
+
+    /* Accumulate the increase since the last read; if the counters went
+     * backwards the interface was reset, so they're all new traffic */
+    ongoing_rx_bytes = mm_bearer_stats_get_rx_bytes (self->priv->stats) +
+        ((rx_bytes >= self->priv->netdev_rx_bytes) ? (rx_bytes - self->priv->netdev_rx_bytes) : rx_bytes);
+    ongoing_tx_bytes = mm_bearer_stats_get_tx_bytes (self->priv->stats) +
+        ((tx_bytes >= self->priv->netdev_tx_bytes) ? (tx_bytes - self->priv->netdev_tx_bytes) : tx_bytes);
+    self->priv->netdev_rx_bytes = rx_bytes;
+    self->priv->netdev_tx_bytes = tx_bytes;
+
+    bearer_set_ongoing_interface_stats (self,
+                                        (guint32) g_timer_elapsed (self->priv->duration_timer, NULL),
+                                        ongoing_rx_bytes,
+                                        ongoing_tx_bytes);
+}
+
 static void
 bearer_stats_stop (MMBaseBearer *self)
 {
+    if (self->priv->netdev_stats_id) {
+        MMNetdevStats *netdev_stats;
+        guint64        rx_bytes;
+        guint64        tx_bytes;
+
+        /* Last update before the interface goes away */
+        netdev_stats = mm_netdev_stats_get ();
+        if (self->priv->duration_timer &&
+            mm_netdev_stats_read (netdev_stats, self->priv->netdev_ifname, &rx_bytes, &tx_bytes, NULL))
+            netdev_stats_cb (self->priv->netdev_ifname, rx_bytes, tx_bytes, self);
+        mm_netdev_stats_unwatch (netdev_stats, self->priv->netdev_stats_id);
+        self->priv->netdev_stats_id = 0;
+        g_clear_pointer (&self->priv->netdev_ifname, g_free);
+    }
+
+    if (mm_bearer_stats_get_rx_rate (self->priv->stats) || mm_bearer_stats_get_tx_rate (self->priv->stats)) {
+        mm_bearer_stats_set_rx_rate (self->priv->stats, 0);
+        mm_bearer_stats_set_tx_rate (self->priv->stats, 0);
+        bearer_update_interface_stats (self);
+    }
+    self->priv->stats_timestamp = 0;
+
     if (self->priv->duration_timer) {
         bearer_set_ongoing_interface_stats (self,
                                             (guint64) g_timer_elapsed (self->priv->duration_timer, NULL),
@@ -326,7 +509,7 @@ bearer_stats_stop (MMBaseBearer *self)
     }
 
     if (self->priv->stats_update_id) {
-        g_source_remove (self->priv->stats_update_id);
+        mm_poll_scheduler_remove (self->priv->poll_scheduler, self->priv->stats_update_id);
         self->priv->stats_update_id = 0;
     }
 }
@@ -370,8 +553,10 @@ stats_update_cb (MMBaseBearer *self)
     if (self->priv->status != MM_BEARER_STATUS_CONNECTED)
         return G_SOURCE_CONTINUE;
 
-    /* If the implementation knows how to update stat values, run it */
-    if (!self->priv->reload_stats_unsupported &&
+    /* If the implementation knows how to update stat values, run it, unless
+     * the kernel interface counters are already being used */
+    if (!self->priv->netdev_stats_id &&
+        !self->priv->reload_stats_unsupported &&
         MM_BASE_BEARER_GET_CLASS (self)->reload_stats &&
         MM_BASE_BEARER_GET_CLASS (self)->reload_stats_finish) {
         MM_BASE_BEARER_GET_CLASS (self)->reload_stats (
@@ -392,13 +577,46 @@ stats_update_cb (MMBaseBearer *self)
 static void
 bearer_stats_start (MMBaseBearer *self)
 {
+    const gchar *ifname;
+
     /* Start duration timer */
     g_assert (!self->priv->duration_timer);
     self->priv->duration_timer = g_timer_new ();
 
+    /* Prefer the kernel counters of the data interface, if available; the
+     * firmware counters are only queried as fallback */
+    g_assert (!self->priv->netdev_stats_id);
+    self->priv->netdev_stats_used = FALSE;
+    ifname = mm_gdbus_bearer_get_interface (MM_GDBUS_BEARER (self));
+    if (ifname) {
+        g_autoptr(GError)  error = NULL;
+        MMNetdevStats     *netdev_stats;
+
+        netdev_stats = mm_netdev_stats_get ();
+        if (mm_netdev_stats_read (netdev_stats,
+                                  ifname,
+                                  &self->priv->netdev_rx_bytes,
+                                  &self->priv->netdev_tx_bytes,
+                                  &error)) {
+            self->priv->netdev_stats_id = mm_netdev_stats_watch (netdev_stats,
+                                                                 ifname,
+                                                                 (MMNetdevStatsFunc) netdev_stats_cb,
+                                                                 self);
+            self->priv->netdev_ifname = g_strdup (ifname);
+            self->priv->netdev_stats_used = TRUE;
+            self->priv->stats_timestamp = g_get_monotonic_time ();
+            /* The duration is also updated on every counters refresh */
+            return;
+        }
+        mm_obj_dbg (self, "couldn't read interface stats: %s", error->message);
+    }
+
     /* Schedule */
     g_assert (!self->priv->stats_update_id);
-    self->priv->stats_update_id = g_timeout_add_seconds (BEARER_STATS_UPDATE_TIMEOUT,
+    self->priv->stats_update_id = mm_poll_scheduler_add (peek_poll_scheduler (self),
+                                                         "stats-update",
+                                                         BEARER_STATS_UPDATE_TIMEOUT,
+                                                         MM_POLL_JOB_FLAG_DEFER_WHEN_BUSY,
                                                          (GSourceFunc) stats_update_cb,
                                                          self);
     /* Load initial values */
@@ -444,6 +662,8 @@ bearer_update_status (MMBaseBearer *self,
         bearer_reset_interface_status (self);
         /* Cleanup flag to ignore disconnection reports */
         self->priv->ignore_disconnection_reports = FALSE;
+        /* Event sources are setup again on the next connection */
+        self->priv->connection_events_available = FALSE;
         /* Stop statistics */
         bearer_stats_stop (self);
         /* Stop connection monitoring */
@@ -455,7 +675,7 @@ bearer_update_status (MMBaseBearer *self,
                                 "connection #%u finished: duration %us",
                                 mm_bearer_stats_get_attempts (self->priv->stats),
                                 mm_bearer_stats_get_duration (self->priv->stats));
-        if (!self->priv->reload_stats_unsupported)
+        if (self->priv->netdev_stats_used || !self->priv->reload_stats_unsupported)
             g_string_append_printf (report,
                                     ", tx: %" G_GUINT64_FORMAT " bytes, rx :%" G_GUINT64_FORMAT " bytes",
                                     mm_bearer_stats_get_tx_bytes (self->priv->stats),
@@ -756,6 +976,47 @@ reset_signal_handlers (MMBaseBearer *self)
     }
 }
 
+/*****************************************************************************/
+/* Connection timings */
+
+void
+mm_base_bearer_mark_connection_step (MMBaseBearer *self,
+                                     const gchar  *step)
+{
+    /* Ignore steps reported out of a connection attempt */
+    if (!self->priv->connection_timings)
+        return;
+
+    mm_connection_timings_mark (self->priv->connection_timings, step, g_get_monotonic_time ());
+    mm_obj_dbg (self, "connection step '%s' finished after %ums",
+                step, mm_connection_timings_get_elapsed (self->priv->connection_timings));
+}
+
+static void
+connection_timings_start (MMBaseBearer *self)
+{
+    g_clear_pointer (&self->priv->connection_timings, mm_connection_timings_free);
+    self->priv->connection_timings = mm_connection_timings_new (g_get_monotonic_time ());
+}
+
+static void
+connection_timings_complete (MMBaseBearer *self,
+                             gboolean      success)
+{
+    if (!self->priv->connection_timings)
+        return;
+
+    mm_base_bearer_mark_connection_step (self, success ? "connected" : "failed");
+
+    mm_gdbus_bearer_set_connection_timings (MM_GDBUS_BEARER (self),
+                                            mm_connection_timings_get_variant (self->priv->connection_timings));
+    if (self->priv->modem)
+        mm_iface_modem_update_connection_timings (MM_IFACE_MODEM (self->priv->modem),
+                                                  self->priv->connection_timings);
+
+    g_clear_pointer (&self->priv->connection_timings, mm_connection_timings_free);
+}
+
 /*****************************************************************************/
 /* CONNECT */
 
@@ -835,6 +1096,8 @@ connect_ready (MMBaseBearer *self,
         mm_bearer_connect_result_unref (result);
     }
 
+    connection_timings_complete (self, !error);
+
     if (launch_disconnect) {
         bearer_update_status (self, MM_BEARER_STATUS_DISCONNECTING);
         MM_BASE_BEARER_GET_CLASS (self)->disconnect (
@@ -946,6 +1209,7 @@ mm_base_bearer_connect (MMBaseBearer *self,
 
     /* Connecting! */
     mm_obj_dbg (self, "connecting...");
+    connection_timings_start (self);
     self->priv->connect_cancellable = g_cancellable_new ();
     bearer_update_status (self, MM_BEARER_STATUS_CONNECTING);
     MM_BASE_BEARER_GET_CLASS (self)->connect (
@@ -1438,7 +1702,7 @@ set_property (GObject *object,
         self->priv->modem = g_value_dup_object (value);
         if (self->priv->modem) {
             /* Set owner ID */
-            mm_log_object_set_owner_id (MM_LOG_OBJECT (self), mm_log_object_get_id (MM_LOG_OBJECT (self->priv->modem)));
+            mm_log_object_set_owner (MM_LOG_OBJECT (self), MM_LOG_OBJECT (self->priv->modem));
             /* Bind the modem's connection (which is set when it is exported,
              * and unset when unexported) to the BEARER's connection */
             g_object_bind_property (self->priv->modem, MM_BASE_MODEM_CONNECTION,
@@ -1544,6 +1808,8 @@ mm_base_bearer_init (MMBaseBearer *self)
                                      mm_bearer_ip_config_get_dictionary (NULL));
     mm_gdbus_bearer_set_ip6_config  (MM_GDBUS_BEARER (self),
                                      mm_bearer_ip_config_get_dictionary (NULL));
+    mm_gdbus_bearer_set_connection_timings (MM_GDBUS_BEARER (self),
+                                            mm_connection_timings_get_variant (NULL));
     bearer_update_interface_stats (self);
 }
 
@@ -1553,6 +1819,7 @@ finalize (GObject *object)
     MMBaseBearer *self = MM_BASE_BEARER (object);
 
     g_free (self->priv->path);
+    g_clear_pointer (&self->priv->connection_timings, mm_connection_timings_free);
 
     G_OBJECT_CLASS (mm_base_bearer_parent_class)->finalize (object);
 }
@@ -1565,6 +1832,7 @@ dispose (GObject *object)
     connection_monitor_stop (self);
     bearer_stats_stop (self);
     g_clear_object (&self->priv->stats);
+    g_clear_object (&self->priv->poll_scheduler);
 
     if (self->priv->connection) {
         base_bearer_dbus_unexport (self);
@@ -157,4 +157,16 @@ void mm_base_bearer_disconnect_force (MMBaseBearer *self);
 void mm_base_bearer_report_connection_status (MMBaseBearer *self,
                                               MMBearerConnectionStatus status);
 
+/* To be called by implementations that get notified about disconnections of
+ * the ongoing connection, so that the periodic connection status checks are
+ * less frequent. Reset on every disconnection. */
+void mm_base_bearer_set_connection_events_available (MMBaseBearer *self,
+                                                     gboolean      available);
+
+/* To be called by implementations when each step of the connection sequence
+ * finishes, so that the time spent in each one is exposed in the
+ * ConnectionTimings property */
+void mm_base_bearer_mark_connection_step (MMBaseBearer *self,
+                                          const gchar  *step);
+
 #endif /* MM_BASE_BEARER_H */
@@ -1398,7 +1398,7 @@ set_property (GObject *object,
         self->priv->modem = g_value_dup_object (value);
         if (self->priv->modem) {
             /* Set owner ID */
-            mm_log_object_set_owner_id (MM_LOG_OBJECT (self), mm_log_object_get_id (MM_LOG_OBJECT (self->priv->modem)));
+            mm_log_object_set_owner (MM_LOG_OBJECT (self), MM_LOG_OBJECT (self->priv->modem));
             /* Bind the modem's connection (which is set when it is exported,
              * and unset when unexported) to the call's connection */
             g_object_bind_property (self->priv->modem, MM_BASE_MODEM_CONNECTION,
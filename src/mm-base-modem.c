@@ -35,6 +35,7 @@
 #include "mm-port-enums-types.h"
 #include "mm-serial-parsers.h"
 #include "mm-modem-helpers.h"
+#include "mm-poll-scheduler.h"
 
 static void log_object_iface_init (MMLogObjectInterface *iface);
 
@@ -106,6 +107,12 @@ struct _MMBaseModemPrivate {
     GList *enable_tasks;
     GList *disable_tasks;
 
+    /* Shared timer for all periodic polling jobs */
+    MMPollScheduler *poll_scheduler;
+
+    /* Binary capture of the traffic of all serial ports */
+    MMPortCapture *port_capture;
+
 #if defined WITH_QMI
     /* QMI ports */
     GList *qmi;
@@ -352,6 +359,9 @@ mm_base_modem_grab_port (MMBaseModem         *self,
 
     mm_obj_dbg (self, "grabbed port '%s/%s'", name, mm_port_type_get_string (ptype));
 
+    if (self->priv->port_capture && MM_IS_PORT_SERIAL (port))
+        mm_port_serial_set_capture (MM_PORT_SERIAL (port), self->priv->port_capture);
+
     /* Add it to the tracking HT.
      * Note: 'key' and 'port' now owned by the HT. */
     g_hash_table_insert (self->priv->ports, key, port);
@@ -362,7 +372,7 @@ mm_base_modem_grab_port (MMBaseModem         *self,
                   NULL);
 
     /* Set owner ID */
-    mm_log_object_set_owner_id (MM_LOG_OBJECT (port), mm_log_object_get_id (MM_LOG_OBJECT (self)));
+    mm_log_object_set_owner (MM_LOG_OBJECT (port), MM_LOG_OBJECT (self));
 
     return TRUE;
 }
@@ -583,6 +593,77 @@ mm_base_modem_get_cancellable  (MMBaseModem *self)
     return g_object_ref (self->priv->cancellable);
 }
 
+static gboolean
+poll_scheduler_busy_cb (MMBaseModem *self)
+{
+    MMPortSerialAt *port;
+
+    /* No AT ports, nothing to wait for */
+    if (!self->priv->primary)
+        return FALSE;
+
+    /* All AT ports in data mode */
+    port = mm_base_modem_peek_best_at_port (self, NULL);
+    if (!port)
+        return TRUE;
+
+    return mm_port_serial_is_busy (MM_PORT_SERIAL (port));
+}
+
+MMPollScheduler *
+mm_base_modem_peek_poll_scheduler (MMBaseModem *self)
+{
+    g_return_val_if_fail (MM_IS_BASE_MODEM (self), NULL);
+
+    if (G_UNLIKELY (!self->priv->poll_scheduler)) {
+        self->priv->poll_scheduler = mm_poll_scheduler_new (mm_log_object_get_id (MM_LOG_OBJECT (self)));
+        mm_log_object_set_recorder (MM_LOG_OBJECT (self->priv->poll_scheduler),
+                                    mm_log_object_peek_recorder (MM_LOG_OBJECT (self)));
+        mm_poll_scheduler_set_busy_func (self->priv->poll_scheduler,
+                                         (MMPollSchedulerBusyFunc) poll_scheduler_busy_cb,
+                                         self);
+    }
+    return self->priv->poll_scheduler;
+}
+
+void
+mm_base_modem_set_port_capture (MMBaseModem   *self,
+                                MMPortCapture *capture)
+{
+    GHashTableIter iter;
+    MMPort        *port;
+
+    g_return_if_fail (MM_IS_BASE_MODEM (self));
+
+    if (self->priv->port_capture) {
+        mm_obj_info (self, "port capture stopped: %s", mm_port_capture_get_path (self->priv->port_capture));
+        g_clear_pointer (&self->priv->port_capture, mm_port_capture_unref);
+    }
+    if (capture) {
+        mm_obj_info (self, "port capture started: %s", mm_port_capture_get_path (capture));
+        self->priv->port_capture = mm_port_capture_ref (capture);
+    }
+
+    g_hash_table_iter_init (&iter, self->priv->ports);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&port)) {
+        if (MM_IS_PORT_SERIAL (port))
+            mm_port_serial_set_capture (MM_PORT_SERIAL (port), capture);
+    }
+}
+
+gchar **
+mm_base_modem_get_recent_log (MMBaseModem *self)
+{
+    MMLogRecorder *recorder;
+
+    g_return_val_if_fail (MM_IS_BASE_MODEM (self), NULL);
+
+    recorder = mm_log_object_peek_recorder (MM_LOG_OBJECT (self));
+    if (!recorder)
+        return g_new0 (gchar *, 1);
+    return mm_log_recorder_dump (recorder);
+}
+
 MMPortSerialAt *
 mm_base_modem_get_port_primary (MMBaseModem *self)
 {
@@ -1563,6 +1644,15 @@ mm_base_modem_init (MMBaseModem *self)
 
     self->priv->max_timeouts = DEFAULT_MAX_TIMEOUTS;
 
+    /* Recent log records of the modem and all its objects */
+    if (mm_context_get_log_recorder_size ()) {
+        MMLogRecorder *recorder;
+
+        recorder = mm_log_recorder_new (mm_context_get_log_recorder_size ());
+        mm_log_object_set_recorder (MM_LOG_OBJECT (self), recorder);
+        mm_log_recorder_unref (recorder);
+    }
+
     setup_ports_table (self);
 }
 
@@ -1709,6 +1799,14 @@ dispose (GObject *object)
 #endif
 
     teardown_ports_table (self);
+    g_clear_pointer (&self->priv->port_capture, mm_port_capture_unref);
+
+    /* Jobs may still be around until the interface contexts are cleared,
+     * which happens after the ports are gone */
+    if (self->priv->poll_scheduler) {
+        mm_poll_scheduler_set_busy_func (self->priv->poll_scheduler, NULL, NULL);
+        g_clear_object (&self->priv->poll_scheduler);
+    }
 
     g_clear_object (&self->priv->connection);
 
@@ -34,6 +34,7 @@
 #include "mm-port-serial-at.h"
 #include "mm-port-serial-qcdm.h"
 #include "mm-port-serial-gps.h"
+#include "mm-poll-scheduler.h"
 
 #if defined WITH_QMI
 #include "mm-port-qmi.h"
@@ -184,6 +185,17 @@ guint mm_base_modem_get_product_id (MMBaseModem *self);
 GCancellable *mm_base_modem_peek_cancellable (MMBaseModem *self);
 GCancellable *mm_base_modem_get_cancellable  (MMBaseModem *self);
 
+/* Per-modem scheduler for periodic polling jobs */
+MMPollScheduler *mm_base_modem_peek_poll_scheduler (MMBaseModem *self);
+
+/* Recent log records of the modem and its objects, of any level */
+gchar **mm_base_modem_get_recent_log  (MMBaseModem *self);
+
+/* Records the traffic of all the serial ports of the modem in @capture, or
+ * stops if NULL */
+void mm_base_modem_set_port_capture (MMBaseModem   *self,
+                                     MMPortCapture *capture);
+
 void     mm_base_modem_authorize        (MMBaseModem *self,
                                          GDBusMethodInvocation *invocation,
                                          const gchar *authorization,
@@ -514,6 +514,23 @@ handle_send_context_free (HandleSendContext *ctx)
     g_free (ctx);
 }
 
+static void
+sms_sent (MMBaseSms *self)
+{
+    /* Transition from Unknown->Sent or Stored->Sent */
+    if (mm_gdbus_sms_get_state (MM_GDBUS_SMS (self)) == MM_SMS_STATE_UNKNOWN ||
+        mm_gdbus_sms_get_state (MM_GDBUS_SMS (self)) == MM_SMS_STATE_STORED) {
+        GList *l;
+
+        /* Update state */
+        mm_gdbus_sms_set_state (MM_GDBUS_SMS (self), MM_SMS_STATE_SENT);
+        /* Grab last message reference */
+        l = g_list_last (mm_base_sms_get_parts (self));
+        mm_gdbus_sms_set_message_reference (MM_GDBUS_SMS (self),
+                                            mm_sms_part_get_message_reference ((MMSmsPart *)l->data));
+    }
+}
+
 static void
 handle_send_ready (MMBaseSms *self,
                    GAsyncResult *res,
@@ -527,18 +544,7 @@ handle_send_ready (MMBaseSms *self,
         self->priv->parts = NULL;
         g_dbus_method_invocation_take_error (ctx->invocation, error);
     } else {
-        /* Transition from Unknown->Sent or Stored->Sent */
-        if (mm_gdbus_sms_get_state (MM_GDBUS_SMS (ctx->self)) == MM_SMS_STATE_UNKNOWN ||
-            mm_gdbus_sms_get_state (MM_GDBUS_SMS (ctx->self)) == MM_SMS_STATE_STORED) {
-            GList *l;
-
-            /* Update state */
-            mm_gdbus_sms_set_state (MM_GDBUS_SMS (ctx->self), MM_SMS_STATE_SENT);
-            /* Grab last message reference */
-            l = g_list_last (mm_base_sms_get_parts (ctx->self));
-            mm_gdbus_sms_set_message_reference (MM_GDBUS_SMS (ctx->self),
-                                                mm_sms_part_get_message_reference ((MMSmsPart *)l->data));
-        }
+        sms_sent (ctx->self);
         mm_gdbus_sms_complete_send (MM_GDBUS_SMS (ctx->self), ctx->invocation);
     }
 
@@ -653,6 +659,74 @@ handle_send (MMBaseSms *self,
     return TRUE;
 }
 
+/*****************************************************************************/
+/* Send SMS (internal API, for messages never exported) */
+
+gboolean
+mm_base_sms_prepare_send (MMBaseSms  *self,
+                          GError    **error)
+{
+    return prepare_sms_to_be_sent (self, error);
+}
+
+gboolean
+mm_base_sms_send_finish (MMBaseSms     *self,
+                         GAsyncResult  *res,
+                         GError       **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+send_ready (MMBaseSms    *self,
+            GAsyncResult *res,
+            GTask        *task)
+{
+    GError *error = NULL;
+
+    if (!MM_BASE_SMS_GET_CLASS (self)->send_finish (self, res, &error)) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    sms_sent (self);
+    g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
+void
+mm_base_sms_send (MMBaseSms           *self,
+                  GAsyncReadyCallback  callback,
+                  gpointer             user_data)
+{
+    GTask  *task;
+    GError *error = NULL;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    /* Parts may have already been generated with mm_base_sms_prepare_send() */
+    if (!prepare_sms_to_be_sent (self, &error)) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    if (!MM_BASE_SMS_GET_CLASS (self)->send ||
+        !MM_BASE_SMS_GET_CLASS (self)->send_finish) {
+        g_task_return_new_error (task,
+                                 MM_CORE_ERROR,
+                                 MM_CORE_ERROR_UNSUPPORTED,
+                                 "Sending SMS is not supported by this modem");
+        g_object_unref (task);
+        return;
+    }
+
+    MM_BASE_SMS_GET_CLASS (self)->send (self,
+                                        (GAsyncReadyCallback)send_ready,
+                                        task);
+}
+
 /*****************************************************************************/
 
 void
@@ -1053,6 +1127,10 @@ sms_store (MMBaseSms *self,
 /*****************************************************************************/
 /* Send the SMS */
 
+/* Flag set in the modem when +CMMS is known to be unsupported */
+#define CMMS_UNSUPPORTED_TAG "sms-cmms-unsupported-tag"
+static GQuark cmms_unsupported_quark;
+
 typedef struct {
     MMBaseModem *modem;
     gboolean need_unlock;
@@ -1060,6 +1138,11 @@ typedef struct {
     gboolean use_pdu_mode;
     GList *current;
     gchar *msg_data;
+    /* Per-part and overall timing, in monotonic time (us) */
+    guint n_parts;
+    guint n_sent;
+    gint64 start_time;
+    gint64 part_start_time;
 } SmsSendContext;
 
 static void
@@ -1083,6 +1166,28 @@ sms_send_finish (MMBaseSms *self,
 
 static void sms_send_next_part (GTask *task);
 
+static void
+sms_send_part_done (GTask *task,
+                    guint  message_reference)
+{
+    MMBaseSms *self;
+    SmsSendContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    mm_sms_part_set_message_reference ((MMSmsPart *)ctx->current->data, message_reference);
+
+    ctx->n_sent++;
+    mm_obj_dbg (self, "part %u/%u sent in %" G_GINT64_FORMAT " ms (message reference %u)",
+                ctx->n_sent, ctx->n_parts,
+                (g_get_monotonic_time () - ctx->part_start_time) / 1000,
+                message_reference);
+
+    ctx->current = g_list_next (ctx->current);
+    sms_send_next_part (task);
+}
+
 static gint
 read_message_reference_from_reply (const gchar *response,
                                    GError **error)
@@ -1126,7 +1231,6 @@ send_generic_msg_data_ready (MMBaseModem *modem,
                              GAsyncResult *res,
                              GTask *task)
 {
-    SmsSendContext *ctx;
     GError *error = NULL;
     const gchar *response;
     gint message_reference;
@@ -1145,13 +1249,7 @@ send_generic_msg_data_ready (MMBaseModem *modem,
         return;
     }
 
-    ctx = g_task_get_task_data (task);
-
-    mm_sms_part_set_message_reference ((MMSmsPart *)ctx->current->data,
-                                       (guint)message_reference);
-
-    ctx->current = g_list_next (ctx->current);
-    sms_send_next_part (task);
+    sms_send_part_done (task, (guint)message_reference);
 }
 
 static void
@@ -1221,11 +1319,12 @@ send_from_storage_ready (MMBaseModem *modem,
         return;
     }
 
-    mm_sms_part_set_message_reference ((MMSmsPart *)ctx->current->data,
-                                       (guint)message_reference);
+    /* The stored part is now in 'sent' state, so the spooled copy is stale */
+    mm_broadband_modem_forget_sms_part (MM_BROADBAND_MODEM (modem),
+                                        mm_gdbus_sms_get_storage (MM_GDBUS_SMS (self)),
+                                        mm_sms_part_get_index ((MMSmsPart *)ctx->current->data));
 
-    ctx->current = g_list_next (ctx->current);
-    sms_send_next_part (task);
+    sms_send_part_done (task, (guint)message_reference);
 }
 
 static void
@@ -1241,11 +1340,16 @@ sms_send_next_part (GTask *task)
 
     if (!ctx->current) {
         /* Done we are */
+        if (ctx->n_parts > 1)
+            mm_obj_dbg (self, "all %u parts sent in %" G_GINT64_FORMAT " ms",
+                        ctx->n_parts, (g_get_monotonic_time () - ctx->start_time) / 1000);
         g_task_return_boolean (task, TRUE);
         g_object_unref (task);
         return;
     }
 
+    ctx->part_start_time = g_get_monotonic_time ();
+
     /* Send from storage */
     if (ctx->from_storage) {
         cmd = g_strdup_printf ("+CMSS=%d",
@@ -1289,12 +1393,113 @@ sms_send_next_part (GTask *task)
     g_free (cmd);
 }
 
+static gboolean
+cmms_error_is_definitive (const GError *error)
+{
+    /* Only an error reported by the modem itself tells anything about the
+     * command support; timeouts or a busy modem don't */
+    return (g_error_matches (error, MM_MOBILE_EQUIPMENT_ERROR, MM_MOBILE_EQUIPMENT_ERROR_NOT_SUPPORTED) ||
+            g_error_matches (error, MM_MESSAGE_ERROR, MM_MESSAGE_ERROR_NOT_SUPPORTED));
+}
+
+static void
+cmms_test_ready (MMBaseModem *modem,
+                 GAsyncResult *res,
+                 GTask *task)
+{
+    MMBaseSms *self;
+    GError *error = NULL;
+
+    self = g_task_get_source_object (task);
+
+    /* If the modem doesn't even know the command, don't try again */
+    if (!mm_base_modem_at_command_finish (modem, res, &error)) {
+        if (error->domain == MM_MOBILE_EQUIPMENT_ERROR || error->domain == MM_MESSAGE_ERROR) {
+            mm_obj_dbg (self, "relay protocol link control unsupported: %s", error->message);
+            g_object_set_qdata (G_OBJECT (modem), cmms_unsupported_quark, GUINT_TO_POINTER (TRUE));
+        }
+        g_error_free (error);
+    }
+
+    sms_send_next_part (task);
+}
+
+static void
+cmms_ready (MMBaseModem *modem,
+            GAsyncResult *res,
+            GTask *task)
+{
+    MMBaseSms *self;
+    GError *error = NULL;
+
+    self = g_task_get_source_object (task);
+
+    /* Not a fatal error, the parts are sent anyway */
+    if (!mm_base_modem_at_command_finish (modem, res, &error)) {
+        mm_obj_dbg (self, "couldn't keep relay protocol link open between parts: %s", error->message);
+
+        /* Don't retry if the modem clearly says it isn't supported */
+        if (cmms_error_is_definitive (error)) {
+            g_object_set_qdata (G_OBJECT (modem), cmms_unsupported_quark, GUINT_TO_POINTER (TRUE));
+            g_error_free (error);
+            sms_send_next_part (task);
+            return;
+        }
+        g_error_free (error);
+
+        /* Otherwise, the test command tells whether it's supported at all */
+        mm_base_modem_at_command (modem,
+                                  "+CMMS=?",
+                                  3,
+                                  TRUE,
+                                  (GAsyncReadyCallback)cmms_test_ready,
+                                  task);
+        return;
+    }
+
+    sms_send_next_part (task);
+}
+
+static void
+sms_send_start (GTask *task)
+{
+    MMBaseSms *self;
+    SmsSendContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    ctx->current = self->priv->parts;
+    ctx->n_parts = g_list_length (self->priv->parts);
+    ctx->start_time = g_get_monotonic_time ();
+
+    if (G_UNLIKELY (!cmms_unsupported_quark))
+        cmms_unsupported_quark = g_quark_from_static_string (CMMS_UNSUPPORTED_TAG);
+
+    /* When sending multiple parts, request the relay protocol link to be kept
+     * open between them (+CMMS=1 keeps it open until the next submission
+     * times out, so there is no need to disable it afterwards), so that the
+     * network doesn't need to set it up again for each part. */
+    if (ctx->n_parts > 1 &&
+        !mm_iface_modem_is_huawei_sms (MM_IFACE_MODEM (ctx->modem)) &&
+        !g_object_get_qdata (G_OBJECT (ctx->modem), cmms_unsupported_quark)) {
+        mm_base_modem_at_command (ctx->modem,
+                                  "+CMMS=1",
+                                  3,
+                                  FALSE,
+                                  (GAsyncReadyCallback)cmms_ready,
+                                  task);
+        return;
+    }
+
+    sms_send_next_part (task);
+}
+
 static void
 send_lock_sms_storages_ready (MMBroadbandModem *modem,
                               GAsyncResult *res,
                               GTask *task)
 {
-    MMBaseSms *self;
     SmsSendContext *ctx;
     GError *error = NULL;
 
@@ -1304,7 +1509,6 @@ send_lock_sms_storages_ready (MMBroadbandModem *modem,
         return;
     }
 
-    self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
     /* We are now locked. Whatever result we have here, we need to make sure
@@ -1312,8 +1516,7 @@ send_lock_sms_storages_ready (MMBroadbandModem *modem,
     ctx->need_unlock = TRUE;
 
     /* Go on to send the parts */
-    ctx->current = self->priv->parts;
-    sms_send_next_part (task);
+    sms_send_start (task);
 }
 
 static void
@@ -1349,8 +1552,7 @@ sms_send (MMBaseSms *self,
     g_object_get (self->priv->modem,
                   MM_IFACE_MODEM_MESSAGING_SMS_PDU_MODE, &ctx->use_pdu_mode,
                   NULL);
-    ctx->current = self->priv->parts;
-    sms_send_next_part (task);
+    sms_send_start (task);
 }
 
 /*****************************************************************************/
@@ -1401,7 +1603,10 @@ delete_part_ready (MMBaseModem *modem,
                     mm_sms_part_get_index ((MMSmsPart *)ctx->current->data),
                     error->message);
         g_error_free (error);
-    }
+    } else
+        mm_broadband_modem_forget_sms_part (MM_BROADBAND_MODEM (modem),
+                                            mm_gdbus_sms_get_storage (MM_GDBUS_SMS (self)),
+                                            mm_sms_part_get_index ((MMSmsPart *)ctx->current->data));
 
     /* We reset the index, as there is no longer that part */
     mm_sms_part_set_index ((MMSmsPart *)ctx->current->data, SMS_PART_INVALID_INDEX);
@@ -1882,6 +2087,23 @@ mm_base_sms_new_from_properties (MMBaseModem      *modem,
                                  GError          **error)
 {
     MMBaseSms *self;
+
+    self = mm_base_sms_new_transient_from_properties (modem, props, error);
+    if (!self)
+        return NULL;
+
+    /* Only export once properly created */
+    mm_base_sms_export (self);
+
+    return self;
+}
+
+MMBaseSms *
+mm_base_sms_new_transient_from_properties (MMBaseModem      *modem,
+                                           MMSmsProperties  *props,
+                                           GError          **error)
+{
+    MMBaseSms *self;
     const gchar *text;
     GByteArray *data;
 
@@ -1940,9 +2162,6 @@ mm_base_sms_new_from_properties (MMBaseModem      *modem,
                                g_variant_new ("(uv)", MM_SMS_VALIDITY_TYPE_UNKNOWN, g_variant_new_boolean (FALSE))),
                   NULL);
 
-    /* Only export once properly created */
-    mm_base_sms_export (self);
-
     return self;
 }
 
@@ -1993,7 +2212,7 @@ set_property (GObject *object,
         self->priv->modem = g_value_dup_object (value);
         if (self->priv->modem) {
             /* Set owner ID */
-            mm_log_object_set_owner_id (MM_LOG_OBJECT (self), mm_log_object_get_id (MM_LOG_OBJECT (self->priv->modem)));
+            mm_log_object_set_owner (MM_LOG_OBJECT (self), MM_LOG_OBJECT (self->priv->modem));
             /* Bind the modem's connection (which is set when it is exported,
              * and unset when unexported) to the SMS's connection */
             g_object_bind_property (self->priv->modem, MM_BASE_MODEM_CONNECTION,
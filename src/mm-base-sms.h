@@ -86,6 +86,10 @@ MMBaseSms *mm_base_sms_new                 (MMBaseModem *modem);
 MMBaseSms *mm_base_sms_new_from_properties (MMBaseModem *modem,
                                             MMSmsProperties *properties,
                                             GError **error);
+/* Transient SMS objects are never exported nor added to the SMS list */
+MMBaseSms *mm_base_sms_new_transient_from_properties (MMBaseModem *modem,
+                                                      MMSmsProperties *properties,
+                                                      GError **error);
 MMBaseSms *mm_base_sms_singlepart_new      (MMBaseModem *modem,
                                             MMSmsState state,
                                             MMSmsStorage storage,
@@ -116,6 +120,15 @@ guint        mm_base_sms_get_multipart_reference (MMBaseSms *self);
 gboolean     mm_base_sms_multipart_is_complete   (MMBaseSms *self);
 gboolean     mm_base_sms_multipart_is_assembled  (MMBaseSms *self);
 
+gboolean mm_base_sms_prepare_send (MMBaseSms *self,
+                                   GError **error);
+void     mm_base_sms_send         (MMBaseSms *self,
+                                   GAsyncReadyCallback callback,
+                                   gpointer user_data);
+gboolean mm_base_sms_send_finish  (MMBaseSms *self,
+                                   GAsyncResult *res,
+                                   GError **error);
+
 void     mm_base_sms_delete        (MMBaseSms *self,
                                     GAsyncReadyCallback callback,
                                     gpointer user_data);
@@ -911,6 +911,7 @@ connect_context_step (GTask *task)
     }
 
     case CONNECT_STEP_PROVISIONED_CONTEXTS:
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "packet-service");
         mm_obj_dbg (self, "listing provisioned contexts...");
         message = mbim_message_provisioned_contexts_query_new (NULL);
         mbim_device_command (ctx->device,
@@ -987,6 +988,8 @@ connect_context_step (GTask *task)
         MMBearerIpFamily ip_family;
         GError *error = NULL;
 
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "context-check");
+
         /* Setup parameters to use */
 
         apn = mm_bearer_properties_get_apn (ctx->properties);
@@ -1056,6 +1059,7 @@ connect_context_step (GTask *task)
     case CONNECT_STEP_IP_CONFIGURATION: {
         GError *error = NULL;
 
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "connect");
         mm_obj_dbg (self, "querying IP configuration...");
         message = (mbim_message_ip_configuration_query_new (
                        self->priv->session_id,
@@ -1091,6 +1095,8 @@ connect_context_step (GTask *task)
     }
 
     case CONNECT_STEP_LAST:
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "ip-config");
+
         /* Port is connected; update the state */
         mm_port_set_connected (MM_PORT (ctx->data), TRUE);
 
@@ -407,23 +407,23 @@ typedef enum {
     CONNECT_STEP_FIRST,
     CONNECT_STEP_OPEN_QMI_PORT,
     CONNECT_STEP_IP_METHOD,
-    CONNECT_STEP_IPV4,
-    CONNECT_STEP_WDS_CLIENT_IPV4,
-    CONNECT_STEP_BIND_MUX_IPV4,
-    CONNECT_STEP_IP_FAMILY_IPV4,
-    CONNECT_STEP_ENABLE_INDICATIONS_IPV4,
-    CONNECT_STEP_START_NETWORK_IPV4,
-    CONNECT_STEP_GET_CURRENT_SETTINGS_IPV4,
-    CONNECT_STEP_IPV6,
-    CONNECT_STEP_WDS_CLIENT_IPV6,
-    CONNECT_STEP_BIND_MUX_IPV6,
-    CONNECT_STEP_IP_FAMILY_IPV6,
-    CONNECT_STEP_ENABLE_INDICATIONS_IPV6,
-    CONNECT_STEP_START_NETWORK_IPV6,
-    CONNECT_STEP_GET_CURRENT_SETTINGS_IPV6,
+    CONNECT_STEP_FAMILIES,
     CONNECT_STEP_LAST
 } ConnectStep;
 
+/* Sequence run for each IP family, each one on its own WDS client. When both
+ * IPv4 and IPv6 are requested, both sequences run in parallel. */
+typedef enum {
+    FAMILY_STEP_FIRST,
+    FAMILY_STEP_WDS_CLIENT,
+    FAMILY_STEP_BIND_MUX,
+    FAMILY_STEP_IP_FAMILY,
+    FAMILY_STEP_ENABLE_INDICATIONS,
+    FAMILY_STEP_START_NETWORK,
+    FAMILY_STEP_GET_CURRENT_SETTINGS,
+    FAMILY_STEP_LAST
+} FamilyStep;
+
 typedef struct {
     MMBearerQmi *self;
     ConnectStep step;
@@ -438,12 +438,15 @@ typedef struct {
     gchar *apn;
     QmiWdsAuthentication auth;
     gboolean no_ip_family_preference;
-    gboolean default_ip_family_set;
 
     MMBearerIpMethod ip_method;
 
+    /* Family sequences still running, and error aborting the whole
+     * connection attempt reported by any of them */
+    guint n_running_families;
+    GError *abort_error;
+
     gboolean ipv4;
-    gboolean running_ipv4;
     QmiClientWds *client_ipv4;
     guint packet_service_status_ipv4_indication_id;
     guint event_report_ipv4_indication_id;
@@ -452,7 +455,6 @@ typedef struct {
     GError *error_ipv4;
 
     gboolean ipv6;
-    gboolean running_ipv6;
     QmiClientWds *client_ipv6;
     guint packet_service_status_ipv6_indication_id;
     guint event_report_ipv6_indication_id;
@@ -461,6 +463,21 @@ typedef struct {
     GError *error_ipv6;
 } ConnectContext;
 
+typedef struct {
+    /* Connection task, owns the ConnectContext */
+    GTask *task;
+    ConnectContext *ctx;
+    FamilyStep step;
+    gboolean ipv6;
+    gboolean default_ip_family_set;
+    /* Fields of the ConnectContext for this family */
+    QmiClientWds **client;
+    guint *packet_service_status_indication_id;
+    guint *event_report_indication_id;
+    guint32 *packet_data_handle;
+    GError **error;
+} FamilySetup;
+
 static void
 connect_context_free (ConnectContext *ctx)
 {
@@ -497,6 +514,7 @@ connect_context_free (ConnectContext *ctx)
     if (ctx->explicit_qmi_open)
         mm_port_qmi_close (ctx->qmi, NULL, NULL);
 
+    g_clear_error (&ctx->abort_error);
     g_clear_error (&ctx->error_ipv4);
     g_clear_error (&ctx->error_ipv6);
     g_clear_object (&ctx->client_ipv4);
@@ -539,22 +557,18 @@ complete_connect (GTask                 *task,
 }
 
 static void connect_context_step (GTask *task);
+static void family_setup_step (FamilySetup *family);
 
 static void
 start_network_ready (QmiClientWds *client,
                      GAsyncResult *res,
-                     GTask *task)
+                     FamilySetup  *family)
 {
     MMBearerQmi *self;
-    ConnectContext *ctx;
     GError *error = NULL;
     QmiMessageWdsStartNetworkOutput *output;
 
-    self = g_task_get_source_object (task);
-    ctx  = g_task_get_task_data (task);
-
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-    g_assert (!(ctx->running_ipv4 && ctx->running_ipv6));
+    self = g_task_get_source_object (family->task);
 
     output = qmi_client_wds_start_network_finish (client, res, &error);
     if (output &&
@@ -569,10 +583,7 @@ start_network_ready (QmiClientWds *client,
                              QMI_PROTOCOL_ERROR_NO_EFFECT)) {
             g_error_free (error);
             error = NULL;
-            if (ctx->running_ipv4)
-                ctx->packet_data_handle_ipv4 = GLOBAL_PACKET_DATA_HANDLE;
-            else
-                ctx->packet_data_handle_ipv6 = GLOBAL_PACKET_DATA_HANDLE;
+            *family->packet_data_handle = GLOBAL_PACKET_DATA_HANDLE;
 
             /* Fall down to a successful connection */
         } else {
@@ -613,8 +624,8 @@ start_network_ready (QmiClientWds *client,
                 if (asprintf (
                         &str,
                         "mm-call-end-notify.sh \"%s\" \"%s\" \"%s %s %s (%u,%u,%u)\"",
-                        mm_base_bearer_get_path(&ctx->self->parent),
-                        ctx->running_ipv6 ? "ipv6" : "ipv4",
+                        mm_base_bearer_get_path(&self->parent),
+                        family->ipv6 ? "ipv6" : "ipv4",
                         cer_str ?: "",
                         verbose_cer_type_str ?: "",
                         verbose_cer_reason_str ?: "",
@@ -628,35 +639,26 @@ start_network_ready (QmiClientWds *client,
         }
     }
 
-    if (error) {
-        if (ctx->running_ipv4)
-            ctx->error_ipv4 = error;
-        else
-            ctx->error_ipv6 = error;
-    } else {
-        if (ctx->running_ipv4)
-            qmi_message_wds_start_network_output_get_packet_data_handle (output, &ctx->packet_data_handle_ipv4, NULL);
-        else
-            qmi_message_wds_start_network_output_get_packet_data_handle (output, &ctx->packet_data_handle_ipv6, NULL);
-    }
+    if (error)
+        *family->error = error;
+    else
+        qmi_message_wds_start_network_output_get_packet_data_handle (output, family->packet_data_handle, NULL);
 
     if (output)
         qmi_message_wds_start_network_output_unref (output);
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    family->step++;
+    family_setup_step (family);
 }
 
 static QmiMessageWdsStartNetworkInput *
-build_start_network_input (ConnectContext *ctx)
+build_start_network_input (FamilySetup *family)
 {
+    ConnectContext *ctx = family->ctx;
     QmiMessageWdsStartNetworkInput *input;
     gboolean has_user, has_password;
 
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-    g_assert (!(ctx->running_ipv4 && ctx->running_ipv6));
-
     input = qmi_message_wds_start_network_input_new ();
 
     if (ctx->apn && ctx->apn[0])
@@ -686,10 +688,10 @@ build_start_network_input (ConnectContext *ctx)
      * TLV if we already set a default IP family preference with "WDS Set IP
      * Family" */
     if (!ctx->no_ip_family_preference &&
-        !ctx->default_ip_family_set) {
+        !family->default_ip_family_set) {
         qmi_message_wds_start_network_input_set_ip_family_preference (
             input,
-            (ctx->running_ipv6 ? QMI_WDS_IP_FAMILY_IPV6 : QMI_WDS_IP_FAMILY_IPV4),
+            (family->ipv6 ? QMI_WDS_IP_FAMILY_IPV6 : QMI_WDS_IP_FAMILY_IPV4),
             NULL);
     }
 
@@ -897,16 +899,15 @@ get_ipv6_config (MMBearerQmi *self,
 static void
 get_current_settings_ready (QmiClientWds *client,
                             GAsyncResult *res,
-                            GTask *task)
+                            FamilySetup  *family)
 {
     MMBearerQmi *self;
     ConnectContext *ctx;
     GError *error = NULL;
     QmiMessageWdsGetCurrentSettingsOutput *output;
 
-    self = g_task_get_source_object (task);
-    ctx  = g_task_get_task_data (task);
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
+    self = g_task_get_source_object (family->task);
+    ctx  = family->ctx;
 
     output = qmi_client_wds_get_current_settings_finish (client, res, &error);
     if (!output || !qmi_message_wds_get_current_settings_output_get_result (output, &error)) {
@@ -917,7 +918,12 @@ get_current_settings_ready (QmiClientWds *client,
             mm_obj_warn (self, "failed to retrieve mandatory IP settings: %s", error->message);
             if (output)
                 qmi_message_wds_get_current_settings_output_unref (output);
-            complete_connect (task, NULL, error);
+            if (!ctx->abort_error)
+                ctx->abort_error = error;
+            else
+                g_error_free (error);
+            family->step = FAMILY_STEP_LAST;
+            family_setup_step (family);
             return;
         }
 
@@ -928,12 +934,10 @@ get_current_settings_ready (QmiClientWds *client,
         config = mm_bearer_ip_config_new ();
         mm_bearer_ip_config_set_method (config, ctx->ip_method);
 
-        if (ctx->running_ipv4)
-            ctx->ipv4_config = config;
-        else if (ctx->running_ipv6)
+        if (family->ipv6)
             ctx->ipv6_config = config;
         else
-            g_assert_not_reached ();
+            ctx->ipv4_config = config;
     } else {
         QmiWdsIpFamily ip_family = QMI_WDS_IP_FAMILY_UNSPECIFIED;
         guint32 mtu = 0;
@@ -953,10 +957,15 @@ get_current_settings_ready (QmiClientWds *client,
             g_clear_error (&error);
         }
 
-        if (ip_family == QMI_WDS_IP_FAMILY_IPV4)
+        /* Both families may be running in parallel, don't leak the settings
+         * if the modem reports the same family twice */
+        if (ip_family == QMI_WDS_IP_FAMILY_IPV4) {
+            g_clear_object (&ctx->ipv4_config);
             ctx->ipv4_config = get_ipv4_config (ctx->self, ctx->ip_method, output, mtu);
-        else if (ip_family == QMI_WDS_IP_FAMILY_IPV6)
+        } else if (ip_family == QMI_WDS_IP_FAMILY_IPV6) {
+            g_clear_object (&ctx->ipv6_config);
             ctx->ipv6_config = get_ipv6_config (ctx->self, ctx->ip_method, output, mtu);
+        }
 
         /* Domain names */
         if (qmi_message_wds_get_current_settings_output_get_domain_name_list (output, &array, &error)) {
@@ -980,20 +989,16 @@ get_current_settings_ready (QmiClientWds *client,
         qmi_message_wds_get_current_settings_output_unref (output);
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    family->step++;
+    family_setup_step (family);
 }
 
 static void
-get_current_settings (GTask *task, QmiClientWds *client)
+get_current_settings (FamilySetup *family)
 {
-    ConnectContext *ctx;
     QmiMessageWdsGetCurrentSettingsInput *input;
     QmiWdsGetCurrentSettingsRequestedSettings requested;
 
-    ctx = g_task_get_task_data (task);
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-
     requested = QMI_WDS_GET_CURRENT_SETTINGS_REQUESTED_SETTINGS_DNS_ADDRESS |
                 QMI_WDS_GET_CURRENT_SETTINGS_REQUESTED_SETTINGS_GRANTED_QOS |
                 QMI_WDS_GET_CURRENT_SETTINGS_REQUESTED_SETTINGS_IP_ADDRESS |
@@ -1004,29 +1009,26 @@ get_current_settings (GTask *task, QmiClientWds *client)
 
     input = qmi_message_wds_get_current_settings_input_new ();
     qmi_message_wds_get_current_settings_input_set_requested_settings (input, requested, NULL);
-    qmi_client_wds_get_current_settings (client,
+    qmi_client_wds_get_current_settings (*family->client,
                                          input,
                                          10,
-                                         g_task_get_cancellable (task),
+                                         g_task_get_cancellable (family->task),
                                          (GAsyncReadyCallback)get_current_settings_ready,
-                                         task);
+                                         family);
     qmi_message_wds_get_current_settings_input_unref (input);
 }
 
 static void
 bind_mux_data_port_ready (QmiClientWds *client,
                           GAsyncResult *res,
-                          GTask *task)
+                          FamilySetup  *family)
 {
-    ConnectContext *ctx;
     GError *error = NULL;
     QmiMessageWdsBindMuxDataPortOutput *output;
 
-    ctx = g_task_get_task_data (task);
-
     output = qmi_client_wds_bind_mux_data_port_finish (client, res, &error);
     if (!output || !qmi_message_wds_bind_mux_data_port_output_get_result (output, &error)) {
-        mm_obj_err (ctx->self, "Failed to bind mux data port: %s\n", error->message);
+        mm_obj_err (family->ctx->self, "Failed to bind mux data port: %s\n", error->message);
         g_error_free (error);
     }
 
@@ -1034,26 +1036,21 @@ bind_mux_data_port_ready (QmiClientWds *client,
         qmi_message_wds_bind_mux_data_port_output_unref (output);
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    family->step++;
+    family_setup_step (family);
 }
 
 
 static void
 set_ip_family_ready (QmiClientWds *client,
                      GAsyncResult *res,
-                     GTask *task)
+                     FamilySetup  *family)
 {
     MMBearerQmi *self;
-    ConnectContext *ctx;
     GError *error = NULL;
     QmiMessageWdsSetIpFamilyOutput *output;
 
-    self = g_task_get_source_object (task);
-    ctx = g_task_get_task_data (task);
-
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-    g_assert (!(ctx->running_ipv4 && ctx->running_ipv6));
+    self = g_task_get_source_object (family->task);
 
     output = qmi_client_wds_set_ip_family_finish (client, res, &error);
     if (output) {
@@ -1065,15 +1062,15 @@ set_ip_family_ready (QmiClientWds *client,
         /* Ensure we add the IP family preference TLV */
         mm_obj_dbg (self, "couldn't set IP family preference: %s", error->message);
         g_error_free (error);
-        ctx->default_ip_family_set = FALSE;
+        family->default_ip_family_set = FALSE;
     } else {
         /* No need to add IP family preference */
-        ctx->default_ip_family_set = TRUE;
+        family->default_ip_family_set = TRUE;
     }
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    family->step++;
+    family_setup_step (family);
 }
 
 static void
@@ -1198,45 +1195,22 @@ connect_enable_indications_ready (QmiClientWds *client,
 }
 
 static void
-connect_enable_indications_ipv4_ready (QmiClientWds *client,
-                                       GAsyncResult *res,
-                                       GTask *task)
+connect_enable_indications_family_ready (QmiClientWds *client,
+                                         GAsyncResult *res,
+                                         FamilySetup  *family)
 {
-    ConnectContext *ctx;
-
-    ctx = g_task_get_task_data (task);
-    g_assert (ctx->event_report_ipv4_indication_id == 0);
-
-    ctx->event_report_ipv4_indication_id =
-        connect_enable_indications_ready (client, res, ctx->self, &ctx->error_ipv4);
-
-    if (!ctx->event_report_ipv4_indication_id)
-        ctx->step = CONNECT_STEP_LAST;
-    else
-        ctx->step++;
-
-    connect_context_step (task);
-}
+    g_assert (*family->event_report_indication_id == 0);
 
-static void
-connect_enable_indications_ipv6_ready (QmiClientWds *client,
-                                       GAsyncResult *res,
-                                       GTask *task)
-{
-    ConnectContext *ctx;
+    *family->event_report_indication_id =
+        connect_enable_indications_ready (client, res, family->ctx->self, family->error);
 
-    ctx = g_task_get_task_data (task);
-    g_assert (ctx->event_report_ipv6_indication_id == 0);
-
-    ctx->event_report_ipv6_indication_id =
-        connect_enable_indications_ready (client, res, ctx->self, &ctx->error_ipv6);
-
-    if (!ctx->event_report_ipv6_indication_id)
-        ctx->step = CONNECT_STEP_LAST;
+    /* Only this family is given up, the other one may still succeed */
+    if (!*family->event_report_indication_id)
+        family->step = FAMILY_STEP_LAST;
     else
-        ctx->step++;
+        family->step++;
 
-    connect_context_step (task);
+    family_setup_step (family);
 }
 
 static QmiMessageWdsSetEventReportInput *
@@ -1300,38 +1274,39 @@ cleanup_event_report_unsolicited_events (MMBearerQmi *self,
     qmi_message_wds_set_event_report_input_unref (input);
 }
 
+static MMPortQmiFlag
+family_setup_get_client_flag (FamilySetup *family)
+{
+    return (family->ipv6 ? MM_PORT_QMI_FLAG_WDS_IPV6 : MM_PORT_QMI_FLAG_WDS_IPV4) + family->ctx->mux_id;
+}
+
 static void
-qmi_port_allocate_client_ready (MMPortQmi *qmi,
+qmi_port_allocate_client_ready (MMPortQmi    *qmi,
                                 GAsyncResult *res,
-                                GTask *task)
+                                FamilySetup  *family)
 {
-    ConnectContext *ctx;
     GError *error = NULL;
 
-    ctx = g_task_get_task_data (task);
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-    g_assert (!(ctx->running_ipv4 && ctx->running_ipv6));
-
     if (!mm_port_qmi_allocate_client_finish (qmi, res, &error)) {
         g_prefix_error (&error, "Couldn't allocate %s client in QMI port %s: ",
-                        ctx->running_ipv4 ? "IPv4" : "IPv6",
+                        family->ipv6 ? "IPv6" : "IPv4",
                         mm_port_get_device (MM_PORT (qmi)));
-        complete_connect (task, NULL, error);
+        if (!family->ctx->abort_error)
+            family->ctx->abort_error = error;
+        else
+            g_error_free (error);
+        family->step = FAMILY_STEP_LAST;
+        family_setup_step (family);
         return;
     }
 
-    if (ctx->running_ipv4)
-        ctx->client_ipv4 = QMI_CLIENT_WDS (mm_port_qmi_get_client (qmi,
-                                                                   QMI_SERVICE_WDS,
-                                                                   MM_PORT_QMI_FLAG_WDS_IPV4 + ctx->mux_id));
-    else
-        ctx->client_ipv6 = QMI_CLIENT_WDS (mm_port_qmi_get_client (qmi,
-                                                                   QMI_SERVICE_WDS,
-                                                                   MM_PORT_QMI_FLAG_WDS_IPV6 + ctx->mux_id));
+    *family->client = QMI_CLIENT_WDS (mm_port_qmi_get_client (qmi,
+                                                              QMI_SERVICE_WDS,
+                                                              family_setup_get_client_flag (family)));
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    family->step++;
+    family_setup_step (family);
 }
 
 static void
@@ -1370,319 +1345,282 @@ get_mux_id(MMPort *data)
 }
 
 static void
-connect_context_step (GTask *task)
+family_setup_step (FamilySetup *family)
 {
     MMBearerQmi    *self;
     ConnectContext *ctx;
-
-    self = g_task_get_source_object (task);
-
-    g_assert (self->priv->ongoing_connect_user_cancellable);
-    if (g_cancellable_is_cancelled (self->priv->ongoing_connect_user_cancellable)) {
-        complete_connect (task,
-                          NULL,
-                          g_error_new (G_IO_ERROR,
-                                       G_IO_ERROR_CANCELLED,
-                                       "operation cancelled"));
-        return;
-    }
-
-    g_assert (self->priv->ongoing_connect_network_cancellable);
-    if (g_cancellable_is_cancelled (self->priv->ongoing_connect_network_cancellable)) {
-        complete_connect (task,
-                          NULL,
-                          g_error_new (MM_CORE_ERROR,
-                                       MM_CORE_ERROR_ABORTED,
-                                       "aborted by the network"));
-        return;
-    }
-
-    ctx = g_task_get_task_data (task);
-
-    switch (ctx->step) {
-    case CONNECT_STEP_FIRST:
-        g_assert (ctx->ipv4 || ctx->ipv6);
-        ctx->step++;
-        /* fall through */
-
-    case CONNECT_STEP_OPEN_QMI_PORT:
-        /* If we're explicitly opening the port (e.g. using a different cdc-wdm
-         * port because the primary one is already connected by a different
-         * bearer), then make sure we also close it if anything goes wrong and
-         * during disconnect */
-        if (!mm_port_qmi_is_open (ctx->qmi)) {
-            mm_port_qmi_open (ctx->qmi,
-                              TRUE,
-                              g_task_get_cancellable (task),
-                              (GAsyncReadyCallback)qmi_port_open_ready,
-                              task);
-            return;
-        }
-
-        ctx->step++;
-        /* fall through */
-
-    case CONNECT_STEP_IP_METHOD:
-        /* Once the QMI port is open, we decide the IP method we're going
-         * to request. If the LLP is raw-ip, we force Static IP, because not
-         * all DHCP clients support the raw-ip interfaces; otherwise default
-         * to DHCP as always. */
-#if 0
-        if (mm_port_qmi_llp_is_raw_ip (ctx->qmi))
-            ctx->ip_method = MM_BEARER_IP_METHOD_STATIC;
-        else
-#endif
-            ctx->ip_method = MM_BEARER_IP_METHOD_DHCP;
-
-        mm_obj_dbg (self, "defaulting to use %s IP method", mm_bearer_ip_method_get_string (ctx->ip_method));
-        ctx->step++;
+    const gchar    *family_str;
+
+    self = g_task_get_source_object (family->task);
+    ctx = family->ctx;
+    family_str = family->ipv6 ? "IPv6" : "IPv4";
+
+    /* If the whole attempt was cancelled, just stop here and let the main
+     * sequence report it */
+    if (g_cancellable_is_cancelled (self->priv->ongoing_connect_user_cancellable) ||
+        g_cancellable_is_cancelled (self->priv->ongoing_connect_network_cancellable))
+        family->step = FAMILY_STEP_LAST;
+
+    switch (family->step) {
+    case FAMILY_STEP_FIRST:
+        mm_obj_dbg (self, "running %s connection setup", family_str);
+        family->step++;
         /* fall through */
 
-    case CONNECT_STEP_IPV4:
-        /* If no IPv4 setup needed, jump to IPv6 */
-        if (!ctx->ipv4) {
-            ctx->step = CONNECT_STEP_IPV6;
-            connect_context_step (task);
-            return;
-        }
-
-        /* Start IPv4 setup */
-        mm_obj_dbg (self, "running IPv4 connection setup");
-        ctx->running_ipv4 = TRUE;
-        ctx->running_ipv6 = FALSE;
-        ctx->step++;
-        /* fall through */
-
-    case CONNECT_STEP_WDS_CLIENT_IPV4: {
+    case FAMILY_STEP_WDS_CLIENT: {
         QmiClient *client;
 
         client = mm_port_qmi_get_client (ctx->qmi,
                                          QMI_SERVICE_WDS,
-                                         MM_PORT_QMI_FLAG_WDS_IPV4 + ctx->mux_id);
+                                         family_setup_get_client_flag (family));
         if (!client) {
-            mm_obj_dbg (self, "allocating IPv4-specific WDS client");
+            mm_obj_dbg (self, "allocating %s-specific WDS client", family_str);
             mm_port_qmi_allocate_client (ctx->qmi,
                                          QMI_SERVICE_WDS,
-                                         MM_PORT_QMI_FLAG_WDS_IPV4 + ctx->mux_id,
-                                         g_task_get_cancellable (task),
+                                         family_setup_get_client_flag (family),
+                                         g_task_get_cancellable (family->task),
                                          (GAsyncReadyCallback)qmi_port_allocate_client_ready,
-                                         task);
+                                         family);
             return;
         }
 
-        ctx->client_ipv4 = QMI_CLIENT_WDS (client);
-        ctx->step++;
+        *family->client = QMI_CLIENT_WDS (client);
+        family->step++;
     } /* fall through */
 
-    case CONNECT_STEP_BIND_MUX_IPV4:
+    case FAMILY_STEP_BIND_MUX:
         /* Associate the QMAP-muxed data port with the allocated WDS client. */
         if (ctx->mux_id) {
             QmiMessageWdsBindMuxDataPortInput *input;
 
-            mm_obj_dbg (self, "Binding IPv4 WDS client to mux id %d on data port on USB interface number %d", ctx->mux_id, ctx->data_ep_iface_num);
+            mm_obj_dbg (self, "Binding %s WDS client to mux id %d on data port on USB interface number %d", family_str, ctx->mux_id, ctx->data_ep_iface_num);
             input = qmi_message_wds_bind_mux_data_port_input_new ();
             qmi_message_wds_bind_mux_data_port_input_set_endpoint_info (input, QMI_DATA_ENDPOINT_TYPE_HSUSB, ctx->data_ep_iface_num, NULL);
             qmi_message_wds_bind_mux_data_port_input_set_mux_id (input, ctx->mux_id, NULL);
             qmi_message_wds_bind_mux_data_port_input_set_client_type (input, QMI_WDS_CLIENT_TYPE_TETHERED, NULL);
 
-            qmi_client_wds_bind_mux_data_port (ctx->client_ipv4,
+            qmi_client_wds_bind_mux_data_port (*family->client,
                                                input,
                                                10,
-                                               g_task_get_cancellable (task),
+                                               g_task_get_cancellable (family->task),
                                                (GAsyncReadyCallback) bind_mux_data_port_ready,
-                                               task);
+                                               family);
             qmi_message_wds_bind_mux_data_port_input_unref (input);
             return;
         }
 
-        /* Just fall down */
-        ctx->step++;
+        family->step++;
+        /* fall through */
 
-    case CONNECT_STEP_IP_FAMILY_IPV4:
+    case FAMILY_STEP_IP_FAMILY:
         /* If client is new enough, select IP family */
         if (!ctx->no_ip_family_preference &&
-            qmi_client_check_version (QMI_CLIENT (ctx->client_ipv4), 1, 9)) {
+            qmi_client_check_version (QMI_CLIENT (*family->client), 1, 9)) {
             QmiMessageWdsSetIpFamilyInput *input;
 
-            mm_obj_dbg (self, "setting default IP family to: IPv4");
+            mm_obj_dbg (self, "setting default IP family to: %s", family_str);
             input = qmi_message_wds_set_ip_family_input_new ();
-            qmi_message_wds_set_ip_family_input_set_preference (input, QMI_WDS_IP_FAMILY_IPV4, NULL);
-            qmi_client_wds_set_ip_family (ctx->client_ipv4,
+            qmi_message_wds_set_ip_family_input_set_preference (input,
+                                                                family->ipv6 ? QMI_WDS_IP_FAMILY_IPV6 : QMI_WDS_IP_FAMILY_IPV4,
+                                                                NULL);
+            qmi_client_wds_set_ip_family (*family->client,
                                           input,
                                           10,
-                                          g_task_get_cancellable (task),
+                                          g_task_get_cancellable (family->task),
                                           (GAsyncReadyCallback)set_ip_family_ready,
-                                          task);
+                                          family);
             qmi_message_wds_set_ip_family_input_unref (input);
             return;
         }
 
-        ctx->default_ip_family_set = FALSE;
+        family->default_ip_family_set = FALSE;
 
-        ctx->step++;
+        family->step++;
         /* fall through */
 
-    case CONNECT_STEP_ENABLE_INDICATIONS_IPV4:
+    case FAMILY_STEP_ENABLE_INDICATIONS:
         common_setup_cleanup_packet_service_status_unsolicited_events (ctx->self,
-                                                                       ctx->client_ipv4,
+                                                                       *family->client,
                                                                        TRUE,
-                                                                       &ctx->packet_service_status_ipv4_indication_id);
+                                                                       family->packet_service_status_indication_id);
         setup_event_report_unsolicited_events (ctx->self,
-                                               ctx->client_ipv4,
-                                               g_task_get_cancellable (task),
-                                               (GAsyncReadyCallback) connect_enable_indications_ipv4_ready,
-                                               task);
+                                               *family->client,
+                                               g_task_get_cancellable (family->task),
+                                               (GAsyncReadyCallback) connect_enable_indications_family_ready,
+                                               family);
         return;
 
-    case CONNECT_STEP_START_NETWORK_IPV4: {
+    case FAMILY_STEP_START_NETWORK: {
         QmiMessageWdsStartNetworkInput *input;
 
-        mm_obj_dbg (self, "starting IPv4 connection...");
-        input = build_start_network_input (ctx);
-        qmi_client_wds_start_network (ctx->client_ipv4,
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), family->ipv6 ? "client-setup-ipv6" : "client-setup-ipv4");
+        mm_obj_dbg (self, "starting %s connection...", family_str);
+        input = build_start_network_input (family);
+        qmi_client_wds_start_network (*family->client,
                                       input,
                                       45,
-                                      g_task_get_cancellable (task),
+                                      g_task_get_cancellable (family->task),
                                       (GAsyncReadyCallback)start_network_ready,
-                                      task);
+                                      family);
         qmi_message_wds_start_network_input_unref (input);
         return;
     }
 
-    case CONNECT_STEP_GET_CURRENT_SETTINGS_IPV4:
+    case FAMILY_STEP_GET_CURRENT_SETTINGS:
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), family->ipv6 ? "start-network-ipv6" : "start-network-ipv4");
+
         /* Retrieve and print IP configuration */
-        if (ctx->packet_data_handle_ipv4) {
-            mm_obj_dbg (self, "getting IPv4 configuration...");
-            get_current_settings (task, ctx->client_ipv4);
+        if (*family->packet_data_handle) {
+            mm_obj_dbg (self, "getting %s configuration...", family_str);
+            get_current_settings (family);
             return;
         }
-        ctx->step++;
+        family->step++;
         /* fall through */
 
-    case CONNECT_STEP_IPV6:
-        /* If no IPv6 setup needed, jump to last */
-        if (!ctx->ipv6) {
-            ctx->step = CONNECT_STEP_LAST;
+    case FAMILY_STEP_LAST: {
+        GTask *task;
+
+        if (*family->packet_data_handle && !ctx->abort_error)
+            mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), family->ipv6 ? "ip-config-ipv6" : "ip-config-ipv4");
+
+        /* The main sequence goes on once all families are done */
+        task = family->task;
+        g_slice_free (FamilySetup, family);
+
+        g_assert (ctx->n_running_families > 0);
+        if (!--ctx->n_running_families) {
+            ctx->step++;
             connect_context_step (task);
-            return;
         }
+        g_object_unref (task);
+        return;
+    }
 
-        /* Start IPv6 setup */
-        mm_obj_dbg (self, "running IPv6 connection setup");
-        ctx->running_ipv4 = FALSE;
-        ctx->running_ipv6 = TRUE;
-        ctx->step++;
-        /* fall through */
+    default:
+        g_assert_not_reached ();
+    }
+}
 
-    case CONNECT_STEP_WDS_CLIENT_IPV6: {
-        QmiClient *client;
+static void
+family_setup_start (GTask    *task,
+                    gboolean  ipv6)
+{
+    ConnectContext *ctx;
+    FamilySetup    *family;
 
-        client = mm_port_qmi_get_client (ctx->qmi,
-                                         QMI_SERVICE_WDS,
-                                         MM_PORT_QMI_FLAG_WDS_IPV6 + ctx->mux_id);
-        if (!client) {
-            mm_obj_dbg (self, "allocating IPv6-specific WDS client");
-            mm_port_qmi_allocate_client (ctx->qmi,
-                                         QMI_SERVICE_WDS,
-                                         MM_PORT_QMI_FLAG_WDS_IPV6 + ctx->mux_id,
-                                         g_task_get_cancellable (task),
-                                         (GAsyncReadyCallback)qmi_port_allocate_client_ready,
-                                         task);
-            return;
-        }
+    ctx = g_task_get_task_data (task);
 
-        ctx->client_ipv6 = QMI_CLIENT_WDS (client);
-        ctx->step++;
-    } /* fall through */
+    family = g_slice_new0 (FamilySetup);
+    family->task = g_object_ref (task);
+    family->ctx = ctx;
+    family->step = FAMILY_STEP_FIRST;
+    family->ipv6 = ipv6;
+    if (ipv6) {
+        family->client = &ctx->client_ipv6;
+        family->packet_service_status_indication_id = &ctx->packet_service_status_ipv6_indication_id;
+        family->event_report_indication_id = &ctx->event_report_ipv6_indication_id;
+        family->packet_data_handle = &ctx->packet_data_handle_ipv6;
+        family->error = &ctx->error_ipv6;
+    } else {
+        family->client = &ctx->client_ipv4;
+        family->packet_service_status_indication_id = &ctx->packet_service_status_ipv4_indication_id;
+        family->event_report_indication_id = &ctx->event_report_ipv4_indication_id;
+        family->packet_data_handle = &ctx->packet_data_handle_ipv4;
+        family->error = &ctx->error_ipv4;
+    }
 
-    case CONNECT_STEP_BIND_MUX_IPV6:
-        /* Associate the QMAP-muxed data port with the allocated WDS client. */
-        if (ctx->mux_id) {
-            QmiMessageWdsBindMuxDataPortInput *input;
+    family_setup_step (family);
+}
 
-            mm_obj_dbg (self, "Binding IPv6 WDS client to mux id %d on data port on USB interface number %d", ctx->mux_id, ctx->data_ep_iface_num);
-            input = qmi_message_wds_bind_mux_data_port_input_new ();
-            qmi_message_wds_bind_mux_data_port_input_set_endpoint_info (input, QMI_DATA_ENDPOINT_TYPE_HSUSB, ctx->data_ep_iface_num, NULL);
-            qmi_message_wds_bind_mux_data_port_input_set_mux_id (input, ctx->mux_id, NULL);
-            qmi_message_wds_bind_mux_data_port_input_set_client_type (input, QMI_WDS_CLIENT_TYPE_TETHERED, NULL);
+static void
+connect_context_step (GTask *task)
+{
+    MMBearerQmi    *self;
+    ConnectContext *ctx;
 
-            qmi_client_wds_bind_mux_data_port (ctx->client_ipv6,
-                                               input,
-                                               10,
-                                               g_task_get_cancellable (task),
-                                               (GAsyncReadyCallback) bind_mux_data_port_ready,
-                                               task);
-            qmi_message_wds_bind_mux_data_port_input_unref (input);
-            return;
-        }
+    self = g_task_get_source_object (task);
 
-        /* Just fall down */
-        ctx->step++;
+    g_assert (self->priv->ongoing_connect_user_cancellable);
+    if (g_cancellable_is_cancelled (self->priv->ongoing_connect_user_cancellable)) {
+        complete_connect (task,
+                          NULL,
+                          g_error_new (G_IO_ERROR,
+                                       G_IO_ERROR_CANCELLED,
+                                       "operation cancelled"));
+        return;
+    }
 
-    case CONNECT_STEP_IP_FAMILY_IPV6:
+    g_assert (self->priv->ongoing_connect_network_cancellable);
+    if (g_cancellable_is_cancelled (self->priv->ongoing_connect_network_cancellable)) {
+        complete_connect (task,
+                          NULL,
+                          g_error_new (MM_CORE_ERROR,
+                                       MM_CORE_ERROR_ABORTED,
+                                       "aborted by the network"));
+        return;
+    }
 
-        g_assert (ctx->no_ip_family_preference == FALSE);
+    ctx = g_task_get_task_data (task);
 
-        /* If client is new enough, select IP family */
-        if (qmi_client_check_version (QMI_CLIENT (ctx->client_ipv6), 1, 9)) {
-            QmiMessageWdsSetIpFamilyInput *input;
+    switch (ctx->step) {
+    case CONNECT_STEP_FIRST:
+        g_assert (ctx->ipv4 || ctx->ipv6);
+        ctx->step++;
+        /* fall through */
 
-            mm_obj_dbg (self, "setting default IP family to: IPv6");
-            input = qmi_message_wds_set_ip_family_input_new ();
-            qmi_message_wds_set_ip_family_input_set_preference (input, QMI_WDS_IP_FAMILY_IPV6, NULL);
-            qmi_client_wds_set_ip_family (ctx->client_ipv6,
-                                          input,
-                                          10,
-                                          g_task_get_cancellable (task),
-                                          (GAsyncReadyCallback)set_ip_family_ready,
-                                          task);
-            qmi_message_wds_set_ip_family_input_unref (input);
+    case CONNECT_STEP_OPEN_QMI_PORT:
+        /* If we're explicitly opening the port (e.g. using a different cdc-wdm
+         * port because the primary one is already connected by a different
+         * bearer), then make sure we also close it if anything goes wrong and
+         * during disconnect */
+        if (!mm_port_qmi_is_open (ctx->qmi)) {
+            mm_port_qmi_open (ctx->qmi,
+                              TRUE,
+                              g_task_get_cancellable (task),
+                              (GAsyncReadyCallback)qmi_port_open_ready,
+                              task);
             return;
         }
 
-        ctx->default_ip_family_set = FALSE;
-
         ctx->step++;
         /* fall through */
 
-    case CONNECT_STEP_ENABLE_INDICATIONS_IPV6:
-        common_setup_cleanup_packet_service_status_unsolicited_events (ctx->self,
-                                                                       ctx->client_ipv6,
-                                                                       TRUE,
-                                                                       &ctx->packet_service_status_ipv6_indication_id);
-        setup_event_report_unsolicited_events (ctx->self,
-                                               ctx->client_ipv6,
-                                               g_task_get_cancellable (task),
-                                               (GAsyncReadyCallback) connect_enable_indications_ipv6_ready,
-                                               task);
-        return;
+    case CONNECT_STEP_IP_METHOD:
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "open-port");
 
-    case CONNECT_STEP_START_NETWORK_IPV6: {
-        QmiMessageWdsStartNetworkInput *input;
+        /* Once the QMI port is open, we decide the IP method we're going
+         * to request. If the LLP is raw-ip, we force Static IP, because not
+         * all DHCP clients support the raw-ip interfaces; otherwise default
+         * to DHCP as always. */
+#if 0
+        if (mm_port_qmi_llp_is_raw_ip (ctx->qmi))
+            ctx->ip_method = MM_BEARER_IP_METHOD_STATIC;
+        else
+#endif
+            ctx->ip_method = MM_BEARER_IP_METHOD_DHCP;
 
-        mm_obj_dbg (self, "starting IPv6 connection...");
-        input = build_start_network_input (ctx);
-        qmi_client_wds_start_network (ctx->client_ipv6,
-                                      input,
-                                      45,
-                                      g_task_get_cancellable (task),
-                                      (GAsyncReadyCallback)start_network_ready,
-                                      task);
-        qmi_message_wds_start_network_input_unref (input);
+        mm_obj_dbg (self, "defaulting to use %s IP method", mm_bearer_ip_method_get_string (ctx->ip_method));
+        ctx->step++;
+        /* fall through */
+
+    case CONNECT_STEP_FAMILIES:
+        /* Both counted before launching any, as they may finish right away */
+        ctx->n_running_families = (ctx->ipv4 ? 1 : 0) + (ctx->ipv6 ? 1 : 0);
+        if (ctx->ipv4 && ctx->ipv6)
+            mm_obj_dbg (self, "running IPv4 and IPv6 connection setups in parallel");
+        if (ctx->ipv4)
+            family_setup_start (task, FALSE);
+        if (ctx->ipv6)
+            family_setup_start (task, TRUE);
         return;
-    }
 
-    case CONNECT_STEP_GET_CURRENT_SETTINGS_IPV6:
-        /* Retrieve and print IP configuration */
-        if (ctx->packet_data_handle_ipv6) {
-            mm_obj_dbg (self, "getting IPv6 configuration...");
-            get_current_settings (task, ctx->client_ipv6);
+    case CONNECT_STEP_LAST:
+        if (ctx->abort_error) {
+            complete_connect (task, NULL, g_steal_pointer (&ctx->abort_error));
             return;
         }
-        ctx->step++;
-        /* fall through */
 
-    case CONNECT_STEP_LAST:
         /* If one of IPv4 or IPv6 succeeds, we're connected */
         if (!ctx->packet_data_handle_ipv4 && !ctx->packet_data_handle_ipv6) {
             GError *error;
@@ -1700,6 +1638,15 @@ connect_context_step (GTask *task)
             return;
         }
 
+        if (ctx->ipv4 && ctx->ipv6) {
+            if (!ctx->packet_data_handle_ipv4)
+                mm_obj_warn (self, "dual-stack connection partially established: IPv4 failed: %s",
+                             ctx->error_ipv4 ? ctx->error_ipv4->message : "unknown error");
+            else if (!ctx->packet_data_handle_ipv6)
+                mm_obj_warn (self, "dual-stack connection partially established: IPv6 failed: %s",
+                             ctx->error_ipv6 ? ctx->error_ipv6->message : "unknown error");
+        }
+
         /* Port is connected; update the state */
         mm_port_set_connected (MM_PORT (ctx->data), TRUE);
 
@@ -1737,6 +1684,12 @@ connect_context_step (GTask *task)
             ctx->self->priv->client_ipv6 = g_object_ref (ctx->client_ipv6);
         }
 
+        /* Disconnections are reported with "Packet Service Status" indications,
+         * so the connection status doesn't need to be polled often */
+        if (ctx->self->priv->packet_service_status_ipv4_indication_id ||
+            ctx->self->priv->packet_service_status_ipv6_indication_id)
+            mm_base_bearer_set_connection_events_available (MM_BASE_BEARER (ctx->self), TRUE);
+
         complete_connect (task,
                           mm_bearer_connect_result_new (ctx->data,
                                                         ctx->ipv4_config,
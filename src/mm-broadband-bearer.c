@@ -28,12 +28,14 @@
 #include <libmm-glib.h>
 
 #include "mm-broadband-bearer.h"
+#include "mm-broadband-modem.h"
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-3gpp.h"
 #include "mm-iface-modem-cdma.h"
 #include "mm-base-modem-at.h"
 #include "mm-log-object.h"
 #include "mm-modem-helpers.h"
+#include "mm-pdp-context-cache.h"
 #include "mm-port-enums-types.h"
 #include "mm-helper-enums-types.h"
 
@@ -600,6 +602,7 @@ dial_3gpp (MMBroadbandBearer *self,
 
 typedef enum {
     CID_SELECTION_3GPP_STEP_FIRST,
+    CID_SELECTION_3GPP_STEP_VALIDATE_CACHED,
     CID_SELECTION_3GPP_STEP_FORMAT,
     CID_SELECTION_3GPP_STEP_CURRENT,
     CID_SELECTION_3GPP_STEP_SELECT_CONTEXT,
@@ -614,6 +617,8 @@ typedef struct {
     GCancellable         *cancellable;
     GList                *context_list;
     GList                *context_format_list;
+    gboolean              context_list_loaded;
+    guint                 cached_cid;
     guint                 cid;
     gboolean              cid_reused;
     gboolean              cid_overwritten;
@@ -758,6 +763,7 @@ cgdcont_query_ready (MMBaseModem  *modem,
 
     /* Build context list */
     ctx->context_list = mm_3gpp_parse_cgdcont_read_response (response, &error);
+    ctx->context_list_loaded = TRUE;
     if (!ctx->context_list) {
         if (error) {
             mm_obj_dbg (self, "failed parsing currently defined contexts: %s", error->message);
@@ -795,6 +801,13 @@ cid_selection_3gpp_query_current (GTask *task)
     self = g_task_get_source_object (task);
     ctx  = g_task_get_task_data (task);
 
+    /* The list is already available if a cached context was checked */
+    if (ctx->context_list_loaded) {
+        ctx->step++;
+        cid_selection_3gpp_context_step (task);
+        return;
+    }
+
     mm_obj_dbg (self, "checking currently defined contexts...");
     mm_base_modem_at_command_full (ctx->modem,
                                    ctx->primary,
@@ -807,6 +820,69 @@ cid_selection_3gpp_query_current (GTask *task)
                                    task);
 }
 
+static void
+cgdcont_validate_ready (MMBaseModem  *modem,
+                        GAsyncResult *res,
+                        GTask        *task)
+{
+    MMBroadbandBearer       *self;
+    CidSelection3gppContext *ctx;
+    GError                  *error = NULL;
+    const gchar             *response;
+
+    self = g_task_get_source_object (task);
+    ctx  = g_task_get_task_data (task);
+
+    response = mm_base_modem_at_command_full_finish (modem, res, &error);
+    if (!response) {
+        mm_obj_dbg (self, "failed checking cached PDP context: %s", error->message);
+        g_clear_error (&error);
+    } else {
+        ctx->context_list = mm_3gpp_parse_cgdcont_read_response (response, NULL);
+        ctx->context_list_loaded = TRUE;
+        if (mm_pdp_context_cache_validate (ctx->context_list,
+                                           ctx->cached_cid,
+                                           mm_bearer_properties_get_apn (mm_base_bearer_peek_config (MM_BASE_BEARER (self))),
+                                           ctx->ip_family)) {
+            mm_obj_dbg (self, "reusing cached PDP context with cid %u", ctx->cached_cid);
+            ctx->cid = ctx->cached_cid;
+            ctx->cid_reused = TRUE;
+            ctx->step = CID_SELECTION_3GPP_STEP_LAST;
+            cid_selection_3gpp_context_step (task);
+            return;
+        }
+        mm_obj_dbg (self, "cached PDP context with cid %u no longer valid", ctx->cached_cid);
+        mm_broadband_modem_invalidate_pdp_context_cache (MM_BROADBAND_MODEM (ctx->modem), ctx->cached_cid);
+    }
+
+    /* Fallback to the full context lookup */
+    ctx->step++;
+    cid_selection_3gpp_context_step (task);
+}
+
+static void
+cid_selection_3gpp_validate_cached (GTask *task)
+{
+    MMBroadbandBearer       *self;
+    CidSelection3gppContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx  = g_task_get_task_data (task);
+
+    /* The modem may have lost or redefined the context since it was cached
+     * (e.g. after a reset), so make sure it's still there before reusing it */
+    mm_obj_dbg (self, "checking cached PDP context with cid %u...", ctx->cached_cid);
+    mm_base_modem_at_command_full (ctx->modem,
+                                   ctx->primary,
+                                   "+CGDCONT?",
+                                   3,
+                                   FALSE, /* cached */
+                                   FALSE, /* raw */
+                                   ctx->cancellable,
+                                   (GAsyncReadyCallback)cgdcont_validate_ready,
+                                   task);
+}
+
 static void
 cgdcont_test_ready (MMBaseModem  *modem,
                     GAsyncResult *res,
@@ -864,9 +940,11 @@ cid_selection_3gpp_query_format (GTask *task)
 static void
 cid_selection_3gpp_context_step (GTask *task)
 {
+    MMBroadbandBearer       *self;
     CidSelection3gppContext *ctx;
 
-    ctx = g_task_get_task_data (task);
+    self = g_task_get_source_object (task);
+    ctx  = g_task_get_task_data (task);
 
     /* Abort if we've been cancelled */
     if (g_task_return_error_if_cancelled (task)) {
@@ -879,6 +957,14 @@ cid_selection_3gpp_context_step (GTask *task)
         ctx->step++;
         /* Fall through */
 
+    case CID_SELECTION_3GPP_STEP_VALIDATE_CACHED:
+        if (ctx->cached_cid) {
+            cid_selection_3gpp_validate_cached (task);
+            return;
+        }
+        ctx->step++;
+        /* Fall through */
+
     case CID_SELECTION_3GPP_STEP_FORMAT:
         cid_selection_3gpp_query_format (task);
         return;
@@ -892,11 +978,13 @@ cid_selection_3gpp_context_step (GTask *task)
         return;
 
     case CID_SELECTION_3GPP_STEP_INITIALIZE_CONTEXT:
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "cid-selection");
         cid_selection_3gpp_initialize_context (task);
         return;
 
     case CID_SELECTION_3GPP_STEP_LAST:
         g_assert (ctx->cid != 0);
+        mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), ctx->cid_reused ? "cid-selection" : "context-setup");
         g_task_return_int (task, (gssize) ctx->cid);
         g_object_unref (task);
         return;
@@ -940,6 +1028,12 @@ cid_selection_3gpp (MMBroadbandBearer   *self,
         return;
     }
 
+    /* Fast path on reconnections: check the context used in a previous
+     * successful connection, if any, with a single +CGDCONT? query */
+    ctx->cached_cid = mm_broadband_modem_lookup_pdp_context_cache (MM_BROADBAND_MODEM (modem),
+                                                                   mm_bearer_properties_get_apn (mm_base_bearer_peek_config (MM_BASE_BEARER (self))),
+                                                                   ctx->ip_family);
+
     cid_selection_3gpp_context_step (task);
 }
 
@@ -980,6 +1074,8 @@ get_ip_config_3gpp_ready (MMBroadbandBearer *self,
         return;
     }
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "ip-config");
+
     /* Keep port open during connection */
     if (MM_IS_PORT_SERIAL_AT (ctx->data))
         ctx->close_data_on_exit = FALSE;
@@ -1011,6 +1107,9 @@ dial_3gpp_ready (MMBroadbandBearer *self,
 
     ctx->data = MM_BROADBAND_BEARER_GET_CLASS (self)->dial_3gpp_finish (self, res, &error);
     if (!ctx->data) {
+        /* The context may no longer be valid, make sure it's checked again
+         * in the next attempt */
+        mm_broadband_modem_invalidate_pdp_context_cache (MM_BROADBAND_MODEM (ctx->modem), self->priv->cid);
         /* Clear CID when it failed to connect. */
         self->priv->cid = 0;
         g_task_return_error (task, error);
@@ -1018,6 +1117,13 @@ dial_3gpp_ready (MMBroadbandBearer *self,
         return;
     }
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "dial");
+
+    mm_broadband_modem_update_pdp_context_cache (MM_BROADBAND_MODEM (ctx->modem),
+                                                 mm_bearer_properties_get_apn (mm_base_bearer_peek_config (MM_BASE_BEARER (self))),
+                                                 ctx->ip_family,
+                                                 self->priv->cid);
+
     /* If the dialling operation used an AT port, it is assumed to have an extra
      * open() count. */
     if (MM_IS_PORT_SERIAL_AT (ctx->data))
@@ -1159,6 +1265,20 @@ connect_succeeded (GTask *task,
      * may already be set as connected, but no big deal. */
     mm_port_set_connected (self->priv->port, TRUE);
 
+    /* Network-initiated deactivations are reported with +CGEV URCs, if
+     * enabled, so the connection status doesn't need to be polled often */
+    if (connection_type == CONNECTION_TYPE_3GPP) {
+        MMBaseModem *modem = NULL;
+
+        g_object_get (self,
+                      MM_BASE_BEARER_MODEM, &modem,
+                      NULL);
+        if (MM_IS_BROADBAND_MODEM (modem) &&
+            mm_broadband_modem_get_packet_domain_events_enabled (MM_BROADBAND_MODEM (modem)))
+            mm_base_bearer_set_connection_events_available (MM_BASE_BEARER (self), TRUE);
+        g_clear_object (&modem);
+    }
+
     /* Set operation result */
     g_task_return_pointer (task,
                            result,
@@ -1181,6 +1301,8 @@ connect_cdma_ready (MMBroadbandBearer *self,
         return;
     }
 
+    mm_base_bearer_mark_connection_step (MM_BASE_BEARER (self), "dial");
+
     /* take result */
     connect_succeeded (task, CONNECTION_TYPE_CDMA, result);
 }
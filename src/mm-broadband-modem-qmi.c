@@ -9160,8 +9160,8 @@ parent_enabling_started_ready (MMBroadbandModem *_self,
         return;
     }
 
-    /* By default there is no generic WDS client preallocated in the QMI port,
-     * so explicitly allocate one ourselves */
+    /* There is no generic WDS client allocated by default in the QMI port,
+     * so get one ourselves (usually from the preallocated pool) */
     mm_port_qmi_allocate_client (ctx->qmi,
                                  QMI_SERVICE_WDS,
                                  MM_PORT_QMI_FLAG_DEFAULT,
@@ -9200,9 +9200,26 @@ static const QmiService qmi_services[] = {
     QMI_SERVICE_VOICE,
 };
 
+/* Clients preallocated right after opening the port: the ones above, plus
+ * the WDS clients of the autoconnect check and of the IPv4 and IPv6 sessions
+ * of the first connection */
+static const QmiService qmi_preallocated_services[] = {
+    QMI_SERVICE_DMS,
+    QMI_SERVICE_NAS,
+    QMI_SERVICE_WMS,
+    QMI_SERVICE_PDS,
+    QMI_SERVICE_OMA,
+    QMI_SERVICE_UIM,
+    QMI_SERVICE_LOC,
+    QMI_SERVICE_PDC,
+    QMI_SERVICE_VOICE,
+    QMI_SERVICE_WDS,
+    QMI_SERVICE_WDS,
+    QMI_SERVICE_WDS,
+};
+
 typedef struct {
     MMPortQmi *qmi;
-    guint service_index;
 } InitializationStartedContext;
 
 static void
@@ -9305,57 +9322,49 @@ untrack_qmi_device_removed (MMBroadbandModemQmi *self,
     self->priv->qmi_device_removed_id = 0;
 }
 
-static void allocate_next_client (GTask *task);
-
 static void
-qmi_port_allocate_client_ready (MMPortQmi *qmi,
-                                GAsyncResult *res,
-                                GTask *task)
+qmi_port_preallocate_clients_ready (MMPortQmi    *qmi,
+                                    GAsyncResult *res,
+                                    GTask        *task)
 {
     MMBroadbandModemQmi *self;
-    InitializationStartedContext *ctx;
-    GError *error = NULL;
+    GError              *error = NULL;
+    guint                i;
 
     self = g_task_get_source_object (task);
-    ctx  = g_task_get_task_data (task);
 
-    if (!mm_port_qmi_allocate_client_finish (qmi, res, &error)) {
-        mm_obj_dbg (self, "couldn't allocate client for service '%s': %s",
-                    qmi_service_get_string (qmi_services[ctx->service_index]),
-                    error->message);
+    if (!mm_port_qmi_preallocate_clients_finish (qmi, res, &error)) {
+        mm_obj_dbg (self, "couldn't preallocate clients: %s", error->message);
         g_error_free (error);
     }
 
-    ctx->service_index++;
-    allocate_next_client (task);
+    /* Services whose client couldn't be preallocated are not supported */
+    for (i = 0; i < G_N_ELEMENTS (qmi_services); i++) {
+        if (!mm_port_qmi_peek_client (qmi, qmi_services[i], MM_PORT_QMI_FLAG_DEFAULT) &&
+            !mm_port_qmi_claim_pooled_client (qmi, qmi_services[i], MM_PORT_QMI_FLAG_DEFAULT))
+            mm_obj_dbg (self, "no client allocated for service '%s'",
+                        qmi_service_get_string (qmi_services[i]));
+    }
+
+    /* Done we are, track device removal and launch parent's callback */
+    track_qmi_device_removed (self, qmi);
+    parent_initialization_started (task);
 }
 
 static void
-allocate_next_client (GTask *task)
+preallocate_clients (GTask *task)
 {
     InitializationStartedContext *ctx;
-    MMBroadbandModemQmi *self;
 
-    self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
-
-    if (ctx->service_index == G_N_ELEMENTS (qmi_services)) {
-        /* Done we are, track device removal and launch parent's callback */
-        track_qmi_device_removed (self, ctx->qmi);
-        parent_initialization_started (task);
-        return;
-    }
-
-    /* Otherwise, allocate next client */
-    mm_port_qmi_allocate_client (ctx->qmi,
-                                 qmi_services[ctx->service_index],
-                                 MM_PORT_QMI_FLAG_DEFAULT,
-                                 NULL,
-                                 (GAsyncReadyCallback)qmi_port_allocate_client_ready,
-                                 task);
+    mm_port_qmi_preallocate_clients (ctx->qmi,
+                                     qmi_preallocated_services,
+                                     G_N_ELEMENTS (qmi_preallocated_services),
+                                     NULL,
+                                     (GAsyncReadyCallback)qmi_port_preallocate_clients_ready,
+                                     task);
 }
 
-
 static void
 qmi_port_open_ready_no_data_format (MMPortQmi *qmi,
                                     GAsyncResult *res,
@@ -9369,7 +9378,7 @@ qmi_port_open_ready_no_data_format (MMPortQmi *qmi,
         return;
     }
 
-    allocate_next_client (task);
+    preallocate_clients (task);
 }
 
 static void
@@ -9400,7 +9409,7 @@ qmi_port_open_ready (MMPortQmi *qmi,
         return;
     }
 
-    allocate_next_client (task);
+    preallocate_clients (task);
 }
 
 static void
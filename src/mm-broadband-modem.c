@@ -45,10 +45,13 @@
 #include "mm-broadband-bearer.h"
 #include "mm-bearer-list.h"
 #include "mm-sms-list.h"
+#include "mm-sms-spool.h"
+#include "mm-pdp-context-cache.h"
 #include "mm-sms-part-3gpp.h"
 #include "mm-call-list.h"
 #include "mm-base-sim.h"
 #include "mm-log-object.h"
+#include "mm-context.h"
 #include "mm-modem-helpers.h"
 #include "mm-error-helpers.h"
 #include "mm-port-serial-qcdm.h"
@@ -171,7 +174,11 @@ struct _MMBroadbandModemPrivate {
     MM3gppCmerInd modem_cmer_ind;
     gboolean modem_cgerep_support_checked;
     gboolean modem_cgerep_supported;
+    gboolean modem_cgerep_enabled;
     MMFlowControl flow_control;
+    /* CIDs of the PDP contexts validated in previous connections, indexed
+     * by SIM, APN and IP type */
+    MMPdpContextCache *pdp_context_cache;
 
     /*<--- Modem 3GPP interface --->*/
     /* Properties */
@@ -221,6 +228,7 @@ struct _MMBroadbandModemPrivate {
     /* Properties */
     GObject *modem_messaging_dbus_skeleton;
     MMSmsList *modem_messaging_sms_list;
+    MMSmsSpool *modem_messaging_sms_spool;
     gboolean modem_messaging_sms_pdu_mode;
     MMSmsStorage modem_messaging_sms_default_storage;
     /* Implementation helpers */
@@ -244,6 +252,8 @@ struct _MMBroadbandModemPrivate {
     /*<--- Modem Signal interface --->*/
     /* Properties */
     GObject *modem_signal_dbus_skeleton;
+    /* Implementation helpers */
+    gboolean signal_cesq_supported;
 
     /*<--- Modem OMA interface --->*/
     /* Properties */
@@ -806,7 +816,7 @@ mode_pref_qcdm_ready (MMPortSerialQcdm *port,
         goto at_caps;
     }
 
-    err = qcdm_result_get_u8 (result, QCDM_CMD_NV_GET_MODE_PREF_ITEM_MODE_PREF, &pref);
+    err = qcdm_result_get_field_u8 (result, QCDM_CMD_NV_GET_MODE_PREF_FIELD_MODE_PREF, &pref);
     qcdm_result_unref (result);
     if (err) {
         mm_obj_dbg (self, "failed to read NV ModePref: %d", err);
@@ -1250,7 +1260,7 @@ mdn_qcdm_ready (MMPortSerialQcdm *port,
         return;
     }
 
-    if (qcdm_result_get_string (result, QCDM_CMD_NV_GET_MDN_ITEM_MDN, &numbers[0]) >= 0) {
+    if (qcdm_result_get_field_string (result, QCDM_CMD_NV_GET_MDN_FIELD_MDN, &numbers[0]) >= 0) {
         gboolean valid = TRUE;
         const char *p = numbers[0];
 
@@ -1998,8 +2008,16 @@ qcdm_evdo_pilot_sets_log_handle (MMPortSerialQcdm *port,
                                                     &pilot_pn,
                                                     &pilot_energy,
                                                     &rssi_dbm)) {
-        mm_obj_dbg (self, "EVDO active pilot RSSI: %ddBm", rssi_dbm);
+        MMSignal *evdo;
+
+        mm_obj_dbg (self, "EVDO active pilot PN %u RSSI: %ddBm", pilot_pn, rssi_dbm);
         self->priv->evdo_pilot_rssi = rssi_dbm;
+
+        /* The active pilot is the serving sector */
+        evdo = mm_signal_new ();
+        mm_signal_set_rssi (evdo, (gdouble) rssi_dbm);
+        mm_iface_modem_signal_update (MM_IFACE_MODEM_SIGNAL (self), NULL, evdo, NULL, NULL, NULL);
+        g_object_unref (evdo);
     }
 
     qcdm_result_unref (result);
@@ -2517,7 +2535,7 @@ access_tech_qcdm_wcdma_ready (MMPortSerialQcdm *port,
                                                       &err);
     g_byte_array_unref (response);
     if (result) {
-        qcdm_result_get_u8 (result, QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_ITEM_L1_STATE, &l1);
+        qcdm_result_get_field_u8 (result, QCDM_CMD_WCDMA_SUBSYS_STATE_INFO_FIELD_L1_STATE, &l1);
         qcdm_result_unref (result);
 
         if (l1 == QCDM_WCDMA_L1_STATE_PCH ||
@@ -2571,8 +2589,8 @@ access_tech_qcdm_gsm_ready (MMPortSerialQcdm *port,
 
     ctx = g_task_get_task_data (task);
 
-    qcdm_result_get_u8 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CM_OP_MODE, &opmode);
-    qcdm_result_get_u8 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_ITEM_CM_SYS_MODE, &sysmode);
+    qcdm_result_get_field_u8 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_OP_MODE, &opmode);
+    qcdm_result_get_field_u8 (result, QCDM_CMD_GSM_SUBSYS_STATE_INFO_FIELD_CM_SYS_MODE, &sysmode);
     qcdm_result_unref (result);
 
     ctx->opmode = opmode;
@@ -2622,8 +2640,8 @@ access_tech_qcdm_hdr_ready (MMPortSerialQcdm *port,
                                                     &err);
     g_byte_array_unref (response);
     if (result) {
-        qcdm_result_get_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_SESSION_STATE, &session);
-        qcdm_result_get_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_ALMP_STATE, &almp);
+        qcdm_result_get_field_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_SESSION_STATE, &session);
+        qcdm_result_get_field_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_ALMP_STATE, &almp);
         qcdm_result_unref (result);
 
         if (session == QCDM_CMD_HDR_SUBSYS_STATE_INFO_SESSION_STATE_OPEN &&
@@ -2673,9 +2691,9 @@ access_tech_qcdm_cdma_ready (MMPortSerialQcdm *port,
 
     ctx = g_task_get_task_data (task);
 
-    qcdm_result_get_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_OPERATING_MODE, &ctx->opmode);
-    qcdm_result_get_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_SYSTEM_MODE, &ctx->sysmode);
-    qcdm_result_get_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_HYBRID_PREF, &hybrid);
+    qcdm_result_get_field_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_OPERATING_MODE, &ctx->opmode);
+    qcdm_result_get_field_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_SYSTEM_MODE, &ctx->sysmode);
+    qcdm_result_get_field_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_HYBRID_PREF, &hybrid);
     qcdm_result_unref (result);
 
     ctx->hybrid = !!hybrid;
@@ -3082,10 +3100,13 @@ cgev_received (MMPortSerialAt   *port,
     case MM_3GPP_CGEV_NW_REACT:
         cgev_process_pdp (self, type, str);
         break;
-    case MM_3GPP_CGEV_NW_CLASS:
-    case MM_3GPP_CGEV_ME_CLASS:
     case MM_3GPP_CGEV_NW_MODIFY:
     case MM_3GPP_CGEV_ME_MODIFY:
+        /* Context parameters changed, they need to be validated again */
+        mm_broadband_modem_invalidate_pdp_context_cache (self, 0);
+        break;
+    case MM_3GPP_CGEV_NW_CLASS:
+    case MM_3GPP_CGEV_ME_CLASS:
         /* ignore */
         break;
     case MM_3GPP_CGEV_UNKNOWN:
@@ -3438,8 +3459,10 @@ modem_3gpp_cleanup_unsolicited_events (MMIfaceModem3gpp    *_self,
     if (!self->priv->modem_cind_disabled && self->priv->modem_cind_support_checked && self->priv->modem_cind_supported)
         set_ciev_unsolicited_events_handlers (self, FALSE);
 
-    if (self->priv->modem_cgerep_supported)
+    if (self->priv->modem_cgerep_supported) {
         set_cgev_unsolicited_events_handlers (self, FALSE);
+        self->priv->modem_cgerep_enabled = FALSE;
+    }
 
     g_task_return_boolean (task, TRUE);
     g_object_unref (task);
@@ -3458,6 +3481,7 @@ typedef struct {
     gchar          *cgerep_command;
     gboolean        cgerep_primary_done;
     gboolean        cgerep_secondary_done;
+    gboolean        cgerep_running;
 } UnsolicitedEventsContext;
 
 static void
@@ -3497,7 +3521,8 @@ unsolicited_events_setup_ready (MMBroadbandModem *self,
                     ctx->enable ? "enable" : "disable",
                     error->message);
         g_error_free (error);
-    }
+    } else if (ctx->enable && ctx->cgerep_running)
+        self->priv->modem_cgerep_enabled = TRUE;
 
     /* Continue on next port/command */
     run_unsolicited_events_setup (task);
@@ -3513,6 +3538,7 @@ run_unsolicited_events_setup (GTask *task)
 
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
+    ctx->cgerep_running = FALSE;
 
     /* CMER on primary port */
     if (!ctx->cmer_primary_done && ctx->cmer_command && ctx->primary && !self->priv->modem_cind_disabled) {
@@ -3532,6 +3558,7 @@ run_unsolicited_events_setup (GTask *task)
     else if (!ctx->cgerep_primary_done && ctx->cgerep_command && ctx->primary) {
         mm_obj_dbg (self, "%s +CGEV event reporting in primary port...", ctx->enable ? "enabling" : "disabling");
         ctx->cgerep_primary_done = TRUE;
+        ctx->cgerep_running = TRUE;
         command = ctx->cgerep_command;
         port = ctx->primary;
     }
@@ -3539,6 +3566,7 @@ run_unsolicited_events_setup (GTask *task)
     else if (!ctx->cgerep_secondary_done && ctx->cgerep_command && ctx->secondary) {
         mm_obj_dbg (self, "%s +CGEV event reporting in secondary port...", ctx->enable ? "enabling" : "disabling");
         ctx->cgerep_secondary_done = TRUE;
+        ctx->cgerep_running = TRUE;
         port = ctx->secondary;
         command = ctx->cgerep_command;
     }
@@ -3610,6 +3638,9 @@ modem_3gpp_disable_unsolicited_events (MMIfaceModem3gpp *_self,
     if (self->priv->modem_cgerep_support_checked && self->priv->modem_cgerep_supported)
         ctx->cgerep_command = g_strdup ("+CGEREP=0");
 
+    /* Stop relying on +CGEV as soon as disabling starts */
+    self->priv->modem_cgerep_enabled = FALSE;
+
     run_unsolicited_events_setup (task);
 }
 
@@ -6824,6 +6855,55 @@ modem_messaging_setup_sms_format (MMIfaceModemMessaging *self,
                               task);
 }
 
+/*****************************************************************************/
+/* SMS spool */
+
+static MMSmsSpool *
+peek_sms_spool (MMBroadbandModem *self)
+{
+    const gchar *directory;
+    const gchar *identifier = NULL;
+    gchar       *safe_identifier;
+
+    /* Only 3GPP PDUs are spooled */
+    directory = mm_context_get_sms_spool_dir ();
+    if (!directory || mm_iface_modem_is_huawei_sms (MM_IFACE_MODEM (self)))
+        return NULL;
+
+    if (self->priv->modem_sim) {
+        identifier = mm_gdbus_sim_get_sim_identifier (MM_GDBUS_SIM (self->priv->modem_sim));
+        if (!identifier)
+            identifier = mm_gdbus_sim_get_imsi (MM_GDBUS_SIM (self->priv->modem_sim));
+    }
+
+    if (!identifier || !identifier[0]) {
+        g_clear_object (&self->priv->modem_messaging_sms_spool);
+        return NULL;
+    }
+
+    safe_identifier = g_strcanon (g_strdup (identifier), G_CSET_A_2_Z G_CSET_a_2_z G_CSET_DIGITS "-_", '_');
+    if (self->priv->modem_messaging_sms_spool &&
+        g_strcmp0 (mm_sms_spool_get_sim_identifier (self->priv->modem_messaging_sms_spool), safe_identifier) != 0)
+        g_clear_object (&self->priv->modem_messaging_sms_spool);
+    if (!self->priv->modem_messaging_sms_spool)
+        self->priv->modem_messaging_sms_spool = mm_sms_spool_new (directory, safe_identifier);
+    g_free (safe_identifier);
+
+    return self->priv->modem_messaging_sms_spool;
+}
+
+void
+mm_broadband_modem_forget_sms_part (MMBroadbandModem *self,
+                                    MMSmsStorage      storage,
+                                    guint             index)
+{
+    MMSmsSpool *spool;
+
+    spool = peek_sms_spool (self);
+    if (spool)
+        mm_sms_spool_remove_part (spool, storage, index);
+}
+
 /*****************************************************************************/
 /* Setup/cleanup messaging related unsolicited events (Messaging interface) */
 
@@ -6880,6 +6960,11 @@ sms_part_ready (MMBroadbandModem *self,
     part = mm_sms_part_3gpp_new_from_pdu (info->index, info->pdu, self, &error);
   }
     if (part) {
+        MMSmsSpool *spool;
+
+        if (!info->is_huawei_sms && (spool = peek_sms_spool (self)) != NULL)
+            mm_sms_spool_add_part (spool, ctx->storage, ctx->idx, info->status, info->pdu);
+
         mm_obj_dbg (self, "correctly parsed PDU (%d)", ctx->idx);
         mm_obj_dbg (self, "with storage type (%d) default is (%d)",
                 ctx->storage, self->priv->modem_messaging_sms_default_storage);
@@ -7235,9 +7320,34 @@ modem_messaging_enable_unsolicited_events (MMIfaceModemMessaging *self,
 /* Load initial list of SMS parts (Messaging interface) */
 
 typedef struct {
-    MMSmsStorage list_storage;
+    MMSmsStorage    list_storage;
+    /* Streaming of PDU mode +CMGL responses */
+    MMPortSerialAt *port;
+    gboolean        have_header;
+    gint            header_index;
+    gint            header_status;
+    guint           n_streamed;
+    /* Spool being refreshed with the listed parts, if any */
+    MMSmsSpool     *spool;
+    guint           used;
+    /* Indexes in use not found in the spool */
+    GArray         *missing;
+    guint           missing_i;
 } ListPartsContext;
 
+static void
+list_parts_context_free (ListPartsContext *ctx)
+{
+    if (ctx->missing)
+        g_array_unref (ctx->missing);
+    g_clear_object (&ctx->spool);
+    if (ctx->port) {
+        mm_port_serial_at_set_intermediate_line_handler (ctx->port, NULL, NULL, NULL, NULL);
+        g_object_unref (ctx->port);
+    }
+    g_free (ctx);
+}
+
 static gboolean
 modem_messaging_load_initial_sms_parts_finish (MMIfaceModemMessaging *self,
                                                GAsyncResult *res,
@@ -7407,6 +7517,62 @@ sms_state_from_index (guint index)
     }
 }
 
+static void
+sms_pdu_part_list_take (MMBroadbandModem *self,
+                        ListPartsContext *ctx,
+                        gint              index,
+                        gint              status,
+                        const gchar      *pdu,
+                        gboolean          spooled)
+{
+    MMSmsPart *part;
+    GError    *error = NULL;
+
+    if (mm_iface_modem_is_huawei_sms (MM_IFACE_MODEM (self)))
+        part = mm_sms_part_cdma_new_from_pdu (index, pdu, self, &error);
+    else
+        part = mm_sms_part_3gpp_new_from_pdu (index, pdu, self, &error);
+
+    if (part) {
+        mm_obj_dbg (self, "correctly parsed PDU (%d)", index);
+        if (ctx->spool && !spooled)
+            mm_sms_spool_add_part (ctx->spool, ctx->list_storage, index, status, pdu);
+        mm_iface_modem_messaging_take_part (MM_IFACE_MODEM_MESSAGING (self),
+                                            part,
+                                            sms_state_from_index (status),
+                                            ctx->list_storage);
+    } else {
+        /* Don't treat the error as critical */
+        mm_obj_dbg (self, "error parsing PDU (%d): %s", index, error->message);
+        g_error_free (error);
+    }
+}
+
+static gboolean
+sms_pdu_part_list_line (MMPortSerialAt *port,
+                        const gchar    *line,
+                        GTask          *task)
+{
+    MMBroadbandModem *self;
+    ListPartsContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    /* +CMGL: <index>,<stat>,[<alpha>],<length><CR><LF><pdu><CR><LF> */
+    if (!ctx->have_header) {
+        if (!mm_3gpp_parse_pdu_cmgl_header (line, &ctx->header_index, &ctx->header_status))
+            return FALSE;
+        ctx->have_header = TRUE;
+        return TRUE;
+    }
+
+    ctx->have_header = FALSE;
+    ctx->n_streamed++;
+    sms_pdu_part_list_take (self, ctx, ctx->header_index, ctx->header_status, line, FALSE);
+    return TRUE;
+}
+
 static void
 sms_pdu_part_list_ready (MMBroadbandModem *self,
                          GAsyncResult *res,
@@ -7421,6 +7587,14 @@ sms_pdu_part_list_ready (MMBroadbandModem *self,
     /* Always always always unlock mem1 storage. Warned you've been. */
     mm_broadband_modem_unlock_sms_storages (self, TRUE, FALSE);
 
+    /* Streaming is over, whatever the result */
+    ctx = g_task_get_task_data (task);
+    if (ctx->port) {
+        mm_port_serial_at_set_intermediate_line_handler (ctx->port, NULL, NULL, NULL, NULL);
+        g_clear_object (&ctx->port);
+        mm_obj_dbg (self, "processed %u SMS parts while listing", ctx->n_streamed);
+    }
+
     response = mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, &error);
     if (error) {
         g_task_return_error (task, error);
@@ -7428,6 +7602,7 @@ sms_pdu_part_list_ready (MMBroadbandModem *self,
         return;
     }
 
+    /* Process whatever wasn't already streamed */
     info_list = mm_3gpp_parse_pdu_cmgl_response (response, &error);
     if (error) {
         g_task_return_error (task, error);
@@ -7435,43 +7610,228 @@ sms_pdu_part_list_ready (MMBroadbandModem *self,
         return;
     }
 
-    ctx = g_task_get_task_data (task);
-    gboolean is_huawei_sms = mm_iface_modem_is_huawei_sms (MM_IFACE_MODEM(self));
-
     for (l = info_list; l; l = g_list_next (l)) {
         MM3gppPduInfo *info = l->data;
-        MMSmsPart *part;
 
-      if (is_huawei_sms) {
-        part = mm_sms_part_cdma_new_from_pdu (info->index, info->pdu, self, &error);
-      } else {
-        part = mm_sms_part_3gpp_new_from_pdu (info->index, info->pdu, self, &error);
-      }
-        if (part) {
-            mm_obj_dbg (self, "correctly parsed PDU (%d)", info->index);
-            mm_iface_modem_messaging_take_part (MM_IFACE_MODEM_MESSAGING (self),
-                                                part,
-                                                sms_state_from_index (info->status),
-                                                ctx->list_storage);
-        } else {
-            /* Don't treat the error as critical */
-            mm_obj_dbg (self, "error parsing PDU (%d): %s", info->index, error->message);
-            g_clear_error (&error);
-        }
+        sms_pdu_part_list_take (self, ctx, info->index, info->status, info->pdu, FALSE);
     }
 
     mm_3gpp_pdu_info_list_free (info_list);
 
+    /* The spool now holds the whole storage */
+    if (ctx->spool)
+        mm_sms_spool_set_storage_listed (ctx->spool, ctx->list_storage);
+
     /* We consider all done */
     g_task_return_boolean (task, TRUE);
     g_object_unref (task);
 }
 
+static void
+sms_pdu_part_list_run (MMBroadbandModem *self,
+                       GTask            *task)
+{
+    ListPartsContext *ctx;
+    GError *error = NULL;
+
+    /* In PDU mode, process each listed part as soon as it's received, instead
+     * of waiting for the whole list */
+    ctx = g_task_get_task_data (task);
+    ctx->port = mm_base_modem_get_best_at_port (MM_BASE_MODEM (self), &error);
+    if (!ctx->port) {
+        mm_broadband_modem_unlock_sms_storages (self, TRUE, FALSE);
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    /* The handler only becomes active once the listing command is the one
+     * being processed by the port */
+    mm_port_serial_at_set_intermediate_line_handler (ctx->port,
+                                                     "+CMGL=4",
+                                                     (MMPortSerialAtIntermediateLineFn)sms_pdu_part_list_line,
+                                                     task,
+                                                     NULL);
+    mm_base_modem_at_command_full (MM_BASE_MODEM (self),
+                                   ctx->port,
+                                   "+CMGL=4",
+                                   20,
+                                   FALSE,
+                                   FALSE,
+                                   NULL,
+                                   (GAsyncReadyCallback)sms_pdu_part_list_ready,
+                                   task);
+}
+
+static void
+list_parts_take_spooled (MMBroadbandModem *self,
+                         ListPartsContext *ctx)
+{
+    GList *info_list;
+    GList *l;
+
+    info_list = mm_sms_spool_get_parts (ctx->spool, ctx->list_storage);
+    mm_obj_dbg (self, "loading %u SMS parts from spool", g_list_length (info_list));
+    for (l = info_list; l; l = g_list_next (l)) {
+        MM3gppPduInfo *info = l->data;
+
+        sms_pdu_part_list_take (self, ctx, info->index, info->status, info->pdu, TRUE);
+    }
+    mm_3gpp_pdu_info_list_free (info_list);
+}
+
+static void list_parts_read_next_missing (MMBroadbandModem *self,
+                                          GTask            *task);
+
+static void
+list_parts_cmgr_ready (MMBroadbandModem *self,
+                       GAsyncResult     *res,
+                       GTask            *task)
+{
+    ListPartsContext *ctx;
+    const gchar *response;
+    MM3gppPduInfo *info = NULL;
+    GError *error = NULL;
+    guint index;
+
+    ctx = g_task_get_task_data (task);
+    index = g_array_index (ctx->missing, guint, ctx->missing_i++);
+
+    response = mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, &error);
+    if (response)
+        info = mm_3gpp_parse_cmgr_read_response (response, index, &error);
+
+    if (!info) {
+        /* Don't treat the error as critical, the part count won't match
+         * next time, so we'll retry */
+        mm_obj_dbg (self, "couldn't read SMS part (%u): %s", index, error->message);
+        g_error_free (error);
+    } else {
+        sms_pdu_part_list_take (self, ctx, info->index, info->status, info->pdu, FALSE);
+        mm_3gpp_pdu_info_free (info);
+    }
+
+    list_parts_read_next_missing (self, task);
+}
+
+static void
+list_parts_read_next_missing (MMBroadbandModem *self,
+                              GTask            *task)
+{
+    ListPartsContext *ctx;
+    gchar *command;
+
+    ctx = g_task_get_task_data (task);
+
+    if (ctx->missing_i == ctx->missing->len) {
+        mm_broadband_modem_unlock_sms_storages (self, TRUE, FALSE);
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    command = g_strdup_printf ("+CMGR=%u", g_array_index (ctx->missing, guint, ctx->missing_i));
+    mm_base_modem_at_command (MM_BASE_MODEM (self),
+                              command,
+                              10,
+                              FALSE,
+                              (GAsyncReadyCallback)list_parts_cmgr_ready,
+                              task);
+    g_free (command);
+}
+
+static void
+list_parts_cmgd_test_ready (MMBroadbandModem *self,
+                            GAsyncResult *res,
+                            GTask *task)
+{
+    ListPartsContext *ctx;
+    const gchar *response;
+    GArray *indexes = NULL;
+    GError *error = NULL;
+
+    ctx = g_task_get_task_data (task);
+
+    response = mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, &error);
+    if (response)
+        indexes = mm_3gpp_parse_cmgd_test_response (response, &error);
+    if (!indexes) {
+        mm_obj_dbg (self, "couldn't query used SMS indexes, listing parts: %s", error->message);
+        g_error_free (error);
+        goto list;
+    }
+
+    /* Some modems report the supported indexes instead of the used ones */
+    if (indexes->len != ctx->used) {
+        mm_obj_dbg (self, "reported SMS indexes (%u) don't match used ones (%u), listing parts",
+                    indexes->len, ctx->used);
+        g_array_unref (indexes);
+        goto list;
+    }
+
+    ctx->missing = mm_sms_spool_sync_storage (ctx->spool, ctx->list_storage, indexes);
+    g_array_unref (indexes);
+
+    list_parts_take_spooled (self, ctx);
+    mm_obj_dbg (self, "reading %u SMS parts missing in spool", ctx->missing->len);
+    list_parts_read_next_missing (self, task);
+    return;
+
+list:
+    mm_sms_spool_clear_storage (ctx->spool, ctx->list_storage);
+    sms_pdu_part_list_run (self, task);
+}
+
+static void
+list_parts_cpms_query_ready (MMBroadbandModem *self,
+                             GAsyncResult *res,
+                             GTask *task)
+{
+    ListPartsContext *ctx;
+    const gchar *response;
+    GError *error = NULL;
+
+    ctx = g_task_get_task_data (task);
+
+    response = mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, &error);
+    if (!response || !mm_3gpp_parse_cpms_query_used (response, &ctx->used, &error)) {
+        mm_obj_dbg (self, "couldn't query used SMS storage, listing parts: %s", error->message);
+        g_error_free (error);
+        goto list;
+    }
+
+    /* Spool is up to date, no need to refresh it */
+    if (mm_sms_spool_check_storage (ctx->spool, ctx->list_storage, ctx->used)) {
+        mm_broadband_modem_unlock_sms_storages (self, TRUE, FALSE);
+        list_parts_take_spooled (self, ctx);
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    /* Spool out of date, find out which parts it's missing, if any */
+    if (mm_sms_spool_get_storage_listed (ctx->spool, ctx->list_storage)) {
+        mm_base_modem_at_command (MM_BASE_MODEM (self),
+                                  "+CMGD=?",
+                                  3,
+                                  FALSE,
+                                  (GAsyncReadyCallback)list_parts_cmgd_test_ready,
+                                  task);
+        return;
+    }
+
+list:
+    mm_obj_dbg (self, "SMS spool is out of date, listing parts");
+    mm_sms_spool_clear_storage (ctx->spool, ctx->list_storage);
+    sms_pdu_part_list_run (self, task);
+}
+
 static void
 list_parts_lock_storages_ready (MMBroadbandModem *self,
                                 GAsyncResult *res,
                                 GTask *task)
 {
+    ListPartsContext *ctx;
     GError *error = NULL;
 
     if (!mm_broadband_modem_lock_sms_storages_finish (self, res, &error)) {
@@ -7486,16 +7846,32 @@ list_parts_lock_storages_ready (MMBroadbandModem *self,
 
     /* Get SMS parts from ALL types.
      * Different command to be used if we are on Text or PDU mode */
-    mm_base_modem_at_command (MM_BASE_MODEM (self),
-                              (MM_BROADBAND_MODEM (self)->priv->modem_messaging_sms_pdu_mode ?
-                               "+CMGL=4" :
-                               "+CMGL=\"ALL\""),
-                              20,
-                              FALSE,
-                              (GAsyncReadyCallback) (MM_BROADBAND_MODEM (self)->priv->modem_messaging_sms_pdu_mode ?
-                                                     sms_pdu_part_list_ready :
-                                                     sms_text_part_list_ready),
-                              task);
+    if (!MM_BROADBAND_MODEM (self)->priv->modem_messaging_sms_pdu_mode) {
+        mm_base_modem_at_command (MM_BASE_MODEM (self),
+                                  "+CMGL=\"ALL\"",
+                                  20,
+                                  FALSE,
+                                  (GAsyncReadyCallback)sms_text_part_list_ready,
+                                  task);
+        return;
+    }
+
+    /* If the storage contents are already spooled, check whether they
+     * changed before listing them all again */
+    ctx = g_task_get_task_data (task);
+    ctx->spool = peek_sms_spool (self);
+    if (ctx->spool) {
+        g_object_ref (ctx->spool);
+        mm_base_modem_at_command (MM_BASE_MODEM (self),
+                                  "+CPMS?",
+                                  3,
+                                  FALSE,
+                                  (GAsyncReadyCallback)list_parts_cpms_query_ready,
+                                  task);
+        return;
+    }
+
+    sms_pdu_part_list_run (self, task);
 }
 
 static void
@@ -7507,11 +7883,11 @@ modem_messaging_load_initial_sms_parts (MMIfaceModemMessaging *self,
     ListPartsContext *ctx;
     GTask *task;
 
-    ctx = g_new (ListPartsContext, 1);
+    ctx = g_new0 (ListPartsContext, 1);
     ctx->list_storage = storage;
 
     task = g_task_new (self, NULL, callback, user_data);
-    g_task_set_task_data (task, ctx, g_free);
+    g_task_set_task_data (task, ctx, (GDestroyNotify)list_parts_context_free);
 
     mm_obj_dbg (self, "listing SMS parts in storage '%s'", mm_sms_storage_get_string (storage));
 
@@ -8510,51 +8886,35 @@ cdma_unsolicited_events_context_free (CdmaUnsolicitedEventsContext *ctx)
 }
 
 static void
-logcmd_qcdm_ready (MMPortSerialQcdm *port,
-                   GAsyncResult *res,
-                   GTask *task)
+log_mask_qcdm_ready (MMPortSerialQcdm *port,
+                     GAsyncResult *res,
+                     GTask *task)
 {
     MMBroadbandModem *self;
     CdmaUnsolicitedEventsContext *ctx;
-    QcdmResult *result;
-    gint err = QCDM_SUCCESS;
-    GByteArray *response;
     GError *error = NULL;
 
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
-    response = mm_port_serial_qcdm_command_finish (port, res, &error);
-    if (error) {
+    if (!mm_port_serial_qcdm_set_log_mask_finish (port, res, &error)) {
+        if (ctx->setup)
+            mm_port_serial_qcdm_enable_unsolicited_msg_handler (port, DM_LOG_ITEM_EVDO_PILOT_SETS_V2, FALSE);
         ctx->close_port = TRUE;
         g_task_return_error (task, error);
         g_object_unref (task);
         return;
     }
 
-    /* Parse the response */
-    result = qcdm_cmd_log_config_set_mask_result ((const gchar *) response->data,
-                                                  response->len,
-                                                  &err);
-    g_byte_array_unref (response);
-    if (!result) {
-        ctx->close_port = TRUE;
-        g_task_return_new_error (task,
-                                 MM_CORE_ERROR,
-                                 MM_CORE_ERROR_FAILED,
-                                 "Failed to parse Log Config Set Mask command result: %d",
-                                 err);
-        g_object_unref (task);
-        return;
-    }
-
-    mm_port_serial_qcdm_add_unsolicited_msg_handler (port,
-                                                     DM_LOG_ITEM_EVDO_PILOT_SETS_V2,
-                                                     ctx->setup ? qcdm_evdo_pilot_sets_log_handle : NULL,
-                                                     self,
-                                                     NULL);
+    if (!ctx->setup) {
+        QcdmLogStreamStats stats;
 
-    qcdm_result_unref (result);
+        mm_port_serial_qcdm_enable_unsolicited_msg_handler (port, DM_LOG_ITEM_EVDO_PILOT_SETS_V2, FALSE);
+        mm_port_serial_qcdm_get_log_stats (port, &stats);
+        mm_obj_dbg (self, "QCDM log items: %" G_GSIZE_FORMAT " handled, %" G_GSIZE_FORMAT " unhandled, "
+                    "%" G_GSIZE_FORMAT " invalid frames, %" G_GSIZE_FORMAT " bytes dropped",
+                    stats.n_items, stats.n_unhandled, stats.n_invalid, stats.n_dropped_bytes);
+    }
 
     /* Balance the mm_port_seral_open() from modem_cdma_setup_cleanup_unsolicited_events().
      * We want to close it in either case:
@@ -8577,12 +8937,10 @@ modem_cdma_setup_cleanup_unsolicited_events (MMBroadbandModem *self,
 {
     CdmaUnsolicitedEventsContext *ctx;
     GTask *task;
-    GByteArray *logcmd;
-    uint16_t log_items[] = { DM_LOG_ITEM_EVDO_PILOT_SETS_V2, 0 };
     GError *error = NULL;
 
     ctx = g_new0 (CdmaUnsolicitedEventsContext, 1);
-    ctx->setup = TRUE;
+    ctx->setup = setup;
 
     task = g_task_new (self, NULL, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)cdma_unsolicited_events_context_free);
@@ -8606,20 +8964,20 @@ modem_cdma_setup_cleanup_unsolicited_events (MMBroadbandModem *self,
         }
     }
 
-    logcmd = g_byte_array_sized_new (512);
-    logcmd->len = qcdm_cmd_log_config_set_mask_new ((char *) logcmd->data,
-                                                    512,
-                                                    0x01,  /* Equipment ID */
-                                                    setup ? log_items : NULL);
-    assert (logcmd->len);
+    /* The handler must be in place for the mask to include its log item */
+    if (setup)
+        mm_port_serial_qcdm_add_unsolicited_msg_handler (ctx->qcdm,
+                                                         DM_LOG_ITEM_EVDO_PILOT_SETS_V2,
+                                                         qcdm_evdo_pilot_sets_log_handle,
+                                                         self,
+                                                         NULL);
 
-    mm_port_serial_qcdm_command (ctx->qcdm,
-                                 logcmd,
-                                 5,
-                                 NULL,
-                                 (GAsyncReadyCallback)logcmd_qcdm_ready,
-                                 task);
-    g_byte_array_unref (logcmd);
+    mm_port_serial_qcdm_set_log_mask (ctx->qcdm,
+                                      0x01, /* Equipment ID */
+                                      setup,
+                                      NULL,
+                                      (GAsyncReadyCallback)log_mask_qcdm_ready,
+                                      task);
 }
 
 static gboolean
@@ -8725,11 +9083,11 @@ hdr_subsys_state_info_ready (MMPortSerialQcdm *port,
 
     /* Build results */
     results = g_new0 (HdrStateResults, 1);
-    qcdm_result_get_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_HDR_HYBRID_MODE, &results->hybrid_mode);
+    qcdm_result_get_field_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_HDR_HYBRID_MODE, &results->hybrid_mode);
     results->session_state = QCDM_CMD_HDR_SUBSYS_STATE_INFO_SESSION_STATE_CLOSED;
-    qcdm_result_get_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_SESSION_STATE, &results->session_state);
+    qcdm_result_get_field_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_SESSION_STATE, &results->session_state);
     results->almp_state = QCDM_CMD_HDR_SUBSYS_STATE_INFO_ALMP_STATE_INACTIVE;
-    qcdm_result_get_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_ITEM_ALMP_STATE, &results->almp_state);
+    qcdm_result_get_field_u8 (result, QCDM_CMD_HDR_SUBSYS_STATE_INFO_FIELD_ALMP_STATE, &results->almp_state);
     qcdm_result_unref (result);
 
     g_task_return_pointer (task, results, g_free);
@@ -8852,8 +9210,8 @@ cm_subsys_state_info_ready (MMPortSerialQcdm *port,
 
     /* Build results */
     results = g_new0 (CallManagerStateResults, 1);
-    qcdm_result_get_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_OPERATING_MODE, &results->operating_mode);
-    qcdm_result_get_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_ITEM_SYSTEM_MODE, &results->system_mode);
+    qcdm_result_get_field_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_OPERATING_MODE, &results->operating_mode);
+    qcdm_result_get_field_u32 (result, QCDM_CMD_CM_SUBSYS_STATE_INFO_FIELD_SYSTEM_MODE, &results->system_mode);
     qcdm_result_unref (result);
 
     g_task_return_pointer (task, results, g_free);
@@ -9137,9 +9495,9 @@ qcdm_cdma_status_ready (MMPortSerialQcdm *port,
 
     g_byte_array_unref (response);
 
-    qcdm_result_get_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_RX_STATE, &rxstate);
-    qcdm_result_get_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_SID, &sid);
-    qcdm_result_get_u32 (result, QCDM_CMD_CDMA_STATUS_ITEM_NID, &nid);
+    qcdm_result_get_field_u32 (result, QCDM_CMD_CDMA_STATUS_FIELD_RX_STATE, &rxstate);
+    qcdm_result_get_field_u32 (result, QCDM_CMD_CDMA_STATUS_FIELD_SID, &sid);
+    qcdm_result_get_field_u32 (result, QCDM_CMD_CDMA_STATUS_FIELD_NID, &nid);
     qcdm_result_unref (result);
 
     /* 99999 means unknown/no service */
@@ -10005,7 +10363,32 @@ modem_signal_check_support_finish (MMIfaceModemSignal  *self,
                                    GAsyncResult        *res,
                                    GError             **error)
 {
-    return !!mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, error);
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+cesq_test_ready (MMBaseModem  *_self,
+                 GAsyncResult *res,
+                 GTask        *task)
+{
+    MMBroadbandModem *self = MM_BROADBAND_MODEM (_self);
+    GError           *error = NULL;
+
+    self->priv->signal_cesq_supported = !!mm_base_modem_at_command_finish (_self, res, &error);
+    if (self->priv->signal_cesq_supported) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    /* EVDO values are also streamed over QCDM */
+    if (mm_base_modem_peek_port_qcdm (_self) && mm_iface_modem_is_cdma (MM_IFACE_MODEM (self))) {
+        mm_obj_dbg (self, "extended signal information only available from QCDM log items");
+        g_error_free (error);
+        g_task_return_boolean (task, TRUE);
+    } else
+        g_task_return_error (task, error);
+    g_object_unref (task);
 }
 
 static void
@@ -10017,8 +10400,8 @@ modem_signal_check_support (MMIfaceModemSignal  *self,
                               "+CESQ=?",
                               3,
                               TRUE,
-                              callback,
-                              user_data);
+                              (GAsyncReadyCallback)cesq_test_ready,
+                              g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -10036,11 +10419,23 @@ modem_signal_load_values_finish (MMIfaceModemSignal  *self,
 {
     const gchar *response;
 
-    response = mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, error);
-    if (!response || !mm_3gpp_cesq_response_to_signal_info (response, self, gsm, umts, lte, error))
-        return FALSE;
+    /* Nothing to poll, values only come from QCDM log items */
+    if (!MM_BROADBAND_MODEM (self)->priv->signal_cesq_supported) {
+        if (!g_task_propagate_boolean (G_TASK (res), error))
+            return FALSE;
+        if (gsm)
+            *gsm = NULL;
+        if (umts)
+            *umts = NULL;
+        if (lte)
+            *lte = NULL;
+    } else {
+        response = mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, error);
+        if (!response || !mm_3gpp_cesq_response_to_signal_info (response, self, gsm, umts, lte, error))
+            return FALSE;
+    }
 
-    /* No 3GPP2 support */
+    /* No 3GPP2 polling, EVDO values are reported from QCDM log items */
     if (cdma)
         *cdma = NULL;
     if (evdo)
@@ -10054,6 +10449,15 @@ modem_signal_load_values (MMIfaceModemSignal  *self,
                           GAsyncReadyCallback  callback,
                           gpointer             user_data)
 {
+    GTask *task;
+
+    if (!MM_BROADBAND_MODEM (self)->priv->signal_cesq_supported) {
+        task = g_task_new (self, cancellable, callback, user_data);
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
     mm_base_modem_at_command (MM_BASE_MODEM (self),
                               "+CESQ",
                               3,
@@ -11884,6 +12288,8 @@ after_hotswap_event_disable_ready (MMBaseModem *self,
 void
 mm_broadband_modem_update_sim_hot_swap_detected (MMBroadbandModem *self)
 {
+    mm_broadband_modem_invalidate_pdp_context_cache (self, 0);
+
     if (self->priv->sim_hot_swap_ports_ctx) {
         mm_obj_dbg (self, "releasing SIM hot swap ports context");
         ports_context_unref (self->priv->sim_hot_swap_ports_ctx);
@@ -11898,6 +12304,72 @@ mm_broadband_modem_update_sim_hot_swap_detected (MMBroadbandModem *self)
 
 /*****************************************************************************/
 
+gboolean
+mm_broadband_modem_get_packet_domain_events_enabled (MMBroadbandModem *self)
+{
+    return self->priv->modem_cgerep_enabled;
+}
+
+/*****************************************************************************/
+
+static const gchar *
+pdp_context_cache_get_sim_identifier (MMBroadbandModem *self)
+{
+    /* Contexts are only cached if we know which SIM they're used with */
+    if (!self->priv->modem_sim)
+        return NULL;
+    return mm_gdbus_sim_get_sim_identifier (MM_GDBUS_SIM (self->priv->modem_sim));
+}
+
+guint
+mm_broadband_modem_lookup_pdp_context_cache (MMBroadbandModem *self,
+                                             const gchar      *apn,
+                                             MMBearerIpFamily  ip_family)
+{
+    if (!self->priv->pdp_context_cache)
+        return 0;
+
+    return mm_pdp_context_cache_lookup (self->priv->pdp_context_cache,
+                                        pdp_context_cache_get_sim_identifier (self),
+                                        apn,
+                                        ip_family);
+}
+
+void
+mm_broadband_modem_invalidate_pdp_context_cache (MMBroadbandModem *self,
+                                                 guint             cid)
+{
+    if (!self->priv->pdp_context_cache)
+        return;
+
+    if (!mm_pdp_context_cache_invalidate (self->priv->pdp_context_cache, cid))
+        return;
+
+    if (cid)
+        mm_obj_dbg (self, "PDP context cache invalidated for cid %u", cid);
+    else
+        mm_obj_dbg (self, "PDP context cache invalidated");
+}
+
+void
+mm_broadband_modem_update_pdp_context_cache (MMBroadbandModem *self,
+                                             const gchar      *apn,
+                                             MMBearerIpFamily  ip_family,
+                                             guint             cid)
+{
+    if (G_UNLIKELY (!self->priv->pdp_context_cache))
+        self->priv->pdp_context_cache = mm_pdp_context_cache_new ();
+
+    if (mm_pdp_context_cache_update (self->priv->pdp_context_cache,
+                                     pdp_context_cache_get_sim_identifier (self),
+                                     apn,
+                                     ip_family,
+                                     cid))
+        mm_obj_dbg (self, "PDP context cache updated: cid %u", cid);
+}
+
+/*****************************************************************************/
+
 MMBroadbandModem *
 mm_broadband_modem_new (const gchar *device,
                         const gchar **drivers,
@@ -12254,6 +12726,8 @@ finalize (GObject *object)
 
     g_free (self->priv->carrier_config_mapping);
 
+    g_clear_pointer (&self->priv->pdp_context_cache, mm_pdp_context_cache_free);
+
     G_OBJECT_CLASS (mm_broadband_modem_parent_class)->finalize (object);
 }
 
@@ -12321,6 +12795,7 @@ dispose (GObject *object)
     g_clear_object (&self->priv->modem_sim);
     g_clear_object (&self->priv->modem_bearer_list);
     g_clear_object (&self->priv->modem_messaging_sms_list);
+    g_clear_object (&self->priv->modem_messaging_sms_spool);
     g_clear_object (&self->priv->modem_voice_call_list);
     g_clear_object (&self->priv->modem_simple_status);
 
@@ -131,6 +131,28 @@ gboolean mm_broadband_modem_lock_sms_storages_finish (MMBroadbandModem *self,
 void     mm_broadband_modem_unlock_sms_storages      (MMBroadbandModem *self,
                                                       gboolean mem1,
                                                       gboolean mem2);
+/* Drop a stored SMS part from the on-disk spool, if any */
+void     mm_broadband_modem_forget_sms_part          (MMBroadbandModem *self,
+                                                      MMSmsStorage storage,
+                                                      guint index);
+
+/* Whether +CGEV packet domain events are enabled, so that bearers get
+ * notified about network-initiated disconnections */
+gboolean mm_broadband_modem_get_packet_domain_events_enabled (MMBroadbandModem *self);
+
+/* Cache of the PDP contexts successfully used with the current SIM, so that
+ * reconnections may skip the context lookup and setup. A cid of 0 in the
+ * invalidation removes all the entries. */
+guint    mm_broadband_modem_lookup_pdp_context_cache     (MMBroadbandModem *self,
+                                                          const gchar      *apn,
+                                                          MMBearerIpFamily  ip_family);
+void     mm_broadband_modem_update_pdp_context_cache     (MMBroadbandModem *self,
+                                                          const gchar      *apn,
+                                                          MMBearerIpFamily  ip_family,
+                                                          guint             cid);
+void     mm_broadband_modem_invalidate_pdp_context_cache (MMBroadbandModem *self,
+                                                          guint             cid);
+
 /* Helper to update SIM hot swap */
 void mm_broadband_modem_update_sim_hot_swap_detected (MMBroadbandModem *self);
 
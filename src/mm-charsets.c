@@ -404,17 +404,17 @@ utf8_to_gsm_ext_char (const char *utf8, guint32 len, guint8 *out_gsm)
     return FALSE;
 }
 
-guint8 *
-mm_charset_gsm_unpacked_to_utf8 (const guint8 *gsm, guint32 len)
+gsize
+mm_charset_gsm_unpacked_to_utf8_buf (const guint8 *gsm,
+                                     guint32       len,
+                                     gchar        *out,
+                                     gsize         out_size)
 {
     guint i;
-    GByteArray *utf8;
-
-    g_return_val_if_fail (gsm != NULL, NULL);
-    g_return_val_if_fail (len < 4096, NULL);
+    gsize n = 0;
 
-    /* worst case initial length */
-    utf8 = g_byte_array_sized_new (len * 2 + 1);
+    g_return_val_if_fail (gsm != NULL, 0);
+    g_return_val_if_fail (out_size >= MM_CHARSET_GSM_UTF8_MAX_LEN (len), 0);
 
     for (i = 0; i < len; i++) {
         guint8 uchars[4];
@@ -444,7 +444,7 @@ mm_charset_gsm_unpacked_to_utf8 (const guint8 *gsm, guint32 len)
 
         if (gsm[i] == GSM_ESCAPE_CHAR) {
             /* Extended alphabet, decode next char */
-            ulen = gsm_ext_char_to_utf8 (gsm[i+1], uchars);
+            ulen = (i + 1 < len) ? gsm_ext_char_to_utf8 (gsm[i+1], uchars) : 0;
             if (ulen)
                 i += 1;
         } else {
@@ -452,15 +452,31 @@ mm_charset_gsm_unpacked_to_utf8 (const guint8 *gsm, guint32 len)
             ulen = gsm_def_char_to_utf8 (gsm[i], uchars);
         }
 
-        if (ulen)
-            g_byte_array_append (utf8, &uchars[0], ulen);
-        else
-            g_byte_array_append (utf8, (guint8 *) "?", 1);
+        if (ulen) {
+            memcpy (&out[n], &uchars[0], ulen);
+            n += ulen;
+        } else
+            out[n++] = '?';
     }
 
     /* Always make sure returned string is NUL terminated */
-    g_byte_array_append (utf8, (guint8 *) "\0", 1);
-    return g_byte_array_free (utf8, FALSE);
+    out[n] = '\0';
+    return n;
+}
+
+guint8 *
+mm_charset_gsm_unpacked_to_utf8 (const guint8 *gsm, guint32 len)
+{
+    gchar *utf8;
+    gsize utf8_len;
+
+    g_return_val_if_fail (gsm != NULL, NULL);
+    g_return_val_if_fail (len < 4096, NULL);
+
+    /* worst case length */
+    utf8 = g_malloc (MM_CHARSET_GSM_UTF8_MAX_LEN (len));
+    utf8_len = mm_charset_gsm_unpacked_to_utf8_buf (gsm, len, utf8, MM_CHARSET_GSM_UTF8_MAX_LEN (len));
+    return (guint8 *) g_realloc (utf8, utf8_len + 1);
 }
 
 guint8 *
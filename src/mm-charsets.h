@@ -63,6 +63,15 @@ guint8 *mm_charset_utf8_to_unpacked_gsm (const char *utf8, guint32 *out_len);
 
 guint8 *mm_charset_gsm_unpacked_to_utf8 (const guint8 *gsm, guint32 len);
 
+/* Same as above, but writing to a caller-provided buffer, which must hold at
+ * least MM_CHARSET_GSM_UTF8_MAX_LEN(len) bytes. Returns the length of the
+ * NUL-terminated string written. */
+#define MM_CHARSET_GSM_UTF8_MAX_LEN(len) (((gsize)(len) * 3) + 1)
+gsize mm_charset_gsm_unpacked_to_utf8_buf (const guint8 *gsm,
+                                           guint32       len,
+                                           gchar        *out,
+                                           gsize         out_size);
+
 /* Checks whether conversion to the given charset may be done without errors */
 gboolean mm_charset_can_convert_to (const char *utf8,
                                     MMModemCharset charset);
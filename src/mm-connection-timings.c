@@ -0,0 +1,188 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include "mm-connection-timings.h"
+
+typedef struct {
+    gchar  *name;
+    /* Milliseconds since the start of the attempt */
+    guint   elapsed;
+} Step;
+
+struct _MMConnectionTimings {
+    gint64  start_time;
+    GArray *steps;
+};
+
+/*****************************************************************************/
+
+static void
+step_clear (Step *step)
+{
+    g_free (step->name);
+}
+
+void
+mm_connection_timings_mark (MMConnectionTimings *self,
+                            const gchar         *step,
+                            gint64               time)
+{
+    Step new_step;
+
+    new_step.name = g_strdup (step);
+    new_step.elapsed = (guint) (MAX (time - self->start_time, 0) / 1000);
+    g_array_append_val (self->steps, new_step);
+}
+
+guint
+mm_connection_timings_get_elapsed (const MMConnectionTimings *self)
+{
+    if (!self->steps->len)
+        return 0;
+    return g_array_index (self->steps, Step, self->steps->len - 1).elapsed;
+}
+
+GVariant *
+mm_connection_timings_get_variant (const MMConnectionTimings *self)
+{
+    GVariantBuilder builder;
+    guint           i;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(su)"));
+    for (i = 0; self && i < self->steps->len; i++) {
+        const Step *step = &g_array_index (self->steps, Step, i);
+
+        g_variant_builder_add (&builder, "(su)", step->name, step->elapsed);
+    }
+    return g_variant_builder_end (&builder);
+}
+
+MMConnectionTimings *
+mm_connection_timings_new (gint64 start_time)
+{
+    MMConnectionTimings *self;
+
+    self = g_slice_new0 (MMConnectionTimings);
+    self->start_time = start_time;
+    self->steps = g_array_new (FALSE, FALSE, sizeof (Step));
+    g_array_set_clear_func (self->steps, (GDestroyNotify) step_clear);
+    return self;
+}
+
+void
+mm_connection_timings_free (MMConnectionTimings *self)
+{
+    g_array_unref (self->steps);
+    g_slice_free (MMConnectionTimings, self);
+}
+
+/*****************************************************************************/
+
+static const guint bounds[] = { MM_CONNECTION_TIMINGS_HISTOGRAM_BOUNDS };
+
+G_STATIC_ASSERT (G_N_ELEMENTS (bounds) + 1 == MM_CONNECTION_TIMINGS_HISTOGRAM_N_BUCKETS);
+
+typedef struct {
+    gchar  *name;
+    guint32 counts[MM_CONNECTION_TIMINGS_HISTOGRAM_N_BUCKETS];
+} Entry;
+
+struct _MMConnectionTimingsHistogram {
+    /* Entries in the order they were first seen */
+    GPtrArray  *entries;
+    GHashTable *entries_by_name;
+};
+
+static void
+entry_free (Entry *entry)
+{
+    g_free (entry->name);
+    g_slice_free (Entry, entry);
+}
+
+static void
+histogram_add (MMConnectionTimingsHistogram *self,
+               const gchar                  *name,
+               guint                         duration)
+{
+    Entry *entry;
+    guint  i;
+
+    entry = g_hash_table_lookup (self->entries_by_name, name);
+    if (!entry) {
+        entry = g_slice_new0 (Entry);
+        entry->name = g_strdup (name);
+        g_ptr_array_add (self->entries, entry);
+        g_hash_table_insert (self->entries_by_name, entry->name, entry);
+    }
+
+    for (i = 0; i < G_N_ELEMENTS (bounds) && duration > bounds[i]; i++);
+    entry->counts[i]++;
+}
+
+void
+mm_connection_timings_histogram_add (MMConnectionTimingsHistogram *self,
+                                     const MMConnectionTimings    *timings)
+{
+    guint previous = 0;
+    guint i;
+
+    for (i = 0; i < timings->steps->len; i++) {
+        const Step *step = &g_array_index (timings->steps, Step, i);
+
+        histogram_add (self, step->name, step->elapsed - MIN (previous, step->elapsed));
+        previous = step->elapsed;
+    }
+    histogram_add (self, MM_CONNECTION_TIMINGS_TOTAL, previous);
+}
+
+GVariant *
+mm_connection_timings_histogram_get_variant (MMConnectionTimingsHistogram *self)
+{
+    GVariantBuilder builder;
+    guint           i;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sau}"));
+    for (i = 0; i < self->entries->len; i++) {
+        const Entry *entry = g_ptr_array_index (self->entries, i);
+
+        g_variant_builder_add (&builder, "{s@au}",
+                               entry->name,
+                               g_variant_new_fixed_array (G_VARIANT_TYPE_UINT32,
+                                                          entry->counts,
+                                                          MM_CONNECTION_TIMINGS_HISTOGRAM_N_BUCKETS,
+                                                          sizeof (guint32)));
+    }
+    return g_variant_builder_end (&builder);
+}
+
+MMConnectionTimingsHistogram *
+mm_connection_timings_histogram_new (void)
+{
+    MMConnectionTimingsHistogram *self;
+
+    self = g_slice_new0 (MMConnectionTimingsHistogram);
+    self->entries = g_ptr_array_new_with_free_func ((GDestroyNotify) entry_free);
+    self->entries_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+    return self;
+}
+
+void
+mm_connection_timings_histogram_free (MMConnectionTimingsHistogram *self)
+{
+    g_hash_table_unref (self->entries_by_name);
+    g_ptr_array_unref (self->entries);
+    g_slice_free (MMConnectionTimingsHistogram, self);
+}
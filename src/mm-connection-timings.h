@@ -0,0 +1,63 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_CONNECTION_TIMINGS_H
+#define MM_CONNECTION_TIMINGS_H
+
+#include <glib.h>
+
+/*****************************************************************************/
+/* Timings of the steps of a single connection attempt */
+
+typedef struct _MMConnectionTimings MMConnectionTimings;
+
+/* Times are given in microseconds of the monotonic clock */
+MMConnectionTimings *mm_connection_timings_new         (gint64                     start_time);
+void                 mm_connection_timings_free        (MMConnectionTimings       *self);
+
+/* Records that @step finished at @time */
+void                 mm_connection_timings_mark        (MMConnectionTimings       *self,
+                                                        const gchar               *step,
+                                                        gint64                     time);
+guint                mm_connection_timings_get_elapsed (const MMConnectionTimings *self);
+
+/* Builds a "a(su)" array with the name of each step and the milliseconds
+ * elapsed since the start of the attempt when it finished */
+GVariant            *mm_connection_timings_get_variant (const MMConnectionTimings *self);
+
+/*****************************************************************************/
+/* Aggregated step durations of all connection attempts */
+
+/* Upper bounds of the histogram buckets, in milliseconds; the last bucket
+ * holds everything longer than the last bound */
+#define MM_CONNECTION_TIMINGS_HISTOGRAM_BOUNDS 100, 250, 500, 1000, 2500, 5000, 10000, 30000
+#define MM_CONNECTION_TIMINGS_HISTOGRAM_N_BUCKETS 9
+
+/* Histogram entry for the whole connection attempt */
+#define MM_CONNECTION_TIMINGS_TOTAL "total"
+
+typedef struct _MMConnectionTimingsHistogram MMConnectionTimingsHistogram;
+
+MMConnectionTimingsHistogram *mm_connection_timings_histogram_new         (void);
+void                          mm_connection_timings_histogram_free        (MMConnectionTimingsHistogram *self);
+
+/* Adds the duration of each step (time since the previous one) and the
+ * total duration of the attempt */
+void                          mm_connection_timings_histogram_add         (MMConnectionTimingsHistogram *self,
+                                                                           const MMConnectionTimings    *timings);
+
+/* Builds a "a{sau}" dictionary with the bucket counts of each step, in the
+ * order in which steps were first seen */
+GVariant                     *mm_connection_timings_histogram_get_variant (MMConnectionTimingsHistogram *self);
+
+#endif /* MM_CONNECTION_TIMINGS_H */
@@ -41,6 +41,9 @@ static gboolean      debug;
 static MMFilterRule  filter_policy = MM_FILTER_POLICY_STRICT;
 static gboolean      no_auto_scan = NO_AUTO_SCAN_DEFAULT;
 static const gchar  *initial_kernel_events;
+static const gchar  *sms_spool_dir;
+static gint          signal_check_max_interval;
+static gint          bearer_stats_refresh;
 
 static gboolean
 filter_policy_option_arg (const gchar  *option_name,
@@ -90,6 +93,21 @@ static const GOptionEntry entries[] = {
         "Path to initial kernel events file",
         "[PATH]"
     },
+    {
+        "sms-spool-dir", 0, 0, G_OPTION_ARG_FILENAME, &sms_spool_dir,
+        "Path to the directory where received SMS parts are spooled",
+        "[PATH]"
+    },
+    {
+        "signal-check-max-interval", 0, 0, G_OPTION_ARG_INT, &signal_check_max_interval,
+        "Maximum interval between periodic signal quality checks, in seconds",
+        "[SECONDS]"
+    },
+    {
+        "bearer-stats-refresh", 0, 0, G_OPTION_ARG_INT, &bearer_stats_refresh,
+        "Interval between bearer statistics updates from the network interface counters, in milliseconds",
+        "[MSECS]"
+    },
     {
         "debug", 0, 0, G_OPTION_ARG_NONE, &debug,
         "Run with extended debugging capabilities",
@@ -132,6 +150,24 @@ mm_context_get_filter_policy (void)
     return filter_policy;
 }
 
+const gchar *
+mm_context_get_sms_spool_dir (void)
+{
+    return sms_spool_dir;
+}
+
+guint
+mm_context_get_signal_check_max_interval (void)
+{
+    return (guint) MAX (signal_check_max_interval, 0);
+}
+
+guint
+mm_context_get_bearer_stats_refresh (void)
+{
+    return (guint) MAX (bearer_stats_refresh, 0);
+}
+
 /*****************************************************************************/
 /* Log context */
 
@@ -140,6 +176,11 @@ static const gchar *log_file;
 static gboolean     log_journal;
 static gboolean     log_show_ts;
 static gboolean     log_rel_ts;
+static gboolean     log_async;
+static const gchar *log_async_drop;
+static gint         log_recorder_size = -1;
+
+#define LOG_RECORDER_SIZE_DEFAULT 256
 
 static const GOptionEntry log_entries[] = {
     {
@@ -169,6 +210,21 @@ static const GOptionEntry log_entries[] = {
         "Use relative timestamps (from MM start)",
         NULL
     },
+    {
+        "log-async", 0, 0, G_OPTION_ARG_NONE, &log_async,
+        "Write log messages from a separate thread",
+        NULL
+    },
+    {
+        "log-async-drop", 0, 0, G_OPTION_ARG_STRING, &log_async_drop,
+        "Messages that may be dropped when the async log writer can't keep up: one of debug (default), all, none",
+        "[POLICY]"
+    },
+    {
+        "log-recorder-size", 0, 0, G_OPTION_ARG_INT, &log_recorder_size,
+        "Number of recent log messages of any level kept per modem, 0 to disable (default 256)",
+        "[RECORDS]"
+    },
     { NULL }
 };
 
@@ -216,6 +272,24 @@ mm_context_get_log_relative_timestamps (void)
     return log_rel_ts;
 }
 
+gboolean
+mm_context_get_log_async (void)
+{
+    return log_async;
+}
+
+const gchar *
+mm_context_get_log_async_drop (void)
+{
+    return log_async_drop;
+}
+
+guint
+mm_context_get_log_recorder_size (void)
+{
+    return (log_recorder_size < 0) ? LOG_RECORDER_SIZE_DEFAULT : (guint) log_recorder_size;
+}
+
 /*****************************************************************************/
 /* Test context */
 
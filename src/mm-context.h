@@ -35,12 +35,24 @@ gboolean     mm_context_get_no_auto_scan          (void);
 /* Filter support */
 MMFilterRule mm_context_get_filter_policy (void);
 
+/* SMS spool support */
+const gchar *mm_context_get_sms_spool_dir (void);
+
+/* Signal quality polling; 0 if not given */
+guint        mm_context_get_signal_check_max_interval (void);
+
+/* Bearer statistics refresh, in milliseconds; 0 if not given */
+guint        mm_context_get_bearer_stats_refresh (void);
+
 /* Logging support */
 const gchar *mm_context_get_log_level               (void);
 const gchar *mm_context_get_log_file                (void);
 gboolean     mm_context_get_log_journal             (void);
 gboolean     mm_context_get_log_timestamps          (void);
 gboolean     mm_context_get_log_relative_timestamps (void);
+gboolean     mm_context_get_log_async               (void);
+const gchar *mm_context_get_log_async_drop          (void);
+guint        mm_context_get_log_recorder_size       (void);
 
 /* Testing support */
 gboolean     mm_context_get_test_session    (void);
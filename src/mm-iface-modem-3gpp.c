@@ -47,8 +47,9 @@ typedef struct {
     GCancellable                 *pending_registration_cancellable;
     gboolean                      reloading_registration_info;
     /* Registration checks */
-    guint    check_timeout_source;
-    gboolean check_running;
+    MMPollScheduler *check_scheduler;
+    guint            check_timeout_source;
+    gboolean         check_running;
 } Private;
 
 static void
@@ -60,7 +61,8 @@ private_free (Private *priv)
         g_object_unref (priv->pending_registration_cancellable);
     }
     if (priv->check_timeout_source)
-        g_source_remove (priv->check_timeout_source);
+        mm_poll_scheduler_remove (priv->check_scheduler, priv->check_timeout_source);
+    g_clear_object (&priv->check_scheduler);
     g_slice_free (Private, priv);
 }
 
@@ -1661,7 +1663,7 @@ periodic_registration_check_disable (MMIfaceModem3gpp *self)
     if (!priv->check_timeout_source)
         return;
 
-    g_source_remove (priv->check_timeout_source);
+    mm_poll_scheduler_remove (priv->check_scheduler, priv->check_timeout_source);
     priv->check_timeout_source = 0;
 
     mm_obj_dbg (self, "periodic 3GPP registration checks disabled");
@@ -1680,7 +1682,12 @@ periodic_registration_check_enable (MMIfaceModem3gpp *self)
 
     /* Create context and keep it as object data */
     mm_obj_dbg (self, "periodic 3GPP registration checks enabled");
-    priv->check_timeout_source = g_timeout_add_seconds (REGISTRATION_CHECK_TIMEOUT_SEC,
+    if (!priv->check_scheduler)
+        priv->check_scheduler = g_object_ref (mm_base_modem_peek_poll_scheduler (MM_BASE_MODEM (self)));
+    priv->check_timeout_source = mm_poll_scheduler_add (priv->check_scheduler,
+                                                        "registration-check",
+                                                        REGISTRATION_CHECK_TIMEOUT_SEC,
+                                                        MM_POLL_JOB_FLAG_DEFER_WHEN_BUSY,
                                                         (GSourceFunc)periodic_registration_check,
                                                         self);
 }
@@ -23,12 +23,22 @@
 #include "mm-iface-modem-location.h"
 #include "mm-log-object.h"
 #include "mm-modem-helpers.h"
+#include "mm-rate-limiter.h"
 
 #define MM_LOCATION_GPS_REFRESH_TIME_SECS 30
 
-#define LOCATION_CONTEXT_TAG "location-context-tag"
+#define LOCATION_CONTEXT_TAG       "location-context-tag"
+#define LOCATION_SUBSCRIPTIONS_TAG "location-subscriptions-tag"
 
 static GQuark location_context_quark;
+static GQuark location_subscriptions_quark;
+
+/* Sources that may be requested in Subscribe() */
+#define SUBSCRIPTION_SOURCES (MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI | MM_MODEM_LOCATION_SOURCE_GPS_RAW)
+
+/* Each subscriber has its own timer, so bound how many there may be */
+#define MAX_SUBSCRIBERS_PER_MODEM   16
+#define MAX_SUBSCRIPTIONS_PER_CLIENT 4
 
 /*****************************************************************************/
 
@@ -227,6 +237,252 @@ build_location_dictionary (GVariant *previous,
     return g_variant_builder_end (&builder);
 }
 
+/*****************************************************************************/
+/* Per-client location update subscriptions */
+
+typedef struct {
+    MMIfaceModemLocation  *self;
+    GDBusConnection       *connection;
+    gchar                 *sender;
+    guint                  name_lost_id;
+    MMModemLocationSource  sources;
+    /* Changed sources not yet sent, waiting for the rate limit */
+    MMRateLimiter         *limiter;
+    guint                  timeout_id;
+} Subscriber;
+
+typedef struct {
+    GList *subscribers;
+} SubscriptionsContext;
+
+/* Number of subscriptions of each client, across all modems */
+static GHashTable *client_subscriptions;
+
+static guint
+client_subscriptions_get (const gchar *sender)
+{
+    if (!client_subscriptions)
+        return 0;
+    return GPOINTER_TO_UINT (g_hash_table_lookup (client_subscriptions, sender));
+}
+
+static void
+client_subscriptions_ref (const gchar *sender)
+{
+    if (G_UNLIKELY (!client_subscriptions))
+        client_subscriptions = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    g_hash_table_insert (client_subscriptions,
+                         g_strdup (sender),
+                         GUINT_TO_POINTER (client_subscriptions_get (sender) + 1));
+}
+
+static void
+client_subscriptions_unref (const gchar *sender)
+{
+    guint n;
+
+    n = client_subscriptions_get (sender);
+    g_assert (n > 0);
+    if (n == 1)
+        g_hash_table_remove (client_subscriptions, sender);
+    else
+        g_hash_table_insert (client_subscriptions, g_strdup (sender), GUINT_TO_POINTER (n - 1));
+}
+
+static void
+subscriber_free (Subscriber *sub)
+{
+    if (sub->timeout_id)
+        g_source_remove (sub->timeout_id);
+    if (sub->name_lost_id)
+        g_bus_unwatch_name (sub->name_lost_id);
+    client_subscriptions_unref (sub->sender);
+    mm_rate_limiter_free (sub->limiter);
+    g_object_unref (sub->connection);
+    g_free (sub->sender);
+    g_slice_free (Subscriber, sub);
+}
+
+static void
+subscriptions_context_free (SubscriptionsContext *ctx)
+{
+    g_list_free_full (ctx->subscribers, (GDestroyNotify) subscriber_free);
+    g_slice_free (SubscriptionsContext, ctx);
+}
+
+static SubscriptionsContext *
+get_subscriptions_context (MMIfaceModemLocation *self)
+{
+    SubscriptionsContext *ctx;
+
+    if (G_UNLIKELY (!location_subscriptions_quark))
+        location_subscriptions_quark = g_quark_from_static_string (LOCATION_SUBSCRIPTIONS_TAG);
+
+    ctx = g_object_get_qdata (G_OBJECT (self), location_subscriptions_quark);
+    if (!ctx) {
+        ctx = g_slice_new0 (SubscriptionsContext);
+        g_object_set_qdata_full (G_OBJECT (self),
+                                 location_subscriptions_quark,
+                                 ctx,
+                                 (GDestroyNotify) subscriptions_context_free);
+    }
+    return ctx;
+}
+
+static void
+clear_subscriptions (MMIfaceModemLocation *self)
+{
+    if (G_UNLIKELY (!location_subscriptions_quark))
+        location_subscriptions_quark = g_quark_from_static_string (LOCATION_SUBSCRIPTIONS_TAG);
+
+    /* The destroy notify drops all subscribers */
+    g_object_set_qdata (G_OBJECT (self), location_subscriptions_quark, NULL);
+}
+
+static Subscriber *
+find_subscriber (SubscriptionsContext *ctx,
+                 const gchar          *sender)
+{
+    GList *l;
+
+    for (l = ctx->subscribers; l; l = g_list_next (l)) {
+        Subscriber *sub = l->data;
+
+        if (g_strcmp0 (sub->sender, sender) == 0)
+            return sub;
+    }
+    return NULL;
+}
+
+static void
+remove_subscriber (MMIfaceModemLocation *self,
+                   Subscriber           *sub)
+{
+    SubscriptionsContext *ctx;
+
+    ctx = get_subscriptions_context (self);
+    ctx->subscribers = g_list_remove (ctx->subscribers, sub);
+    subscriber_free (sub);
+}
+
+/* "hhmmss.ss" to milliseconds since midnight */
+static guint
+utc_time_to_ms (const gchar *utc_time)
+{
+    guint   hh, mm;
+    gdouble ss;
+
+    if (!utc_time ||
+        !g_ascii_isdigit (utc_time[0]) || !g_ascii_isdigit (utc_time[1]) ||
+        !g_ascii_isdigit (utc_time[2]) || !g_ascii_isdigit (utc_time[3]) ||
+        !g_ascii_isdigit (utc_time[4]))
+        return 0;
+
+    hh = (utc_time[0] - '0') * 10 + (utc_time[1] - '0');
+    mm = (utc_time[2] - '0') * 10 + (utc_time[3] - '0');
+    ss = g_ascii_strtod (utc_time + 4, NULL);
+    return (hh * 3600 + mm * 60) * 1000 + (guint) (ss * 1000.0);
+}
+
+static void
+subscriber_flush (Subscriber *sub)
+{
+    LocationContext       *location_ctx;
+    MMModemLocationSource  pending;
+    MMModemLocationSource  sources = MM_MODEM_LOCATION_SOURCE_NONE;
+    const gchar           *path;
+    GVariant              *gps;
+    GVariant              *cell;
+    GError                *error = NULL;
+
+    /* Always start a new interval, even if nothing can be sent */
+    pending = mm_rate_limiter_take (sub->limiter, g_get_monotonic_time ()) & sub->sources;
+
+    path = g_dbus_object_get_object_path (G_DBUS_OBJECT (sub->self));
+    if (!path)
+        return;
+
+    location_ctx = get_location_context (sub->self);
+
+    if ((pending & MM_MODEM_LOCATION_SOURCE_GPS_RAW) && location_ctx->location_gps_raw) {
+        MMLocationGpsRaw *raw = location_ctx->location_gps_raw;
+
+        sources |= MM_MODEM_LOCATION_SOURCE_GPS_RAW;
+        gps = g_variant_new ("(udddu)",
+                             utc_time_to_ms (mm_location_gps_raw_get_utc_time (raw)),
+                             mm_location_gps_raw_get_latitude (raw),
+                             mm_location_gps_raw_get_longitude (raw),
+                             mm_location_gps_raw_get_altitude (raw),
+                             mm_location_gps_raw_get_fix_quality (raw));
+    } else
+        gps = g_variant_new ("(udddu)", 0, 0.0, 0.0, 0.0, 0);
+
+    if ((pending & MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI) && location_ctx->location_3gpp) {
+        MMLocation3gpp *location_3gpp = location_ctx->location_3gpp;
+
+        sources |= MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI;
+        cell = g_variant_new ("(uuuuu)",
+                              mm_location_3gpp_get_mobile_country_code (location_3gpp),
+                              mm_location_3gpp_get_mobile_network_code (location_3gpp),
+                              (guint) mm_location_3gpp_get_location_area_code (location_3gpp),
+                              (guint) mm_location_3gpp_get_tracking_area_code (location_3gpp),
+                              (guint) mm_location_3gpp_get_cell_id (location_3gpp));
+    } else
+        cell = g_variant_new ("(uuuuu)", 0, 0, 0, 0, 0);
+
+    /* Unicast signal, only the subscriber gets it */
+    if (!g_dbus_connection_emit_signal (sub->connection,
+                                        sub->sender,
+                                        path,
+                                        MM_DBUS_INTERFACE_MODEM_LOCATION,
+                                        MM_MODEM_LOCATION_SIGNAL_UPDATED,
+                                        g_variant_new ("(u@(udddu)@(uuuuu))", sources, gps, cell),
+                                        &error)) {
+        mm_obj_dbg (sub->self, "couldn't send location update to %s: %s", sub->sender, error->message);
+        g_error_free (error);
+    }
+}
+
+static gboolean
+subscriber_timeout_cb (Subscriber *sub)
+{
+    sub->timeout_id = 0;
+    subscriber_flush (sub);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+notify_subscribers (MMIfaceModemLocation  *self,
+                    MMModemLocationSource  changed)
+{
+    SubscriptionsContext *ctx;
+    GList                *l;
+    gint64                now;
+
+    ctx = get_subscriptions_context (self);
+    if (!ctx->subscribers)
+        return;
+
+    now = g_get_monotonic_time ();
+    for (l = ctx->subscribers; l; l = g_list_next (l)) {
+        Subscriber *sub = l->data;
+        guint       delay_ms = 0;
+
+        switch (mm_rate_limiter_push (sub->limiter, changed & sub->sources, now, &delay_ms)) {
+        case MM_RATE_LIMITER_ACTION_SEND:
+            subscriber_flush (sub);
+            break;
+        case MM_RATE_LIMITER_ACTION_SCHEDULE:
+            g_assert (!sub->timeout_id);
+            sub->timeout_id = g_timeout_add (delay_ms, (GSourceFunc) subscriber_timeout_cb, sub);
+            break;
+        case MM_RATE_LIMITER_ACTION_NONE:
+        default:
+            break;
+        }
+    }
+}
+
 /*****************************************************************************/
 
 static void
@@ -277,11 +533,14 @@ location_gps_update_nmea (MMIfaceModemLocation *self,
 
     if (mm_gdbus_modem_location_get_enabled (skeleton) & MM_MODEM_LOCATION_SOURCE_GPS_RAW) {
         g_assert (ctx->location_gps_raw != NULL);
-        if (mm_location_gps_raw_add_trace (ctx->location_gps_raw, nmea_trace) &&
-            (ctx->location_gps_raw_last_time == 0 ||
-             time (NULL) - ctx->location_gps_raw_last_time >= (glong)mm_gdbus_modem_location_get_gps_refresh_rate (skeleton))) {
-            ctx->location_gps_raw_last_time = time (NULL);
-            update_raw = TRUE;
+        if (mm_location_gps_raw_add_trace (ctx->location_gps_raw, nmea_trace)) {
+            /* Subscribers have their own rate limit */
+            notify_subscribers (self, MM_MODEM_LOCATION_SOURCE_GPS_RAW);
+            if (ctx->location_gps_raw_last_time == 0 ||
+                time (NULL) - ctx->location_gps_raw_last_time >= (glong)mm_gdbus_modem_location_get_gps_refresh_rate (skeleton)) {
+                ctx->location_gps_raw_last_time = time (NULL);
+                update_raw = TRUE;
+            }
         }
     }
 
@@ -353,6 +612,8 @@ notify_3gpp_location_update (MMIfaceModemLocation *self,
                 mm_location_3gpp_get_tracking_area_code (location_3gpp),
                 mm_location_3gpp_get_cell_id (location_3gpp));
 
+    notify_subscribers (self, MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI);
+
     /* We only update the property if we are supposed to signal
      * location */
     if (mm_gdbus_modem_location_get_signals_location (skeleton))
@@ -1294,6 +1555,162 @@ handle_set_gps_refresh_rate (MmGdbusModemLocation *skeleton,
 
 /*****************************************************************************/
 
+typedef struct {
+    MmGdbusModemLocation  *skeleton;
+    GDBusMethodInvocation *invocation;
+    MMIfaceModemLocation  *self;
+    MMModemLocationSource  sources;
+    guint                  interval;
+} HandleSubscribeContext;
+
+static void
+handle_subscribe_context_free (HandleSubscribeContext *ctx)
+{
+    g_object_unref (ctx->skeleton);
+    g_object_unref (ctx->invocation);
+    g_object_unref (ctx->self);
+    g_slice_free (HandleSubscribeContext, ctx);
+}
+
+static void
+subscriber_name_vanished (GDBusConnection *connection,
+                          const gchar     *name,
+                          Subscriber      *sub)
+{
+    mm_obj_dbg (sub->self, "location updates subscriber %s gone", name);
+    remove_subscriber (sub->self, sub);
+}
+
+static void
+handle_subscribe_auth_ready (MMBaseModem            *self,
+                             GAsyncResult           *res,
+                             HandleSubscribeContext *ctx)
+{
+    SubscriptionsContext *subscriptions;
+    Subscriber           *sub;
+    const gchar          *sender;
+    guint                 interval;
+    GError               *error = NULL;
+
+    if (!mm_base_modem_authorize_finish (self, res, &error)) {
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+        handle_subscribe_context_free (ctx);
+        return;
+    }
+
+    if (!ctx->sources || (ctx->sources & ~SUBSCRIPTION_SOURCES)) {
+        g_autofree gchar *str = NULL;
+
+        str = mm_modem_location_source_build_string_from_mask (ctx->sources);
+        g_dbus_method_invocation_return_error (ctx->invocation,
+                                               MM_CORE_ERROR,
+                                               MM_CORE_ERROR_INVALID_ARGS,
+                                               "Cannot subscribe to location updates: "
+                                               "invalid sources requested: '%s'", str);
+        handle_subscribe_context_free (ctx);
+        return;
+    }
+
+    subscriptions = get_subscriptions_context (ctx->self);
+    sender = g_dbus_method_invocation_get_sender (ctx->invocation);
+    sub = find_subscriber (subscriptions, sender);
+    if (!sub) {
+        if (g_list_length (subscriptions->subscribers) >= MAX_SUBSCRIBERS_PER_MODEM) {
+            g_dbus_method_invocation_return_error (ctx->invocation,
+                                                   MM_CORE_ERROR,
+                                                   MM_CORE_ERROR_TOO_MANY,
+                                                   "Cannot subscribe to location updates: "
+                                                   "too many subscribers");
+            handle_subscribe_context_free (ctx);
+            return;
+        }
+        if (client_subscriptions_get (sender) >= MAX_SUBSCRIPTIONS_PER_CLIENT) {
+            g_dbus_method_invocation_return_error (ctx->invocation,
+                                                   MM_CORE_ERROR,
+                                                   MM_CORE_ERROR_TOO_MANY,
+                                                   "Cannot subscribe to location updates: "
+                                                   "too many subscriptions from this client");
+            handle_subscribe_context_free (ctx);
+            return;
+        }
+
+        sub = g_slice_new0 (Subscriber);
+        sub->self = ctx->self;
+        sub->connection = g_object_ref (g_dbus_method_invocation_get_connection (ctx->invocation));
+        sub->sender = g_strdup (sender);
+        sub->limiter = mm_rate_limiter_new (ctx->interval);
+        client_subscriptions_ref (sub->sender);
+        /* The subscriber is owned by the subscriptions context, which is bound
+         * to the lifetime of the modem */
+        sub->name_lost_id = g_bus_watch_name_on_connection (sub->connection,
+                                                            sub->sender,
+                                                            G_BUS_NAME_WATCHER_FLAGS_NONE,
+                                                            NULL,
+                                                            (GBusNameVanishedCallback) subscriber_name_vanished,
+                                                            sub,
+                                                            NULL);
+        subscriptions->subscribers = g_list_append (subscriptions->subscribers, sub);
+    }
+
+    sub->sources = ctx->sources;
+    mm_rate_limiter_filter (sub->limiter, sub->sources);
+    interval = mm_rate_limiter_set_interval (sub->limiter, ctx->interval);
+    mm_obj_dbg (self, "location updates subscriber %s: sources 0x%x, interval %ums",
+                sub->sender, sub->sources, interval);
+
+    mm_gdbus_modem_location_complete_subscribe (ctx->skeleton, ctx->invocation);
+    handle_subscribe_context_free (ctx);
+}
+
+static gboolean
+handle_subscribe (MmGdbusModemLocation  *skeleton,
+                  GDBusMethodInvocation *invocation,
+                  guint                  sources,
+                  guint                  interval,
+                  MMIfaceModemLocation  *self)
+{
+    HandleSubscribeContext *ctx;
+
+    ctx = g_slice_new0 (HandleSubscribeContext);
+    ctx->skeleton = g_object_ref (skeleton);
+    ctx->invocation = g_object_ref (invocation);
+    ctx->self = g_object_ref (self);
+    ctx->sources = sources;
+    ctx->interval = interval;
+
+    mm_base_modem_authorize (MM_BASE_MODEM (self),
+                             invocation,
+                             MM_AUTHORIZATION_LOCATION,
+                             (GAsyncReadyCallback)handle_subscribe_auth_ready,
+                             ctx);
+    return TRUE;
+}
+
+static gboolean
+handle_unsubscribe (MmGdbusModemLocation  *skeleton,
+                    GDBusMethodInvocation *invocation,
+                    MMIfaceModemLocation  *self)
+{
+    Subscriber *sub;
+
+    /* Only the client itself can drop its subscription, no need to authorize */
+    sub = find_subscriber (get_subscriptions_context (self),
+                           g_dbus_method_invocation_get_sender (invocation));
+    if (!sub) {
+        g_dbus_method_invocation_return_error (invocation,
+                                               MM_CORE_ERROR,
+                                               MM_CORE_ERROR_NOT_FOUND,
+                                               "Not subscribed to location updates");
+        return TRUE;
+    }
+
+    remove_subscriber (self, sub);
+    mm_gdbus_modem_location_complete_unsubscribe (skeleton, invocation);
+    return TRUE;
+}
+
+/*****************************************************************************/
+
 typedef struct {
     MmGdbusModemLocation *skeleton;
     GDBusMethodInvocation *invocation;
@@ -1445,6 +1862,7 @@ interface_disabling_step (GTask *task)
 
     case DISABLING_STEP_LAST:
         /* We are done without errors! */
+        clear_subscriptions (self);
         clear_location_context (self);
         g_task_return_boolean (task, TRUE);
         g_object_unref (task);
@@ -1875,6 +2293,14 @@ interface_initialization_step (GTask *task)
                           "handle-get-location",
                           G_CALLBACK (handle_get_location),
                           self);
+        g_signal_connect (ctx->skeleton,
+                          "handle-subscribe",
+                          G_CALLBACK (handle_subscribe),
+                          self);
+        g_signal_connect (ctx->skeleton,
+                          "handle-unsubscribe",
+                          G_CALLBACK (handle_unsubscribe),
+                          self);
 
         /* Finally, export the new interface */
         mm_gdbus_object_skeleton_set_modem_location (MM_GDBUS_OBJECT_SKELETON (self),
@@ -1945,6 +2371,8 @@ mm_iface_modem_location_initialize (MMIfaceModemLocation *self,
 void
 mm_iface_modem_location_shutdown (MMIfaceModemLocation *self)
 {
+    clear_subscriptions (self);
+
     /* Unexport DBus interface and remove the skeleton */
     mm_gdbus_object_skeleton_set_modem_location (MM_GDBUS_OBJECT_SKELETON (self), NULL);
     g_object_set (self,
@@ -20,6 +20,7 @@
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-messaging.h"
 #include "mm-sms-list.h"
+#include "mm-sms-batch.h"
 #include "mm-log-object.h"
 
 #define SUPPORT_CHECKED_TAG "messaging-support-checked-tag"
@@ -363,6 +364,157 @@ handle_create (MmGdbusModemMessaging *skeleton,
 
 /*****************************************************************************/
 
+typedef struct {
+    MmGdbusModemMessaging *skeleton;
+    GDBusMethodInvocation *invocation;
+    MMIfaceModemMessaging *self;
+    GVariant *messages;
+    MMSmsBatch *batch;
+    guint current;
+} HandleSendBatchContext;
+
+static void
+handle_send_batch_context_free (HandleSendBatchContext *ctx)
+{
+    if (ctx->batch)
+        mm_sms_batch_free (ctx->batch);
+    g_object_unref (ctx->skeleton);
+    g_object_unref (ctx->invocation);
+    g_object_unref (ctx->self);
+    g_variant_unref (ctx->messages);
+    g_free (ctx);
+}
+
+static void send_batch_next (HandleSendBatchContext *ctx);
+
+static void
+send_batch_item_ready (MMBaseSms *sms,
+                       GAsyncResult *res,
+                       HandleSendBatchContext *ctx)
+{
+    GError *error = NULL;
+
+    if (!mm_base_sms_send_finish (sms, res, &error))
+        mm_obj_dbg (ctx->self, "couldn't send message %u in batch: %s", ctx->current, error->message);
+
+    /* The transient SMS object is dropped once completed */
+    mm_sms_batch_complete (ctx->batch,
+                           ctx->current,
+                           error ? 0 : mm_gdbus_sms_get_message_reference (MM_GDBUS_SMS (sms)),
+                           error);
+    g_clear_error (&error);
+
+    ctx->current++;
+    send_batch_next (ctx);
+}
+
+static void
+send_batch_next (HandleSendBatchContext *ctx)
+{
+    guint n_messages;
+
+    /* Skip messages that couldn't be prepared */
+    n_messages = mm_sms_batch_get_n_messages (ctx->batch);
+    while (ctx->current < n_messages && !mm_sms_batch_peek_prepared (ctx->batch, ctx->current))
+        ctx->current++;
+
+    if (ctx->current == n_messages) {
+        mm_gdbus_modem_messaging_complete_send_batch (ctx->skeleton,
+                                                      ctx->invocation,
+                                                      mm_sms_batch_build_results (ctx->batch));
+        handle_send_batch_context_free (ctx);
+        return;
+    }
+
+    mm_base_sms_send (MM_BASE_SMS (mm_sms_batch_peek_prepared (ctx->batch, ctx->current)),
+                      (GAsyncReadyCallback)send_batch_item_ready,
+                      ctx);
+}
+
+static gpointer
+send_batch_prepare (MMSmsProperties *properties,
+                    MMBaseModem *self,
+                    GError **error)
+{
+    MMBaseSms *sms;
+
+    sms = mm_base_sms_new_transient_from_properties (self, properties, error);
+    if (sms && !mm_base_sms_prepare_send (sms, error))
+        g_clear_object (&sms);
+    return sms;
+}
+
+static void
+handle_send_batch_auth_ready (MMBaseModem *self,
+                              GAsyncResult *res,
+                              HandleSendBatchContext *ctx)
+{
+    MMModemState modem_state = MM_MODEM_STATE_UNKNOWN;
+    GError *error = NULL;
+    guint n_prepared;
+
+    if (!mm_base_modem_authorize_finish (self, res, &error)) {
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+        handle_send_batch_context_free (ctx);
+        return;
+    }
+
+    g_object_get (self,
+                  MM_IFACE_MODEM_STATE, &modem_state,
+                  NULL);
+
+    if (modem_state < MM_MODEM_STATE_ENABLED) {
+        g_dbus_method_invocation_return_error (ctx->invocation,
+                                               MM_CORE_ERROR,
+                                               MM_CORE_ERROR_WRONG_STATE,
+                                               "Cannot send SMS batch: device not yet enabled");
+        handle_send_batch_context_free (ctx);
+        return;
+    }
+
+    ctx->batch = mm_sms_batch_new (ctx->messages, &error);
+    if (!ctx->batch) {
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+        handle_send_batch_context_free (ctx);
+        return;
+    }
+
+    /* Generate the PDUs of all messages before sending any of them */
+    n_prepared = mm_sms_batch_prepare (ctx->batch,
+                                       (MMSmsBatchPrepareFunc)send_batch_prepare,
+                                       g_object_unref,
+                                       self);
+
+    mm_obj_dbg (self, "sending batch of %u messages (%u ready)",
+                mm_sms_batch_get_n_messages (ctx->batch), n_prepared);
+    ctx->current = 0;
+    send_batch_next (ctx);
+}
+
+static gboolean
+handle_send_batch (MmGdbusModemMessaging *skeleton,
+                   GDBusMethodInvocation *invocation,
+                   GVariant *messages,
+                   MMIfaceModemMessaging *self)
+{
+    HandleSendBatchContext *ctx;
+
+    ctx = g_new0 (HandleSendBatchContext, 1);
+    ctx->skeleton = g_object_ref (skeleton);
+    ctx->invocation = g_object_ref (invocation);
+    ctx->self = g_object_ref (self);
+    ctx->messages = g_variant_ref (messages);
+
+    mm_base_modem_authorize (MM_BASE_MODEM (self),
+                             invocation,
+                             MM_AUTHORIZATION_MESSAGING,
+                             (GAsyncReadyCallback)handle_send_batch_auth_ready,
+                             ctx);
+    return TRUE;
+}
+
+/*****************************************************************************/
+
 static gboolean
 handle_list (MmGdbusModemMessaging *skeleton,
              GDBusMethodInvocation *invocation,
@@ -521,6 +673,26 @@ sms_deleted (MMSmsList             *list,
     mm_gdbus_modem_messaging_emit_deleted (skeleton, sms_path);
 }
 
+static void
+sms_multipart_stats_updated (MMSmsList             *list,
+                             MmGdbusModemMessaging *skeleton)
+{
+    GVariantBuilder builder;
+    guint           n_in_flight;
+    guint           n_pending_parts;
+    guint           n_expired;
+    guint           n_evicted;
+
+    mm_sms_list_get_multipart_stats (list, &n_in_flight, &n_pending_parts, &n_expired, &n_evicted);
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    g_variant_builder_add (&builder, "{sv}", "in-flight",     g_variant_new_uint32 (n_in_flight));
+    g_variant_builder_add (&builder, "{sv}", "pending-parts", g_variant_new_uint32 (n_pending_parts));
+    g_variant_builder_add (&builder, "{sv}", "expired",       g_variant_new_uint32 (n_expired));
+    g_variant_builder_add (&builder, "{sv}", "evicted",       g_variant_new_uint32 (n_evicted));
+    mm_gdbus_modem_messaging_set_multipart_stats (skeleton, g_variant_builder_end (&builder));
+}
+
 /*****************************************************************************/
 
 typedef struct _DisablingContext DisablingContext;
@@ -951,6 +1123,11 @@ interface_enabling_step (GTask *task)
                           MM_SMS_DELETED,
                           G_CALLBACK (sms_deleted),
                           ctx->skeleton);
+        g_signal_connect (list,
+                          MM_SMS_MULTIPART_STATS_UPDATED,
+                          G_CALLBACK (sms_multipart_stats_updated),
+                          ctx->skeleton);
+        sms_multipart_stats_updated (list, ctx->skeleton);
 
         g_object_unref (list);
 
@@ -1354,6 +1531,10 @@ interface_initialization_step (GTask *task)
                           "handle-delete",
                           G_CALLBACK (handle_delete),
                           self);
+        g_signal_connect (ctx->skeleton,
+                          "handle-send-batch",
+                          G_CALLBACK (handle_send_batch),
+                          self);
         g_signal_connect (ctx->skeleton,
                           "handle-list",
                           G_CALLBACK (handle_list),
@@ -13,21 +13,50 @@
  * Copyright (C) 2013 Aleksander Morgado <aleksander@gnu.org>
  */
 
+#include <string.h>
+
 #include <ModemManager.h>
 #define _LIBMM_INSIDE_MM
 #include <libmm-glib.h>
 
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-signal.h"
+#include "mm-base-modem.h"
+#include "mm-signal-history.h"
 #include "mm-log-object.h"
 
 #define SUPPORT_CHECKED_TAG "signal-support-checked-tag"
 #define SUPPORTED_TAG       "signal-supported-tag"
 #define REFRESH_CONTEXT_TAG "signal-refresh-context-tag"
+#define HISTORY_TAG         "signal-history-tag"
+
+/* Number of samples kept, each one for a single access technology */
+#define SIGNAL_HISTORY_SIZE 1024
+
+/* Values reported by the modem on its own are published at most this often,
+ * only the latest one of each technology */
+#define UPDATE_FLUSH_INTERVAL_MS 250
+
+/* Values reported by the modem on its own are kept over periodic loads that
+ * don't include them, unless no new one arrived in this many refresh periods
+ * (e.g. if the modem stopped reporting them) */
+#define UNSOLICITED_MAX_AGE_PERIODS 3
+
+enum {
+    SIGNAL_CDMA,
+    SIGNAL_EVDO,
+    SIGNAL_GSM,
+    SIGNAL_UMTS,
+    SIGNAL_LTE,
+    SIGNAL_LAST
+};
+
+static const gchar *signal_names[SIGNAL_LAST] = { "CDMA", "EV-DO", "GSM", "UMTS", "LTE" };
 
 static GQuark support_checked_quark;
 static GQuark supported_quark;
 static GQuark refresh_context_quark;
+static GQuark history_quark;
 
 /*****************************************************************************/
 
@@ -40,15 +69,35 @@ mm_iface_modem_signal_bind_simple_status (MMIfaceModemSignal *self,
 /*****************************************************************************/
 
 typedef struct {
-    guint rate;
-    guint timeout_source;
+    MMIfaceModemSignal *self;
+    guint               rate;
+    MMPollScheduler    *scheduler;
+    guint               timeout_source;
+    /* Unsolicited values waiting to be published */
+    MMSignal           *pending[SIGNAL_LAST];
+    guint               flush_source;
+    /* When each technology was last reported unsolicited, 0 if never */
+    gint64              unsolicited_time[SIGNAL_LAST];
+    guint               n_updates;
+    guint               n_dropped;
 } RefreshContext;
 
 static void
 refresh_context_free (RefreshContext *ctx)
 {
+    guint i;
+
+    if (ctx->n_updates)
+        mm_obj_dbg (ctx->self, "unsolicited extended signal information: %u values received, %u superseded before being published",
+                    ctx->n_updates, ctx->n_dropped);
+
     if (ctx->timeout_source)
-        g_source_remove (ctx->timeout_source);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
+    if (ctx->flush_source)
+        g_source_remove (ctx->flush_source);
+    for (i = 0; i < SIGNAL_LAST; i++)
+        g_clear_object (&ctx->pending[i]);
+    g_object_unref (ctx->scheduler);
     g_slice_free (RefreshContext, ctx);
 }
 
@@ -71,27 +120,139 @@ clear_values (MMIfaceModemSignal *self)
     g_object_unref (skeleton);
 }
 
+static MMSignalHistory *
+peek_history (MMIfaceModemSignal *self)
+{
+    MMSignalHistory *history;
+
+    if (G_UNLIKELY (!history_quark))
+        history_quark = g_quark_from_static_string (HISTORY_TAG);
+
+    history = g_object_get_qdata (G_OBJECT (self), history_quark);
+    if (!history) {
+        history = mm_signal_history_new (SIGNAL_HISTORY_SIZE);
+        g_object_set_qdata_full (G_OBJECT (self),
+                                 history_quark,
+                                 history,
+                                 (GDestroyNotify)mm_signal_history_free);
+    }
+    return history;
+}
+
+static void
+update_history (MMIfaceModemSignal *self,
+                MMSignal           *cdma,
+                MMSignal           *evdo,
+                MMSignal           *gsm,
+                MMSignal           *umts,
+                MMSignal           *lte)
+{
+    MMSignalHistory *history;
+    guint64          timestamp;
+
+    history = peek_history (self);
+    timestamp = (guint64) (g_get_real_time () / G_USEC_PER_SEC);
+    if (cdma)
+        mm_signal_history_add (history, timestamp, MM_MODEM_ACCESS_TECHNOLOGY_1XRTT, cdma);
+    if (evdo)
+        mm_signal_history_add (history, timestamp, MM_MODEM_ACCESS_TECHNOLOGY_EVDO0, evdo);
+    if (gsm)
+        mm_signal_history_add (history, timestamp, MM_MODEM_ACCESS_TECHNOLOGY_GSM, gsm);
+    if (umts)
+        mm_signal_history_add (history, timestamp, MM_MODEM_ACCESS_TECHNOLOGY_UMTS, umts);
+    if (lte)
+        mm_signal_history_add (history, timestamp, MM_MODEM_ACCESS_TECHNOLOGY_LTE, lte);
+}
+
+static void
+set_value (MmGdbusModemSignal *skeleton,
+           guint               i,
+           MMSignal           *value)
+{
+    GVariant *dictionary = NULL;
+
+    if (value)
+        dictionary = mm_signal_get_dictionary (value);
+
+    switch (i) {
+    case SIGNAL_CDMA:
+        mm_gdbus_modem_signal_set_cdma (skeleton, dictionary);
+        break;
+    case SIGNAL_EVDO:
+        mm_gdbus_modem_signal_set_evdo (skeleton, dictionary);
+        break;
+    case SIGNAL_GSM:
+        mm_gdbus_modem_signal_set_gsm (skeleton, dictionary);
+        break;
+    case SIGNAL_UMTS:
+        mm_gdbus_modem_signal_set_umts (skeleton, dictionary);
+        break;
+    case SIGNAL_LTE:
+        mm_gdbus_modem_signal_set_lte (skeleton, dictionary);
+        break;
+    default:
+        g_assert_not_reached ();
+    }
+
+    if (dictionary)
+        g_variant_unref (dictionary);
+}
+
+/* Takes ownership of the values; missing ones are cleared unless kept */
+static void
+apply_values (MMIfaceModemSignal *self,
+              MMSignal           *values[SIGNAL_LAST],
+              const gboolean      keep_missing[SIGNAL_LAST])
+{
+    MmGdbusModemSignal *skeleton;
+    guint               i;
+
+    g_object_get (self,
+                  MM_IFACE_MODEM_SIGNAL_DBUS_SKELETON, &skeleton,
+                  NULL);
+    if (!skeleton) {
+        mm_obj_warn (self, "cannot update extended signal information: couldn't get interface skeleton");
+        for (i = 0; i < SIGNAL_LAST; i++)
+            g_clear_object (&values[i]);
+        return;
+    }
+
+    update_history (self,
+                    values[SIGNAL_CDMA],
+                    values[SIGNAL_EVDO],
+                    values[SIGNAL_GSM],
+                    values[SIGNAL_UMTS],
+                    values[SIGNAL_LTE]);
+
+    for (i = 0; i < SIGNAL_LAST; i++) {
+        if (values[i] || !keep_missing[i])
+            set_value (skeleton, i, values[i]);
+        g_clear_object (&values[i]);
+    }
+
+    /* Flush right away */
+    g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (skeleton));
+
+    g_object_unref (skeleton);
+}
+
 static void
 load_values_ready (MMIfaceModemSignal *self,
                    GAsyncResult *res)
 {
-    GVariant *dictionary;
     GError *error = NULL;
-    MMSignal *cdma = NULL;
-    MMSignal *evdo = NULL;
-    MMSignal *gsm = NULL;
-    MMSignal *umts = NULL;
-    MMSignal *lte = NULL;
-    MmGdbusModemSignal *skeleton;
+    MMSignal *values[SIGNAL_LAST] = { NULL };
+    RefreshContext *ctx;
+    gboolean keep[SIGNAL_LAST] = { FALSE };
 
     if (!MM_IFACE_MODEM_SIGNAL_GET_INTERFACE (self)->load_values_finish (
             self,
             res,
-            &cdma,
-            &evdo,
-            &gsm,
-            &umts,
-            &lte,
+            &values[SIGNAL_CDMA],
+            &values[SIGNAL_EVDO],
+            &values[SIGNAL_GSM],
+            &values[SIGNAL_UMTS],
+            &values[SIGNAL_LTE],
             &error)) {
         mm_obj_warn (self, "couldn't load extended signal information: %s", error->message);
         g_error_free (error);
@@ -99,58 +260,76 @@ load_values_ready (MMIfaceModemSignal *self,
         return;
     }
 
-    g_object_get (self,
-                  MM_IFACE_MODEM_SIGNAL_DBUS_SKELETON, &skeleton,
-                  NULL);
-    if (!skeleton) {
-        mm_obj_warn (self, "cannot update extended signal information: couldn't get interface skeleton");
-        return;
+    ctx = g_object_get_qdata (G_OBJECT (self), refresh_context_quark);
+    if (ctx) {
+        gint64 now;
+        guint  i;
+
+        now = g_get_monotonic_time ();
+        for (i = 0; i < SIGNAL_LAST; i++) {
+            if (!ctx->unsolicited_time[i])
+                continue;
+            if (now - ctx->unsolicited_time[i] < (gint64) UNSOLICITED_MAX_AGE_PERIODS * ctx->rate * G_USEC_PER_SEC) {
+                keep[i] = TRUE;
+                continue;
+            }
+            /* Stale, cleared unless loaded now */
+            mm_obj_dbg (self, "unsolicited %s extended signal information expired", signal_names[i]);
+            ctx->unsolicited_time[i] = 0;
+        }
     }
+    apply_values (self, values, keep);
+}
 
-    if (cdma) {
-        dictionary = mm_signal_get_dictionary (cdma);
-        mm_gdbus_modem_signal_set_cdma (skeleton, dictionary);
-        g_variant_unref (dictionary);
-        g_object_unref (cdma);
-    } else
-        mm_gdbus_modem_signal_set_cdma (skeleton, NULL);
-
-    if (evdo) {
-        dictionary = mm_signal_get_dictionary (evdo);
-        mm_gdbus_modem_signal_set_evdo (skeleton, dictionary);
-        g_variant_unref (dictionary);
-        g_object_unref (evdo);
-    } else
-        mm_gdbus_modem_signal_set_evdo (skeleton, NULL);
+static gboolean
+flush_updates_cb (RefreshContext *ctx)
+{
+    MMSignal *values[SIGNAL_LAST];
+    static const gboolean keep_all[SIGNAL_LAST] = { TRUE, TRUE, TRUE, TRUE, TRUE };
+
+    ctx->flush_source = 0;
+    memcpy (values, ctx->pending, sizeof (values));
+    memset (ctx->pending, 0, sizeof (ctx->pending));
+    apply_values (ctx->self, values, keep_all);
+    return G_SOURCE_REMOVE;
+}
 
-    if (gsm) {
-        dictionary = mm_signal_get_dictionary (gsm);
-        mm_gdbus_modem_signal_set_gsm (skeleton, dictionary);
-        g_variant_unref (dictionary);
-        g_object_unref (gsm);
-    } else
-        mm_gdbus_modem_signal_set_gsm (skeleton, NULL);
+void
+mm_iface_modem_signal_update (MMIfaceModemSignal *self,
+                              MMSignal           *cdma,
+                              MMSignal           *evdo,
+                              MMSignal           *gsm,
+                              MMSignal           *umts,
+                              MMSignal           *lte)
+{
+    RefreshContext *ctx;
+    MMSignal       *values[SIGNAL_LAST] = { cdma, evdo, gsm, umts, lte };
+    gint64          now;
+    guint           i;
 
-    if (umts) {
-        dictionary = mm_signal_get_dictionary (umts);
-        mm_gdbus_modem_signal_set_umts (skeleton, dictionary);
-        g_variant_unref (dictionary);
-        g_object_unref (umts);
-    } else
-        mm_gdbus_modem_signal_set_umts (skeleton, NULL);
+    if (G_UNLIKELY (!refresh_context_quark))
+        refresh_context_quark  = g_quark_from_static_string (REFRESH_CONTEXT_TAG);
 
-    if (lte) {
-        dictionary = mm_signal_get_dictionary (lte);
-        mm_gdbus_modem_signal_set_lte (skeleton, dictionary);
-        g_variant_unref (dictionary);
-        g_object_unref (lte);
-    } else
-        mm_gdbus_modem_signal_set_lte (skeleton, NULL);
+    /* Only while reporting is enabled */
+    ctx = g_object_get_qdata (G_OBJECT (self), refresh_context_quark);
+    if (!ctx)
+        return;
 
-    /* Flush right away */
-    g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (skeleton));
+    now = g_get_monotonic_time ();
+    for (i = 0; i < SIGNAL_LAST; i++) {
+        if (!values[i])
+            continue;
+        ctx->n_updates++;
+        ctx->unsolicited_time[i] = now;
+        if (ctx->pending[i]) {
+            ctx->n_dropped++;
+            g_object_unref (ctx->pending[i]);
+        }
+        ctx->pending[i] = g_object_ref (values[i]);
+    }
 
-    g_object_unref (skeleton);
+    if (!ctx->flush_source)
+        ctx->flush_source = g_timeout_add (UPDATE_FLUSH_INTERVAL_MS, (GSourceFunc) flush_updates_cb, ctx);
 }
 
 static gboolean
@@ -224,6 +403,8 @@ setup_refresh_context (MMIfaceModemSignal *self,
     ctx = g_object_get_qdata (G_OBJECT (self), refresh_context_quark);
     if (!ctx) {
         ctx = g_slice_new0 (RefreshContext);
+        ctx->self = self;
+        ctx->scheduler = g_object_ref (mm_base_modem_peek_poll_scheduler (MM_BASE_MODEM (self)));
         g_object_set_qdata_full (G_OBJECT (self),
                                  refresh_context_quark,
                                  ctx,
@@ -240,8 +421,13 @@ setup_refresh_context (MMIfaceModemSignal *self,
     mm_obj_dbg (self, "extended signal information reporting enabled (rate: %u seconds)", new_rate);
     ctx->rate = new_rate;
     if (ctx->timeout_source)
-        g_source_remove (ctx->timeout_source);
-    ctx->timeout_source = g_timeout_add_seconds (ctx->rate, (GSourceFunc) refresh_context_cb, self);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
+    ctx->timeout_source = mm_poll_scheduler_add (ctx->scheduler,
+                                                 "extended-signal",
+                                                 ctx->rate,
+                                                 MM_POLL_JOB_FLAG_DEFER_WHEN_BUSY,
+                                                 (GSourceFunc) refresh_context_cb,
+                                                 self);
 
     /* Also launch right away */
     refresh_context_cb (self);
@@ -307,6 +493,36 @@ handle_setup (MmGdbusModemSignal *skeleton,
 
 /*****************************************************************************/
 
+static gboolean
+handle_get_history (MmGdbusModemSignal    *skeleton,
+                    GDBusMethodInvocation *invocation,
+                    guint64                since,
+                    guint                  max,
+                    guint                  aggregation,
+                    MMIfaceModemSignal    *self)
+{
+    if (aggregation > MM_SIGNAL_HISTORY_AGGREGATION_MAX) {
+        g_dbus_method_invocation_return_error (invocation,
+                                               MM_CORE_ERROR,
+                                               MM_CORE_ERROR_INVALID_ARGS,
+                                               "Invalid aggregation: %u", aggregation);
+        return TRUE;
+    }
+
+    /* Values are public in the interface properties already, so no
+     * authorization is required to read their history */
+    mm_gdbus_modem_signal_complete_get_history (
+        skeleton,
+        invocation,
+        mm_signal_history_build (peek_history (self),
+                                 since,
+                                 max,
+                                 (MMSignalHistoryAggregation) aggregation));
+    return TRUE;
+}
+
+/*****************************************************************************/
+
 gboolean
 mm_iface_modem_signal_disable_finish (MMIfaceModemSignal *self,
                                       GAsyncResult *res,
@@ -493,6 +709,10 @@ interface_initialization_step (GTask *task)
                           "handle-setup",
                           G_CALLBACK (handle_setup),
                           self);
+        g_signal_connect (ctx->skeleton,
+                          "handle-get-history",
+                          G_CALLBACK (handle_get_history),
+                          self);
         /* Finally, export the new interface */
         mm_gdbus_object_skeleton_set_modem_signal (MM_GDBUS_OBJECT_SKELETON (self),
                                                    MM_GDBUS_MODEM_SIGNAL (ctx->skeleton));
@@ -548,6 +768,10 @@ mm_iface_modem_signal_shutdown (MMIfaceModemSignal *self)
     /* Teardown refresh context */
     teardown_refresh_context (self);
 
+    /* Drop history */
+    if (history_quark)
+        g_object_set_qdata (G_OBJECT (self), history_quark, NULL);
+
     /* Unexport DBus interface and remove the skeleton */
     mm_gdbus_object_skeleton_set_modem_signal (MM_GDBUS_OBJECT_SKELETON (self), NULL);
     g_object_set (self,
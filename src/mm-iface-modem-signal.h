@@ -88,6 +88,17 @@ gboolean mm_iface_modem_signal_disable_finish (MMIfaceModemSignal *self,
 /* Shutdown Signal interface */
 void mm_iface_modem_signal_shutdown (MMIfaceModemSignal *self);
 
+/* Report values obtained without polling, e.g. from a stream of measurements.
+ * Only the given technologies are updated; values arriving faster than they
+ * can be published are coalesced, keeping the latest one. Ignored unless
+ * extended signal information reporting is enabled. */
+void mm_iface_modem_signal_update (MMIfaceModemSignal *self,
+                                   MMSignal           *cdma,
+                                   MMSignal           *evdo,
+                                   MMSignal           *gsm,
+                                   MMSignal           *umts,
+                                   MMSignal           *lte);
+
 /* Bind properties for simple GetStatus() */
 void mm_iface_modem_signal_bind_simple_status (MMIfaceModemSignal *self,
                                                MMSimpleStatus *status);
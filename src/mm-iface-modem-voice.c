@@ -20,6 +20,7 @@
 
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-voice.h"
+#include "mm-base-modem.h"
 #include "mm-call-list.h"
 #include "mm-log-object.h"
 
@@ -2360,15 +2361,17 @@ setup_in_call_event_handling (MMCallList        *call_list,
 #define CALL_LIST_POLLING_TIMEOUT_SECS 2
 
 typedef struct {
-    guint    polling_id;
-    gboolean polling_ongoing;
+    MMPollScheduler *scheduler;
+    guint            polling_id;
+    gboolean         polling_ongoing;
 } CallListPollingContext;
 
 static void
 call_list_polling_context_free (CallListPollingContext *ctx)
 {
     if (ctx->polling_id)
-        g_source_remove (ctx->polling_id);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->polling_id);
+    g_object_unref (ctx->scheduler);
     g_slice_free (CallListPollingContext, ctx);
 }
 
@@ -2385,6 +2388,7 @@ get_call_list_polling_context (MMIfaceModemVoice *self)
     if (!ctx) {
         /* Create context and keep it as object data */
         ctx = g_slice_new0 (CallListPollingContext);
+        ctx->scheduler = g_object_ref (mm_base_modem_peek_poll_scheduler (MM_BASE_MODEM (self)));
 
         g_object_set_qdata_full (
             G_OBJECT (self),
@@ -2398,6 +2402,21 @@ get_call_list_polling_context (MMIfaceModemVoice *self)
 
 static gboolean call_list_poll (MMIfaceModemVoice *self);
 
+static void
+schedule_call_list_poll (MMIfaceModemVoice      *self,
+                         CallListPollingContext *ctx)
+{
+    /* Never deferred while the ports are busy, as the call state changes
+     * need to be reported right away */
+    g_assert (!ctx->polling_id);
+    ctx->polling_id = mm_poll_scheduler_add (ctx->scheduler,
+                                             "call-list",
+                                             CALL_LIST_POLLING_TIMEOUT_SECS,
+                                             MM_POLL_JOB_FLAG_NONE,
+                                             (GSourceFunc) call_list_poll,
+                                             self);
+}
+
 static void
 load_call_list_ready (MMIfaceModemVoice *self,
                       GAsyncResult      *res)
@@ -2423,9 +2442,7 @@ load_call_list_ready (MMIfaceModemVoice *self,
      * we reported calls (e.g. a new incoming call may have been detected that
      * also triggers the poll setup) */
     if (!ctx->polling_id)
-        ctx->polling_id = g_timeout_add_seconds (CALL_LIST_POLLING_TIMEOUT_SECS,
-                                                 (GSourceFunc) call_list_poll,
-                                                 self);
+        schedule_call_list_poll (self, ctx);
 }
 
 static void
@@ -2497,9 +2514,7 @@ setup_call_list_polling (MMCallList        *call_list,
     ctx = get_call_list_polling_context (self);
 
     if (!ctx->polling_id && !ctx->polling_ongoing)
-        ctx->polling_id = g_timeout_add_seconds (CALL_LIST_POLLING_TIMEOUT_SECS,
-                                                 (GSourceFunc) call_list_poll,
-                                                 self);
+        schedule_call_list_poll (self, ctx);
 }
 
 /*****************************************************************************/
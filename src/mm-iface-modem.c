@@ -29,6 +29,7 @@
 #include "mm-bearer-list.h"
 #include "mm-log-object.h"
 #include "mm-context.h"
+#include "mm-connection-timings.h"
 
 #if defined WITH_MBIM
 #include "mm-broadband-modem-mbim.h"
@@ -38,17 +39,21 @@
 
 #define SIGNAL_CHECK_INITIAL_RETRIES      5
 #define SIGNAL_CHECK_INITIAL_TIMEOUT_SEC  3
+#define SIGNAL_CHECK_FAST_TIMEOUT_SEC     10
 #define SIGNAL_CHECK_TIMEOUT_SEC          30
+#define SIGNAL_CHECK_MAX_TIMEOUT_SEC      300
 
 #define STATE_UPDATE_CONTEXT_TAG          "state-update-context-tag"
 #define SIGNAL_QUALITY_UPDATE_CONTEXT_TAG "signal-quality-update-context-tag"
 #define SIGNAL_CHECK_CONTEXT_TAG          "signal-check-context-tag"
 #define RESTART_INITIALIZE_IDLE_TAG       "restart-initialize-tag"
+#define CONNECTION_TIMINGS_TAG            "connection-timings-tag"
 
 static GQuark state_update_context_quark;
 static GQuark signal_quality_update_context_quark;
 static GQuark signal_check_context_quark;
 static GQuark restart_initialize_idle_quark;
+static GQuark connection_timings_quark;
 
 /*****************************************************************************/
 
@@ -814,6 +819,146 @@ handle_command (MmGdbusModem *skeleton,
 
 /*****************************************************************************/
 
+typedef struct {
+    MmGdbusModem *skeleton;
+    GDBusMethodInvocation *invocation;
+    MMIfaceModem *self;
+    gchar *name;
+    guint max_size;
+} HandleSetPortCaptureContext;
+
+static void
+handle_set_port_capture_context_free (HandleSetPortCaptureContext *ctx)
+{
+    g_object_unref (ctx->skeleton);
+    g_object_unref (ctx->invocation);
+    g_object_unref (ctx->self);
+    g_free (ctx->name);
+    g_free (ctx);
+}
+
+static void
+handle_set_port_capture_auth_ready (MMBaseModem *self,
+                                    GAsyncResult *res,
+                                    HandleSetPortCaptureContext *ctx)
+{
+    MMPortCapture *capture;
+    GError *error = NULL;
+
+    if (!mm_base_modem_authorize_finish (self, res, &error)) {
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+        handle_set_port_capture_context_free (ctx);
+        return;
+    }
+
+    /* Empty name stops the capture */
+    if (!ctx->name[0]) {
+        mm_base_modem_set_port_capture (self, NULL);
+        mm_gdbus_modem_complete_set_port_capture (ctx->skeleton, ctx->invocation);
+        handle_set_port_capture_context_free (ctx);
+        return;
+    }
+
+    /* Only plain file names are accepted, always created in the daemon
+     * captures directory */
+    capture = mm_port_capture_new (PORTCAPTUREDIR, ctx->name, ctx->max_size, &error);
+    if (!capture) {
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+        handle_set_port_capture_context_free (ctx);
+        return;
+    }
+
+    mm_base_modem_set_port_capture (self, capture);
+    mm_port_capture_unref (capture);
+    mm_gdbus_modem_complete_set_port_capture (ctx->skeleton, ctx->invocation);
+    handle_set_port_capture_context_free (ctx);
+}
+
+static gboolean
+handle_set_port_capture (MmGdbusModem *skeleton,
+                         GDBusMethodInvocation *invocation,
+                         const gchar *name,
+                         guint max_size,
+                         MMIfaceModem *self)
+{
+    HandleSetPortCaptureContext *ctx;
+
+    ctx = g_new (HandleSetPortCaptureContext, 1);
+    ctx->skeleton = g_object_ref (skeleton);
+    ctx->invocation = g_object_ref (invocation);
+    ctx->self = g_object_ref (self);
+    ctx->name = g_strdup (name);
+    ctx->max_size = max_size;
+
+    /* Files are created with the daemon privileges */
+    mm_base_modem_authorize (MM_BASE_MODEM (self),
+                             invocation,
+                             MM_AUTHORIZATION_MANAGER_CONTROL,
+                             (GAsyncReadyCallback)handle_set_port_capture_auth_ready,
+                             ctx);
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    MmGdbusModem *skeleton;
+    GDBusMethodInvocation *invocation;
+    MMIfaceModem *self;
+} HandleGetRecentLogContext;
+
+static void
+handle_get_recent_log_context_free (HandleGetRecentLogContext *ctx)
+{
+    g_object_unref (ctx->skeleton);
+    g_object_unref (ctx->invocation);
+    g_object_unref (ctx->self);
+    g_free (ctx);
+}
+
+static void
+handle_get_recent_log_auth_ready (MMBaseModem *self,
+                                  GAsyncResult *res,
+                                  HandleGetRecentLogContext *ctx)
+{
+    GError *error = NULL;
+    gchar **records;
+
+    if (!mm_base_modem_authorize_finish (self, res, &error)) {
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+        handle_get_recent_log_context_free (ctx);
+        return;
+    }
+
+    records = mm_base_modem_get_recent_log (self);
+    mm_gdbus_modem_complete_get_recent_log (ctx->skeleton, ctx->invocation, (const gchar *const *) records);
+    g_strfreev (records);
+    handle_get_recent_log_context_free (ctx);
+}
+
+static gboolean
+handle_get_recent_log (MmGdbusModem *skeleton,
+                       GDBusMethodInvocation *invocation,
+                       MMIfaceModem *self)
+{
+    HandleGetRecentLogContext *ctx;
+
+    ctx = g_new (HandleGetRecentLogContext, 1);
+    ctx->skeleton = g_object_ref (skeleton);
+    ctx->invocation = g_object_ref (invocation);
+    ctx->self = g_object_ref (self);
+
+    /* Debug messages may include PINs or other secrets */
+    mm_base_modem_authorize (MM_BASE_MODEM (self),
+                             invocation,
+                             MM_AUTHORIZATION_MANAGER_CONTROL,
+                             (GAsyncReadyCallback)handle_get_recent_log_auth_ready,
+                             ctx);
+    return TRUE;
+}
+
+/*****************************************************************************/
+
 typedef struct {
     MmGdbusModem *skeleton;
     GDBusMethodInvocation *invocation;
@@ -1009,8 +1154,13 @@ mm_iface_modem_update_access_technologies (MMIfaceModem *self,
 
 typedef struct {
     guint recent_timeout_source;
+    guint recent_timeout_sec;
 } SignalQualityUpdateContext;
 
+static guint signal_check_get_recent_timeout (MMIfaceModem *self);
+static void  signal_check_report_unsolicited (MMIfaceModem *self,
+                                              guint         signal_quality);
+
 static void
 signal_quality_update_context_free (SignalQualityUpdateContext *ctx)
 {
@@ -1025,6 +1175,8 @@ expire_signal_quality (MMIfaceModem *self)
     MmGdbusModem *skeleton = NULL;
     SignalQualityUpdateContext *ctx;
 
+    ctx = g_object_get_qdata (G_OBJECT (self), signal_quality_update_context_quark);
+
     g_object_get (self,
                   MM_IFACE_MODEM_DBUS_SKELETON, &skeleton,
                   NULL);
@@ -1043,7 +1195,7 @@ expire_signal_quality (MMIfaceModem *self)
         /* If value is already not recent, we're done */
         if (recent) {
             mm_obj_dbg (self, "signal quality value not updated in %us, marking as not being recent",
-                        SIGNAL_QUALITY_RECENT_TIMEOUT_SEC);
+                        ctx->recent_timeout_sec);
             mm_gdbus_modem_set_signal_quality (skeleton,
                                                g_variant_new ("(ub)",
                                                               signal_quality,
@@ -1054,7 +1206,6 @@ expire_signal_quality (MMIfaceModem *self)
     }
 
     /* Remove source id */
-    ctx = g_object_get_qdata (G_OBJECT (self), signal_quality_update_context_quark);
     ctx->recent_timeout_source = 0;
     return G_SOURCE_REMOVE;
 }
@@ -1108,12 +1259,16 @@ update_signal_quality (MMIfaceModem *self,
         ctx->recent_timeout_source = 0;
     }
 
-    /* If we got a new expirable value, setup new timeout */
-    if (expire)
+    /* If we got a new expirable value, setup new timeout. While periodic
+     * checks are backed off the value is still considered recent until the
+     * next check is overdue. */
+    if (expire) {
+        ctx->recent_timeout_sec = signal_check_get_recent_timeout (self);
         ctx->recent_timeout_source = (g_timeout_add_seconds (
-                                          SIGNAL_QUALITY_RECENT_TIMEOUT_SEC,
+                                          ctx->recent_timeout_sec,
                                           (GSourceFunc)expire_signal_quality,
                                           self));
+    }
 
     g_object_unref (skeleton);
 }
@@ -1122,6 +1277,7 @@ void
 mm_iface_modem_update_signal_quality (MMIfaceModem *self,
                                       guint signal_quality)
 {
+    signal_check_report_unsolicited (self, signal_quality);
     update_signal_quality (self, signal_quality, TRUE);
 }
 
@@ -1137,8 +1293,9 @@ typedef enum {
 } SignalCheckStep;
 
 typedef struct {
-    gboolean enabled;
-    guint    timeout_source;
+    gboolean         enabled;
+    MMPollScheduler *scheduler;
+    guint            timeout_source;
 
     /* We first attempt an initial loading, and once it's done we
      * setup polling */
@@ -1147,8 +1304,15 @@ typedef struct {
 
     /* Values polled in this iteration */
     guint                   signal_quality;
+    gboolean                signal_quality_loaded;
     MMModemAccessTechnology access_technologies;
     guint                   access_technologies_mask;
+    gboolean                access_technologies_loaded;
+
+    /* Adaptive polling: interval after the initial check and monotonic time
+     * (seconds) of the last unsolicited update */
+    MMSignalCheckInterval   adaptive;
+    gint64                  last_unsolicited_update;
 
     /* If both signal and access tech polling are either unsupported
      * or disabled, we'll automatically stop polling */
@@ -1165,24 +1329,45 @@ static void
 signal_check_context_free (SignalCheckContext *ctx)
 {
     if (ctx->timeout_source)
-        g_source_remove (ctx->timeout_source);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
+    g_object_unref (ctx->scheduler);
     g_slice_free (SignalCheckContext, ctx);
 }
 
+/* Returns NULL if periodic checks were never enabled */
 static SignalCheckContext *
-get_signal_check_context (MMIfaceModem *self)
+peek_signal_check_context (MMIfaceModem *self)
 {
-    SignalCheckContext *ctx;
-
     if (G_UNLIKELY (!signal_check_context_quark))
         signal_check_context_quark = (g_quark_from_static_string (
                                           SIGNAL_CHECK_CONTEXT_TAG));
 
-    ctx = g_object_get_qdata (G_OBJECT (self), signal_check_context_quark);
+    return g_object_get_qdata (G_OBJECT (self), signal_check_context_quark);
+}
+
+/* Only while polling, i.e. after ensure_signal_check_context() */
+static SignalCheckContext *
+get_signal_check_context (MMIfaceModem *self)
+{
+    SignalCheckContext *ctx;
+
+    ctx = peek_signal_check_context (self);
+    g_assert (ctx);
+    return ctx;
+}
+
+static SignalCheckContext *
+ensure_signal_check_context (MMIfaceModem *self)
+{
+    SignalCheckContext *ctx;
+
+    ctx = peek_signal_check_context (self);
     if (!ctx) {
         /* Create context and attach it to the object */
         ctx = g_slice_new0 (SignalCheckContext);
         ctx->running_step = SIGNAL_CHECK_STEP_NONE;
+        ctx->scheduler = g_object_ref (mm_base_modem_peek_poll_scheduler (MM_BASE_MODEM (self)));
+        mm_signal_check_interval_reset (&ctx->adaptive, SIGNAL_CHECK_TIMEOUT_SEC);
 
         /* Initially assume supported if load_access_technologies() is
          * implemented. If the plugin reports an UNSUPPORTED error we'll clear
@@ -1206,7 +1391,6 @@ get_signal_check_context (MMIfaceModem *self)
                                  ctx, (GDestroyNotify) signal_check_context_free);
     }
 
-    g_assert (ctx);
     return ctx;
 }
 
@@ -1241,8 +1425,10 @@ access_technologies_check_ready (MMIfaceModem *self,
         g_error_free (error);
     }
     /* We may have been disabled while this command was running. */
-    else if (ctx->enabled)
+    else if (ctx->enabled) {
+        ctx->access_technologies_loaded = TRUE;
         mm_iface_modem_update_access_technologies (self, ctx->access_technologies, ctx->access_technologies_mask);
+    }
 
     /* Go on */
     ctx->running_step++;
@@ -1271,14 +1457,65 @@ signal_quality_check_ready (MMIfaceModem *self,
         g_error_free (error);
     }
     /* We may have been disabled while this command was running. */
-    else if (ctx->enabled)
+    else if (ctx->enabled) {
+        ctx->signal_quality_loaded = TRUE;
         update_signal_quality (self, ctx->signal_quality, TRUE);
+    }
 
     /* Go on */
     ctx->running_step++;
     peridic_signal_check_step (self);
 }
 
+static guint
+signal_check_get_max_interval (void)
+{
+    guint max_interval;
+
+    max_interval = mm_context_get_signal_check_max_interval ();
+    if (!max_interval)
+        return SIGNAL_CHECK_MAX_TIMEOUT_SEC;
+    return MAX (max_interval, SIGNAL_CHECK_FAST_TIMEOUT_SEC);
+}
+
+static guint
+signal_check_next_interval (MMIfaceModem       *self,
+                            SignalCheckContext *ctx)
+{
+    MMModemState state = MM_MODEM_STATE_UNKNOWN;
+    guint        previous;
+    guint        interval;
+
+    g_object_get (self,
+                  MM_IFACE_MODEM_STATE, &state,
+                  NULL);
+
+    previous = ctx->adaptive.interval;
+    interval = mm_signal_check_interval_update (&ctx->adaptive,
+                                                ctx->signal_quality_loaded,
+                                                ctx->signal_quality,
+                                                ctx->access_technologies_loaded,
+                                                ctx->access_technologies & ctx->access_technologies_mask,
+                                                state == MM_MODEM_STATE_CONNECTING,
+                                                SIGNAL_CHECK_FAST_TIMEOUT_SEC,
+                                                signal_check_get_max_interval ());
+
+    if (interval < previous)
+        mm_obj_dbg (self, "signal check interval reset to %us: %s",
+                    interval, state == MM_MODEM_STATE_CONNECTING ? "connecting" : "values changed");
+    else if (interval > previous) {
+        gboolean unsolicited;
+
+        /* Unsolicited updates keep the values fresh meanwhile, if the modem
+         * sends them */
+        unsolicited = (ctx->last_unsolicited_update &&
+                       (g_get_monotonic_time () / G_USEC_PER_SEC) - ctx->last_unsolicited_update <= previous);
+        mm_obj_dbg (self, "signal check interval backed off to %us: %s",
+                    interval, unsolicited ? "unsolicited updates received" : "values stable");
+    }
+    return interval;
+}
+
 static void
 peridic_signal_check_step (MMIfaceModem *self)
 {
@@ -1357,9 +1594,15 @@ peridic_signal_check_step (MMIfaceModem *self)
             return;
         }
 
+        if (ctx->initial_check_done)
+            signal_check_next_interval (self, ctx);
+
         mm_obj_dbg (self, "periodic signal quality and access technology checks scheduled");
         g_assert (!ctx->timeout_source);
-        ctx->timeout_source = g_timeout_add_seconds (ctx->initial_check_done ? SIGNAL_CHECK_TIMEOUT_SEC : SIGNAL_CHECK_INITIAL_TIMEOUT_SEC,
+        ctx->timeout_source = mm_poll_scheduler_add (ctx->scheduler,
+                                                     "signal-check",
+                                                     ctx->initial_check_done ? ctx->adaptive.interval : SIGNAL_CHECK_INITIAL_TIMEOUT_SEC,
+                                                     MM_POLL_JOB_FLAG_DEFER_WHEN_BUSY,
                                                      (GSourceFunc) periodic_signal_check_cb,
                                                      self);
         return;
@@ -1378,10 +1621,12 @@ periodic_signal_check_cb (MMIfaceModem *self)
     g_assert (ctx->enabled);
 
     /* Start the sequence */
-    ctx->running_step             = SIGNAL_CHECK_STEP_FIRST;
-    ctx->signal_quality           = 0;
-    ctx->access_technologies      = MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN;
-    ctx->access_technologies_mask = MM_MODEM_ACCESS_TECHNOLOGY_ANY;
+    ctx->running_step               = SIGNAL_CHECK_STEP_FIRST;
+    ctx->signal_quality             = 0;
+    ctx->signal_quality_loaded      = FALSE;
+    ctx->access_technologies        = MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN;
+    ctx->access_technologies_mask   = MM_MODEM_ACCESS_TECHNOLOGY_ANY;
+    ctx->access_technologies_loaded = FALSE;
     peridic_signal_check_step (self);
 
 #if defined WITH_MBIM
@@ -1409,8 +1654,8 @@ mm_iface_modem_refresh_signal (MMIfaceModem *self)
     SignalCheckContext *ctx;
 
     /* Don't refresh polling if we're not enabled */
-    ctx = get_signal_check_context (self);
-    if (!ctx->enabled) {
+    ctx = peek_signal_check_context (self);
+    if (!ctx || !ctx->enabled) {
         mm_obj_dbg (self, "periodic signal check refresh ignored: checks not enabled");
         return;
     }
@@ -1426,7 +1671,7 @@ mm_iface_modem_refresh_signal (MMIfaceModem *self)
     /* Remove the scheduled timeout as we're going to refresh
      * right away */
     if (ctx->timeout_source) {
-        g_source_remove (ctx->timeout_source);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
         ctx->timeout_source = 0;
     }
 
@@ -1434,6 +1679,7 @@ mm_iface_modem_refresh_signal (MMIfaceModem *self)
      * so that we poll at a higher frequency */
     ctx->initial_retries    = SIGNAL_CHECK_INITIAL_RETRIES;
     ctx->initial_check_done = FALSE;
+    mm_signal_check_interval_reset (&ctx->adaptive, SIGNAL_CHECK_FAST_TIMEOUT_SEC);
 
     /* Start sequence */
     periodic_signal_check_cb (self);
@@ -1445,8 +1691,8 @@ periodic_signal_check_disable (MMIfaceModem *self,
 {
     SignalCheckContext *ctx;
 
-    ctx = get_signal_check_context (self);
-    if (!ctx->enabled)
+    ctx = peek_signal_check_context (self);
+    if (!ctx || !ctx->enabled)
         return;
 
     /* Clear access technology and signal quality */
@@ -1459,7 +1705,7 @@ periodic_signal_check_disable (MMIfaceModem *self,
 
     /* Remove scheduled timeout */
     if (ctx->timeout_source) {
-        g_source_remove (ctx->timeout_source);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
         ctx->timeout_source = 0;
     }
 
@@ -1472,7 +1718,7 @@ periodic_signal_check_enable (MMIfaceModem *self)
 {
     SignalCheckContext *ctx;
 
-    ctx = get_signal_check_context (self);
+    ctx = ensure_signal_check_context (self);
 
     /* If polling access technology and signal quality not supported, don't even
      * bother trying. */
@@ -1491,6 +1737,56 @@ periodic_signal_check_enable (MMIfaceModem *self)
     mm_iface_modem_refresh_signal (self);
 }
 
+static void
+periodic_signal_check_speed_up (MMIfaceModem *self)
+{
+    SignalCheckContext *ctx;
+
+    ctx = peek_signal_check_context (self);
+
+    /* Nothing to do if not polling, or if the next check is already close */
+    if (!ctx || !ctx->enabled || !ctx->timeout_source || !ctx->initial_check_done ||
+        ctx->adaptive.interval <= SIGNAL_CHECK_FAST_TIMEOUT_SEC)
+        return;
+
+    mm_obj_dbg (self, "signal check interval reset to %us: connecting", SIGNAL_CHECK_FAST_TIMEOUT_SEC);
+    mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
+    mm_signal_check_interval_reset (&ctx->adaptive, SIGNAL_CHECK_FAST_TIMEOUT_SEC);
+    ctx->timeout_source = mm_poll_scheduler_add (ctx->scheduler,
+                                                 "signal-check",
+                                                 ctx->adaptive.interval,
+                                                 MM_POLL_JOB_FLAG_DEFER_WHEN_BUSY,
+                                                 (GSourceFunc) periodic_signal_check_cb,
+                                                 self);
+}
+
+static guint
+signal_check_get_recent_timeout (MMIfaceModem *self)
+{
+    SignalCheckContext *ctx;
+
+    ctx = peek_signal_check_context (self);
+    if (!ctx || !ctx->enabled || !ctx->initial_check_done)
+        return SIGNAL_QUALITY_RECENT_TIMEOUT_SEC;
+    return MAX (SIGNAL_QUALITY_RECENT_TIMEOUT_SEC, 2 * ctx->adaptive.interval);
+}
+
+static void
+signal_check_report_unsolicited (MMIfaceModem *self,
+                                 guint         signal_quality)
+{
+    SignalCheckContext *ctx;
+
+    /* Unsolicited updates are already known values for the next check, so
+     * they don't count as changes and polling keeps backing off. Nothing to
+     * do if periodic checks were never enabled. */
+    ctx = peek_signal_check_context (self);
+    if (!ctx)
+        return;
+    mm_signal_check_interval_report (&ctx->adaptive, signal_quality);
+    ctx->last_unsolicited_update = g_get_monotonic_time () / G_USEC_PER_SEC;
+}
+
 /*****************************************************************************/
 
 static void
@@ -1596,6 +1892,9 @@ __iface_modem_update_state_internal (MMIfaceModem *self,
          * cleanup signal quality retrieval */
         else if (old_state >= MM_MODEM_STATE_REGISTERED && new_state < MM_MODEM_STATE_REGISTERED)
             periodic_signal_check_disable (self, TRUE);
+        /* Signal may change quickly while a bearer is connecting */
+        else if (new_state == MM_MODEM_STATE_CONNECTING)
+            periodic_signal_check_speed_up (self);
     }
 
     if (skeleton)
@@ -4531,6 +4830,38 @@ mm_iface_modem_update_own_numbers (MMIfaceModem *self,
     }
 }
 
+/*****************************************************************************/
+
+void
+mm_iface_modem_update_connection_timings (MMIfaceModem              *self,
+                                          const MMConnectionTimings *timings)
+{
+    MMConnectionTimingsHistogram *histogram;
+    MmGdbusModem                 *skeleton = NULL;
+
+    if (G_UNLIKELY (!connection_timings_quark))
+        connection_timings_quark = (g_quark_from_static_string (
+                                        CONNECTION_TIMINGS_TAG));
+
+    histogram = g_object_get_qdata (G_OBJECT (self), connection_timings_quark);
+    if (!histogram) {
+        histogram = mm_connection_timings_histogram_new ();
+        g_object_set_qdata_full (G_OBJECT (self),
+                                 connection_timings_quark,
+                                 histogram,
+                                 (GDestroyNotify) mm_connection_timings_histogram_free);
+    }
+    mm_connection_timings_histogram_add (histogram, timings);
+
+    g_object_get (self,
+                  MM_IFACE_MODEM_DBUS_SKELETON, &skeleton,
+                  NULL);
+    if (skeleton) {
+        mm_gdbus_modem_set_connection_timing_histograms (skeleton, mm_connection_timings_histogram_get_variant (histogram));
+        g_object_unref (skeleton);
+    }
+}
+
 static void
 load_own_numbers_ready (MMIfaceModem *self,
                         GAsyncResult *res,
@@ -5290,6 +5621,8 @@ interface_initialization_step (GTask *task)
                           "signal::handle-enable",                   G_CALLBACK (handle_enable),                   self,
                           "signal::handle-set-current-bands",        G_CALLBACK (handle_set_current_bands),        self,
                           "signal::handle-set-current-modes",        G_CALLBACK (handle_set_current_modes),        self,
+                          "signal::handle-set-port-capture",         G_CALLBACK (handle_set_port_capture),         self,
+                          "signal::handle-get-recent-log",           G_CALLBACK (handle_get_recent_log),           self,
                           NULL);
 
         /* Finally, export the new interface, even if we got errors, but only if not
@@ -5365,6 +5698,7 @@ mm_iface_modem_initialize (MMIfaceModem *self,
         mm_gdbus_modem_set_supported_ip_families (skeleton, MM_BEARER_IP_FAMILY_NONE);
         mm_gdbus_modem_set_power_state (skeleton, MM_MODEM_POWER_STATE_UNKNOWN);
         mm_gdbus_modem_set_state_failed_reason (skeleton, MM_MODEM_STATE_FAILED_REASON_NONE);
+        mm_gdbus_modem_set_connection_timing_histograms (skeleton, g_variant_new_array (G_VARIANT_TYPE ("{sau}"), NULL, 0));
 
         /* Bind our State property */
         g_object_bind_property (self, MM_IFACE_MODEM_STATE,
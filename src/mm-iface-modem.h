@@ -26,6 +26,7 @@
 #include "mm-port-serial-at.h"
 #include "mm-base-bearer.h"
 #include "mm-base-sim.h"
+#include "mm-connection-timings.h"
 
 #define MM_TYPE_IFACE_MODEM            (mm_iface_modem_get_type ())
 #define MM_IFACE_MODEM(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_IFACE_MODEM, MMIfaceModem))
@@ -495,6 +496,10 @@ void mm_iface_modem_update_failed_state (MMIfaceModem *self,
 void mm_iface_modem_update_own_numbers (MMIfaceModem *self,
                                         const GStrv own_numbers);
 
+/* Allow reporting the timings of a finished connection attempt */
+void mm_iface_modem_update_connection_timings (MMIfaceModem *self,
+                                               const MMConnectionTimings *timings);
+
 /* Allow reporting new access tech */
 void mm_iface_modem_update_access_technologies (MMIfaceModem *self,
                                                 MMModemAccessTechnology access_tech,
@@ -0,0 +1,328 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <glib-unix.h>
+#include <gio/gio.h>
+
+#include "mm-log-object.h"
+#include "mm-utils.h"
+#include "mm-link-monitor.h"
+
+/* IFF_LOWER_UP lives in linux/if.h, which conflicts with net/if.h */
+#ifndef IFF_LOWER_UP
+# define IFF_LOWER_UP 0x10000
+#endif
+
+typedef struct {
+    guint              id;
+    gchar             *ifname;
+    guint              ifindex;
+    gboolean           link_up;
+    MMLinkMonitorFunc  callback;
+    gpointer           user_data;
+    /* Unwatched while dispatching */
+    gboolean           removed;
+} Watch;
+
+struct _MMLinkMonitor {
+    GObject   parent;
+    GList    *watches;
+    guint     next_id;
+    gint      fd;
+    guint     fd_source_id;
+    gboolean  dispatching;
+};
+
+struct _MMLinkMonitorClass {
+    GObjectClass parent;
+};
+
+static void log_object_iface_init (MMLogObjectInterface *iface);
+
+G_DEFINE_TYPE_EXTENDED (MMLinkMonitor, mm_link_monitor, G_TYPE_OBJECT, 0,
+                        G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
+
+/*****************************************************************************/
+
+static void
+watch_free (Watch *watch)
+{
+    g_free (watch->ifname);
+    g_slice_free (Watch, watch);
+}
+
+static void
+socket_close (MMLinkMonitor *self)
+{
+    if (self->fd_source_id) {
+        g_source_remove (self->fd_source_id);
+        self->fd_source_id = 0;
+    }
+    if (self->fd >= 0) {
+        close (self->fd);
+        self->fd = -1;
+    }
+}
+
+static void
+process_link_message (MMLinkMonitor         *self,
+                      const struct nlmsghdr *hdr)
+{
+    const struct ifinfomsg *ifi;
+    gboolean                link_up;
+    GList                  *l;
+
+    if (hdr->nlmsg_len < NLMSG_LENGTH (sizeof (struct ifinfomsg)))
+        return;
+
+    ifi = NLMSG_DATA (hdr);
+    link_up = (hdr->nlmsg_type == RTM_NEWLINK &&
+               (ifi->ifi_flags & IFF_UP) &&
+               (ifi->ifi_flags & IFF_LOWER_UP));
+
+    for (l = self->watches; l; l = g_list_next (l)) {
+        Watch *watch = l->data;
+
+        if (watch->removed || watch->ifindex != (guint) ifi->ifi_index)
+            continue;
+        /* Notifications are also emitted for unrelated flag or attribute
+         * changes; only report transitions */
+        if (watch->link_up == link_up)
+            continue;
+
+        mm_obj_dbg (self, "interface %s link %s", watch->ifname, link_up ? "up" : "down");
+        watch->link_up = link_up;
+        watch->callback (watch->ifname, link_up, watch->user_data);
+    }
+}
+
+static void
+sweep_removed_watches (MMLinkMonitor *self)
+{
+    GList *l;
+
+    for (l = self->watches; l; ) {
+        GList *next = g_list_next (l);
+
+        if (((Watch *) l->data)->removed) {
+            watch_free (l->data);
+            self->watches = g_list_delete_link (self->watches, l);
+        }
+        l = next;
+    }
+
+    if (!self->watches)
+        socket_close (self);
+}
+
+static gboolean
+socket_ready_cb (gint           fd,
+                 GIOCondition   condition,
+                 MMLinkMonitor *self)
+{
+    guint8 buffer[8192] __attribute__ ((aligned (NLMSG_ALIGNTO)));
+
+    if (condition & (G_IO_ERR | G_IO_HUP)) {
+        mm_obj_warn (self, "netlink socket error: link changes no longer monitored");
+        self->fd_source_id = 0;
+        socket_close (self);
+        return G_SOURCE_REMOVE;
+    }
+
+    self->dispatching = TRUE;
+    for (;;) {
+        const struct nlmsghdr *hdr;
+        gssize                 len;
+
+        len = recv (fd, buffer, sizeof (buffer), MSG_DONTWAIT);
+        if (len < 0) {
+            /* ENOBUFS means some notifications were dropped; the connection
+             * status checks still run periodically, so just go on */
+            if (errno != EAGAIN && errno != EINTR && errno != ENOBUFS)
+                mm_obj_dbg (self, "couldn't read netlink messages: %s", g_strerror (errno));
+            if (errno == EINTR || errno == ENOBUFS)
+                continue;
+            break;
+        }
+        if (len == 0)
+            break;
+
+        for (hdr = (const struct nlmsghdr *) buffer; NLMSG_OK (hdr, len); hdr = NLMSG_NEXT (hdr, len)) {
+            if (hdr->nlmsg_type == RTM_NEWLINK || hdr->nlmsg_type == RTM_DELLINK)
+                process_link_message (self, hdr);
+        }
+    }
+    self->dispatching = FALSE;
+
+    sweep_removed_watches (self);
+    return self->fd_source_id ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+static gboolean
+socket_open (MMLinkMonitor  *self,
+             GError        **error)
+{
+    struct sockaddr_nl addr;
+    gint               fd;
+
+    if (self->fd >= 0)
+        return TRUE;
+
+    fd = socket (AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (fd < 0) {
+        g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                     "couldn't create netlink socket: %s", g_strerror (errno));
+        return FALSE;
+    }
+
+    memset (&addr, 0, sizeof (addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK;
+    if (bind (fd, (struct sockaddr *) &addr, sizeof (addr)) < 0) {
+        g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                     "couldn't bind netlink socket: %s", g_strerror (errno));
+        close (fd);
+        return FALSE;
+    }
+
+    self->fd = fd;
+    self->fd_source_id = g_unix_fd_add (fd,
+                                        G_IO_IN | G_IO_ERR | G_IO_HUP,
+                                        (GUnixFDSourceFunc) socket_ready_cb,
+                                        self);
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+guint
+mm_link_monitor_watch (MMLinkMonitor     *self,
+                       const gchar       *ifname,
+                       MMLinkMonitorFunc  callback,
+                       gpointer           user_data)
+{
+    g_autoptr(GError)  error = NULL;
+    Watch             *watch;
+    guint              ifindex;
+
+    g_return_val_if_fail (MM_IS_LINK_MONITOR (self), 0);
+    g_return_val_if_fail (ifname != NULL, 0);
+    g_return_val_if_fail (callback != NULL, 0);
+
+    ifindex = if_nametoindex (ifname);
+    if (!ifindex) {
+        mm_obj_dbg (self, "couldn't monitor interface %s: %s", ifname, g_strerror (errno));
+        return 0;
+    }
+
+    if (!socket_open (self, &error)) {
+        mm_obj_dbg (self, "couldn't monitor interface %s: %s", ifname, error->message);
+        return 0;
+    }
+
+    watch = g_slice_new0 (Watch);
+    watch->id = ++self->next_id;
+    if (G_UNLIKELY (!watch->id))
+        watch->id = ++self->next_id;
+    watch->ifname = g_strdup (ifname);
+    watch->ifindex = ifindex;
+    /* Interfaces are watched while in use, so assume they're up */
+    watch->link_up = TRUE;
+    watch->callback = callback;
+    watch->user_data = user_data;
+    self->watches = g_list_prepend (self->watches, watch);
+
+    mm_obj_dbg (self, "monitoring link changes of interface %s", ifname);
+    return watch->id;
+}
+
+void
+mm_link_monitor_unwatch (MMLinkMonitor *self,
+                         guint          id)
+{
+    GList *l;
+
+    g_return_if_fail (MM_IS_LINK_MONITOR (self));
+
+    for (l = self->watches; l; l = g_list_next (l)) {
+        Watch *watch = l->data;
+
+        if (watch->id != id || watch->removed)
+            continue;
+
+        if (self->dispatching) {
+            watch->removed = TRUE;
+            return;
+        }
+
+        watch_free (watch);
+        self->watches = g_list_delete_link (self->watches, l);
+        if (!self->watches)
+            socket_close (self);
+        return;
+    }
+
+    g_warn_if_reached ();
+}
+
+/*****************************************************************************/
+
+static gchar *
+log_object_build_id (MMLogObject *_self)
+{
+    return g_strdup ("link-monitor");
+}
+
+/*****************************************************************************/
+
+static void
+mm_link_monitor_init (MMLinkMonitor *self)
+{
+    self->fd = -1;
+}
+
+static void
+finalize (GObject *object)
+{
+    MMLinkMonitor *self = MM_LINK_MONITOR (object);
+
+    socket_close (self);
+    g_list_free_full (self->watches, (GDestroyNotify) watch_free);
+
+    G_OBJECT_CLASS (mm_link_monitor_parent_class)->finalize (object);
+}
+
+static void
+log_object_iface_init (MMLogObjectInterface *iface)
+{
+    iface->build_id = log_object_build_id;
+}
+
+static void
+mm_link_monitor_class_init (MMLinkMonitorClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->finalize = finalize;
+}
+
+MM_DEFINE_SINGLETON_GETTER (MMLinkMonitor, mm_link_monitor_get, MM_TYPE_LINK_MONITOR)
@@ -0,0 +1,51 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_LINK_MONITOR_H
+#define MM_LINK_MONITOR_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+/* Listens to rtnetlink link notifications and reports lower layer (carrier)
+ * up/down transitions of the watched network interfaces. The netlink socket
+ * is only open while there are watches. */
+
+#define MM_TYPE_LINK_MONITOR            (mm_link_monitor_get_type ())
+#define MM_LINK_MONITOR(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_LINK_MONITOR, MMLinkMonitor))
+#define MM_LINK_MONITOR_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),  MM_TYPE_LINK_MONITOR, MMLinkMonitorClass))
+#define MM_IS_LINK_MONITOR(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_LINK_MONITOR))
+#define MM_IS_LINK_MONITOR_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  MM_TYPE_LINK_MONITOR))
+#define MM_LINK_MONITOR_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  MM_TYPE_LINK_MONITOR, MMLinkMonitorClass))
+
+typedef struct _MMLinkMonitor      MMLinkMonitor;
+typedef struct _MMLinkMonitorClass MMLinkMonitorClass;
+
+/* Called when the lower layer of the interface goes up or down, or when the
+ * interface is removed (reported as down). */
+typedef void (* MMLinkMonitorFunc) (const gchar *ifname,
+                                    gboolean     link_up,
+                                    gpointer     user_data);
+
+GType          mm_link_monitor_get_type (void);
+MMLinkMonitor *mm_link_monitor_get      (void);
+
+/* Returns 0 if link changes of the interface can't be monitored */
+guint          mm_link_monitor_watch    (MMLinkMonitor      *self,
+                                         const gchar        *ifname,
+                                         MMLinkMonitorFunc   callback,
+                                         gpointer            user_data);
+void           mm_link_monitor_unwatch  (MMLinkMonitor      *self,
+                                         guint               id);
+
+#endif /* MM_LINK_MONITOR_H */
@@ -26,6 +26,7 @@ static GQuark private_quark;
 typedef struct {
   gchar *owner_id;
   gchar *id;
+  MMLogRecorder *recorder;
 } Private;
 
 static void
@@ -33,6 +34,7 @@ private_free (Private *priv)
 {
     g_free (priv->owner_id);
     g_free (priv->id);
+    g_clear_pointer (&priv->recorder, mm_log_recorder_unref);
     g_slice_free (Private, priv);
 }
 
@@ -83,6 +85,32 @@ mm_log_object_set_owner_id (MMLogObject *self,
     priv->owner_id = g_strdup (owner_id);
 }
 
+void
+mm_log_object_set_owner (MMLogObject *self,
+                         MMLogObject *owner)
+{
+    mm_log_object_set_owner_id (self, mm_log_object_get_id (owner));
+    mm_log_object_set_recorder (self, mm_log_object_peek_recorder (owner));
+}
+
+void
+mm_log_object_set_recorder (MMLogObject   *self,
+                            MMLogRecorder *recorder)
+{
+    Private *priv;
+
+    priv = get_private (self);
+    g_clear_pointer (&priv->recorder, mm_log_recorder_unref);
+    if (recorder)
+        priv->recorder = mm_log_recorder_ref (recorder);
+}
+
+MMLogRecorder *
+mm_log_object_peek_recorder (MMLogObject *self)
+{
+    return get_private (self)->recorder;
+}
+
 static void
 mm_log_object_default_init (MMLogObjectInterface *iface)
 {
@@ -20,6 +20,7 @@
 #include <glib-object.h>
 
 #include "mm-log.h"
+#include "mm-log-recorder.h"
 
 #define MM_TYPE_LOG_OBJECT mm_log_object_get_type ()
 G_DECLARE_INTERFACE (MMLogObject, mm_log_object, MM, LOG_OBJECT, GObject)
@@ -35,4 +36,12 @@ const gchar *mm_log_object_get_id       (MMLogObject *self);
 void         mm_log_object_set_owner_id (MMLogObject *self,
                                          const gchar *owner_id);
 
+/* Records of the object are also kept in the given recorder. Objects
+ * inherit the recorder of their owner. */
+void           mm_log_object_set_owner     (MMLogObject   *self,
+                                            MMLogObject   *owner);
+void           mm_log_object_set_recorder  (MMLogObject   *self,
+                                            MMLogRecorder *recorder);
+MMLogRecorder *mm_log_object_peek_recorder (MMLogObject   *self);
+
 #endif /* MM_LOG_OBJECT_H */
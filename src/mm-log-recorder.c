@@ -0,0 +1,170 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include "mm-log-recorder.h"
+
+typedef struct {
+    /* Wall clock, in microseconds */
+    gint64     timestamp;
+    MMLogLevel level;
+    gchar      message[MM_LOG_RECORDER_MESSAGE_LEN + 1];
+} Record;
+
+struct _MMLogRecorder {
+    volatile gint  ref_count;
+    /* Records may come from any thread */
+    GMutex         mutex;
+    Record        *records;
+    guint          size;
+    /* Index of the oldest record */
+    guint          first;
+    guint          n;
+};
+
+#define RECORD_AT(self, i) (&(self)->records[((self)->first + (i)) % (self)->size])
+
+/*****************************************************************************/
+
+void
+mm_log_recorder_add (MMLogRecorder *self,
+                     MMLogLevel     level,
+                     const gchar   *object_id,
+                     const gchar   *module,
+                     const gchar   *fmt,
+                     va_list        args)
+{
+    Record *record;
+    gsize   len = 0;
+
+    g_mutex_lock (&self->mutex);
+
+    if (self->n < self->size) {
+        record = RECORD_AT (self, self->n);
+        self->n++;
+    } else {
+        /* Full, overwrite the oldest one */
+        record = RECORD_AT (self, 0);
+        self->first = (self->first + 1) % self->size;
+    }
+
+    record->timestamp = g_get_real_time ();
+    record->level = level;
+
+    if (object_id)
+        len = g_snprintf (record->message, sizeof (record->message), "[%s] ", object_id);
+    if (module && len < sizeof (record->message))
+        len += g_snprintf (record->message + len, sizeof (record->message) - len, "(%s) ", module);
+    if (len < sizeof (record->message))
+        g_vsnprintf (record->message + len, sizeof (record->message) - len, fmt, args);
+
+    g_mutex_unlock (&self->mutex);
+}
+
+guint
+mm_log_recorder_get_n_records (MMLogRecorder *self)
+{
+    guint n;
+
+    g_mutex_lock (&self->mutex);
+    n = self->n;
+    g_mutex_unlock (&self->mutex);
+    return n;
+}
+
+void
+mm_log_recorder_clear (MMLogRecorder *self)
+{
+    g_mutex_lock (&self->mutex);
+    self->first = 0;
+    self->n = 0;
+    g_mutex_unlock (&self->mutex);
+}
+
+/*****************************************************************************/
+
+static const gchar *
+level_description (MMLogLevel level)
+{
+    switch (level) {
+    case MM_LOG_LEVEL_DEBUG:
+        return "<debug>";
+    case MM_LOG_LEVEL_WARN:
+        return "<warn> ";
+    case MM_LOG_LEVEL_INFO:
+        return "<info> ";
+    case MM_LOG_LEVEL_ERR:
+        return "<error>";
+    default:
+        break;
+    }
+    g_assert_not_reached ();
+    return NULL;
+}
+
+gchar **
+mm_log_recorder_dump (MMLogRecorder *self)
+{
+    gchar **lines;
+    guint   i;
+
+    g_mutex_lock (&self->mutex);
+    lines = g_new0 (gchar *, self->n + 1);
+    for (i = 0; i < self->n; i++) {
+        const Record *record = RECORD_AT (self, i);
+
+        lines[i] = g_strdup_printf ("%s [%09" G_GINT64_FORMAT ".%06" G_GINT64_FORMAT "] %s",
+                                    level_description (record->level),
+                                    record->timestamp / G_USEC_PER_SEC,
+                                    record->timestamp % G_USEC_PER_SEC,
+                                    record->message);
+    }
+    g_mutex_unlock (&self->mutex);
+
+    return lines;
+}
+
+/*****************************************************************************/
+
+MMLogRecorder *
+mm_log_recorder_new (guint n_records)
+{
+    MMLogRecorder *self;
+
+    g_assert (n_records > 0);
+
+    self = g_slice_new0 (MMLogRecorder);
+    self->ref_count = 1;
+    g_mutex_init (&self->mutex);
+    self->size = n_records;
+    self->records = g_new (Record, n_records);
+    return self;
+}
+
+MMLogRecorder *
+mm_log_recorder_ref (MMLogRecorder *self)
+{
+    g_atomic_int_inc (&self->ref_count);
+    return self;
+}
+
+void
+mm_log_recorder_unref (MMLogRecorder *self)
+{
+    if (g_atomic_int_dec_and_test (&self->ref_count)) {
+        g_free (self->records);
+        g_mutex_clear (&self->mutex);
+        g_slice_free (MMLogRecorder, self);
+    }
+}
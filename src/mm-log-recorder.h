@@ -0,0 +1,49 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_LOG_RECORDER_H
+#define MM_LOG_RECORDER_H
+
+#include <stdarg.h>
+#include <glib.h>
+
+#include "mm-log.h"
+
+/* Fixed-size ring of the most recent log records of a modem, of any level,
+ * even if not enabled in the main log. Messages are formatted straight into
+ * fixed-size slots, longer ones get truncated. */
+
+typedef struct _MMLogRecorder MMLogRecorder;
+
+/* Maximum length of each message, including object id and module */
+#define MM_LOG_RECORDER_MESSAGE_LEN 255
+
+MMLogRecorder  *mm_log_recorder_new   (guint          n_records);
+MMLogRecorder  *mm_log_recorder_ref   (MMLogRecorder *self);
+void            mm_log_recorder_unref (MMLogRecorder *self);
+
+void            mm_log_recorder_add   (MMLogRecorder *self,
+                                       MMLogLevel     level,
+                                       const gchar   *object_id,
+                                       const gchar   *module,
+                                       const gchar   *fmt,
+                                       va_list        args) G_GNUC_PRINTF (5, 0);
+
+guint           mm_log_recorder_get_n_records (MMLogRecorder *self);
+void            mm_log_recorder_clear (MMLogRecorder *self);
+
+/* Records formatted as in the log file, with wall clock timestamps, oldest
+ * first */
+gchar         **mm_log_recorder_dump  (MMLogRecorder *self);
+
+#endif /* MM_LOG_RECORDER_H */
@@ -0,0 +1,153 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+#include <string.h>
+
+#include "mm-log-ring.h"
+
+/* A slot at index i is free for the producer claiming position 'pos' when its
+ * sequence is 'pos', and ready for the consumer once it's 'pos + 1'. After
+ * being consumed it becomes 'pos + n_slots', i.e. free for the next lap.
+ * Positions wrap around, so they're always compared as differences. */
+typedef struct {
+    gint         sequence;
+    gint         priority;
+    const gchar *loc;
+    const gchar *func;
+    gchar       *heap_message;
+    gsize        length;
+    gchar        message[MM_LOG_RING_INLINE_MESSAGE_LEN + 1];
+} Slot;
+
+struct _MMLogRing {
+    Slot  *slots;
+    guint  mask;
+    /* Shared by all producers */
+    gint   enqueue_pos;
+    /* Only used by the consumer */
+    guint  dequeue_pos;
+};
+
+/*****************************************************************************/
+
+gboolean
+mm_log_ring_push (MMLogRing   *self,
+                  gint         priority,
+                  const gchar *loc,
+                  const gchar *func,
+                  const gchar *message,
+                  gsize        length)
+{
+    Slot  *slot;
+    guint  pos;
+
+    pos = (guint) g_atomic_int_get (&self->enqueue_pos);
+    for (;;) {
+        gint diff;
+
+        slot = &self->slots[pos & self->mask];
+        diff = (gint) ((guint) g_atomic_int_get (&slot->sequence) - pos);
+        if (diff == 0) {
+            if (g_atomic_int_compare_and_exchange (&self->enqueue_pos, (gint) pos, (gint) (pos + 1)))
+                break;
+        } else if (diff < 0) {
+            /* Not yet consumed since the previous lap */
+            return FALSE;
+        }
+        /* Another producer got it first */
+        pos = (guint) g_atomic_int_get (&self->enqueue_pos);
+    }
+
+    slot->priority = priority;
+    slot->loc = loc;
+    slot->func = func;
+    slot->length = length;
+    if (length <= MM_LOG_RING_INLINE_MESSAGE_LEN) {
+        memcpy (slot->message, message, length);
+        slot->message[length] = '\0';
+    } else
+        slot->heap_message = g_strndup (message, length);
+
+    /* Publish; atomic operations are full barriers */
+    g_atomic_int_set (&slot->sequence, (gint) (pos + 1));
+    return TRUE;
+}
+
+guint
+mm_log_ring_peek (MMLogRing   *self,
+                  MMLogRecord *records,
+                  guint        max)
+{
+    guint n;
+
+    for (n = 0; n < max && n <= self->mask; n++) {
+        Slot  *slot;
+        guint  pos;
+
+        pos = self->dequeue_pos + n;
+        slot = &self->slots[pos & self->mask];
+        if ((guint) g_atomic_int_get (&slot->sequence) != pos + 1)
+            break;
+
+        records[n].priority = slot->priority;
+        records[n].loc = slot->loc;
+        records[n].func = slot->func;
+        records[n].message = slot->heap_message ? slot->heap_message : slot->message;
+        records[n].length = slot->length;
+    }
+    return n;
+}
+
+void
+mm_log_ring_release (MMLogRing *self,
+                     guint      n_records)
+{
+    while (n_records--) {
+        Slot *slot;
+
+        slot = &self->slots[self->dequeue_pos & self->mask];
+        g_clear_pointer (&slot->heap_message, g_free);
+        g_atomic_int_set (&slot->sequence, (gint) (self->dequeue_pos + self->mask + 1));
+        self->dequeue_pos++;
+    }
+}
+
+/*****************************************************************************/
+
+MMLogRing *
+mm_log_ring_new (guint n_slots)
+{
+    MMLogRing *self;
+    guint      i;
+
+    g_assert (n_slots > 1 && (n_slots & (n_slots - 1)) == 0);
+
+    self = g_slice_new0 (MMLogRing);
+    self->slots = g_new0 (Slot, n_slots);
+    self->mask = n_slots - 1;
+    for (i = 0; i < n_slots; i++)
+        self->slots[i].sequence = (gint) i;
+    return self;
+}
+
+void
+mm_log_ring_free (MMLogRing *self)
+{
+    guint i;
+
+    for (i = 0; i <= self->mask; i++)
+        g_free (self->slots[i].heap_message);
+    g_free (self->slots);
+    g_slice_free (MMLogRing, self);
+}
@@ -0,0 +1,59 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_LOG_RING_H
+#define MM_LOG_RING_H
+
+#include <glib.h>
+
+/* Bounded queue of formatted log records, with any number of producer
+ * threads and a single consumer. Pushing and consuming never take a lock:
+ * each slot carries a sequence number telling whether it's free or ready. */
+
+typedef struct _MMLogRing MMLogRing;
+
+/* Messages up to this length are copied into the slot itself, longer ones
+ * are duplicated in the heap */
+#define MM_LOG_RING_INLINE_MESSAGE_LEN 248
+
+typedef struct {
+    gint         priority;
+    /* Static strings (G_STRLOC, G_STRFUNC), may be NULL */
+    const gchar *loc;
+    const gchar *func;
+    /* Owned by the ring until released */
+    const gchar *message;
+    gsize        length;
+} MMLogRecord;
+
+/* @n_slots must be a power of two */
+MMLogRing *mm_log_ring_new      (guint        n_slots);
+void       mm_log_ring_free     (MMLogRing   *self);
+
+/* Producers; returns FALSE without copying anything if the ring is full */
+gboolean   mm_log_ring_push     (MMLogRing   *self,
+                                 gint         priority,
+                                 const gchar *loc,
+                                 const gchar *func,
+                                 const gchar *message,
+                                 gsize        length);
+
+/* Consumer; fills up to @max records, oldest first, which stay valid until
+ * mm_log_ring_release() is called for them */
+guint      mm_log_ring_peek     (MMLogRing   *self,
+                                 MMLogRecord *records,
+                                 guint        max);
+void       mm_log_ring_release  (MMLogRing   *self,
+                                 guint        n_records);
+
+#endif /* MM_LOG_RING_H */
@@ -24,6 +24,7 @@
 #include <sys/stat.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/uio.h>
 
 #include <ModemManager.h>
 #include <mm-errors-types.h>
@@ -43,6 +44,7 @@
 
 #include "mm-log.h"
 #include "mm-log-object.h"
+#include "mm-log-ring.h"
 
 enum {
     TS_FLAG_NONE = 0,
@@ -62,6 +64,30 @@ static void (*log_backend) (const char *loc,
                             const char *message,
                             size_t length);
 
+/* Writes several records at once, used by the async writer thread */
+static void (*log_backend_batch) (const MMLogRecord *records,
+                                  guint n_records);
+
+/* Async mode: callers push formatted records into a ring, a writer thread
+ * empties it into the backend */
+#define ASYNC_RING_SLOTS 4096
+#define ASYNC_BATCH_MAX  64
+
+/* The ring is published with atomic operations, as producers run in any
+ * thread; it's only freed once no push is in progress. The writer thread
+ * is only handled from the main thread. */
+static MMLogRing *async_ring;
+static gint async_n_pushing;
+static GThread *async_writer;
+static GMutex async_mutex;
+static GCond async_cond;
+static gint async_writer_sleeping;
+static gboolean async_writer_quit;
+static MMLogAsyncDropPolicy async_drop_policy = MM_LOG_ASYNC_DROP_POLICY_DEBUG;
+/* Dropped since the last report, and in total */
+static gint async_n_dropped;
+static guint64 async_n_dropped_total;
+
 typedef struct {
     guint32 num;
     const char *name;
@@ -75,8 +101,28 @@ static const LogDesc level_descs[] = {
     { 0, NULL }
 };
 
-static GString *msgbuf = NULL;
-static volatile gsize msgbuf_once = 0;
+/* Messages are formatted in a per-thread buffer */
+static void
+msgbuf_free (GString *msgbuf)
+{
+    g_string_free (msgbuf, TRUE);
+}
+
+static GPrivate msgbuf_private = G_PRIVATE_INIT ((GDestroyNotify) msgbuf_free);
+
+static GString *
+get_msgbuf (void)
+{
+    GString *msgbuf;
+
+    msgbuf = g_private_get (&msgbuf_private);
+    if (!msgbuf) {
+        msgbuf = g_string_sized_new (512);
+        g_private_set (&msgbuf_private, msgbuf);
+    } else
+        g_string_truncate (msgbuf, 0);
+    return msgbuf;
+}
 
 static int
 mm_to_syslog_priority (MMLogLevel level)
@@ -154,6 +200,25 @@ log_backend_file (const char *loc,
     fsync (logfd);  /* Make sure output is dumped to disk immediately  */
 }
 
+static void
+log_backend_file_batch (const MMLogRecord *records,
+                        guint n_records)
+{
+    struct iovec iov[ASYNC_BATCH_MAX];
+    guint i;
+    ssize_t ign;
+
+    g_assert (n_records <= G_N_ELEMENTS (iov));
+    for (i = 0; i < n_records; i++) {
+        iov[i].iov_base = (void *) records[i].message;
+        iov[i].iov_len = records[i].length;
+    }
+    ign = writev (logfd, iov, n_records);
+    if (ign) {} /* whatever; really shut up about unused result */
+
+    fsync (logfd);  /* Once per batch */
+}
+
 static void
 log_backend_syslog (const char *loc,
                     const char *func,
@@ -164,7 +229,35 @@ log_backend_syslog (const char *loc,
     syslog (syslog_level, "%s", message);
 }
 
+static void
+log_backend_syslog_batch (const MMLogRecord *records,
+                          guint n_records)
+{
+    guint i;
+
+    for (i = 0; i < n_records; i++)
+        syslog (records[i].priority, "%s", records[i].message);
+}
+
 #if defined WITH_SYSTEMD_JOURNAL
+static const char *
+split_loc (const char *loc,
+           size_t *file_length)
+{
+    const char *line;
+
+    line = strstr (loc, ":");
+    if (line) {
+        *file_length = line - loc;
+        line++;
+    } else {
+        /* This is not supposed to happen but we must be prepared for this */
+        line = loc;
+        *file_length = 0;
+    }
+    return line;
+}
+
 static void
 log_backend_systemd_journal (const char *loc,
                              const char *func,
@@ -182,16 +275,7 @@ log_backend_systemd_journal (const char *loc,
         return;
     }
 
-    line = strstr (loc, ":");
-    if (line) {
-        file_length = line - loc;
-        line++;
-    } else {
-        /* This is not supposed to happen but we must be prepared for this */
-        line = loc;
-        file_length = 0;
-    }
-
+    line = split_loc (loc, &file_length);
     sd_journal_send ("MESSAGE=%s", message,
                      "PRIORITY=%d", syslog_level,
                      "CODE_FUNC=%s", func,
@@ -199,28 +283,196 @@ log_backend_systemd_journal (const char *loc,
                      "CODE_LINE=%s", line,
                      NULL);
 }
+
+static void
+log_backend_systemd_journal_batch (const MMLogRecord *records,
+                                   guint n_records)
+{
+    GString *fields;
+    guint i;
+
+    /* Fields are built one after the other in a single buffer, and only
+     * referenced from the iovecs once complete, as the buffer may move */
+    fields = g_string_sized_new (1024);
+    for (i = 0; i < n_records; i++) {
+        struct iovec iov[5];
+        gsize offsets[G_N_ELEMENTS (iov) + 1];
+        guint n_fields = 0;
+        guint j;
+
+        g_string_truncate (fields, 0);
+
+        offsets[n_fields++] = fields->len;
+        g_string_append (fields, "MESSAGE=");
+        g_string_append_len (fields, records[i].message, records[i].length);
+        offsets[n_fields++] = fields->len;
+        g_string_append_printf (fields, "PRIORITY=%d", records[i].priority);
+
+        if (records[i].loc) {
+            const char *line;
+            size_t file_length;
+
+            line = split_loc (records[i].loc, &file_length);
+            offsets[n_fields++] = fields->len;
+            g_string_append_printf (fields, "CODE_FUNC=%s", records[i].func);
+            offsets[n_fields++] = fields->len;
+            g_string_append_printf (fields, "CODE_FILE=%.*s", (int) file_length, records[i].loc);
+            offsets[n_fields++] = fields->len;
+            g_string_append_printf (fields, "CODE_LINE=%s", line);
+        }
+        offsets[n_fields] = fields->len;
+
+        for (j = 0; j < n_fields; j++) {
+            iov[j].iov_base = fields->str + offsets[j];
+            iov[j].iov_len = offsets[j + 1] - offsets[j];
+        }
+        sd_journal_sendv (iov, n_fields);
+    }
+    g_string_free (fields, TRUE);
+}
 #endif
 
-void
-_mm_log (gpointer     obj,
-         const gchar *module,
-         const gchar *loc,
-         const gchar *func,
-         MMLogLevel   level,
-         const gchar *fmt,
-         ...)
+/*****************************************************************************/
+/* Async writer */
+
+static void
+async_wake_writer (void)
 {
-    va_list args;
-    GTimeVal tv;
+    /* The writer flags itself as sleeping before checking the ring for the
+     * last time, and the mutex is held until it's waiting on the condition */
+    if (g_atomic_int_get (&async_writer_sleeping)) {
+        g_mutex_lock (&async_mutex);
+        g_cond_signal (&async_cond);
+        g_mutex_unlock (&async_mutex);
+    }
+}
 
-    if (!(log_level & level))
+/* Returns FALSE if async mode isn't running, so that the caller writes the
+ * message itself. Dropped messages are reported as handled. */
+static gboolean
+async_push (MMLogLevel level,
+            const char *loc,
+            const char *func,
+            int syslog_level,
+            const char *message,
+            size_t length)
+{
+    MMLogRing *ring;
+
+    /* Flag the push before looking at the ring, so that async_stop() either
+     * sees it in progress or has already unpublished the ring */
+    g_atomic_int_inc (&async_n_pushing);
+    ring = g_atomic_pointer_get (&async_ring);
+    if (!ring)
+        goto out;
+
+    while (!mm_log_ring_push (ring, syslog_level, loc, func, message, length)) {
+        if (async_drop_policy == MM_LOG_ASYNC_DROP_POLICY_ALL ||
+            (async_drop_policy == MM_LOG_ASYNC_DROP_POLICY_DEBUG && level == MM_LOG_LEVEL_DEBUG)) {
+            g_atomic_int_inc (&async_n_dropped);
+            goto out;
+        }
+        /* Wait for the writer to make room */
+        async_wake_writer ();
+        g_thread_yield ();
+    }
+    async_wake_writer ();
+
+out:
+    g_atomic_int_add (&async_n_pushing, -1);
+    return !!ring;
+}
+
+static void log_format_prefix (GString *msgbuf, MMLogLevel level);
+
+static void
+async_report_dropped (void)
+{
+    GString *msgbuf;
+    gint n_dropped;
+
+    n_dropped = g_atomic_int_get (&async_n_dropped);
+    if (!n_dropped)
         return;
+    g_atomic_int_add (&async_n_dropped, -n_dropped);
+    async_n_dropped_total += n_dropped;
+
+    msgbuf = get_msgbuf ();
+    log_format_prefix (msgbuf, MM_LOG_LEVEL_WARN);
+    g_string_append_printf (msgbuf, "%d log messages dropped (%" G_GUINT64_FORMAT " in total)\n",
+                            n_dropped, async_n_dropped_total);
+    log_backend (NULL, NULL, LOG_WARNING, msgbuf->str, msgbuf->len);
+}
 
-    if (g_once_init_enter (&msgbuf_once)) {
-        msgbuf = g_string_sized_new (512);
-        g_once_init_leave (&msgbuf_once, 1);
-    } else
-        g_string_truncate (msgbuf, 0);
+static gpointer
+async_writer_thread (MMLogRing *ring)
+{
+    MMLogRecord records[ASYNC_BATCH_MAX];
+    gboolean quit = FALSE;
+
+    for (;;) {
+        guint n_records;
+
+        n_records = mm_log_ring_peek (ring, records, G_N_ELEMENTS (records));
+        if (n_records) {
+            log_backend_batch (records, n_records);
+            mm_log_ring_release (ring, n_records);
+            async_report_dropped ();
+            continue;
+        }
+
+        /* Only exit once everything pushed before the request is written */
+        if (quit)
+            break;
+
+        g_mutex_lock (&async_mutex);
+        g_atomic_int_set (&async_writer_sleeping, TRUE);
+        while (!async_writer_quit && !mm_log_ring_peek (ring, records, 1))
+            g_cond_wait (&async_cond, &async_mutex);
+        g_atomic_int_set (&async_writer_sleeping, FALSE);
+        quit = async_writer_quit;
+        g_mutex_unlock (&async_mutex);
+    }
+
+    async_report_dropped ();
+    return NULL;
+}
+
+static void
+async_stop (void)
+{
+    MMLogRing *ring;
+
+    if (!async_writer)
+        return;
+
+    /* New messages are written right away from now on; wait for the pushes
+     * already in progress, which may still be using the ring. The writer keeps
+     * running meanwhile, so blocked pushes get room. */
+    ring = g_atomic_pointer_get (&async_ring);
+    g_atomic_pointer_set (&async_ring, NULL);
+    while (g_atomic_int_get (&async_n_pushing))
+        g_thread_yield ();
+
+    g_mutex_lock (&async_mutex);
+    async_writer_quit = TRUE;
+    g_cond_signal (&async_cond);
+    g_mutex_unlock (&async_mutex);
+
+    g_thread_join (async_writer);
+    async_writer = NULL;
+    async_writer_quit = FALSE;
+
+    mm_log_ring_free (ring);
+}
+
+/*****************************************************************************/
+
+static void
+log_format_prefix (GString *msgbuf,
+                   MMLogLevel level)
+{
+    GTimeVal tv;
 
     if (append_log_level_text)
         g_string_append_printf (msgbuf, "%s ", log_level_description (level));
@@ -242,6 +494,33 @@ _mm_log (gpointer     obj,
 
         g_string_append_printf (msgbuf, "[%06ld.%06ld] ", secs, usecs);
     }
+}
+
+void
+_mm_log (gpointer     obj,
+         const gchar *module,
+         const gchar *loc,
+         const gchar *func,
+         MMLogLevel   level,
+         const gchar *fmt,
+         ...)
+{
+    va_list args;
+    GString *msgbuf;
+    MMLogRecorder *recorder;
+
+    /* Per-modem recorders keep records of all levels */
+    if (obj && (recorder = mm_log_object_peek_recorder (MM_LOG_OBJECT (obj))) != NULL) {
+        va_start (args, fmt);
+        mm_log_recorder_add (recorder, level, mm_log_object_get_id (MM_LOG_OBJECT (obj)), module, fmt, args);
+        va_end (args);
+    }
+
+    if (!(log_level & level))
+        return;
+
+    msgbuf = get_msgbuf ();
+    log_format_prefix (msgbuf, level);
 
 #if defined MM_LOG_FUNC_LOC
     g_string_append_printf (msgbuf, "[%s] %s(): ", loc, func);
@@ -258,7 +537,8 @@ _mm_log (gpointer     obj,
 
     g_string_append_c (msgbuf, '\n');
 
-    log_backend (loc, func, mm_to_syslog_priority (level), msgbuf->str, msgbuf->len);
+    if (!async_push (level, loc, func, mm_to_syslog_priority (level), msgbuf->str, msgbuf->len))
+        log_backend (loc, func, mm_to_syslog_priority (level), msgbuf->str, msgbuf->len);
 }
 
 static void
@@ -267,7 +547,12 @@ log_handler (const gchar *log_domain,
              const gchar *message,
              gpointer ignored)
 {
-    log_backend (NULL, NULL, glib_to_syslog_priority (level), message, strlen (message));
+    /* Fatal messages are written right away, as the process is aborted
+     * before the writer thread would get to them */
+    if ((level & (G_LOG_FLAG_FATAL | G_LOG_LEVEL_ERROR)) ||
+        !async_push ((level & G_LOG_LEVEL_DEBUG) ? MM_LOG_LEVEL_DEBUG : MM_LOG_LEVEL_WARN,
+                     NULL, NULL, glib_to_syslog_priority (level & G_LOG_LEVEL_MASK), message, strlen (message)))
+        log_backend (NULL, NULL, glib_to_syslog_priority (level & G_LOG_LEVEL_MASK), message, strlen (message));
 }
 
 gboolean
@@ -322,12 +607,14 @@ mm_log_setup (const char *level,
 #if defined WITH_SYSTEMD_JOURNAL
     if (log_journal) {
         log_backend = log_backend_systemd_journal;
+        log_backend_batch = log_backend_systemd_journal_batch;
         append_log_level_text = FALSE;
     } else
 #endif
     if (log_file == NULL) {
         openlog (G_LOG_DOMAIN, LOG_CONS | LOG_PID, LOG_DAEMON);
         log_backend = log_backend_syslog;
+        log_backend_batch = log_backend_syslog_batch;
     } else {
         logfd = open (log_file,
                       O_CREAT | O_APPEND | O_WRONLY,
@@ -339,6 +626,7 @@ mm_log_setup (const char *level,
             return FALSE;
         }
         log_backend = log_backend_file;
+        log_backend_batch = log_backend_file_batch;
     }
 
     g_log_set_handler (G_LOG_DOMAIN,
@@ -363,9 +651,40 @@ mm_log_setup (const char *level,
     return TRUE;
 }
 
+gboolean
+mm_log_setup_async (const char *drop_policy,
+                    GError **error)
+{
+    MMLogRing *ring;
+
+    if (!drop_policy || !strcasecmp (drop_policy, "debug"))
+        async_drop_policy = MM_LOG_ASYNC_DROP_POLICY_DEBUG;
+    else if (!strcasecmp (drop_policy, "all"))
+        async_drop_policy = MM_LOG_ASYNC_DROP_POLICY_ALL;
+    else if (!strcasecmp (drop_policy, "none"))
+        async_drop_policy = MM_LOG_ASYNC_DROP_POLICY_NONE;
+    else {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS,
+                     "Unknown log drop policy '%s'", drop_policy);
+        return FALSE;
+    }
+
+    if (async_writer)
+        return TRUE;
+
+    g_assert (log_backend_batch);
+    ring = mm_log_ring_new (ASYNC_RING_SLOTS);
+    async_writer = g_thread_new ("mm-log", (GThreadFunc) async_writer_thread, ring);
+    g_atomic_pointer_set (&async_ring, ring);
+    return TRUE;
+}
+
 void
 mm_log_shutdown (void)
 {
+    /* Flush pending records before closing the backend */
+    async_stop ();
+
     if (logfd < 0)
         closelog ();
     else {
@@ -62,6 +62,19 @@ gboolean mm_log_setup (const char *level,
                        gboolean rel_ts,
                        GError **error);
 
+/* Which records may be dropped in async mode when the writer thread can't
+ * keep up; the rest make the caller wait */
+typedef enum {
+    MM_LOG_ASYNC_DROP_POLICY_DEBUG,
+    MM_LOG_ASYNC_DROP_POLICY_ALL,
+    MM_LOG_ASYNC_DROP_POLICY_NONE,
+} MMLogAsyncDropPolicy;
+
+/* Moves backend I/O to a writer thread; must be called after mm_log_setup().
+ * @drop_policy is one of "debug" (default), "all" or "none". */
+gboolean mm_log_setup_async (const char *drop_policy,
+                             GError **error);
+
 void mm_log_shutdown (void);
 
 #endif  /* MM_LOG_H */
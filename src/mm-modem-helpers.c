@@ -3007,6 +3007,82 @@ end:
     return ret;
 }
 
+#define CPMS_QUERY_USED_REGEX "\\+CPMS:\\s*\"[^\"]*\"\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)"
+
+gboolean
+mm_3gpp_parse_cpms_query_used (const gchar *reply,
+                               guint *memr_used,
+                               GError **error)
+{
+    GRegex *r;
+    GMatchInfo *match_info = NULL;
+    gboolean ret = FALSE;
+
+    r = g_regex_new (CPMS_QUERY_USED_REGEX, G_REGEX_RAW, 0, NULL);
+    g_assert (r);
+
+    if (!g_regex_match (r, reply, 0, &match_info) ||
+        !mm_get_uint_from_match_info (match_info, 1, memr_used)) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Could not parse used messages in CPMS query reply '%s'", reply);
+        goto end;
+    }
+
+    ret = TRUE;
+
+end:
+    g_match_info_free (match_info);
+    g_regex_unref (r);
+
+    return ret;
+}
+
+GArray *
+mm_3gpp_parse_cmgd_test_response (const gchar  *reply,
+                                  GError      **error)
+{
+    gchar  **split;
+    gchar   *str;
+    gchar   *dst;
+    GArray  *array = NULL;
+    GError  *inner_error = NULL;
+
+    /*
+     * AT+CMGD=?
+     *  +CMGD: (1,3,4),(0-4)
+     *
+     * AT+CMGD=?
+     *  +CMGD: (),(0-4)
+     */
+    split = mm_split_string_groups (mm_strip_tag (reply, "+CMGD:"));
+    if (!split) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Couldn't split +CMGD test response in groups");
+        return NULL;
+    }
+
+    /* Spaces between list items aren't supported by the list parser */
+    for (str = dst = split[0]; *str; str++) {
+        if (*str != ' ')
+            *dst++ = *str;
+    }
+    *dst = '\0';
+
+    /* An empty index list means an empty storage */
+    if (!split[0][0])
+        array = g_array_new (FALSE, FALSE, sizeof (guint));
+    else
+        array = mm_parse_uint_list (split[0], &inner_error);
+    g_strfreev (split);
+
+    if (inner_error) {
+        g_propagate_error (error, inner_error);
+        return NULL;
+    }
+
+    return array;
+}
+
 gboolean
 mm_3gpp_get_cpms_storage_match (GMatchInfo *match_info,
                                 const gchar *match_name,
@@ -3896,6 +3972,59 @@ mm_3gpp_parse_pdu_cmgl_response (const gchar *str,
     return list;
 }
 
+gboolean
+mm_3gpp_parse_pdu_cmgl_header (const gchar *line,
+                               gint        *out_index,
+                               gint        *out_status)
+{
+    const gchar *p;
+    gchar       *end = NULL;
+    glong        index;
+    glong        status;
+
+    /*
+     * +CMGL: <index>, <status>, [<alpha>], <length>
+     *   or
+     * +CMGL: <index>, <status>, <length>
+     *
+     * We just read <index> and <stat>.
+     */
+    if (!g_str_has_prefix (line, "+CMGL:"))
+        return FALSE;
+
+    p = line + strlen ("+CMGL:");
+    while (g_ascii_isspace (*p))
+        p++;
+    if (!g_ascii_isdigit (*p))
+        return FALSE;
+    index = strtol (p, &end, 10);
+
+    p = end;
+    while (g_ascii_isspace (*p))
+        p++;
+    if (*p != ',')
+        return FALSE;
+    p++;
+    while (g_ascii_isspace (*p))
+        p++;
+    if (!g_ascii_isdigit (*p))
+        return FALSE;
+    status = strtol (p, &end, 10);
+
+    p = end;
+    while (g_ascii_isspace (*p))
+        p++;
+    if (*p != ',')
+        return FALSE;
+
+    if (index > G_MAXINT || status > G_MAXINT)
+        return FALSE;
+
+    *out_index = (gint) index;
+    *out_status = (gint) status;
+    return TRUE;
+}
+
 /*************************************************************************/
 
 /* Map two letter facility codes into flag values. There are
@@ -5112,3 +5241,139 @@ out:
     g_strfreev (split);
     return valid;
 }
+
+/*****************************************************************************/
+/* /proc/net/dev parser */
+
+/* Number of receive counters before the transmitted bytes */
+#define PROC_NET_DEV_N_RX_FIELDS 8
+
+gboolean
+mm_parse_proc_net_dev (const gchar  *contents,
+                       const gchar  *ifname,
+                       guint64      *out_rx_bytes,
+                       guint64      *out_tx_bytes,
+                       GError      **error)
+{
+    gchar    **lines;
+    gboolean   found = FALSE;
+    guint      i;
+
+    g_assert (contents);
+    g_assert (ifname);
+
+    /* Lines look like "  wwan0: <8 rx counters> <8 tx counters>", where the
+     * first counter of each block is the number of bytes. The two header
+     * lines never match an interface name followed by a colon. */
+    lines = g_strsplit (contents, "\n", -1);
+    for (i = 0; lines[i] && !found; i++) {
+        gchar   *colon;
+        gchar  **fields;
+        guint64  rx_bytes = 0;
+        guint64  tx_bytes = 0;
+        guint    n_fields = 0;
+        guint    j;
+
+        colon = strchr (lines[i], ':');
+        if (!colon)
+            continue;
+        *colon = '\0';
+        if (!g_str_equal (g_strstrip (lines[i]), ifname))
+            continue;
+
+        /* Counters are separated by one or more spaces */
+        fields = g_strsplit (colon + 1, " ", -1);
+        for (j = 0; fields[j]; j++) {
+            if (!fields[j][0])
+                continue;
+            if (n_fields == 0 && !mm_get_u64_from_str (fields[j], &rx_bytes))
+                break;
+            if (n_fields == PROC_NET_DEV_N_RX_FIELDS) {
+                found = mm_get_u64_from_str (fields[j], &tx_bytes);
+                break;
+            }
+            n_fields++;
+        }
+        g_strfreev (fields);
+
+        if (found) {
+            if (out_rx_bytes)
+                *out_rx_bytes = rx_bytes;
+            if (out_tx_bytes)
+                *out_tx_bytes = tx_bytes;
+        }
+        break;
+    }
+    g_strfreev (lines);
+
+    if (!found)
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_NOT_FOUND,
+                     "No valid counters found for interface '%s'", ifname);
+    return found;
+}
+
+/*****************************************************************************/
+
+void
+mm_signal_check_interval_reset (MMSignalCheckInterval *self,
+                                guint                  interval)
+{
+    self->interval = interval;
+    self->n_changed = 0;
+    self->n_stable = 0;
+}
+
+void
+mm_signal_check_interval_report (MMSignalCheckInterval *self,
+                                 guint                  signal_quality)
+{
+    self->signal_quality = signal_quality;
+}
+
+guint
+mm_signal_check_interval_update (MMSignalCheckInterval   *self,
+                                 gboolean                 signal_quality_loaded,
+                                 guint                    signal_quality,
+                                 gboolean                 access_technologies_loaded,
+                                 MMModemAccessTechnology  access_technologies,
+                                 gboolean                 connecting,
+                                 guint                    fast_interval,
+                                 guint                    max_interval)
+{
+    gboolean changed = FALSE;
+
+    /* Compared against the last reference value, not the last sample, so
+     * that a slow drift is eventually detected as well */
+    if (signal_quality_loaded &&
+        ABS ((gint) signal_quality - (gint) self->signal_quality) >= MM_SIGNAL_CHECK_MIN_DELTA) {
+        self->signal_quality = signal_quality;
+        changed = TRUE;
+    }
+    if (access_technologies_loaded && access_technologies != self->access_technologies) {
+        self->access_technologies = access_technologies;
+        changed = TRUE;
+    }
+
+    if (changed) {
+        self->n_stable = 0;
+        self->n_changed++;
+    } else {
+        self->n_changed = 0;
+        self->n_stable++;
+    }
+
+    /* A connection attempt needs fresh values right away */
+    if (connecting) {
+        self->n_stable = 0;
+        self->interval = fast_interval;
+    } else if (self->n_changed >= MM_SIGNAL_CHECK_CHANGED_SAMPLES) {
+        self->n_changed = 0;
+        self->interval = fast_interval;
+    } else if (self->n_stable >= MM_SIGNAL_CHECK_STABLE_SAMPLES) {
+        self->n_stable = 0;
+        self->interval = MIN (self->interval * 2, max_interval);
+    }
+
+    self->interval = MIN (self->interval, max_interval);
+    return self->interval;
+}
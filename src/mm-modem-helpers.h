@@ -243,6 +243,14 @@ gboolean mm_3gpp_parse_cpms_query_response (const gchar *reply,
                                             MMSmsStorage *mem1,
                                             MMSmsStorage *mem2,
                                             GError** error);
+/* AT+CPMS? number of messages currently in <mem1> */
+gboolean mm_3gpp_parse_cpms_query_used (const gchar *reply,
+                                        guint *memr_used,
+                                        GError **error);
+/* AT+CMGD=? list of <index>s reported, usually those in use in <mem1>.
+ * Returns a GArray of guints, sorted */
+GArray *mm_3gpp_parse_cmgd_test_response (const gchar  *reply,
+                                          GError      **error);
 gboolean mm_3gpp_get_cpms_storage_match (GMatchInfo *match_info,
                                          const gchar *match_name,
                                          MMSmsStorage *storage,
@@ -354,6 +362,11 @@ void   mm_3gpp_pdu_info_list_free      (GList *info_list);
 GList *mm_3gpp_parse_pdu_cmgl_response (const gchar *str,
                                         GError **error);
 
+/* Single +CMGL header line parser, used when processing the list as it arrives */
+gboolean mm_3gpp_parse_pdu_cmgl_header (const gchar *line,
+                                        gint        *out_index,
+                                        gint        *out_status);
+
 /* AT+CMGR (Read message) response parser */
 MM3gppPduInfo *mm_3gpp_parse_cmgr_read_response (const gchar *reply,
                                                  guint index,
@@ -518,6 +531,48 @@ gboolean mm_parse_supl_address (const gchar  *supl,
                                 guint16      *out_port,
                                 GError      **error);
 
+/* /proc/net/dev parser, gets the byte counters of a given interface */
+gboolean mm_parse_proc_net_dev (const gchar  *contents,
+                                const gchar  *ifname,
+                                guint64      *out_rx_bytes,
+                                guint64      *out_tx_bytes,
+                                GError      **error);
+
+/*****************************************************************************/
+/* Adaptive interval of the periodic signal quality and access technology
+ * checks. Signal quality changes below MM_SIGNAL_CHECK_MIN_DELTA (percent)
+ * are ignored; the interval only drops to the fast one after
+ * MM_SIGNAL_CHECK_CHANGED_SAMPLES consecutive changes, and is only doubled
+ * after MM_SIGNAL_CHECK_STABLE_SAMPLES consecutive stable samples. */
+
+#define MM_SIGNAL_CHECK_MIN_DELTA       5
+#define MM_SIGNAL_CHECK_CHANGED_SAMPLES 2
+#define MM_SIGNAL_CHECK_STABLE_SAMPLES  3
+
+typedef struct {
+    guint                   interval;
+    /* Reference values, only updated on significant changes */
+    guint                   signal_quality;
+    MMModemAccessTechnology access_technologies;
+    guint                   n_changed;
+    guint                   n_stable;
+} MMSignalCheckInterval;
+
+void  mm_signal_check_interval_reset  (MMSignalCheckInterval   *self,
+                                       guint                    interval);
+/* Known values, e.g. from unsolicited updates, which don't count as changes */
+void  mm_signal_check_interval_report (MMSignalCheckInterval   *self,
+                                       guint                    signal_quality);
+/* Accounts a new sample, returns the interval to use for the next check */
+guint mm_signal_check_interval_update (MMSignalCheckInterval   *self,
+                                       gboolean                 signal_quality_loaded,
+                                       guint                    signal_quality,
+                                       gboolean                 access_technologies_loaded,
+                                       MMModemAccessTechnology  access_technologies,
+                                       gboolean                 connecting,
+                                       guint                    fast_interval,
+                                       guint                    max_interval);
+
 /*****************************************************************************/
 
 /* Useful when clamp-ing an unsigned integer with implicit low limit set to 0,
@@ -0,0 +1,272 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-context.h"
+#include "mm-log-object.h"
+#include "mm-modem-helpers.h"
+#include "mm-utils.h"
+#include "mm-netdev-stats.h"
+
+#define PROC_NET_DEV_PATH "/proc/net/dev"
+
+#define REFRESH_DEFAULT_MS 30000
+#define REFRESH_MIN_MS     100
+
+typedef struct {
+    guint              id;
+    gchar             *ifname;
+    MMNetdevStatsFunc  callback;
+    gpointer           user_data;
+    /* Unwatched while dispatching */
+    gboolean           removed;
+} Watch;
+
+struct _MMNetdevStats {
+    GObject   parent;
+    GList    *watches;
+    guint     next_id;
+    guint     refresh;
+    guint     timeout_id;
+    gboolean  dispatching;
+};
+
+struct _MMNetdevStatsClass {
+    GObjectClass parent;
+};
+
+static void log_object_iface_init (MMLogObjectInterface *iface);
+
+G_DEFINE_TYPE_EXTENDED (MMNetdevStats, mm_netdev_stats, G_TYPE_OBJECT, 0,
+                        G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
+
+/*****************************************************************************/
+
+static void
+watch_free (Watch *watch)
+{
+    g_free (watch->ifname);
+    g_slice_free (Watch, watch);
+}
+
+static gchar *
+load_proc_net_dev (GError **error)
+{
+    gchar *contents = NULL;
+
+    if (!g_file_get_contents (PROC_NET_DEV_PATH, &contents, NULL, error))
+        return NULL;
+    return contents;
+}
+
+gboolean
+mm_netdev_stats_read (MMNetdevStats  *self,
+                      const gchar    *ifname,
+                      guint64        *out_rx_bytes,
+                      guint64        *out_tx_bytes,
+                      GError        **error)
+{
+    g_autofree gchar *contents = NULL;
+
+    g_return_val_if_fail (MM_IS_NETDEV_STATS (self), FALSE);
+
+    contents = load_proc_net_dev (error);
+    if (!contents)
+        return FALSE;
+    return mm_parse_proc_net_dev (contents, ifname, out_rx_bytes, out_tx_bytes, error);
+}
+
+/*****************************************************************************/
+
+static void schedule_refresh (MMNetdevStats *self);
+
+static gboolean
+refresh_cb (MMNetdevStats *self)
+{
+    g_autoptr(GError)  error = NULL;
+    g_autofree gchar  *contents = NULL;
+    GList             *l;
+
+    /* One single read for all the watched interfaces */
+    contents = load_proc_net_dev (&error);
+    if (!contents) {
+        mm_obj_dbg (self, "couldn't read interface counters: %s", error->message);
+        return G_SOURCE_CONTINUE;
+    }
+
+    /* Callbacks may add or remove watches; new ones are prepended so they're
+     * not reached in this loop, removed ones are flagged and freed below */
+    self->dispatching = TRUE;
+    for (l = self->watches; l; l = g_list_next (l)) {
+        Watch   *watch = l->data;
+        guint64  rx_bytes = 0;
+        guint64  tx_bytes = 0;
+
+        if (watch->removed)
+            continue;
+        if (!mm_parse_proc_net_dev (contents, watch->ifname, &rx_bytes, &tx_bytes, NULL))
+            continue;
+        watch->callback (watch->ifname, rx_bytes, tx_bytes, watch->user_data);
+    }
+    self->dispatching = FALSE;
+
+    for (l = self->watches; l; ) {
+        GList *next = g_list_next (l);
+
+        if (((Watch *) l->data)->removed) {
+            watch_free (l->data);
+            self->watches = g_list_delete_link (self->watches, l);
+        }
+        l = next;
+    }
+
+    if (!self->watches) {
+        self->timeout_id = 0;
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+schedule_refresh (MMNetdevStats *self)
+{
+    if (self->timeout_id)
+        return;
+
+    /* Whole seconds can be coalesced with other wakeups */
+    if (self->refresh % 1000 == 0)
+        self->timeout_id = g_timeout_add_seconds (self->refresh / 1000, (GSourceFunc) refresh_cb, self);
+    else
+        self->timeout_id = g_timeout_add (self->refresh, (GSourceFunc) refresh_cb, self);
+}
+
+guint
+mm_netdev_stats_watch (MMNetdevStats     *self,
+                       const gchar       *ifname,
+                       MMNetdevStatsFunc  callback,
+                       gpointer           user_data)
+{
+    Watch *watch;
+
+    g_return_val_if_fail (MM_IS_NETDEV_STATS (self), 0);
+    g_return_val_if_fail (ifname != NULL, 0);
+    g_return_val_if_fail (callback != NULL, 0);
+
+    watch = g_slice_new0 (Watch);
+    watch->id = ++self->next_id;
+    if (G_UNLIKELY (!watch->id))
+        watch->id = ++self->next_id;
+    watch->ifname = g_strdup (ifname);
+    watch->callback = callback;
+    watch->user_data = user_data;
+    self->watches = g_list_prepend (self->watches, watch);
+
+    mm_obj_dbg (self, "watching interface %s (every %ums)", ifname, self->refresh);
+    schedule_refresh (self);
+    return watch->id;
+}
+
+void
+mm_netdev_stats_unwatch (MMNetdevStats *self,
+                         guint          id)
+{
+    GList *l;
+
+    g_return_if_fail (MM_IS_NETDEV_STATS (self));
+
+    for (l = self->watches; l; l = g_list_next (l)) {
+        Watch *watch = l->data;
+
+        if (watch->id != id || watch->removed)
+            continue;
+
+        mm_obj_dbg (self, "no longer watching interface %s", watch->ifname);
+        if (self->dispatching) {
+            watch->removed = TRUE;
+            return;
+        }
+
+        watch_free (watch);
+        self->watches = g_list_delete_link (self->watches, l);
+        if (!self->watches && self->timeout_id) {
+            g_source_remove (self->timeout_id);
+            self->timeout_id = 0;
+        }
+        return;
+    }
+
+    g_warn_if_reached ();
+}
+
+guint
+mm_netdev_stats_get_refresh (MMNetdevStats *self)
+{
+    g_return_val_if_fail (MM_IS_NETDEV_STATS (self), 0);
+
+    return self->refresh;
+}
+
+/*****************************************************************************/
+
+static gchar *
+log_object_build_id (MMLogObject *_self)
+{
+    return g_strdup ("netdev-stats");
+}
+
+/*****************************************************************************/
+
+static void
+mm_netdev_stats_init (MMNetdevStats *self)
+{
+    self->refresh = mm_context_get_bearer_stats_refresh ();
+    if (!self->refresh)
+        self->refresh = REFRESH_DEFAULT_MS;
+    else if (self->refresh < REFRESH_MIN_MS) {
+        mm_obj_warn (self, "bearer stats refresh too low (%ums), using %ums", self->refresh, REFRESH_MIN_MS);
+        self->refresh = REFRESH_MIN_MS;
+    }
+}
+
+static void
+finalize (GObject *object)
+{
+    MMNetdevStats *self = MM_NETDEV_STATS (object);
+
+    if (self->timeout_id)
+        g_source_remove (self->timeout_id);
+    g_list_free_full (self->watches, (GDestroyNotify) watch_free);
+
+    G_OBJECT_CLASS (mm_netdev_stats_parent_class)->finalize (object);
+}
+
+static void
+log_object_iface_init (MMLogObjectInterface *iface)
+{
+    iface->build_id = log_object_build_id;
+}
+
+static void
+mm_netdev_stats_class_init (MMNetdevStatsClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->finalize = finalize;
+}
+
+MM_DEFINE_SINGLETON_GETTER (MMNetdevStats, mm_netdev_stats_get, MM_TYPE_NETDEV_STATS)
@@ -0,0 +1,61 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_NETDEV_STATS_H
+#define MM_NETDEV_STATS_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+/* Provider of the kernel byte counters of network interfaces. All watched
+ * interfaces are refreshed together with a single read of /proc/net/dev, at
+ * the rate given with --bearer-stats-refresh. */
+
+#define MM_TYPE_NETDEV_STATS            (mm_netdev_stats_get_type ())
+#define MM_NETDEV_STATS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_NETDEV_STATS, MMNetdevStats))
+#define MM_NETDEV_STATS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),  MM_TYPE_NETDEV_STATS, MMNetdevStatsClass))
+#define MM_IS_NETDEV_STATS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_NETDEV_STATS))
+#define MM_IS_NETDEV_STATS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  MM_TYPE_NETDEV_STATS))
+#define MM_NETDEV_STATS_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  MM_TYPE_NETDEV_STATS, MMNetdevStatsClass))
+
+typedef struct _MMNetdevStats      MMNetdevStats;
+typedef struct _MMNetdevStatsClass MMNetdevStatsClass;
+
+/* Called on every refresh with the current counters of the interface; not
+ * called if the interface counters can't be read. */
+typedef void (* MMNetdevStatsFunc) (const gchar *ifname,
+                                    guint64      rx_bytes,
+                                    guint64      tx_bytes,
+                                    gpointer     user_data);
+
+GType          mm_netdev_stats_get_type (void);
+MMNetdevStats *mm_netdev_stats_get      (void);
+
+/* Refresh rate, in milliseconds */
+guint          mm_netdev_stats_get_refresh (MMNetdevStats      *self);
+
+/* One-off read of the counters of a single interface */
+gboolean       mm_netdev_stats_read     (MMNetdevStats      *self,
+                                         const gchar        *ifname,
+                                         guint64            *out_rx_bytes,
+                                         guint64            *out_tx_bytes,
+                                         GError            **error);
+
+guint          mm_netdev_stats_watch    (MMNetdevStats      *self,
+                                         const gchar        *ifname,
+                                         MMNetdevStatsFunc   callback,
+                                         gpointer            user_data);
+void           mm_netdev_stats_unwatch  (MMNetdevStats      *self,
+                                         guint               id);
+
+#endif /* MM_NETDEV_STATS_H */
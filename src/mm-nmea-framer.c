@@ -0,0 +1,110 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+#include <string.h>
+
+#include "mm-nmea-framer.h"
+
+/* Validates the '*hh' checksum field, if any, of a sentence starting with
+ * '$' and without line terminator */
+static gboolean
+sentence_checksum_valid (const guint8 *sentence,
+                         gsize         len)
+{
+    guint8 checksum = 0;
+    gsize  i;
+    gint   high;
+    gint   low;
+
+    for (i = 1; i < len && sentence[i] != '*'; i++)
+        checksum ^= sentence[i];
+
+    /* No checksum field */
+    if (i == len)
+        return TRUE;
+
+    if (len - i != 3)
+        return FALSE;
+    high = g_ascii_xdigit_value (sentence[i + 1]);
+    low  = g_ascii_xdigit_value (sentence[i + 2]);
+    if (high < 0 || low < 0)
+        return FALSE;
+    return (checksum == ((high << 4) | low));
+}
+
+gsize
+mm_nmea_framer_process (guint8                 *data,
+                        gsize                   len,
+                        MMNmeaFramerStats      *stats,
+                        MMNmeaFramerSentenceFn  callback,
+                        gpointer                user_data)
+{
+    gsize pos = 0;
+
+    while (pos < len) {
+        const guint8 *start;
+        gsize         end;
+        gsize         sentence_len;
+
+        start = memchr (data + pos, '$', len - pos);
+        if (!start) {
+            stats->n_garbage_bytes += len - pos;
+            return len;
+        }
+        stats->n_garbage_bytes += (start - data) - pos;
+        pos = start - data;
+
+        /* '$' is reserved, so if found before the end of line the current
+         * sentence was truncated */
+        for (end = pos + 1; end < len && data[end] != '\n' && data[end] != '$'; end++);
+
+        if (end == len) {
+            if (len - pos > MM_NMEA_FRAMER_MAX_SENTENCE_LEN + 2) {
+                stats->n_garbage_bytes += len - pos;
+                return len;
+            }
+            /* Wait for the rest of the sentence */
+            return pos;
+        }
+
+        if (data[end] == '$') {
+            stats->n_garbage_bytes += end - pos;
+            pos = end;
+            continue;
+        }
+
+        sentence_len = end - pos;
+        if (data[end - 1] == '\r')
+            sentence_len--;
+
+        if (sentence_len < 2 || sentence_len > MM_NMEA_FRAMER_MAX_SENTENCE_LEN)
+            stats->n_garbage_bytes += end + 1 - pos;
+        else if (!sentence_checksum_valid (data + pos, sentence_len))
+            stats->n_bad_checksum++;
+        else {
+            guint8 terminator;
+
+            stats->n_sentences++;
+            if (callback) {
+                terminator = data[pos + sentence_len];
+                data[pos + sentence_len] = '\0';
+                callback ((const gchar *) (data + pos), sentence_len, user_data);
+                data[pos + sentence_len] = terminator;
+            }
+        }
+        pos = end + 1;
+    }
+
+    return len;
+}
@@ -0,0 +1,50 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_NMEA_FRAMER_H
+#define MM_NMEA_FRAMER_H
+
+#include <glib.h>
+
+/* Splits a stream of bytes into '$...*hh\r\n' NMEA sentences */
+
+/* Longest sentence accepted, without line terminator. NMEA 0183 limits them
+ * to 82 characters, but proprietary ones are often longer. */
+#define MM_NMEA_FRAMER_MAX_SENTENCE_LEN 512
+
+typedef struct {
+    guint64 n_sentences;
+    /* Sentences with a checksum field not matching their contents */
+    guint64 n_bad_checksum;
+    /* Bytes discarded outside of valid sentences */
+    guint64 n_garbage_bytes;
+} MMNmeaFramerStats;
+
+/* @sentence points into the buffer being processed and is only valid during
+ * the call; it's NUL-terminated and doesn't include the line terminator */
+typedef void (* MMNmeaFramerSentenceFn) (const gchar *sentence,
+                                         gsize        len,
+                                         gpointer     user_data);
+
+/* Reports every complete sentence in @data, and returns the number of bytes
+ * consumed; the rest is an incomplete sentence to be processed again once
+ * more data is available. @data is modified while the callback runs, but
+ * restored afterwards. Sentences without checksum field are reported as
+ * well, as the field is optional for most sentence types. */
+gsize mm_nmea_framer_process (guint8                 *data,
+                              gsize                   len,
+                              MMNmeaFramerStats      *stats,
+                              MMNmeaFramerSentenceFn  callback,
+                              gpointer                user_data);
+
+#endif /* MM_NMEA_FRAMER_H */
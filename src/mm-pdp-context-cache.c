@@ -0,0 +1,138 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include "mm-pdp-context-cache.h"
+#include "mm-modem-helpers.h"
+
+struct _MMPdpContextCache {
+    /* key -> cid */
+    GHashTable *entries;
+};
+
+/*****************************************************************************/
+
+static gchar *
+build_key (const gchar      *sim_identifier,
+           const gchar      *apn,
+           MMBearerIpFamily  ip_family)
+{
+    gchar *apn_lower;
+    gchar *key;
+
+    if (!sim_identifier || !sim_identifier[0])
+        return NULL;
+
+    apn_lower = g_ascii_strdown (apn ? apn : "", -1);
+    key = g_strdup_printf ("%s/%s/%u", sim_identifier, apn_lower, ip_family);
+    g_free (apn_lower);
+    return key;
+}
+
+static gboolean
+match_cid (gpointer key,
+           gpointer value,
+           gpointer user_data)
+{
+    return (!user_data || value == user_data);
+}
+
+guint
+mm_pdp_context_cache_lookup (MMPdpContextCache *self,
+                             const gchar       *sim_identifier,
+                             const gchar       *apn,
+                             MMBearerIpFamily   ip_family)
+{
+    gchar *key;
+    guint  cid;
+
+    key = build_key (sim_identifier, apn, ip_family);
+    if (!key)
+        return 0;
+
+    cid = GPOINTER_TO_UINT (g_hash_table_lookup (self->entries, key));
+    g_free (key);
+    return cid;
+}
+
+gboolean
+mm_pdp_context_cache_update (MMPdpContextCache *self,
+                             const gchar       *sim_identifier,
+                             const gchar       *apn,
+                             MMBearerIpFamily   ip_family,
+                             guint              cid)
+{
+    gchar *key;
+
+    g_assert (cid != 0);
+
+    key = build_key (sim_identifier, apn, ip_family);
+    if (!key)
+        return FALSE;
+
+    if (GPOINTER_TO_UINT (g_hash_table_lookup (self->entries, key)) == cid) {
+        g_free (key);
+        return FALSE;
+    }
+
+    /* The context may have been redefined with a different APN or IP type */
+    g_hash_table_foreach_remove (self->entries, match_cid, GUINT_TO_POINTER (cid));
+    g_hash_table_insert (self->entries, key, GUINT_TO_POINTER (cid));
+    return TRUE;
+}
+
+guint
+mm_pdp_context_cache_invalidate (MMPdpContextCache *self,
+                                 guint              cid)
+{
+    return g_hash_table_foreach_remove (self->entries, match_cid, GUINT_TO_POINTER (cid));
+}
+
+gboolean
+mm_pdp_context_cache_validate (GList            *context_list,
+                               guint             cid,
+                               const gchar      *apn,
+                               MMBearerIpFamily  ip_family)
+{
+    GList *l;
+
+    for (l = context_list; l; l = g_list_next (l)) {
+        MM3gppPdpContext *pdp = l->data;
+
+        if (pdp->cid != cid)
+            continue;
+        return (pdp->pdp_type == ip_family && mm_3gpp_cmp_apn_name (apn, pdp->apn));
+    }
+
+    return FALSE;
+}
+
+/*****************************************************************************/
+
+MMPdpContextCache *
+mm_pdp_context_cache_new (void)
+{
+    MMPdpContextCache *self;
+
+    self = g_slice_new0 (MMPdpContextCache);
+    self->entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    return self;
+}
+
+void
+mm_pdp_context_cache_free (MMPdpContextCache *self)
+{
+    g_hash_table_unref (self->entries);
+    g_slice_free (MMPdpContextCache, self);
+}
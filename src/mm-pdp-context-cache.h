@@ -0,0 +1,55 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_PDP_CONTEXT_CACHE_H
+#define MM_PDP_CONTEXT_CACHE_H
+
+#include <glib.h>
+
+#include <ModemManager.h>
+
+/* CIDs of the PDP contexts used in successful connections, indexed by SIM
+ * identifier, APN (case-insensitive) and IP type. Nothing is cached when
+ * the SIM identifier is unknown. */
+
+typedef struct _MMPdpContextCache MMPdpContextCache;
+
+MMPdpContextCache *mm_pdp_context_cache_new        (void);
+void               mm_pdp_context_cache_free       (MMPdpContextCache *self);
+
+/* Returns 0 if no context is cached */
+guint              mm_pdp_context_cache_lookup     (MMPdpContextCache *self,
+                                                    const gchar       *sim_identifier,
+                                                    const gchar       *apn,
+                                                    MMBearerIpFamily   ip_family);
+
+/* Any other entry using the same @cid is dropped, as the context was
+ * redefined. Returns TRUE if the cache changed. */
+gboolean           mm_pdp_context_cache_update     (MMPdpContextCache *self,
+                                                    const gchar       *sim_identifier,
+                                                    const gchar       *apn,
+                                                    MMBearerIpFamily   ip_family,
+                                                    guint              cid);
+
+/* A @cid of 0 removes all entries. Returns the number of entries removed. */
+guint              mm_pdp_context_cache_invalidate (MMPdpContextCache *self,
+                                                    guint              cid);
+
+/* Checks whether a cached @cid is still defined with the same APN and IP
+ * type in a list of MM3gppPdpContext, as given by +CGDCONT? */
+gboolean           mm_pdp_context_cache_validate   (GList             *context_list,
+                                                    guint              cid,
+                                                    const gchar       *apn,
+                                                    MMBearerIpFamily   ip_family);
+
+#endif /* MM_PDP_CONTEXT_CACHE_H */
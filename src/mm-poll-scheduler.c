@@ -0,0 +1,418 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include "mm-poll-scheduler.h"
+#include "mm-log-object.h"
+
+static void log_object_iface_init (MMLogObjectInterface *iface);
+
+G_DEFINE_TYPE_EXTENDED (MMPollScheduler, mm_poll_scheduler, G_TYPE_OBJECT, 0,
+                        G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
+
+/* Jobs with intervals of at least 4 grid steps are aligned to the grid,
+ * shorter ones just run with second granularity. The grid is based on the
+ * monotonic clock, so it's shared by the jobs of all modems. */
+#define ALIGN_GRID_SEC      5
+/* Initial backoff when a deferrable job finds the ports busy */
+#define BUSY_BACKOFF_SEC    2
+#define BUSY_BACKOFF_MAX_SHIFT 8
+
+typedef struct {
+    guint           id;
+    gchar          *name;
+    guint           interval;
+    MMPollJobFlags  flags;
+    GSourceFunc     callback;
+    gpointer        user_data;
+    /* Monotonic time, in seconds */
+    gint64          deadline;
+    /* Backoff while busy */
+    guint           n_deferrals;
+    guint           deferred;
+    /* Removed while its callback was running */
+    gboolean        removed;
+} PollJob;
+
+struct _MMPollSchedulerPrivate {
+    /* Pending jobs, sorted by deadline */
+    GList   *jobs;
+    /* Jobs detached while processing a wakeup */
+    GList   *due;
+    PollJob *running;
+    guint    next_id;
+
+    guint    timeout_id;
+    gint64   timeout_deadline;
+
+    MMPollSchedulerBusyFunc busy_func;
+    gpointer                busy_user_data;
+
+    MMPollSchedulerClockFunc clock_func;
+    gpointer                 clock_user_data;
+
+    /* Metrics */
+    gint64   minute_start;
+    guint    n_wakeups;
+    guint    n_jobs_run;
+    guint    wakeups_per_minute;
+};
+
+/*****************************************************************************/
+
+static gint64
+now_sec (MMPollScheduler *self)
+{
+    if (self->priv->clock_func)
+        return self->priv->clock_func (self->priv->clock_user_data);
+    return g_get_monotonic_time () / G_USEC_PER_SEC;
+}
+
+static gint64
+aligned_deadline (gint64 now,
+                  guint  interval)
+{
+    gint64 deadline;
+
+    deadline = now + interval;
+    if (interval >= 4 * ALIGN_GRID_SEC)
+        deadline = ((deadline + ALIGN_GRID_SEC - 1) / ALIGN_GRID_SEC) * ALIGN_GRID_SEC;
+    return deadline;
+}
+
+static void
+poll_job_free (PollJob *job)
+{
+    g_free (job->name);
+    g_slice_free (PollJob, job);
+}
+
+static gint
+poll_job_cmp_deadline (const PollJob *a,
+                       const PollJob *b)
+{
+    return (a->deadline > b->deadline) - (a->deadline < b->deadline);
+}
+
+static void
+insert_job (MMPollScheduler *self,
+            PollJob         *job)
+{
+    /* Jobs with the same deadline keep the order in which they were added */
+    self->priv->jobs = g_list_insert_sorted (self->priv->jobs, job, (GCompareFunc) poll_job_cmp_deadline);
+}
+
+static gboolean wakeup_cb (MMPollScheduler *self);
+
+static void
+schedule_wakeup (MMPollScheduler *self)
+{
+    PollJob *first;
+    gint64   now;
+
+    if (!self->priv->jobs) {
+        if (self->priv->timeout_id) {
+            g_source_remove (self->priv->timeout_id);
+            self->priv->timeout_id = 0;
+        }
+        return;
+    }
+
+    first = self->priv->jobs->data;
+    if (self->priv->timeout_id) {
+        if (self->priv->timeout_deadline == first->deadline)
+            return;
+        g_source_remove (self->priv->timeout_id);
+    }
+
+    now = now_sec (self);
+    self->priv->timeout_deadline = first->deadline;
+    self->priv->timeout_id = g_timeout_add_seconds ((guint) MAX (first->deadline - now, 0),
+                                                    (GSourceFunc) wakeup_cb,
+                                                    self);
+}
+
+static void
+account_wakeup (MMPollScheduler *self,
+                gint64           now)
+{
+    if (now - self->priv->minute_start >= 60) {
+        /* Nothing at all during the minute(s) right before this wakeup */
+        self->priv->wakeups_per_minute = (now - self->priv->minute_start < 120) ? self->priv->n_wakeups : 0;
+        mm_obj_dbg (self, "%u wakeups and %u jobs run in the last minute",
+                    self->priv->n_wakeups, self->priv->n_jobs_run);
+        self->priv->minute_start = now;
+        self->priv->n_wakeups = 0;
+        self->priv->n_jobs_run = 0;
+    }
+    self->priv->n_wakeups++;
+}
+
+static guint
+dispatch (MMPollScheduler *self)
+{
+    gint64   now;
+    gboolean busy;
+    guint    n_run = 0;
+
+    now = now_sec (self);
+    account_wakeup (self, now);
+
+    /* Callbacks may drop the last reference to the scheduler's owner */
+    g_object_ref (self);
+
+    /* Detach all due jobs first, as callbacks may add or remove jobs */
+    g_assert (!self->priv->due);
+    while (self->priv->jobs && ((PollJob *) self->priv->jobs->data)->deadline <= now) {
+        self->priv->due = g_list_append (self->priv->due, self->priv->jobs->data);
+        self->priv->jobs = g_list_delete_link (self->priv->jobs, self->priv->jobs);
+    }
+
+    /* Busy state is checked once per wakeup, so that the commands issued by
+     * the first jobs don't make the rest of the batch back off */
+    busy = (self->priv->due && self->priv->busy_func && self->priv->busy_func (self->priv->busy_user_data));
+
+    while (self->priv->due) {
+        PollJob  *job;
+        gboolean  keep;
+
+        job = self->priv->due->data;
+        self->priv->due = g_list_delete_link (self->priv->due, self->priv->due);
+
+        if (busy && (job->flags & MM_POLL_JOB_FLAG_DEFER_WHEN_BUSY) && job->deferred < job->interval) {
+            guint backoff;
+
+            backoff = MIN (BUSY_BACKOFF_SEC << MIN (job->n_deferrals, BUSY_BACKOFF_MAX_SHIFT),
+                           job->interval - job->deferred);
+            job->n_deferrals++;
+            job->deferred += backoff;
+            job->deadline = now + backoff;
+            mm_obj_dbg (self, "'%s' job deferred %us: ports busy", job->name, backoff);
+            insert_job (self, job);
+            continue;
+        }
+
+        job->n_deferrals = 0;
+        job->deferred = 0;
+        self->priv->n_jobs_run++;
+        n_run++;
+
+        self->priv->running = job;
+        keep = job->callback (job->user_data);
+        self->priv->running = NULL;
+
+        if (keep && !job->removed) {
+            job->deadline = aligned_deadline (now, job->interval);
+            insert_job (self, job);
+        } else
+            poll_job_free (job);
+    }
+
+    schedule_wakeup (self);
+    g_object_unref (self);
+    return n_run;
+}
+
+static gboolean
+wakeup_cb (MMPollScheduler *self)
+{
+    self->priv->timeout_id = 0;
+    dispatch (self);
+    return G_SOURCE_REMOVE;
+}
+
+/*****************************************************************************/
+
+guint
+mm_poll_scheduler_add (MMPollScheduler *self,
+                       const gchar     *name,
+                       guint            interval_sec,
+                       MMPollJobFlags   flags,
+                       GSourceFunc      callback,
+                       gpointer         user_data)
+{
+    PollJob *job;
+
+    g_return_val_if_fail (MM_IS_POLL_SCHEDULER (self), 0);
+    g_return_val_if_fail (callback != NULL, 0);
+
+    job = g_slice_new0 (PollJob);
+    job->id = ++self->priv->next_id;
+    if (G_UNLIKELY (!job->id))
+        job->id = ++self->priv->next_id;
+    job->name = g_strdup (name);
+    job->interval = interval_sec;
+    job->flags = flags;
+    job->callback = callback;
+    job->user_data = user_data;
+    job->deadline = aligned_deadline (now_sec (self), interval_sec);
+
+    insert_job (self, job);
+
+    /* If added while processing a wakeup, the timer is armed afterwards */
+    if (!self->priv->running)
+        schedule_wakeup (self);
+
+    return job->id;
+}
+
+static gboolean
+remove_from_list (GList **list,
+                  guint   id)
+{
+    GList *l;
+
+    for (l = *list; l; l = g_list_next (l)) {
+        PollJob *job = l->data;
+
+        if (job->id == id) {
+            poll_job_free (job);
+            *list = g_list_delete_link (*list, l);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+void
+mm_poll_scheduler_remove (MMPollScheduler *self,
+                          guint            id)
+{
+    g_return_if_fail (MM_IS_POLL_SCHEDULER (self));
+
+    if (self->priv->running && self->priv->running->id == id) {
+        self->priv->running->removed = TRUE;
+        return;
+    }
+
+    if (remove_from_list (&self->priv->due, id))
+        return;
+
+    if (remove_from_list (&self->priv->jobs, id)) {
+        if (!self->priv->running)
+            schedule_wakeup (self);
+        return;
+    }
+
+    g_warn_if_reached ();
+}
+
+void
+mm_poll_scheduler_set_clock_func (MMPollScheduler          *self,
+                                  MMPollSchedulerClockFunc  clock_func,
+                                  gpointer                  user_data)
+{
+    g_return_if_fail (MM_IS_POLL_SCHEDULER (self));
+
+    self->priv->clock_func = clock_func;
+    self->priv->clock_user_data = user_data;
+    self->priv->minute_start = now_sec (self);
+}
+
+guint
+mm_poll_scheduler_get_wakeups_per_minute (MMPollScheduler *self)
+{
+    gint64 elapsed;
+
+    g_return_val_if_fail (MM_IS_POLL_SCHEDULER (self), 0);
+
+    /* The counters are only rolled over on wakeups, so the last full minute
+     * may still be the one being accounted */
+    elapsed = now_sec (self) - self->priv->minute_start;
+    if (elapsed < 60)
+        return self->priv->wakeups_per_minute;
+    if (elapsed < 120)
+        return self->priv->n_wakeups;
+    return 0;
+}
+
+guint
+mm_poll_scheduler_dispatch (MMPollScheduler *self)
+{
+    g_return_val_if_fail (MM_IS_POLL_SCHEDULER (self), 0);
+    g_return_val_if_fail (!self->priv->running, 0);
+
+    if (self->priv->timeout_id) {
+        g_source_remove (self->priv->timeout_id);
+        self->priv->timeout_id = 0;
+    }
+    return dispatch (self);
+}
+
+void
+mm_poll_scheduler_set_busy_func (MMPollScheduler         *self,
+                                 MMPollSchedulerBusyFunc  busy_func,
+                                 gpointer                 user_data)
+{
+    g_return_if_fail (MM_IS_POLL_SCHEDULER (self));
+
+    self->priv->busy_func = busy_func;
+    self->priv->busy_user_data = user_data;
+}
+
+/*****************************************************************************/
+
+static gchar *
+log_object_build_id (MMLogObject *_self)
+{
+    return g_strdup ("poll-scheduler");
+}
+
+/*****************************************************************************/
+
+MMPollScheduler *
+mm_poll_scheduler_new (const gchar *owner_id)
+{
+    MMPollScheduler *self;
+
+    self = g_object_new (MM_TYPE_POLL_SCHEDULER, NULL);
+    if (owner_id)
+        mm_log_object_set_owner_id (MM_LOG_OBJECT (self), owner_id);
+    return self;
+}
+
+static void
+mm_poll_scheduler_init (MMPollScheduler *self)
+{
+    self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_POLL_SCHEDULER, MMPollSchedulerPrivate);
+    self->priv->minute_start = now_sec (self);
+}
+
+static void
+finalize (GObject *object)
+{
+    MMPollScheduler *self = MM_POLL_SCHEDULER (object);
+
+    if (self->priv->timeout_id)
+        g_source_remove (self->priv->timeout_id);
+    g_list_free_full (self->priv->jobs, (GDestroyNotify) poll_job_free);
+
+    G_OBJECT_CLASS (mm_poll_scheduler_parent_class)->finalize (object);
+}
+
+static void
+log_object_iface_init (MMLogObjectInterface *iface)
+{
+    iface->build_id = log_object_build_id;
+}
+
+static void
+mm_poll_scheduler_class_init (MMPollSchedulerClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    g_type_class_add_private (object_class, sizeof (MMPollSchedulerPrivate));
+
+    object_class->finalize = finalize;
+}
@@ -0,0 +1,87 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_POLL_SCHEDULER_H
+#define MM_POLL_SCHEDULER_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+/* Per-modem scheduler for periodic jobs (signal quality, registration,
+ * bearer stats...). Deadlines are aligned to a common grid so that jobs due
+ * around the same time run in a single wakeup, instead of each one arming
+ * its own timer. Jobs behave like g_timeout_add_seconds() sources: the
+ * callback returns G_SOURCE_CONTINUE to be run again after the same
+ * interval, or G_SOURCE_REMOVE to be dropped. */
+
+#define MM_TYPE_POLL_SCHEDULER            (mm_poll_scheduler_get_type ())
+#define MM_POLL_SCHEDULER(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_POLL_SCHEDULER, MMPollScheduler))
+#define MM_POLL_SCHEDULER_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),  MM_TYPE_POLL_SCHEDULER, MMPollSchedulerClass))
+#define MM_IS_POLL_SCHEDULER(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_POLL_SCHEDULER))
+#define MM_IS_POLL_SCHEDULER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  MM_TYPE_POLL_SCHEDULER))
+#define MM_POLL_SCHEDULER_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  MM_TYPE_POLL_SCHEDULER, MMPollSchedulerClass))
+
+typedef struct _MMPollScheduler MMPollScheduler;
+typedef struct _MMPollSchedulerClass MMPollSchedulerClass;
+typedef struct _MMPollSchedulerPrivate MMPollSchedulerPrivate;
+
+struct _MMPollScheduler {
+    GObject parent;
+    MMPollSchedulerPrivate *priv;
+};
+
+struct _MMPollSchedulerClass {
+    GObjectClass parent;
+};
+
+typedef enum {
+    MM_POLL_JOB_FLAG_NONE            = 0,
+    /* Postpone the job (with exponential backoff, at most one interval)
+     * while the control port is busy or in data mode */
+    MM_POLL_JOB_FLAG_DEFER_WHEN_BUSY = 1 << 0,
+} MMPollJobFlags;
+
+/* Returns TRUE if the modem ports are busy and deferrable jobs should wait */
+typedef gboolean (* MMPollSchedulerBusyFunc) (gpointer user_data);
+
+/* Returns the current time, in seconds */
+typedef gint64 (* MMPollSchedulerClockFunc) (gpointer user_data);
+
+GType mm_poll_scheduler_get_type (void);
+
+MMPollScheduler *mm_poll_scheduler_new           (const gchar             *owner_id);
+void             mm_poll_scheduler_set_busy_func (MMPollScheduler         *self,
+                                                  MMPollSchedulerBusyFunc  busy_func,
+                                                  gpointer                 user_data);
+
+guint            mm_poll_scheduler_add           (MMPollScheduler         *self,
+                                                  const gchar             *name,
+                                                  guint                    interval_sec,
+                                                  MMPollJobFlags           flags,
+                                                  GSourceFunc              callback,
+                                                  gpointer                 user_data);
+void             mm_poll_scheduler_remove        (MMPollScheduler         *self,
+                                                  guint                    id);
+
+/* Number of wakeups during the last full minute */
+guint            mm_poll_scheduler_get_wakeups_per_minute (MMPollScheduler *self);
+
+/* Unit test support: replace the monotonic clock, and run the jobs due at
+ * the current time without waiting for the timer. Returns the number of
+ * jobs run. */
+void             mm_poll_scheduler_set_clock_func (MMPollScheduler          *self,
+                                                   MMPollSchedulerClockFunc  clock_func,
+                                                   gpointer                  user_data);
+guint            mm_poll_scheduler_dispatch       (MMPollScheduler          *self);
+
+#endif /* MM_POLL_SCHEDULER_H */
@@ -0,0 +1,349 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <ModemManager.h>
+#include <mm-errors-types.h>
+
+#include "mm-port-capture.h"
+#include "mm-log.h"
+
+#define BLOCK_TYPE_SHB 0x0A0D0D0A
+#define BLOCK_TYPE_IDB 0x00000001
+#define BLOCK_TYPE_EPB 0x00000006
+
+#define BYTE_ORDER_MAGIC 0x1A2B3C4D
+
+#define OPTION_END_OF_OPT  0
+#define OPTION_SHB_USERAPPL 4
+#define OPTION_IF_NAME     2
+#define OPTION_IF_TSRESOL  9
+#define OPTION_EPB_FLAGS   2
+
+/* Buffered blocks are written once this size is reached */
+#define FLUSH_SIZE 32768
+
+struct _MMPortCapture {
+    volatile gint  ref_count;
+    gchar         *path;
+    int            fd;
+    gsize          max_size;
+    /* Written or buffered */
+    gsize          size;
+    gboolean       full;
+    GByteArray    *buffer;
+    guint          flush_id;
+    /* Port name to interface id */
+    GHashTable    *interfaces;
+};
+
+/*****************************************************************************/
+
+#define PADDED_LEN(len) (((len) + 3) & ~((gsize) 3))
+
+static void
+append_u16 (GByteArray *buffer,
+            guint16     value)
+{
+    g_byte_array_append (buffer, (const guint8 *) &value, sizeof (value));
+}
+
+static void
+append_u32 (GByteArray *buffer,
+            guint32     value)
+{
+    g_byte_array_append (buffer, (const guint8 *) &value, sizeof (value));
+}
+
+static void
+append_padded (GByteArray   *buffer,
+               const guint8 *data,
+               gsize         len)
+{
+    static const guint8 zero[3] = { 0 };
+
+    g_byte_array_append (buffer, data, len);
+    g_byte_array_append (buffer, zero, PADDED_LEN (len) - len);
+}
+
+static void
+append_option (GByteArray   *buffer,
+               guint16       code,
+               const guint8 *data,
+               gsize         len)
+{
+    append_u16 (buffer, code);
+    append_u16 (buffer, (guint16) len);
+    append_padded (buffer, data, len);
+}
+
+/* Blocks are built in place: the total length is set once complete */
+static guint
+block_start (GByteArray *buffer,
+             guint32     type)
+{
+    guint start;
+
+    start = buffer->len;
+    append_u32 (buffer, type);
+    append_u32 (buffer, 0);
+    return start;
+}
+
+static void
+block_end (GByteArray *buffer,
+           guint       start)
+{
+    guint32 total;
+
+    total = buffer->len - start + 4;
+    memcpy (&buffer->data[start + 4], &total, sizeof (total));
+    append_u32 (buffer, total);
+}
+
+/*****************************************************************************/
+
+static gboolean
+write_buffer (MMPortCapture *self)
+{
+    const guint8 *p;
+    gsize         left;
+
+    p = self->buffer->data;
+    left = self->buffer->len;
+    while (left > 0) {
+        gssize written;
+
+        written = write (self->fd, p, left);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            mm_obj_warn (NULL, "couldn't write port capture file '%s': %s",
+                         self->path, g_strerror (errno));
+            g_byte_array_set_size (self->buffer, 0);
+            return FALSE;
+        }
+        p += written;
+        left -= written;
+    }
+    g_byte_array_set_size (self->buffer, 0);
+    return TRUE;
+}
+
+void
+mm_port_capture_flush (MMPortCapture *self)
+{
+    if (self->flush_id) {
+        g_source_remove (self->flush_id);
+        self->flush_id = 0;
+    }
+    if (self->buffer->len && !write_buffer (self))
+        self->full = TRUE;
+}
+
+static gboolean
+flush_cb (MMPortCapture *self)
+{
+    self->flush_id = 0;
+    mm_port_capture_flush (self);
+    return G_SOURCE_REMOVE;
+}
+
+/* Blocks are only kept if they fit in the maximum file size */
+static gboolean
+block_commit (MMPortCapture *self,
+              guint          start)
+{
+    gsize block_len;
+
+    block_end (self->buffer, start);
+    block_len = self->buffer->len - start;
+    if (self->size + block_len > self->max_size) {
+        mm_obj_info (NULL, "port capture file '%s' reached its maximum size (%" G_GSIZE_FORMAT " bytes)",
+                     self->path, self->max_size);
+        g_byte_array_set_size (self->buffer, start);
+        self->full = TRUE;
+        return FALSE;
+    }
+    self->size += block_len;
+    return TRUE;
+}
+
+static guint32
+get_interface_id (MMPortCapture *self,
+                  const gchar   *port_name)
+{
+    gpointer value;
+    guint32  id;
+    guint    start;
+    /* Microseconds */
+    guint8   tsresol = 6;
+
+    if (g_hash_table_lookup_extended (self->interfaces, port_name, NULL, &value))
+        return GPOINTER_TO_UINT (value);
+
+    start = block_start (self->buffer, BLOCK_TYPE_IDB);
+    append_u16 (self->buffer, MM_PORT_CAPTURE_LINKTYPE);
+    append_u16 (self->buffer, 0);
+    /* No snapshot length limit */
+    append_u32 (self->buffer, 0);
+    append_option (self->buffer, OPTION_IF_NAME, (const guint8 *) port_name, strlen (port_name));
+    append_option (self->buffer, OPTION_IF_TSRESOL, &tsresol, 1);
+    append_u32 (self->buffer, OPTION_END_OF_OPT);
+    if (!block_commit (self, start))
+        return G_MAXUINT32;
+
+    id = g_hash_table_size (self->interfaces);
+    g_hash_table_insert (self->interfaces, g_strdup (port_name), GUINT_TO_POINTER (id));
+    return id;
+}
+
+void
+mm_port_capture_write (MMPortCapture          *self,
+                       const gchar            *port_name,
+                       MMPortCaptureDirection  direction,
+                       const guint8           *data,
+                       gsize                   len)
+{
+    guint32 interface_id;
+    guint64 timestamp;
+    guint32 flags;
+    guint   start;
+
+    if (self->full || !len)
+        return;
+
+    interface_id = get_interface_id (self, port_name);
+    if (interface_id == G_MAXUINT32)
+        return;
+
+    timestamp = (guint64) g_get_real_time ();
+    flags = (guint32) direction;
+
+    start = block_start (self->buffer, BLOCK_TYPE_EPB);
+    append_u32 (self->buffer, interface_id);
+    append_u32 (self->buffer, (guint32) (timestamp >> 32));
+    append_u32 (self->buffer, (guint32) timestamp);
+    append_u32 (self->buffer, (guint32) len);
+    append_u32 (self->buffer, (guint32) len);
+    append_padded (self->buffer, data, len);
+    append_option (self->buffer, OPTION_EPB_FLAGS, (const guint8 *) &flags, sizeof (flags));
+    append_u32 (self->buffer, OPTION_END_OF_OPT);
+    if (!block_commit (self, start))
+        return;
+
+    if (self->buffer->len >= FLUSH_SIZE)
+        mm_port_capture_flush (self);
+    else if (!self->flush_id)
+        self->flush_id = g_timeout_add_seconds (1, (GSourceFunc) flush_cb, self);
+}
+
+/*****************************************************************************/
+
+const gchar *
+mm_port_capture_get_path (MMPortCapture *self)
+{
+    return self->path;
+}
+
+MMPortCapture *
+mm_port_capture_new (const gchar  *dir,
+                     const gchar  *name,
+                     gsize         max_size,
+                     GError      **error)
+{
+    MMPortCapture *self;
+    guint          start;
+    const gchar   *userappl = "ModemManager " MM_DIST_VERSION;
+    gchar         *path;
+    int            fd;
+
+    /* The daemon runs with privileges, so never let the name point
+     * anywhere else than the captures directory */
+    if (!name || !name[0] ||
+        strchr (name, G_DIR_SEPARATOR) ||
+        g_str_equal (name, ".") ||
+        g_str_equal (name, "..")) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS,
+                     "Invalid port capture file name '%s'", name ? name : "");
+        return NULL;
+    }
+
+    if (g_mkdir_with_parents (dir, 0700) < 0) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Couldn't create port capture directory '%s': %s",
+                     dir, g_strerror (errno));
+        return NULL;
+    }
+
+    path = g_build_filename (dir, name, NULL);
+    fd = open (path, O_CREAT | O_EXCL | O_NOFOLLOW | O_WRONLY | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        g_set_error (error, MM_CORE_ERROR,
+                     errno == EEXIST ? MM_CORE_ERROR_EXISTS : MM_CORE_ERROR_FAILED,
+                     "Couldn't create port capture file '%s': %s",
+                     path, g_strerror (errno));
+        g_free (path);
+        return NULL;
+    }
+
+    self = g_slice_new0 (MMPortCapture);
+    self->ref_count = 1;
+    self->path = path;
+    self->fd = fd;
+    self->max_size = max_size ? max_size : MM_PORT_CAPTURE_DEFAULT_MAX_SIZE;
+    self->buffer = g_byte_array_sized_new (FLUSH_SIZE + 4096);
+    self->interfaces = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    start = block_start (self->buffer, BLOCK_TYPE_SHB);
+    append_u32 (self->buffer, BYTE_ORDER_MAGIC);
+    append_u16 (self->buffer, 1);
+    append_u16 (self->buffer, 0);
+    /* Unknown section length */
+    append_u32 (self->buffer, G_MAXUINT32);
+    append_u32 (self->buffer, G_MAXUINT32);
+    append_option (self->buffer, OPTION_SHB_USERAPPL, (const guint8 *) userappl, strlen (userappl));
+    append_u32 (self->buffer, OPTION_END_OF_OPT);
+    block_end (self->buffer, start);
+    self->size = self->buffer->len;
+
+    /* Header written right away, so that the file is valid even if empty */
+    mm_port_capture_flush (self);
+    return self;
+}
+
+MMPortCapture *
+mm_port_capture_ref (MMPortCapture *self)
+{
+    g_atomic_int_inc (&self->ref_count);
+    return self;
+}
+
+void
+mm_port_capture_unref (MMPortCapture *self)
+{
+    if (g_atomic_int_dec_and_test (&self->ref_count)) {
+        mm_port_capture_flush (self);
+        close (self->fd);
+        g_hash_table_unref (self->interfaces);
+        g_byte_array_unref (self->buffer);
+        g_free (self->path);
+        g_slice_free (MMPortCapture, self);
+    }
+}
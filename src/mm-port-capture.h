@@ -0,0 +1,64 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_PORT_CAPTURE_H
+#define MM_PORT_CAPTURE_H
+
+#include <glib.h>
+
+/* Binary capture of the raw traffic of a set of ports, written as a pcapng
+ * file that can be read with decode/capture.py or Wireshark:
+ *
+ *  - One Section Header Block, in host byte order.
+ *  - One Interface Description Block per port, with link type USER0 (147),
+ *    the port name in the if_name option and microsecond resolution.
+ *  - One Enhanced Packet Block per chunk of data read from or written to
+ *    the port, with the direction in the epb_flags option (bit 0 inbound,
+ *    bit 1 outbound).
+ *
+ * Blocks are buffered and written at most once per second, or earlier if
+ * the buffer fills up. Once the file would grow over its maximum size, new
+ * data is discarded. */
+
+typedef struct _MMPortCapture MMPortCapture;
+
+/* Same values as the epb_flags option */
+typedef enum {
+    MM_PORT_CAPTURE_DIRECTION_IN  = 1,
+    MM_PORT_CAPTURE_DIRECTION_OUT = 2,
+} MMPortCaptureDirection;
+
+#define MM_PORT_CAPTURE_LINKTYPE 147
+
+/* 0 uses the default maximum size */
+#define MM_PORT_CAPTURE_DEFAULT_MAX_SIZE (16 * 1024 * 1024)
+
+/* The file is created as @name in @dir, which is created if needed. @name
+ * must be a plain file name, and the file must not exist yet. */
+MMPortCapture *mm_port_capture_new       (const gchar             *dir,
+                                          const gchar             *name,
+                                          gsize                    max_size,
+                                          GError                 **error);
+MMPortCapture *mm_port_capture_ref       (MMPortCapture           *self);
+void           mm_port_capture_unref     (MMPortCapture           *self);
+
+const gchar   *mm_port_capture_get_path  (MMPortCapture           *self);
+
+void           mm_port_capture_write     (MMPortCapture           *self,
+                                          const gchar             *port_name,
+                                          MMPortCaptureDirection   direction,
+                                          const guint8            *data,
+                                          gsize                    len);
+void           mm_port_capture_flush     (MMPortCapture           *self);
+
+#endif /* MM_PORT_CAPTURE_H */
@@ -36,6 +36,8 @@ struct _MMPortQmiPrivate {
     gboolean in_progress;
     QmiDevice *qmi_device;
     GList *services;
+    /* Preallocated clients not yet handed out */
+    GList *pool;
     gboolean llp_is_raw_ip;
 };
 
@@ -171,6 +173,39 @@ allocate_client_ready (QmiDevice *qmi_device,
     g_object_unref (task);
 }
 
+static gboolean
+take_pooled_client (MMPortQmi     *self,
+                    QmiService     service,
+                    MMPortQmiFlag  flag)
+{
+    GList *l;
+
+    for (l = self->priv->pool; l; l = g_list_next (l)) {
+        ServiceInfo *info = l->data;
+
+        if (info->service == service) {
+            self->priv->pool = g_list_delete_link (self->priv->pool, l);
+            info->flag = flag;
+            self->priv->services = g_list_prepend (self->priv->services, info);
+            mm_obj_dbg (self, "client for service '%s' taken from pool", qmi_service_get_string (service));
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+gboolean
+mm_port_qmi_claim_pooled_client (MMPortQmi     *self,
+                                 QmiService     service,
+                                 MMPortQmiFlag  flag)
+{
+    g_return_val_if_fail (MM_IS_PORT_QMI (self), FALSE);
+
+    if (mm_port_qmi_peek_client (self, service, flag))
+        return FALSE;
+    return take_pooled_client (self, service, flag);
+}
+
 void
 mm_port_qmi_allocate_client (MMPortQmi *self,
                              QmiService service,
@@ -199,6 +234,13 @@ mm_port_qmi_allocate_client (MMPortQmi *self,
         return;
     }
 
+    /* Preallocated clients are handed out right away */
+    if (take_pooled_client (self, service, flag)) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
     ctx = g_new0 (AllocateClientContext, 1);
     ctx->info = g_new0 (ServiceInfo, 1);
     ctx->info->service = service;
@@ -216,6 +258,149 @@ mm_port_qmi_allocate_client (MMPortQmi *self,
 
 /*****************************************************************************/
 
+typedef struct {
+    QmiDevice *qmi_device;
+    guint      n_pending;
+    guint      n_requested;
+    guint      n_allocated;
+    gint64     start_time;
+    /* Sum of the individual allocation times, i.e. what allocating the
+     * clients one after the other would have taken */
+    gint64     serial_time;
+} PreallocateClientsContext;
+
+typedef struct {
+    GTask      *task;
+    QmiService  service;
+    gint64      start_time;
+} PreallocateClientRequest;
+
+static void
+preallocate_clients_context_free (PreallocateClientsContext *ctx)
+{
+    g_object_unref (ctx->qmi_device);
+    g_slice_free (PreallocateClientsContext, ctx);
+}
+
+gboolean
+mm_port_qmi_preallocate_clients_finish (MMPortQmi     *self,
+                                        GAsyncResult  *res,
+                                        GError       **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+preallocate_client_ready (QmiDevice                *qmi_device,
+                          GAsyncResult             *res,
+                          PreallocateClientRequest *request)
+{
+    MMPortQmi                 *self;
+    PreallocateClientsContext *ctx;
+    QmiClient                 *client;
+    GTask                     *task;
+    GError                    *error = NULL;
+    gint64                     now;
+
+    task = request->task;
+    self = g_task_get_source_object (task);
+    ctx  = g_task_get_task_data (task);
+    now  = g_get_monotonic_time ();
+    ctx->serial_time += now - request->start_time;
+
+    client = qmi_device_allocate_client_finish (qmi_device, res, &error);
+    if (!client) {
+        mm_obj_dbg (self, "couldn't preallocate client for service '%s': %s",
+                    qmi_service_get_string (request->service), error->message);
+        g_error_free (error);
+    } else if (self->priv->qmi_device != ctx->qmi_device) {
+        /* Port closed (or reopened) in the meantime */
+        qmi_device_release_client (qmi_device,
+                                   client,
+                                   QMI_DEVICE_RELEASE_CLIENT_FLAGS_RELEASE_CID,
+                                   3, NULL, NULL, NULL);
+        g_object_unref (client);
+    } else {
+        ServiceInfo *info;
+
+        info = g_new0 (ServiceInfo, 1);
+        info->service = request->service;
+        info->client = client;
+        self->priv->pool = g_list_append (self->priv->pool, info);
+        ctx->n_allocated++;
+    }
+    g_slice_free (PreallocateClientRequest, request);
+
+    g_assert (ctx->n_pending > 0);
+    if (--ctx->n_pending > 0)
+        return;
+
+    mm_obj_dbg (self, "preallocated %u/%u clients in %" G_GINT64_FORMAT "ms "
+                "(%" G_GINT64_FORMAT "ms if allocated serially, %" G_GINT64_FORMAT "ms saved)",
+                ctx->n_allocated, ctx->n_requested,
+                (now - ctx->start_time) / 1000,
+                ctx->serial_time / 1000,
+                MAX (ctx->serial_time - (now - ctx->start_time), 0) / 1000);
+
+    g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
+void
+mm_port_qmi_preallocate_clients (MMPortQmi           *self,
+                                 const QmiService    *services,
+                                 guint                n_services,
+                                 GCancellable        *cancellable,
+                                 GAsyncReadyCallback  callback,
+                                 gpointer             user_data)
+{
+    PreallocateClientsContext *ctx;
+    GTask                     *task;
+    guint                      i;
+
+    task = g_task_new (self, cancellable, callback, user_data);
+
+    if (!mm_port_qmi_is_open (self)) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE,
+                                 "Port is closed");
+        g_object_unref (task);
+        return;
+    }
+
+    if (!n_services) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    ctx = g_slice_new0 (PreallocateClientsContext);
+    ctx->qmi_device = g_object_ref (self->priv->qmi_device);
+    ctx->n_requested = n_services;
+    ctx->n_pending = n_services;
+    ctx->start_time = g_get_monotonic_time ();
+    g_task_set_task_data (task, ctx, (GDestroyNotify)preallocate_clients_context_free);
+
+    /* All CTL transactions are launched at once, each one keeping its own
+     * task reference */
+    for (i = 0; i < n_services; i++) {
+        PreallocateClientRequest *request;
+
+        request = g_slice_new0 (PreallocateClientRequest);
+        request->task = task;
+        request->service = services[i];
+        request->start_time = ctx->start_time;
+        qmi_device_allocate_client (ctx->qmi_device,
+                                    services[i],
+                                    QMI_CID_NONE,
+                                    10,
+                                    cancellable,
+                                    (GAsyncReadyCallback)preallocate_client_ready,
+                                    request);
+    }
+}
+
+/*****************************************************************************/
+
 gboolean
 mm_port_qmi_llp_is_raw_ip (MMPortQmi *self)
 {
@@ -847,6 +1032,19 @@ mm_port_qmi_close (MMPortQmi           *self,
     g_list_free_full (self->priv->services, g_free);
     self->priv->services = NULL;
 
+    /* And the preallocated ones never handed out */
+    for (l = self->priv->pool; l; l = g_list_next (l)) {
+        ServiceInfo *info = l->data;
+
+        qmi_device_release_client (ctx->qmi_device,
+                                   info->client,
+                                   QMI_DEVICE_RELEASE_CLIENT_FLAGS_RELEASE_CID,
+                                   3, NULL, NULL, NULL);
+        g_clear_object (&info->client);
+    }
+    g_list_free_full (self->priv->pool, g_free);
+    self->priv->pool = NULL;
+
     qmi_device_close_async (ctx->qmi_device,
                             5,
                             NULL,
@@ -887,6 +1085,13 @@ dispose (GObject *object)
     }
     g_list_free_full (self->priv->services, g_free);
     self->priv->services = NULL;
+    for (l = self->priv->pool; l; l = g_list_next (l)) {
+        ServiceInfo *info = l->data;
+
+        g_object_unref (info->client);
+    }
+    g_list_free_full (self->priv->pool, g_free);
+    self->priv->pool = NULL;
 
     /* Clear device object */
     g_clear_object (&self->priv->qmi_device);
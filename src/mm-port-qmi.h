@@ -80,6 +80,25 @@ gboolean mm_port_qmi_allocate_client_finish (MMPortQmi *self,
                                              GAsyncResult *res,
                                              GError **error);
 
+/* Allocates clients for all the given services in parallel and keeps them
+ * in a pool, so that a later mm_port_qmi_allocate_client() for any of those
+ * services doesn't need a CTL transaction. Services may be repeated to get
+ * more than one client (e.g. WDS for each IP family). Failing to allocate a
+ * client is not an error, it will just be allocated on demand. */
+void     mm_port_qmi_preallocate_clients        (MMPortQmi           *self,
+                                                 const QmiService    *services,
+                                                 guint                n_services,
+                                                 GCancellable        *cancellable,
+                                                 GAsyncReadyCallback  callback,
+                                                 gpointer             user_data);
+gboolean mm_port_qmi_preallocate_clients_finish (MMPortQmi           *self,
+                                                 GAsyncResult        *res,
+                                                 GError             **error);
+/* Hands out a preallocated client, if any; FALSE otherwise */
+gboolean mm_port_qmi_claim_pooled_client        (MMPortQmi           *self,
+                                                 QmiService           service,
+                                                 MMPortQmiFlag        flag);
+
 void     mm_port_qmi_release_client         (MMPortQmi     *self,
                                              QmiService     service,
                                              MMPortQmiFlag  flag);
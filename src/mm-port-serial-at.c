@@ -41,6 +41,14 @@ struct _MMPortSerialAtPrivate {
     gpointer response_parser_user_data;
     GDestroyNotify response_parser_notify;
 
+    /* Intermediate response line handler, only active while its command is
+     * the one being processed */
+    GByteArray *intermediate_line_command;
+    gboolean intermediate_line_active;
+    MMPortSerialAtIntermediateLineFn intermediate_line_fn;
+    gpointer intermediate_line_user_data;
+    GDestroyNotify intermediate_line_notify;
+
     GSList *unsolicited_msg_handlers;
 
     MMPortSerialAtFlag flags;
@@ -96,6 +104,100 @@ mm_port_serial_at_set_response_parser (MMPortSerialAt *self,
     self->priv->response_parser_notify = notify;
 }
 
+static GByteArray *at_command_to_byte_array (const char *command,
+                                             gboolean is_raw,
+                                             gboolean send_lf);
+
+void
+mm_port_serial_at_set_intermediate_line_handler (MMPortSerialAt *self,
+                                                 const gchar *command,
+                                                 MMPortSerialAtIntermediateLineFn fn,
+                                                 gpointer user_data,
+                                                 GDestroyNotify notify)
+{
+    g_return_if_fail (MM_IS_PORT_SERIAL_AT (self));
+    g_return_if_fail (!fn || command);
+
+    if (self->priv->intermediate_line_notify)
+        self->priv->intermediate_line_notify (self->priv->intermediate_line_user_data);
+
+    if (self->priv->intermediate_line_command) {
+        g_byte_array_unref (self->priv->intermediate_line_command);
+        self->priv->intermediate_line_command = NULL;
+    }
+
+    /* Built exactly as mm_port_serial_at_command() would, so that it can be
+     * matched against the command being written */
+    if (fn)
+        self->priv->intermediate_line_command =
+            at_command_to_byte_array (command,
+                                      FALSE,
+                                      (mm_port_get_subsys (MM_PORT (self)) == MM_PORT_SUBSYS_TTY ?
+                                       self->priv->send_lf :
+                                       TRUE));
+
+    /* Not active until the command is processed */
+    self->priv->intermediate_line_active = FALSE;
+    self->priv->intermediate_line_fn = fn;
+    self->priv->intermediate_line_user_data = user_data;
+    self->priv->intermediate_line_notify = notify;
+}
+
+static void
+command_started (MMPortSerial *port,
+                 const GByteArray *command)
+{
+    MMPortSerialAt *self = MM_PORT_SERIAL_AT (port);
+    GByteArray *expected;
+
+    expected = self->priv->intermediate_line_command;
+    self->priv->intermediate_line_active = (expected &&
+                                            expected->len == command->len &&
+                                            !memcmp (expected->data, command->data, command->len));
+}
+
+static void
+process_intermediate_lines (MMPortSerialAt *self,
+                            GByteArray *response)
+{
+    guint start = 0;
+
+    while (start < response->len) {
+        guint line_start;
+        guint i;
+        gchar *line;
+        gboolean consumed;
+
+        /* Skip line separators */
+        line_start = start;
+        while (line_start < response->len &&
+               (response->data[line_start] == '\r' || response->data[line_start] == '\n'))
+            line_start++;
+
+        /* Look for the end of the line; lines not fully received yet are left
+         * in the buffer until more data arrives */
+        for (i = line_start; (i + 1) < response->len; i++) {
+            if (response->data[i] == '\r' && response->data[i + 1] == '\n')
+                break;
+        }
+        if ((i + 1) >= response->len)
+            break;
+
+        line = g_strndup ((const gchar *) &response->data[line_start], i - line_start);
+        consumed = self->priv->intermediate_line_fn (self, line, self->priv->intermediate_line_user_data);
+        g_free (line);
+
+        /* Stop as soon as the handler doesn't want a line, the remaining
+         * contents are processed as the final response */
+        if (!consumed)
+            break;
+        start = i + 2;
+    }
+
+    if (start > 0)
+        g_byte_array_remove_range (response, 0, start);
+}
+
 void
 mm_port_serial_at_remove_echo (GByteArray *response)
 {
@@ -133,6 +235,11 @@ parse_response (MMPortSerial *port,
     if (self->priv->remove_echo)
         mm_port_serial_at_remove_echo (response);
 
+    /* Hand out complete intermediate lines as soon as they're received, if
+     * requested; they won't be part of the final response */
+    if (self->priv->intermediate_line_active)
+        process_intermediate_lines (self, response);
+
     /* If there's no response to receive, we're done; e.g. if we only got
      * unsolicited messages */
     if (!response->len)
@@ -155,6 +262,9 @@ parse_response (MMPortSerial *port,
         return MM_PORT_SERIAL_RESPONSE_NONE;
     }
 
+    /* The command is over, no more intermediate lines for it */
+    self->priv->intermediate_line_active = FALSE;
+
     /* If we got an error, propagate it without any further response string */
     if (inner_error) {
         g_string_free (string, TRUE);
@@ -630,6 +740,11 @@ finalize (GObject *object)
     if (self->priv->response_parser_notify)
         self->priv->response_parser_notify (self->priv->response_parser_user_data);
 
+    if (self->priv->intermediate_line_notify)
+        self->priv->intermediate_line_notify (self->priv->intermediate_line_user_data);
+    if (self->priv->intermediate_line_command)
+        g_byte_array_unref (self->priv->intermediate_line_command);
+
     g_strfreev (self->priv->init_sequence);
 
     G_OBJECT_CLASS (mm_port_serial_at_parent_class)->finalize (object);
@@ -651,6 +766,7 @@ mm_port_serial_at_class_init (MMPortSerialAtClass *klass)
     serial_class->parse_unsolicited = parse_unsolicited;
     serial_class->parse_response = parse_response;
     serial_class->debug_log = debug_log;
+    serial_class->command_started = command_started;
     serial_class->config = config;
 
     g_object_class_install_property
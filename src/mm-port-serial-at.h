@@ -58,6 +58,15 @@ typedef gboolean (*MMPortSerialAtResponseParserFn) (gpointer   user_data,
                                                     gpointer   log_object,
                                                     GError   **error);
 
+/* Handler for intermediate response lines of a given command, given as soon
+ * as they're fully received and before the final response is available. The
+ * handler is only active while that command is the one being processed.
+ * Returns TRUE if the line was consumed, FALSE to leave it (and all lines
+ * after it) in the response. */
+typedef gboolean (*MMPortSerialAtIntermediateLineFn) (MMPortSerialAt *port,
+                                                      const gchar    *line,
+                                                      gpointer        user_data);
+
 typedef void (*MMPortSerialAtUnsolicitedMsgFn) (MMPortSerialAt *port,
                                                 GMatchInfo *match_info,
                                                 gpointer user_data);
@@ -96,6 +105,12 @@ void     mm_port_serial_at_set_response_parser (MMPortSerialAt *self,
                                                 gpointer user_data,
                                                 GDestroyNotify notify);
 
+void     mm_port_serial_at_set_intermediate_line_handler (MMPortSerialAt *self,
+                                                          const gchar *command,
+                                                          MMPortSerialAtIntermediateLineFn fn,
+                                                          gpointer user_data,
+                                                          GDestroyNotify notify);
+
 void         mm_port_serial_at_command        (MMPortSerialAt *self,
                                                const char *command,
                                                guint32 timeout_seconds,
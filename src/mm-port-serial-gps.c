@@ -29,8 +29,7 @@ struct _MMPortSerialGpsPrivate {
     gpointer user_data;
     GDestroyNotify notify;
 
-    /* Regex for all known traces */
-    GRegex *known_traces_regex;
+    MMNmeaFramerStats stats;
 };
 
 /*****************************************************************************/
@@ -53,19 +52,23 @@ mm_port_serial_gps_add_trace_handler (MMPortSerialGps *self,
 
 /*****************************************************************************/
 
-static gboolean
-remove_eval_cb (const GMatchInfo *match_info,
-                GString *result,
-                gpointer user_data)
+const MMNmeaFramerStats *
+mm_port_serial_gps_peek_stats (MMPortSerialGps *self)
 {
-    int *result_len = (int *) user_data;
-    int start;
-    int end;
+    g_return_val_if_fail (MM_IS_PORT_SERIAL_GPS (self), NULL);
 
-    if (g_match_info_fetch_pos  (match_info, 0, &start, &end))
-        *result_len -= (end - start);
+    return &self->priv->stats;
+}
+
+/*****************************************************************************/
 
-    return FALSE;
+static void
+sentence_cb (const gchar     *sentence,
+             gsize            len,
+             MMPortSerialGps *self)
+{
+    if (self->priv->callback)
+        self->priv->callback (self, sentence, self->priv->user_data);
 }
 
 static MMPortSerialResponseType
@@ -75,61 +78,53 @@ parse_response (MMPortSerial *port,
                 GError **error)
 {
     MMPortSerialGps *self = MM_PORT_SERIAL_GPS (port);
-    gboolean matches;
-    GMatchInfo *match_info;
-    gchar *str;
-    gint result_len;
-    guint i;
-
-    for (i = 0; i < response->len; i++) {
-        /* If there is any content before the first $,
-         * assume it's garbage, and skip it */
-        if (response->data[i] == '$') {
-            if (i > 0)
-                g_byte_array_remove_range (response, 0, i);
-            /* else, good, we're already started with $ */
-            break;
-        }
-    }
-
-    matches = g_regex_match_full (self->priv->known_traces_regex,
-                                  (const gchar *) response->data,
-                                  response->len,
-                                  0, 0, &match_info, NULL);
-
-    if (self->priv->callback) {
-        while (g_match_info_matches (match_info)) {
-            gchar *trace;
-
-            trace = g_match_info_fetch (match_info, 0);
-            if (trace) {
-                self->priv->callback (self, trace, self->priv->user_data);
-                g_free (trace);
-            }
-            g_match_info_next (match_info, NULL);
-        }
-    }
-
-    g_match_info_free (match_info);
-
-    if (!matches)
+    guint64          n_bad_checksum;
+    guint64          n_sentences;
+    gsize            consumed;
+
+    /* Sentences are passed to the trace handler straight from the response
+     * buffer; only the incomplete one at the end, if any, is kept */
+    n_bad_checksum = self->priv->stats.n_bad_checksum;
+    n_sentences = self->priv->stats.n_sentences;
+    consumed = mm_nmea_framer_process (response->data,
+                                       response->len,
+                                       &self->priv->stats,
+                                       (MMNmeaFramerSentenceFn) sentence_cb,
+                                       self);
+    if (consumed)
+        g_byte_array_remove_range (response, 0, consumed);
+
+    if (self->priv->stats.n_bad_checksum != n_bad_checksum)
+        mm_obj_dbg (self, "%" G_GUINT64_FORMAT " NMEA sentences with wrong checksum discarded "
+                    "(%" G_GUINT64_FORMAT " valid, %" G_GUINT64_FORMAT " bytes of garbage so far)",
+                    self->priv->stats.n_bad_checksum - n_bad_checksum,
+                    self->priv->stats.n_sentences,
+                    self->priv->stats.n_garbage_bytes);
+
+    /* Some modems need a command sent through the GPS data port to start
+     * the NMEA output (e.g. MBM); there is no proper reply to it, so the
+     * first sentence received completes the command. */
+    if (self->priv->stats.n_sentences == n_sentences || !mm_port_serial_is_busy (port))
         return MM_PORT_SERIAL_RESPONSE_NONE;
 
-    /* Remove matches */
-    result_len = response->len;
-    str = g_regex_replace_eval (self->priv->known_traces_regex,
-                                (const char *) response->data,
-                                response->len,
-                                0, 0,
-                                remove_eval_cb, &result_len, NULL);
-
-    /* Cleanup response buffer */
-    g_byte_array_remove_range (response, 0, response->len);
+    *parsed_response = g_byte_array_new ();
+    return MM_PORT_SERIAL_RESPONSE_BUFFER;
+}
 
-    /* Build parsed response */
-    *parsed_response = g_byte_array_new_take ((guint8 *)str, result_len);
+/*****************************************************************************/
 
-    return TRUE;
+static void
+closing (MMPortSerial *port)
+{
+    MMPortSerialGps         *self = MM_PORT_SERIAL_GPS (port);
+    const MMNmeaFramerStats *stats;
+
+    stats = mm_port_serial_gps_peek_stats (self);
+    mm_obj_dbg (self, "NMEA sentences received so far: %" G_GUINT64_FORMAT " valid, "
+                "%" G_GUINT64_FORMAT " with wrong checksum, %" G_GUINT64_FORMAT " bytes of garbage",
+                stats->n_sentences,
+                stats->n_bad_checksum,
+                stats->n_garbage_bytes);
 }
 
 /*****************************************************************************/
@@ -186,13 +181,6 @@ mm_port_serial_gps_init (MMPortSerialGps *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
                                               MM_TYPE_PORT_SERIAL_GPS,
                                               MMPortSerialGpsPrivate);
-
-    /* We'll assume that all traces start with the dollar sign and end with \r\n */
-    self->priv->known_traces_regex =
-        g_regex_new ("\\$.*\\r\\n",
-                     G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                     0,
-                     NULL);
 }
 
 static void
@@ -203,8 +191,6 @@ finalize (GObject *object)
     if (self->priv->notify)
         self->priv->notify (self->priv->user_data);
 
-    g_regex_unref (self->priv->known_traces_regex);
-
     G_OBJECT_CLASS (mm_port_serial_gps_parent_class)->finalize (object);
 }
 
@@ -221,4 +207,5 @@ mm_port_serial_gps_class_init (MMPortSerialGpsClass *klass)
 
     serial_class->parse_response = parse_response;
     serial_class->debug_log = debug_log;
+    serial_class->closing = closing;
 }
@@ -20,6 +20,7 @@
 #include <glib-object.h>
 
 #include "mm-port-serial.h"
+#include "mm-nmea-framer.h"
 
 #define MM_TYPE_PORT_SERIAL_GPS            (mm_port_serial_gps_get_type ())
 #define MM_PORT_SERIAL_GPS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_PORT_SERIAL_GPS, MMPortSerialGps))
@@ -54,4 +55,7 @@ void mm_port_serial_gps_add_trace_handler (MMPortSerialGps *self,
                                            gpointer user_data,
                                            GDestroyNotify notify);
 
+/* Counters of the NMEA sentences received since the port was created */
+const MMNmeaFramerStats *mm_port_serial_gps_peek_stats (MMPortSerialGps *self);
+
 #endif /* MM_PORT_SERIAL_GPS_H */
@@ -27,12 +27,29 @@
 #include "libqcdm/src/utils.h"
 #include "libqcdm/src/errors.h"
 #include "libqcdm/src/dm-commands.h"
+#include "libqcdm/src/commands.h"
+#include "libqcdm/src/result.h"
 #include "mm-log-object.h"
 
 G_DEFINE_TYPE (MMPortSerialQcdm, mm_port_serial_qcdm, MM_TYPE_PORT_SERIAL)
 
+/* Items per equipment ID, as set in a log mask */
+#define LOG_ITEMS_PER_EQUIP_ID 4095
+
+/* Log config command with the largest possible mask, escaped */
+#define LOG_CONFIG_CMD_LEN ((sizeof (DMCmdLogConfig) + (LOG_ITEMS_PER_EQUIP_ID + 7) / 8 + 2) * 2 + 1)
+
+/* Largest incomplete frame kept while waiting for the rest of it */
+#define MAX_FRAME_LEN ((QCDM_LOG_STREAM_DEFAULT_MAX_PACKET_LEN + 2) * 2 + 1)
+
 struct _MMPortSerialQcdmPrivate {
     GSList *unsolicited_msg_handlers;
+    /* Dispatches log items to the enabled handlers */
+    QcdmLogStream *log_stream;
+    /* Given to every handler, reused across log items */
+    GByteArray *log_buffer;
+    /* Incomplete data dropped from the response buffer */
+    gsize n_dropped_bytes;
 };
 
 /*****************************************************************************/
@@ -72,7 +89,6 @@ find_qcdm_start (GByteArray *response, gsize *start)
 
 static MMPortSerialResponseType
 parse_qcdm (GByteArray *response,
-            gboolean want_log,
             GByteArray **parsed_response,
             GError **error)
 {
@@ -122,14 +138,6 @@ parse_qcdm (GByteArray *response,
         return MM_PORT_SERIAL_RESPONSE_NONE;
     }
 
-    if (want_log && unescaped_buffer[0] != DIAG_CMD_LOG) {
-        /* If we only want log items and this isn't one, don't remove this
-         * DM packet from the buffer.
-         */
-        g_free (unescaped_buffer);
-        return MM_PORT_SERIAL_RESPONSE_NONE;
-    }
-
     /* Successfully decapsulated the DM command. We'll build a new byte array
      * with the response, and leave the input buffer cleaned up. */
     g_assert (unescaped_len <= 1024);
@@ -149,7 +157,7 @@ parse_response (MMPortSerial *port,
                 GByteArray **parsed_response,
                 GError **error)
 {
-    return parse_qcdm (response, FALSE, parsed_response, error);
+    return parse_qcdm (response, parsed_response, error);
 }
 
 /*****************************************************************************/
@@ -229,6 +237,7 @@ debug_log (MMPortSerial *self,
 /*****************************************************************************/
 
 typedef struct {
+    MMPortSerialQcdm *self;
     guint log_code;
     MMPortSerialQcdmUnsolicitedMsgFn callback;
     gboolean enable;
@@ -243,6 +252,30 @@ unsolicited_msg_handler_cmp (MMQcdmUnsolicitedMsgHandler *handler,
     return handler->log_code - GPOINTER_TO_UINT (log_code);
 }
 
+static void
+log_item_cb (uint16_t log_code,
+             const char *packet,
+             size_t len,
+             void *user_data)
+{
+    MMQcdmUnsolicitedMsgHandler *handler = user_data;
+    GByteArray *log_buffer = handler->self->priv->log_buffer;
+
+    g_byte_array_set_size (log_buffer, 0);
+    g_byte_array_append (log_buffer, (const guint8 *) packet, len);
+    handler->callback (handler->self, log_buffer, handler->user_data);
+}
+
+static void
+update_log_stream_handler (MMPortSerialQcdm *self,
+                           MMQcdmUnsolicitedMsgHandler *handler)
+{
+    qcdm_log_stream_set_handler (self->priv->log_stream,
+                                 handler->log_code,
+                                 (handler->enable && handler->callback) ? log_item_cb : NULL,
+                                 handler);
+}
+
 void
 mm_port_serial_qcdm_add_unsolicited_msg_handler (MMPortSerialQcdm *self,
                                                  guint log_code,
@@ -267,6 +300,7 @@ mm_port_serial_qcdm_add_unsolicited_msg_handler (MMPortSerialQcdm *self,
     } else {
         handler = g_slice_new (MMQcdmUnsolicitedMsgHandler);
         self->priv->unsolicited_msg_handlers = g_slist_append (self->priv->unsolicited_msg_handlers, handler);
+        handler->self = self;
         handler->log_code = log_code;
     }
 
@@ -274,6 +308,7 @@ mm_port_serial_qcdm_add_unsolicited_msg_handler (MMPortSerialQcdm *self,
     handler->enable = TRUE;
     handler->user_data = user_data;
     handler->notify = notify;
+    update_log_stream_handler (self, handler);
 }
 
 void
@@ -293,6 +328,7 @@ mm_port_serial_qcdm_enable_unsolicited_msg_handler (MMPortSerialQcdm *self,
     if (existing) {
         handler = existing->data;
         handler->enable = enable;
+        update_log_stream_handler (self, handler);
     }
 }
 
@@ -300,35 +336,147 @@ static void
 parse_unsolicited (MMPortSerial *port, GByteArray *response)
 {
     MMPortSerialQcdm *self = MM_PORT_SERIAL_QCDM (port);
-    GByteArray *log_buffer = NULL;
-    GSList *iter;
+    const guint8 *frame;
+    const guint8 *end;
+    gsize kept = 0;
+
+    /* Log items are streamed out of the buffer in a single pass over all the
+     * complete frames; anything else is left in place, in order, for
+     * parse_response(). Log packets start with DIAG_CMD_LOG, which is never
+     * escaped, so there's no need to unescape frames to find them. */
+    frame = response->data;
+    end = response->data + response->len;
+    while (frame < end) {
+        const guint8 *control;
+        gsize frame_len;
+
+        control = memchr (frame, DIAG_CONTROL_CHAR, end - frame);
+        if (!control)
+            break;
+
+        frame_len = control + 1 - frame;
+        if (frame[0] == DIAG_CMD_LOG)
+            qcdm_log_stream_feed (self->priv->log_stream, (const char *) frame, frame_len);
+        else if (frame_len > 1) {
+            memmove (response->data + kept, frame, frame_len);
+            kept += frame_len;
+        }
+        frame = control + 1;
+    }
 
-    if (parse_qcdm (response,
-                    TRUE,
-                    &log_buffer,
-                    NULL) != MM_PORT_SERIAL_RESPONSE_BUFFER) {
-        return;
+    /* Keep the incomplete frame, unless it's already too long to be valid */
+    if (frame < end) {
+        gsize incomplete_len = end - frame;
+
+        if (incomplete_len > MAX_FRAME_LEN)
+            self->priv->n_dropped_bytes += incomplete_len;
+        else {
+            memmove (response->data + kept, frame, incomplete_len);
+            kept += incomplete_len;
+        }
     }
 
-    /* These should be guaranteed by parse_qcdm() */
-    g_return_if_fail (log_buffer);
-    g_return_if_fail (log_buffer->len > 0);
-    g_return_if_fail (log_buffer->data[0] == DIAG_CMD_LOG);
+    g_byte_array_set_size (response, kept);
+}
+
+void
+mm_port_serial_qcdm_get_log_stats (MMPortSerialQcdm *self,
+                                   QcdmLogStreamStats *out_stats)
+{
+    g_return_if_fail (MM_IS_PORT_SERIAL_QCDM (self));
+    g_return_if_fail (out_stats != NULL);
+
+    qcdm_log_stream_get_stats (self->priv->log_stream, out_stats);
+    out_stats->n_dropped_bytes += self->priv->n_dropped_bytes;
+}
 
-    if (log_buffer->len < sizeof (DMCmdLog))
+/*****************************************************************************/
+
+gboolean
+mm_port_serial_qcdm_set_log_mask_finish (MMPortSerialQcdm *self,
+                                         GAsyncResult *res,
+                                         GError **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+log_config_set_mask_ready (MMPortSerialQcdm *self,
+                           GAsyncResult *res,
+                           GTask *task)
+{
+    QcdmResult *result;
+    GByteArray *response;
+    GError *error = NULL;
+    gint err = QCDM_SUCCESS;
+
+    response = mm_port_serial_qcdm_command_finish (self, res, &error);
+    if (!response) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
         return;
+    }
 
-    for (iter = self->priv->unsolicited_msg_handlers; iter; iter = iter->next) {
-        MMQcdmUnsolicitedMsgHandler *handler = (MMQcdmUnsolicitedMsgHandler *) iter->data;
-        DMCmdLog *log_cmd = (DMCmdLog *) log_buffer->data;
+    result = qcdm_cmd_log_config_set_mask_result ((const gchar *) response->data,
+                                                  response->len,
+                                                  &err);
+    g_byte_array_unref (response);
+    if (!result) {
+        g_task_return_new_error (task,
+                                 MM_CORE_ERROR,
+                                 MM_CORE_ERROR_FAILED,
+                                 "Failed to parse Log Config Set Mask command result: %d",
+                                 err);
+        g_object_unref (task);
+        return;
+    }
 
-        if (!handler->enable)
-            continue;
-        if (handler->log_code != le16toh (log_cmd->log_code))
-            continue;
-        if (handler->callback)
-            handler->callback (self, log_buffer, handler->user_data);
+    qcdm_result_unref (result);
+    g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
+void
+mm_port_serial_qcdm_set_log_mask (MMPortSerialQcdm *self,
+                                  guint8 equip_id,
+                                  gboolean enable,
+                                  GCancellable *cancellable,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data)
+{
+    GTask *task;
+    GByteArray *logcmd;
+    uint16_t *log_items = NULL;
+
+    g_return_if_fail (MM_IS_PORT_SERIAL_QCDM (self));
+    g_return_if_fail (equip_id <= 0x0F);
+
+    task = g_task_new (self, cancellable, callback, user_data);
+
+    /* Request just the items with an enabled handler */
+    if (enable) {
+        log_items = g_new (uint16_t, LOG_ITEMS_PER_EQUIP_ID + 1);
+        qcdm_log_stream_get_codes (self->priv->log_stream,
+                                   equip_id,
+                                   log_items,
+                                   LOG_ITEMS_PER_EQUIP_ID + 1);
     }
+
+    logcmd = g_byte_array_sized_new (LOG_CONFIG_CMD_LEN);
+    logcmd->len = qcdm_cmd_log_config_set_mask_new ((char *) logcmd->data,
+                                                    LOG_CONFIG_CMD_LEN,
+                                                    equip_id,
+                                                    log_items);
+    g_free (log_items);
+    g_assert (logcmd->len);
+
+    mm_port_serial_qcdm_command (self,
+                                 logcmd,
+                                 5,
+                                 cancellable,
+                                 (GAsyncReadyCallback)log_config_set_mask_ready,
+                                 task);
+    g_byte_array_unref (logcmd);
 }
 
 /*****************************************************************************/
@@ -382,6 +530,8 @@ static void
 mm_port_serial_qcdm_init (MMPortSerialQcdm *self)
 {
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_PORT_SERIAL_QCDM, MMPortSerialQcdmPrivate);
+    self->priv->log_stream = qcdm_log_stream_new (QCDM_LOG_STREAM_DEFAULT_MAX_PACKET_LEN);
+    self->priv->log_buffer = g_byte_array_sized_new (QCDM_LOG_STREAM_DEFAULT_MAX_PACKET_LEN);
 }
 
 static void
@@ -400,6 +550,9 @@ finalize (GObject *object)
                                                                     self->priv->unsolicited_msg_handlers);
     }
 
+    qcdm_log_stream_free (self->priv->log_stream);
+    g_byte_array_unref (self->priv->log_buffer);
+
     G_OBJECT_CLASS (mm_port_serial_qcdm_parent_class)->finalize (object);
 }
 
@@ -21,6 +21,7 @@
 #include <glib-object.h>
 
 #include "mm-port-serial.h"
+#include "libqcdm/src/log-stream.h"
 
 #define MM_TYPE_PORT_SERIAL_QCDM            (mm_port_serial_qcdm_get_type ())
 #define MM_PORT_SERIAL_QCDM(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_PORT_SERIAL_QCDM, MMPortSerialQcdm))
@@ -57,6 +58,8 @@ GByteArray *mm_port_serial_qcdm_command_finish (MMPortSerialQcdm *self,
                                                 GAsyncResult *res,
                                                 GError **error);
 
+/* 'log_buffer' holds the whole DIAG log packet and is only valid during the
+ * call, it is reused for the next log item. */
 typedef void (*MMPortSerialQcdmUnsolicitedMsgFn) (MMPortSerialQcdm *port,
                                                   GByteArray *log_buffer,
                                                   gpointer user_data);
@@ -71,4 +74,19 @@ void     mm_port_serial_qcdm_enable_unsolicited_msg_handler (MMPortSerialQcdm *s
                                                              guint log_code,
                                                              gboolean enable);
 
+/* Requests from the device the log items of the given equipment ID which
+ * have an enabled handler, or none if 'enable' is FALSE. */
+void     mm_port_serial_qcdm_set_log_mask        (MMPortSerialQcdm *self,
+                                                  guint8 equip_id,
+                                                  gboolean enable,
+                                                  GCancellable *cancellable,
+                                                  GAsyncReadyCallback callback,
+                                                  gpointer user_data);
+gboolean mm_port_serial_qcdm_set_log_mask_finish (MMPortSerialQcdm *self,
+                                                  GAsyncResult *res,
+                                                  GError **error);
+
+void     mm_port_serial_qcdm_get_log_stats (MMPortSerialQcdm *self,
+                                            QcdmLogStreamStats *out_stats);
+
 #endif /* MM_PORT_SERIAL_QCDM_H */
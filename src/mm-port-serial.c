@@ -113,6 +113,9 @@ struct _MMPortSerialPrivate {
 
     GTask *flash_task;
     GTask *reopen_task;
+
+    /* Binary capture of the port traffic, if enabled */
+    MMPortCapture *capture;
 };
 
 /*****************************************************************************/
@@ -524,6 +527,20 @@ real_config_fd (MMPortSerial *self, int fd, GError **error)
     return internal_tcsetattr (self, fd, &stbuf, error);
 }
 
+static void
+serial_capture (MMPortSerial           *self,
+                MMPortCaptureDirection  direction,
+                const guint8           *buf,
+                gsize                   len)
+{
+    if (self->priv->capture)
+        mm_port_capture_write (self->priv->capture,
+                               mm_port_get_device (MM_PORT (self)),
+                               direction,
+                               buf,
+                               len);
+}
+
 static void
 serial_debug (MMPortSerial *self,
               const gchar  *prefix,
@@ -560,6 +577,9 @@ port_serial_process_command (MMPortSerial *self,
     /* Only print command the first time */
     if (ctx->started == FALSE) {
         ctx->started = TRUE;
+        if (MM_PORT_SERIAL_GET_CLASS (self)->command_started)
+            MM_PORT_SERIAL_GET_CLASS (self)->command_started (self, ctx->command);
+        serial_capture (self, MM_PORT_CAPTURE_DIRECTION_OUT, ctx->command->data, ctx->command->len);
         serial_debug (self, "-->", (const gchar *) ctx->command->data, ctx->command->len);
     }
 
@@ -987,6 +1007,9 @@ common_input_available (MMPortSerial *self,
                     mm_obj_warn (self, "read error: %s", error->message);
                 g_clear_error (&error);
             } else {
+                /* Captured before NULs are escaped */
+                serial_capture (self, MM_PORT_CAPTURE_DIRECTION_IN, (const guint8 *) buf, bytes_read);
+
                 /* convert NULs to "\\0" */
                 if (bytes_read > 0) {
                     data_len = bytes_read;
@@ -1028,6 +1051,7 @@ common_input_available (MMPortSerial *self,
             } else {
                 bytes_read = (gsize) sbytes_read;
                 status = G_IO_STATUS_NORMAL;
+                serial_capture (self, MM_PORT_CAPTURE_DIRECTION_IN, (const guint8 *) buf, bytes_read);
             }
         }
 
@@ -1366,6 +1390,15 @@ mm_port_serial_is_open (MMPortSerial *self)
     return !!self->priv->open_count;
 }
 
+gboolean
+mm_port_serial_is_busy (MMPortSerial *self)
+{
+    g_return_val_if_fail (MM_IS_PORT_SERIAL (self), FALSE);
+
+    /* Either a command is in flight or some are waiting to be sent */
+    return !g_queue_is_empty (self->priv->queue);
+}
+
 static void
 _close_internal (MMPortSerial *self, gboolean force)
 {
@@ -1401,6 +1434,9 @@ _close_internal (MMPortSerial *self, gboolean force)
 
         mm_obj_dbg (self, "closing serial port...");
 
+        if (MM_PORT_SERIAL_GET_CLASS (self)->closing)
+            MM_PORT_SERIAL_GET_CLASS (self)->closing (self);
+
         mm_port_set_connected (MM_PORT (self), FALSE);
 
         g_get_current_time (&tv_start);
@@ -1915,6 +1951,15 @@ mm_port_serial_get_flow_control (MMPortSerial *self)
     return self->priv->flow_control;
 }
 
+void
+mm_port_serial_set_capture (MMPortSerial  *self,
+                            MMPortCapture *capture)
+{
+    g_clear_pointer (&self->priv->capture, mm_port_capture_unref);
+    if (capture)
+        self->priv->capture = mm_port_capture_ref (capture);
+}
+
 /*****************************************************************************/
 
 MMPortSerial *
@@ -2095,6 +2140,7 @@ finalize (GObject *object)
     g_hash_table_destroy (self->priv->reply_cache);
     g_byte_array_unref (self->priv->response);
     g_queue_free (self->priv->queue);
+    g_clear_pointer (&self->priv->capture, mm_port_capture_unref);
 
     G_OBJECT_CLASS (mm_port_serial_parent_class)->finalize (object);
 }
@@ -23,6 +23,7 @@
 
 #include "mm-modem-helpers.h"
 #include "mm-port.h"
+#include "mm-port-capture.h"
 
 #define MM_TYPE_PORT_SERIAL            (mm_port_serial_get_type ())
 #define MM_PORT_SERIAL(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_PORT_SERIAL, MMPortSerial))
@@ -100,6 +101,15 @@ struct _MMPortSerialClass {
                                    const gchar  *buf,
                                    gsize         len);
 
+    /* Called when a queued command becomes the head of the queue and is
+     * about to be written to the port. */
+    void (*command_started)       (MMPortSerial     *self,
+                                   const GByteArray *command);
+
+    /* Called when the port is about to be closed, once the open count
+     * drops to zero. */
+    void (*closing)               (MMPortSerial *self);
+
     /* Signals */
     void (*buffer_full)           (MMPortSerial *port, const GByteArray *buffer);
     void (*timed_out)             (MMPortSerial *port, guint n_consecutive_replies);
@@ -116,6 +126,9 @@ MMPortSerial *mm_port_serial_new (const char *name, MMPortType ptype);
 
 gboolean mm_port_serial_is_open           (MMPortSerial *self);
 
+/* TRUE if there are commands queued or in flight */
+gboolean mm_port_serial_is_busy           (MMPortSerial *self);
+
 gboolean mm_port_serial_open              (MMPortSerial *self,
                                            GError  **error);
 
@@ -157,4 +170,8 @@ gboolean mm_port_serial_set_flow_control (MMPortSerial   *self,
                                           GError        **error);
 
 MMFlowControl mm_port_serial_get_flow_control (MMPortSerial *self);
+
+/* Records all the traffic of the port in @capture, or stops if NULL */
+void mm_port_serial_set_capture (MMPortSerial  *self,
+                                 MMPortCapture *capture);
 #endif /* MM_PORT_SERIAL_H */
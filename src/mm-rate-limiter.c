@@ -0,0 +1,97 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include "mm-rate-limiter.h"
+
+struct _MMRateLimiter {
+    guint    interval_ms;
+    guint    pending;
+    gint64   last_sent;
+    gboolean scheduled;
+};
+
+/*****************************************************************************/
+
+guint
+mm_rate_limiter_set_interval (MMRateLimiter *self,
+                              guint          interval_ms)
+{
+    self->interval_ms = MAX (interval_ms, MM_RATE_LIMITER_MIN_INTERVAL_MS);
+    return self->interval_ms;
+}
+
+MMRateLimiterAction
+mm_rate_limiter_push (MMRateLimiter *self,
+                      guint          changed,
+                      gint64         now,
+                      guint         *delay_ms)
+{
+    gint64 elapsed_ms;
+
+    if (!changed)
+        return MM_RATE_LIMITER_ACTION_NONE;
+
+    self->pending |= changed;
+
+    /* Already waiting for the interval to expire */
+    if (self->scheduled)
+        return MM_RATE_LIMITER_ACTION_NONE;
+
+    elapsed_ms = (now - self->last_sent) / 1000;
+    if (!self->last_sent || elapsed_ms >= self->interval_ms)
+        return MM_RATE_LIMITER_ACTION_SEND;
+
+    self->scheduled = TRUE;
+    *delay_ms = (guint) (self->interval_ms - elapsed_ms);
+    return MM_RATE_LIMITER_ACTION_SCHEDULE;
+}
+
+guint
+mm_rate_limiter_take (MMRateLimiter *self,
+                      gint64         now)
+{
+    guint pending;
+
+    pending = self->pending;
+    self->pending = 0;
+    self->scheduled = FALSE;
+    self->last_sent = now;
+    return pending;
+}
+
+void
+mm_rate_limiter_filter (MMRateLimiter *self,
+                        guint          mask)
+{
+    self->pending &= mask;
+}
+
+/*****************************************************************************/
+
+MMRateLimiter *
+mm_rate_limiter_new (guint interval_ms)
+{
+    MMRateLimiter *self;
+
+    self = g_slice_new0 (MMRateLimiter);
+    mm_rate_limiter_set_interval (self, interval_ms);
+    return self;
+}
+
+void
+mm_rate_limiter_free (MMRateLimiter *self)
+{
+    g_slice_free (MMRateLimiter, self);
+}
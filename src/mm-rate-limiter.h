@@ -0,0 +1,58 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_RATE_LIMITER_H
+#define MM_RATE_LIMITER_H
+
+#include <glib.h>
+
+/* Merges change bitmasks so that they are sent at most once per interval.
+ * The limiter doesn't own any timer; the caller arms one when asked to and
+ * calls mm_rate_limiter_take() when it fires. Times are monotonic, in
+ * microseconds. */
+
+#define MM_RATE_LIMITER_MIN_INTERVAL_MS 1000
+
+typedef struct _MMRateLimiter MMRateLimiter;
+
+typedef enum {
+    MM_RATE_LIMITER_ACTION_NONE,
+    MM_RATE_LIMITER_ACTION_SEND,
+    MM_RATE_LIMITER_ACTION_SCHEDULE,
+} MMRateLimiterAction;
+
+MMRateLimiter       *mm_rate_limiter_new          (guint          interval_ms);
+void                 mm_rate_limiter_free         (MMRateLimiter *self);
+
+/* Intervals below MM_RATE_LIMITER_MIN_INTERVAL_MS are raised to it. Returns
+ * the interval in effect. */
+guint                mm_rate_limiter_set_interval (MMRateLimiter *self,
+                                                   guint          interval_ms);
+
+/* Records @changed. Returns SEND if the changes must be taken right away,
+ * SCHEDULE if a timer must be armed to take them after @delay_ms, or NONE
+ * if nothing changed or a timer is already armed. */
+MMRateLimiterAction  mm_rate_limiter_push         (MMRateLimiter *self,
+                                                   guint          changed,
+                                                   gint64         now,
+                                                   guint         *delay_ms);
+
+/* Returns and clears the pending changes, starting a new interval */
+guint                mm_rate_limiter_take         (MMRateLimiter *self,
+                                                   gint64         now);
+
+/* Drops pending changes not in @mask */
+void                 mm_rate_limiter_filter       (MMRateLimiter *self,
+                                                   guint          mask);
+
+#endif /* MM_RATE_LIMITER_H */
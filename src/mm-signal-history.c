@@ -0,0 +1,309 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+#include <math.h>
+
+#include "mm-signal-history.h"
+
+typedef enum {
+    FIELD_RSSI,
+    FIELD_RSCP,
+    FIELD_ECIO,
+    FIELD_SINR,
+    FIELD_IO,
+    FIELD_RSRQ,
+    FIELD_RSRP,
+    FIELD_SNR,
+    N_FIELDS
+} Field;
+
+typedef struct {
+    guint64 timestamp;
+    guint32 access_technology;
+    /* NAN if unknown */
+    gfloat  values[N_FIELDS];
+} Sample;
+
+struct _MMSignalHistory {
+    Sample *samples;
+    guint   size;
+    /* Index of the oldest sample */
+    guint   first;
+    guint   n;
+};
+
+#define SAMPLE_AT(self, i) (&(self)->samples[((self)->first + (i)) % (self)->size])
+
+/* Access technologies of a single sample; at most one per MMSignal
+ * property of the interface */
+#define MAX_TECHNOLOGIES 8
+
+/*****************************************************************************/
+
+static gfloat
+signal_value (gdouble value)
+{
+    return (value == MM_SIGNAL_UNKNOWN) ? NAN : (gfloat) value;
+}
+
+void
+mm_signal_history_add (MMSignalHistory         *self,
+                       guint64                  timestamp,
+                       MMModemAccessTechnology  access_technology,
+                       MMSignal                *signal)
+{
+    Sample *sample;
+
+    if (self->n < self->size) {
+        sample = SAMPLE_AT (self, self->n);
+        self->n++;
+    } else {
+        /* Full, overwrite the oldest one */
+        sample = SAMPLE_AT (self, 0);
+        self->first = (self->first + 1) % self->size;
+    }
+
+    sample->timestamp = timestamp;
+    sample->access_technology = (guint32) access_technology;
+    sample->values[FIELD_RSSI] = signal_value (mm_signal_get_rssi (signal));
+    sample->values[FIELD_RSCP] = signal_value (mm_signal_get_rscp (signal));
+    sample->values[FIELD_ECIO] = signal_value (mm_signal_get_ecio (signal));
+    sample->values[FIELD_SINR] = signal_value (mm_signal_get_sinr (signal));
+    sample->values[FIELD_IO]   = signal_value (mm_signal_get_io   (signal));
+    sample->values[FIELD_RSRQ] = signal_value (mm_signal_get_rsrq (signal));
+    sample->values[FIELD_RSRP] = signal_value (mm_signal_get_rsrp (signal));
+    sample->values[FIELD_SNR]  = signal_value (mm_signal_get_snr  (signal));
+}
+
+void
+mm_signal_history_clear (MMSignalHistory *self)
+{
+    self->first = 0;
+    self->n = 0;
+}
+
+guint
+mm_signal_history_get_n_samples (MMSignalHistory *self)
+{
+    return self->n;
+}
+
+/*****************************************************************************/
+
+static void
+builder_add (GVariantBuilder *builder,
+             guint64          timestamp,
+             guint32          access_technology,
+             const gdouble   *values)
+{
+    g_variant_builder_add (builder, MM_SIGNAL_HISTORY_SAMPLE_SIGNATURE,
+                           timestamp,
+                           access_technology,
+                           values[FIELD_RSSI],
+                           values[FIELD_RSCP],
+                           values[FIELD_ECIO],
+                           values[FIELD_SINR],
+                           values[FIELD_IO],
+                           values[FIELD_RSRQ],
+                           values[FIELD_RSRP],
+                           values[FIELD_SNR]);
+}
+
+static void
+builder_add_sample (GVariantBuilder *builder,
+                    const Sample    *sample)
+{
+    gdouble values[N_FIELDS];
+    guint   i;
+
+    for (i = 0; i < N_FIELDS; i++)
+        values[i] = sample->values[i];
+    builder_add (builder, sample->timestamp, sample->access_technology, values);
+}
+
+typedef struct {
+    gboolean used;
+    guint64  timestamp;
+    guint32  access_technology;
+    gdouble  acc[N_FIELDS];
+    guint    count[N_FIELDS];
+} Bucket;
+
+static void
+build_aggregated (MMSignalHistory            *self,
+                  GVariantBuilder            *builder,
+                  guint64                     since,
+                  guint                       max,
+                  MMSignalHistoryAggregation  aggregation)
+{
+    guint32  techs[MAX_TECHNOLOGIES];
+    guint    n_techs = 0;
+    guint64  first_ts = G_MAXUINT64;
+    guint64  last_ts = 0;
+    guint64  width;
+    guint    n_buckets;
+    guint    n_used = 0;
+    Bucket  *buckets;
+    guint    i;
+    guint    j;
+
+    /* Technologies and time span of the samples in range */
+    for (i = 0; i < self->n; i++) {
+        const Sample *sample = SAMPLE_AT (self, i);
+
+        if (sample->timestamp < since)
+            continue;
+        first_ts = MIN (first_ts, sample->timestamp);
+        last_ts = MAX (last_ts, sample->timestamp);
+        for (j = 0; j < n_techs && techs[j] != sample->access_technology; j++);
+        if (j == n_techs && n_techs < MAX_TECHNOLOGIES)
+            techs[n_techs++] = sample->access_technology;
+    }
+    g_assert (n_techs > 0);
+
+    /* Each technology gets the same number of time buckets */
+    n_buckets = MAX (max / n_techs, 1);
+    width = (last_ts - first_ts) / n_buckets + 1;
+    buckets = g_new0 (Bucket, n_buckets * n_techs);
+
+    for (i = 0; i < self->n; i++) {
+        const Sample *sample = SAMPLE_AT (self, i);
+        Bucket       *bucket;
+        guint         k;
+
+        if (sample->timestamp < since)
+            continue;
+        for (j = 0; j < n_techs && techs[j] != sample->access_technology; j++);
+        if (j == n_techs)
+            continue;
+
+        bucket = &buckets[((sample->timestamp - first_ts) / width) * n_techs + j];
+        if (!bucket->used) {
+            bucket->used = TRUE;
+            bucket->timestamp = sample->timestamp;
+            bucket->access_technology = sample->access_technology;
+            n_used++;
+        }
+
+        for (k = 0; k < N_FIELDS; k++) {
+            gdouble value = sample->values[k];
+
+            if (isnan (value))
+                continue;
+            switch (aggregation) {
+            case MM_SIGNAL_HISTORY_AGGREGATION_MIN:
+                if (!bucket->count[k] || value < bucket->acc[k])
+                    bucket->acc[k] = value;
+                break;
+            case MM_SIGNAL_HISTORY_AGGREGATION_MAX:
+                if (!bucket->count[k] || value > bucket->acc[k])
+                    bucket->acc[k] = value;
+                break;
+            case MM_SIGNAL_HISTORY_AGGREGATION_MEAN:
+            case MM_SIGNAL_HISTORY_AGGREGATION_NONE:
+            default:
+                bucket->acc[k] += value;
+                break;
+            }
+            bucket->count[k]++;
+        }
+    }
+
+    /* If there are more technologies than allowed samples, only the most
+     * recent buckets are reported */
+    for (i = 0; i < n_buckets * n_techs; i++) {
+        Bucket  *bucket = &buckets[i];
+        gdouble  values[N_FIELDS];
+        guint    k;
+
+        if (!bucket->used)
+            continue;
+        if (n_used-- > max)
+            continue;
+
+        for (k = 0; k < N_FIELDS; k++) {
+            if (!bucket->count[k])
+                values[k] = NAN;
+            else if (aggregation == MM_SIGNAL_HISTORY_AGGREGATION_MEAN)
+                values[k] = bucket->acc[k] / bucket->count[k];
+            else
+                values[k] = bucket->acc[k];
+        }
+        builder_add (builder, bucket->timestamp, bucket->access_technology, values);
+    }
+
+    g_free (buckets);
+}
+
+GVariant *
+mm_signal_history_build (MMSignalHistory            *self,
+                         guint64                     since,
+                         guint                       max,
+                         MMSignalHistoryAggregation  aggregation)
+{
+    GVariantBuilder builder;
+    guint           n_selected = 0;
+    guint           i;
+
+    for (i = 0; i < self->n; i++) {
+        if (SAMPLE_AT (self, i)->timestamp >= since)
+            n_selected++;
+    }
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a" MM_SIGNAL_HISTORY_SAMPLE_SIGNATURE));
+
+    if (max && n_selected > max && aggregation != MM_SIGNAL_HISTORY_AGGREGATION_NONE)
+        build_aggregated (self, &builder, since, max, aggregation);
+    else {
+        /* Skip the oldest ones if there are too many */
+        guint n_skip;
+
+        n_skip = (max && n_selected > max) ? (n_selected - max) : 0;
+        for (i = 0; i < self->n; i++) {
+            const Sample *sample = SAMPLE_AT (self, i);
+
+            if (sample->timestamp < since)
+                continue;
+            if (n_skip) {
+                n_skip--;
+                continue;
+            }
+            builder_add_sample (&builder, sample);
+        }
+    }
+
+    return g_variant_builder_end (&builder);
+}
+
+/*****************************************************************************/
+
+MMSignalHistory *
+mm_signal_history_new (guint size)
+{
+    MMSignalHistory *self;
+
+    g_assert (size > 0);
+
+    self = g_slice_new0 (MMSignalHistory);
+    self->size = size;
+    self->samples = g_new0 (Sample, size);
+    return self;
+}
+
+void
+mm_signal_history_free (MMSignalHistory *self)
+{
+    g_free (self->samples);
+    g_slice_free (MMSignalHistory, self);
+}
@@ -0,0 +1,59 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_SIGNAL_HISTORY_H
+#define MM_SIGNAL_HISTORY_H
+
+#include <glib.h>
+
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+/* Fixed-size ring buffer of extended signal samples. Each sample holds the
+ * values reported for one access technology at a given time. */
+
+typedef struct _MMSignalHistory MMSignalHistory;
+
+/* Values of the 'aggregation' argument of Signal.GetHistory() */
+typedef enum {
+    MM_SIGNAL_HISTORY_AGGREGATION_NONE = 0,
+    MM_SIGNAL_HISTORY_AGGREGATION_MEAN = 1,
+    MM_SIGNAL_HISTORY_AGGREGATION_MIN  = 2,
+    MM_SIGNAL_HISTORY_AGGREGATION_MAX  = 3,
+} MMSignalHistoryAggregation;
+
+/* D-Bus signature of the history built by mm_signal_history_build():
+ * timestamp, access technology, rssi, rscp, ecio, sinr, io, rsrq, rsrp, snr */
+#define MM_SIGNAL_HISTORY_SAMPLE_SIGNATURE "(tudddddddd)"
+
+MMSignalHistory *mm_signal_history_new           (guint                       size);
+void             mm_signal_history_free          (MMSignalHistory            *self);
+
+void             mm_signal_history_clear         (MMSignalHistory            *self);
+guint            mm_signal_history_get_n_samples (MMSignalHistory            *self);
+
+void             mm_signal_history_add           (MMSignalHistory            *self,
+                                                  guint64                     timestamp,
+                                                  MMModemAccessTechnology     access_technology,
+                                                  MMSignal                   *signal);
+
+/* Builds an array of samples taken at or after @since, oldest first. If
+ * there are more than @max (0 for no limit), either the most recent ones are
+ * returned (NONE) or consecutive samples of each technology are merged into
+ * time buckets. */
+GVariant        *mm_signal_history_build         (MMSignalHistory            *self,
+                                                  guint64                     since,
+                                                  guint                       max,
+                                                  MMSignalHistoryAggregation  aggregation);
+
+#endif /* MM_SIGNAL_HISTORY_H */
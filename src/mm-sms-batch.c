@@ -0,0 +1,195 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include <ModemManager.h>
+
+#include "mm-sms-batch.h"
+
+typedef struct {
+    MMSmsProperties *properties;
+    gpointer         prepared;
+    gboolean         sent;
+    guint            message_reference;
+    gchar           *error_message;
+} BatchItem;
+
+struct _MMSmsBatch {
+    GArray         *items;
+    GDestroyNotify  prepared_free;
+};
+
+/*****************************************************************************/
+
+static void
+item_drop_prepared (MMSmsBatch *self,
+                    BatchItem  *item)
+{
+    if (item->prepared && self->prepared_free)
+        self->prepared_free (item->prepared);
+    item->prepared = NULL;
+}
+
+guint
+mm_sms_batch_get_n_messages (MMSmsBatch *self)
+{
+    return self->items->len;
+}
+
+guint
+mm_sms_batch_prepare (MMSmsBatch            *self,
+                      MMSmsBatchPrepareFunc  prepare,
+                      GDestroyNotify         prepared_free,
+                      gpointer               user_data)
+{
+    guint i;
+    guint n_prepared = 0;
+
+    g_assert (!self->prepared_free);
+    self->prepared_free = prepared_free;
+
+    for (i = 0; i < self->items->len; i++) {
+        BatchItem *item;
+        GError    *error = NULL;
+
+        item = &g_array_index (self->items, BatchItem, i);
+        if (!item->properties)
+            continue;
+
+        item->prepared = prepare (item->properties, user_data, &error);
+        if (item->prepared)
+            n_prepared++;
+        else {
+            item->error_message = g_strdup (error->message);
+            g_error_free (error);
+        }
+
+        /* Not needed any more once prepared */
+        g_clear_object (&item->properties);
+    }
+
+    return n_prepared;
+}
+
+gpointer
+mm_sms_batch_peek_prepared (MMSmsBatch *self,
+                            guint       i)
+{
+    g_assert (i < self->items->len);
+    return g_array_index (self->items, BatchItem, i).prepared;
+}
+
+void
+mm_sms_batch_complete (MMSmsBatch   *self,
+                       guint         i,
+                       guint         message_reference,
+                       const GError *error)
+{
+    BatchItem *item;
+
+    g_assert (i < self->items->len);
+    item = &g_array_index (self->items, BatchItem, i);
+
+    item_drop_prepared (self, item);
+    if (error) {
+        g_free (item->error_message);
+        item->error_message = g_strdup (error->message);
+        return;
+    }
+
+    item->sent = TRUE;
+    item->message_reference = message_reference;
+}
+
+GVariant *
+mm_sms_batch_build_results (MMSmsBatch *self)
+{
+    GVariantBuilder builder;
+    guint           i;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(bus)"));
+    for (i = 0; i < self->items->len; i++) {
+        BatchItem *item;
+
+        item = &g_array_index (self->items, BatchItem, i);
+        g_variant_builder_add (&builder, "(bus)",
+                               item->sent,
+                               item->message_reference,
+                               item->error_message ? item->error_message : "");
+    }
+    return g_variant_builder_end (&builder);
+}
+
+/*****************************************************************************/
+
+MMSmsBatch *
+mm_sms_batch_new (GVariant  *messages,
+                  GError   **error)
+{
+    MMSmsBatch   *self;
+    GVariantIter  iter;
+    GVariant     *dictionary;
+    gsize         n_messages;
+    guint         i;
+
+    g_assert (g_variant_is_of_type (messages, G_VARIANT_TYPE ("aa{sv}")));
+
+    /* Don't build anything for requests over the limit */
+    n_messages = g_variant_n_children (messages);
+    if (n_messages > MM_SMS_BATCH_MAX_MESSAGES) {
+        g_set_error (error,
+                     MM_CORE_ERROR,
+                     MM_CORE_ERROR_TOO_MANY,
+                     "Too many messages in batch: %" G_GSIZE_FORMAT " (maximum %u)",
+                     n_messages, MM_SMS_BATCH_MAX_MESSAGES);
+        return NULL;
+    }
+
+    self = g_slice_new0 (MMSmsBatch);
+    self->items = g_array_sized_new (FALSE, TRUE, sizeof (BatchItem), (guint) n_messages);
+    g_array_set_size (self->items, (guint) n_messages);
+
+    g_variant_iter_init (&iter, messages);
+    for (i = 0; (dictionary = g_variant_iter_next_value (&iter)) != NULL; i++) {
+        BatchItem *item;
+        GError    *inner_error = NULL;
+
+        item = &g_array_index (self->items, BatchItem, i);
+        item->properties = mm_sms_properties_new_from_dictionary (dictionary, &inner_error);
+        if (!item->properties) {
+            item->error_message = g_strdup (inner_error->message);
+            g_error_free (inner_error);
+        }
+        g_variant_unref (dictionary);
+    }
+
+    return self;
+}
+
+void
+mm_sms_batch_free (MMSmsBatch *self)
+{
+    guint i;
+
+    for (i = 0; i < self->items->len; i++) {
+        BatchItem *item;
+
+        item = &g_array_index (self->items, BatchItem, i);
+        item_drop_prepared (self, item);
+        g_clear_object (&item->properties);
+        g_free (item->error_message);
+    }
+    g_array_unref (self->items);
+    g_slice_free (MMSmsBatch, self);
+}
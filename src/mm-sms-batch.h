@@ -0,0 +1,68 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_SMS_BATCH_H
+#define MM_SMS_BATCH_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+/* Per-message state of a SendBatch request: the properties parsed from the
+ * request, the message prepared to be sent, and the send result. Messages
+ * that can't be parsed or prepared are reported as failed, without stopping
+ * the rest of the batch. */
+
+#define MM_SMS_BATCH_MAX_MESSAGES 64
+
+typedef struct _MMSmsBatch MMSmsBatch;
+
+/* Prepares a message to be sent, e.g. creates its PDUs. Returns the
+ * prepared message, or NULL and sets @error */
+typedef gpointer (* MMSmsBatchPrepareFunc) (MMSmsProperties  *properties,
+                                            gpointer          user_data,
+                                            GError          **error);
+
+/* Parses the aa{sv} list of message properties. Fails with
+ * MM_CORE_ERROR_TOO_MANY if there are more than MM_SMS_BATCH_MAX_MESSAGES. */
+MMSmsBatch *mm_sms_batch_new             (GVariant              *messages,
+                                          GError               **error);
+void        mm_sms_batch_free            (MMSmsBatch            *self);
+
+guint       mm_sms_batch_get_n_messages  (MMSmsBatch            *self);
+
+/* Prepares all the messages that could be parsed, before any of them is
+ * sent. Returns the number of messages ready to be sent. */
+guint       mm_sms_batch_prepare         (MMSmsBatch            *self,
+                                          MMSmsBatchPrepareFunc  prepare,
+                                          GDestroyNotify         prepared_free,
+                                          gpointer               user_data);
+
+/* Returns the prepared message at @i, or NULL if it failed or was already
+ * completed */
+gpointer    mm_sms_batch_peek_prepared   (MMSmsBatch            *self,
+                                          guint                  i);
+
+/* Records the send result of the message at @i, and drops the prepared
+ * message. A NULL @error means the message was sent. */
+void        mm_sms_batch_complete        (MMSmsBatch            *self,
+                                          guint                  i,
+                                          guint                  message_reference,
+                                          const GError          *error);
+
+/* Returns a floating a(bus) variant with one result per message */
+GVariant   *mm_sms_batch_build_results   (MMSmsBatch            *self);
+
+#endif /* MM_SMS_BATCH_H */
@@ -27,6 +27,7 @@
 #include "mm-iface-modem-messaging.h"
 #include "mm-sms-list.h"
 #include "mm-base-sms.h"
+#include "mm-sms-multipart-tracker.h"
 #include "mm-log-object.h"
 
 static void log_object_iface_init (MMLogObjectInterface *iface);
@@ -44,17 +45,33 @@ static GParamSpec *properties[PROP_LAST];
 enum {
     SIGNAL_ADDED,
     SIGNAL_DELETED,
+    SIGNAL_MULTIPART_STATS_UPDATED,
     SIGNAL_LAST
 };
 static guint signals[SIGNAL_LAST];
 
+/* Limits applied to incomplete multipart messages being reassembled */
+#define MULTIPART_MAX_INCOMPLETE         32
+#define MULTIPART_MAX_PENDING_PARTS      128
+#define MULTIPART_EXPIRY_TIMEOUT_SEC     3600
+#define MULTIPART_EXPIRY_CHECK_SEC       60
+
 struct _MMSmsListPrivate {
     /* The owner modem */
     MMBaseModem *modem;
     /* List of sms objects */
     GList *list;
+
+    /* Incomplete multipart messages, keyed by MMBaseSms. The SMS objects
+     * are owned by the list above. */
+    MMSmsMultipartTracker *multipart;
+    guint                  multipart_expiry_id;
 };
 
+static void multipart_discard (MMSmsList   *self,
+                               MMBaseSms   *sms,
+                               const gchar *reason);
+
 /*****************************************************************************/
 
 gboolean
@@ -155,6 +172,8 @@ delete_ready (MMBaseSms *sms,
                             path,
                             (GCompareFunc)cmp_sms_by_path);
     if (l) {
+        mm_sms_multipart_tracker_remove (self->priv->multipart, l->data);
+        g_signal_emit (self, signals[SIGNAL_MULTIPART_STATS_UPDATED], 0);
         g_object_unref (MM_BASE_SMS (l->data));
         self->priv->list = g_list_delete_link (self->priv->list, l);
     }
@@ -205,6 +224,104 @@ mm_sms_list_delete_sms (MMSmsList *self,
                         task);
 }
 
+/*****************************************************************************/
+/* Multipart reassembly tracking */
+
+static gboolean
+multipart_expiry_cb (MMSmsList *self)
+{
+    GList *expired;
+    GList *l;
+    guint  n_in_flight;
+
+    expired = mm_sms_multipart_tracker_expire (self->priv->multipart, g_get_monotonic_time ());
+    for (l = expired; l; l = g_list_next (l))
+        multipart_discard (self, MM_BASE_SMS (l->data), "expired");
+    if (expired)
+        g_signal_emit (self, signals[SIGNAL_MULTIPART_STATS_UPDATED], 0);
+    g_list_free (expired);
+
+    mm_sms_multipart_tracker_get_stats (self->priv->multipart, &n_in_flight, NULL, NULL, NULL);
+    if (n_in_flight > 0)
+        return G_SOURCE_CONTINUE;
+
+    self->priv->multipart_expiry_id = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static void
+multipart_track_part (MMSmsList *self,
+                      MMBaseSms *sms,
+                      MMSmsPart *part)
+{
+    GList *evicted = NULL;
+    GList *l;
+
+    mm_sms_multipart_tracker_add_part (self->priv->multipart,
+                                       sms,
+                                       mm_sms_part_get_concat_sequence (part),
+                                       mm_sms_part_get_concat_max (part),
+                                       g_get_monotonic_time (),
+                                       &evicted);
+
+    /* The SMS object has the final word on completion */
+    if (mm_base_sms_multipart_is_complete (sms))
+        mm_sms_multipart_tracker_remove (self->priv->multipart, sms);
+    else if (!self->priv->multipart_expiry_id)
+        self->priv->multipart_expiry_id = g_timeout_add_seconds (MULTIPART_EXPIRY_CHECK_SEC,
+                                                                 (GSourceFunc)multipart_expiry_cb,
+                                                                 self);
+
+    for (l = evicted; l; l = g_list_next (l))
+        multipart_discard (self, MM_BASE_SMS (l->data), "evicted");
+    g_list_free (evicted);
+
+    g_signal_emit (self, signals[SIGNAL_MULTIPART_STATS_UPDATED], 0);
+}
+
+static void
+multipart_discard (MMSmsList   *self,
+                   MMBaseSms   *sms,
+                   const gchar *reason)
+{
+    gchar *path;
+    GList *l;
+
+    l = g_list_find (self->priv->list, sms);
+    g_assert (l);
+
+    mm_obj_dbg (self, "incomplete multipart SMS with reference '%u' %s (%u parts received)",
+                mm_base_sms_get_multipart_reference (sms),
+                reason,
+                g_list_length (mm_base_sms_get_parts (sms)));
+
+    mm_sms_multipart_tracker_remove (self->priv->multipart, sms);
+    self->priv->list = g_list_delete_link (self->priv->list, l);
+
+    /* Only the in-memory object is dropped, the parts are left untouched in
+     * the device storage, so they'll show up again the next time the
+     * storages are listed */
+    path = g_strdup (mm_base_sms_get_path (sms));
+    mm_base_sms_unexport (sms);
+    g_signal_emit (self, signals[SIGNAL_DELETED], 0, path);
+    g_free (path);
+    g_object_unref (sms);
+}
+
+void
+mm_sms_list_get_multipart_stats (MMSmsList *self,
+                                 guint     *n_in_flight,
+                                 guint     *n_pending_parts,
+                                 guint     *n_expired,
+                                 guint     *n_evicted)
+{
+    mm_sms_multipart_tracker_get_stats (self->priv->multipart,
+                                        n_in_flight,
+                                        n_pending_parts,
+                                        n_expired,
+                                        n_evicted);
+}
+
 /*****************************************************************************/
 
 void
@@ -284,7 +401,11 @@ take_multipart (MMSmsList *self,
     if (l) {
         /* Try to take the part */
         mm_obj_dbg (self, "found existing multipart SMS object with reference '%u': adding new part", concat_reference);
-        return mm_base_sms_multipart_take_part (MM_BASE_SMS (l->data), part, error);
+        sms = MM_BASE_SMS (l->data);
+        if (!mm_base_sms_multipart_take_part (sms, part, error))
+            return FALSE;
+        multipart_track_part (self, sms, part);
+        return TRUE;
     }
 
     /* Create new Multipart */
@@ -307,6 +428,7 @@ take_multipart (MMSmsList *self,
                    (state == MM_SMS_STATE_RECEIVED ||
                     state == MM_SMS_STATE_RECEIVING));
 
+    multipart_track_part (self, sms, part);
     return TRUE;
 }
 
@@ -409,7 +531,7 @@ set_property (GObject *object,
         self->priv->modem = g_value_dup_object (value);
         if (self->priv->modem) {
             /* Set owner ID */
-            mm_log_object_set_owner_id (MM_LOG_OBJECT (self), mm_log_object_get_id (MM_LOG_OBJECT (self->priv->modem)));
+            mm_log_object_set_owner (MM_LOG_OBJECT (self), MM_LOG_OBJECT (self->priv->modem));
         }
         break;
     default:
@@ -443,6 +565,9 @@ mm_sms_list_init (MMSmsList *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
                                               MM_TYPE_SMS_LIST,
                                               MMSmsListPrivate);
+    self->priv->multipart = mm_sms_multipart_tracker_new (MULTIPART_MAX_INCOMPLETE,
+                                                          MULTIPART_MAX_PENDING_PARTS,
+                                                          MULTIPART_EXPIRY_TIMEOUT_SEC * G_USEC_PER_SEC);
 }
 
 static void
@@ -450,6 +575,23 @@ dispose (GObject *object)
 {
     MMSmsList *self = MM_SMS_LIST (object);
 
+    if (self->priv->multipart_expiry_id) {
+        g_source_remove (self->priv->multipart_expiry_id);
+        self->priv->multipart_expiry_id = 0;
+    }
+    /* Only once, the modem is cleared below */
+    if (self->priv->modem) {
+        guint n_in_flight;
+        guint n_pending_parts;
+        guint n_expired;
+        guint n_evicted;
+
+        mm_sms_list_get_multipart_stats (self, &n_in_flight, &n_pending_parts, &n_expired, &n_evicted);
+        mm_obj_dbg (self, "multipart reassembly: %u in flight (%u parts), %u expired, %u evicted",
+                    n_in_flight, n_pending_parts, n_expired, n_evicted);
+    }
+    mm_sms_multipart_tracker_clear (self->priv->multipart);
+
     g_clear_object (&self->priv->modem);
     g_list_free_full (self->priv->list, g_object_unref);
     self->priv->list = NULL;
@@ -457,6 +599,16 @@ dispose (GObject *object)
     G_OBJECT_CLASS (mm_sms_list_parent_class)->dispose (object);
 }
 
+static void
+finalize (GObject *object)
+{
+    MMSmsList *self = MM_SMS_LIST (object);
+
+    mm_sms_multipart_tracker_free (self->priv->multipart);
+
+    G_OBJECT_CLASS (mm_sms_list_parent_class)->finalize (object);
+}
+
 static void
 log_object_iface_init (MMLogObjectInterface *iface)
 {
@@ -474,6 +626,7 @@ mm_sms_list_class_init (MMSmsListClass *klass)
     object_class->get_property = get_property;
     object_class->set_property = set_property;
     object_class->dispose = dispose;
+    object_class->finalize = finalize;
 
     /* Properties */
     properties[PROP_MODEM] =
@@ -502,4 +655,13 @@ mm_sms_list_class_init (MMSmsListClass *klass)
                       NULL, NULL,
                       g_cclosure_marshal_generic,
                       G_TYPE_NONE, 1, G_TYPE_STRING);
+
+    signals[SIGNAL_MULTIPART_STATS_UPDATED] =
+        g_signal_new (MM_SMS_MULTIPART_STATS_UPDATED,
+                      G_OBJECT_CLASS_TYPE (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MMSmsListClass, multipart_stats_updated),
+                      NULL, NULL,
+                      g_cclosure_marshal_generic,
+                      G_TYPE_NONE, 0);
 }
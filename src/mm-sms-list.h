@@ -37,6 +37,7 @@ typedef struct _MMSmsListPrivate MMSmsListPrivate;
 
 #define MM_SMS_ADDED     "sms-added"
 #define MM_SMS_DELETED   "sms-deleted"
+#define MM_SMS_MULTIPART_STATS_UPDATED "sms-multipart-stats-updated"
 
 struct _MMSmsList {
     GObject parent;
@@ -52,6 +53,7 @@ struct _MMSmsListClass {
                            gboolean received);
     void (*sms_deleted)   (MMSmsList *self,
                            const gchar *sms_path);
+    void (*multipart_stats_updated) (MMSmsList *self);
 };
 
 GType mm_sms_list_get_type (void);
@@ -82,6 +84,12 @@ gboolean mm_sms_list_delete_sms_finish (MMSmsList *self,
                                         GAsyncResult *res,
                                         GError **error);
 
+void mm_sms_list_get_multipart_stats (MMSmsList *self,
+                                      guint     *n_in_flight,
+                                      guint     *n_pending_parts,
+                                      guint     *n_expired,
+                                      guint     *n_evicted);
+
 gboolean mm_sms_list_has_local_multipart_reference (MMSmsList *self,
                                                     const gchar *number,
                                                     guint8 reference);
@@ -0,0 +1,220 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include "mm-sms-multipart-tracker.h"
+
+/* Concatenation sequence numbers are 8-bit values */
+#define MAX_SEQUENCE 255
+
+typedef struct {
+    gint64  last_update;
+    guint   max;
+    guint   n_parts;
+    guint32 received[(MAX_SEQUENCE + 32) / 32];
+} Entry;
+
+struct _MMSmsMultipartTracker {
+    /* key -> Entry */
+    GHashTable *entries;
+    guint       max_incomplete;
+    guint       max_pending_parts;
+    gint64      expiry_timeout;
+    guint       n_pending_parts;
+    guint       n_expired;
+    guint       n_evicted;
+};
+
+/*****************************************************************************/
+
+static void
+remove_entry (MMSmsMultipartTracker *self,
+              gpointer               key,
+              Entry                 *entry)
+{
+    g_assert (self->n_pending_parts >= entry->n_parts);
+    self->n_pending_parts -= entry->n_parts;
+    g_hash_table_remove (self->entries, key);
+}
+
+static gpointer
+find_least_recently_updated (MMSmsMultipartTracker *self,
+                             gpointer               skip)
+{
+    GHashTableIter iter;
+    gpointer       key;
+    gpointer       value;
+    gpointer       oldest = NULL;
+    gint64         oldest_time = G_MAXINT64;
+
+    g_hash_table_iter_init (&iter, self->entries);
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+        Entry *entry = value;
+
+        if (key == skip)
+            continue;
+        if (entry->last_update < oldest_time) {
+            oldest_time = entry->last_update;
+            oldest = key;
+        }
+    }
+
+    return oldest;
+}
+
+MMSmsMultipartTrackerResult
+mm_sms_multipart_tracker_add_part (MMSmsMultipartTracker  *self,
+                                   gpointer                key,
+                                   guint                   sequence,
+                                   guint                   max,
+                                   gint64                  now,
+                                   GList                 **evicted)
+{
+    Entry *entry;
+
+    g_assert (key);
+
+    entry = g_hash_table_lookup (self->entries, key);
+    if (!entry) {
+        entry = g_slice_new0 (Entry);
+        entry->max = MIN (max, MAX_SEQUENCE);
+        g_hash_table_insert (self->entries, key, entry);
+    }
+
+    /* Parts with a bogus sequence only refresh the update time */
+    if (sequence == 0 || sequence > entry->max) {
+        entry->last_update = now;
+        return MM_SMS_MULTIPART_TRACKER_RESULT_INCOMPLETE;
+    }
+
+    if (entry->received[sequence / 32] & (1u << (sequence % 32)))
+        return MM_SMS_MULTIPART_TRACKER_RESULT_DUPLICATE;
+
+    entry->received[sequence / 32] |= (1u << (sequence % 32));
+    entry->n_parts++;
+    entry->last_update = now;
+    self->n_pending_parts++;
+
+    /* Completed messages are no longer tracked */
+    if (entry->n_parts >= entry->max) {
+        remove_entry (self, key, entry);
+        return MM_SMS_MULTIPART_TRACKER_RESULT_COMPLETE;
+    }
+
+    /* Evict the least recently updated incomplete messages until we're within
+     * limits; the one that was just updated is never evicted. */
+    while (g_hash_table_size (self->entries) > self->max_incomplete ||
+           self->n_pending_parts > self->max_pending_parts) {
+        gpointer oldest;
+
+        oldest = find_least_recently_updated (self, key);
+        if (!oldest)
+            break;
+        remove_entry (self, oldest, g_hash_table_lookup (self->entries, oldest));
+        self->n_evicted++;
+        if (evicted)
+            *evicted = g_list_append (*evicted, oldest);
+    }
+
+    return MM_SMS_MULTIPART_TRACKER_RESULT_INCOMPLETE;
+}
+
+GList *
+mm_sms_multipart_tracker_expire (MMSmsMultipartTracker *self,
+                                 gint64                 now)
+{
+    GHashTableIter  iter;
+    gpointer        key;
+    gpointer        value;
+    GList          *expired = NULL;
+
+    g_hash_table_iter_init (&iter, self->entries);
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+        Entry *entry = value;
+
+        if ((now - entry->last_update) < self->expiry_timeout)
+            continue;
+        self->n_pending_parts -= entry->n_parts;
+        self->n_expired++;
+        expired = g_list_prepend (expired, key);
+        g_hash_table_iter_remove (&iter);
+    }
+
+    return expired;
+}
+
+void
+mm_sms_multipart_tracker_remove (MMSmsMultipartTracker *self,
+                                 gpointer               key)
+{
+    Entry *entry;
+
+    entry = g_hash_table_lookup (self->entries, key);
+    if (entry)
+        remove_entry (self, key, entry);
+}
+
+void
+mm_sms_multipart_tracker_clear (MMSmsMultipartTracker *self)
+{
+    g_hash_table_remove_all (self->entries);
+    self->n_pending_parts = 0;
+}
+
+void
+mm_sms_multipart_tracker_get_stats (MMSmsMultipartTracker *self,
+                                    guint                 *n_in_flight,
+                                    guint                 *n_pending_parts,
+                                    guint                 *n_expired,
+                                    guint                 *n_evicted)
+{
+    if (n_in_flight)
+        *n_in_flight = g_hash_table_size (self->entries);
+    if (n_pending_parts)
+        *n_pending_parts = self->n_pending_parts;
+    if (n_expired)
+        *n_expired = self->n_expired;
+    if (n_evicted)
+        *n_evicted = self->n_evicted;
+}
+
+/*****************************************************************************/
+
+static void
+entry_free (Entry *entry)
+{
+    g_slice_free (Entry, entry);
+}
+
+MMSmsMultipartTracker *
+mm_sms_multipart_tracker_new (guint  max_incomplete,
+                              guint  max_pending_parts,
+                              gint64 expiry_timeout)
+{
+    MMSmsMultipartTracker *self;
+
+    self = g_slice_new0 (MMSmsMultipartTracker);
+    self->entries = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)entry_free);
+    self->max_incomplete = max_incomplete;
+    self->max_pending_parts = max_pending_parts;
+    self->expiry_timeout = expiry_timeout;
+    return self;
+}
+
+void
+mm_sms_multipart_tracker_free (MMSmsMultipartTracker *self)
+{
+    g_hash_table_unref (self->entries);
+    g_slice_free (MMSmsMultipartTracker, self);
+}
@@ -0,0 +1,61 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_SMS_MULTIPART_TRACKER_H
+#define MM_SMS_MULTIPART_TRACKER_H
+
+#include <glib.h>
+
+/* Bookkeeping of the multipart messages being reassembled. Each message is
+ * identified by an opaque key (the SMS object owning the parts), and keeps
+ * the sequence numbers received so far and the time of the last update.
+ * Times are given by the caller, in microseconds. */
+
+typedef struct _MMSmsMultipartTracker MMSmsMultipartTracker;
+
+typedef enum {
+    MM_SMS_MULTIPART_TRACKER_RESULT_INCOMPLETE,
+    MM_SMS_MULTIPART_TRACKER_RESULT_COMPLETE,
+    MM_SMS_MULTIPART_TRACKER_RESULT_DUPLICATE,
+} MMSmsMultipartTrackerResult;
+
+MMSmsMultipartTracker       *mm_sms_multipart_tracker_new       (guint                  max_incomplete,
+                                                                 guint                  max_pending_parts,
+                                                                 gint64                 expiry_timeout);
+void                         mm_sms_multipart_tracker_free      (MMSmsMultipartTracker *self);
+
+/* Records part @sequence (1-based) of a message of @max parts. Completed
+ * messages are no longer tracked. If limits are exceeded, the least recently
+ * updated messages other than @key are untracked and returned in @evicted. */
+MMSmsMultipartTrackerResult  mm_sms_multipart_tracker_add_part  (MMSmsMultipartTracker *self,
+                                                                 gpointer               key,
+                                                                 guint                  sequence,
+                                                                 guint                  max,
+                                                                 gint64                 now,
+                                                                 GList                **evicted);
+
+/* Untracks and returns the messages not updated within the expiry timeout */
+GList                       *mm_sms_multipart_tracker_expire    (MMSmsMultipartTracker *self,
+                                                                 gint64                 now);
+
+void                         mm_sms_multipart_tracker_remove    (MMSmsMultipartTracker *self,
+                                                                 gpointer               key);
+void                         mm_sms_multipart_tracker_clear     (MMSmsMultipartTracker *self);
+
+void                         mm_sms_multipart_tracker_get_stats (MMSmsMultipartTracker *self,
+                                                                 guint                 *n_in_flight,
+                                                                 guint                 *n_pending_parts,
+                                                                 guint                 *n_expired,
+                                                                 guint                 *n_evicted);
+
+#endif /* MM_SMS_MULTIPART_TRACKER_H */
@@ -61,18 +61,6 @@
 
 static char sms_bcd_chars[] = "0123456789*#abc\0\0";
 
-static void
-sms_semi_octets_to_bcd_string (char *dest, const guint8 *octets, int num_octets)
-{
-    int i;
-
-    for (i = 0 ; i < num_octets; i++) {
-        *dest++ = sms_bcd_chars[octets[i] & 0xf];
-        *dest++ = sms_bcd_chars[(octets[i] >> 4) & 0xf];
-    }
-    *dest++ = '\0';
-}
-
 static gboolean
 char_to_bcd (char in, guint8 *out)
 {
@@ -119,65 +107,6 @@ sms_string_to_bcd_semi_octets (guint8 *buf, gsize buflen, const char *string)
     return addrlen / 2;
 }
 
-/* len is in semi-octets */
-static char *
-sms_decode_address (const guint8 *address, int len)
-{
-    guint8 addrtype, addrplan;
-    char *utf8;
-
-    addrtype = address[0] & SMS_NUMBER_TYPE_MASK;
-    addrplan = address[0] & SMS_NUMBER_PLAN_MASK;
-    address++;
-
-    if (addrtype == SMS_NUMBER_TYPE_ALPHA) {
-        guint8 *unpacked;
-        guint32 unpacked_len;
-        unpacked = mm_charset_gsm_unpack (address, (len * 4) / 7, 0, &unpacked_len);
-        utf8 = (char *)mm_charset_gsm_unpacked_to_utf8 (unpacked,
-                                                        unpacked_len);
-        g_free (unpacked);
-    } else if (addrtype == SMS_NUMBER_TYPE_INTL &&
-               addrplan == SMS_NUMBER_PLAN_TELEPHONE) {
-        /* International telphone number, format as "+1234567890" */
-        utf8 = g_malloc (len + 3); /* '+' + digits + possible trailing 0xf + NUL */
-        utf8[0] = '+';
-        sms_semi_octets_to_bcd_string (utf8 + 1, address, (len + 1) / 2);
-    } else {
-        /*
-         * All non-alphanumeric types and plans are just digits, but
-         * don't apply any special formatting if we don't know the
-         * format.
-         */
-        utf8 = g_malloc (len + 2); /* digits + possible trailing 0xf + NUL */
-        sms_semi_octets_to_bcd_string (utf8, address, (len + 1) / 2);
-    }
-
-    return utf8;
-}
-
-static gchar *
-sms_decode_timestamp (const guint8 *timestamp)
-{
-    /* ISO8601 format: YYYY-MM-DDTHH:MM:SS+HHMM */
-    guint year, month, day, hour, minute, second;
-    gint quarters, offset_minutes;
-
-    year = 2000 + ((timestamp[0] & 0xf) * 10) + ((timestamp[0] >> 4) & 0xf);
-    month = ((timestamp[1] & 0xf) * 10) + ((timestamp[1] >> 4) & 0xf);
-    day = ((timestamp[2] & 0xf) * 10) + ((timestamp[2] >> 4) & 0xf);
-    hour = ((timestamp[3] & 0xf) * 10) + ((timestamp[3] >> 4) & 0xf);
-    minute = ((timestamp[4] & 0xf) * 10) + ((timestamp[4] >> 4) & 0xf);
-    second = ((timestamp[5] & 0xf) * 10) + ((timestamp[5] >> 4) & 0xf);
-    quarters = ((timestamp[6] & 0x7) * 10) + ((timestamp[6] >> 4) & 0xf);
-    offset_minutes = quarters * 15;
-    if (timestamp[6] & 0x08)
-        offset_minutes = -1 * offset_minutes;
-
-    return mm_new_iso8601_time (year, month, day, hour,
-                                minute, second, TRUE, offset_minutes);
-}
-
 static MMSmsEncoding
 sms_encoding_type (int dcs)
 {
@@ -346,40 +275,291 @@ validity_to_relative (guint validity)
     return 255; /* 63 weeks */
 }
 
-MMSmsPart *
-mm_sms_part_3gpp_new_from_pdu (guint         index,
-                               const gchar  *hexpdu,
-                               gpointer      log_object,
-                               GError      **error)
+/*****************************************************************************/
+/* PDU decoder
+ *
+ * The PDU is read in place, either from its hex representation or from the
+ * binary one, and all decoded strings are stored in the arena of the
+ * caller-provided MMSmsPart3gppPdu record, so no intermediate buffers are
+ * allocated while decoding.
+ */
+
+#define SMS_MAX_ADDRESS_SEPTETS ((2 * G_MAXUINT8 * 4) / 7)
+
+guint8
+mm_sms_part_3gpp_pdu_get_byte (const MMSmsPart3gppPdu *pdu,
+                               guint                   offset)
 {
-    gsize pdu_len;
-    guint8 *pdu;
-    MMSmsPart *part;
+    if (G_UNLIKELY (offset >= pdu->pdu_len))
+        return 0;
+    if (pdu->binpdu)
+        return pdu->binpdu[offset];
+    return (guint8) ((g_ascii_xdigit_value (pdu->hexpdu[2 * offset]) << 4) |
+                     g_ascii_xdigit_value (pdu->hexpdu[(2 * offset) + 1]));
+}
 
-    /* Convert PDU from hex to binary */
-    pdu = (guint8 *) mm_utils_hexstr2bin (hexpdu, &pdu_len);
-    if (!pdu) {
-        g_set_error_literal (error,
-                             MM_CORE_ERROR,
-                             MM_CORE_ERROR_FAILED,
-                             "Couldn't convert 3GPP PDU from hex to binary");
+#define PDU_BYTE(offset) mm_sms_part_3gpp_pdu_get_byte (pdu, offset)
+
+static gchar *
+pdu_arena_alloc (MMSmsPart3gppPdu *pdu,
+                 gsize             size)
+{
+    gchar *str;
+
+    if (size > sizeof (pdu->arena) - pdu->arena_used)
+        return NULL;
+    str = &pdu->arena[pdu->arena_used];
+    pdu->arena_used += size;
+    return str;
+}
+
+/* Give back the unused tail of the last allocation */
+static void
+pdu_arena_shrink (MMSmsPart3gppPdu *pdu,
+                  const gchar      *last,
+                  gsize             used)
+{
+    pdu->arena_used = (gsize)(last - pdu->arena) + used;
+}
+
+static void
+pdu_gsm_unpack (const MMSmsPart3gppPdu *pdu,
+                guint                   offset,
+                guint                   num_septets,
+                guint                   start_offset, /* in bits */
+                guint8                 *out)
+{
+    guint i;
+
+    for (i = 0; i < num_septets; i++) {
+        guint  start_bit;
+        guint  bit;
+        guint  bits_here;
+        guint  bits_in_next;
+        guint8 c;
+
+        start_bit = start_offset + (i * 7); /* Overall bit offset of char in buffer */
+        bit = start_bit % 8;                /* Offset to start of char in this byte */
+        bits_here = bit ? (8 - bit) : 7;
+        bits_in_next = 7 - bits_here;
+
+        /* Grab bits in the current byte */
+        c = (PDU_BYTE (offset + (start_bit / 8)) >> bit) & (0xFF >> (8 - bits_here));
+
+        /* Grab any bits that spilled over to next byte */
+        if (bits_in_next)
+            c |= (PDU_BYTE (offset + (start_bit / 8) + 1) & (0xFF >> (8 - bits_in_next))) << bits_here;
+
+        out[i] = c;
+    }
+}
+
+/* offset points to the Type of Address byte; len is in semi-octets */
+static const gchar *
+pdu_decode_address (MMSmsPart3gppPdu *pdu,
+                    guint             offset,
+                    guint             len)
+{
+    guint8  addrtype;
+    guint8  addrplan;
+    gchar  *utf8;
+    gchar  *dest;
+    guint   i;
+
+    addrtype = PDU_BYTE (offset) & SMS_NUMBER_TYPE_MASK;
+    addrplan = PDU_BYTE (offset) & SMS_NUMBER_PLAN_MASK;
+    offset++;
+
+    if (addrtype == SMS_NUMBER_TYPE_ALPHA) {
+        guint8 unpacked[SMS_MAX_ADDRESS_SEPTETS];
+        guint  n_septets;
+
+        n_septets = (len * 4) / 7;
+        g_assert (n_septets <= SMS_MAX_ADDRESS_SEPTETS);
+        pdu_gsm_unpack (pdu, offset, n_septets, 0, unpacked);
+
+        utf8 = pdu_arena_alloc (pdu, MM_CHARSET_GSM_UTF8_MAX_LEN (n_septets));
+        if (utf8)
+            pdu_arena_shrink (pdu, utf8,
+                              mm_charset_gsm_unpacked_to_utf8_buf (unpacked, n_septets, utf8,
+                                                                   MM_CHARSET_GSM_UTF8_MAX_LEN (n_septets)) + 1);
+        return utf8;
+    }
+
+    /* '+' + digits + possible trailing 0xf + NUL */
+    utf8 = pdu_arena_alloc (pdu, len + 3);
+    if (!utf8)
         return NULL;
+
+    /*
+     * International telephone numbers are formatted as "+1234567890". All
+     * other non-alphanumeric types and plans are just digits, but don't
+     * apply any special formatting if we don't know the format.
+     */
+    dest = utf8;
+    if (addrtype == SMS_NUMBER_TYPE_INTL && addrplan == SMS_NUMBER_PLAN_TELEPHONE)
+        *dest++ = '+';
+    for (i = 0; i < (len + 1) / 2; i++) {
+        guint8 octet;
+
+        octet = PDU_BYTE (offset + i);
+        *dest++ = sms_bcd_chars[octet & 0xf];
+        *dest++ = sms_bcd_chars[(octet >> 4) & 0xf];
     }
+    *dest = '\0';
 
-    part = mm_sms_part_3gpp_new_from_binary_pdu (index, pdu, pdu_len, log_object, error);
-    g_free (pdu);
+    pdu_arena_shrink (pdu, utf8, strlen (utf8) + 1);
+    return utf8;
+}
+
+#define SMS_SEMI_OCTETS_VALUE(octet) ((((octet) & 0xf) * 10) + (((octet) >> 4) & 0xf))
+
+static const gchar *
+pdu_decode_timestamp (MMSmsPart3gppPdu *pdu,
+                      guint             offset)
+{
+    /* ISO8601 format: YYYY-MM-DDTHH:MM:SS+HH:MM */
+    guint8  timestamp[SMS_TIMESTAMP_LEN];
+    gint    quarters;
+    gint    offset_minutes;
+    gchar  *str;
+    gint    len;
+    guint   i;
+
+    str = pdu_arena_alloc (pdu, 32);
+    if (!str)
+        return NULL;
 
-    return part;
+    for (i = 0; i < SMS_TIMESTAMP_LEN; i++)
+        timestamp[i] = PDU_BYTE (offset + i);
+
+    quarters = ((timestamp[6] & 0x7) * 10) + ((timestamp[6] >> 4) & 0xf);
+    offset_minutes = quarters * 15;
+    if (timestamp[6] & 0x08)
+        offset_minutes = -1 * offset_minutes;
+
+    len = g_snprintf (str, 32, "%04u-%02u-%02uT%02u:%02u:%02u%c%02d:%02d",
+                      2000 + SMS_SEMI_OCTETS_VALUE (timestamp[0]),
+                      SMS_SEMI_OCTETS_VALUE (timestamp[1]),
+                      SMS_SEMI_OCTETS_VALUE (timestamp[2]),
+                      SMS_SEMI_OCTETS_VALUE (timestamp[3]),
+                      SMS_SEMI_OCTETS_VALUE (timestamp[4]),
+                      SMS_SEMI_OCTETS_VALUE (timestamp[5]),
+                      offset_minutes >= 0 ? '+' : '-',
+                      ABS (offset_minutes) / 60,
+                      ABS (offset_minutes) % 60);
+    pdu_arena_shrink (pdu, str, MIN (len, 31) + 1);
+    return str;
 }
 
-MMSmsPart *
-mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
-                                      const guint8  *pdu,
-                                      gsize          pdu_len,
-                                      gpointer       log_object,
-                                      GError       **error)
+/* UTF-16BE is a superset of UCS-2BE, so a single pass covers both; see
+ * sms_decode_text() */
+static gboolean
+pdu_decode_utf16be (const MMSmsPart3gppPdu *pdu,
+                    guint                   offset,
+                    guint                   len,
+                    gchar                  *out,
+                    gsize                  *out_len)
 {
-    MMSmsPart *sms_part;
+    gsize n = 0;
+    guint i;
+
+    if (len % 2)
+        return FALSE;
+
+    for (i = 0; i < len; i += 2) {
+        gunichar c;
+
+        c = (PDU_BYTE (offset + i) << 8) | PDU_BYTE (offset + i + 1);
+        if (c >= 0xd800 && c <= 0xdbff) {
+            gunichar low;
+
+            if (i + 3 >= len)
+                return FALSE;
+            low = (PDU_BYTE (offset + i + 2) << 8) | PDU_BYTE (offset + i + 3);
+            if (low < 0xdc00 || low > 0xdfff)
+                return FALSE;
+            c = 0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00);
+            i += 2;
+        } else if (c >= 0xdc00 && c <= 0xdfff)
+            return FALSE;
+
+        n += g_unichar_to_utf8 (c, &out[n]);
+    }
+
+    out[n] = '\0';
+    *out_len = n;
+    return TRUE;
+}
+
+static const gchar *
+pdu_decode_text (MMSmsPart3gppPdu *pdu,
+                 guint             offset,
+                 guint             len,
+                 guint             bit_offset,
+                 gpointer          log_object)
+{
+    gchar *utf8;
+    gsize  utf8_len = 0;
+
+    if (pdu->encoding == MM_SMS_ENCODING_GSM7) {
+        guint8 unpacked[G_MAXUINT8];
+
+        g_assert (len <= G_MAXUINT8);
+
+        mm_obj_dbg (log_object, "converting SMS part text from GSM-7 to UTF-8...");
+        utf8 = pdu_arena_alloc (pdu, MM_CHARSET_GSM_UTF8_MAX_LEN (len));
+        if (!utf8)
+            return NULL;
+        pdu_gsm_unpack (pdu, offset, len, bit_offset, unpacked);
+        utf8_len = mm_charset_gsm_unpacked_to_utf8_buf (unpacked, len, utf8, MM_CHARSET_GSM_UTF8_MAX_LEN (len));
+        mm_obj_dbg (log_object, "   got UTF-8 text: '%s'", utf8);
+    } else if (pdu->encoding == MM_SMS_ENCODING_UCS2) {
+        mm_obj_dbg (log_object, "converting SMS part text from UTF-16BE to UTF-8...");
+        utf8 = pdu_arena_alloc (pdu, ((len / 2) * 3) + 1);
+        if (!utf8)
+            return NULL;
+        if (!pdu_decode_utf16be (pdu, offset, len, utf8, &utf8_len)) {
+            mm_obj_warn (log_object, "couldn't convert SMS part contents from UTF-16BE/UCS-2BE to UTF-8: not decoding any text");
+            utf8[0] = '\0';
+            utf8_len = 0;
+        } else
+            mm_obj_dbg (log_object, "   got UTF-8 text: '%s'", utf8);
+    } else {
+        mm_obj_warn (log_object, "unexpected encoding: %s; not decoding any text", mm_sms_encoding_get_string (pdu->encoding));
+        utf8 = pdu_arena_alloc (pdu, 1);
+        if (!utf8)
+            return NULL;
+        utf8[0] = '\0';
+    }
+
+    pdu_arena_shrink (pdu, utf8, utf8_len + 1);
+    return utf8;
+}
+
+static void
+pdu_init (MMSmsPart3gppPdu *pdu,
+          const gchar      *hexpdu,
+          const guint8     *binpdu,
+          gsize             pdu_len)
+{
+    /* The arena doesn't need to be cleared */
+    memset (pdu, 0, G_STRUCT_OFFSET (MMSmsPart3gppPdu, arena));
+    pdu->hexpdu = hexpdu;
+    pdu->binpdu = binpdu;
+    pdu->pdu_len = pdu_len;
+    pdu->pdu_type = MM_SMS_PDU_TYPE_UNKNOWN;
+    pdu->encoding = MM_SMS_ENCODING_UNKNOWN;
+    pdu->class = -1;
+    pdu->delivery_state = MM_SMS_DELIVERY_STATE_UNKNOWN;
+}
+
+static gboolean
+pdu_decode (MMSmsPart3gppPdu  *pdu,
+            gpointer           log_object,
+            GError           **error)
+{
+    guint8 first_octet;
     guint8 pdu_type;
     guint offset;
     guint smsc_addr_size_bytes;
@@ -392,27 +572,27 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
     guint tp_pid_offset = 0;
     guint tp_dcs_offset = 0;
     guint tp_user_data_len_offset = 0;
-    MMSmsEncoding user_data_encoding = MM_SMS_ENCODING_UNKNOWN;
-
-    /* Create the new MMSmsPart */
-    sms_part = mm_sms_part_new (index, MM_SMS_PDU_TYPE_UNKNOWN);
-
-    if (index != SMS_PART_INVALID_INDEX)
-        mm_obj_dbg (log_object, "parsing PDU (%u)...", index);
-    else
-        mm_obj_dbg (log_object, "parsing PDU...");
 
 #define PDU_SIZE_CHECK(required_size, check_descr_str)                 \
-    if (pdu_len < required_size) {                                     \
+    if (pdu->pdu_len < required_size) {                                \
         g_set_error (error,                                            \
                      MM_CORE_ERROR,                                    \
                      MM_CORE_ERROR_FAILED,                             \
                      "PDU too short, %s: %" G_GSIZE_FORMAT " < %u",    \
                      check_descr_str,                                  \
-                     pdu_len,                                          \
+                     pdu->pdu_len,                                     \
                      required_size);                                   \
-        mm_sms_part_free (sms_part);                                   \
-        return NULL;                                                   \
+        return FALSE;                                                  \
+    }
+
+#define PDU_ARENA_CHECK(str, check_descr_str)                          \
+    if (!(str)) {                                                      \
+        g_set_error (error,                                            \
+                     MM_CORE_ERROR,                                    \
+                     MM_CORE_ERROR_FAILED,                             \
+                     "PDU too long, cannot store %s",                  \
+                     check_descr_str);                                 \
+        return FALSE;                                                  \
     }
 
     offset = 0;
@@ -421,13 +601,13 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
     /* SMSC, in address format, precedes the TPDU
      * First byte represents the number of BYTES for the address value */
     PDU_SIZE_CHECK (1, "cannot read SMSC address length");
-    smsc_addr_size_bytes = pdu[offset++];
+    smsc_addr_size_bytes = PDU_BYTE (offset++);
     if (smsc_addr_size_bytes > 0) {
         PDU_SIZE_CHECK (offset + smsc_addr_size_bytes, "cannot read SMSC address");
         /* SMSC may not be given in DELIVER PDUs */
-        mm_sms_part_take_smsc (sms_part,
-                               sms_decode_address (&pdu[1], 2 * (smsc_addr_size_bytes - 1)));
-        mm_obj_dbg (log_object, "  SMSC address parsed: '%s'", mm_sms_part_get_smsc (sms_part));
+        pdu->smsc = pdu_decode_address (pdu, 1, 2 * (smsc_addr_size_bytes - 1));
+        PDU_ARENA_CHECK (pdu->smsc, "SMSC address");
+        mm_obj_dbg (log_object, "  SMSC address parsed: '%s'", pdu->smsc);
         offset += smsc_addr_size_bytes;
     } else
         mm_obj_dbg (log_object, "  no SMSC address given");
@@ -437,40 +617,40 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
     /* TP-MTI (1 byte) */
     PDU_SIZE_CHECK (offset + 1, "cannot read TP-MTI");
 
-    pdu_type = (pdu[offset] & SMS_TP_MTI_MASK);
+    first_octet = PDU_BYTE (offset);
+    pdu_type = (first_octet & SMS_TP_MTI_MASK);
     switch (pdu_type) {
     case SMS_TP_MTI_SMS_DELIVER:
         mm_obj_dbg (log_object, "  deliver type PDU detected");
-        mm_sms_part_set_pdu_type (sms_part, MM_SMS_PDU_TYPE_DELIVER);
+        pdu->pdu_type = MM_SMS_PDU_TYPE_DELIVER;
         break;
     case SMS_TP_MTI_SMS_SUBMIT:
         mm_obj_dbg (log_object, "  submit type PDU detected");
-        mm_sms_part_set_pdu_type (sms_part, MM_SMS_PDU_TYPE_SUBMIT);
+        pdu->pdu_type = MM_SMS_PDU_TYPE_SUBMIT;
         break;
     case SMS_TP_MTI_SMS_STATUS_REPORT:
         mm_obj_dbg (log_object, "  status report type PDU detected");
-        mm_sms_part_set_pdu_type (sms_part, MM_SMS_PDU_TYPE_STATUS_REPORT);
+        pdu->pdu_type = MM_SMS_PDU_TYPE_STATUS_REPORT;
         break;
     default:
-        mm_sms_part_free (sms_part);
         g_set_error (error,
                      MM_CORE_ERROR,
                      MM_CORE_ERROR_FAILED,
                      "Unhandled message type: 0x%02x",
                      pdu_type);
-        return NULL;
+        return FALSE;
     }
 
     /* Delivery report was requested? */
-    if (pdu[offset] & 0x20)
-        mm_sms_part_set_delivery_report_request (sms_part, TRUE);
+    if (first_octet & 0x20)
+        pdu->delivery_report_request = TRUE;
 
     /* PDU with validity? (only in SUBMIT PDUs) */
     if (pdu_type == SMS_TP_MTI_SMS_SUBMIT)
-        validity_format = pdu[offset] & 0x18;
+        validity_format = first_octet & 0x18;
 
     /* PDU with user data header? */
-    if (pdu[offset] & 0x40)
+    if (first_octet & 0x40)
         has_udh = TRUE;
 
     offset++;
@@ -481,8 +661,8 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
         pdu_type == SMS_TP_MTI_SMS_SUBMIT) {
         PDU_SIZE_CHECK (offset + 1, "cannot read message reference");
 
-        mm_obj_dbg (log_object, "  message reference: %u", (guint)pdu[offset]);
-        mm_sms_part_set_message_reference (sms_part, pdu[offset]);
+        pdu->message_reference = PDU_BYTE (offset);
+        mm_obj_dbg (log_object, "  message reference: %u", pdu->message_reference);
         offset++;
     }
 
@@ -494,14 +674,13 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
      * semi-octets, and thus an integral number of octets.
      */
     PDU_SIZE_CHECK (offset + 1, "cannot read number of digits in number");
-    tp_addr_size_digits = pdu[offset++];
+    tp_addr_size_digits = PDU_BYTE (offset++);
     tp_addr_size_bytes = (tp_addr_size_digits + 1) >> 1;
 
     PDU_SIZE_CHECK (offset + tp_addr_size_bytes, "cannot read number");
-    mm_sms_part_take_number (sms_part,
-                             sms_decode_address (&pdu[offset],
-                                                 tp_addr_size_digits));
-    mm_obj_dbg (log_object, "  number parsed: %s", mm_sms_part_get_number (sms_part));
+    pdu->number = pdu_decode_address (pdu, offset, tp_addr_size_digits);
+    PDU_ARENA_CHECK (pdu->number, "number");
+    mm_obj_dbg (log_object, "  number parsed: %s", pdu->number);
     offset += (1 + tp_addr_size_bytes); /* +1 due to the Type of Address byte */
 
     /* ---------------------------------------------------------------------- */
@@ -518,8 +697,8 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
         tp_dcs_offset = offset++;
 
         /* ------ Timestamp (7 bytes) ------ */
-        mm_sms_part_take_timestamp (sms_part,
-                                    sms_decode_timestamp (&pdu[offset]));
+        pdu->timestamp = pdu_decode_timestamp (pdu, offset);
+        PDU_ARENA_CHECK (pdu->timestamp, "timestamp");
         offset += 7;
 
         tp_user_data_len_offset = offset;
@@ -538,8 +717,7 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
             switch (validity_format) {
             case 0x10:
                 mm_obj_dbg (log_object, "  validity available, format relative");
-                mm_sms_part_set_validity_relative (sms_part,
-                                                   relative_to_validity (pdu[offset]));
+                pdu->validity_relative = relative_to_validity (PDU_BYTE (offset));
                 offset++;
                 break;
             case 0x08:
@@ -570,34 +748,37 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
         PDU_SIZE_CHECK (offset + 15, "cannot read Timestamps/TP-STATUS"); /* 7+7+1=15 */
 
         /* ------ Timestamp (7 bytes) ------ */
-        mm_sms_part_take_timestamp (sms_part,
-                                    sms_decode_timestamp (&pdu[offset]));
+        pdu->timestamp = pdu_decode_timestamp (pdu, offset);
+        PDU_ARENA_CHECK (pdu->timestamp, "timestamp");
         offset += 7;
 
         /* ------ Discharge Timestamp (7 bytes) ------ */
-        mm_sms_part_take_discharge_timestamp (sms_part,
-                                              sms_decode_timestamp (&pdu[offset]));
+        pdu->discharge_timestamp = pdu_decode_timestamp (pdu, offset);
+        PDU_ARENA_CHECK (pdu->discharge_timestamp, "discharge timestamp");
         offset += 7;
 
         /* ----- TP-STATUS (1 byte) ------ */
-        mm_obj_dbg (log_object, "  delivery state: %u", (guint)pdu[offset]);
-        mm_sms_part_set_delivery_state (sms_part, pdu[offset]);
+        pdu->delivery_state = PDU_BYTE (offset);
+        mm_obj_dbg (log_object, "  delivery state: %u", pdu->delivery_state);
         offset++;
 
         /* ------ TP-PI (1 byte) OPTIONAL ------ */
-        if (offset < pdu_len) {
+        if (offset < pdu->pdu_len) {
             guint next_optional_field_offset = offset + 1;
+            guint8 tp_pi;
+
+            tp_pi = PDU_BYTE (offset);
 
             /* TP-PID? */
-            if (pdu[offset] & 0x01)
+            if (tp_pi & 0x01)
                 tp_pid_offset = next_optional_field_offset++;
 
             /* TP-DCS? */
-            if (pdu[offset] & 0x02)
+            if (tp_pi & 0x02)
                 tp_dcs_offset = next_optional_field_offset++;
 
             /* TP-UserData? */
-            if (pdu[offset] & 0x04)
+            if (tp_pi & 0x04)
                 tp_user_data_len_offset = next_optional_field_offset;
         }
     } else
@@ -605,16 +786,19 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
 
     if (tp_pid_offset > 0) {
         PDU_SIZE_CHECK (tp_pid_offset + 1, "cannot read TP-PID");
-        mm_obj_dbg (log_object, "  PID: %u", (guint)pdu[tp_pid_offset]);
+        mm_obj_dbg (log_object, "  PID: %u", (guint)PDU_BYTE (tp_pid_offset));
     }
 
     /* Grab user data encoding and message class */
     if (tp_dcs_offset > 0) {
+        guint8 tp_dcs;
+
         PDU_SIZE_CHECK (tp_dcs_offset + 1, "cannot read TP-DCS");
+        tp_dcs = PDU_BYTE (tp_dcs_offset);
 
         /* Encoding given in the 'alphabet' bits */
-        user_data_encoding = sms_encoding_type (pdu[tp_dcs_offset]);
-        switch (user_data_encoding) {
+        pdu->encoding = sms_encoding_type (tp_dcs);
+        switch (pdu->encoding) {
         case MM_SMS_ENCODING_GSM7:
             mm_obj_dbg (log_object, "  user data encoding is GSM7");
             break;
@@ -629,12 +813,10 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
             mm_obj_dbg (log_object, "  user data encoding is unknown");
             break;
         }
-        mm_sms_part_set_encoding (sms_part, user_data_encoding);
 
         /* Class */
-        if (pdu[tp_dcs_offset] & SMS_DCS_CLASS_VALID)
-            mm_sms_part_set_class (sms_part,
-                                   pdu[tp_dcs_offset] & SMS_DCS_CLASS_MASK);
+        if (tp_dcs & SMS_DCS_CLASS_VALID)
+            pdu->class = tp_dcs & SMS_DCS_CLASS_MASK;
     }
 
     if (tp_user_data_len_offset > 0) {
@@ -644,10 +826,10 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
         guint bit_offset;
 
         PDU_SIZE_CHECK (tp_user_data_len_offset + 1, "cannot read TP-UDL");
-        tp_user_data_size_elements = pdu[tp_user_data_len_offset];
+        tp_user_data_size_elements = PDU_BYTE (tp_user_data_len_offset);
         mm_obj_dbg (log_object, "  user data length: %u elements", tp_user_data_size_elements);
 
-        if (user_data_encoding == MM_SMS_ENCODING_GSM7)
+        if (pdu->encoding == MM_SMS_ENCODING_GSM7)
             tp_user_data_size_bytes = (7 * (tp_user_data_size_elements + 1 )) / 8;
         else
             tp_user_data_size_bytes = tp_user_data_size_elements;
@@ -659,17 +841,26 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
         bit_offset = 0;
         if (has_udh) {
             guint udhl, end;
+            guint udh_elements;
 
-            udhl = pdu[tp_user_data_offset] + 1;
+            udhl = PDU_BYTE (tp_user_data_offset) + 1;
             end = tp_user_data_offset + udhl;
 
             PDU_SIZE_CHECK (tp_user_data_offset + udhl, "cannot read UDH");
+            if (udhl > tp_user_data_size_bytes) {
+                g_set_error (error,
+                             MM_CORE_ERROR,
+                             MM_CORE_ERROR_FAILED,
+                             "UDH longer than user data: %u > %u",
+                             udhl, tp_user_data_size_bytes);
+                return FALSE;
+            }
 
             for (offset = tp_user_data_offset + 1; (offset + 1) < end;) {
                 guint8 ie_id, ie_len;
 
-                ie_id = pdu[offset++];
-                ie_len = pdu[offset++];
+                ie_id = PDU_BYTE (offset++);
+                ie_len = PDU_BYTE (offset++);
 
                 switch (ie_id) {
                 case 0x00:
@@ -680,25 +871,27 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
                      *  - it claims to be part 0 of M
                      *  - it claims to be part N of M, N > M
                      */
-                    if (pdu[offset + 2] == 0 ||
-                        pdu[offset + 2] > pdu[offset + 1])
+                    if (PDU_BYTE (offset + 2) == 0 ||
+                        PDU_BYTE (offset + 2) > PDU_BYTE (offset + 1))
                         break;
 
-                    mm_sms_part_set_concat_reference (sms_part, pdu[offset]);
-                    mm_sms_part_set_concat_max (sms_part, pdu[offset + 1]);
-                    mm_sms_part_set_concat_sequence (sms_part, pdu[offset + 2]);
+                    pdu->concat = TRUE;
+                    pdu->concat_reference = PDU_BYTE (offset);
+                    pdu->concat_max = PDU_BYTE (offset + 1);
+                    pdu->concat_sequence = PDU_BYTE (offset + 2);
                     break;
                 case 0x08:
                     if (offset + 3 >= end)
                         break;
                     /* Concatenated short message, 16-bit reference */
-                    if (pdu[offset + 3] == 0 ||
-                        pdu[offset + 3] > pdu[offset + 2])
+                    if (PDU_BYTE (offset + 3) == 0 ||
+                        PDU_BYTE (offset + 3) > PDU_BYTE (offset + 2))
                         break;
 
-                    mm_sms_part_set_concat_reference (sms_part, (pdu[offset] << 8) | pdu[offset + 1]);
-                    mm_sms_part_set_concat_max (sms_part,pdu[offset + 2]);
-                    mm_sms_part_set_concat_sequence (sms_part, pdu[offset + 3]);
+                    pdu->concat = TRUE;
+                    pdu->concat_reference = (PDU_BYTE (offset) << 8) | PDU_BYTE (offset + 1);
+                    pdu->concat_max = PDU_BYTE (offset + 2);
+                    pdu->concat_sequence = PDU_BYTE (offset + 3);
                     break;
                 default:
                     break;
@@ -713,55 +906,174 @@ mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
              */
             tp_user_data_offset += udhl;
             tp_user_data_size_bytes -= udhl;
-            if (user_data_encoding == MM_SMS_ENCODING_GSM7) {
+            if (pdu->encoding == MM_SMS_ENCODING_GSM7) {
                 /*
                  * Find the number of bits we need to add to the length of the
                  * user data to get a multiple of 7 (the padding).
                  */
                 bit_offset = (7 - udhl % 7) % 7;
-                tp_user_data_size_elements -= (udhl * 8 + bit_offset) / 7;
+                udh_elements = (udhl * 8 + bit_offset) / 7;
             } else
-                tp_user_data_size_elements -= udhl;
+                udh_elements = udhl;
+            tp_user_data_size_elements -= MIN (udh_elements, tp_user_data_size_elements);
         }
 
-        switch (user_data_encoding) {
+        switch (pdu->encoding) {
         case MM_SMS_ENCODING_GSM7:
         case MM_SMS_ENCODING_UCS2:
             /* Otherwise if it's 7-bit or UCS2 we can decode it */
             mm_obj_dbg (log_object, "decoding SMS text with %u elements", tp_user_data_size_elements);
-            mm_sms_part_take_text (sms_part,
-                                   sms_decode_text (&pdu[tp_user_data_offset],
-                                                    tp_user_data_size_elements,
-                                                    user_data_encoding,
-                                                    bit_offset,
-                                                    log_object));
-            g_warn_if_fail (mm_sms_part_get_text (sms_part) != NULL);
+            pdu->text = pdu_decode_text (pdu,
+                                         tp_user_data_offset,
+                                         tp_user_data_size_elements,
+                                         bit_offset,
+                                         log_object);
+            PDU_ARENA_CHECK (pdu->text, "text");
             break;
 
         case MM_SMS_ENCODING_8BIT:
         case MM_SMS_ENCODING_UNKNOWN:
         default:
-            {
-                GByteArray *raw;
-
-                mm_obj_dbg (log_object, "skipping SMS text: unknown encoding (0x%02X)", user_data_encoding);
+            mm_obj_dbg (log_object, "skipping SMS text: unknown encoding (0x%02X)", pdu->encoding);
 
-                PDU_SIZE_CHECK (tp_user_data_offset + tp_user_data_size_bytes, "cannot read user data");
+            PDU_SIZE_CHECK (tp_user_data_offset + tp_user_data_size_bytes, "cannot read user data");
 
-                /* 8-bit encoding is usually binary data, and we have no idea what
-                 * actual encoding the data is in so we can't convert it.
-                 */
-                raw = g_byte_array_sized_new (tp_user_data_size_bytes);
-                g_byte_array_append (raw, &pdu[tp_user_data_offset], tp_user_data_size_bytes);
-                mm_sms_part_take_data (sms_part, raw);
-                break;
-            }
+            /* 8-bit encoding is usually binary data, and we have no idea what
+             * actual encoding the data is in so we can't convert it.
+             */
+            pdu->have_data = TRUE;
+            pdu->data_offset = tp_user_data_offset;
+            pdu->data_len = tp_user_data_size_bytes;
+            break;
         }
     }
 
+#undef PDU_SIZE_CHECK
+#undef PDU_ARENA_CHECK
+
+    return TRUE;
+}
+
+gboolean
+mm_sms_part_3gpp_pdu_decode (MMSmsPart3gppPdu  *pdu,
+                             const gchar       *hexpdu,
+                             gpointer           log_object,
+                             GError           **error)
+{
+    gsize len;
+
+    /* Validate the hex string once, so that bytes can be read straight
+     * from it while decoding */
+    for (len = 0; hexpdu[len]; len++) {
+        if (!g_ascii_isxdigit (hexpdu[len]))
+            break;
+    }
+    if (hexpdu[len] != '\0' || (len % 2) != 0) {
+        g_set_error_literal (error,
+                             MM_CORE_ERROR,
+                             MM_CORE_ERROR_FAILED,
+                             "Couldn't convert 3GPP PDU from hex to binary");
+        return FALSE;
+    }
+
+    pdu_init (pdu, hexpdu, NULL, len / 2);
+    return pdu_decode (pdu, log_object, error);
+}
+
+gboolean
+mm_sms_part_3gpp_pdu_decode_binary (MMSmsPart3gppPdu  *pdu,
+                                    const guint8      *binpdu,
+                                    gsize              pdu_len,
+                                    gpointer           log_object,
+                                    GError           **error)
+{
+    pdu_init (pdu, NULL, binpdu, pdu_len);
+    return pdu_decode (pdu, log_object, error);
+}
+
+MMSmsPart *
+mm_sms_part_3gpp_new_from_decoded_pdu (guint                   index,
+                                       const MMSmsPart3gppPdu *pdu)
+{
+    MMSmsPart *sms_part;
+
+    sms_part = mm_sms_part_new (index, pdu->pdu_type);
+    if (pdu->smsc)
+        mm_sms_part_set_smsc (sms_part, pdu->smsc);
+    mm_sms_part_set_number (sms_part, pdu->number);
+    if (pdu->timestamp)
+        mm_sms_part_set_timestamp (sms_part, pdu->timestamp);
+    if (pdu->discharge_timestamp)
+        mm_sms_part_set_discharge_timestamp (sms_part, pdu->discharge_timestamp);
+    mm_sms_part_set_encoding (sms_part, pdu->encoding);
+    mm_sms_part_set_class (sms_part, pdu->class);
+    mm_sms_part_set_validity_relative (sms_part, pdu->validity_relative);
+    mm_sms_part_set_delivery_report_request (sms_part, pdu->delivery_report_request);
+    mm_sms_part_set_message_reference (sms_part, pdu->message_reference);
+    mm_sms_part_set_delivery_state (sms_part, pdu->delivery_state);
+
+    if (pdu->concat) {
+        mm_sms_part_set_concat_reference (sms_part, pdu->concat_reference);
+        mm_sms_part_set_concat_max (sms_part, pdu->concat_max);
+        mm_sms_part_set_concat_sequence (sms_part, pdu->concat_sequence);
+    }
+
+    if (pdu->text)
+        mm_sms_part_set_text (sms_part, pdu->text);
+
+    if (pdu->have_data) {
+        GByteArray *raw;
+        guint       i;
+
+        raw = g_byte_array_sized_new (pdu->data_len);
+        g_byte_array_set_size (raw, pdu->data_len);
+        for (i = 0; i < pdu->data_len; i++)
+            raw->data[i] = PDU_BYTE (pdu->data_offset + i);
+        mm_sms_part_take_data (sms_part, raw);
+    }
+
     return sms_part;
 }
 
+MMSmsPart *
+mm_sms_part_3gpp_new_from_pdu (guint         index,
+                               const gchar  *hexpdu,
+                               gpointer      log_object,
+                               GError      **error)
+{
+    MMSmsPart3gppPdu pdu;
+
+    if (index != SMS_PART_INVALID_INDEX)
+        mm_obj_dbg (log_object, "parsing PDU (%u)...", index);
+    else
+        mm_obj_dbg (log_object, "parsing PDU...");
+
+    if (!mm_sms_part_3gpp_pdu_decode (&pdu, hexpdu, log_object, error))
+        return NULL;
+
+    return mm_sms_part_3gpp_new_from_decoded_pdu (index, &pdu);
+}
+
+MMSmsPart *
+mm_sms_part_3gpp_new_from_binary_pdu (guint         index,
+                                      const guint8  *pdu,
+                                      gsize          pdu_len,
+                                      gpointer       log_object,
+                                      GError       **error)
+{
+    MMSmsPart3gppPdu decoded;
+
+    if (index != SMS_PART_INVALID_INDEX)
+        mm_obj_dbg (log_object, "parsing PDU (%u)...", index);
+    else
+        mm_obj_dbg (log_object, "parsing PDU...");
+
+    if (!mm_sms_part_3gpp_pdu_decode_binary (&decoded, pdu, pdu_len, log_object, error))
+        return NULL;
+
+    return mm_sms_part_3gpp_new_from_decoded_pdu (index, &decoded);
+}
+
 /**
  * mm_sms_part_3gpp_encode_address:
  *
@@ -22,6 +22,58 @@
 
 #include "mm-sms-part.h"
 
+/* Decoded 3GPP PDU. Decoded strings are stored in the record's own arena,
+ * while the user data of 8-bit messages is referenced in the input PDU,
+ * which must stay valid as long as the record is in use. */
+#define MM_SMS_PART_3GPP_PDU_ARENA_SIZE 2048
+
+typedef struct {
+    /* Input PDU, not owned; either in hex or in binary */
+    const gchar   *hexpdu;
+    const guint8  *binpdu;
+    gsize          pdu_len; /* in bytes */
+
+    MMSmsPduType   pdu_type;
+    const gchar   *smsc;
+    const gchar   *number;
+    const gchar   *timestamp;
+    const gchar   *discharge_timestamp;
+    const gchar   *text;
+    MMSmsEncoding  encoding;
+    gint           class;
+    guint          validity_relative;
+    gboolean       delivery_report_request;
+    guint          message_reference;
+    guint          delivery_state;
+
+    gboolean       concat;
+    guint          concat_reference;
+    guint          concat_max;
+    guint          concat_sequence;
+
+    /* Undecoded user data, as offset in the input PDU */
+    gboolean       have_data;
+    guint          data_offset;
+    guint          data_len;
+
+    gsize          arena_used;
+    gchar          arena[MM_SMS_PART_3GPP_PDU_ARENA_SIZE];
+} MMSmsPart3gppPdu;
+
+gboolean   mm_sms_part_3gpp_pdu_decode        (MMSmsPart3gppPdu  *pdu,
+                                               const gchar       *hexpdu,
+                                               gpointer           log_object,
+                                               GError           **error);
+gboolean   mm_sms_part_3gpp_pdu_decode_binary (MMSmsPart3gppPdu  *pdu,
+                                               const guint8      *binpdu,
+                                               gsize              pdu_len,
+                                               gpointer           log_object,
+                                               GError           **error);
+guint8     mm_sms_part_3gpp_pdu_get_byte      (const MMSmsPart3gppPdu *pdu,
+                                               guint                   offset);
+
+MMSmsPart *mm_sms_part_3gpp_new_from_decoded_pdu (guint                   index,
+                                                  const MMSmsPart3gppPdu *pdu);
 MMSmsPart *mm_sms_part_3gpp_new_from_pdu        (guint          index,
                                                  const gchar   *hexpdu,
                                                  gpointer       log_object,
@@ -0,0 +1,435 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-sms-spool.h"
+#include "mm-modem-helpers.h"
+#include "mm-log-object.h"
+
+static void log_object_iface_init (MMLogObjectInterface *iface);
+
+G_DEFINE_TYPE_EXTENDED (MMSmsSpool, mm_sms_spool, G_TYPE_OBJECT, 0,
+                        G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
+
+/*
+ * Spool file format (GKeyFile), one group per stored part:
+ *
+ *   [sm/3]
+ *   status=1
+ *   pdu=07914306073011F0040B...
+ *   hash=<SHA-256 of the PDU>
+ *
+ * Entries whose hash doesn't match the PDU are ignored when loading.
+ *
+ * Whether the spool holds the whole contents of each storage (i.e. it was
+ * fully listed at least once) is kept in a separate group, keyed by storage:
+ *
+ *   [listed]
+ *   sm=true
+ */
+#define SPOOL_KEY_STATUS "status"
+#define SPOOL_KEY_PDU    "pdu"
+#define SPOOL_KEY_HASH   "hash"
+
+#define SPOOL_GROUP_LISTED "listed"
+
+struct _MMSmsSpoolPrivate {
+    gchar    *sim_identifier;
+    gchar    *path;
+    GKeyFile *key_file;
+    guint     save_id;
+};
+
+/*****************************************************************************/
+
+static gchar *
+build_group (MMSmsStorage storage,
+             guint        index)
+{
+    return g_strdup_printf ("%s/%u", mm_sms_storage_get_string (storage), index);
+}
+
+static gboolean
+parse_group (const gchar  *group,
+             MMSmsStorage *out_storage,
+             guint        *out_index)
+{
+    const gchar *slash;
+    gchar       *storage_str;
+    gchar       *end = NULL;
+    gulong       index;
+
+    slash = strchr (group, '/');
+    if (!slash || !g_ascii_isdigit (slash[1]))
+        return FALSE;
+
+    index = strtoul (slash + 1, &end, 10);
+    if (*end != '\0' || index > G_MAXUINT)
+        return FALSE;
+
+    storage_str = g_strndup (group, slash - group);
+    *out_storage = mm_common_get_sms_storage_from_string (storage_str, NULL);
+    g_free (storage_str);
+    if (*out_storage == MM_SMS_STORAGE_UNKNOWN)
+        return FALSE;
+
+    *out_index = (guint) index;
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+static gboolean
+save_cb (MMSmsSpool *self)
+{
+    GError *error = NULL;
+
+    self->priv->save_id = 0;
+    if (!g_key_file_save_to_file (self->priv->key_file, self->priv->path, &error)) {
+        mm_obj_warn (self, "couldn't save SMS spool: %s", error->message);
+        g_error_free (error);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_save (MMSmsSpool *self)
+{
+    /* Several updates in a row (e.g. while listing) end up in a single write */
+    if (!self->priv->save_id)
+        self->priv->save_id = g_idle_add ((GSourceFunc)save_cb, self);
+}
+
+/*****************************************************************************/
+
+guint
+mm_sms_spool_get_count (MMSmsSpool   *self,
+                        MMSmsStorage  storage)
+{
+    gchar **groups;
+    guint   i;
+    guint   n = 0;
+
+    groups = g_key_file_get_groups (self->priv->key_file, NULL);
+    for (i = 0; groups[i]; i++) {
+        MMSmsStorage group_storage;
+        guint        index;
+
+        if (parse_group (groups[i], &group_storage, &index) && group_storage == storage)
+            n++;
+    }
+    g_strfreev (groups);
+    return n;
+}
+
+GList *
+mm_sms_spool_get_parts (MMSmsSpool   *self,
+                        MMSmsStorage  storage)
+{
+    gchar **groups;
+    GList  *list = NULL;
+    guint   i;
+
+    groups = g_key_file_get_groups (self->priv->key_file, NULL);
+    for (i = 0; groups[i]; i++) {
+        MMSmsStorage   group_storage;
+        guint          index;
+        MM3gppPduInfo *info;
+        gchar         *hash;
+        gchar         *expected_hash;
+
+        if (!parse_group (groups[i], &group_storage, &index) || group_storage != storage)
+            continue;
+
+        info = g_new0 (MM3gppPduInfo, 1);
+        info->index = (gint) index;
+        info->status = g_key_file_get_integer (self->priv->key_file, groups[i], SPOOL_KEY_STATUS, NULL);
+        info->pdu = g_key_file_get_string (self->priv->key_file, groups[i], SPOOL_KEY_PDU, NULL);
+        hash = g_key_file_get_string (self->priv->key_file, groups[i], SPOOL_KEY_HASH, NULL);
+
+        expected_hash = info->pdu ? g_compute_checksum_for_string (G_CHECKSUM_SHA256, info->pdu, -1) : NULL;
+        if (!hash || g_strcmp0 (hash, expected_hash) != 0) {
+            mm_obj_dbg (self, "ignoring corrupted spool entry '%s'", groups[i]);
+            mm_3gpp_pdu_info_free (info);
+        } else
+            list = g_list_prepend (list, info);
+
+        g_free (expected_hash);
+        g_free (hash);
+    }
+    g_strfreev (groups);
+
+    return g_list_reverse (list);
+}
+
+void
+mm_sms_spool_add_part (MMSmsSpool   *self,
+                       MMSmsStorage  storage,
+                       guint         index,
+                       gint          status,
+                       const gchar  *pdu)
+{
+    gchar *group;
+    gchar *hash;
+
+    if (storage == MM_SMS_STORAGE_UNKNOWN || index == SMS_PART_INVALID_INDEX)
+        return;
+
+    group = build_group (storage, index);
+    hash = g_compute_checksum_for_string (G_CHECKSUM_SHA256, pdu, -1);
+    g_key_file_set_integer (self->priv->key_file, group, SPOOL_KEY_STATUS, status);
+    g_key_file_set_string  (self->priv->key_file, group, SPOOL_KEY_PDU,    pdu);
+    g_key_file_set_string  (self->priv->key_file, group, SPOOL_KEY_HASH,   hash);
+    g_free (hash);
+    g_free (group);
+
+    schedule_save (self);
+}
+
+void
+mm_sms_spool_remove_part (MMSmsSpool   *self,
+                          MMSmsStorage  storage,
+                          guint         index)
+{
+    gchar *group;
+
+    group = build_group (storage, index);
+    if (g_key_file_remove_group (self->priv->key_file, group, NULL))
+        schedule_save (self);
+    g_free (group);
+}
+
+gboolean
+mm_sms_spool_get_storage_listed (MMSmsSpool   *self,
+                                 MMSmsStorage  storage)
+{
+    return g_key_file_get_boolean (self->priv->key_file,
+                                   SPOOL_GROUP_LISTED,
+                                   mm_sms_storage_get_string (storage),
+                                   NULL);
+}
+
+gboolean
+mm_sms_spool_check_storage (MMSmsSpool   *self,
+                            MMSmsStorage  storage,
+                            guint         used)
+{
+    if (!mm_sms_spool_get_storage_listed (self, storage)) {
+        mm_obj_dbg (self, "storage '%s' never fully listed", mm_sms_storage_get_string (storage));
+        return FALSE;
+    }
+
+    /* Note: the spool only tracks parts that could be parsed, so if any part
+     * in the storage is unparseable the count will never match, and the
+     * caller needs to find out which indexes are missing */
+    if (used != mm_sms_spool_get_count (self, storage)) {
+        mm_obj_dbg (self, "storage '%s' part count changed", mm_sms_storage_get_string (storage));
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void
+mm_sms_spool_set_storage_listed (MMSmsSpool   *self,
+                                 MMSmsStorage  storage)
+{
+    if (mm_sms_spool_get_storage_listed (self, storage))
+        return;
+
+    g_key_file_set_boolean (self->priv->key_file,
+                            SPOOL_GROUP_LISTED,
+                            mm_sms_storage_get_string (storage),
+                            TRUE);
+    schedule_save (self);
+}
+
+static gboolean
+index_in_array (GArray *indexes,
+                guint   index)
+{
+    guint i;
+
+    for (i = 0; i < indexes->len; i++) {
+        if (g_array_index (indexes, guint, i) == index)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+GArray *
+mm_sms_spool_sync_storage (MMSmsSpool   *self,
+                           MMSmsStorage  storage,
+                           GArray       *indexes)
+{
+    gchar  **groups;
+    GArray  *spooled;
+    GArray  *missing;
+    guint    i;
+
+    spooled = g_array_new (FALSE, FALSE, sizeof (guint));
+
+    /* Parts no longer in the device, e.g. removed by some other program */
+    groups = g_key_file_get_groups (self->priv->key_file, NULL);
+    for (i = 0; groups[i]; i++) {
+        MMSmsStorage group_storage;
+        guint        index;
+
+        if (!parse_group (groups[i], &group_storage, &index) || group_storage != storage)
+            continue;
+
+        if (index_in_array (indexes, index))
+            g_array_append_val (spooled, index);
+        else {
+            mm_obj_dbg (self, "part '%s' no longer stored", groups[i]);
+            g_key_file_remove_group (self->priv->key_file, groups[i], NULL);
+            schedule_save (self);
+        }
+    }
+    g_strfreev (groups);
+
+    /* Parts in the device not spooled yet */
+    missing = g_array_new (FALSE, FALSE, sizeof (guint));
+    for (i = 0; i < indexes->len; i++) {
+        guint index;
+
+        index = g_array_index (indexes, guint, i);
+        if (!index_in_array (spooled, index))
+            g_array_append_val (missing, index);
+    }
+    g_array_unref (spooled);
+
+    return missing;
+}
+
+void
+mm_sms_spool_clear_storage (MMSmsSpool   *self,
+                            MMSmsStorage  storage)
+{
+    gchar **groups;
+    guint   i;
+
+    g_key_file_remove_key (self->priv->key_file,
+                           SPOOL_GROUP_LISTED,
+                           mm_sms_storage_get_string (storage),
+                           NULL);
+
+    groups = g_key_file_get_groups (self->priv->key_file, NULL);
+    for (i = 0; groups[i]; i++) {
+        MMSmsStorage group_storage;
+        guint        index;
+
+        if (parse_group (groups[i], &group_storage, &index) && group_storage == storage)
+            g_key_file_remove_group (self->priv->key_file, groups[i], NULL);
+    }
+    g_strfreev (groups);
+
+    schedule_save (self);
+}
+
+/*****************************************************************************/
+
+const gchar *
+mm_sms_spool_get_sim_identifier (MMSmsSpool *self)
+{
+    return self->priv->sim_identifier;
+}
+
+static gchar *
+log_object_build_id (MMLogObject *_self)
+{
+    return g_strdup ("sms-spool");
+}
+
+/*****************************************************************************/
+
+MMSmsSpool *
+mm_sms_spool_new (const gchar *directory,
+                  const gchar *sim_identifier)
+{
+    MMSmsSpool *self;
+    gchar      *filename;
+    GError     *error = NULL;
+
+    g_assert (directory && sim_identifier);
+
+    if (g_mkdir_with_parents (directory, 0700) < 0) {
+        mm_obj_warn (NULL, "couldn't create SMS spool directory '%s'", directory);
+        return NULL;
+    }
+
+    self = g_object_new (MM_TYPE_SMS_SPOOL, NULL);
+    self->priv->sim_identifier = g_strdup (sim_identifier);
+    filename = g_strdup_printf ("%s.spool", sim_identifier);
+    self->priv->path = g_build_filename (directory, filename, NULL);
+    g_free (filename);
+
+    if (!g_key_file_load_from_file (self->priv->key_file, self->priv->path, G_KEY_FILE_NONE, &error)) {
+        if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+            mm_obj_warn (self, "couldn't load SMS spool '%s', starting a new one: %s",
+                         self->priv->path, error->message);
+        g_error_free (error);
+    }
+
+    return self;
+}
+
+static void
+mm_sms_spool_init (MMSmsSpool *self)
+{
+    self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_SMS_SPOOL, MMSmsSpoolPrivate);
+    self->priv->key_file = g_key_file_new ();
+}
+
+static void
+finalize (GObject *object)
+{
+    MMSmsSpool *self = MM_SMS_SPOOL (object);
+
+    /* Flush any pending update */
+    if (self->priv->save_id) {
+        g_source_remove (self->priv->save_id);
+        save_cb (self);
+    }
+
+    g_key_file_unref (self->priv->key_file);
+    g_free (self->priv->path);
+    g_free (self->priv->sim_identifier);
+
+    G_OBJECT_CLASS (mm_sms_spool_parent_class)->finalize (object);
+}
+
+static void
+log_object_iface_init (MMLogObjectInterface *iface)
+{
+    iface->build_id = log_object_build_id;
+}
+
+static void
+mm_sms_spool_class_init (MMSmsSpoolClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    g_type_class_add_private (object_class, sizeof (MMSmsSpoolPrivate));
+
+    object_class->finalize = finalize;
+}
@@ -0,0 +1,86 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_SMS_SPOOL_H
+#define MM_SMS_SPOOL_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+/* On-disk record of the SMS parts already read from the device storages,
+ * keyed by storage and index. Each SIM card gets its own spool file, named
+ * after its identifier. */
+
+#define MM_TYPE_SMS_SPOOL            (mm_sms_spool_get_type ())
+#define MM_SMS_SPOOL(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_SMS_SPOOL, MMSmsSpool))
+#define MM_SMS_SPOOL_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),  MM_TYPE_SMS_SPOOL, MMSmsSpoolClass))
+#define MM_IS_SMS_SPOOL(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_SMS_SPOOL))
+#define MM_IS_SMS_SPOOL_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  MM_TYPE_SMS_SPOOL))
+#define MM_SMS_SPOOL_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  MM_TYPE_SMS_SPOOL, MMSmsSpoolClass))
+
+typedef struct _MMSmsSpool MMSmsSpool;
+typedef struct _MMSmsSpoolClass MMSmsSpoolClass;
+typedef struct _MMSmsSpoolPrivate MMSmsSpoolPrivate;
+
+struct _MMSmsSpool {
+    GObject parent;
+    MMSmsSpoolPrivate *priv;
+};
+
+struct _MMSmsSpoolClass {
+    GObjectClass parent;
+};
+
+GType mm_sms_spool_get_type (void);
+
+MMSmsSpool  *mm_sms_spool_new         (const gchar *directory,
+                                       const gchar *sim_identifier);
+const gchar *mm_sms_spool_get_sim_identifier (MMSmsSpool *self);
+
+guint  mm_sms_spool_get_count         (MMSmsSpool   *self,
+                                       MMSmsStorage  storage);
+/* Returns a list of MM3gppPduInfo, free with mm_3gpp_pdu_info_list_free() */
+GList *mm_sms_spool_get_parts         (MMSmsSpool   *self,
+                                       MMSmsStorage  storage);
+
+void   mm_sms_spool_add_part          (MMSmsSpool   *self,
+                                       MMSmsStorage  storage,
+                                       guint         index,
+                                       gint          status,
+                                       const gchar  *pdu);
+void   mm_sms_spool_remove_part       (MMSmsSpool   *self,
+                                       MMSmsStorage  storage,
+                                       guint         index);
+void   mm_sms_spool_clear_storage     (MMSmsSpool   *self,
+                                       MMSmsStorage  storage);
+
+/* Returns TRUE if the spooled parts of the storage can be used instead of
+ * listing it, given the number of parts reported by the device ('used') */
+gboolean mm_sms_spool_check_storage      (MMSmsSpool   *self,
+                                          MMSmsStorage  storage,
+                                          guint         used);
+gboolean mm_sms_spool_get_storage_listed (MMSmsSpool   *self,
+                                          MMSmsStorage  storage);
+void     mm_sms_spool_set_storage_listed (MMSmsSpool   *self,
+                                          MMSmsStorage  storage);
+/* Drops the spooled parts of the storage whose index isn't in 'indexes' (the
+ * ones in use in the device), and returns a GArray with the indexes in use
+ * that aren't spooled yet */
+GArray  *mm_sms_spool_sync_storage       (MMSmsSpool   *self,
+                                          MMSmsStorage  storage,
+                                          GArray       *indexes);
+
+#endif /* MM_SMS_SPOOL_H */
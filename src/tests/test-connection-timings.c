@@ -0,0 +1,128 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <locale.h>
+
+#include "mm-connection-timings.h"
+#include "mm-log-test.h"
+
+#define MSEC(ms) ((gint64) (ms) * 1000)
+
+/*****************************************************************************/
+
+static void
+test_timings (void)
+{
+    MMConnectionTimings *timings;
+    GVariant            *result;
+    const gchar         *step;
+    guint                elapsed;
+
+    timings = mm_connection_timings_new (MSEC (5000));
+    result = mm_connection_timings_get_variant (timings);
+    g_assert_cmpuint (g_variant_n_children (result), ==, 0);
+    g_variant_unref (result);
+
+    mm_connection_timings_mark (timings, "dial", MSEC (5120));
+    mm_connection_timings_mark (timings, "ip-config", MSEC (5400));
+    g_assert_cmpuint (mm_connection_timings_get_elapsed (timings), ==, 400);
+
+    result = mm_connection_timings_get_variant (timings);
+    g_assert_cmpuint (g_variant_n_children (result), ==, 2);
+    g_variant_get_child (result, 0, "(&su)", &step, &elapsed);
+    g_assert_cmpstr (step, ==, "dial");
+    g_assert_cmpuint (elapsed, ==, 120);
+    g_variant_get_child (result, 1, "(&su)", &step, &elapsed);
+    g_assert_cmpstr (step, ==, "ip-config");
+    g_assert_cmpuint (elapsed, ==, 400);
+    g_variant_unref (result);
+
+    mm_connection_timings_free (timings);
+}
+
+static void
+assert_counts (GVariant    *histograms,
+               const gchar *step,
+               const guint *expected)
+{
+    GVariant      *counts;
+    const guint32 *values;
+    gsize          n_values;
+    guint          i;
+
+    counts = g_variant_lookup_value (histograms, step, G_VARIANT_TYPE ("au"));
+    g_assert (counts);
+    values = g_variant_get_fixed_array (counts, &n_values, sizeof (guint32));
+    g_assert_cmpuint (n_values, ==, MM_CONNECTION_TIMINGS_HISTOGRAM_N_BUCKETS);
+    for (i = 0; i < n_values; i++)
+        g_assert_cmpuint (values[i], ==, expected[i]);
+    g_variant_unref (counts);
+}
+
+static void
+test_histogram (void)
+{
+    MMConnectionTimingsHistogram *histogram;
+    MMConnectionTimings          *timings;
+    GVariant                     *result;
+    const gchar                  *step;
+    static const guint dial[]      = { 1, 0, 0, 0, 0, 0, 0, 0, 1 };
+    static const guint ip_config[] = { 0, 1, 0, 0, 0, 0, 0, 0, 0 };
+    static const guint total[]     = { 0, 0, 1, 0, 0, 0, 0, 0, 1 };
+
+    histogram = mm_connection_timings_histogram_new ();
+
+    /* dial 100ms (bounds are inclusive), ip-config 150ms */
+    timings = mm_connection_timings_new (0);
+    mm_connection_timings_mark (timings, "dial", MSEC (100));
+    mm_connection_timings_mark (timings, "ip-config", MSEC (250));
+    mm_connection_timings_histogram_add (histogram, timings);
+    mm_connection_timings_free (timings);
+
+    /* dial failing after a long time */
+    timings = mm_connection_timings_new (0);
+    mm_connection_timings_mark (timings, "dial", MSEC (45000));
+    mm_connection_timings_histogram_add (histogram, timings);
+    mm_connection_timings_free (timings);
+
+    result = mm_connection_timings_histogram_get_variant (histogram);
+    g_assert_cmpuint (g_variant_n_children (result), ==, 3);
+
+    /* Steps in the order they were first seen */
+    g_variant_get_child (result, 0, "{&s@au}", &step, NULL);
+    g_assert_cmpstr (step, ==, "dial");
+    g_variant_get_child (result, 2, "{&s@au}", &step, NULL);
+    g_assert_cmpstr (step, ==, MM_CONNECTION_TIMINGS_TOTAL);
+
+    assert_counts (result, "dial", dial);
+    assert_counts (result, "ip-config", ip_config);
+    assert_counts (result, MM_CONNECTION_TIMINGS_TOTAL, total);
+    g_variant_unref (result);
+
+    mm_connection_timings_histogram_free (histogram);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/connection-timings/timings",   test_timings);
+    g_test_add_func ("/MM/connection-timings/histogram", test_histogram);
+
+    return g_test_run ();
+}
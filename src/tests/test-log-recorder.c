@@ -0,0 +1,155 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <locale.h>
+#include <string.h>
+
+#include "mm-log-recorder.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+static void
+add (MMLogRecorder *recorder,
+     MMLogLevel     level,
+     const gchar   *object_id,
+     const gchar   *fmt,
+     ...) G_GNUC_PRINTF (4, 5);
+
+static void
+add (MMLogRecorder *recorder,
+     MMLogLevel     level,
+     const gchar   *object_id,
+     const gchar   *fmt,
+     ...)
+{
+    va_list args;
+
+    va_start (args, fmt);
+    mm_log_recorder_add (recorder, level, object_id, "test", fmt, args);
+    va_end (args);
+}
+
+/* Skips the level and timestamp */
+static const gchar *
+message_of (const gchar *line)
+{
+    const gchar *p;
+
+    p = strstr (line, "] ");
+    g_assert (p);
+    return p + 2;
+}
+
+/*****************************************************************************/
+
+static void
+test_format (void)
+{
+    MMLogRecorder  *recorder;
+    gchar         **lines;
+
+    recorder = mm_log_recorder_new (4);
+    add (recorder, MM_LOG_LEVEL_DEBUG, "modem0", "hello %s %u", "world", 42);
+    add (recorder, MM_LOG_LEVEL_ERR, NULL, "no object");
+
+    lines = mm_log_recorder_dump (recorder);
+    g_assert_cmpuint (g_strv_length (lines), ==, 2);
+    g_assert (g_str_has_prefix (lines[0], "<debug> ["));
+    g_assert_cmpstr (message_of (lines[0]), ==, "[modem0] (test) hello world 42");
+    g_assert (g_str_has_prefix (lines[1], "<error> ["));
+    g_assert_cmpstr (message_of (lines[1]), ==, "(test) no object");
+    g_strfreev (lines);
+
+    mm_log_recorder_unref (recorder);
+}
+
+static void
+test_wraparound (void)
+{
+    MMLogRecorder  *recorder;
+    gchar         **lines;
+    guint           i;
+
+    recorder = mm_log_recorder_new (3);
+    for (i = 0; i < 10; i++)
+        add (recorder, MM_LOG_LEVEL_INFO, NULL, "%u", i);
+    g_assert_cmpuint (mm_log_recorder_get_n_records (recorder), ==, 3);
+
+    /* Only the most recent ones, oldest first */
+    lines = mm_log_recorder_dump (recorder);
+    g_assert_cmpuint (g_strv_length (lines), ==, 3);
+    g_assert_cmpstr (message_of (lines[0]), ==, "(test) 7");
+    g_assert_cmpstr (message_of (lines[1]), ==, "(test) 8");
+    g_assert_cmpstr (message_of (lines[2]), ==, "(test) 9");
+    g_strfreev (lines);
+
+    mm_log_recorder_clear (recorder);
+    g_assert_cmpuint (mm_log_recorder_get_n_records (recorder), ==, 0);
+    lines = mm_log_recorder_dump (recorder);
+    g_assert_cmpuint (g_strv_length (lines), ==, 0);
+    g_strfreev (lines);
+
+    add (recorder, MM_LOG_LEVEL_INFO, NULL, "after clear");
+    lines = mm_log_recorder_dump (recorder);
+    g_assert_cmpuint (g_strv_length (lines), ==, 1);
+    g_assert_cmpstr (message_of (lines[0]), ==, "(test) after clear");
+    g_strfreev (lines);
+
+    mm_log_recorder_unref (recorder);
+}
+
+static void
+test_truncation (void)
+{
+    MMLogRecorder  *recorder;
+    gchar         **lines;
+    gchar          *long_id;
+    gchar          *long_message;
+
+    recorder = mm_log_recorder_new (2);
+
+    long_message = g_strnfill (1000, 'x');
+    add (recorder, MM_LOG_LEVEL_DEBUG, "modem0", "%s", long_message);
+    /* Object id alone longer than the slot */
+    long_id = g_strnfill (1000, 'y');
+    add (recorder, MM_LOG_LEVEL_DEBUG, long_id, "lost");
+
+    lines = mm_log_recorder_dump (recorder);
+    g_assert_cmpuint (g_strv_length (lines), ==, 2);
+    g_assert_cmpuint (strlen (message_of (lines[0])), ==, MM_LOG_RECORDER_MESSAGE_LEN);
+    g_assert (g_str_has_prefix (message_of (lines[0]), "[modem0] (test) xxx"));
+    g_assert_cmpuint (strlen (message_of (lines[1])), ==, MM_LOG_RECORDER_MESSAGE_LEN);
+    g_assert (strstr (lines[1], "lost") == NULL);
+    g_strfreev (lines);
+
+    g_free (long_id);
+    g_free (long_message);
+    mm_log_recorder_unref (recorder);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/log-recorder/format",     test_format);
+    g_test_add_func ("/MM/log-recorder/wraparound", test_wraparound);
+    g_test_add_func ("/MM/log-recorder/truncation", test_truncation);
+
+    return g_test_run ();
+}
@@ -0,0 +1,199 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <locale.h>
+#include <string.h>
+
+#include "mm-log-ring.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+static gboolean
+push_string (MMLogRing   *ring,
+             gint         priority,
+             const gchar *message)
+{
+    return mm_log_ring_push (ring, priority, G_STRLOC, G_STRFUNC, message, strlen (message));
+}
+
+static void
+test_fifo (void)
+{
+    MMLogRing   *ring;
+    MMLogRecord  records[8];
+    guint        n;
+
+    ring = mm_log_ring_new (4);
+
+    n = mm_log_ring_peek (ring, records, G_N_ELEMENTS (records));
+    g_assert_cmpuint (n, ==, 0);
+
+    g_assert (push_string (ring, 1, "one\n"));
+    g_assert (push_string (ring, 2, "two\n"));
+    g_assert (push_string (ring, 3, "three\n"));
+    g_assert (push_string (ring, 4, "four\n"));
+    /* Full */
+    g_assert (!push_string (ring, 5, "five\n"));
+
+    n = mm_log_ring_peek (ring, records, 2);
+    g_assert_cmpuint (n, ==, 2);
+    g_assert_cmpint (records[0].priority, ==, 1);
+    g_assert_cmpstr (records[0].message, ==, "one\n");
+    g_assert_cmpuint (records[0].length, ==, 4);
+    g_assert_cmpstr (records[0].func, ==, G_STRFUNC);
+    g_assert_cmpstr (records[1].message, ==, "two\n");
+
+    /* Peeking again without releasing returns the same records */
+    n = mm_log_ring_peek (ring, records, G_N_ELEMENTS (records));
+    g_assert_cmpuint (n, ==, 4);
+    g_assert_cmpstr (records[0].message, ==, "one\n");
+    g_assert_cmpstr (records[3].message, ==, "four\n");
+
+    /* Room for more after releasing, wrapping around */
+    mm_log_ring_release (ring, 2);
+    g_assert (push_string (ring, 5, "five\n"));
+    g_assert (push_string (ring, 6, "six\n"));
+    g_assert (!push_string (ring, 7, "seven\n"));
+
+    n = mm_log_ring_peek (ring, records, G_N_ELEMENTS (records));
+    g_assert_cmpuint (n, ==, 4);
+    g_assert_cmpstr (records[0].message, ==, "three\n");
+    g_assert_cmpstr (records[3].message, ==, "six\n");
+    g_assert_cmpint (records[3].priority, ==, 6);
+    mm_log_ring_release (ring, n);
+
+    n = mm_log_ring_peek (ring, records, G_N_ELEMENTS (records));
+    g_assert_cmpuint (n, ==, 0);
+
+    mm_log_ring_free (ring);
+}
+
+static void
+test_long_message (void)
+{
+    MMLogRing   *ring;
+    MMLogRecord  record;
+    gchar       *message;
+    guint        n;
+
+    ring = mm_log_ring_new (2);
+
+    message = g_strnfill (MM_LOG_RING_INLINE_MESSAGE_LEN * 3, 'x');
+    g_assert (push_string (ring, 0, message));
+    n = mm_log_ring_peek (ring, &record, 1);
+    g_assert_cmpuint (n, ==, 1);
+    g_assert_cmpuint (record.length, ==, MM_LOG_RING_INLINE_MESSAGE_LEN * 3);
+    g_assert_cmpstr (record.message, ==, message);
+    mm_log_ring_release (ring, 1);
+
+    /* Same slot reused for a short one afterwards */
+    g_assert (push_string (ring, 0, "short"));
+    g_assert (push_string (ring, 0, "short"));
+    n = mm_log_ring_peek (ring, &record, 1);
+    g_assert_cmpuint (n, ==, 1);
+    g_assert_cmpstr (record.message, ==, "short");
+
+    /* Pending records are freed with the ring */
+    mm_log_ring_free (ring);
+    g_free (message);
+}
+
+/*****************************************************************************/
+
+#define N_PRODUCERS           4
+#define N_MESSAGES_PER_THREAD 20000
+
+typedef struct {
+    MMLogRing *ring;
+    gint       id;
+} Producer;
+
+static gpointer
+producer_thread (Producer *producer)
+{
+    guint i;
+
+    for (i = 0; i < N_MESSAGES_PER_THREAD; i++) {
+        gchar message[32];
+
+        g_snprintf (message, sizeof (message), "%u", i);
+        while (!push_string (producer->ring, producer->id, message))
+            g_thread_yield ();
+    }
+    return NULL;
+}
+
+static void
+test_threads (void)
+{
+    MMLogRing *ring;
+    Producer   producers[N_PRODUCERS];
+    GThread   *threads[N_PRODUCERS];
+    guint      expected[N_PRODUCERS] = { 0 };
+    guint      n_received = 0;
+    guint      i;
+
+    ring = mm_log_ring_new (64);
+
+    for (i = 0; i < N_PRODUCERS; i++) {
+        producers[i].ring = ring;
+        producers[i].id = (gint) i;
+        threads[i] = g_thread_new ("producer", (GThreadFunc) producer_thread, &producers[i]);
+    }
+
+    /* Every record arrives exactly once, complete, and in the order each
+     * producer pushed them */
+    while (n_received < N_PRODUCERS * N_MESSAGES_PER_THREAD) {
+        MMLogRecord records[16];
+        guint       n;
+        guint       j;
+
+        n = mm_log_ring_peek (ring, records, G_N_ELEMENTS (records));
+        for (j = 0; j < n; j++) {
+            gint id;
+
+            id = records[j].priority;
+            g_assert_cmpint (id, >=, 0);
+            g_assert_cmpint (id, <, N_PRODUCERS);
+            g_assert_cmpuint (records[j].length, ==, strlen (records[j].message));
+            g_assert_cmpuint (g_ascii_strtoull (records[j].message, NULL, 10), ==, expected[id]);
+            expected[id]++;
+        }
+        mm_log_ring_release (ring, n);
+        n_received += n;
+        if (!n)
+            g_thread_yield ();
+    }
+
+    for (i = 0; i < N_PRODUCERS; i++)
+        g_thread_join (threads[i]);
+
+    mm_log_ring_free (ring);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/log-ring/fifo",         test_fifo);
+    g_test_add_func ("/MM/log-ring/long-message", test_long_message);
+    g_test_add_func ("/MM/log-ring/threads",      test_threads);
+
+    return g_test_run ();
+}
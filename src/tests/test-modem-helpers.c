@@ -407,6 +407,30 @@ test_cmgl_response_pantech_multiple (void *f, gpointer d)
     test_cmgl_response (str, expected, G_N_ELEMENTS (expected));
 }
 
+static void
+test_cmgl_header (void *f, gpointer d)
+{
+    gint index = -1;
+    gint status = -1;
+
+    g_assert (mm_3gpp_parse_pdu_cmgl_header ("+CMGL: 0,1,,147", &index, &status));
+    g_assert_cmpint (index, ==, 0);
+    g_assert_cmpint (status, ==, 1);
+
+    g_assert (mm_3gpp_parse_pdu_cmgl_header ("+CMGL: 17,3,35", &index, &status));
+    g_assert_cmpint (index, ==, 17);
+    g_assert_cmpint (status, ==, 3);
+
+    g_assert (mm_3gpp_parse_pdu_cmgl_header ("+CMGL:  5 , 2 ,\"alpha\",23", &index, &status));
+    g_assert_cmpint (index, ==, 5);
+    g_assert_cmpint (status, ==, 2);
+
+    g_assert (!mm_3gpp_parse_pdu_cmgl_header ("07914306073011F00405812261F7", &index, &status));
+    g_assert (!mm_3gpp_parse_pdu_cmgl_header ("+CMGL: 1", &index, &status));
+    g_assert (!mm_3gpp_parse_pdu_cmgl_header ("+CMGL: 1,\"REC READ\",\"+123\"", &index, &status));
+    g_assert (!mm_3gpp_parse_pdu_cmgl_header ("OK", &index, &status));
+}
+
 /*****************************************************************************/
 /* Test CMGR responses */
 
@@ -3129,6 +3153,59 @@ test_cpms_query_response (void *f, gpointer d) {
     }
 }
 
+static void
+test_cpms_query_used (void *f, gpointer d)
+{
+    guint used = 0;
+    GError *error = NULL;
+
+    g_assert (mm_3gpp_parse_cpms_query_used ("+CPMS: \"ME\",1,100,\"ME\",1,100,\"ME\",1,100", &used, &error));
+    g_assert_no_error (error);
+    g_assert_cmpuint (used, ==, 1);
+
+    g_assert (mm_3gpp_parse_cpms_query_used ("+CPMS: \"SM\", 23 , 30,\"SM\",23,30,\"SM\",23,30", &used, &error));
+    g_assert_no_error (error);
+    g_assert_cmpuint (used, ==, 23);
+
+    g_assert (!mm_3gpp_parse_cpms_query_used ("+CPMS: \"SM\",,30", &used, &error));
+    g_assert (error);
+    g_clear_error (&error);
+}
+
+static void
+test_cmgd_test_response (void *f, gpointer d)
+{
+    GArray *indexes;
+    GError *error = NULL;
+
+    indexes = mm_3gpp_parse_cmgd_test_response ("+CMGD: (4,1,3),(0-4)", &error);
+    g_assert_no_error (error);
+    g_assert (indexes);
+    g_assert_cmpuint (indexes->len, ==, 3);
+    g_assert_cmpuint (g_array_index (indexes, guint, 0), ==, 1);
+    g_assert_cmpuint (g_array_index (indexes, guint, 1), ==, 3);
+    g_assert_cmpuint (g_array_index (indexes, guint, 2), ==, 4);
+    g_array_unref (indexes);
+
+    indexes = mm_3gpp_parse_cmgd_test_response ("+CMGD: ( 0, 2-3 ),(0-4)", &error);
+    g_assert_no_error (error);
+    g_assert (indexes);
+    g_assert_cmpuint (indexes->len, ==, 3);
+    g_assert_cmpuint (g_array_index (indexes, guint, 2), ==, 3);
+    g_array_unref (indexes);
+
+    indexes = mm_3gpp_parse_cmgd_test_response ("+CMGD: (),(0-4)", &error);
+    g_assert_no_error (error);
+    g_assert (indexes);
+    g_assert_cmpuint (indexes->len, ==, 0);
+    g_array_unref (indexes);
+
+    indexes = mm_3gpp_parse_cmgd_test_response ("+CMGD: (a,b),(0-4)", &error);
+    g_assert (!indexes);
+    g_assert (error);
+    g_clear_error (&error);
+}
+
 /*****************************************************************************/
 /* Test CNUM responses */
 
@@ -4460,6 +4537,153 @@ test_bcd_to_string (void *f, gpointer d)
     }
 }
 
+/*****************************************************************************/
+/* Test /proc/net/dev contents */
+
+static const gchar *proc_net_dev =
+    "Inter-|   Receive                                                |  Transmit\n"
+    " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n"
+    "    lo:  123456     789    0    0    0     0          0         0   123456     789    0    0    0     0       0          0\n"
+    " wwan0: 18446744073709551615 52 0 0 0 0 0 0 9876 41 0 0 0 0 0 0\n"
+    "wwan10:5000 10 1 2 3 4 5 6 7000 14 0 0 0 0 0 0\n"
+    " wwan1:    1000      10    0    0\n";
+
+static void
+test_proc_net_dev (void *f, gpointer d)
+{
+    GError   *error = NULL;
+    guint64   rx_bytes = 0;
+    guint64   tx_bytes = 0;
+    gboolean  result;
+
+    result = mm_parse_proc_net_dev (proc_net_dev, "lo", &rx_bytes, &tx_bytes, &error);
+    g_assert_no_error (error);
+    g_assert (result);
+    g_assert_cmpuint (rx_bytes, ==, 123456);
+    g_assert_cmpuint (tx_bytes, ==, 123456);
+
+    result = mm_parse_proc_net_dev (proc_net_dev, "wwan0", &rx_bytes, &tx_bytes, &error);
+    g_assert_no_error (error);
+    g_assert (result);
+    g_assert_cmpuint (rx_bytes, ==, G_MAXUINT64);
+    g_assert_cmpuint (tx_bytes, ==, 9876);
+
+    /* No space after the colon, and name sharing a prefix with another one */
+    result = mm_parse_proc_net_dev (proc_net_dev, "wwan10", &rx_bytes, &tx_bytes, &error);
+    g_assert_no_error (error);
+    g_assert (result);
+    g_assert_cmpuint (rx_bytes, ==, 5000);
+    g_assert_cmpuint (tx_bytes, ==, 7000);
+
+    /* Truncated line */
+    result = mm_parse_proc_net_dev (proc_net_dev, "wwan1", &rx_bytes, &tx_bytes, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_NOT_FOUND);
+    g_assert (!result);
+    g_clear_error (&error);
+
+    result = mm_parse_proc_net_dev (proc_net_dev, "wwan", &rx_bytes, &tx_bytes, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_NOT_FOUND);
+    g_assert (!result);
+    g_clear_error (&error);
+}
+
+/*****************************************************************************/
+/* Test the adaptive signal check interval */
+
+#define CHECK_FAST 10
+#define CHECK_MAX  300
+
+static guint
+signal_check_sample (MMSignalCheckInterval *interval,
+                     guint                  signal_quality)
+{
+    return mm_signal_check_interval_update (interval,
+                                            TRUE, signal_quality,
+                                            TRUE, MM_MODEM_ACCESS_TECHNOLOGY_LTE,
+                                            FALSE,
+                                            CHECK_FAST, CHECK_MAX);
+}
+
+static void
+test_signal_check_interval_backoff (void *f, gpointer d)
+{
+    MMSignalCheckInterval interval = { 0 };
+    guint                 i;
+
+    mm_signal_check_interval_reset (&interval, CHECK_FAST);
+    interval.access_technologies = MM_MODEM_ACCESS_TECHNOLOGY_LTE;
+    mm_signal_check_interval_report (&interval, 50);
+
+    /* Small changes are noise; the interval doubles after each run of
+     * stable samples, up to the maximum */
+    g_assert_cmpuint (signal_check_sample (&interval, 52), ==, CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 48), ==, CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 51), ==, 2 * CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 50), ==, 2 * CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 50), ==, 2 * CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 50), ==, 4 * CHECK_FAST);
+
+    for (i = 0; i < 5 * MM_SIGNAL_CHECK_STABLE_SAMPLES; i++)
+        signal_check_sample (&interval, 50);
+    g_assert_cmpuint (interval.interval, ==, CHECK_MAX);
+}
+
+static void
+test_signal_check_interval_hysteresis (void *f, gpointer d)
+{
+    MMSignalCheckInterval interval = { 0 };
+
+    mm_signal_check_interval_reset (&interval, 8 * CHECK_FAST);
+    interval.access_technologies = MM_MODEM_ACCESS_TECHNOLOGY_LTE;
+    mm_signal_check_interval_report (&interval, 50);
+
+    /* A single significant change doesn't speed up polling... */
+    g_assert_cmpuint (signal_check_sample (&interval, 60), ==, 8 * CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 60), ==, 8 * CHECK_FAST);
+    /* ...but consecutive ones do */
+    g_assert_cmpuint (signal_check_sample (&interval, 40), ==, 8 * CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 30), ==, CHECK_FAST);
+
+    /* Slow drift is compared against the last reference value (30), not
+     * against the previous sample */
+    mm_signal_check_interval_reset (&interval, 8 * CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 33), ==, 8 * CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 36), ==, 8 * CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 41), ==, CHECK_FAST);
+
+    /* Known values reported meanwhile are not changes */
+    mm_signal_check_interval_reset (&interval, 8 * CHECK_FAST);
+    mm_signal_check_interval_report (&interval, 70);
+    g_assert_cmpuint (signal_check_sample (&interval, 70), ==, 8 * CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 71), ==, 8 * CHECK_FAST);
+    g_assert_cmpuint (signal_check_sample (&interval, 70), ==, 16 * CHECK_FAST);
+}
+
+static void
+test_signal_check_interval_access_tech (void *f, gpointer d)
+{
+    MMSignalCheckInterval interval = { 0 };
+
+    mm_signal_check_interval_reset (&interval, 8 * CHECK_FAST);
+    interval.access_technologies = MM_MODEM_ACCESS_TECHNOLOGY_LTE;
+    mm_signal_check_interval_report (&interval, 50);
+
+    g_assert_cmpuint (mm_signal_check_interval_update (&interval, TRUE, 50, TRUE, MM_MODEM_ACCESS_TECHNOLOGY_UMTS, FALSE, CHECK_FAST, CHECK_MAX), ==, 8 * CHECK_FAST);
+    g_assert_cmpuint (mm_signal_check_interval_update (&interval, TRUE, 50, TRUE, MM_MODEM_ACCESS_TECHNOLOGY_LTE, FALSE, CHECK_FAST, CHECK_MAX), ==, CHECK_FAST);
+
+    /* Values not loaded are not compared */
+    mm_signal_check_interval_reset (&interval, 8 * CHECK_FAST);
+    g_assert_cmpuint (mm_signal_check_interval_update (&interval, FALSE, 0, FALSE, MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN, FALSE, CHECK_FAST, CHECK_MAX), ==, 8 * CHECK_FAST);
+    g_assert_cmpuint (mm_signal_check_interval_update (&interval, FALSE, 0, FALSE, MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN, FALSE, CHECK_FAST, CHECK_MAX), ==, 8 * CHECK_FAST);
+    g_assert_cmpuint (mm_signal_check_interval_update (&interval, FALSE, 0, FALSE, MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN, FALSE, CHECK_FAST, CHECK_MAX), ==, 16 * CHECK_FAST);
+
+    /* Connecting always polls fast right away */
+    g_assert_cmpuint (mm_signal_check_interval_update (&interval, TRUE, 50, TRUE, MM_MODEM_ACCESS_TECHNOLOGY_LTE, TRUE, CHECK_FAST, CHECK_MAX), ==, CHECK_FAST);
+}
+
+#undef CHECK_FAST
+#undef CHECK_MAX
+
 /*****************************************************************************/
 
 #define TESTCASE(t, d) g_test_create_case (#t, 0, d, NULL, (GTestFixtureFunc) t, NULL)
@@ -4622,6 +4846,8 @@ int main (int argc, char **argv)
     g_test_suite_add (suite, TESTCASE (test_cpms_response_mixed_spaces, NULL));
     g_test_suite_add (suite, TESTCASE (test_cpms_response_empty_fields, NULL));
     g_test_suite_add (suite, TESTCASE (test_cpms_query_response,        NULL));
+    g_test_suite_add (suite, TESTCASE (test_cpms_query_used,            NULL));
+    g_test_suite_add (suite, TESTCASE (test_cmgd_test_response,         NULL));
 
     g_test_suite_add (suite, TESTCASE (test_cmp_apn_name, NULL));
 
@@ -4658,6 +4884,7 @@ int main (int argc, char **argv)
     g_test_suite_add (suite, TESTCASE (test_cmgl_response_generic_multiple, NULL));
     g_test_suite_add (suite, TESTCASE (test_cmgl_response_pantech, NULL));
     g_test_suite_add (suite, TESTCASE (test_cmgl_response_pantech_multiple, NULL));
+    g_test_suite_add (suite, TESTCASE (test_cmgl_header, NULL));
 
     g_test_suite_add (suite, TESTCASE (test_cmgr_response_generic, NULL));
     g_test_suite_add (suite, TESTCASE (test_cmgr_response_telit, NULL));
@@ -4693,6 +4920,12 @@ int main (int argc, char **argv)
 
     g_test_suite_add (suite, TESTCASE (test_bcd_to_string, NULL));
 
+    g_test_suite_add (suite, TESTCASE (test_proc_net_dev, NULL));
+
+    g_test_suite_add (suite, TESTCASE (test_signal_check_interval_backoff, NULL));
+    g_test_suite_add (suite, TESTCASE (test_signal_check_interval_hysteresis, NULL));
+    g_test_suite_add (suite, TESTCASE (test_signal_check_interval_access_tech, NULL));
+
     result = g_test_run ();
 
     reg_test_data_free (reg_data);
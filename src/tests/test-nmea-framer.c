@@ -0,0 +1,139 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <locale.h>
+#include <string.h>
+
+#include "mm-nmea-framer.h"
+#include "mm-log-test.h"
+
+#define GGA "$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76"
+#define RMC "$GPRMC,092750.000,A,5321.6802,N,00630.3372,W,0.02,31.66,280511,,,A*43"
+
+/*****************************************************************************/
+
+static void
+sentence_cb (const gchar *sentence,
+             gsize        len,
+             GPtrArray   *sentences)
+{
+    g_assert_cmpuint (strlen (sentence), ==, len);
+    g_ptr_array_add (sentences, g_strdup (sentence));
+}
+
+static gsize
+process (GByteArray        *buffer,
+         const gchar       *str,
+         MMNmeaFramerStats *stats,
+         GPtrArray         *sentences)
+{
+    gsize consumed;
+
+    g_byte_array_append (buffer, (const guint8 *) str, strlen (str));
+    consumed = mm_nmea_framer_process (buffer->data, buffer->len, stats,
+                                       (MMNmeaFramerSentenceFn) sentence_cb, sentences);
+    g_byte_array_remove_range (buffer, 0, consumed);
+    return consumed;
+}
+
+/*****************************************************************************/
+
+static void
+test_split (void)
+{
+    MMNmeaFramerStats  stats = { 0 };
+    GByteArray        *buffer;
+    GPtrArray         *sentences;
+
+    buffer = g_byte_array_new ();
+    sentences = g_ptr_array_new_with_free_func (g_free);
+
+    /* Partial sentence is kept until complete */
+    process (buffer, GGA "\r\n$GPRMC,0927", &stats, sentences);
+    g_assert_cmpuint (sentences->len, ==, 1);
+    g_assert_cmpstr (sentences->pdata[0], ==, GGA);
+    g_assert_cmpuint (buffer->len, ==, strlen ("$GPRMC,0927"));
+
+    process (buffer, RMC "\r\n" + strlen ("$GPRMC,0927"), &stats, sentences);
+    g_assert_cmpuint (sentences->len, ==, 2);
+    g_assert_cmpstr (sentences->pdata[1], ==, RMC);
+    g_assert_cmpuint (buffer->len, ==, 0);
+
+    /* Sentences without checksum field are accepted, as well as LF-only
+     * line endings */
+    process (buffer, "$PFOO,1,2\n", &stats, sentences);
+    g_assert_cmpuint (sentences->len, ==, 3);
+    g_assert_cmpstr (sentences->pdata[2], ==, "$PFOO,1,2");
+
+    g_assert_cmpuint (stats.n_sentences, ==, 3);
+    g_assert_cmpuint (stats.n_bad_checksum, ==, 0);
+    g_assert_cmpuint (stats.n_garbage_bytes, ==, 0);
+
+    g_ptr_array_unref (sentences);
+    g_byte_array_unref (buffer);
+}
+
+static void
+test_errors (void)
+{
+    MMNmeaFramerStats  stats = { 0 };
+    GByteArray        *buffer;
+    GPtrArray         *sentences;
+    gchar             *long_sentence;
+
+    buffer = g_byte_array_new ();
+    sentences = g_ptr_array_new_with_free_func (g_free);
+
+    /* Garbage before and between sentences */
+    process (buffer, "OK\r\n" GGA "\r\nxx" RMC "\r\n", &stats, sentences);
+    g_assert_cmpuint (sentences->len, ==, 2);
+    g_assert_cmpuint (stats.n_garbage_bytes, ==, 6);
+
+    /* Wrong and malformed checksums */
+    process (buffer, "$GPGSA,A,3,,,*00\r\n$GPGSA,A,3,,,*6\r\n", &stats, sentences);
+    g_assert_cmpuint (sentences->len, ==, 2);
+    g_assert_cmpuint (stats.n_bad_checksum, ==, 2);
+
+    /* Truncated sentence followed by a complete one */
+    process (buffer, "$GPGGA,0927" GGA "\r\n", &stats, sentences);
+    g_assert_cmpuint (sentences->len, ==, 3);
+    g_assert_cmpstr (sentences->pdata[2], ==, GGA);
+    g_assert_cmpuint (stats.n_garbage_bytes, ==, 6 + strlen ("$GPGGA,0927"));
+
+    /* Endless sentence is dropped */
+    long_sentence = g_strnfill (MM_NMEA_FRAMER_MAX_SENTENCE_LEN + 8, 'A');
+    long_sentence[0] = '$';
+    g_assert_cmpuint (process (buffer, long_sentence, &stats, sentences), ==, strlen (long_sentence));
+    g_assert_cmpuint (buffer->len, ==, 0);
+    g_free (long_sentence);
+
+    g_assert_cmpuint (stats.n_sentences, ==, 3);
+
+    g_ptr_array_unref (sentences);
+    g_byte_array_unref (buffer);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/nmea-framer/split",  test_split);
+    g_test_add_func ("/MM/nmea-framer/errors", test_errors);
+
+    return g_test_run ();
+}
@@ -0,0 +1,123 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <locale.h>
+
+#include "mm-pdp-context-cache.h"
+#include "mm-modem-helpers.h"
+#include "mm-log-test.h"
+
+#define SIM_A "8934071100000000001"
+#define SIM_B "8934071100000000002"
+
+/*****************************************************************************/
+
+static void
+test_key (void)
+{
+    MMPdpContextCache *cache;
+
+    cache = mm_pdp_context_cache_new ();
+
+    /* Nothing cached without SIM identifier */
+    g_assert (!mm_pdp_context_cache_update (cache, NULL, "internet", MM_BEARER_IP_FAMILY_IPV4, 1));
+    g_assert (!mm_pdp_context_cache_update (cache, "", "internet", MM_BEARER_IP_FAMILY_IPV4, 1));
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, NULL, "internet", MM_BEARER_IP_FAMILY_IPV4), ==, 0);
+
+    g_assert (mm_pdp_context_cache_update (cache, SIM_A, "internet", MM_BEARER_IP_FAMILY_IPV4, 1));
+    g_assert (mm_pdp_context_cache_update (cache, SIM_A, "internet", MM_BEARER_IP_FAMILY_IPV6, 2));
+    /* Same entry again */
+    g_assert (!mm_pdp_context_cache_update (cache, SIM_A, "internet", MM_BEARER_IP_FAMILY_IPV4, 1));
+
+    /* APN is case-insensitive */
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_A, "Internet", MM_BEARER_IP_FAMILY_IPV4), ==, 1);
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_A, "internet", MM_BEARER_IP_FAMILY_IPV6), ==, 2);
+
+    /* Every other field of the key must match */
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_B, "internet", MM_BEARER_IP_FAMILY_IPV4), ==, 0);
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_A, "other", MM_BEARER_IP_FAMILY_IPV4), ==, 0);
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_A, NULL, MM_BEARER_IP_FAMILY_IPV4), ==, 0);
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_A, "internet", MM_BEARER_IP_FAMILY_IPV4V6), ==, 0);
+
+    mm_pdp_context_cache_free (cache);
+}
+
+static void
+test_invalidation (void)
+{
+    MMPdpContextCache *cache;
+
+    cache = mm_pdp_context_cache_new ();
+
+    mm_pdp_context_cache_update (cache, SIM_A, "internet", MM_BEARER_IP_FAMILY_IPV4, 1);
+    mm_pdp_context_cache_update (cache, SIM_A, "ims", MM_BEARER_IP_FAMILY_IPV6, 2);
+    mm_pdp_context_cache_update (cache, SIM_B, "internet", MM_BEARER_IP_FAMILY_IPV4, 3);
+
+    /* Redefining a cid for another APN drops the previous entry */
+    g_assert (mm_pdp_context_cache_update (cache, SIM_A, "mms", MM_BEARER_IP_FAMILY_IPV4, 1));
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_A, "internet", MM_BEARER_IP_FAMILY_IPV4), ==, 0);
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_A, "mms", MM_BEARER_IP_FAMILY_IPV4), ==, 1);
+
+    /* Invalidation by cid only drops the entries using it */
+    g_assert_cmpuint (mm_pdp_context_cache_invalidate (cache, 1), ==, 1);
+    g_assert_cmpuint (mm_pdp_context_cache_invalidate (cache, 1), ==, 0);
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_A, "mms", MM_BEARER_IP_FAMILY_IPV4), ==, 0);
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_A, "ims", MM_BEARER_IP_FAMILY_IPV6), ==, 2);
+
+    /* cid 0 drops everything */
+    g_assert_cmpuint (mm_pdp_context_cache_invalidate (cache, 0), ==, 2);
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_A, "ims", MM_BEARER_IP_FAMILY_IPV6), ==, 0);
+    g_assert_cmpuint (mm_pdp_context_cache_lookup (cache, SIM_B, "internet", MM_BEARER_IP_FAMILY_IPV4), ==, 0);
+
+    mm_pdp_context_cache_free (cache);
+}
+
+static void
+test_validate (void)
+{
+    GList  *list;
+    GError *error = NULL;
+
+    list = mm_3gpp_parse_cgdcont_read_response ("+CGDCONT: 1,\"IP\",\"ac.vodafone.es.MNC001.MCC214.GPRS\",\"\",0,0\r\n"
+                                                 "+CGDCONT: 2,\"IPV6\",\"ims\",\"\",0,0\r\n",
+                                                 &error);
+    g_assert_no_error (error);
+    g_assert_cmpuint (g_list_length (list), ==, 2);
+
+    g_assert (mm_pdp_context_cache_validate (list, 1, "ac.vodafone.es", MM_BEARER_IP_FAMILY_IPV4));
+    g_assert (mm_pdp_context_cache_validate (list, 2, "IMS", MM_BEARER_IP_FAMILY_IPV6));
+
+    /* e.g. after a modem reset to factory contexts */
+    g_assert (!mm_pdp_context_cache_validate (list, 3, "internet", MM_BEARER_IP_FAMILY_IPV4));
+    g_assert (!mm_pdp_context_cache_validate (list, 1, "internet", MM_BEARER_IP_FAMILY_IPV4));
+    g_assert (!mm_pdp_context_cache_validate (list, 2, "ims", MM_BEARER_IP_FAMILY_IPV4));
+    g_assert (!mm_pdp_context_cache_validate (NULL, 1, "ac.vodafone.es", MM_BEARER_IP_FAMILY_IPV4));
+
+    mm_3gpp_pdp_context_list_free (list);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/pdp-context-cache/key",          test_key);
+    g_test_add_func ("/MM/pdp-context-cache/invalidation", test_invalidation);
+    g_test_add_func ("/MM/pdp-context-cache/validate",     test_validate);
+
+    return g_test_run ();
+}
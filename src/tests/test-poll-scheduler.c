@@ -0,0 +1,258 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <locale.h>
+
+#include "mm-poll-scheduler.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+typedef struct {
+    MMPollScheduler *scheduler;
+    gint64           now;
+    gboolean         busy;
+} Fixture;
+
+typedef struct {
+    Fixture  *fixture;
+    guint     n_calls;
+    gboolean  keep;
+    /* Job to remove from the callback, or 0 */
+    guint     remove_id;
+    guint     id;
+} Job;
+
+static gint64
+fixture_clock (Fixture *fixture)
+{
+    return fixture->now;
+}
+
+static gboolean
+fixture_busy (Fixture *fixture)
+{
+    return fixture->busy;
+}
+
+static void
+fixture_setup (Fixture       *fixture,
+               gconstpointer  user_data)
+{
+    /* Not aligned to the grid */
+    fixture->now = 1001;
+    fixture->busy = FALSE;
+    fixture->scheduler = mm_poll_scheduler_new (NULL);
+    mm_poll_scheduler_set_clock_func (fixture->scheduler, (MMPollSchedulerClockFunc) fixture_clock, fixture);
+    mm_poll_scheduler_set_busy_func (fixture->scheduler, (MMPollSchedulerBusyFunc) fixture_busy, fixture);
+}
+
+static void
+fixture_teardown (Fixture       *fixture,
+                  gconstpointer  user_data)
+{
+    g_object_unref (fixture->scheduler);
+}
+
+static gboolean
+job_cb (Job *job)
+{
+    job->n_calls++;
+    if (job->remove_id)
+        mm_poll_scheduler_remove (job->fixture->scheduler, job->remove_id);
+    return job->keep ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+static void
+job_add (Fixture        *fixture,
+         Job            *job,
+         guint           interval,
+         MMPollJobFlags  flags)
+{
+    job->fixture = fixture;
+    job->keep = TRUE;
+    job->id = mm_poll_scheduler_add (fixture->scheduler, "test", interval, flags, (GSourceFunc) job_cb, job);
+    g_assert_cmpuint (job->id, !=, 0);
+}
+
+static guint
+dispatch_at (Fixture *fixture,
+             gint64   now)
+{
+    fixture->now = now;
+    return mm_poll_scheduler_dispatch (fixture->scheduler);
+}
+
+/*****************************************************************************/
+
+static void
+test_coalescing (Fixture       *fixture,
+                 gconstpointer  user_data)
+{
+    Job a = { 0 };
+    Job b = { 0 };
+    Job c = { 0 };
+
+    /* Long intervals are aligned to the grid, so jobs added at different
+     * times share the wakeup: 1001+30 and 1003+30 both end up at 1035 */
+    job_add (fixture, &a, 30, MM_POLL_JOB_FLAG_NONE);
+    fixture->now = 1003;
+    job_add (fixture, &b, 30, MM_POLL_JOB_FLAG_NONE);
+    /* Short intervals are not aligned */
+    job_add (fixture, &c, 2, MM_POLL_JOB_FLAG_NONE);
+
+    g_assert_cmpuint (dispatch_at (fixture, 1004), ==, 0);
+    g_assert_cmpuint (dispatch_at (fixture, 1005), ==, 1);
+    g_assert_cmpuint (c.n_calls, ==, 1);
+    c.keep = FALSE;
+    g_assert_cmpuint (dispatch_at (fixture, 1007), ==, 1);
+    g_assert_cmpuint (c.n_calls, ==, 2);
+
+    g_assert_cmpuint (dispatch_at (fixture, 1034), ==, 0);
+    g_assert_cmpuint (dispatch_at (fixture, 1035), ==, 2);
+    g_assert_cmpuint (a.n_calls, ==, 1);
+    g_assert_cmpuint (b.n_calls, ==, 1);
+
+    /* Rescheduled together, c was dropped */
+    g_assert_cmpuint (dispatch_at (fixture, 1065), ==, 2);
+    g_assert_cmpuint (c.n_calls, ==, 2);
+
+    mm_poll_scheduler_remove (fixture->scheduler, a.id);
+    mm_poll_scheduler_remove (fixture->scheduler, b.id);
+    g_assert_cmpuint (dispatch_at (fixture, 1095), ==, 0);
+}
+
+static void
+test_busy_deferral (Fixture       *fixture,
+                    gconstpointer  user_data)
+{
+    Job deferrable = { 0 };
+    Job always = { 0 };
+
+    job_add (fixture, &deferrable, 20, MM_POLL_JOB_FLAG_DEFER_WHEN_BUSY);
+    job_add (fixture, &always, 20, MM_POLL_JOB_FLAG_NONE);
+
+    /* Both due at 1025; only the non-deferrable one runs while busy, the
+     * other one backs off 2s, then 4s... */
+    fixture->busy = TRUE;
+    g_assert_cmpuint (dispatch_at (fixture, 1025), ==, 1);
+    g_assert_cmpuint (always.n_calls, ==, 1);
+    g_assert_cmpuint (deferrable.n_calls, ==, 0);
+
+    g_assert_cmpuint (dispatch_at (fixture, 1026), ==, 0);
+    g_assert_cmpuint (dispatch_at (fixture, 1027), ==, 0);
+    g_assert_cmpuint (deferrable.n_calls, ==, 0);
+    g_assert_cmpuint (dispatch_at (fixture, 1031), ==, 0);
+
+    /* Not busy any more */
+    fixture->busy = FALSE;
+    g_assert_cmpuint (dispatch_at (fixture, 1039), ==, 1);
+    g_assert_cmpuint (deferrable.n_calls, ==, 1);
+
+    /* Never deferred more than one interval in total: 2+4+8+6 */
+    fixture->busy = TRUE;
+    g_assert_cmpuint (dispatch_at (fixture, 1045), ==, 1);
+    g_assert_cmpuint (always.n_calls, ==, 2);
+    g_assert_cmpuint (dispatch_at (fixture, 1060), ==, 0);
+    g_assert_cmpuint (dispatch_at (fixture, 1062), ==, 0);
+    /* The non-deferrable job is due again at 1065 */
+    g_assert_cmpuint (dispatch_at (fixture, 1066), ==, 1);
+    g_assert_cmpuint (always.n_calls, ==, 3);
+    g_assert_cmpuint (dispatch_at (fixture, 1074), ==, 0);
+    /* Runs even if still busy */
+    g_assert_cmpuint (dispatch_at (fixture, 1080), ==, 1);
+    g_assert_cmpuint (deferrable.n_calls, ==, 2);
+}
+
+static void
+test_removal_during_dispatch (Fixture       *fixture,
+                              gconstpointer  user_data)
+{
+    Job a = { 0 };
+    Job b = { 0 };
+    Job c = { 0 };
+
+    job_add (fixture, &a, 20, MM_POLL_JOB_FLAG_NONE);
+    job_add (fixture, &b, 20, MM_POLL_JOB_FLAG_NONE);
+    job_add (fixture, &c, 20, MM_POLL_JOB_FLAG_NONE);
+
+    /* a removes b, which is due in the same batch but not run yet; c
+     * removes itself while asking to be run again */
+    a.remove_id = b.id;
+    c.remove_id = c.id;
+    g_assert_cmpuint (dispatch_at (fixture, 1025), ==, 2);
+    g_assert_cmpuint (a.n_calls, ==, 1);
+    g_assert_cmpuint (b.n_calls, ==, 0);
+    g_assert_cmpuint (c.n_calls, ==, 1);
+
+    /* Only a is left */
+    a.remove_id = 0;
+    g_assert_cmpuint (dispatch_at (fixture, 1045), ==, 1);
+    g_assert_cmpuint (a.n_calls, ==, 2);
+    g_assert_cmpuint (c.n_calls, ==, 1);
+
+    mm_poll_scheduler_remove (fixture->scheduler, a.id);
+    g_assert_cmpuint (dispatch_at (fixture, 1065), ==, 0);
+}
+
+static void
+test_wakeups_per_minute (Fixture       *fixture,
+                         gconstpointer  user_data)
+{
+    Job a = { 0 };
+    Job b = { 0 };
+
+    /* Minute being accounted started at 1001 */
+    g_assert_cmpuint (mm_poll_scheduler_get_wakeups_per_minute (fixture->scheduler), ==, 0);
+
+    /* Two jobs sharing each wakeup, every 20s */
+    job_add (fixture, &a, 20, MM_POLL_JOB_FLAG_NONE);
+    job_add (fixture, &b, 20, MM_POLL_JOB_FLAG_NONE);
+    g_assert_cmpuint (dispatch_at (fixture, 1025), ==, 2);
+    g_assert_cmpuint (dispatch_at (fixture, 1045), ==, 2);
+    g_assert_cmpuint (mm_poll_scheduler_get_wakeups_per_minute (fixture->scheduler), ==, 0);
+
+    /* The minute is over, even if no wakeup rolled the counters over yet */
+    fixture->now = 1061;
+    g_assert_cmpuint (mm_poll_scheduler_get_wakeups_per_minute (fixture->scheduler), ==, 2);
+
+    /* Rolled over by the next wakeup */
+    g_assert_cmpuint (dispatch_at (fixture, 1065), ==, 2);
+    g_assert_cmpuint (mm_poll_scheduler_get_wakeups_per_minute (fixture->scheduler), ==, 2);
+
+    /* No wakeups at all once the jobs are gone */
+    mm_poll_scheduler_remove (fixture->scheduler, a.id);
+    mm_poll_scheduler_remove (fixture->scheduler, b.id);
+    fixture->now = 1125;
+    g_assert_cmpuint (mm_poll_scheduler_get_wakeups_per_minute (fixture->scheduler), ==, 1);
+    fixture->now = 1185;
+    g_assert_cmpuint (mm_poll_scheduler_get_wakeups_per_minute (fixture->scheduler), ==, 0);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add ("/MM/poll-scheduler/coalescing",              Fixture, NULL, fixture_setup, test_coalescing,              fixture_teardown);
+    g_test_add ("/MM/poll-scheduler/busy-deferral",           Fixture, NULL, fixture_setup, test_busy_deferral,           fixture_teardown);
+    g_test_add ("/MM/poll-scheduler/removal-during-dispatch", Fixture, NULL, fixture_setup, test_removal_during_dispatch, fixture_teardown);
+    g_test_add ("/MM/poll-scheduler/wakeups-per-minute",      Fixture, NULL, fixture_setup, test_wakeups_per_minute,      fixture_teardown);
+
+    return g_test_run ();
+}
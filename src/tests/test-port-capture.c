@@ -0,0 +1,320 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <locale.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ModemManager.h>
+#include <mm-errors-types.h>
+
+#include "mm-port-capture.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+typedef struct {
+    guint32       type;
+    const guint8 *body;
+    guint32       body_len;
+} Block;
+
+static guint32
+read_u32 (const guint8 *p)
+{
+    guint32 value;
+
+    memcpy (&value, p, sizeof (value));
+    return value;
+}
+
+static guint16
+read_u16 (const guint8 *p)
+{
+    guint16 value;
+
+    memcpy (&value, p, sizeof (value));
+    return value;
+}
+
+static GArray *
+parse_blocks (const guint8 *data,
+              gsize         len)
+{
+    GArray *blocks;
+    gsize   offset = 0;
+
+    blocks = g_array_new (FALSE, FALSE, sizeof (Block));
+    while (offset < len) {
+        Block   block;
+        guint32 total;
+
+        g_assert_cmpuint (len - offset, >=, 12);
+        total = read_u32 (data + offset + 4);
+        g_assert_cmpuint (total % 4, ==, 0);
+        g_assert_cmpuint (total, <=, len - offset);
+        /* Trailing length repeated */
+        g_assert_cmpuint (read_u32 (data + offset + total - 4), ==, total);
+
+        block.type = read_u32 (data + offset);
+        block.body = data + offset + 8;
+        block.body_len = total - 12;
+        g_array_append_val (blocks, block);
+        offset += total;
+    }
+    return blocks;
+}
+
+/* Returns the value of the given option, NULL if not found */
+static const guint8 *
+find_option (const guint8 *options,
+             gsize         len,
+             guint16       code,
+             guint16      *option_len)
+{
+    gsize offset = 0;
+
+    while (offset + 4 <= len) {
+        guint16 current_code;
+        guint16 current_len;
+
+        current_code = read_u16 (options + offset);
+        current_len = read_u16 (options + offset + 2);
+        if (current_code == 0)
+            break;
+        if (current_code == code) {
+            *option_len = current_len;
+            return options + offset + 4;
+        }
+        offset += 4 + ((current_len + 3) & ~3);
+    }
+    return NULL;
+}
+
+static void
+check_packet (const Block            *block,
+              guint32                 interface_id,
+              MMPortCaptureDirection  direction,
+              const gchar            *data)
+{
+    const guint8 *option;
+    guint16       option_len;
+    guint32       captured_len;
+
+    g_assert_cmphex (block->type, ==, 0x00000006);
+    g_assert_cmpuint (read_u32 (block->body), ==, interface_id);
+    captured_len = read_u32 (block->body + 12);
+    g_assert_cmpuint (captured_len, ==, strlen (data));
+    g_assert_cmpuint (read_u32 (block->body + 16), ==, captured_len);
+    g_assert (memcmp (block->body + 20, data, captured_len) == 0);
+
+    option = find_option (block->body + 20 + ((captured_len + 3) & ~3),
+                          block->body_len - 20 - ((captured_len + 3) & ~3),
+                          2, &option_len);
+    g_assert (option);
+    g_assert_cmpuint (option_len, ==, 4);
+    g_assert_cmpuint (read_u32 (option), ==, direction);
+}
+
+static void
+check_interface (const Block *block,
+                 const gchar *name)
+{
+    const guint8 *option;
+    guint16       option_len;
+
+    g_assert_cmphex (block->type, ==, 0x00000001);
+    g_assert_cmpuint (read_u16 (block->body), ==, MM_PORT_CAPTURE_LINKTYPE);
+    option = find_option (block->body + 8, block->body_len - 8, 2, &option_len);
+    g_assert (option);
+    g_assert_cmpuint (option_len, ==, strlen (name));
+    g_assert (memcmp (option, name, option_len) == 0);
+}
+
+/*****************************************************************************/
+
+#define CAPTURE_NAME "capture.pcapng"
+
+static gchar *
+build_dir (void)
+{
+    GError *error = NULL;
+    gchar  *dir;
+
+    dir = g_dir_make_tmp ("test-port-capture-XXXXXX", &error);
+    g_assert_no_error (error);
+    return dir;
+}
+
+static void
+remove_dir (gchar *dir)
+{
+    gchar *path;
+
+    path = g_build_filename (dir, CAPTURE_NAME, NULL);
+    g_unlink (path);
+    g_rmdir (dir);
+    g_free (path);
+    g_free (dir);
+}
+
+static void
+test_blocks (void)
+{
+    MMPortCapture *capture;
+    GError        *error = NULL;
+    gchar         *dir;
+    gchar         *path;
+    gchar         *contents;
+    gsize          len;
+    GArray        *blocks;
+    Block         *block;
+
+    dir = build_dir ();
+    path = g_build_filename (dir, CAPTURE_NAME, NULL);
+    capture = mm_port_capture_new (dir, CAPTURE_NAME, 0, &error);
+    g_assert_no_error (error);
+    g_assert (capture);
+
+    mm_port_capture_write (capture, "ttyUSB2", MM_PORT_CAPTURE_DIRECTION_OUT, (const guint8 *) "AT+CSQ\r", 7);
+    mm_port_capture_write (capture, "ttyUSB2", MM_PORT_CAPTURE_DIRECTION_IN, (const guint8 *) "\r\n+CSQ: 20,99\r\n", 15);
+    mm_port_capture_write (capture, "ttyUSB0", MM_PORT_CAPTURE_DIRECTION_IN, (const guint8 *) "\x7e\x00\x7e", 3);
+    /* Empty chunks are ignored */
+    mm_port_capture_write (capture, "ttyUSB0", MM_PORT_CAPTURE_DIRECTION_IN, (const guint8 *) "", 0);
+    g_assert_cmpstr (mm_port_capture_get_path (capture), ==, path);
+    mm_port_capture_unref (capture);
+
+    g_file_get_contents (path, &contents, &len, &error);
+    g_assert_no_error (error);
+    blocks = parse_blocks ((const guint8 *) contents, len);
+    g_assert_cmpuint (blocks->len, ==, 6);
+
+    block = &g_array_index (blocks, Block, 0);
+    g_assert_cmphex (block->type, ==, 0x0A0D0D0A);
+    g_assert_cmphex (read_u32 (block->body), ==, 0x1A2B3C4D);
+
+    check_interface (&g_array_index (blocks, Block, 1), "ttyUSB2");
+    check_packet (&g_array_index (blocks, Block, 2), 0, MM_PORT_CAPTURE_DIRECTION_OUT, "AT+CSQ\r");
+    check_packet (&g_array_index (blocks, Block, 3), 0, MM_PORT_CAPTURE_DIRECTION_IN, "\r\n+CSQ: 20,99\r\n");
+    check_interface (&g_array_index (blocks, Block, 4), "ttyUSB0");
+    block = &g_array_index (blocks, Block, 5);
+    g_assert_cmpuint (read_u32 (block->body), ==, 1);
+    g_assert_cmpuint (read_u32 (block->body + 12), ==, 3);
+
+    g_array_unref (blocks);
+    g_free (contents);
+    g_free (path);
+    remove_dir (dir);
+}
+
+static void
+test_max_size (void)
+{
+    MMPortCapture *capture;
+    GError        *error = NULL;
+    gchar         *dir;
+    gchar         *path;
+    gchar         *contents;
+    gsize          len;
+    GArray        *blocks;
+    guint          i;
+
+    dir = build_dir ();
+    path = g_build_filename (dir, CAPTURE_NAME, NULL);
+    capture = mm_port_capture_new (dir, CAPTURE_NAME, 1024, &error);
+    g_assert_no_error (error);
+
+    for (i = 0; i < 100; i++)
+        mm_port_capture_write (capture, "ttyUSB2", MM_PORT_CAPTURE_DIRECTION_OUT, (const guint8 *) "AT\r", 3);
+    mm_port_capture_unref (capture);
+
+    /* Only complete blocks, within the limit */
+    g_file_get_contents (path, &contents, &len, &error);
+    g_assert_no_error (error);
+    g_assert_cmpuint (len, <=, 1024);
+    blocks = parse_blocks ((const guint8 *) contents, len);
+    g_assert_cmpuint (blocks->len, >, 2);
+    g_assert_cmpuint (blocks->len, <, 102);
+
+    g_array_unref (blocks);
+    g_free (contents);
+    g_free (path);
+    remove_dir (dir);
+}
+
+static void
+test_file_name (void)
+{
+    MMPortCapture *capture;
+    GError        *error = NULL;
+    gchar         *dir;
+    gchar         *path;
+    gchar         *target;
+
+    dir = build_dir ();
+
+    /* Only plain file names */
+    capture = mm_port_capture_new (dir, "", 0, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+    g_assert (!capture);
+    g_clear_error (&error);
+    capture = mm_port_capture_new (dir, "..", 0, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+    g_clear_error (&error);
+    capture = mm_port_capture_new (dir, "../" CAPTURE_NAME, 0, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+    g_clear_error (&error);
+    capture = mm_port_capture_new (dir, "/tmp/" CAPTURE_NAME, 0, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+    g_clear_error (&error);
+
+    /* Existing files are never overwritten */
+    path = g_build_filename (dir, CAPTURE_NAME, NULL);
+    g_file_set_contents (path, "keep", -1, &error);
+    g_assert_no_error (error);
+    capture = mm_port_capture_new (dir, CAPTURE_NAME, 0, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_EXISTS);
+    g_assert (!capture);
+    g_clear_error (&error);
+    g_unlink (path);
+
+    /* Nor followed if they are symlinks */
+    target = g_build_filename (dir, "target", NULL);
+    g_assert_cmpint (symlink (target, path), ==, 0);
+    capture = mm_port_capture_new (dir, CAPTURE_NAME, 0, &error);
+    g_assert (error);
+    g_assert (!capture);
+    g_clear_error (&error);
+    g_assert (!g_file_test (target, G_FILE_TEST_EXISTS));
+    g_free (target);
+
+    g_free (path);
+    remove_dir (dir);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/port-capture/blocks",    test_blocks);
+    g_test_add_func ("/MM/port-capture/max-size",  test_max_size);
+    g_test_add_func ("/MM/port-capture/file-name", test_file_name);
+
+    return g_test_run ();
+}
@@ -34,6 +34,7 @@
 #include "libqcdm/src/utils.h"
 #include "libqcdm/src/com.h"
 #include "libqcdm/src/errors.h"
+#include "libqcdm/src/log-items.h"
 #include "mm-log-test.h"
 
 typedef struct {
@@ -206,7 +207,10 @@ qcdm_request_verinfo (MMPortSerialQcdm *port,
 }
 
 static void
-qcdm_test_child (int fd, GAsyncReadyCallback cb)
+qcdm_test_child (int fd,
+                 guint log_code,
+                 MMPortSerialQcdmUnsolicitedMsgFn log_handler,
+                 GAsyncReadyCallback cb)
 {
     MMPortSerialQcdm *port;
     GMainLoop *loop;
@@ -222,6 +226,9 @@ qcdm_test_child (int fd, GAsyncReadyCallback cb)
     g_assert_no_error (error);
     g_assert (success);
 
+    if (log_handler)
+        mm_port_serial_qcdm_add_unsolicited_msg_handler (port, log_code, log_handler, NULL, NULL);
+
     qcdm_request_verinfo (port, cb, loop);
     g_main_loop_run (loop);
     g_main_loop_unref (loop);
@@ -253,7 +260,7 @@ test_verinfo (TestData *d)
 
     if (cpid == 0) {
         /* In the child */
-        qcdm_test_child (d->slave, (GAsyncReadyCallback)qcdm_verinfo_expect_success_cb);
+        qcdm_test_child (d->slave, 0, NULL, (GAsyncReadyCallback)qcdm_verinfo_expect_success_cb);
         exit (0);
     }
     /* Parent */
@@ -305,7 +312,7 @@ test_sierra_cns_rejected (TestData *d)
 
     if (cpid == 0) {
         /* In the child */
-        qcdm_test_child (d->slave, (GAsyncReadyCallback)qcdm_verinfo_expect_fail_cb);
+        qcdm_test_child (d->slave, 0, NULL, (GAsyncReadyCallback)qcdm_verinfo_expect_fail_cb);
         exit (0);
     }
     /* Parent */
@@ -341,7 +348,7 @@ test_random_data_rejected (TestData *d)
 
     if (cpid == 0) {
         /* In the child */
-        qcdm_test_child (d->slave, (GAsyncReadyCallback)qcdm_verinfo_expect_fail_cb);
+        qcdm_test_child (d->slave, 0, NULL, (GAsyncReadyCallback)qcdm_verinfo_expect_fail_cb);
         exit (0);
     }
     /* Parent */
@@ -381,7 +388,91 @@ test_leading_frame_markers (TestData *d)
 
     if (cpid == 0) {
         /* In the child */
-        qcdm_test_child (d->slave, (GAsyncReadyCallback)qcdm_verinfo_expect_success_cb);
+        qcdm_test_child (d->slave, 0, NULL, (GAsyncReadyCallback)qcdm_verinfo_expect_success_cb);
+        exit (0);
+    }
+    /* Parent */
+    d->child = cpid;
+
+    req_len = server_wait_request (d->master, req, sizeof (req));
+    g_assert (req_len == 1);
+    g_assert_cmpint (req[0], ==, 0x00);
+
+    server_send_response (d->master, rsp, sizeof (rsp));
+
+    /* We expect the child to exit normally */
+    g_assert (wait_for_child (d, 3));
+}
+
+/* WCDMA cell ID log item, header only */
+static const char cell_id_log[] = {
+    0x10, 0x00, 0x0c, 0x00, 0x0c, 0x00, 0x27, 0x41, 0x00, 0x00, 0x10, 0x20,
+    0x00, 0x00, 0x00, 0x00
+};
+
+static guint n_log_items;
+
+static void
+qcdm_cell_id_log_handle (MMPortSerialQcdm *port,
+                         GByteArray *log_buffer,
+                         gpointer user_data)
+{
+    g_assert_cmpuint (log_buffer->len, ==, sizeof (cell_id_log));
+    g_assert (memcmp (log_buffer->data, cell_id_log, sizeof (cell_id_log)) == 0);
+    n_log_items++;
+}
+
+static void
+qcdm_verinfo_after_log_item_cb (MMPortSerialQcdm *port,
+                                GAsyncResult *res,
+                                GMainLoop *loop)
+{
+    QcdmLogStreamStats stats;
+
+    /* The log item was taken out of the way of the response */
+    g_assert_cmpuint (n_log_items, ==, 1);
+    mm_port_serial_qcdm_get_log_stats (port, &stats);
+    g_assert_cmpuint (stats.n_items, ==, 1);
+    g_assert_cmpuint (stats.n_invalid, ==, 0);
+
+    qcdm_verinfo_expect_success_cb (port, res, loop);
+}
+
+/* Test that a log item received while waiting for the response to a
+ * Version Info command goes to its handler and not to the command.
+ */
+static void
+test_log_item_before_response (TestData *d)
+{
+    char req[512];
+    gsize req_len;
+    pid_t cpid;
+    char log_buf[sizeof (cell_id_log) + 2];
+    char log_frame[(sizeof (log_buf) * 2) + 1];
+    gsize log_frame_len;
+    const char rsp[] = {
+        0x00, 0x41, 0x75, 0x67, 0x20, 0x31, 0x39, 0x20, 0x32, 0x30, 0x30, 0x38,
+        0x32, 0x30, 0x3a, 0x34, 0x38, 0x3a, 0x34, 0x37, 0x4f, 0x63, 0x74, 0x20,
+        0x32, 0x39, 0x20, 0x32, 0x30, 0x30, 0x37, 0x31, 0x39, 0x3a, 0x30, 0x30,
+        0x3a, 0x30, 0x30, 0x53, 0x43, 0x4e, 0x52, 0x5a, 0x2e, 0x2e, 0x2e, 0x2a,
+        0x06, 0x04, 0xb9, 0x0b, 0x02, 0x00, 0xb2, 0x19, 0xc4, 0x7e
+    };
+
+    memcpy (log_buf, cell_id_log, sizeof (cell_id_log));
+    log_frame_len = dm_encapsulate_buffer (log_buf, sizeof (cell_id_log), sizeof (log_buf),
+                                           log_frame, sizeof (log_frame));
+    g_assert_cmpuint (log_frame_len, >, 0);
+
+    signal (SIGCHLD, SIG_DFL);
+    cpid = fork ();
+    g_assert (cpid >= 0);
+
+    if (cpid == 0) {
+        /* In the child */
+        qcdm_test_child (d->slave,
+                         DM_LOG_ITEM_WCDMA_CELL_ID,
+                         qcdm_cell_id_log_handle,
+                         (GAsyncReadyCallback)qcdm_verinfo_after_log_item_cb);
         exit (0);
     }
     /* Parent */
@@ -391,6 +482,7 @@ test_leading_frame_markers (TestData *d)
     g_assert (req_len == 1);
     g_assert_cmpint (req[0], ==, 0x00);
 
+    server_send_response (d->master, log_frame, log_frame_len);
     server_send_response (d->master, rsp, sizeof (rsp));
 
     /* We expect the child to exit normally */
@@ -448,6 +540,7 @@ int main (int argc, char **argv)
     TESTCASE_PTY ("/MM/QCDM/Sierra-Cns-Rejected", test_sierra_cns_rejected);
     TESTCASE_PTY ("/MM/QCDM/Random-Data-Rejected", test_random_data_rejected);
     TESTCASE_PTY ("/MM/QCDM/Leading-Frame-Markers", test_leading_frame_markers);
+    TESTCASE_PTY ("/MM/QCDM/Log-Item-Before-Response", test_log_item_before_response);
 
     return g_test_run ();
 }
@@ -0,0 +1,115 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <locale.h>
+
+#include "mm-rate-limiter.h"
+#include "mm-log-test.h"
+
+#define MS(ms) ((gint64) (ms) * 1000)
+
+/* Arbitrary start time, monotonic clocks never start at 0 */
+#define T0 MS (100000)
+
+#define CHANGE_A 0x1
+#define CHANGE_B 0x2
+
+/*****************************************************************************/
+
+static void
+test_min_interval (void)
+{
+    MMRateLimiter *limiter;
+    guint          delay_ms = 0;
+
+    limiter = mm_rate_limiter_new (0);
+    g_assert_cmpuint (mm_rate_limiter_set_interval (limiter, 0), ==, MM_RATE_LIMITER_MIN_INTERVAL_MS);
+    g_assert_cmpuint (mm_rate_limiter_set_interval (limiter, 10), ==, MM_RATE_LIMITER_MIN_INTERVAL_MS);
+    g_assert_cmpuint (mm_rate_limiter_set_interval (limiter, 5000), ==, 5000);
+
+    /* A limiter created with a 0 interval still limits */
+    mm_rate_limiter_set_interval (limiter, 0);
+    g_assert_cmpint (mm_rate_limiter_push (limiter, CHANGE_A, T0, &delay_ms), ==, MM_RATE_LIMITER_ACTION_SEND);
+    mm_rate_limiter_take (limiter, T0);
+    g_assert_cmpint (mm_rate_limiter_push (limiter, CHANGE_A, T0 + MS (1), &delay_ms), ==, MM_RATE_LIMITER_ACTION_SCHEDULE);
+    g_assert_cmpuint (delay_ms, ==, MM_RATE_LIMITER_MIN_INTERVAL_MS - 1);
+
+    mm_rate_limiter_free (limiter);
+}
+
+static void
+test_merge (void)
+{
+    MMRateLimiter *limiter;
+    guint          delay_ms = 0;
+
+    limiter = mm_rate_limiter_new (2000);
+
+    /* First change goes out right away */
+    g_assert_cmpint (mm_rate_limiter_push (limiter, CHANGE_A, T0, &delay_ms), ==, MM_RATE_LIMITER_ACTION_SEND);
+    g_assert_cmpuint (mm_rate_limiter_take (limiter, T0), ==, CHANGE_A);
+
+    /* Changes within the interval are merged, only one timer is requested */
+    g_assert_cmpint (mm_rate_limiter_push (limiter, CHANGE_A, T0 + MS (500), &delay_ms), ==, MM_RATE_LIMITER_ACTION_SCHEDULE);
+    g_assert_cmpuint (delay_ms, ==, 1500);
+    g_assert_cmpint (mm_rate_limiter_push (limiter, CHANGE_B, T0 + MS (700), &delay_ms), ==, MM_RATE_LIMITER_ACTION_NONE);
+    g_assert_cmpint (mm_rate_limiter_push (limiter, CHANGE_A, T0 + MS (900), &delay_ms), ==, MM_RATE_LIMITER_ACTION_NONE);
+    g_assert_cmpuint (mm_rate_limiter_take (limiter, T0 + MS (2000)), ==, CHANGE_A | CHANGE_B);
+
+    /* Nothing pending after taking */
+    g_assert_cmpuint (mm_rate_limiter_take (limiter, T0 + MS (2100)), ==, 0);
+
+    /* No changes, nothing to do */
+    g_assert_cmpint (mm_rate_limiter_push (limiter, 0, T0 + MS (2200), &delay_ms), ==, MM_RATE_LIMITER_ACTION_NONE);
+
+    /* Past the interval, sent right away again */
+    g_assert_cmpint (mm_rate_limiter_push (limiter, CHANGE_B, T0 + MS (4100), &delay_ms), ==, MM_RATE_LIMITER_ACTION_SEND);
+    g_assert_cmpuint (mm_rate_limiter_take (limiter, T0 + MS (4100)), ==, CHANGE_B);
+
+    mm_rate_limiter_free (limiter);
+}
+
+static void
+test_filter (void)
+{
+    MMRateLimiter *limiter;
+    guint          delay_ms = 0;
+
+    limiter = mm_rate_limiter_new (1000);
+
+    mm_rate_limiter_push (limiter, CHANGE_A, T0, &delay_ms);
+    mm_rate_limiter_take (limiter, T0);
+    g_assert_cmpint (mm_rate_limiter_push (limiter, CHANGE_A | CHANGE_B, T0 + MS (100), &delay_ms), ==, MM_RATE_LIMITER_ACTION_SCHEDULE);
+
+    /* e.g. the subscriber no longer wants A */
+    mm_rate_limiter_filter (limiter, CHANGE_B);
+    g_assert_cmpuint (mm_rate_limiter_take (limiter, T0 + MS (1000)), ==, CHANGE_B);
+
+    mm_rate_limiter_free (limiter);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/rate-limiter/min-interval", test_min_interval);
+    g_test_add_func ("/MM/rate-limiter/merge",        test_merge);
+    g_test_add_func ("/MM/rate-limiter/filter",       test_filter);
+
+    return g_test_run ();
+}
@@ -0,0 +1,204 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <locale.h>
+#include <math.h>
+
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-signal-history.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+static void
+add_lte (MMSignalHistory *history,
+         guint64          timestamp,
+         gdouble          rsrp)
+{
+    MMSignal *signal;
+
+    signal = mm_signal_new ();
+    mm_signal_set_rsrp (signal, rsrp);
+    mm_signal_history_add (history, timestamp, MM_MODEM_ACCESS_TECHNOLOGY_LTE, signal);
+    g_object_unref (signal);
+}
+
+static void
+add_umts (MMSignalHistory *history,
+          guint64          timestamp,
+          gdouble          rscp)
+{
+    MMSignal *signal;
+
+    signal = mm_signal_new ();
+    mm_signal_set_rscp (signal, rscp);
+    mm_signal_history_add (history, timestamp, MM_MODEM_ACCESS_TECHNOLOGY_UMTS, signal);
+    g_object_unref (signal);
+}
+
+static void
+get_sample (GVariant *history,
+            guint     i,
+            guint64  *timestamp,
+            guint    *access_technology,
+            gdouble  *rscp,
+            gdouble  *rsrp)
+{
+    gdouble rssi, ecio, sinr, io, rsrq, snr;
+
+    g_variant_get_child (history, i, MM_SIGNAL_HISTORY_SAMPLE_SIGNATURE,
+                         timestamp, access_technology,
+                         &rssi, rscp, &ecio, &sinr, &io, &rsrq, rsrp, &snr);
+    g_assert (isnan (rssi));
+    g_assert (isnan (ecio));
+    g_assert (isnan (sinr));
+    g_assert (isnan (io));
+    g_assert (isnan (rsrq));
+    g_assert (isnan (snr));
+}
+
+/*****************************************************************************/
+
+static void
+test_ring (void)
+{
+    MMSignalHistory *history;
+    GVariant        *result;
+    guint64          timestamp;
+    guint            access_technology;
+    gdouble          rscp;
+    gdouble          rsrp;
+    guint            i;
+
+    history = mm_signal_history_new (4);
+    for (i = 0; i < 6; i++)
+        add_lte (history, 100 + i, -100.0 + i);
+    g_assert_cmpuint (mm_signal_history_get_n_samples (history), ==, 4);
+
+    /* Only the last 4 samples are kept, oldest first */
+    result = mm_signal_history_build (history, 0, 0, MM_SIGNAL_HISTORY_AGGREGATION_NONE);
+    g_assert_cmpuint (g_variant_n_children (result), ==, 4);
+    for (i = 0; i < 4; i++) {
+        get_sample (result, i, &timestamp, &access_technology, &rscp, &rsrp);
+        g_assert_cmpuint (timestamp, ==, 102 + i);
+        g_assert_cmpuint (access_technology, ==, MM_MODEM_ACCESS_TECHNOLOGY_LTE);
+        g_assert (isnan (rscp));
+        g_assert_cmpfloat (rsrp, ==, -98.0 + i);
+    }
+    g_variant_unref (result);
+
+    /* Time filter */
+    result = mm_signal_history_build (history, 104, 0, MM_SIGNAL_HISTORY_AGGREGATION_NONE);
+    g_assert_cmpuint (g_variant_n_children (result), ==, 2);
+    get_sample (result, 0, &timestamp, &access_technology, &rscp, &rsrp);
+    g_assert_cmpuint (timestamp, ==, 104);
+    g_variant_unref (result);
+
+    /* Most recent ones when limited without aggregation */
+    result = mm_signal_history_build (history, 0, 1, MM_SIGNAL_HISTORY_AGGREGATION_NONE);
+    g_assert_cmpuint (g_variant_n_children (result), ==, 1);
+    get_sample (result, 0, &timestamp, &access_technology, &rscp, &rsrp);
+    g_assert_cmpuint (timestamp, ==, 105);
+    g_variant_unref (result);
+
+    mm_signal_history_clear (history);
+    g_assert_cmpuint (mm_signal_history_get_n_samples (history), ==, 0);
+    result = mm_signal_history_build (history, 0, 0, MM_SIGNAL_HISTORY_AGGREGATION_NONE);
+    g_assert_cmpuint (g_variant_n_children (result), ==, 0);
+    g_variant_unref (result);
+
+    mm_signal_history_free (history);
+}
+
+static void
+test_aggregation (void)
+{
+    MMSignalHistory *history;
+    GVariant        *result;
+    guint64          timestamp;
+    guint            access_technology;
+    gdouble          rscp;
+    gdouble          rsrp;
+    guint            i;
+
+    /* 10 LTE and 10 UMTS samples, one per second */
+    history = mm_signal_history_new (64);
+    for (i = 0; i < 10; i++) {
+        add_lte (history, 1000 + i, -100.0 - i);
+        add_umts (history, 1000 + i, -80.0 + i);
+    }
+
+    /* 4 samples max: 2 buckets of 5s per technology */
+    result = mm_signal_history_build (history, 0, 4, MM_SIGNAL_HISTORY_AGGREGATION_MEAN);
+    g_assert_cmpuint (g_variant_n_children (result), ==, 4);
+
+    get_sample (result, 0, &timestamp, &access_technology, &rscp, &rsrp);
+    g_assert_cmpuint (timestamp, ==, 1000);
+    g_assert_cmpuint (access_technology, ==, MM_MODEM_ACCESS_TECHNOLOGY_LTE);
+    g_assert_cmpfloat (rsrp, ==, -102.0);
+    g_assert (isnan (rscp));
+
+    get_sample (result, 1, &timestamp, &access_technology, &rscp, &rsrp);
+    g_assert_cmpuint (timestamp, ==, 1000);
+    g_assert_cmpuint (access_technology, ==, MM_MODEM_ACCESS_TECHNOLOGY_UMTS);
+    g_assert_cmpfloat (rscp, ==, -78.0);
+    g_assert (isnan (rsrp));
+
+    get_sample (result, 2, &timestamp, &access_technology, &rscp, &rsrp);
+    g_assert_cmpuint (timestamp, ==, 1005);
+    g_assert_cmpuint (access_technology, ==, MM_MODEM_ACCESS_TECHNOLOGY_LTE);
+    g_assert_cmpfloat (rsrp, ==, -107.0);
+    g_variant_unref (result);
+
+    result = mm_signal_history_build (history, 0, 4, MM_SIGNAL_HISTORY_AGGREGATION_MIN);
+    get_sample (result, 0, &timestamp, &access_technology, &rscp, &rsrp);
+    g_assert_cmpfloat (rsrp, ==, -104.0);
+    get_sample (result, 1, &timestamp, &access_technology, &rscp, &rsrp);
+    g_assert_cmpfloat (rscp, ==, -80.0);
+    g_variant_unref (result);
+
+    result = mm_signal_history_build (history, 0, 4, MM_SIGNAL_HISTORY_AGGREGATION_MAX);
+    get_sample (result, 0, &timestamp, &access_technology, &rscp, &rsrp);
+    g_assert_cmpfloat (rsrp, ==, -100.0);
+    get_sample (result, 1, &timestamp, &access_technology, &rscp, &rsrp);
+    g_assert_cmpfloat (rscp, ==, -76.0);
+    g_variant_unref (result);
+
+    /* Fewer samples allowed than technologies: most recent buckets only */
+    result = mm_signal_history_build (history, 0, 1, MM_SIGNAL_HISTORY_AGGREGATION_MEAN);
+    g_assert_cmpuint (g_variant_n_children (result), ==, 1);
+    get_sample (result, 0, &timestamp, &access_technology, &rscp, &rsrp);
+    g_assert_cmpuint (access_technology, ==, MM_MODEM_ACCESS_TECHNOLOGY_UMTS);
+    g_assert_cmpfloat (rscp, ==, -75.5);
+    g_variant_unref (result);
+
+    mm_signal_history_free (history);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/signal-history/ring",        test_ring);
+    g_test_add_func ("/MM/signal-history/aggregation", test_aggregation);
+
+    return g_test_run ();
+}
@@ -0,0 +1,304 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <locale.h>
+#include <string.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-sms-batch.h"
+#include "mm-sms-part.h"
+#include "mm-sms-part-3gpp.h"
+#include "mm-log-test.h"
+
+#define NUMBER "+15555551234"
+
+/*****************************************************************************/
+
+static guint n_prepared_freed;
+
+static void
+prepared_free (GPtrArray *pdus)
+{
+    n_prepared_freed++;
+    g_ptr_array_unref (pdus);
+}
+
+/* Same steps as the daemon follows to generate the 3GPP SUBMIT PDUs of a
+ * text message; returns the array of PDUs */
+static gpointer
+prepare_3gpp (MMSmsProperties  *properties,
+              gpointer          user_data,
+              GError          **error)
+{
+    const gchar    *text;
+    gchar         **split;
+    MMSmsEncoding   encoding = MM_SMS_ENCODING_UNKNOWN;
+    GPtrArray      *pdus;
+    guint           n_parts;
+    guint           i;
+
+    text = mm_sms_properties_get_text (properties);
+    if (!mm_sms_properties_get_number (properties) || !text) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS,
+                     "Cannot create SMS: mandatory parameter missing");
+        return NULL;
+    }
+
+    split = mm_sms_part_3gpp_util_split_text (text, &encoding, NULL);
+    g_assert (split);
+    n_parts = g_strv_length (split);
+
+    pdus = g_ptr_array_new_with_free_func (g_free);
+    for (i = 0; split[i]; i++) {
+        MMSmsPart *part;
+        guint8    *pdu;
+        guint      len = 0;
+        guint      msgstart = 0;
+
+        part = mm_sms_part_new (SMS_PART_INVALID_INDEX, MM_SMS_PDU_TYPE_SUBMIT);
+        mm_sms_part_set_text (part, split[i]);
+        mm_sms_part_set_encoding (part, encoding);
+        mm_sms_part_set_number (part, mm_sms_properties_get_number (properties));
+        if (n_parts > 1) {
+            mm_sms_part_set_concat_reference (part, 0);
+            mm_sms_part_set_concat_sequence (part, i + 1);
+            mm_sms_part_set_concat_max (part, n_parts);
+        }
+
+        pdu = mm_sms_part_3gpp_get_submit_pdu (part, &len, &msgstart, NULL, error);
+        mm_sms_part_free (part);
+        if (!pdu) {
+            g_ptr_array_unref (pdus);
+            pdus = NULL;
+            break;
+        }
+        g_ptr_array_add (pdus, pdu);
+    }
+    g_strfreev (split);
+
+    return pdus;
+}
+
+static void
+add_message (GVariantBuilder *builder,
+             const gchar     *number,
+             const gchar     *text)
+{
+    g_variant_builder_open (builder, G_VARIANT_TYPE ("a{sv}"));
+    if (number)
+        g_variant_builder_add (builder, "{sv}", "number", g_variant_new_string (number));
+    if (text)
+        g_variant_builder_add (builder, "{sv}", "text", g_variant_new_string (text));
+    g_variant_builder_close (builder);
+}
+
+static void
+add_invalid_message (GVariantBuilder *builder)
+{
+    g_variant_builder_open (builder, G_VARIANT_TYPE ("a{sv}"));
+    g_variant_builder_add (builder, "{sv}", "number", g_variant_new_string (NUMBER));
+    g_variant_builder_add (builder, "{sv}", "unknown-key", g_variant_new_string ("value"));
+    g_variant_builder_close (builder);
+}
+
+static MMSmsBatch *
+new_batch (GVariantBuilder *builder,
+           GError         **error)
+{
+    GVariant   *messages;
+    MMSmsBatch *batch;
+
+    messages = g_variant_ref_sink (g_variant_builder_end (builder));
+    batch = mm_sms_batch_new (messages, error);
+    g_variant_unref (messages);
+    return batch;
+}
+
+/*****************************************************************************/
+
+static void
+test_parse (void)
+{
+    GVariantBuilder  builder;
+    MMSmsBatch      *batch;
+    GError          *error = NULL;
+
+    /* Empty batch */
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+    batch = new_batch (&builder, &error);
+    g_assert_no_error (error);
+    g_assert (batch);
+    g_assert_cmpuint (mm_sms_batch_get_n_messages (batch), ==, 0);
+    mm_sms_batch_free (batch);
+
+    /* Unparseable messages don't make the whole batch fail */
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+    add_message (&builder, NUMBER, "first");
+    add_invalid_message (&builder);
+    add_message (&builder, NUMBER, "third");
+    batch = new_batch (&builder, &error);
+    g_assert_no_error (error);
+    g_assert (batch);
+    g_assert_cmpuint (mm_sms_batch_get_n_messages (batch), ==, 3);
+    mm_sms_batch_free (batch);
+}
+
+static void
+test_too_many (void)
+{
+    GVariantBuilder  builder;
+    MMSmsBatch      *batch;
+    GError          *error = NULL;
+    guint            i;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+    for (i = 0; i < MM_SMS_BATCH_MAX_MESSAGES; i++)
+        add_message (&builder, NUMBER, "text");
+    batch = new_batch (&builder, &error);
+    g_assert_no_error (error);
+    g_assert_cmpuint (mm_sms_batch_get_n_messages (batch), ==, MM_SMS_BATCH_MAX_MESSAGES);
+    mm_sms_batch_free (batch);
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+    for (i = 0; i < MM_SMS_BATCH_MAX_MESSAGES + 1; i++)
+        add_message (&builder, NUMBER, "text");
+    batch = new_batch (&builder, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_TOO_MANY);
+    g_assert (!batch);
+    g_clear_error (&error);
+}
+
+static void
+test_prepare (void)
+{
+    GVariantBuilder  builder;
+    MMSmsBatch      *batch;
+    GPtrArray       *pdus;
+    gchar           *long_text;
+    GError          *error = NULL;
+
+    /* 200 GSM 7-bit characters need 2 parts */
+    long_text = g_strnfill (200, 'a');
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+    add_message (&builder, NUMBER, "short");
+    add_message (&builder, NUMBER, long_text);
+    add_message (&builder, NULL, "no number");
+    add_invalid_message (&builder);
+    batch = new_batch (&builder, &error);
+    g_assert_no_error (error);
+    g_free (long_text);
+
+    n_prepared_freed = 0;
+    g_assert_cmpuint (mm_sms_batch_prepare (batch,
+                                            (MMSmsBatchPrepareFunc) prepare_3gpp,
+                                            (GDestroyNotify) prepared_free,
+                                            NULL), ==, 2);
+
+    pdus = mm_sms_batch_peek_prepared (batch, 0);
+    g_assert (pdus);
+    g_assert_cmpuint (pdus->len, ==, 1);
+    pdus = mm_sms_batch_peek_prepared (batch, 1);
+    g_assert (pdus);
+    g_assert_cmpuint (pdus->len, ==, 2);
+    g_assert (!mm_sms_batch_peek_prepared (batch, 2));
+    g_assert (!mm_sms_batch_peek_prepared (batch, 3));
+
+    /* Prepared messages not sent are released with the batch */
+    mm_sms_batch_free (batch);
+    g_assert_cmpuint (n_prepared_freed, ==, 2);
+}
+
+static void
+test_results (void)
+{
+    GVariantBuilder  builder;
+    MMSmsBatch      *batch;
+    GVariant        *results;
+    GError          *error = NULL;
+    GError          *send_error;
+    gboolean         sent;
+    guint            reference;
+    const gchar     *error_message;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+    add_message (&builder, NUMBER, "first");
+    add_invalid_message (&builder);
+    add_message (&builder, NUMBER, "third");
+    add_message (&builder, NULL, "no number");
+    batch = new_batch (&builder, &error);
+    g_assert_no_error (error);
+
+    n_prepared_freed = 0;
+    g_assert_cmpuint (mm_sms_batch_prepare (batch,
+                                            (MMSmsBatchPrepareFunc) prepare_3gpp,
+                                            (GDestroyNotify) prepared_free,
+                                            NULL), ==, 2);
+
+    /* Completed messages release the prepared data right away */
+    mm_sms_batch_complete (batch, 0, 12, NULL);
+    g_assert (!mm_sms_batch_peek_prepared (batch, 0));
+    g_assert_cmpuint (n_prepared_freed, ==, 1);
+
+    send_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Network timeout");
+    mm_sms_batch_complete (batch, 2, 0, send_error);
+    g_error_free (send_error);
+    g_assert_cmpuint (n_prepared_freed, ==, 2);
+
+    results = g_variant_ref_sink (mm_sms_batch_build_results (batch));
+    g_assert_cmpstr (g_variant_get_type_string (results), ==, "a(bus)");
+    g_assert_cmpuint (g_variant_n_children (results), ==, 4);
+
+    /* Same order as requested */
+    g_variant_get_child (results, 0, "(bu&s)", &sent, &reference, &error_message);
+    g_assert (sent);
+    g_assert_cmpuint (reference, ==, 12);
+    g_assert_cmpstr (error_message, ==, "");
+
+    g_variant_get_child (results, 1, "(bu&s)", &sent, &reference, &error_message);
+    g_assert (!sent);
+    g_assert (strstr (error_message, "unknown-key"));
+
+    g_variant_get_child (results, 2, "(bu&s)", &sent, &reference, &error_message);
+    g_assert (!sent);
+    g_assert_cmpstr (error_message, ==, "Network timeout");
+
+    g_variant_get_child (results, 3, "(bu&s)", &sent, &reference, &error_message);
+    g_assert (!sent);
+    g_assert (strstr (error_message, "mandatory parameter"));
+
+    g_variant_unref (results);
+    mm_sms_batch_free (batch);
+    g_assert_cmpuint (n_prepared_freed, ==, 2);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/sms-batch/parse",    test_parse);
+    g_test_add_func ("/MM/sms-batch/too-many", test_too_many);
+    g_test_add_func ("/MM/sms-batch/prepare",  test_prepare);
+    g_test_add_func ("/MM/sms-batch/results",  test_results);
+
+    return g_test_run ();
+}
@@ -0,0 +1,162 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <locale.h>
+
+#include "mm-sms-multipart-tracker.h"
+#include "mm-log-test.h"
+
+#define TIMEOUT G_USEC_PER_SEC
+
+/* Any distinct non-NULL pointers work as keys */
+#define SMS_A GUINT_TO_POINTER (1)
+#define SMS_B GUINT_TO_POINTER (2)
+#define SMS_C GUINT_TO_POINTER (3)
+
+static void
+check_stats (MMSmsMultipartTracker *tracker,
+             guint                  expected_in_flight,
+             guint                  expected_pending_parts,
+             guint                  expected_expired,
+             guint                  expected_evicted)
+{
+    guint n_in_flight;
+    guint n_pending_parts;
+    guint n_expired;
+    guint n_evicted;
+
+    mm_sms_multipart_tracker_get_stats (tracker, &n_in_flight, &n_pending_parts, &n_expired, &n_evicted);
+    g_assert_cmpuint (n_in_flight,     ==, expected_in_flight);
+    g_assert_cmpuint (n_pending_parts, ==, expected_pending_parts);
+    g_assert_cmpuint (n_expired,       ==, expected_expired);
+    g_assert_cmpuint (n_evicted,       ==, expected_evicted);
+}
+
+/*****************************************************************************/
+
+static void
+test_out_of_order (void)
+{
+    MMSmsMultipartTracker *tracker;
+
+    tracker = mm_sms_multipart_tracker_new (8, 32, TIMEOUT);
+
+    g_assert_cmpint (mm_sms_multipart_tracker_add_part (tracker, SMS_A, 3, 3, 0, NULL), ==, MM_SMS_MULTIPART_TRACKER_RESULT_INCOMPLETE);
+    g_assert_cmpint (mm_sms_multipart_tracker_add_part (tracker, SMS_A, 1, 3, 1, NULL), ==, MM_SMS_MULTIPART_TRACKER_RESULT_INCOMPLETE);
+    check_stats (tracker, 1, 2, 0, 0);
+    g_assert_cmpint (mm_sms_multipart_tracker_add_part (tracker, SMS_A, 2, 3, 2, NULL), ==, MM_SMS_MULTIPART_TRACKER_RESULT_COMPLETE);
+
+    /* Completed messages are no longer tracked */
+    check_stats (tracker, 0, 0, 0, 0);
+
+    mm_sms_multipart_tracker_free (tracker);
+}
+
+static void
+test_duplicate (void)
+{
+    MMSmsMultipartTracker *tracker;
+
+    tracker = mm_sms_multipart_tracker_new (8, 32, TIMEOUT);
+
+    g_assert_cmpint (mm_sms_multipart_tracker_add_part (tracker, SMS_A, 1, 2, 0, NULL), ==, MM_SMS_MULTIPART_TRACKER_RESULT_INCOMPLETE);
+    g_assert_cmpint (mm_sms_multipart_tracker_add_part (tracker, SMS_A, 1, 2, 1, NULL), ==, MM_SMS_MULTIPART_TRACKER_RESULT_DUPLICATE);
+    check_stats (tracker, 1, 1, 0, 0);
+
+    /* A duplicate doesn't refresh the update time */
+    g_list_free (mm_sms_multipart_tracker_expire (tracker, TIMEOUT));
+    check_stats (tracker, 0, 0, 1, 0);
+
+    mm_sms_multipart_tracker_free (tracker);
+}
+
+static void
+test_expiry (void)
+{
+    MMSmsMultipartTracker *tracker;
+    GList                 *expired;
+
+    tracker = mm_sms_multipart_tracker_new (8, 32, TIMEOUT);
+
+    mm_sms_multipart_tracker_add_part (tracker, SMS_A, 1, 2, 0, NULL);
+    mm_sms_multipart_tracker_add_part (tracker, SMS_B, 1, 3, 0, NULL);
+    mm_sms_multipart_tracker_add_part (tracker, SMS_B, 2, 3, TIMEOUT / 2, NULL);
+
+    expired = mm_sms_multipart_tracker_expire (tracker, TIMEOUT - 1);
+    g_assert (!expired);
+
+    expired = mm_sms_multipart_tracker_expire (tracker, TIMEOUT);
+    g_assert_cmpuint (g_list_length (expired), ==, 1);
+    g_assert (expired->data == SMS_A);
+    g_list_free (expired);
+    check_stats (tracker, 1, 2, 1, 0);
+
+    expired = mm_sms_multipart_tracker_expire (tracker, TIMEOUT + TIMEOUT / 2);
+    g_assert_cmpuint (g_list_length (expired), ==, 1);
+    g_assert (expired->data == SMS_B);
+    g_list_free (expired);
+    check_stats (tracker, 0, 0, 2, 0);
+
+    mm_sms_multipart_tracker_free (tracker);
+}
+
+static void
+test_eviction (void)
+{
+    MMSmsMultipartTracker *tracker;
+    GList                 *evicted = NULL;
+
+    /* At most 2 messages or 3 parts in flight */
+    tracker = mm_sms_multipart_tracker_new (2, 3, TIMEOUT);
+
+    mm_sms_multipart_tracker_add_part (tracker, SMS_A, 1, 4, 0, &evicted);
+    mm_sms_multipart_tracker_add_part (tracker, SMS_B, 1, 4, 1, &evicted);
+    mm_sms_multipart_tracker_add_part (tracker, SMS_A, 2, 4, 2, &evicted);
+    g_assert (!evicted);
+
+    /* Too many messages: B is the least recently updated one */
+    mm_sms_multipart_tracker_add_part (tracker, SMS_C, 1, 4, 3, &evicted);
+    g_assert_cmpuint (g_list_length (evicted), ==, 1);
+    g_assert (evicted->data == SMS_B);
+    g_clear_pointer (&evicted, g_list_free);
+    check_stats (tracker, 2, 3, 0, 1);
+
+    /* Too many parts: the message just updated is never evicted */
+    mm_sms_multipart_tracker_add_part (tracker, SMS_C, 2, 4, 4, &evicted);
+    g_assert_cmpuint (g_list_length (evicted), ==, 1);
+    g_assert (evicted->data == SMS_A);
+    g_clear_pointer (&evicted, g_list_free);
+    check_stats (tracker, 1, 2, 0, 2);
+
+    mm_sms_multipart_tracker_remove (tracker, SMS_C);
+    check_stats (tracker, 0, 0, 0, 2);
+
+    mm_sms_multipart_tracker_free (tracker);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/sms-multipart-tracker/out-of-order", test_out_of_order);
+    g_test_add_func ("/MM/sms-multipart-tracker/duplicate",    test_duplicate);
+    g_test_add_func ("/MM/sms-multipart-tracker/expiry",       test_expiry);
+    g_test_add_func ("/MM/sms-multipart-tracker/eviction",     test_eviction);
+
+    return g_test_run ();
+}
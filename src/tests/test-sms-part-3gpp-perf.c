@@ -0,0 +1,194 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <string.h>
+#include <stdio.h>
+#include <locale.h>
+
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-sms-part-3gpp.h"
+#include "mm-log-test.h"
+
+/*
+ * PDU decoder throughput. Run with '-m perf' to get meaningful numbers; in
+ * the default (quick) mode the corpus is only decoded a few times, just to
+ * make sure every PDU in it is valid.
+ */
+
+#define QUICK_ROUNDS 10
+#define PERF_ROUNDS  20000
+
+static const gchar *corpus[] = {
+    /* GSM-7, long text with extended chars */
+    "07912104442961F4040B916171957291F800001120821105050A6AC8B2BC7C9A83C220F6DB7D2ECB41EDF2"
+    "7C1E3E97411BDE06754FD3D1A0F9BB5D0695F1F4B29B5C2683C6E8B03C3CA697E5F34D6AE303D1D1F2F7DD"
+    "0D4ABB59A0797D8C0685E7A00028EC26832A960B28EC2683BE6050780EBA97D96C17",
+    /* GSM-7, short text, international and national numbers */
+    "07912143658709F1040B918100551512F20000111010214365000AE8329BFD4697D9EC37",
+    "07912143658709F1040B818100551512F20000111010214365000AE8329BFD4697D9EC37",
+    /* GSM-7, DCS group F, full 160 chars */
+    "07913306091093F0040485810000F111604231805180A049B7F90D9A1AA5A01668F8769BD3E4B29B9E2EB3"
+    "59A03FC85D06A9C3ED707A0EA2CBC3EE79BB4CA7CBCBA05643617DA7C76990FD4D979741EE77DD5E0ED741"
+    "ED371D442E83E0E1F9BC0CD281E677D9B84C06C1DF7539E85C9097E520FB9B2E2F83C6EF369C5E064D8D52"
+    "D0BC2E07DDEF77D7DC2C7799E5A0771D040FCB41F402BB0047BFDD6550B80ECAD966",
+    /* UCS2, alphanumeric sender */
+    "07919730071111F10414D04937BD2C7797E9D3E614000811309291024061080442043504410442",
+    /* UCS2, SUBMIT stored by us */
+    "002100098136397339F70008224F60597D4F60597D4F60597D4F60597D4F60597D4F60597D4F60597D4F60"
+    "597D4F60",
+    /* 8-bit, DCS general group and group F */
+    "07912143658709F1040B918100551512F20004111010214365000AE8329BFD4697D9EC37DE",
+    "07912143658709F1040B918100551512F200F4111010214365000AE8329BFD4697D9EC37DE",
+    /* GSM-7 with UDH, 8-bit concat reference */
+    "07911356131313F64004850120390011609232239180A006080400100201D7327BFD6EB340E2321BF46E83"
+    "EA7790F59D1E97DBE1341B442F83C465763D3DA797E56537C81D0ECB41AB59CC1693C16031D96C064241E5"
+    "656838AF03A96230982A269BCD462917C8FA4E8FCBED709A0D7ABBE9F6B0FB5C7683D27350984D4FABC9A0"
+    "B33C4C4FCF5D20EBFB2D079DCB62793DBD06D9C36E50FB2D4E97D9A0B49B5E96BBCB",
+    "07912160130320F5440B916171056429F5000021405291650569A00500034C0201A9E8F41C949E83C2207B"
+    "599E07B1DFEE33885E9ED341E4F23C7D7697C920FA1B54C697E5E3F4BC0C6AD7D9F434081E96D341E3303C"
+    "2C4EB3D3F4BC0B94A483E6E8779D4D06CDD1EF3BA80E0785E7A0B7BB0C6A97E7F3F0B9CC02B9DF7450780E"
+    "A2DFDF2C50780EA2A3CBA0BA9B5C96B3F369F71954768FDFE4B4FB0C9297E1F2F2BCECA6CF41",
+    "07912160130320F6440B916171056429F5000021405291651569320500034C0202E9E8301D44479741F0B0"
+    "9C3E0785E56590BCCC0ED3CB6410FD0D7ABBCBA0B0FB4D4797E52E10",
+    /* Status report */
+    "07914356060013F1065A098136397339F7219011700463802190117004638030",
+    /* UCS2, concatenated, 8-bit reference (1/3) */
+    "0791947101670000440B919761214365F70008425091214365008C0500037A0301041F0440043804320435"
+    "044200210020042D0442043E00200434043B0438043D043D043E043500200441043E043E04310449043504"
+    "3D04380435002C0020043A043E0442043E0440043E04350020043D04350020043F043E043C043504490430"
+    "043504420441044F002004320020043E0434043D044300200447043004410442044C00200053",
+    /* UCS2, concatenated, 8-bit reference (2/3) */
+    "0791947101670000440B919761214365F70008425091214365008C0500037A0302004D0053002004380020"
+    "043F043E044D0442043E043C04430020043F044004380445043E043404380442002004320020043D043504"
+    "41043A043E043B044C043A0438044500200447043004410442044F0445002C002004370430043A043E0434"
+    "04380440043E04320430043D043D044B04450020043200200055004300530032002E0020041A",
+    /* UCS2, concatenated, 8-bit reference (3/3) */
+    "0791947101670000440B919761214365F7000842509121436500100500037A0303043E043D04350446002E",
+    /* UCS2, concatenated, 16-bit reference (1/2) */
+    "0891683108100005F0440D91683108108300F00008425091214365208B060804123402014F60597DFF0C8F"
+    "D9662F4E0067615F88957F768477ED4FE1FF0C97008981520662104E2490E8520653D1900130026BCF90E8"
+    "52066700591A53EF4EE55305542B516D5341516D4E2A5B577B26FF0C56E04E3A752862376570636E593453"
+    "6075284E864E034E2A5B57828276847A7A95F430025982679C63A5653665B96B63786E573091CD",
+    /* UCS2, concatenated, 16-bit reference (2/2) */
+    "0891683108100005F0440D91683108108300F0000842509121436520330608041234020265B07EC454088F"
+    "D94E9B90E85206FF0C752862375C06770B52305B8C657476846587672C30028C228C22FF01",
+    /* UCS2, surrogate pairs */
+    "0791947101670000040D91945111325476F8000842509121436500380041006C006C006500730020006700"
+    "7500740020D83DDC4DD83DDE00002000620069007300200073007000E40074006500720020D83CDF89",
+    /* UCS2, class 0 */
+    "07913306091093F0040B913316325476F800184250912143650A48004D0065007300730061006700650020"
+    "0066006C006100730068003A00200076006F00740072006500200063006F00640065002000650073007400"
+    "20003400380032003900310033",
+    /* GSM-7, concatenated, 16-bit reference (1/2) */
+    "07912160130300F4440B912160550501F0000042509121436580A0060804BEEF020154747A0E4ACF416110"
+    "FBED3E838ED326E8066A97E7F3F0B90C9AC3D9693A28ED06D1EF6F103C2CA7CF41F579DA7D068541F3349E"
+    "5E2EBB41E2341D347EBBC7617AD91DA6A7DF6E90BC6C2ECBCBEE71D9054AD24173F4BBCE2683C46590BC1C"
+    "9ECFCB6D31BB4C0689F3203ABA0C9297C7E5B4BD2C07A5DDF437280C9AA7DD677619442FE3E9",
+    /* GSM-7, concatenated, 16-bit reference (2/2) */
+    "07912160130300F4440B912160550501F000004250912143658028060804BEEF0202A0F0399C76B3406FF7"
+    "B80C12BFE968103C2CA7CF4161B93C6D2F935D",
+    /* Status report, delivered, with TP-PI */
+    "079144775810065006110C9144770009103242509121436508425091215320080000",
+    /* Status report, temporary error */
+    "079144775810065006120C91447700091032425091214365084250912153200820",
+    /* Status report, permanent error */
+    "079144775810065006130C91447700091032425091214365084250912153200841",
+    /* Status report, expired */
+    "079144775810065006140C91447700091032425091214365084250912153200846",
+};
+
+static guint
+n_rounds (void)
+{
+    return g_test_perf () ? PERF_ROUNDS : QUICK_ROUNDS;
+}
+
+static void
+report_rate (const gchar *what,
+             guint        n_pdus,
+             gdouble      elapsed)
+{
+    gdouble rate;
+
+    rate = elapsed > 0.0 ? n_pdus / elapsed : 0.0;
+    g_test_maximized_result (rate, "%s: %.0f PDUs/s", what, rate);
+    /* Numbers from the quick mode are meaningless */
+    if (g_test_perf ())
+        g_print ("%s: %u PDUs in %.3f s: %.0f PDUs/s\n", what, n_pdus, elapsed, rate);
+}
+
+static void
+test_perf_decode (void)
+{
+    MMSmsPart3gppPdu pdu;
+    guint rounds;
+    guint r;
+    guint i;
+    guint n = 0;
+
+    rounds = n_rounds ();
+    g_test_timer_start ();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < G_N_ELEMENTS (corpus); i++) {
+            GError *error = NULL;
+
+            if (!mm_sms_part_3gpp_pdu_decode (&pdu, corpus[i], NULL, &error))
+                g_error ("couldn't decode PDU #%u: %s", i, error->message);
+            n++;
+        }
+    }
+    report_rate ("decode", n, g_test_timer_elapsed ());
+}
+
+static void
+test_perf_new_from_pdu (void)
+{
+    guint rounds;
+    guint r;
+    guint i;
+    guint n = 0;
+
+    rounds = n_rounds ();
+    g_test_timer_start ();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < G_N_ELEMENTS (corpus); i++) {
+            MMSmsPart *part;
+            GError *error = NULL;
+
+            part = mm_sms_part_3gpp_new_from_pdu (0, corpus[i], NULL, &error);
+            if (!part)
+                g_error ("couldn't parse PDU #%u: %s", i, error->message);
+            mm_sms_part_free (part);
+            n++;
+        }
+    }
+    report_rate ("new-from-pdu", n, g_test_timer_elapsed ());
+}
+
+/************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/SMS/3GPP/PDU-Parser/perf/decode", test_perf_decode);
+    g_test_add_func ("/MM/SMS/3GPP/PDU-Parser/perf/new-from-pdu", test_perf_new_from_pdu);
+
+    return g_test_run ();
+}
@@ -437,6 +437,75 @@ test_pdu_not_stored (void)
         NULL, 0);
 }
 
+static void
+test_pdu_decoded (void)
+{
+    /* Same PDU as in test_pdu3_8bit() */
+    static const gchar *hexpdu =
+        "07912143658709F1040B918100551512F20004111010214365000AE8329BFD4697D9EC37DE";
+    static const guint8 expected_data[] = {
+        0xe8, 0x32, 0x9b, 0xfd, 0x46, 0x97, 0xd9, 0xec, 0x37, 0xde };
+    MMSmsPart3gppPdu pdu;
+    GError *error = NULL;
+    gboolean ret;
+    guint i;
+
+    ret = mm_sms_part_3gpp_pdu_decode (&pdu, hexpdu, NULL, &error);
+    g_assert_no_error (error);
+    g_assert (ret);
+
+    g_assert_cmpuint (pdu.pdu_type, ==, MM_SMS_PDU_TYPE_DELIVER);
+    g_assert_cmpstr (pdu.smsc, ==, "+12345678901");
+    g_assert_cmpstr (pdu.number, ==, "+18005551212");
+    g_assert_cmpstr (pdu.timestamp, ==, "2011-01-01T12:34:56+00:00");
+    g_assert (pdu.text == NULL);
+    g_assert_cmpuint (pdu.encoding, ==, MM_SMS_ENCODING_8BIT);
+
+    /* Strings live in the record, data is referenced in the input */
+    g_assert (pdu.smsc >= pdu.arena && pdu.smsc < pdu.arena + pdu.arena_used);
+    g_assert (pdu.number >= pdu.arena && pdu.number < pdu.arena + pdu.arena_used);
+    g_assert (pdu.have_data);
+    g_assert_cmpuint (pdu.data_len, ==, sizeof (expected_data));
+    for (i = 0; i < pdu.data_len; i++)
+        g_assert_cmpuint (mm_sms_part_3gpp_pdu_get_byte (&pdu, pdu.data_offset + i), ==, expected_data[i]);
+}
+
+static void
+test_pdu_decoded_status_report (void)
+{
+    /* Same PDU as in test_pdu_not_stored() */
+    static const gchar *hexpdu =
+        "07914356060013F1065A098136397339F7219011700463802190117004638030";
+    MMSmsPart3gppPdu pdu;
+    GError *error = NULL;
+    gboolean ret;
+
+    ret = mm_sms_part_3gpp_pdu_decode (&pdu, hexpdu, NULL, &error);
+    g_assert_no_error (error);
+    g_assert (ret);
+
+    g_assert_cmpuint (pdu.pdu_type, ==, MM_SMS_PDU_TYPE_STATUS_REPORT);
+    g_assert_cmpuint (pdu.message_reference, ==, 0x5a);
+    g_assert_cmpstr (pdu.timestamp, ==, "2012-09-11T07:40:36+02:00");
+    g_assert_cmpstr (pdu.discharge_timestamp, ==, "2012-09-11T07:40:36+02:00");
+    g_assert_cmpuint (pdu.delivery_state, ==, 0x30);
+}
+
+static void
+test_pdu_decoded_invalid_hex (void)
+{
+    MMSmsPart3gppPdu pdu;
+    GError *error = NULL;
+
+    g_assert (!mm_sms_part_3gpp_pdu_decode (&pdu, "07912143658709F", NULL, &error));
+    g_assert (error != NULL);
+    g_clear_error (&error);
+
+    g_assert (!mm_sms_part_3gpp_pdu_decode (&pdu, "07912143658709FX", NULL, &error));
+    g_assert (error != NULL);
+    g_clear_error (&error);
+}
+
 /********************* SMS ADDRESS ENCODER TESTS *********************/
 
 static void
@@ -861,6 +930,9 @@ int main (int argc, char **argv)
     g_test_add_func ("/MM/SMS/3GPP/PDU-Parser/pdu-multipart", test_pdu_multipart);
     g_test_add_func ("/MM/SMS/3GPP/PDU-Parser/pdu-stored-by-us", test_pdu_stored_by_us);
     g_test_add_func ("/MM/SMS/3GPP/PDU-Parser/pdu-not-stored", test_pdu_not_stored);
+    g_test_add_func ("/MM/SMS/3GPP/PDU-Parser/pdu-decoded", test_pdu_decoded);
+    g_test_add_func ("/MM/SMS/3GPP/PDU-Parser/pdu-decoded-status-report", test_pdu_decoded_status_report);
+    g_test_add_func ("/MM/SMS/3GPP/PDU-Parser/pdu-decoded-invalid-hex", test_pdu_decoded_invalid_hex);
 
     g_test_add_func ("/MM/SMS/3GPP/Address-Encoder/smsc-intl", test_address_encode_smsc_intl);
     g_test_add_func ("/MM/SMS/3GPP/Address-Encoder/smsc-unknown", test_address_encode_smsc_unknown);
@@ -0,0 +1,282 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <glib/gstdio.h>
+#include <locale.h>
+#include <string.h>
+
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-sms-spool.h"
+#include "mm-modem-helpers.h"
+#include "mm-sms-part.h"
+#include "mm-log-test.h"
+
+#define SIM_ID "8934071100000000001"
+
+/*****************************************************************************/
+
+typedef struct {
+    gchar *directory;
+} Fixture;
+
+static void
+fixture_setup (Fixture       *fixture,
+               gconstpointer  user_data)
+{
+    GError *error = NULL;
+
+    fixture->directory = g_dir_make_tmp ("mm-test-sms-spool-XXXXXX", &error);
+    g_assert_no_error (error);
+}
+
+static void
+fixture_teardown (Fixture       *fixture,
+                  gconstpointer  user_data)
+{
+    gchar *path;
+
+    path = g_build_filename (fixture->directory, SIM_ID ".spool", NULL);
+    g_unlink (path);
+    g_free (path);
+    g_rmdir (fixture->directory);
+    g_free (fixture->directory);
+}
+
+static MM3gppPduInfo *
+find_part (GList *parts,
+           gint   index)
+{
+    GList *l;
+
+    for (l = parts; l; l = g_list_next (l)) {
+        MM3gppPduInfo *info = l->data;
+
+        if (info->index == index)
+            return info;
+    }
+    return NULL;
+}
+
+/*****************************************************************************/
+
+static void
+test_dedup (Fixture       *fixture,
+            gconstpointer  user_data)
+{
+    MMSmsSpool    *spool;
+    GList         *parts;
+    MM3gppPduInfo *info;
+
+    spool = mm_sms_spool_new (fixture->directory, SIM_ID);
+    g_assert (spool);
+
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 3, 0, "0011AA");
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 4, 0, "0011BB");
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_ME, 3, 0, "0011CC");
+
+    /* Same storage and index replaces the previous entry, e.g. when the part
+     * is read again after its status changed */
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 3, 1, "0011DD");
+
+    g_assert_cmpuint (mm_sms_spool_get_count (spool, MM_SMS_STORAGE_SM), ==, 2);
+    g_assert_cmpuint (mm_sms_spool_get_count (spool, MM_SMS_STORAGE_ME), ==, 1);
+
+    parts = mm_sms_spool_get_parts (spool, MM_SMS_STORAGE_SM);
+    g_assert_cmpuint (g_list_length (parts), ==, 2);
+    info = find_part (parts, 3);
+    g_assert (info);
+    g_assert_cmpint (info->status, ==, 1);
+    g_assert_cmpstr (info->pdu, ==, "0011DD");
+    g_assert (find_part (parts, 4));
+    mm_3gpp_pdu_info_list_free (parts);
+
+    mm_sms_spool_remove_part (spool, MM_SMS_STORAGE_SM, 4);
+    g_assert_cmpuint (mm_sms_spool_get_count (spool, MM_SMS_STORAGE_SM), ==, 1);
+
+    /* Unknown storage or index are never spooled */
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_UNKNOWN, 1, 0, "0011EE");
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, SMS_PART_INVALID_INDEX, 0, "0011EE");
+    g_assert_cmpuint (mm_sms_spool_get_count (spool, MM_SMS_STORAGE_SM), ==, 1);
+
+    g_object_unref (spool);
+}
+
+static void
+test_count_shortcut (Fixture       *fixture,
+                     gconstpointer  user_data)
+{
+    MMSmsSpool *spool;
+
+    spool = mm_sms_spool_new (fixture->directory, SIM_ID);
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 1, 1, "0011AA");
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 2, 1, "0011BB");
+
+    /* Parts only added through indications, storage never fully listed */
+    g_assert (!mm_sms_spool_get_storage_listed (spool, MM_SMS_STORAGE_SM));
+    g_assert (!mm_sms_spool_check_storage (spool, MM_SMS_STORAGE_SM, 2));
+
+    mm_sms_spool_set_storage_listed (spool, MM_SMS_STORAGE_SM);
+    g_assert (mm_sms_spool_get_storage_listed (spool, MM_SMS_STORAGE_SM));
+    g_assert (mm_sms_spool_check_storage (spool, MM_SMS_STORAGE_SM, 2));
+
+    /* Count differs */
+    g_assert (!mm_sms_spool_check_storage (spool, MM_SMS_STORAGE_SM, 1));
+    g_assert (!mm_sms_spool_check_storage (spool, MM_SMS_STORAGE_SM, 3));
+
+    /* A new part read after an indication keeps the spool in sync */
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 5, 0, "0011CC");
+    g_assert (mm_sms_spool_check_storage (spool, MM_SMS_STORAGE_SM, 3));
+
+    /* Other storages are independent */
+    g_assert (!mm_sms_spool_check_storage (spool, MM_SMS_STORAGE_ME, 0));
+
+    g_object_unref (spool);
+}
+
+static void
+test_sync (Fixture       *fixture,
+           gconstpointer  user_data)
+{
+    MMSmsSpool *spool;
+    GArray     *indexes;
+    GArray     *missing;
+    GList      *parts;
+    guint       in_use[] = { 1, 3, 7 };
+
+    spool = mm_sms_spool_new (fixture->directory, SIM_ID);
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 1, 1, "0011AA");
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 2, 1, "0011BB");
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 3, 1, "0011CC");
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_ME, 2, 1, "0011DD");
+    mm_sms_spool_set_storage_listed (spool, MM_SMS_STORAGE_SM);
+
+    /* Index 2 removed and index 7 added behind our back */
+    indexes = g_array_new (FALSE, FALSE, sizeof (guint));
+    g_array_append_vals (indexes, in_use, G_N_ELEMENTS (in_use));
+    missing = mm_sms_spool_sync_storage (spool, MM_SMS_STORAGE_SM, indexes);
+
+    /* Only the unknown index needs to be read */
+    g_assert_cmpuint (missing->len, ==, 1);
+    g_assert_cmpuint (g_array_index (missing, guint, 0), ==, 7);
+    g_array_unref (missing);
+
+    parts = mm_sms_spool_get_parts (spool, MM_SMS_STORAGE_SM);
+    g_assert_cmpuint (g_list_length (parts), ==, 2);
+    g_assert (find_part (parts, 1));
+    g_assert (!find_part (parts, 2));
+    g_assert (find_part (parts, 3));
+    mm_3gpp_pdu_info_list_free (parts);
+
+    /* Other storages untouched */
+    g_assert_cmpuint (mm_sms_spool_get_count (spool, MM_SMS_STORAGE_ME), ==, 1);
+
+    /* Once the missing part is read, the count shortcut applies again */
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 7, 0, "0011EE");
+    g_assert (mm_sms_spool_check_storage (spool, MM_SMS_STORAGE_SM, 3));
+
+    /* Empty storage drops everything */
+    g_array_set_size (indexes, 0);
+    missing = mm_sms_spool_sync_storage (spool, MM_SMS_STORAGE_SM, indexes);
+    g_assert_cmpuint (missing->len, ==, 0);
+    g_array_unref (missing);
+    g_assert_cmpuint (mm_sms_spool_get_count (spool, MM_SMS_STORAGE_SM), ==, 0);
+
+    g_array_unref (indexes);
+    g_object_unref (spool);
+}
+
+static void
+test_clear (Fixture       *fixture,
+            gconstpointer  user_data)
+{
+    MMSmsSpool *spool;
+
+    spool = mm_sms_spool_new (fixture->directory, SIM_ID);
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 1, 1, "0011AA");
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_ME, 1, 1, "0011BB");
+    mm_sms_spool_set_storage_listed (spool, MM_SMS_STORAGE_SM);
+    mm_sms_spool_set_storage_listed (spool, MM_SMS_STORAGE_ME);
+
+    /* Clearing drops both the parts and the listed flag */
+    mm_sms_spool_clear_storage (spool, MM_SMS_STORAGE_ME);
+    g_assert_cmpuint (mm_sms_spool_get_count (spool, MM_SMS_STORAGE_ME), ==, 0);
+    g_assert (!mm_sms_spool_get_storage_listed (spool, MM_SMS_STORAGE_ME));
+    g_assert (!mm_sms_spool_check_storage (spool, MM_SMS_STORAGE_ME, 0));
+    g_assert (mm_sms_spool_check_storage (spool, MM_SMS_STORAGE_SM, 1));
+
+    g_object_unref (spool);
+}
+
+static void
+test_persistence (Fixture       *fixture,
+                  gconstpointer  user_data)
+{
+    MMSmsSpool *spool;
+    GList      *parts;
+    gchar      *path;
+    gchar      *contents;
+    gchar      *pdu;
+    GError     *error = NULL;
+
+    spool = mm_sms_spool_new (fixture->directory, SIM_ID);
+    mm_sms_spool_add_part (spool, MM_SMS_STORAGE_SM, 1, 1, "0011AA");
+    mm_sms_spool_set_storage_listed (spool, MM_SMS_STORAGE_SM);
+    /* Pending writes are flushed on finalization */
+    g_object_unref (spool);
+
+    spool = mm_sms_spool_new (fixture->directory, SIM_ID);
+    g_assert (mm_sms_spool_check_storage (spool, MM_SMS_STORAGE_SM, 1));
+    parts = mm_sms_spool_get_parts (spool, MM_SMS_STORAGE_SM);
+    g_assert_cmpuint (g_list_length (parts), ==, 1);
+    mm_3gpp_pdu_info_list_free (parts);
+    g_object_unref (spool);
+
+    /* Entries whose PDU doesn't match the hash are ignored */
+    path = g_build_filename (fixture->directory, SIM_ID ".spool", NULL);
+    g_file_get_contents (path, &contents, NULL, &error);
+    g_assert_no_error (error);
+    pdu = strstr (contents, "pdu=0011AA");
+    g_assert (pdu);
+    pdu[strlen ("pdu=0011A")] = 'B';
+    g_file_set_contents (path, contents, -1, &error);
+    g_assert_no_error (error);
+
+    spool = mm_sms_spool_new (fixture->directory, SIM_ID);
+    parts = mm_sms_spool_get_parts (spool, MM_SMS_STORAGE_SM);
+    g_assert_cmpuint (g_list_length (parts), ==, 0);
+    g_object_unref (spool);
+
+    g_free (contents);
+    g_free (path);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add ("/MM/sms-spool/dedup",          Fixture, NULL, fixture_setup, test_dedup,          fixture_teardown);
+    g_test_add ("/MM/sms-spool/count-shortcut", Fixture, NULL, fixture_setup, test_count_shortcut, fixture_teardown);
+    g_test_add ("/MM/sms-spool/sync",           Fixture, NULL, fixture_setup, test_sync,           fixture_teardown);
+    g_test_add ("/MM/sms-spool/clear",          Fixture, NULL, fixture_setup, test_clear,          fixture_teardown);
+    g_test_add ("/MM/sms-spool/persistence",    Fixture, NULL, fixture_setup, test_persistence,    fixture_teardown);
+
+    return g_test_run ();
+}